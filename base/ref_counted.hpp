@@ -2,24 +2,27 @@
 
 #include "base/macros.hpp"
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 
 namespace base
 {
+// The counter is atomic, so objects may be shared between threads as long as
+// they are not modified.
 class RefCounted
 {
 public:
   virtual ~RefCounted() = default;
 
-  inline void IncRef() noexcept { ++m_refs; }
-  inline uint64_t DecRef() noexcept { return --m_refs; }
-  inline uint64_t NumRefs() const noexcept { return m_refs; }
+  inline void IncRef() noexcept { m_refs.fetch_add(1, std::memory_order_relaxed); }
+  inline uint64_t DecRef() noexcept { return m_refs.fetch_sub(1, std::memory_order_acq_rel) - 1; }
+  inline uint64_t NumRefs() const noexcept { return m_refs.load(std::memory_order_acquire); }
 
 protected:
   RefCounted() noexcept = default;
 
-  uint64_t m_refs = 0;
+  std::atomic<uint64_t> m_refs{0};
 
   DISALLOW_COPY_AND_MOVE(RefCounted);
 };
@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <iterator>
 #include <memory>
+#include <random>
 #include <set>
 #include <vector>
 
@@ -84,6 +85,55 @@ void CheckUnion(vector<uint64_t> & setBits1, coding::CompressedBitVector::Storag
   TEST_EQUAL(resultStrategy, cbv3->GetStorageStrategy(), ());
   CheckUnion(setBits1, setBits2, *cbv3);
 }
+
+vector<uint64_t> ToVector(coding::CompressedBitVector const & cbv)
+{
+  vector<uint64_t> setBits;
+  coding::CompressedBitVectorEnumerator::ForEach(cbv,
+                                                 [&setBits](uint64_t bit) { setBits.push_back(bit); });
+  return setBits;
+}
+
+// Generates bits for chunks of all container types: arrays, bitmaps, runs and full chunks.
+vector<uint64_t> GenerateChunkedBits(minstd_rand & rng)
+{
+  uint64_t const kChunkSize = coding::ChunkedCBV::kChunkSize;
+
+  vector<uint64_t> setBits;
+  for (uint64_t key = 0; key < 6; ++key)
+  {
+    uint64_t const offset = key * kChunkSize;
+    switch (rng() % 5)
+    {
+    case 0: break;
+    case 1:
+      for (size_t i = 0; i < 100; ++i)
+        setBits.push_back(offset + rng() % kChunkSize);
+      break;
+    case 2:
+      for (uint64_t i = 0; i < kChunkSize; ++i)
+      {
+        if (rng() % 3 == 0)
+          setBits.push_back(offset + i);
+      }
+      break;
+    case 3:
+      for (uint64_t first = rng() % 1000; first < kChunkSize; first += 1000 + rng() % 1000)
+      {
+        for (uint64_t i = first; i < min(kChunkSize, first + 300); ++i)
+          setBits.push_back(offset + i);
+      }
+      break;
+    case 4:
+      for (uint64_t i = 0; i < kChunkSize; ++i)
+        setBits.push_back(offset + i);
+      break;
+    }
+  }
+  sort(setBits.begin(), setBits.end());
+  setBits.erase(unique(setBits.begin(), setBits.end()), setBits.end());
+  return setBits;
+}
 }  // namespace
 
 UNIT_TEST(CompressedBitVector_Intersect1)
@@ -472,3 +522,120 @@ UNIT_TEST(CompressedBitVector_SparseLeaveFirstNBits)
   for (uint64_t bit = 0; bit < (1 << 10); ++bit)
     TEST(!cbv->GetBit(bit), (bit));
 }
+
+UNIT_TEST(CompressedBitVector_ChunkedOperations)
+{
+  minstd_rand rng(0);
+  for (size_t iteration = 0; iteration < 30; ++iteration)
+  {
+    auto bits1 = GenerateChunkedBits(rng);
+    auto bits2 = GenerateChunkedBits(rng);
+
+    vector<uint64_t> intersection;
+    vector<uint64_t> difference;
+    vector<uint64_t> unionBits;
+    Intersect(bits1, bits2, intersection);
+    Subtract(bits1, bits2, difference);
+    Union(bits1, bits2, unionBits);
+
+    coding::ChunkedCBV const cbv1(bits1);
+    coding::ChunkedCBV const cbv2(bits2);
+    TEST_EQUAL(ToVector(cbv1), bits1, ());
+    TEST_EQUAL(cbv1.PopCount(), bits1.size(), ());
+
+    // Other strategies are converted to chunked bit vectors.
+    unique_ptr<coding::CompressedBitVector const> const plain2 =
+        coding::CompressedBitVectorBuilder::FromBitPositions(bits2);
+    for (auto const * rhs : {static_cast<coding::CompressedBitVector const *>(&cbv2), plain2.get()})
+    {
+      auto const i = coding::CompressedBitVector::Intersect(cbv1, *rhs);
+      TEST_EQUAL(i->GetStorageStrategy(), coding::CompressedBitVector::StorageStrategy::Chunked, ());
+      TEST_EQUAL(ToVector(*i), intersection, ());
+      TEST_EQUAL(i->PopCount(), intersection.size(), ());
+      TEST_EQUAL(coding::CompressedBitVector::IntersectionPopCount(cbv1, *rhs), intersection.size(),
+                 ());
+
+      auto const d = coding::CompressedBitVector::Subtract(cbv1, *rhs);
+      TEST_EQUAL(ToVector(*d), difference, ());
+      TEST_EQUAL(d->PopCount(), difference.size(), ());
+
+      auto const u = coding::CompressedBitVector::Union(*rhs, cbv1);
+      TEST_EQUAL(ToVector(*u), unionBits, ());
+      TEST_EQUAL(u->PopCount(), unionBits.size(), ());
+    }
+
+    {
+      coding::ChunkedCBV cbv(bits1);
+      cbv.IntersectWith(cbv2);
+      TEST_EQUAL(ToVector(cbv), intersection, ());
+      TEST_EQUAL(cbv.PopCount(), intersection.size(), ());
+    }
+    {
+      coding::ChunkedCBV cbv(bits1);
+      cbv.SubtractWith(cbv2);
+      TEST_EQUAL(ToVector(cbv), difference, ());
+      TEST_EQUAL(cbv.PopCount(), difference.size(), ());
+    }
+    {
+      coding::ChunkedCBV cbv(bits1);
+      cbv.UnionWith(cbv2);
+      TEST_EQUAL(ToVector(cbv), unionBits, ());
+      TEST_EQUAL(cbv.PopCount(), unionBits.size(), ());
+    }
+
+    set<uint64_t> const expected(bits1.begin(), bits1.end());
+    for (size_t i = 0; i < 1000; ++i)
+    {
+      uint64_t const bit = rng() % (7 * coding::ChunkedCBV::kChunkSize);
+      TEST_EQUAL(cbv1.GetBit(bit), expected.count(bit) != 0, (bit));
+    }
+
+    size_t const n = bits1.size() / 3;
+    auto const first = cbv1.LeaveFirstSetNBits(n);
+    TEST_EQUAL(ToVector(*first), vector<uint64_t>(bits1.begin(), bits1.begin() + n), ());
+  }
+}
+
+UNIT_TEST(CompressedBitVector_ChunkedRange)
+{
+  uint64_t const kBegin = 70000;
+  uint64_t const kEnd = 200000;
+  auto const cbv = coding::ChunkedCBV::BuildFromRange(kBegin, kEnd);
+  TEST_EQUAL(cbv->PopCount(), kEnd - kBegin, ());
+  TEST_EQUAL(cbv->NumChunks(), 3, ());
+  TEST(!cbv->GetBit(kBegin - 1), ());
+  TEST(cbv->GetBit(kBegin), ());
+  TEST(cbv->GetBit(2 * coding::ChunkedCBV::kChunkSize), ());
+  TEST(cbv->GetBit(kEnd - 1), ());
+  TEST(!cbv->GetBit(kEnd), ());
+
+  auto const first = cbv->LeaveFirstSetNBits(100);
+  TEST_EQUAL(first->PopCount(), 100, ());
+  TEST(first->GetBit(kBegin + 99), ());
+  TEST(!first->GetBit(kBegin + 100), ());
+
+  // The second chunk is full, so it doesn't change the other operand.
+  vector<uint64_t> const setBits = {5, 70000, 131072, 131073, 262143};
+  coding::ChunkedCBV rhs(setBits);
+  TEST_EQUAL(coding::CompressedBitVector::IntersectionPopCount(*cbv, rhs), 3, ());
+  rhs.IntersectWith(*cbv);
+  TEST_EQUAL(ToVector(rhs), vector<uint64_t>({70000, 131072, 131073}), ());
+}
+
+UNIT_TEST(CompressedBitVector_ChunkedSerialization)
+{
+  minstd_rand rng(1);
+  auto const setBits = GenerateChunkedBits(rng);
+
+  vector<uint8_t> buf;
+  {
+    MemWriter<vector<uint8_t>> writer(buf);
+    coding::ChunkedCBV(setBits).Serialize(writer);
+  }
+  MemReader reader(buf.data(), buf.size());
+  auto cbv = coding::CompressedBitVectorBuilder::DeserializeFromReader(reader);
+  TEST(cbv.get(), ());
+  TEST_NOT_EQUAL(cbv->GetStorageStrategy(), coding::CompressedBitVector::StorageStrategy::Chunked,
+                 ());
+  TEST_EQUAL(ToVector(*cbv), setBits, ());
+}
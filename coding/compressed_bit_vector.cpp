@@ -4,8 +4,16 @@
 
 #include "base/assert.hpp"
 #include "base/bits.hpp"
+#include "base/stl_helpers.hpp"
 
 #include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 using namespace std;
 
@@ -13,6 +21,493 @@ namespace coding
 {
 namespace
 {
+using Chunk = ChunkedCBV::Chunk;
+using ChunkType = ChunkedCBV::Chunk::Type;
+
+size_t constexpr kBitmapWords = ChunkedCBV::kBitmapWords;
+
+// Word-wise operations on bitmaps ------------------------------------------------------------------
+struct AndWords
+{
+  static uint64_t Apply(uint64_t a, uint64_t b) { return a & b; }
+#if defined(__SSE2__)
+  static __m128i Apply(__m128i a, __m128i b) { return _mm_and_si128(a, b); }
+#elif defined(__ARM_NEON)
+  static uint64x2_t Apply(uint64x2_t a, uint64x2_t b) { return vandq_u64(a, b); }
+#endif
+};
+
+struct OrWords
+{
+  static uint64_t Apply(uint64_t a, uint64_t b) { return a | b; }
+#if defined(__SSE2__)
+  static __m128i Apply(__m128i a, __m128i b) { return _mm_or_si128(a, b); }
+#elif defined(__ARM_NEON)
+  static uint64x2_t Apply(uint64x2_t a, uint64x2_t b) { return vorrq_u64(a, b); }
+#endif
+};
+
+struct AndNotWords
+{
+  static uint64_t Apply(uint64_t a, uint64_t b) { return a & ~b; }
+#if defined(__SSE2__)
+  static __m128i Apply(__m128i a, __m128i b) { return _mm_andnot_si128(b, a); }
+#elif defined(__ARM_NEON)
+  static uint64x2_t Apply(uint64x2_t a, uint64x2_t b) { return vbicq_u64(a, b); }
+#endif
+};
+
+// Applies |Op| to the bitmaps |a| and |b| of a chunk and returns the number of set bits
+// in the result. The result is written to |res| if it's not null, |res| may be equal to |a|.
+template <typename Op>
+uint32_t ApplyToWords(uint64_t const * a, uint64_t const * b, uint64_t * res)
+{
+  uint32_t popCount = 0;
+  size_t i = 0;
+#if defined(__SSE2__) || defined(__ARM_NEON)
+  for (; i + 2 <= kBitmapWords; i += 2)
+  {
+    uint64_t words[2];
+#if defined(__SSE2__)
+    auto const v = Op::Apply(_mm_loadu_si128(reinterpret_cast<__m128i const *>(a + i)),
+                             _mm_loadu_si128(reinterpret_cast<__m128i const *>(b + i)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(words), v);
+#else
+    vst1q_u64(words, Op::Apply(vld1q_u64(a + i), vld1q_u64(b + i)));
+#endif
+    popCount += bits::PopCount(words[0]) + bits::PopCount(words[1]);
+    if (res)
+      memcpy(res + i, words, sizeof(words));
+  }
+#endif
+  for (; i < kBitmapWords; ++i)
+  {
+    uint64_t const word = Op::Apply(a[i], b[i]);
+    popCount += bits::PopCount(word);
+    if (res)
+      res[i] = word;
+  }
+  return popCount;
+}
+
+// Chunks -------------------------------------------------------------------------------------------
+bool TestBit(vector<uint64_t> const & words, uint16_t value)
+{
+  return ((words[value / 64] >> (value % 64)) & 1) != 0;
+}
+
+// Returns true if the bit was not set.
+bool SetBit(vector<uint64_t> & words, uint16_t value)
+{
+  uint64_t const mask = static_cast<uint64_t>(1) << (value % 64);
+  bool const wasSet = (words[value / 64] & mask) != 0;
+  words[value / 64] |= mask;
+  return !wasSet;
+}
+
+// Returns true if the bit was set.
+bool ClearBit(vector<uint64_t> & words, uint16_t value)
+{
+  uint64_t const mask = static_cast<uint64_t>(1) << (value % 64);
+  bool const wasSet = (words[value / 64] & mask) != 0;
+  words[value / 64] &= ~mask;
+  return wasSet;
+}
+
+void ToBitmap(Chunk const & chunk, vector<uint64_t> & words)
+{
+  switch (chunk.m_type)
+  {
+  case ChunkType::Bitmap: words = chunk.m_words; return;
+  case ChunkType::Array:
+    words.assign(kBitmapWords, 0);
+    for (auto const value : chunk.m_values)
+      SetBit(words, value);
+    return;
+  case ChunkType::Run:
+    words.assign(kBitmapWords, 0);
+    for (auto const & run : chunk.m_runs)
+    {
+      for (uint32_t value = run.m_first; value <= run.m_last; ++value)
+        SetBit(words, static_cast<uint16_t>(value));
+    }
+    return;
+  }
+}
+
+void ToArray(Chunk const & chunk, vector<uint16_t> & values)
+{
+  values.clear();
+  values.reserve(chunk.m_popCount);
+  switch (chunk.m_type)
+  {
+  case ChunkType::Array: values = chunk.m_values; return;
+  case ChunkType::Bitmap:
+    for (size_t i = 0; i < kBitmapWords; ++i)
+    {
+      for (uint64_t word = chunk.m_words[i]; word != 0; word &= word - 1)
+        values.push_back(static_cast<uint16_t>(64 * i + bits::FloorLog(word & (~word + 1))));
+    }
+    return;
+  case ChunkType::Run:
+    for (auto const & run : chunk.m_runs)
+    {
+      for (uint32_t value = run.m_first; value <= run.m_last; ++value)
+        values.push_back(static_cast<uint16_t>(value));
+    }
+    return;
+  }
+}
+
+// Chooses an array or a bitmap container for |chunk| according to |chunk.m_popCount|.
+void Normalize(Chunk & chunk)
+{
+  if (chunk.m_type == ChunkType::Bitmap && chunk.m_popCount <= ChunkedCBV::kMaxArraySize)
+  {
+    ToArray(chunk, chunk.m_values);
+    chunk.m_words = {};
+    chunk.m_type = ChunkType::Array;
+  }
+  else if (chunk.m_type == ChunkType::Array && chunk.m_popCount > ChunkedCBV::kMaxArraySize)
+  {
+    ToBitmap(chunk, chunk.m_words);
+    chunk.m_values = {};
+    chunk.m_type = ChunkType::Bitmap;
+  }
+}
+
+// Set operations are implemented for arrays and bitmaps. Runs are expanded to |buffer| by
+// this function, full chunks are handled separately before that.
+Chunk const & ExpandRuns(Chunk const & chunk, Chunk & buffer)
+{
+  if (chunk.m_type != ChunkType::Run)
+    return chunk;
+
+  buffer.m_key = chunk.m_key;
+  buffer.m_popCount = chunk.m_popCount;
+  if (chunk.m_popCount <= ChunkedCBV::kMaxArraySize)
+  {
+    buffer.m_type = ChunkType::Array;
+    ToArray(chunk, buffer.m_values);
+  }
+  else
+  {
+    buffer.m_type = ChunkType::Bitmap;
+    ToBitmap(chunk, buffer.m_words);
+  }
+  return buffer;
+}
+
+Chunk MakeArrayChunk(uint64_t key, vector<uint16_t> && values)
+{
+  Chunk chunk;
+  chunk.m_key = key;
+  chunk.m_type = ChunkType::Array;
+  chunk.m_popCount = static_cast<uint32_t>(values.size());
+  chunk.m_values = move(values);
+  Normalize(chunk);
+  return chunk;
+}
+
+Chunk MakeBitmapChunk(uint64_t key, vector<uint64_t> && words, uint32_t popCount)
+{
+  Chunk chunk;
+  chunk.m_key = key;
+  chunk.m_type = ChunkType::Bitmap;
+  chunk.m_popCount = popCount;
+  chunk.m_words = move(words);
+  Normalize(chunk);
+  return chunk;
+}
+
+// Builds a chunk from sorted unique positions [begin, end) of the chunk |key|.
+template <typename It>
+Chunk BuildChunk(uint64_t key, It begin, It end)
+{
+  uint64_t const offset = key << ChunkedCBV::kChunkBits;
+  size_t const popCount = static_cast<size_t>(distance(begin, end));
+
+  vector<ChunkedCBV::Run> runs;
+  for (auto it = begin; it != end; ++it)
+  {
+    auto const value = static_cast<uint16_t>(*it - offset);
+    if (!runs.empty() && runs.back().m_last + 1 == value)
+      runs.back().m_last = value;
+    else
+      runs.push_back({value, value});
+  }
+
+  size_t const runsSize = runs.size() * sizeof(ChunkedCBV::Run);
+  if (runsSize < min(popCount * sizeof(uint16_t), kBitmapWords * sizeof(uint64_t)))
+  {
+    Chunk chunk;
+    chunk.m_key = key;
+    chunk.m_type = ChunkType::Run;
+    chunk.m_popCount = static_cast<uint32_t>(popCount);
+    chunk.m_runs = move(runs);
+    return chunk;
+  }
+
+  vector<uint16_t> values;
+  values.reserve(popCount);
+  for (auto it = begin; it != end; ++it)
+    values.push_back(static_cast<uint16_t>(*it - offset));
+  return MakeArrayChunk(key, move(values));
+}
+
+Chunk IntersectChunks(Chunk const & lhs, Chunk const & rhs)
+{
+  ASSERT_EQUAL(lhs.m_key, rhs.m_key, ());
+  if (lhs.IsFull())
+    return rhs;
+  if (rhs.IsFull())
+    return lhs;
+
+  Chunk bufferA;
+  Chunk bufferB;
+  Chunk const & a = ExpandRuns(lhs, bufferA);
+  Chunk const & b = ExpandRuns(rhs, bufferB);
+
+  if (a.m_type == ChunkType::Bitmap && b.m_type == ChunkType::Bitmap)
+  {
+    vector<uint64_t> words(kBitmapWords);
+    auto const popCount = ApplyToWords<AndWords>(a.m_words.data(), b.m_words.data(), words.data());
+    return MakeBitmapChunk(a.m_key, move(words), popCount);
+  }
+
+  vector<uint16_t> values;
+  if (a.m_type == ChunkType::Array && b.m_type == ChunkType::Array)
+  {
+    set_intersection(a.m_values.begin(), a.m_values.end(), b.m_values.begin(), b.m_values.end(),
+                     back_inserter(values));
+  }
+  else
+  {
+    auto const & array = a.m_type == ChunkType::Array ? a : b;
+    auto const & bitmap = a.m_type == ChunkType::Array ? b : a;
+    copy_if(array.m_values.begin(), array.m_values.end(), back_inserter(values),
+            [&bitmap](uint16_t value) { return TestBit(bitmap.m_words, value); });
+  }
+  return MakeArrayChunk(a.m_key, move(values));
+}
+
+Chunk SubtractChunks(Chunk const & lhs, Chunk const & rhs)
+{
+  ASSERT_EQUAL(lhs.m_key, rhs.m_key, ());
+  if (rhs.IsFull())
+    return MakeArrayChunk(lhs.m_key, {});
+
+  Chunk bufferA;
+  Chunk bufferB;
+  Chunk const & a = ExpandRuns(lhs, bufferA);
+  Chunk const & b = ExpandRuns(rhs, bufferB);
+
+  if (a.m_type == ChunkType::Array)
+  {
+    vector<uint16_t> values;
+    if (b.m_type == ChunkType::Array)
+    {
+      set_difference(a.m_values.begin(), a.m_values.end(), b.m_values.begin(), b.m_values.end(),
+                     back_inserter(values));
+    }
+    else
+    {
+      copy_if(a.m_values.begin(), a.m_values.end(), back_inserter(values),
+              [&b](uint16_t value) { return !TestBit(b.m_words, value); });
+    }
+    return MakeArrayChunk(a.m_key, move(values));
+  }
+
+  vector<uint64_t> words(kBitmapWords);
+  uint32_t popCount = 0;
+  if (b.m_type == ChunkType::Bitmap)
+  {
+    popCount = ApplyToWords<AndNotWords>(a.m_words.data(), b.m_words.data(), words.data());
+  }
+  else
+  {
+    words = a.m_words;
+    popCount = a.m_popCount;
+    for (auto const value : b.m_values)
+      popCount -= ClearBit(words, value) ? 1 : 0;
+  }
+  return MakeBitmapChunk(a.m_key, move(words), popCount);
+}
+
+Chunk UniteChunks(Chunk const & lhs, Chunk const & rhs)
+{
+  ASSERT_EQUAL(lhs.m_key, rhs.m_key, ());
+  if (lhs.IsFull())
+    return lhs;
+  if (rhs.IsFull())
+    return rhs;
+
+  Chunk bufferA;
+  Chunk bufferB;
+  Chunk const & a = ExpandRuns(lhs, bufferA);
+  Chunk const & b = ExpandRuns(rhs, bufferB);
+
+  if (a.m_type == ChunkType::Array && b.m_type == ChunkType::Array)
+  {
+    vector<uint16_t> values;
+    values.reserve(a.m_values.size() + b.m_values.size());
+    set_union(a.m_values.begin(), a.m_values.end(), b.m_values.begin(), b.m_values.end(),
+              back_inserter(values));
+    return MakeArrayChunk(a.m_key, move(values));
+  }
+
+  vector<uint64_t> words(kBitmapWords);
+  uint32_t popCount = 0;
+  if (a.m_type == ChunkType::Bitmap && b.m_type == ChunkType::Bitmap)
+  {
+    popCount = ApplyToWords<OrWords>(a.m_words.data(), b.m_words.data(), words.data());
+  }
+  else
+  {
+    auto const & array = a.m_type == ChunkType::Array ? a : b;
+    auto const & bitmap = a.m_type == ChunkType::Array ? b : a;
+    words = bitmap.m_words;
+    popCount = bitmap.m_popCount;
+    for (auto const value : array.m_values)
+      popCount += SetBit(words, value) ? 1 : 0;
+  }
+  return MakeBitmapChunk(a.m_key, move(words), popCount);
+}
+
+uint64_t IntersectChunksPopCount(Chunk const & lhs, Chunk const & rhs)
+{
+  ASSERT_EQUAL(lhs.m_key, rhs.m_key, ());
+  if (lhs.IsFull())
+    return rhs.m_popCount;
+  if (rhs.IsFull())
+    return lhs.m_popCount;
+
+  Chunk bufferA;
+  Chunk bufferB;
+  Chunk const & a = ExpandRuns(lhs, bufferA);
+  Chunk const & b = ExpandRuns(rhs, bufferB);
+
+  if (a.m_type == ChunkType::Bitmap && b.m_type == ChunkType::Bitmap)
+    return ApplyToWords<AndWords>(a.m_words.data(), b.m_words.data(), nullptr /* res */);
+
+  uint64_t popCount = 0;
+  if (a.m_type == ChunkType::Array && b.m_type == ChunkType::Array)
+  {
+    auto i = a.m_values.begin();
+    auto j = b.m_values.begin();
+    while (i != a.m_values.end() && j != b.m_values.end())
+    {
+      if (*i < *j)
+      {
+        ++i;
+      }
+      else if (*j < *i)
+      {
+        ++j;
+      }
+      else
+      {
+        ++popCount;
+        ++i;
+        ++j;
+      }
+    }
+    return popCount;
+  }
+
+  auto const & array = a.m_type == ChunkType::Array ? a : b;
+  auto const & bitmap = a.m_type == ChunkType::Array ? b : a;
+  for (auto const value : array.m_values)
+    popCount += TestBit(bitmap.m_words, value) ? 1 : 0;
+  return popCount;
+}
+
+// In-place versions of the operations above. They fall back to building a new chunk
+// when the container of |lhs| can't be updated in place.
+void IntersectChunkWith(Chunk & lhs, Chunk const & rhs)
+{
+  if (rhs.IsFull())
+    return;
+
+  Chunk buffer;
+  Chunk const & b = ExpandRuns(rhs, buffer);
+  if (lhs.m_type == ChunkType::Bitmap && b.m_type == ChunkType::Bitmap)
+  {
+    lhs.m_popCount = ApplyToWords<AndWords>(lhs.m_words.data(), b.m_words.data(),
+                                            lhs.m_words.data());
+    Normalize(lhs);
+    return;
+  }
+
+  if (lhs.m_type == ChunkType::Array)
+  {
+    auto & values = lhs.m_values;
+    if (b.m_type == ChunkType::Bitmap)
+    {
+      base::EraseIf(values, [&b](uint16_t value) { return !TestBit(b.m_words, value); });
+    }
+    else
+    {
+      auto j = b.m_values.begin();
+      base::EraseIf(values, [&](uint16_t value) {
+        j = lower_bound(j, b.m_values.end(), value);
+        return j == b.m_values.end() || *j != value;
+      });
+    }
+    lhs.m_popCount = static_cast<uint32_t>(values.size());
+    return;
+  }
+
+  lhs = IntersectChunks(lhs, rhs);
+}
+
+void SubtractChunkWith(Chunk & lhs, Chunk const & rhs)
+{
+  Chunk buffer;
+  Chunk const & b = rhs.IsFull() ? rhs : ExpandRuns(rhs, buffer);
+  if (lhs.m_type == ChunkType::Bitmap && b.m_type == ChunkType::Bitmap)
+  {
+    lhs.m_popCount = ApplyToWords<AndNotWords>(lhs.m_words.data(), b.m_words.data(),
+                                               lhs.m_words.data());
+    Normalize(lhs);
+    return;
+  }
+
+  if (lhs.m_type == ChunkType::Bitmap && b.m_type == ChunkType::Array)
+  {
+    for (auto const value : b.m_values)
+      lhs.m_popCount -= ClearBit(lhs.m_words, value) ? 1 : 0;
+    Normalize(lhs);
+    return;
+  }
+
+  lhs = SubtractChunks(lhs, rhs);
+}
+
+void UniteChunkWith(Chunk & lhs, Chunk const & rhs)
+{
+  if (lhs.IsFull())
+    return;
+
+  Chunk buffer;
+  Chunk const & b = rhs.IsFull() ? rhs : ExpandRuns(rhs, buffer);
+  if (lhs.m_type == ChunkType::Bitmap && b.m_type == ChunkType::Bitmap)
+  {
+    lhs.m_popCount = ApplyToWords<OrWords>(lhs.m_words.data(), b.m_words.data(),
+                                           lhs.m_words.data());
+    return;
+  }
+
+  if (lhs.m_type == ChunkType::Bitmap && b.m_type == ChunkType::Array)
+  {
+    for (auto const value : b.m_values)
+      lhs.m_popCount += SetBit(lhs.m_words, value) ? 1 : 0;
+    return;
+  }
+
+  lhs = UniteChunks(lhs, rhs);
+}
+
 struct IntersectOp
 {
   IntersectOp() {}
@@ -55,6 +550,34 @@ struct IntersectOp
     set_intersection(a.Begin(), a.End(), b.Begin(), b.End(), back_inserter(resPos));
     return make_unique<coding::SparseCBV>(move(resPos));
   }
+
+  unique_ptr<coding::CompressedBitVector> operator()(coding::ChunkedCBV const & a,
+                                                     coding::ChunkedCBV const & b) const
+  {
+    vector<Chunk> chunks;
+    for (size_t i = 0, j = 0; i < a.NumChunks() && j < b.NumChunks();)
+    {
+      auto const & chunkA = a.GetChunk(i);
+      auto const & chunkB = b.GetChunk(j);
+      if (chunkA.m_key < chunkB.m_key)
+      {
+        ++i;
+      }
+      else if (chunkB.m_key < chunkA.m_key)
+      {
+        ++j;
+      }
+      else
+      {
+        auto chunk = IntersectChunks(chunkA, chunkB);
+        if (chunk.m_popCount != 0)
+          chunks.push_back(move(chunk));
+        ++i;
+        ++j;
+      }
+    }
+    return make_unique<coding::ChunkedCBV>(move(chunks));
+  }
 };
 
 struct SubtractOp
@@ -118,6 +641,30 @@ struct SubtractOp
     set_difference(a.Begin(), a.End(), b.Begin(), b.End(), back_inserter(resPos));
     return CompressedBitVectorBuilder::FromBitPositions(move(resPos));
   }
+
+  unique_ptr<coding::CompressedBitVector> operator()(coding::ChunkedCBV const & a,
+                                                     coding::ChunkedCBV const & b) const
+  {
+    vector<Chunk> chunks;
+    size_t j = 0;
+    for (size_t i = 0; i < a.NumChunks(); ++i)
+    {
+      auto const & chunkA = a.GetChunk(i);
+      while (j < b.NumChunks() && b.GetChunk(j).m_key < chunkA.m_key)
+        ++j;
+
+      if (j == b.NumChunks() || b.GetChunk(j).m_key != chunkA.m_key)
+      {
+        chunks.push_back(chunkA);
+        continue;
+      }
+
+      auto chunk = SubtractChunks(chunkA, b.GetChunk(j));
+      if (chunk.m_popCount != 0)
+        chunks.push_back(move(chunk));
+    }
+    return make_unique<coding::ChunkedCBV>(move(chunks));
+  }
 };
 
 struct UnionOp
@@ -211,6 +758,31 @@ struct UnionOp
     set_union(a.Begin(), a.End(), b.Begin(), b.End(), back_inserter(resPos));
     return CompressedBitVectorBuilder::FromBitPositions(move(resPos));
   }
+
+  unique_ptr<coding::CompressedBitVector> operator()(coding::ChunkedCBV const & a,
+                                                     coding::ChunkedCBV const & b) const
+  {
+    vector<Chunk> chunks;
+    chunks.reserve(a.NumChunks() + b.NumChunks());
+    size_t i = 0;
+    size_t j = 0;
+    while (i < a.NumChunks() || j < b.NumChunks())
+    {
+      if (j == b.NumChunks() || (i < a.NumChunks() && a.GetChunk(i).m_key < b.GetChunk(j).m_key))
+      {
+        chunks.push_back(a.GetChunk(i++));
+      }
+      else if (i == a.NumChunks() || b.GetChunk(j).m_key < a.GetChunk(i).m_key)
+      {
+        chunks.push_back(b.GetChunk(j++));
+      }
+      else
+      {
+        chunks.push_back(UniteChunks(a.GetChunk(i++), b.GetChunk(j++)));
+      }
+    }
+    return make_unique<coding::ChunkedCBV>(move(chunks));
+  }
 };
 
 template <typename TBinaryOp>
@@ -220,6 +792,12 @@ unique_ptr<coding::CompressedBitVector> Apply(TBinaryOp const & op, CompressedBi
   using strat = CompressedBitVector::StorageStrategy;
   auto const stratA = lhs.GetStorageStrategy();
   auto const stratB = rhs.GetStorageStrategy();
+  if (stratA == strat::Chunked || stratB == strat::Chunked)
+  {
+    unique_ptr<ChunkedCBV> bufferA;
+    unique_ptr<ChunkedCBV> bufferB;
+    return op(ChunkedCBV::AsChunked(lhs, bufferA), ChunkedCBV::AsChunked(rhs, bufferB));
+  }
   if (stratA == strat::Dense && stratB == strat::Dense)
   {
     DenseCBV const & a = static_cast<DenseCBV const &>(lhs);
@@ -417,6 +995,235 @@ unique_ptr<CompressedBitVector> SparseCBV::Clone() const
   return unique_ptr<CompressedBitVector>(cbv);
 }
 
+ChunkedCBV::ChunkedCBV(vector<uint64_t> const & setBits)
+{
+  ASSERT(is_sorted(setBits.begin(), setBits.end()), ());
+  ASSERT(adjacent_find(setBits.begin(), setBits.end()) == setBits.end(), ());
+
+  for (auto begin = setBits.begin(); begin != setBits.end();)
+  {
+    uint64_t const key = *begin >> kChunkBits;
+    auto const end = find_if(begin, setBits.end(),
+                             [key](uint64_t pos) { return (pos >> kChunkBits) != key; });
+    m_chunks.push_back(BuildChunk(key, begin, end));
+    begin = end;
+  }
+  m_popCount = setBits.size();
+}
+
+ChunkedCBV::ChunkedCBV(vector<Chunk> && chunks) : m_chunks(move(chunks))
+{
+  ASSERT(is_sorted(m_chunks.begin(), m_chunks.end(),
+                   [](Chunk const & lhs, Chunk const & rhs) { return lhs.m_key < rhs.m_key; }),
+         ());
+  UpdatePopCount();
+}
+
+// static
+unique_ptr<ChunkedCBV> ChunkedCBV::BuildFromRange(uint64_t begin, uint64_t end)
+{
+  auto cbv = make_unique<ChunkedCBV>();
+  for (uint64_t first = begin; first < end;)
+  {
+    uint64_t const key = first >> kChunkBits;
+    uint64_t const last = min(end, (key + 1) << kChunkBits) - 1;
+
+    Chunk chunk;
+    chunk.m_key = key;
+    chunk.m_type = Chunk::Type::Run;
+    chunk.m_popCount = static_cast<uint32_t>(last - first + 1);
+    chunk.m_runs.push_back({static_cast<uint16_t>(first - (key << kChunkBits)),
+                            static_cast<uint16_t>(last - (key << kChunkBits))});
+    cbv->m_chunks.push_back(move(chunk));
+
+    first = last + 1;
+  }
+  cbv->UpdatePopCount();
+  return cbv;
+}
+
+// static
+ChunkedCBV const & ChunkedCBV::AsChunked(CompressedBitVector const & cbv,
+                                         unique_ptr<ChunkedCBV> & buffer)
+{
+  if (cbv.GetStorageStrategy() == StorageStrategy::Chunked)
+    return static_cast<ChunkedCBV const &>(cbv);
+
+  vector<uint64_t> setBits;
+  setBits.reserve(static_cast<size_t>(cbv.PopCount()));
+  CompressedBitVectorEnumerator::ForEach(cbv, [&setBits](uint64_t pos) { setBits.push_back(pos); });
+  buffer = make_unique<ChunkedCBV>(setBits);
+  return *buffer;
+}
+
+void ChunkedCBV::IntersectWith(ChunkedCBV const & rhs)
+{
+  if (&rhs == this)
+    return;
+
+  size_t numChunks = 0;
+  size_t j = 0;
+  for (size_t i = 0; i < m_chunks.size(); ++i)
+  {
+    auto & chunk = m_chunks[i];
+    while (j < rhs.m_chunks.size() && rhs.m_chunks[j].m_key < chunk.m_key)
+      ++j;
+    if (j == rhs.m_chunks.size())
+      break;
+    if (rhs.m_chunks[j].m_key != chunk.m_key)
+      continue;
+
+    IntersectChunkWith(chunk, rhs.m_chunks[j]);
+    if (chunk.m_popCount == 0)
+      continue;
+    if (numChunks != i)
+      m_chunks[numChunks] = move(chunk);
+    ++numChunks;
+  }
+  m_chunks.resize(numChunks);
+  UpdatePopCount();
+}
+
+void ChunkedCBV::SubtractWith(ChunkedCBV const & rhs)
+{
+  if (&rhs == this)
+  {
+    m_chunks.clear();
+    m_popCount = 0;
+    return;
+  }
+
+  size_t numChunks = 0;
+  size_t j = 0;
+  for (size_t i = 0; i < m_chunks.size(); ++i)
+  {
+    auto & chunk = m_chunks[i];
+    while (j < rhs.m_chunks.size() && rhs.m_chunks[j].m_key < chunk.m_key)
+      ++j;
+    if (j < rhs.m_chunks.size() && rhs.m_chunks[j].m_key == chunk.m_key)
+      SubtractChunkWith(chunk, rhs.m_chunks[j]);
+
+    if (chunk.m_popCount == 0)
+      continue;
+    if (numChunks != i)
+      m_chunks[numChunks] = move(chunk);
+    ++numChunks;
+  }
+  m_chunks.resize(numChunks);
+  UpdatePopCount();
+}
+
+void ChunkedCBV::UnionWith(ChunkedCBV const & rhs)
+{
+  if (&rhs == this)
+    return;
+
+  vector<Chunk> chunks;
+  chunks.reserve(m_chunks.size() + rhs.m_chunks.size());
+  size_t i = 0;
+  size_t j = 0;
+  while (i < m_chunks.size() || j < rhs.m_chunks.size())
+  {
+    if (j == rhs.m_chunks.size() ||
+        (i < m_chunks.size() && m_chunks[i].m_key < rhs.m_chunks[j].m_key))
+    {
+      chunks.push_back(move(m_chunks[i++]));
+    }
+    else if (i == m_chunks.size() || rhs.m_chunks[j].m_key < m_chunks[i].m_key)
+    {
+      chunks.push_back(rhs.m_chunks[j++]);
+    }
+    else
+    {
+      UniteChunkWith(m_chunks[i], rhs.m_chunks[j++]);
+      chunks.push_back(move(m_chunks[i++]));
+    }
+  }
+  m_chunks.swap(chunks);
+  UpdatePopCount();
+}
+
+uint64_t ChunkedCBV::PopCount() const { return m_popCount; }
+
+bool ChunkedCBV::GetBit(uint64_t pos) const
+{
+  uint64_t const key = pos >> kChunkBits;
+  auto const it = lower_bound(m_chunks.begin(), m_chunks.end(), key,
+                              [](Chunk const & chunk, uint64_t key) { return chunk.m_key < key; });
+  if (it == m_chunks.end() || it->m_key != key)
+    return false;
+
+  auto const value = static_cast<uint16_t>(pos - (key << kChunkBits));
+  switch (it->m_type)
+  {
+  case Chunk::Type::Array: return binary_search(it->m_values.begin(), it->m_values.end(), value);
+  case Chunk::Type::Bitmap: return TestBit(it->m_words, value);
+  case Chunk::Type::Run:
+  {
+    auto const run = upper_bound(it->m_runs.begin(), it->m_runs.end(), value,
+                                 [](uint16_t value, Run const & run) { return value < run.m_first; });
+    return run != it->m_runs.begin() && value <= prev(run)->m_last;
+  }
+  }
+  UNREACHABLE();
+}
+
+unique_ptr<CompressedBitVector> ChunkedCBV::LeaveFirstSetNBits(uint64_t n) const
+{
+  if (PopCount() <= n)
+    return Clone();
+
+  vector<Chunk> chunks;
+  for (size_t i = 0; i < m_chunks.size() && n != 0; ++i)
+  {
+    auto const & chunk = m_chunks[i];
+    if (chunk.m_popCount <= n)
+    {
+      n -= chunk.m_popCount;
+      chunks.push_back(chunk);
+      continue;
+    }
+
+    vector<uint16_t> values;
+    ToArray(chunk, values);
+    values.resize(static_cast<size_t>(n));
+    chunks.push_back(MakeArrayChunk(chunk.m_key, move(values)));
+    n = 0;
+  }
+  return make_unique<ChunkedCBV>(move(chunks));
+}
+
+CompressedBitVector::StorageStrategy ChunkedCBV::GetStorageStrategy() const
+{
+  return CompressedBitVector::StorageStrategy::Chunked;
+}
+
+void ChunkedCBV::Serialize(Writer & writer) const
+{
+  vector<uint64_t> setBits;
+  setBits.reserve(static_cast<size_t>(PopCount()));
+  ForEach([&setBits](uint64_t pos) { setBits.push_back(pos); });
+  CompressedBitVectorBuilder::FromBitPositions(move(setBits))->Serialize(writer);
+}
+
+unique_ptr<CompressedBitVector> ChunkedCBV::Clone() const
+{
+  auto cbv = make_unique<ChunkedCBV>();
+  cbv->m_chunks = m_chunks;
+  cbv->m_popCount = m_popCount;
+  return cbv;
+}
+
+void ChunkedCBV::UpdatePopCount()
+{
+  m_popCount = 0;
+  for (auto const & chunk : m_chunks)
+  {
+    ASSERT_NOT_EQUAL(chunk.m_popCount, 0, ());
+    m_popCount += chunk.m_popCount;
+  }
+}
+
 // static
 unique_ptr<CompressedBitVector> CompressedBitVectorBuilder::FromBitPositions(
     vector<uint64_t> const & setBits)
@@ -468,6 +1275,7 @@ string DebugPrint(CompressedBitVector::StorageStrategy strat)
   {
   case CompressedBitVector::StorageStrategy::Dense: return "Dense";
   case CompressedBitVector::StorageStrategy::Sparse: return "Sparse";
+  case CompressedBitVector::StorageStrategy::Chunked: return "Chunked";
   }
   UNREACHABLE();
 }
@@ -496,6 +1304,42 @@ unique_ptr<CompressedBitVector> CompressedBitVector::Union(CompressedBitVector c
   return Apply(op, lhs, rhs);
 }
 
+// static
+uint64_t CompressedBitVector::IntersectionPopCount(CompressedBitVector const & lhs,
+                                                   CompressedBitVector const & rhs)
+{
+  using strat = CompressedBitVector::StorageStrategy;
+  if (lhs.GetStorageStrategy() != strat::Chunked && rhs.GetStorageStrategy() != strat::Chunked)
+    return Intersect(lhs, rhs)->PopCount();
+
+  unique_ptr<ChunkedCBV> bufferA;
+  unique_ptr<ChunkedCBV> bufferB;
+  auto const & a = ChunkedCBV::AsChunked(lhs, bufferA);
+  auto const & b = ChunkedCBV::AsChunked(rhs, bufferB);
+
+  uint64_t popCount = 0;
+  for (size_t i = 0, j = 0; i < a.NumChunks() && j < b.NumChunks();)
+  {
+    auto const & chunkA = a.GetChunk(i);
+    auto const & chunkB = b.GetChunk(j);
+    if (chunkA.m_key < chunkB.m_key)
+    {
+      ++i;
+    }
+    else if (chunkB.m_key < chunkA.m_key)
+    {
+      ++j;
+    }
+    else
+    {
+      popCount += IntersectChunksPopCount(chunkA, chunkB);
+      ++i;
+      ++j;
+    }
+  }
+  return popCount;
+}
+
 // static
 bool CompressedBitVector::IsEmpty(unique_ptr<CompressedBitVector> const & cbv)
 {
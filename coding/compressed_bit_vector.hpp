@@ -5,6 +5,7 @@
 #include "coding/writer.hpp"
 
 #include "base/assert.hpp"
+#include "base/bits.hpp"
 #include "base/control_flow.hpp"
 #include "base/ref_counted.hpp"
 
@@ -23,7 +24,9 @@ public:
   enum class StorageStrategy
   {
     Dense,
-    Sparse
+    Sparse,
+    // In-memory only, see ChunkedCBV.
+    Chunked
   };
 
   virtual ~CompressedBitVector() = default;
@@ -51,6 +54,11 @@ public:
   static std::unique_ptr<CompressedBitVector> Union(CompressedBitVector const & lhs,
                                                     CompressedBitVector const & rhs);
 
+  // Returns the number of set bits in the intersection of two bit vectors.
+  // The intersection is not built if any of the bit vectors is chunked.
+  static uint64_t IntersectionPopCount(CompressedBitVector const & lhs,
+                                       CompressedBitVector const & rhs);
+
   static bool IsEmpty(std::unique_ptr<CompressedBitVector> const & cbv);
 
   static bool IsEmpty(CompressedBitVector const * cbv);
@@ -178,6 +186,129 @@ private:
   std::vector<uint64_t> m_positions;
 };
 
+// A bit vector which is split into chunks of 2^16 bits like Roaring bitmaps. Every non-empty
+// chunk is stored in a container which suits its contents best: a sorted array of low 16 bits
+// of the positions, a bitmap or a list of runs of consecutive set bits. Set operations work
+// chunk by chunk, bitmaps are processed by vectorized kernels and results may be built in place.
+// This strategy is used for in-memory bit vectors only, it's serialized as Dense or Sparse.
+class ChunkedCBV : public CompressedBitVector
+{
+public:
+  static uint8_t constexpr kChunkBits = 16;
+  static uint64_t constexpr kChunkSize = static_cast<uint64_t>(1) << kChunkBits;
+  static size_t constexpr kBitmapWords = kChunkSize / 64;
+  // Arrays with more values take more memory than bitmaps.
+  static size_t constexpr kMaxArraySize = 4096;
+
+  // Run of set bits [m_first, m_last] of a chunk.
+  struct Run
+  {
+    uint16_t m_first = 0;
+    uint16_t m_last = 0;
+  };
+
+  struct Chunk
+  {
+    enum class Type : uint8_t
+    {
+      Array,
+      Bitmap,
+      Run
+    };
+
+    bool IsFull() const { return m_popCount == kChunkSize; }
+
+    // Position of the first bit of the chunk is |m_key| << kChunkBits.
+    uint64_t m_key = 0;
+    Type m_type = Type::Array;
+    uint32_t m_popCount = 0;
+
+    // Only the container of |m_type| is used.
+    std::vector<uint16_t> m_values;
+    std::vector<uint64_t> m_words;
+    std::vector<Run> m_runs;
+  };
+
+  ChunkedCBV() = default;
+
+  // Builds a chunked CBV from a sorted list of positions of set bits.
+  explicit ChunkedCBV(std::vector<uint64_t> const & setBits);
+
+  // |chunks| must be non-empty and sorted by keys.
+  explicit ChunkedCBV(std::vector<Chunk> && chunks);
+
+  // Builds a chunked CBV with bits from [begin, end) set.
+  static std::unique_ptr<ChunkedCBV> BuildFromRange(uint64_t begin, uint64_t end);
+
+  // Returns |cbv| if it's chunked, otherwise converts it to |buffer| and returns |*buffer|.
+  static ChunkedCBV const & AsChunked(CompressedBitVector const & cbv,
+                                      std::unique_ptr<ChunkedCBV> & buffer);
+
+  // Set operations which modify the current bit vector.
+  void IntersectWith(ChunkedCBV const & rhs);
+  void SubtractWith(ChunkedCBV const & rhs);
+  void UnionWith(ChunkedCBV const & rhs);
+
+  size_t NumChunks() const { return m_chunks.size(); }
+  Chunk const & GetChunk(size_t i) const { return m_chunks[i]; }
+
+  template <typename Fn>
+  void ForEach(Fn && f) const
+  {
+    base::ControlFlowWrapper<Fn> wrapper(std::forward<Fn>(f));
+    for (auto const & chunk : m_chunks)
+    {
+      uint64_t const offset = chunk.m_key << kChunkBits;
+      switch (chunk.m_type)
+      {
+      case Chunk::Type::Array:
+        for (auto const value : chunk.m_values)
+        {
+          if (wrapper(offset + value) == base::ControlFlow::Break)
+            return;
+        }
+        break;
+      case Chunk::Type::Bitmap:
+        for (size_t i = 0; i < chunk.m_words.size(); ++i)
+        {
+          for (uint64_t word = chunk.m_words[i]; word != 0; word &= word - 1)
+          {
+            uint64_t const bit = bits::FloorLog(word & (~word + 1));
+            if (wrapper(offset + 64 * i + bit) == base::ControlFlow::Break)
+              return;
+          }
+        }
+        break;
+      case Chunk::Type::Run:
+        for (auto const & run : chunk.m_runs)
+        {
+          for (uint64_t value = run.m_first; value <= run.m_last; ++value)
+          {
+            if (wrapper(offset + value) == base::ControlFlow::Break)
+              return;
+          }
+        }
+        break;
+      }
+    }
+  }
+
+  // CompressedBitVector overrides:
+  uint64_t PopCount() const override;
+  bool GetBit(uint64_t pos) const override;
+  std::unique_ptr<CompressedBitVector> LeaveFirstSetNBits(uint64_t n) const override;
+  StorageStrategy GetStorageStrategy() const override;
+  void Serialize(Writer & writer) const override;
+  std::unique_ptr<CompressedBitVector> Clone() const override;
+
+private:
+  void UpdatePopCount();
+
+  // Non-empty chunks sorted by keys.
+  std::vector<Chunk> m_chunks;
+  uint64_t m_popCount = 0;
+};
+
 class CompressedBitVectorBuilder
 {
 public:
@@ -223,6 +354,8 @@ public:
       rw::ReadVectorOfPOD(src, setBits);
       return std::make_unique<SparseCBV>(std::move(setBits));
     }
+    // Chunked bit vectors are serialized as dense or sparse ones.
+    case CompressedBitVector::StorageStrategy::Chunked: break;
     }
     return std::unique_ptr<CompressedBitVector>();
   }
@@ -252,6 +385,12 @@ public:
       sparseCBV.ForEach(f);
       return;
     }
+    case CompressedBitVector::StorageStrategy::Chunked:
+    {
+      ChunkedCBV const & chunkedCBV = static_cast<ChunkedCBV const &>(cbv);
+      chunkedCBV.ForEach(f);
+      return;
+    }
     }
   }
 };
@@ -29,6 +29,7 @@
 #define INDEX_FILE_TAG "idx"
 #define SEARCH_INDEX_FILE_TAG "sdx"
 #define SEARCH_ADDRESS_FILE_TAG "addr"
+#define SEARCH_ADDRESS_INDEX_FILE_TAG "addr_index"
 #define POSTCODE_POINTS_FILE_TAG "postcode_points"
 #define POSTCODES_FILE_TAG "postcodes"
 #define CITIES_BOUNDARIES_FILE_TAG "cities_boundaries"
@@ -57,6 +58,11 @@
 #define DESCRIPTIONS_FILE_TAG "descriptions"
 #define MAXSPEEDS_FILE_TAG "maxspeeds"
 #define ROUTING_WORLD_FILE_TAG "routing_world"
+#define ROUTING_CH_FILE_TAG "routing_ch"
+#define ROUTING_LANDMARKS_FILE_TAG "routing_landmarks"
+#define ROUTING_GEOMETRY_FILE_TAG "routing_geometry"
+#define ROUTING_SEGMENTS_FILE_TAG "routing_segments"
+#define SPEED_PROFILES_FILE_TAG "speed_profiles"
 
 #define READY_FILE_EXTENSION ".ready"
 #define RESUME_FILE_EXTENSION ".resume"
@@ -765,16 +765,17 @@ void DrapeEngine::EnableTraffic(bool trafficEnabled)
 
 void DrapeEngine::UpdateTraffic(traffic::TrafficInfo const & info)
 {
-  if (info.GetColoring().empty())
+  if (info.IsEmpty())
     return;
 
+  auto coloring = info.GetColoring();
 #ifdef DEBUG
-  for (auto const & segmentPair : info.GetColoring())
+  for (auto const & segmentPair : coloring)
     ASSERT_NOT_EQUAL(segmentPair.second, traffic::SpeedGroup::Unknown, ());
 #endif
 
   df::TrafficSegmentsColoring segmentsColoring;
-  segmentsColoring.emplace(info.GetMwmId(), info.GetColoring());
+  segmentsColoring.emplace(info.GetMwmId(), std::move(coloring));
 
   m_threadCommutator->PostMessage(ThreadsCommutator::ResourceUploadThread,
                                   make_unique_dp<UpdateTrafficMessage>(std::move(segmentsColoring)),
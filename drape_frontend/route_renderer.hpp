@@ -24,6 +24,8 @@ extern std::string const kRouteColor;
 extern std::string const kRouteOutlineColor;
 extern std::string const kRoutePedestrian;
 extern std::string const kRouteBicycle;
+extern std::string const kRouteFakeColor;
+extern std::string const kRouteFakeOutlineColor;
 extern std::string const kTransitStopInnerMarkerColor;
 
 class RouteRenderer final
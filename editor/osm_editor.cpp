@@ -614,6 +614,17 @@ bool Editor::HaveMapEditsToUpload(MwmSet::MwmId const & mwmId) const
   return false;
 }
 
+bool Editor::HaveMapEdits(MwmSet::MwmId const & mwmId) const
+{
+  if (!mwmId.IsAlive())
+    return false;
+
+  auto const features = m_features.Get();
+
+  auto const found = features->find(mwmId);
+  return found != features->cend() && !found->second.empty();
+}
+
 void Editor::UploadChanges(string const & key, string const & secret, ChangesetTags tags,
                            FinishUploadCallback callback)
 {
@@ -157,6 +157,8 @@ public:
 
   bool HaveMapEditsOrNotesToUpload() const;
   bool HaveMapEditsToUpload(MwmSet::MwmId const & mwmId) const;
+  /// @returns true if any feature of the mwm was created, edited or deleted.
+  bool HaveMapEdits(MwmSet::MwmId const & mwmId) const;
 
   using ChangesetTags = std::map<std::string, std::string>;
   /// Tries to upload all local changes to OSM server in a separate thread.
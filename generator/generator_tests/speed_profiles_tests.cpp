@@ -0,0 +1,85 @@
+#include "testing/testing.hpp"
+
+#include "generator/speed_profiles_builder.hpp"
+
+#include "routing/speed_profiles.hpp"
+
+#include "routing_common/vehicle_model.hpp"
+
+#include "platform/platform.hpp"
+#include "platform/platform_tests_support/scoped_dir.hpp"
+#include "platform/platform_tests_support/scoped_file.hpp"
+
+#include "base/file_name_utils.hpp"
+#include "base/geo_object_id.hpp"
+
+#include <string>
+
+namespace speed_profiles_tests
+{
+using namespace platform::tests_support;
+using namespace routing;
+using namespace routing_builder;
+using namespace std;
+
+// Directory name for creating temporary files.
+string const kTestDir = "speed_profiles_generation_test";
+// File name for keeping speed profiles.
+string const kCsv = "speed_profiles.csv";
+
+bool ParseCsv(string const & csvContent, string const & country, SpeedProfilesData & data)
+{
+  string const testDirFullPath = base::JoinPath(GetPlatform().WritableDir(), kTestDir);
+  ScopedDir testScopedDir(kTestDir);
+  ScopedFile testScopedCsv(base::JoinPath(kTestDir, kCsv), csvContent);
+
+  return ParseSpeedProfiles(base::JoinPath(testDirFullPath, kCsv), country, data);
+}
+
+UNIT_TEST(SpeedProfiles_ParseEmpty)
+{
+  SpeedProfilesData data;
+  TEST(ParseCsv("", "Country", data), ());
+  TEST(data.m_ways.empty(), ());
+  TEST(data.m_highwayTypes.empty(), ());
+}
+
+UNIT_TEST(SpeedProfiles_ParseInterpolation)
+{
+  auto const primary = static_cast<uint32_t>(HighwayType::HighwayPrimary);
+  string const csv =
+      "Country," + to_string(primary) + ",0,1,0,1.0\n"
+      "Country," + to_string(primary) + ",0,1,10,0.5\n"
+      "Other Country," + to_string(primary) + ",0,1,5,2.0\n"
+      "Country,0,25,0,3,0.8\n";
+
+  SpeedProfilesData data;
+  TEST(ParseCsv(csv, "Country", data), ());
+
+  TEST_EQUAL(data.m_highwayTypes.size(), 1, ());
+  auto const & ratios = data.m_highwayTypes.at(HighwayType::HighwayPrimary);
+  TEST_EQUAL(ratios[0], 100, ());
+  TEST_EQUAL(ratios[5], 75, ());
+  TEST_EQUAL(ratios[10], 50, ());
+  // The hours after the last known one are interpolated with the first hour of the week.
+  auto const lastHour = SpeedProfile::kKnotsNumber - 1;
+  TEST_EQUAL(ratios[lastHour],
+             SpeedProfile::QuantizeRatio(0.5 + 0.5 * (lastHour - 10.0) / (lastHour + 1 - 10.0)),
+             ());
+
+  // A single known hour is the ratio of the whole week.
+  TEST_EQUAL(data.m_ways.size(), 1, ());
+  auto const & wayRatios = data.m_ways.at({base::MakeOsmWay(25), false /* forward */});
+  for (auto const ratio : wayRatios)
+    TEST_EQUAL(ratio, 80, ());
+}
+
+UNIT_TEST(SpeedProfiles_ParseWrong)
+{
+  SpeedProfilesData data;
+  TEST(!ParseCsv("Country,1,0,1,168,1.0\n", "Country", data), ());
+  TEST(!ParseCsv("Country,1,0,2,0,1.0\n", "Country", data), ());
+  TEST(!ParseCsv("Country,1,0,1,0\n", "Country", data), ());
+  TEST(!ParseCsv("Country,1,0,1,0,-1.0\n", "Country", data), ());
+}
+}  // namespace speed_profiles_tests
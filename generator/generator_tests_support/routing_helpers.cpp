@@ -73,6 +73,14 @@ void TestGeometryLoader::SetPassThroughAllowed(uint32_t featureId, bool passThro
   m_roads[featureId].SetPassThroughAllowedForTests(passThroughAllowed);
 }
 
+void TestGeometryLoader::SetSpeedProfiles(uint32_t featureId, SpeedProfile forward,
+                                          SpeedProfile backward)
+{
+  auto const it = m_roads.find(featureId);
+  CHECK(it != m_roads.end(), ("No feature", featureId));
+  it->second.SetSpeedProfiles(forward, backward);
+}
+
 std::shared_ptr<EdgeEstimator> CreateEstimatorForCar(std::shared_ptr<TrafficStash> trafficStash)
 {
   auto const carModel = CarModelFactory({}).GetVehicleModel();
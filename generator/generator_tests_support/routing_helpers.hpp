@@ -40,6 +40,8 @@ public:
 
   void SetPassThroughAllowed(uint32_t featureId, bool passThroughAllowed);
 
+  void SetSpeedProfiles(uint32_t featureId, SpeedProfile forward, SpeedProfile backward);
+
 private:
   std::unordered_map<uint32_t, RoadGeometry> m_roads;
 };
@@ -26,6 +26,7 @@
 #include "generator/routing_index_generator.hpp"
 #include "generator/routing_world_roads_generator.hpp"
 #include "generator/search_index_builder.hpp"
+#include "generator/speed_profiles_builder.hpp"
 #include "generator/statistics.hpp"
 #include "generator/traffic_generator.hpp"
 #include "generator/transit_generator.hpp"
@@ -139,6 +140,12 @@ DEFINE_bool(make_routing_index, false, "Make sections with the routing informati
 DEFINE_bool(make_cross_mwm, false,
             "Make section for cross mwm routing (for dynamic indexed routing).");
 DEFINE_bool(make_transit_cross_mwm, false, "Make section for cross mwm transit routing.");
+DEFINE_bool(make_routing_contraction_hierarchy, false,
+            "Make section with contraction hierarchy for car routing inside mwm.");
+DEFINE_bool(make_routing_landmarks, false,
+            "Make section with landmark distances for A* heuristic of car routing.");
+DEFINE_bool(make_routing_geometry, false,
+            "Make section with road points and attributes for routing without decoding features.");
 DEFINE_bool(make_transit_cross_mwm_experimental, false,
             "Experimental parameter. If set the new version of transit cross-mwm section will be "
             "generated. Makes section for cross mwm transit routing.");
@@ -160,6 +167,9 @@ DEFINE_bool(
     make_city_roads, false,
     "Calculates which roads lie inside cities and makes a section with ids of these roads.");
 DEFINE_bool(generate_maxspeed, false, "Generate section with maxspeed of road features.");
+DEFINE_string(speed_profiles_path, "",
+              "Path to csv file with weekly speed profiles of roads which is made by "
+              "track_analyzer. If set, the section with speed profiles is generated.");
 
 // Sponsored-related.
 DEFINE_string(complex_hierarchy_data, "", "Path to complex hierarchy in csv format.");
@@ -313,8 +323,9 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
   // Load mwm tree only if we need it
   unique_ptr<storage::CountryParentGetter> countryParentGetter;
   if (FLAGS_make_routing_index || FLAGS_make_cross_mwm || FLAGS_make_transit_cross_mwm ||
-      FLAGS_make_transit_cross_mwm_experimental || !FLAGS_uk_postcodes_dataset.empty() ||
-      !FLAGS_us_postcodes_dataset.empty())
+      FLAGS_make_transit_cross_mwm_experimental || FLAGS_make_routing_contraction_hierarchy ||
+      FLAGS_make_routing_landmarks || FLAGS_make_routing_geometry ||
+      !FLAGS_uk_postcodes_dataset.empty() || !FLAGS_us_postcodes_dataset.empty())
   {
     countryParentGetter = make_unique<storage::CountryParentGetter>();
   }
@@ -520,6 +531,13 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
         LOG(LINFO, ("Generating maxspeeds section for", dataFile, "using", maxspeedsFilename));
         BuildMaxspeedsSection(routingGraph.get(), dataFile, osmToFeatureFilename, maxspeedsFilename);
       }
+
+      if (!FLAGS_speed_profiles_path.empty() &&
+          !BuildSpeedProfilesSection(dataFile, country, osmToFeatureFilename,
+                                     FLAGS_speed_profiles_path))
+      {
+        LOG(LERROR, ("Speed profiles build failed for", dataFile));
+      }
     }
 
     if (FLAGS_make_city_roads)
@@ -568,6 +586,48 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
       }
     }
 
+    if (FLAGS_make_routing_contraction_hierarchy)
+    {
+      if (!countryParentGetter)
+      {
+        // All the mwms should use proper VehicleModels.
+        LOG(LCRITICAL,
+            ("Countries file is needed. Please set countries file name (countries.txt). "
+             "File must be located in data directory."));
+        return EXIT_FAILURE;
+      }
+
+      BuildRoutingContractionHierarchySection(path, dataFile, country, *countryParentGetter);
+    }
+
+    if (FLAGS_make_routing_landmarks)
+    {
+      if (!countryParentGetter)
+      {
+        // All the mwms should use proper VehicleModels.
+        LOG(LCRITICAL,
+            ("Countries file is needed. Please set countries file name (countries.txt). "
+             "File must be located in data directory."));
+        return EXIT_FAILURE;
+      }
+
+      BuildRoutingLandmarksSection(path, dataFile, country, *countryParentGetter);
+    }
+
+    if (FLAGS_make_routing_geometry)
+    {
+      if (!countryParentGetter)
+      {
+        // All the mwms should use proper VehicleModels.
+        LOG(LCRITICAL,
+            ("Countries file is needed. Please set countries file name (countries.txt). "
+             "File must be located in data directory."));
+        return EXIT_FAILURE;
+      }
+
+      BuildRoutingGeometrySection(path, dataFile, country, *countryParentGetter);
+    }
+
     if (!FLAGS_wikipedia_pages.empty())
     {
       if (!FLAGS_idToWikidata.empty())
@@ -13,7 +13,11 @@
 #include "routing/index_graph_loader.hpp"
 #include "routing/index_graph_serialization.hpp"
 #include "routing/index_graph_starter_joints.hpp"
+#include "routing/joint_contraction_hierarchy.hpp"
+#include "routing/joint_landmarks.hpp"
 #include "routing/joint_segment.hpp"
+#include "routing/road_geometry_section.hpp"
+#include "routing/road_segments_index.hpp"
 #include "routing/vehicle_mask.hpp"
 #include "routing/world_graph.hpp"
 
@@ -25,6 +29,7 @@
 #include "routing_common/car_model.hpp"
 #include "routing_common/pedestrian_model.hpp"
 
+#include "indexer/altitude_loader.hpp"
 #include "indexer/feature.hpp"
 #include "indexer/feature_processor.hpp"
 
@@ -43,6 +48,7 @@
 #include "base/timer.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
 #include <functional>
 #include <limits>
@@ -689,6 +695,176 @@ void BuildRoutingCrossMwmSection(string const & path, string const & mwmFile,
   SerializeCrossMwm(mwmFile, CROSS_MWM_FILE_TAG, builder);
 }
 
+void BuildRoutingContractionHierarchySection(
+    string const & path, string const & mwmFile, string const & country,
+    CountryParentNameGetterFn const & countryParentNameGetterFn)
+{
+  LOG(LINFO, ("Building contraction hierarchy section for", country));
+
+  VehicleType const vhType = VehicleType::Car;
+  shared_ptr<VehicleModelInterface> vehicleModel =
+      CarModelFactory(countryParentNameGetterFn).GetVehicleModelForCountry(country);
+
+  MwmValue mwmValue(LocalCountryFile(path, platform::CountryFile(country), 0 /* version */));
+  uint32_t mwmNumRoads = DeserializeIndexGraphNumRoads(mwmValue, vhType);
+  IndexGraph graph(make_shared<Geometry>(GeometryLoader::CreateFromFile(mwmFile, vehicleModel), mwmNumRoads),
+                                         EdgeEstimator::Create(vhType, *vehicleModel,
+                                                               nullptr /* trafficStash */,
+                                                               nullptr /* dataSource */,
+                                                               nullptr /* numMvmIds */));
+  graph.SetCurrentTimeGetter([time = GetCurrentTimestamp()] { return time; });
+  DeserializeIndexGraph(mwmValue, vhType, graph);
+
+  JointContractionHierarchy const hierarchy = BuildJointContractionHierarchy(graph);
+
+  FilesContainerW cont(mwmFile, FileWriter::OP_WRITE_EXISTING);
+  auto writer = cont.GetWriter(ROUTING_CH_FILE_TAG);
+  auto const startPos = writer->Pos();
+  hierarchy.Serialize(*writer);
+  auto const sectionSize = writer->Pos() - startPos;
+
+  LOG(LINFO, ("Contraction hierarchy section generated, size:", sectionSize, "bytes"));
+}
+
+void BuildRoutingLandmarksSection(string const & path, string const & mwmFile,
+                                  string const & country,
+                                  CountryParentNameGetterFn const & countryParentNameGetterFn)
+{
+  LOG(LINFO, ("Building landmarks section for", country));
+
+  // Enough for a good bound in most cases. Every landmark takes 4 bytes per road piece direction.
+  uint32_t constexpr kLandmarksNumber = 4;
+
+  VehicleType const vhType = VehicleType::Car;
+  shared_ptr<VehicleModelInterface> vehicleModel =
+      CarModelFactory(countryParentNameGetterFn).GetVehicleModelForCountry(country);
+
+  MwmValue mwmValue(LocalCountryFile(path, platform::CountryFile(country), 0 /* version */));
+  uint32_t mwmNumRoads = DeserializeIndexGraphNumRoads(mwmValue, vhType);
+  IndexGraph graph(make_shared<Geometry>(GeometryLoader::CreateFromFile(mwmFile, vehicleModel), mwmNumRoads),
+                                         EdgeEstimator::Create(vhType, *vehicleModel,
+                                                               nullptr /* trafficStash */,
+                                                               nullptr /* dataSource */,
+                                                               nullptr /* numMvmIds */));
+  DeserializeIndexGraph(mwmValue, vhType, graph);
+
+  // Landmark distances should be lower bounds of route weights for any road access and
+  // restrictions the router may use.
+  graph.SetRestrictions({});
+  graph.SetUTurnRestrictions({});
+  graph.SetRoadAccess(RoadAccess());
+
+  JointLandmarks const landmarks = BuildJointLandmarks(graph, kLandmarksNumber);
+
+  FilesContainerW cont(mwmFile, FileWriter::OP_WRITE_EXISTING);
+  auto writer = cont.GetWriter(ROUTING_LANDMARKS_FILE_TAG);
+  auto const startPos = writer->Pos();
+  landmarks.Serialize(*writer);
+  auto const sectionSize = writer->Pos() - startPos;
+
+  LOG(LINFO, ("Landmarks section generated, size:", sectionSize, "bytes"));
+}
+
+void BuildRoutingGeometrySection(string const & path, string const & mwmFile,
+                                 string const & country,
+                                 CountryParentNameGetterFn const & countryParentNameGetterFn)
+{
+  LOG(LINFO, ("Building routing geometry section for", country));
+  base::Timer timer;
+
+  // Models and loaders are indexed by VehicleType.
+  array<shared_ptr<VehicleModelInterface>, RoadGeometrySection::kVehiclesNumber> const models = {
+      PedestrianModelFactory(countryParentNameGetterFn).GetVehicleModelForCountry(country),
+      BicycleModelFactory(countryParentNameGetterFn).GetVehicleModelForCountry(country),
+      CarModelFactory(countryParentNameGetterFn).GetVehicleModelForCountry(country)};
+  array<unique_ptr<GeometryLoader>, RoadGeometrySection::kVehiclesNumber> loaders;
+  for (size_t i = 0; i < models.size(); ++i)
+    loaders[i] = GeometryLoader::CreateFromFile(mwmFile, models[i]);
+
+  VehicleMaskBuilder const maskBuilder(country, countryParentNameGetterFn);
+  MwmValue mwmValue(LocalCountryFile(path, platform::CountryFile(country), 0 /* version */));
+  AltitudeLoaderBase altitudeLoader(mwmValue);
+  RoadGeometrySectionBuilder builder(mwmValue.GetHeader().GetDefGeometryCodingParams().GetCoordBits(),
+                                     altitudeLoader.HasAltitudes());
+  // Indexes of road segments are built with the same coordinates and altitudes as
+  // FeaturesRoadGraphBase builds them at runtime.
+  vector<RoadSegmentsIndexBuilder> segmentsBuilders(
+      RoadSegmentsIndex::kVehiclesNumber,
+      RoadSegmentsIndexBuilder(kPointCoordBits, altitudeLoader.HasAltitudes()));
+  IRoadGraph::PointWithAltitudeVec junctions;
+
+  uint32_t roadsNumber = 0;
+  ForEachFeature(mwmFile, [&](FeatureType & f, uint32_t featureId) {
+    if (maskBuilder.CalcRoadMask(f) == 0)
+      return;
+
+    RoadGeometrySectionBuilder::Road road;
+    road.m_featureId = featureId;
+
+    f.ParseGeometry(FeatureType::BEST_GEOMETRY);
+    road.m_points.reserve(f.GetPointsCount());
+    for (size_t i = 0; i < f.GetPointsCount(); ++i)
+      road.m_points.push_back(f.GetPoint(i));
+    road.m_altitudes = altitudeLoader.GetAltitudes(featureId, f.GetPointsCount());
+
+    for (size_t i = 0; i < loaders.size(); ++i)
+    {
+      RoadGeometry geometry;
+      loaders[i]->Load(featureId, geometry);
+
+      auto & attrs = road.m_vehicles[i];
+      attrs.m_valid = geometry.IsValid();
+      attrs.m_isOneWay = geometry.IsOneWay();
+      attrs.m_isPassThroughAllowed = geometry.IsPassThroughAllowed();
+      attrs.m_highwayType = geometry.GetHighwayType();
+      attrs.m_forwardSpeed = geometry.GetSpeed(true /* forward */);
+      attrs.m_backwardSpeed = geometry.GetSpeed(false /* forward */);
+
+      // Types and city roads don't depend on the vehicle.
+      road.m_routingOptions = geometry.GetRoutingOptions();
+      road.m_inCity = geometry.IsInCity();
+    }
+
+    junctions.clear();
+    for (size_t i = 0; i < road.m_points.size(); ++i)
+    {
+      junctions.emplace_back(road.m_points[i], road.m_altitudes.empty()
+                                                   ? geometry::kDefaultAltitudeMeters
+                                                   : road.m_altitudes[i]);
+    }
+
+    for (size_t i = 0; i < segmentsBuilders.size(); ++i)
+    {
+      auto const & attrs = road.m_vehicles[i];
+      if (!attrs.m_valid)
+        continue;
+
+      // Pedestrian roads are built in IRoadGraph::Mode::IgnoreOnewayTag mode.
+      bool const bidirectional =
+          static_cast<VehicleType>(i) == VehicleType::Pedestrian || !attrs.m_isOneWay;
+      segmentsBuilders[i].AddRoad(featureId, bidirectional, junctions);
+    }
+
+    builder.AddRoad(move(road));
+    ++roadsNumber;
+  });
+
+  FilesContainerW cont(mwmFile, FileWriter::OP_WRITE_EXISTING);
+  auto writer = cont.GetWriter(ROUTING_GEOMETRY_FILE_TAG);
+  auto const startPos = writer->Pos();
+  builder.Serialize(*writer);
+  auto const sectionSize = writer->Pos() - startPos;
+
+  LOG(LINFO, ("Routing geometry section generated in", timer.ElapsedSeconds(), "seconds, roads:",
+              roadsNumber, "size:", sectionSize, "bytes"));
+
+  auto segmentsWriter = cont.GetWriter(ROUTING_SEGMENTS_FILE_TAG);
+  auto const segmentsStartPos = segmentsWriter->Pos();
+  RoadSegmentsIndexBuilder::SerializeSection(segmentsBuilders, *segmentsWriter);
+  LOG(LINFO, ("Routing segments section generated, size:", segmentsWriter->Pos() - segmentsStartPos,
+              "bytes"));
+}
+
 void BuildTransitCrossMwmSection(
     string const & path, string const & mwmFile, string const & country,
     CountryParentNameGetterFn const & countryParentNameGetterFn,
@@ -22,6 +22,27 @@ void BuildRoutingCrossMwmSection(std::string const & path, std::string const & m
                                  CountryParentNameGetterFn const & countryParentNameGetterFn,
                                  std::string const & osmToFeatureFile,
                                  bool disableCrossMwmProgress);
+/// \brief Builds ROUTING_CH_FILE_TAG section with contraction hierarchy for car routing.
+/// \note Before call of this method routing, restrictions, road access and maxspeeds sections
+/// should be generated.
+void BuildRoutingContractionHierarchySection(
+    std::string const & path, std::string const & mwmFile, std::string const & country,
+    CountryParentNameGetterFn const & countryParentNameGetterFn);
+
+/// \brief Builds ROUTING_LANDMARKS_FILE_TAG section with landmark distances for car routing.
+/// \note Before call of this method routing and maxspeeds sections should be generated.
+void BuildRoutingLandmarksSection(std::string const & path, std::string const & mwmFile,
+                                  std::string const & country,
+                                  CountryParentNameGetterFn const & countryParentNameGetterFn);
+
+/// \brief Builds ROUTING_GEOMETRY_FILE_TAG section with road points and attributes and
+/// ROUTING_SEGMENTS_FILE_TAG section with indexes of road segments for all vehicle types.
+/// \note Before call of this method altitudes, city roads and maxspeeds sections should be
+/// generated.
+void BuildRoutingGeometrySection(std::string const & path, std::string const & mwmFile,
+                                 std::string const & country,
+                                 CountryParentNameGetterFn const & countryParentNameGetterFn);
+
 /// \brief Builds TRANSIT_CROSS_MWM_FILE_TAG section.
 /// \note Before a call of this method TRANSIT_FILE_TAG should be built.
 void BuildTransitCrossMwmSection(
@@ -1,5 +1,6 @@
 #include "generator/search_index_builder.hpp"
 
+#include "search/address_index.hpp"
 #include "search/common.hpp"
 #include "search/house_to_street_table.hpp"
 #include "search/mwm_context.hpp"
@@ -419,7 +420,7 @@ bool GetStreetIndex(search::MwmContext & ctx, uint32_t featureID, string_view st
 }
 
 void BuildAddressTable(FilesContainerR & container, string const & addressDataFile, Writer & writer,
-                       uint32_t threadsCount)
+                       Writer & indexWriter, uint32_t threadsCount)
 {
   vector<feature::AddressData> addrs;
   ReadAddressData(addressDataFile, addrs);
@@ -503,6 +504,29 @@ void BuildAddressTable(FilesContainerR & container, string const & addressDataFi
     LOG(LINFO, ("Address: BuildingToStreet entries count:", houseToStreetCount));
   }
 
+  // Only buildings with house numbers are found by ReverseGeocoder.
+  {
+    search::AddressIndexBuilder builder;
+    auto & context = *contexts.front();
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+      if (results[i] == kEmptyResult)
+        continue;
+
+      auto ft = context.GetFeature(base::asserted_cast<uint32_t>(i));
+      CHECK(ft, ());
+      if (ft->GetHouseNumber().empty())
+        continue;
+
+      builder.Put(base::asserted_cast<uint32_t>(i), results[i],
+                  ft->GetLimitRect(FeatureType::BEST_GEOMETRY));
+    }
+
+    builder.Freeze(indexWriter);
+
+    LOG(LINFO, ("Address: index buildings count:", builder.GetNumBuildings()));
+  }
+
   double matchedPercent = 100;
   if (address > 0)
     matchedPercent = 100.0 * (1.0 - static_cast<double>(missing) / static_cast<double>(address));
@@ -526,8 +550,10 @@ bool BuildSearchIndexFromDataFile(string const & country, feature::GenerateInfo
 
   string const indexFilePath = filename + "." + SEARCH_INDEX_FILE_TAG EXTENSION_TMP;
   string const addrFilePath = filename + "." + SEARCH_ADDRESS_FILE_TAG EXTENSION_TMP;
+  string const addrIndexFilePath = filename + "." + SEARCH_ADDRESS_INDEX_FILE_TAG EXTENSION_TMP;
   SCOPE_GUARD(indexFileGuard, bind(&FileWriter::DeleteFileX, indexFilePath));
   SCOPE_GUARD(addrFileGuard, bind(&FileWriter::DeleteFileX, addrFilePath));
+  SCOPE_GUARD(addrIndexFileGuard, bind(&FileWriter::DeleteFileX, addrIndexFilePath));
 
   try
   {
@@ -539,9 +565,11 @@ bool BuildSearchIndexFromDataFile(string const & country, feature::GenerateInfo
     if (filename != WORLD_FILE_NAME && filename != WORLD_COASTS_FILE_NAME)
     {
       FileWriter writer(addrFilePath);
+      FileWriter indexWriter(addrIndexFilePath);
       auto const addrsFile = info.GetIntermediateFileName(country + DATA_FILE_EXTENSION, TEMP_ADDR_FILENAME);
-      BuildAddressTable(readContainer, addrsFile, writer, threadsCount);
+      BuildAddressTable(readContainer, addrsFile, writer, indexWriter, threadsCount);
       LOG(LINFO, ("Search address table size =", writer.Size()));
+      LOG(LINFO, ("Search address index size =", indexWriter.Size()));
     }
     {
       // Separate scopes because FilesContainerW cannot write two sections at once.
@@ -572,6 +600,11 @@ bool BuildSearchIndexFromDataFile(string const & country, feature::GenerateInfo
         FilesContainerW writeContainer(readContainer.GetFileName(), FileWriter::OP_WRITE_EXISTING);
         writeContainer.Write(addrFilePath, SEARCH_ADDRESS_FILE_TAG);
       }
+
+      {
+        FilesContainerW writeContainer(readContainer.GetFileName(), FileWriter::OP_WRITE_EXISTING);
+        writeContainer.Write(addrIndexFilePath, SEARCH_ADDRESS_INDEX_FILE_TAG);
+      }
     }
   }
   catch (Reader::Exception const & e)
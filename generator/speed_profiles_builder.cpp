@@ -0,0 +1,181 @@
+#include "generator/speed_profiles_builder.hpp"
+
+#include "generator/routing_helpers.hpp"
+
+#include "coding/files_container.hpp"
+#include "coding/file_writer.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+#include "base/string_utils.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <vector>
+
+#include "defines.hpp"
+
+namespace routing_builder
+{
+using namespace routing;
+using namespace std;
+
+namespace
+{
+// Country names may contain spaces, so the fields are split by commas only.
+char const kDelim[] = ",\r\n";
+
+using HourRatios = map<uint32_t, double>;
+
+// Fills the hours which are absent in |hourRatios| with linear interpolation between the nearest
+// known hours. The week is cyclic, so the hours after the last known hour are interpolated with
+// the first known one.
+SpeedProfile::Ratios Interpolate(HourRatios const & hourRatios)
+{
+  CHECK(!hourRatios.empty(), ());
+
+  uint32_t constexpr kWeekHours = SpeedProfile::kKnotsNumber;
+  SpeedProfile::Ratios ratios;
+  for (uint32_t hour = 0; hour < kWeekHours; ++hour)
+  {
+    auto next = hourRatios.lower_bound(hour);
+    if (next != hourRatios.end() && next->first == hour)
+    {
+      ratios[hour] = SpeedProfile::QuantizeRatio(next->second);
+      continue;
+    }
+
+    auto before = next == hourRatios.begin() ? std::prev(hourRatios.end()) : std::prev(next);
+    if (next == hourRatios.end())
+      next = hourRatios.begin();
+
+    // Distances are counted cyclically, so they are positive even if the known hours belong to
+    // the neighbouring weeks.
+    uint32_t const fromPrev = (hour + kWeekHours - before->first) % kWeekHours;
+    uint32_t const toNext = (next->first + kWeekHours - hour) % kWeekHours;
+    double const t = static_cast<double>(fromPrev) / (fromPrev + toNext);
+    ratios[hour] = SpeedProfile::QuantizeRatio(before->second * (1.0 - t) + next->second * t);
+  }
+  return ratios;
+}
+}  // namespace
+
+bool ParseSpeedProfiles(string const & filePath, string const & country, SpeedProfilesData & data)
+{
+  data = {};
+
+  ifstream stream(filePath);
+  if (!stream)
+    return false;
+
+  map<pair<base::GeoObjectId, bool>, HourRatios> ways;
+  map<HighwayType, HourRatios> highwayTypes;
+
+  string line;
+  while (stream.good())
+  {
+    getline(stream, line);
+    vector<string> fields;
+    strings::Tokenize(line, kDelim, [&fields](string_view field) {
+      string f(field);
+      strings::Trim(f);
+      fields.push_back(move(f));
+    });
+
+    if (fields.empty())  // empty line
+      continue;
+
+    if (fields.size() != 6)
+    {
+      LOG(LWARNING, ("Wrong speed profiles line:", line));
+      return false;
+    }
+
+    if (fields[0] != country)
+      continue;
+
+    uint32_t highwayType = 0;
+    uint64_t osmId = 0;
+    uint32_t forward = 0;
+    uint32_t hour = 0;
+    double ratio = 0.0;
+    if (!strings::to_uint(fields[1], highwayType) || !strings::to_uint(fields[2], osmId) ||
+        !strings::to_uint(fields[3], forward) || forward > 1 ||
+        !strings::to_uint(fields[4], hour) || hour >= SpeedProfile::kKnotsNumber ||
+        !strings::to_double(fields[5], ratio) || ratio <= 0.0)
+    {
+      LOG(LWARNING, ("Wrong speed profiles line:", line));
+      return false;
+    }
+
+    if (osmId == 0)
+      highwayTypes[static_cast<HighwayType>(highwayType)][hour] = ratio;
+    else
+      ways[{base::MakeOsmWay(osmId), forward == 1}][hour] = ratio;
+  }
+
+  for (auto const & [way, hourRatios] : ways)
+    data.m_ways.emplace(way, Interpolate(hourRatios));
+  for (auto const & [type, hourRatios] : highwayTypes)
+    data.m_highwayTypes.emplace(type, Interpolate(hourRatios));
+  return true;
+}
+
+bool BuildSpeedProfilesSection(string const & dataPath, string const & country,
+                               string const & osmToFeaturePath, string const & speedProfilesPath)
+{
+  LOG(LINFO, ("Generating speed profiles for", dataPath));
+
+  SpeedProfilesData data;
+  if (!ParseSpeedProfiles(speedProfilesPath, country, data))
+  {
+    LOG(LERROR, ("Can't parse speed profiles file", speedProfilesPath));
+    return false;
+  }
+
+  map<uint32_t, pair<optional<SpeedProfile::Ratios>, optional<SpeedProfile::Ratios>>> features;
+  if (!data.m_ways.empty())
+  {
+    OsmIdToFeatureIds osmIdToFeatureIds;
+    if (!ParseWaysOsmIdToFeatureIdMapping(osmToFeaturePath, osmIdToFeatureIds))
+    {
+      LOG(LERROR, ("Can't parse osm to feature mapping", osmToFeaturePath));
+      return false;
+    }
+
+    for (auto const & [way, ratios] : data.m_ways)
+    {
+      auto const it = osmIdToFeatureIds.find(way.first);
+      if (it == osmIdToFeatureIds.cend())
+        continue;
+
+      for (uint32_t const featureId : it->second)
+      {
+        auto & profiles = features[featureId];
+        (way.second ? profiles.first : profiles.second) = ratios;
+      }
+    }
+  }
+
+  SpeedProfilesSectionBuilder builder;
+  for (auto const & [featureId, profiles] : features)
+    builder.AddFeature(featureId, profiles.first, profiles.second);
+  for (auto const & [type, ratios] : data.m_highwayTypes)
+    builder.AddHighwayType(type, ratios);
+
+  if (builder.IsEmpty())
+  {
+    LOG(LINFO, ("No speed profiles for", country));
+    return true;
+  }
+
+  FilesContainerW cont(dataPath, FileWriter::OP_WRITE_EXISTING);
+  auto writer = cont.GetWriter(SPEED_PROFILES_FILE_TAG);
+  builder.Serialize(*writer);
+
+  LOG(LINFO, ("Serialized", builder.GetProfilesNumber(), "speed profiles of", features.size(),
+              "features and", data.m_highwayTypes.size(), "highway types for", dataPath));
+  return true;
+}
+}  // namespace routing_builder
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "routing/speed_profiles.hpp"
+
+#include "routing_common/vehicle_model.hpp"
+
+#include "base/geo_object_id.hpp"
+
+#include <map>
+#include <string>
+#include <utility>
+
+namespace routing_builder
+{
+/// \brief Weekly speed profiles of one country aggregated from tracks.
+struct SpeedProfilesData
+{
+  using Ratios = routing::SpeedProfile::Ratios;
+
+  // Profiles of osm ways in forward (true) and backward (false) directions.
+  std::map<std::pair<base::GeoObjectId, bool>, Ratios> m_ways;
+  std::map<routing::HighwayType, Ratios> m_highwayTypes;
+};
+
+/// \brief Parses csv file with speed profiles of |country|. Lines of the file are
+/// <country>,<highway type>,<osm way id>,<forward>,<hour of week>,<speed ratio>
+/// where
+/// * highway type is a number of routing::HighwayType;
+/// * osm way id is 0 for the profile of the highway type, the highway type is ignored otherwise;
+/// * forward is 1 for the profile of the way direction and 0 for the opposite one, it's ignored
+///   for the profile of the highway type;
+/// * hour of week is from 0 to 167, hours begin from Monday 00:00 UTC;
+/// * speed ratio is the ratio of the average speed to the speed of the car model.
+/// Lines of other countries are skipped. Ratios of the hours which are absent are interpolated
+/// between the neighbouring hours of the week.
+/// The file is written by "speed_profiles" command of track_analyzer.
+bool ParseSpeedProfiles(std::string const & filePath, std::string const & country,
+                        SpeedProfilesData & data);
+
+/// \brief Builds SPEED_PROFILES_FILE_TAG section in mwm |dataPath| of |country| with the profiles
+/// of |speedProfilesPath|. Osm ways are matched to features with |osmToFeaturePath|.
+/// \returns false if the profiles can't be parsed.
+bool BuildSpeedProfilesSection(std::string const & dataPath, std::string const & country,
+                               std::string const & osmToFeaturePath,
+                               std::string const & speedProfilesPath);
+}  // namespace routing_builder
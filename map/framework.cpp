@@ -19,6 +19,7 @@
 
 #include "routing_common/num_mwm_id.hpp"
 
+#include "search/address_index.hpp"
 #include "search/cities_boundaries_table.hpp"
 #include "search/downloader_search_callback.hpp"
 #include "search/editor_delegate.hpp"
@@ -389,6 +390,9 @@ Framework::Framework(FrameworkParams const & params)
   RegisterAllMaps();
   LOG(LDEBUG, ("Maps initialized"));
 
+  // Address indices of deregistered maps are dropped from the cache shared by reverse geocoders.
+  m_featuresFetcher.GetDataSource().AddObserver(search::AddressIndexCache::Instance());
+
   // Perform real initialization after World was loaded.
   GetSearchAPI().InitAfterWorldLoaded();
 
@@ -401,7 +405,12 @@ Framework::Framework(FrameworkParams const & params)
   LOG(LINFO, ("System languages:", languages::GetPreferred()));
 
   editor.SetDelegate(make_unique<search::EditorDelegate>(m_featuresFetcher.GetDataSource()));
-  editor.SetInvalidateFn([this](){ InvalidateRect(GetCurrentViewport()); });
+  editor.SetInvalidateFn([this]()
+  {
+    // Cached features of categories and rects don't know about edits.
+    GetSearchAPI().ClearCaches();
+    InvalidateRect(GetCurrentViewport());
+  });
   editor.LoadEdits();
 
   m_featuresFetcher.GetDataSource().AddObserver(editor);
@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace address_tests
 {
@@ -104,4 +105,56 @@ UNIT_TEST(ReverseGeocoder_Smoke)
     TestAddress(coder, mwmInfo, {53.89745, 27.55835}, streetNames, "18А");
   }
 }
+
+UNIT_TEST(ReverseGeocoder_Batch)
+{
+  classificator::Load();
+
+  LocalCountryFile file = LocalCountryFile::MakeForTesting("minsk-pass");
+
+  FrozenDataSource dataSource;
+  auto const regResult = dataSource.RegisterMap(file);
+  TEST_EQUAL(regResult.second, MwmSet::RegResult::Success, ());
+
+  ReverseGeocoder coder(dataSource);
+
+  std::vector<m2::PointD> centers = {
+      mercator::FromLatLon(53.89815, 27.54265), mercator::FromLatLon(53.8997617, 27.5429365),
+      mercator::FromLatLon(53.89666, 27.54904), mercator::FromLatLon(53.89724, 27.54983),
+      mercator::FromLatLon(53.89745, 27.55835)};
+  size_t const numExactPoints = centers.size();
+
+  // Close points share cells and buildings.
+  for (int i = 0; i < 20; ++i)
+  {
+    for (int j = 0; j < 20; ++j)
+      centers.push_back(mercator::FromLatLon(53.890 + 0.001 * i, 27.540 + 0.001 * j));
+  }
+
+  std::vector<ReverseGeocoder::Address> addrs;
+  coder.GetNearbyAddresses(centers, ReverseGeocoder::kLookupRadiusM, 1 /* numThreads */, addrs);
+  TEST_EQUAL(addrs.size(), centers.size(), ());
+
+  for (size_t i = 0; i < numExactPoints; ++i)
+  {
+    ReverseGeocoder::Address expected;
+    coder.GetNearbyAddress(centers[i], expected);
+    TEST(expected.IsValid(), (i));
+    TEST_EQUAL(addrs[i].m_building.m_id, expected.m_building.m_id, (i, addrs[i], expected));
+    TEST_EQUAL(addrs[i].GetStreetName(), expected.GetStreetName(), (i));
+    TEST_EQUAL(addrs[i].GetHouseNumber(), expected.GetHouseNumber(), (i));
+  }
+
+  std::vector<ReverseGeocoder::Address> parallelAddrs;
+  coder.GetNearbyAddresses(centers, ReverseGeocoder::kLookupRadiusM, 4 /* numThreads */,
+                           parallelAddrs);
+  TEST_EQUAL(parallelAddrs.size(), centers.size(), ());
+  for (size_t i = 0; i < centers.size(); ++i)
+  {
+    TEST_EQUAL(addrs[i].m_building.m_id, parallelAddrs[i].m_building.m_id, (i));
+    TEST_EQUAL(addrs[i].m_street.m_id, parallelAddrs[i].m_street.m_id, (i));
+    TEST_EQUAL(addrs[i].GetStreetName(), parallelAddrs[i].GetStreetName(), (i));
+    TEST_ALMOST_EQUAL_ABS(addrs[i].GetDistance(), parallelAddrs[i].GetDistance(), 1e-9, (i));
+  }
+}
 } // namespace address_tests
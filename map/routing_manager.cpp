@@ -58,6 +58,9 @@ double const kRouteScaleMultiplier = 1.5;
 string const kRoutePointsFile = "route_points.dat";
 
 uint32_t constexpr kInvalidTransactionId = 0;
+// Turns and street names of car routes are generated synchronously for the beginning of the route
+// only. The rest is generated after the route is shown.
+double constexpr kCarSyncDirectionsDistanceM = 50000.0;
 
 void FillTurnsDistancesForRendering(vector<RouteSegment> const & segments,
                                     double baseDistance, vector<double> & turns)
@@ -330,6 +333,11 @@ RoutingManager::RoutingManager(Callbacks && callbacks, Delegate & delegate)
       },
       [this](RouterResultCode code) { OnRemoveRoute(code); });
 
+  m_routingSession.SetDirectionsAppliedCallback([this](Route const & route)
+  {
+    OnDirectionsApplied(route);
+  });
+
   m_routingSession.SetCheckpointCallback([this](size_t passedCheckpointIdx)
   {
     GetPlatform().RunTask(Platform::Thread::Gui, [this, passedCheckpointIdx]()
@@ -433,6 +441,13 @@ void RoutingManager::OnRebuildRouteReady(Route const & route, RouterResultCode c
   CallRouteBuilded(hasWarnings ? RouterResultCode::HasWarnings : code, storage::CountriesSet());
 }
 
+void RoutingManager::OnDirectionsApplied(Route const & route)
+{
+  // Turn arrows are a part of drape subroutes, so the subroutes are replaced. Route marks don't
+  // depend on turns. Voice notifications take next turns from the route on every call.
+  InsertRoute(route, true /* keepMarks */);
+}
+
 void RoutingManager::OnNeedMoreMaps(uint64_t routeId, storage::CountriesSet const & absentCountries)
 {
   // No need to inform user about maps needed for the route if the method is called
@@ -530,6 +545,12 @@ void RoutingManager::SetRouterImpl(RouterType type)
                                          countryFileGetter, getMwmRectByName, numMwmIds,
                                          MakeNumMwmTree(*numMwmIds, m_callbacks.m_countryInfoGetter()),
                                          m_routingSession, dataSource);
+  if (vehicleType == VehicleType::Car)
+  {
+    router->SetSyncDirectionsDistance(kCarSyncDirectionsDistanceM);
+    router->SetAlternativesNumber(m_alternativeRoutesNumber);
+    router->SetTimeDependentWeights(true);
+  }
 
   m_routingSession.SetRoutingSettings(GetRoutingSettings(vehicleType));
   m_routingSession.SetRouter(move(router), move(regionsFinder));
@@ -556,8 +577,19 @@ void RoutingManager::RemoveRoute(bool deactivateFollowing)
     // Remove all subroutes.
     m_drapeEngine.SafeCall(&df::DrapeEngine::RemoveSubroute,
                            dp::DrapeID(), true /* deactivateFollowing */);
+
+    lock_guard<mutex> lock(m_drapeSubroutesMutex);
+    m_drapeSubroutes.clear();
+    m_transitRouteInfo = TransitRouteInfo();
   }
   else
+  {
+    RemoveSubroutes();
+  }
+}
+
+void RoutingManager::RemoveSubroutes()
+{
   {
     df::DrapeEngineLockGuard lock(m_drapeEngine);
     if (lock)
@@ -640,13 +672,16 @@ void RoutingManager::CreateRoadWarningMarks(RoadWarningsCollection && roadWarnin
   });
 }
 
-bool RoutingManager::InsertRoute(Route const & route)
+bool RoutingManager::InsertRoute(Route const & route, bool keepMarks /* = false */)
 {
   if (!m_drapeEngine)
     return false;
 
   // TODO: Now we always update whole route, so we need to remove previous one.
-  RemoveRoute(false /* deactivateFollowing */);
+  if (keepMarks)
+    RemoveSubroutes();
+  else
+    RemoveRoute(false /* deactivateFollowing */);
 
   auto numMwmIds = make_shared<NumMwmIds>();
   m_delegate.RegisterCountryFilesOnRoute(numMwmIds);
@@ -723,11 +758,41 @@ bool RoutingManager::InsertRoute(Route const & route)
     m_drapeSubroutes.push_back(subrouteId);
   }
 
+  // Alternatives are drawn under the route in the color of fake segments. They are hidden
+  // while following the route.
+  if (m_currentRouterType == RouterType::Vehicle && !m_routingSession.IsFollowing())
+  {
+    double alternativeDepth = -1.0;
+    for (auto const & alternative : route.GetAlternatives())
+    {
+      auto const subrouteIndex = alternative->GetCurrentSubrouteIdx();
+      alternative->GetSubrouteInfo(subrouteIndex, segments);
+
+      auto const startPt = alternative->GetSubrouteAttrs(subrouteIndex).GetStart().GetPoint();
+      auto subroute = CreateDrapeSubroute(segments, startPt, 0.0 /* baseDistance */,
+                                          alternativeDepth, false /* isTransit */);
+      alternativeDepth -= 1.0;
+      if (!subroute)
+        continue;
+
+      subroute->m_routeType = df::RouteType::Car;
+      subroute->AddStyle(df::SubrouteStyle(df::kRouteFakeColor, df::kRouteFakeOutlineColor));
+
+      auto const subrouteId = m_drapeEngine.SafeCallWithResult(&df::DrapeEngine::AddSubroute,
+                                                               df::SubrouteConstPtr(subroute.release()));
+      lock_guard<mutex> lock(m_drapeSubroutesMutex);
+      m_drapeSubroutes.push_back(subrouteId);
+    }
+  }
+
   {
     lock_guard<mutex> lock(m_drapeSubroutesMutex);
     m_transitRouteInfo = isTransitRoute ? transitRouteDisplay->GetRouteInfo() : TransitRouteInfo();
   }
 
+  if (keepMarks)
+    return false;
+
   if (isTransitRoute)
   {
     GetPlatform().RunTask(Platform::Thread::Gui, [transitRouteDisplay = move(transitRouteDisplay)]()
@@ -760,6 +825,13 @@ void RoutingManager::FollowRoute()
   HideRoutePoint(RouteMarkType::Start);
   SetPointsFollowingMode(true /* enabled */);
 
+  // Alternatives of the route are not drawn while following.
+  m_routingSession.RouteCall([this](Route const & route)
+  {
+    if (!route.GetAlternatives().empty())
+      InsertRoute(route, true /* keepMarks */);
+  });
+
   CancelRecommendation(Recommendation::RebuildAfterPointsLoading);
 }
 
@@ -1206,6 +1278,27 @@ void RoutingManager::SetRouter(RouterType type)
   SetRouterImpl(type);
 }
 
+void RoutingManager::SetAlternativeRoutesNumber(size_t alternativesNumber)
+{
+  CHECK_THREAD_CHECKER(m_threadChecker, ("SetAlternativeRoutesNumber"));
+
+  if (m_alternativeRoutesNumber == alternativesNumber)
+    return;
+
+  m_alternativeRoutesNumber = alternativesNumber;
+  if (m_currentRouterType == RouterType::Vehicle)
+    SetRouterImpl(m_currentRouterType);
+}
+
+void RoutingManager::ForEachAlternativeRoute(function<void(Route const &)> const & fn) const
+{
+  m_routingSession.RouteCall([&fn](Route const & route)
+  {
+    for (auto const & alternative : route.GetAlternatives())
+      fn(*alternative);
+  });
+}
+
 // static
 uint32_t RoutingManager::InvalidRoutePointsTransactionId()
 {
@@ -130,6 +130,10 @@ public:
   routing::RoutingSession & RoutingSession() { return m_routingSession; }
   void SetRouter(routing::RouterType type);
   routing::RouterType GetRouter() const { return m_currentRouterType; }
+  /// \brief Up to |alternativesNumber| alternative car routes are built besides the best one.
+  void SetAlternativeRoutesNumber(size_t alternativesNumber);
+  /// \brief Calls |fn| for every alternative of the built route.
+  void ForEachAlternativeRoute(std::function<void(routing::Route const &)> const & fn) const;
   bool IsRoutingActive() const { return m_routingSession.IsActive(); }
   bool IsRouteBuilt() const { return m_routingSession.IsBuilt(); }
   bool IsRouteBuilding() const { return m_routingSession.IsBuilding(); }
@@ -249,6 +253,7 @@ public:
                         storage::CountriesSet const & absentCountries);
   void OnBuildRouteReady(routing::Route const & route, routing::RouterResultCode code);
   void OnRebuildRouteReady(routing::Route const & route, routing::RouterResultCode code);
+  void OnDirectionsApplied(routing::Route const & route);
   void OnNeedMoreMaps(uint64_t routeId, storage::CountriesSet const & absentCountries);
   void OnRemoveRoute(routing::RouterResultCode code);
   void OnRoutePointPassed(RouteMarkType type, size_t intermediateIndex);
@@ -315,7 +320,10 @@ public:
 
 private:
   /// \returns true if the route has warnings.
-  bool InsertRoute(routing::Route const & route);
+  /// \param keepMarks if true only the drape subroutes are replaced, route marks are kept.
+  bool InsertRoute(routing::Route const & route, bool keepMarks = false);
+  /// Removes the drape subroutes of the route without its marks.
+  void RemoveSubroutes();
 
   struct RoadInfo
   {
@@ -366,6 +374,7 @@ private:
   Callbacks m_callbacks;
   df::DrapeEngineSafePtr m_drapeEngine;
   routing::RouterType m_currentRouterType = routing::RouterType::Count;
+  size_t m_alternativeRoutesNumber = 0;
   bool m_loadAltitudes = false;
   routing::RoutingSession m_routingSession;
   Delegate & m_delegate;
@@ -5,6 +5,8 @@
 #include "drape_frontend/drape_engine.hpp"
 #include "drape_frontend/visual_params.hpp"
 
+#include "traffic/traffic_table.hpp"
+
 #include "indexer/ftypes_matcher.hpp"
 #include "indexer/scales.hpp"
 
@@ -373,11 +375,11 @@ void TrafficManager::OnTrafficDataResponse(traffic::TrafficInfo && info)
     it->second.m_isWaitingForResponse = false;
     it->second.m_lastAvailability = info.GetAvailability();
 
-    if (!info.GetColoring().empty())
+    if (!info.IsEmpty())
     {
       // Update cache.
       size_t constexpr kElementSize = sizeof(traffic::TrafficInfo::RoadSegmentId) + sizeof(traffic::SpeedGroup);
-      size_t const dataSize = info.GetColoring().size() * kElementSize;
+      size_t const dataSize = info.GetTable()->GetSize() * kElementSize;
       m_currentCacheSizeBytes += (dataSize - it->second.m_dataSize);
       it->second.m_dataSize = dataSize;
       ShrinkCacheToAllowableSize();
@@ -386,7 +388,7 @@ void TrafficManager::OnTrafficDataResponse(traffic::TrafficInfo && info)
     UpdateState();
   }
 
-  if (!info.GetColoring().empty())
+  if (!info.IsEmpty())
   {
     m_drapeEngine.SafeCall(&df::DrapeEngine::UpdateTraffic,
                            static_cast<traffic::TrafficInfo const &>(info));
@@ -73,6 +73,13 @@ void Graph::FindClosestEdges(m2::PointD const & point, uint32_t const count,
       count, vicinities);
 }
 
+void Graph::FindClosestEdges(vector<m2::PointD> const & points, uint32_t const count,
+                             size_t threadsNumber, vector<vector<pair<Edge, Junction>>> & vicinities) const
+{
+  m_graph.FindClosestEdges(points, FeaturesRoadGraph::kClosestEdgesRadiusM, count, threadsNumber,
+                           vicinities);
+}
+
 void Graph::AddIngoingFakeEdge(Edge const & e)
 {
   m_graph.AddIngoingFakeEdge(e);
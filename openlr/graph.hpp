@@ -44,6 +44,11 @@ public:
 
   void FindClosestEdges(m2::PointD const & point, uint32_t const count,
                         std::vector<std::pair<Edge, Junction>> & vicinities) const;
+  // Finds closest edges for all |points| at once. Roads are read once per mwm,
+  // see FeaturesRoadGraphBase::FindClosestEdges().
+  void FindClosestEdges(std::vector<m2::PointD> const & points, uint32_t const count,
+                        size_t threadsNumber,
+                        std::vector<std::vector<std::pair<Edge, Junction>>> & vicinities) const;
 
   void AddIngoingFakeEdge(Edge const & e);
   void AddOutgoingFakeEdge(Edge const & e);
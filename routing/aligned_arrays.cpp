@@ -0,0 +1,38 @@
+#include "routing/aligned_arrays.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include "platform/local_country_file.hpp"
+
+#include "coding/files_container.hpp"
+#include "coding/reader.hpp"
+
+#include "base/checked_cast.hpp"
+#include "base/logging.hpp"
+
+#include <utility>
+#include <vector>
+
+namespace routing
+{
+using namespace std;
+
+unique_ptr<MemoryRegion> MapSection(MwmValue const & mwmValue, string const & tag)
+{
+  try
+  {
+    FilesMappingContainer cont(mwmValue.m_file.GetPath(MapFileType::Map));
+    return make_unique<MappedMemoryRegion>(cont.Map(tag));
+  }
+  catch (RootException const & e)
+  {
+    // The mwm may be not a plain file, e.g. it may be a part of an apk.
+    LOG(LDEBUG, ("Can't map", tag, "section, it's copied.", e.Msg()));
+  }
+
+  auto const reader = mwmValue.m_cont.GetReader(tag);
+  vector<uint8_t> buffer(base::checked_cast<size_t>(reader.Size()));
+  reader.Read(0 /* pos */, buffer.data(), buffer.size());
+  return make_unique<CopiedMemoryRegion>(move(buffer));
+}
+}  // namespace routing
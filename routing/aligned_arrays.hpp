@@ -0,0 +1,92 @@
+#pragma once
+
+#include "routing/routing_exceptions.hpp"
+
+#include "coding/memory_region.hpp"
+#include "coding/write_to_sink.hpp"
+#include "coding/writer.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+
+class MwmValue;
+
+namespace routing
+{
+/// \brief Readers and writers of structures of 4-byte aligned arrays which are used right from
+/// the mapped memory, see RoadGeometrySection and RoadSegmentsIndex.
+size_t constexpr kArraysAlignment = 4;
+
+/// \returns section |tag| of |mwmValue| mapped to memory. If the mwm can't be mapped the section
+/// is copied.
+std::unique_ptr<MemoryRegion> MapSection(MwmValue const & mwmValue, std::string const & tag);
+
+// Sequential reader of the arrays of |name|.
+class ArraysReader
+{
+public:
+  ArraysReader(uint8_t const * data, uint64_t size, uint64_t pos, std::string const & name)
+    : m_data(data), m_size(size), m_pos(pos), m_name(name)
+  {
+  }
+
+  template <typename T>
+  T const * Read(uint64_t count)
+  {
+    static_assert(alignof(T) <= kArraysAlignment, "");
+    uint64_t const size = count * sizeof(T);
+    if (m_pos + size > m_size)
+      MYTHROW(CorruptedDataException, (m_name, "is too small:", m_size));
+
+    auto const * result = reinterpret_cast<T const *>(m_data + m_pos);
+    m_pos += size;
+    m_pos += (kArraysAlignment - m_pos % kArraysAlignment) % kArraysAlignment;
+    return result;
+  }
+
+private:
+  uint8_t const * m_data;
+  uint64_t m_size;
+  uint64_t m_pos;
+  std::string m_name;
+};
+
+// Writer of 4-byte aligned arrays.
+class ArraysWriter
+{
+public:
+  explicit ArraysWriter(Writer & writer) : m_writer(writer), m_startPos(writer.Pos()) {}
+
+  template <typename T, typename Fn>
+  void Write(uint64_t count, Fn && fn)
+  {
+    for (uint64_t i = 0; i < count; ++i)
+      WriteToSink(m_writer, static_cast<T>(fn(i)));
+    Align();
+  }
+
+  void WriteFloats(uint64_t count, std::function<double(uint64_t)> const & fn)
+  {
+    static_assert(sizeof(float) == sizeof(uint32_t), "");
+    Write<uint32_t>(count, [&fn](uint64_t i) {
+      auto const value = static_cast<float>(fn(i));
+      uint32_t bits = 0;
+      std::memcpy(&bits, &value, sizeof(bits));
+      return bits;
+    });
+  }
+
+  void Align()
+  {
+    auto const size = m_writer.Pos() - m_startPos;
+    WriteZeroesToSink(m_writer, (kArraysAlignment - size % kArraysAlignment) % kArraysAlignment);
+  }
+
+private:
+  Writer & m_writer;
+  uint64_t const m_startPos;
+};
+}  // namespace routing
@@ -22,12 +22,14 @@ AsyncRouter::RouterDelegateProxy::RouterDelegateProxy(ReadyCallbackOwnership con
                                                       RemoveRouteCallback const & onRemoveRoute,
                                                       PointCheckCallback const & onPointCheck,
                                                       ProgressCallback const & onProgress,
+                                                      DirectionsReadyCallback const & onDirectionsReady,
                                                       uint32_t timeoutSec)
   : m_onReadyOwnership(onReady)
   , m_onNeedMoreMaps(onNeedMoreMaps)
   , m_onRemoveRoute(onRemoveRoute)
   , m_onPointCheck(onPointCheck)
   , m_onProgress(onProgress)
+  , m_onDirectionsReady(onDirectionsReady)
 {
   m_delegate.Reset();
   m_delegate.SetPointCheckCallback(bind(&RouterDelegateProxy::OnPointCheck, this, _1));
@@ -72,10 +74,24 @@ void AsyncRouter::RouterDelegateProxy::OnRemoveRoute(RouterResultCode resultCode
   m_onRemoveRoute(resultCode);
 }
 
+void AsyncRouter::RouterDelegateProxy::OnDirectionsReady(
+    uint64_t routeId, size_t firstSegmentIdx, vector<RouteSegment> const & routeSegments)
+{
+  if (!m_onDirectionsReady)
+    return;
+  {
+    lock_guard<mutex> l(m_guard);
+    if (m_directionsCancellable.IsCancelled())
+      return;
+  }
+  m_onDirectionsReady(routeId, firstSegmentIdx, routeSegments);
+}
+
 void AsyncRouter::RouterDelegateProxy::Cancel()
 {
   lock_guard<mutex> l(m_guard);
   m_delegate.Cancel();
+  m_directionsCancellable.Cancel();
 }
 
 bool AsyncRouter::FindClosestProjectionToRoad(m2::PointD const & point,
@@ -179,7 +195,8 @@ void AsyncRouter::CalculateRoute(Checkpoints const & checkpoints, m2::PointD con
 
   m_delegateProxy =
       make_shared<RouterDelegateProxy>(readyCallback, needMoreMapsCallback, removeRouteCallback,
-                                       m_pointCheckCallback, progressCallback, timeoutSec);
+                                       m_pointCheckCallback, progressCallback,
+                                       m_directionsReadyCallback, timeoutSec);
 
   m_hasRequest = true;
   m_threadCondVar.notify_one();
@@ -191,6 +208,12 @@ void AsyncRouter::SetGuidesTracks(GuidesTracks && guides)
   m_guides = move(guides);
 }
 
+void AsyncRouter::SetDirectionsReadyCallback(DirectionsReadyCallback const & directionsReadyCallback)
+{
+  unique_lock<mutex> ul(m_guard);
+  m_directionsReadyCallback = directionsReadyCallback;
+}
+
 void AsyncRouter::ClearState()
 {
   unique_lock<mutex> ul(m_guard);
@@ -364,6 +387,8 @@ void AsyncRouter::CalculateRoute()
   }
 
   // Draw route without waiting network latency.
+  bool const hasPendingDirections =
+      code == RouterResultCode::NoError && route->HasPendingDirections();
   if (code == RouterResultCode::NoError)
   {
     // Note. After call of this method |route| should be used only on ui thread.
@@ -403,5 +428,46 @@ void AsyncRouter::CalculateRoute()
                             [delegateProxy, code]() { delegateProxy->OnRemoveRoute(code); });
     }
   }
+
+  // The route is shown already, the rest of its turns and street names are generated now.
+  // A route which needs more maps is shown too, so its directions are generated as well.
+  if (hasPendingDirections)
+    GeneratePendingDirections(*router, routeId, delegateProxy);
+}
+
+void AsyncRouter::GeneratePendingDirections(IRouter & router, uint64_t routeId,
+                                            shared_ptr<RouterDelegateProxy> const & delegateProxy)
+{
+  // Reading of mwm sections may fail, the next attempt uses the same router state.
+  uint32_t constexpr kMaxAttempts = 2;
+
+  base::Timer timer;
+  auto const & cancellable = delegateProxy->GetDirectionsCancellable();
+  for (uint32_t attempt = 1; attempt <= kMaxAttempts && !cancellable.IsCancelled(); ++attempt)
+  {
+    size_t firstSegmentIdx = 0;
+    auto routeSegments = make_shared<vector<RouteSegment>>();
+    try
+    {
+      if (!router.GeneratePendingDirections(cancellable, firstSegmentIdx, *routeSegments))
+        continue;
+    }
+    catch (RootException const & e)
+    {
+      LOG(LERROR, ("Exception happened while generating directions, attempt", attempt, ":", e.Msg()));
+      continue;
+    }
+
+    LOG(LINFO, ("Directions are generated, elapsed seconds:", timer.ElapsedSeconds()));
+    GetPlatform().RunTask(Platform::Thread::Gui,
+                          [delegateProxy, routeId, firstSegmentIdx, routeSegments]() {
+                            delegateProxy->OnDirectionsReady(routeId, firstSegmentIdx,
+                                                             *routeSegments);
+                          });
+    return;
+  }
+
+  if (!cancellable.IsCancelled())
+    LOG(LWARNING, ("Directions are not generated for route", routeId));
 }
 }  // namespace routing
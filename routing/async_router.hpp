@@ -9,9 +9,11 @@
 
 #include "platform/platform.hpp"
 
+#include "base/cancellable.hpp"
 #include "base/thread.hpp"
 
 #include <condition_variable>
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -19,6 +21,7 @@
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace routing
 {
@@ -56,6 +59,9 @@ public:
                       uint32_t timeoutSec = RouterDelegate::kNoTimeout);
 
   void SetGuidesTracks(GuidesTracks && guides);
+  /// Sets a callback which is called at the GUI thread when turns and street names of a route
+  /// with pending directions (Route::HasPendingDirections()) are generated.
+  void SetDirectionsReadyCallback(DirectionsReadyCallback const & directionsReadyCallback);
   /// Interrupt routing and clear buffers
   void ClearState();
 
@@ -80,14 +86,20 @@ private:
                         RemoveRouteCallback const & onRemoveRoute,
                         PointCheckCallback const & onPointCheck,
                         ProgressCallback const & onProgress,
+                        DirectionsReadyCallback const & onDirectionsReady,
                         uint32_t timeoutSec);
 
     void OnReady(std::shared_ptr<Route> route, RouterResultCode resultCode);
     void OnNeedMoreMaps(uint64_t routeId, std::set<std::string> const & absentCounties);
     void OnRemoveRoute(RouterResultCode resultCode);
+    void OnDirectionsReady(uint64_t routeId, size_t firstSegmentIdx,
+                           std::vector<RouteSegment> const & routeSegments);
     void Cancel();
 
     RouterDelegate const & GetDelegate() const { return m_delegate; }
+    /// Directions are generated after the route is ready, so the timeout of the route
+    /// calculation is not applied to them.
+    base::Cancellable const & GetDirectionsCancellable() const { return m_directionsCancellable; }
 
   private:
     void OnProgress(float progress);
@@ -102,9 +114,16 @@ private:
     RemoveRouteCallback const m_onRemoveRoute;
     PointCheckCallback const m_onPointCheck;
     ProgressCallback const m_onProgress;
+    DirectionsReadyCallback const m_onDirectionsReady;
     RouterDelegate m_delegate;
+    base::Cancellable m_directionsCancellable;
   };
 
+  /// Generates turns and street names of |route| which are left by the router after the route
+  /// is passed to the GUI thread.
+  void GeneratePendingDirections(IRouter & router, uint64_t routeId,
+                                 std::shared_ptr<RouterDelegateProxy> const & delegateProxy);
+
 private:
   std::mutex m_guard;
 
@@ -126,6 +145,7 @@ private:
   std::shared_ptr<IRouter> m_router;
 
   PointCheckCallback const m_pointCheckCallback;
+  DirectionsReadyCallback m_directionsReadyCallback;
   uint64_t m_routeCounter = 0;
 };
 }  // namespace routing
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "routing/base/astar_graph.hpp"
+#include "routing/base/astar_search_state.hpp"
 #include "routing/base/astar_vertex_data.hpp"
 #include "routing/base/astar_weight.hpp"
 #include "routing/base/routing_result.hpp"
@@ -8,13 +9,19 @@
 #include "base/assert.hpp"
 #include "base/cancellable.hpp"
 #include "base/logging.hpp"
+#include "base/thread_pool_computational.hpp"
 
 #include <algorithm>
+#include <array>
+#include <exception>
 #include <functional>
+#include <future>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <optional>
 #include <queue>
+#include <set>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -26,6 +33,15 @@ namespace routing
 namespace astar
 {
 
+/// \brief Backward waves of the parallel bidirectional searches of a thread are propagated by
+/// its worker. The worker is kept for the life of the thread, so waves are resumed and searches
+/// are started without starting threads.
+inline base::thread_pool::computational::ThreadPool & GetBackwardWavePool()
+{
+  thread_local base::thread_pool::computational::ThreadPool pool(1 /* threadCount */);
+  return pool;
+}
+
 struct DefaultVisitor
 {
   template <class State, class Vertex> void operator() (State const &, Vertex const &) const {};
@@ -87,6 +103,23 @@ public:
     // Used for AdjustRoute.
     base::Cancellable const & m_cancellable;
     std::function<bool(Weight, Weight)> m_badReducedWeight = [](Weight, Weight) { return true; };
+    // Used for FindPath, FindPathBidirectional instead of |m_graph.HeuristicCostEstimate()|
+    // if it's set.
+    astar::Heuristic<Vertex, Weight> * m_heuristic = nullptr;
+    // Used for FindPathBidirectional. If it's set, the backward wave is propagated on this graph
+    // in a separate thread while the forward wave is propagated on |m_graph|. It should be
+    // an independent copy of |m_graph| with the same vertices, edges and heuristic which doesn't
+    // share any mutable state with |m_graph|. |m_badReducedWeight| is called from both threads,
+    // |m_onVisitedVertexCallback| is called for the forward wave only.
+    Graph * m_backwardGraph = nullptr;
+    // Used for the backward wave instead of |m_heuristic| if |m_backwardGraph| is set.
+    astar::Heuristic<Vertex, Weight> * m_backwardHeuristic = nullptr;
+
+    Weight HeuristicCostEstimate(Vertex const & from, Vertex const & to) const
+    {
+      return m_heuristic ? m_heuristic->HeuristicCostEstimate(from, to)
+                         : m_graph.HeuristicCostEstimate(from, to);
+    }
   };
 
   // |LengthChecker| callback used to check path length from start/finish to the edge (including the
@@ -108,6 +141,9 @@ public:
 
     Visitor m_onVisitedVertexCallback;
     LengthChecker const m_checkLengthCallback;
+    // Used for the backward wave of the parallel search if it's set. Otherwise
+    // |m_checkLengthCallback| is called from both threads.
+    std::optional<LengthChecker> m_backwardCheckLengthCallback;
   };
 
   template <typename LengthChecker = astar::DefaultLengthChecker>
@@ -122,17 +158,42 @@ public:
 
     astar::DefaultVisitor const m_onVisitedVertexCallback{};
     LengthChecker const m_checkLengthCallback;
+    std::optional<LengthChecker> m_backwardCheckLengthCallback;
 
   private:
     base::Cancellable const m_dummy;
   };
 
+private:
+  // State is what is going to be put in the priority queue. See the
+  // comment for FindPath for more information.
+  struct State
+  {
+    State(Vertex const & vertex, Weight const & distance, Weight const & heuristic)
+        : vertex(vertex), distance(distance), heuristic(heuristic)
+    {
+    }
+    State(Vertex const & vertex, Weight const & distance) : State(vertex, distance, Weight()) {}
+
+    inline bool operator>(State const & rhs) const { return distance > rhs.distance; }
+
+    Vertex vertex;
+    Weight distance;
+    Weight heuristic;
+  };
+
+  using SearchState = astar::SearchState<Vertex, Weight, State>;
+  using SearchStateLease = astar::SearchStateLease<SearchState>;
+
+public:
+  /// \brief Distances and parents of one wave. Their storage is taken from the pool of
+  /// the current thread, so a context should be destroyed by the thread which has created it.
   class Context final
   {
   public:
     Context(Graph & graph) : m_graph(graph)
     {
-      m_graph.SetAStarParents(true /* forward */, m_parents);
+      m_graph.SetAStarParents(true /* forward */, m_state->m_parents);
     }
 
     ~Context()
@@ -142,54 +203,51 @@ public:
 
     void Clear()
     {
-      m_distanceMap.clear();
-      m_parents.clear();
+      m_state->Clear();
     }
 
     bool HasDistance(Vertex const & vertex) const
     {
-      return m_distanceMap.find(vertex) != m_distanceMap.cend();
+      return m_state->m_distances.Contains(vertex);
     }
 
     Weight GetDistance(Vertex const & vertex) const
     {
-      auto const & it = m_distanceMap.find(vertex);
-      if (it == m_distanceMap.cend())
-        return kInfiniteDistance;
-
-      return it->second;
+      auto const * distance = m_state->m_distances.Find(vertex);
+      return distance ? *distance : kInfiniteDistance;
     }
 
     void SetDistance(Vertex const & vertex, Weight const & distance)
     {
-      m_distanceMap[vertex] = distance;
+      m_state->m_distances.InsertOrAssign(vertex, distance);
     }
 
     void SetParent(Vertex const & parent, Vertex const & child)
     {
-      m_parents[parent] = child;
+      m_state->m_parents[parent] = child;
     }
 
     bool HasParent(Vertex const & child) const
     {
-      return m_parents.count(child) != 0;
+      return m_state->m_parents.count(child) != 0;
     }
 
     Vertex const & GetParent(Vertex const & child) const
     {
-      auto const it = m_parents.find(child);
-      CHECK(it != m_parents.cend(), ("Can not find parent of child:", child));
+      auto const it = m_state->m_parents.find(child);
+      CHECK(it != m_state->m_parents.cend(), ("Can not find parent of child:", child));
       return it->second;
     }
 
-    typename Graph::Parents & GetParents() { return m_parents; }
+    typename Graph::Parents & GetParents() { return m_state->m_parents; }
+
+    astar::VertexQueue<State> & GetQueue() { return m_state->m_queue; }
 
     void ReconstructPath(Vertex const & v, std::vector<Vertex> & path) const;
 
   private:
     Graph & m_graph;
-    ska::bytell_hash_map<Vertex, Weight> m_distanceMap;
-    typename Graph::Parents m_parents;
+    SearchStateLease m_state;
   };
 
   // VisitVertex returns true: wave will continue
@@ -208,6 +266,7 @@ public:
   Result FindPath(P & params, RoutingResult<Vertex, Weight> & result) const;
 
   /// Fetch routes until \a emitter returns false.
+  /// The waves are propagated concurrently if |params.m_backwardGraph| is set.
   template <class P, class Emitter>
   Result FindPathBidirectionalEx(P & params, Emitter && emitter) const;
 
@@ -222,6 +281,36 @@ public:
     });
   }
 
+  // Limits of alternative routes of FindPathBidirectionalAlternatives(). Lengths are given
+  // relative to the length of the best route.
+  struct AlternativesParams
+  {
+    // Max number of alternatives besides the best route.
+    size_t m_maxAlternatives = 2;
+    // An alternative is not longer than (1 + |m_maxStretch|) lengths of the best route.
+    double m_maxStretch = 0.25;
+    // Length of the edges an alternative shares with the best route and the previous
+    // alternatives is not greater than |m_maxSharing|.
+    double m_maxSharing = 0.8;
+    // The part of an alternative which is in both shortest path trees (plateau) is not shorter
+    // than |m_minPlateau|. Every subpath of the plateau is a shortest path, so an alternative
+    // with a long plateau has no local detours.
+    double m_minPlateau = 0.2;
+  };
+
+  // Finds the best route as FindPathBidirectional() does and up to
+  // |altParams.m_maxAlternatives| alternatives in the search spaces of the same search (via-vertex
+  // method). After the best route is found every wave is propagated until its top shows that the
+  // remaining paths through the vertices it reaches are longer than the admissible stretch.
+  // Every vertex reached by both waves is a via vertex of a path: the shortest path to it in the
+  // forward tree and the shortest path from it in the backward tree. Via paths are checked by
+  // length, by plateau and by sharing with the routes already taken. |results| are sorted by
+  // length, the best route is the first one. The waves are always propagated in the calling
+  // thread, |params.m_backwardGraph| isn't used.
+  template <class P>
+  Result FindPathBidirectionalAlternatives(P & params, AlternativesParams const & altParams,
+                                           std::vector<RoutingResult<Vertex, Weight>> & results) const;
+
   // Adjust route to the previous one.
   // Expects |params.m_checkLengthCallback| to check wave propagation limit.
   template <typename P>
@@ -229,6 +318,18 @@ public:
                                                                     std::vector<Edge> const & prevRoute,
                                                                     RoutingResult<Vertex, Weight> & result) const;
 
+  // Finds shortest paths from |params.m_startVertex| to |targetsNumber| targets by one Dijkstra
+  // wave which is stopped when all the targets are reached. Targets are not vertices of the graph,
+  // they're reached by edges: |reachTargets(vertex, edge, emit)| should call |emit(targetIdx, weight)|
+  // for every target which may be reached from |vertex| by |edge| or by a part of it. |weight| is
+  // the weight of the way from |vertex| to the target, it should be non-negative.
+  // |results[i].m_path| is the path to the last vertex before i-th target, it's empty
+  // if the target isn't reached. |results[i].m_distance| is the weight of the path to the target.
+  // Expects |params.m_checkLengthCallback| to check wave propagation limit.
+  template <typename P, typename ReachTargets>
+  Result FindPathsToTargets(P & params, size_t targetsNumber, ReachTargets && reachTargets,
+                            std::vector<RoutingResult<Vertex, Weight>> & results) const;
+
 private:
   // Periodicity of switching a wave of bidirectional algorithm.
   static uint32_t constexpr kQueueSwitchPeriod = 128;
@@ -254,23 +355,6 @@ private:
     uint32_t count = 0;
   };
 
-  // State is what is going to be put in the priority queue. See the
-  // comment for FindPath for more information.
-  struct State
-  {
-    State(Vertex const & vertex, Weight const & distance, Weight const & heuristic)
-        : vertex(vertex), distance(distance), heuristic(heuristic)
-    {
-    }
-    State(Vertex const & vertex, Weight const & distance) : State(vertex, distance, Weight()) {}
-
-    inline bool operator>(State const & rhs) const { return distance > rhs.distance; }
-
-    Vertex vertex;
-    Weight distance;
-    Weight heuristic;
-  };
-
   // BidirectionalStepContext keeps all the information that is needed to
   // search starting from one of the two directions. Its main
   // purpose is to make the code that changes directions more readable.
@@ -279,11 +363,15 @@ private:
     using Parents = typename Graph::Parents;
 
     BidirectionalStepContext(bool forward, Vertex const & startVertex, Vertex const & finalVertex,
-                             Graph & graph)
+                             Graph & graph, astar::Heuristic<Vertex, Weight> * heuristic)
         : forward(forward)
         , startVertex(startVertex)
         , finalVertex(finalVertex)
         , graph(graph)
+        , heuristic(heuristic)
+        , queue(storage->m_queue)
+        , bestDistance(storage->m_distances)
+        , parent(storage->m_parents)
     {
       bestVertex = forward ? startVertex : finalVertex;
       pS = ConsistentHeuristic(bestVertex);
@@ -298,7 +386,9 @@ private:
     Weight TopDistance() const
     {
       ASSERT(!queue.empty(), ());
-      return bestDistance.at(queue.top().vertex);
+      auto const * distance = bestDistance.Find(queue.top().vertex);
+      CHECK(distance, ());
+      return *distance;
     }
 
     // p_f(v) = 0.5*(π_f(v) - π_r(v))
@@ -314,8 +404,8 @@ private:
     // particular routes when debugging turned out to be easier.
     Weight ConsistentHeuristic(Vertex const & v) const
     {
-      auto const piF = graph.HeuristicCostEstimate(v, finalVertex);
-      auto const piR = graph.HeuristicCostEstimate(v, startVertex);
+      auto const piF = HeuristicCostEstimate(v, finalVertex);
+      auto const piR = HeuristicCostEstimate(v, startVertex);
       if (forward)
       {
         /// @todo careful: with this "return" here and below in the Backward case
@@ -330,21 +420,27 @@ private:
       }
     }
 
+    Weight HeuristicCostEstimate(Vertex const & v, Vertex const & to) const
+    {
+      return heuristic ? heuristic->HeuristicCostEstimate(v, to)
+                       : graph.HeuristicCostEstimate(v, to);
+    }
+
     bool ExistsStateWithBetterDistance(State const & state, Weight const & eps = Weight(0.0)) const
     {
-      auto const it = bestDistance.find(state.vertex);
-      return it != bestDistance.end() && state.distance > it->second - eps;
+      auto const * distance = bestDistance.Find(state.vertex);
+      return distance && state.distance > *distance - eps;
     }
 
     void UpdateDistance(State const & state)
     {
-      bestDistance.insert_or_assign(state.vertex, state.distance);
+      bestDistance.InsertOrAssign(state.vertex, state.distance);
     }
 
     std::optional<Weight> GetDistance(Vertex const & vertex) const
     {
-      auto const it = bestDistance.find(vertex);
-      return it != bestDistance.cend() ? std::optional<Weight>(it->second) : std::nullopt;
+      auto const * distance = bestDistance.Find(vertex);
+      return distance ? std::optional<Weight>(*distance) : std::nullopt;
     }
 
     void UpdateParent(Vertex const & to, Vertex const & from)
@@ -374,15 +470,136 @@ private:
     Vertex const & startVertex;
     Vertex const & finalVertex;
     Graph & graph;
+    astar::Heuristic<Vertex, Weight> * const heuristic;
 
-    std::priority_queue<State, std::vector<State>, std::greater<State>> queue;
-    ska::bytell_hash_map<Vertex, Weight> bestDistance;
-    Parents parent;
+    // Storage of the wave which is reused by the next searches of the thread.
+    SearchStateLease storage;
+    astar::VertexQueue<State> & queue;
+    astar::VertexMap<Vertex, Weight> & bestDistance;
+    Parents & parent;
     Vertex bestVertex;
 
     Weight pS;
   };
 
+  // Reduced distances of both waves of the parallel bidirectional search. They duplicate
+  // the distances of the waves' contexts to let a wave check whether a vertex is reached by
+  // the other wave. The table is split into shards with a mutex per shard, so the waves seldom
+  // wait for each other.
+  class MeetingTable final
+  {
+  public:
+    // Sets reduced distance of |vertex| for the wave |forward|.
+    // \returns reduced distance of |vertex| for the other wave if it has reached |vertex|.
+    std::optional<Weight> Update(bool forward, Vertex const & vertex, Weight const & distance)
+    {
+      auto & shard = m_shards[std::hash<Vertex>()(vertex) % kShardsNumber];
+      std::lock_guard<std::mutex> guard(shard.m_mutex);
+      auto & distances = shard.m_distances[vertex];
+      distances[forward ? 0 : 1] = distance;
+      return distances[forward ? 1 : 0];
+    }
+
+  private:
+    static size_t constexpr kShardsNumber = 64;
+
+    struct Shard
+    {
+      std::mutex m_mutex;
+      // Distances of the forward and the backward waves.
+      ska::bytell_hash_map<Vertex, std::array<std::optional<Weight>, 2>> m_distances;
+    };
+
+    std::array<Shard, kShardsNumber> m_shards;
+  };
+
+  // State of the parallel bidirectional search which is shared by the waves.
+  class ParallelSearchState final
+  {
+  public:
+    explicit ParallelSearchState(Weight const & epsilon) : m_epsilon(epsilon) {}
+
+    // Publishes |top|, reduced distance of the queue top of the wave |forward|.
+    // \returns false if the wave should stop.
+    // The termination criterion is the same as the one of the sequential search. Reduced
+    // distances of queue tops don't decrease, so an outdated top of the other wave is not greater
+    // than the actual one and the wave may only be stopped later than necessary but not earlier.
+    bool UpdateTop(bool forward, Weight const & top)
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      m_tops[forward ? 0 : 1] = top;
+      if (!m_stopped && m_bestPathReducedLength && IsShortestImpl(*m_bestPathReducedLength))
+        m_stopped = true;
+      return !m_stopped;
+    }
+
+    void UpdateBestPath(Weight const & reducedLength)
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      if (!m_bestPathReducedLength || reducedLength < *m_bestPathReducedLength)
+        m_bestPathReducedLength = reducedLength;
+    }
+
+    // Marks the queue of the wave |forward| as empty and stops both waves. If the waves
+    // haven't met by this time, they never will, like in the sequential search.
+    void SetExhausted(bool forward)
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      m_exhausted[forward ? 0 : 1] = true;
+      m_stopped = true;
+    }
+
+    // Stops both waves.
+    void Stop(bool cancelled)
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      m_stopped = true;
+      m_cancelled = m_cancelled || cancelled;
+    }
+
+    // Lets the stopped waves continue. |bestPathReducedLength| is the length of the best path
+    // which is left after the paths of the previous run are checked.
+    void Resume(std::optional<Weight> const & bestPathReducedLength)
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      m_stopped = false;
+      m_bestPathReducedLength = bestPathReducedLength;
+    }
+
+    // The methods below are used when the waves are stopped.
+    bool IsCancelled() const { return m_cancelled; }
+    // \returns true if a wave can't be propagated anymore.
+    bool IsExhausted() const { return m_exhausted[0] || m_exhausted[1]; }
+    // \returns true if there's no path shorter than |reducedLength| among unpropagated vertices.
+    bool IsShortest(Weight const & reducedLength) const { return IsShortestImpl(reducedLength); }
+
+  private:
+    bool IsShortestImpl(Weight const & reducedLength) const
+    {
+      return m_exhausted[0] || m_exhausted[1] ||
+             m_tops[0] + m_tops[1] >= reducedLength - m_epsilon;
+    }
+
+    Weight const m_epsilon;
+
+    std::mutex m_mutex;
+    std::array<Weight, 2> m_tops = {{kZeroDistance, kZeroDistance}};
+    std::array<bool, 2> m_exhausted = {{false, false}};
+    std::optional<Weight> m_bestPathReducedLength;
+    bool m_stopped = false;
+    bool m_cancelled = false;
+  };
+
+  template <class P, class Emitter>
+  Result FindPathBidirectionalParallel(P & params, Emitter && emitter) const;
+
+  // Propagates a wave of the parallel bidirectional search until |state| stops it.
+  // Vertices which are reached by both waves are added to |meetingVertices|.
+  template <class P>
+  void PropagateParallelWave(P & params, BidirectionalStepContext & context,
+                             MeetingTable & meetingTable, ParallelSearchState & state,
+                             std::vector<Vertex> & meetingVertices) const;
+
   static void ReconstructPath(Vertex const & v,
                               typename BidirectionalStepContext::Parents const & parent,
                               std::vector<Vertex> & path);
@@ -411,7 +628,7 @@ void AStarAlgorithm<Vertex, Edge, Weight>::PropagateWave(
 
   context.Clear();
 
-  std::priority_queue<State, std::vector<State>, std::greater<State>> queue;
+  auto & queue = context.GetQueue();
 
   context.SetDistance(startVertex, kZeroDistance);
   queue.push(State(startVertex, kZeroDistance));
@@ -504,8 +721,8 @@ AStarAlgorithm<Vertex, Edge, Weight>::FindPath(P & params, RoutingResult<Vertex,
   Result resultCode = Result::NoPath;
 
   auto const heuristicDiff = [&](Vertex const & vertexFrom, Vertex const & vertexTo) {
-    return graph.HeuristicCostEstimate(vertexFrom, finalVertex) -
-           graph.HeuristicCostEstimate(vertexTo, finalVertex);
+    return params.HeuristicCostEstimate(vertexFrom, finalVertex) -
+           params.HeuristicCostEstimate(vertexTo, finalVertex);
   };
 
   auto const fullToReducedLength = [&](Vertex const & vertexFrom, Vertex const & vertexTo,
@@ -573,13 +790,18 @@ template <class P, class Emitter>
 typename AStarAlgorithm<Vertex, Edge, Weight>::Result
 AStarAlgorithm<Vertex, Edge, Weight>::FindPathBidirectionalEx(P & params, Emitter && emitter) const
 {
+  if (params.m_backwardGraph)
+    return FindPathBidirectionalParallel(params, std::forward<Emitter>(emitter));
+
   auto const epsilon = params.m_weightEpsilon;
   auto & graph = params.m_graph;
   auto const & finalVertex = params.m_finalVertex;
   auto const & startVertex = params.m_startVertex;
 
-  BidirectionalStepContext forward(true /* forward */, startVertex, finalVertex, graph);
-  BidirectionalStepContext backward(false /* forward */, startVertex, finalVertex, graph);
+  BidirectionalStepContext forward(true /* forward */, startVertex, finalVertex, graph,
+                                   params.m_heuristic);
+  BidirectionalStepContext backward(false /* forward */, startVertex, finalVertex, graph,
+                                    params.m_heuristic);
 
   auto & forwardParents = forward.GetParents();
   auto & backwardParents = backward.GetParents();
@@ -737,6 +959,492 @@ AStarAlgorithm<Vertex, Edge, Weight>::FindPathBidirectionalEx(P & params, Emitte
   return Result::NoPath;
 }
 
+template <typename Vertex, typename Edge, typename Weight>
+template <class P>
+typename AStarAlgorithm<Vertex, Edge, Weight>::Result
+AStarAlgorithm<Vertex, Edge, Weight>::FindPathBidirectionalAlternatives(
+    P & params, AlternativesParams const & altParams,
+    std::vector<RoutingResult<Vertex, Weight>> & results) const
+{
+  results.clear();
+
+  auto const epsilon = params.m_weightEpsilon;
+  auto & graph = params.m_graph;
+  auto const & finalVertex = params.m_finalVertex;
+  auto const & startVertex = params.m_startVertex;
+
+  if (startVertex == finalVertex)
+  {
+    results.emplace_back();
+    results.back().m_path.push_back(startVertex);
+    results.back().m_distance = kZeroDistance;
+    return Result::OK;
+  }
+
+  BidirectionalStepContext forward(true /* forward */, startVertex, finalVertex, graph,
+                                   params.m_heuristic);
+  BidirectionalStepContext backward(false /* forward */, startVertex, finalVertex, graph,
+                                    params.m_heuristic);
+
+  auto & forwardParents = forward.GetParents();
+  auto & backwardParents = backward.GetParents();
+
+  forward.UpdateDistance(State(startVertex, kZeroDistance));
+  forward.queue.push(State(startVertex, kZeroDistance, forward.ConsistentHeuristic(startVertex)));
+
+  backward.UpdateDistance(State(finalVertex, kZeroDistance));
+  backward.queue.push(State(finalVertex, kZeroDistance, backward.ConsistentHeuristic(finalVertex)));
+
+  // Real lengths of the parts of a via path from start to |vertex| and from |vertex| to finish.
+  auto const getForwardLength = [&forward](Vertex const & vertex)
+  {
+    return *forward.GetDistance(vertex) + forward.pS - forward.ConsistentHeuristic(vertex);
+  };
+  auto const getBackwardLength = [&backward](Vertex const & vertex)
+  {
+    return *backward.GetDistance(vertex) + backward.pS - backward.ConsistentHeuristic(vertex);
+  };
+
+  bool foundAnyPath = false;
+  Weight bestPathReducedLength = kZeroDistance;
+  Weight bestPathRealLength = kZeroDistance;
+  std::vector<Vertex> viaVertices;
+
+  BidirectionalStepContext * cur = &forward;
+  BidirectionalStepContext * nxt = &backward;
+
+  typename Graph::EdgeListT adj;
+
+  uint32_t steps = 0;
+  PeriodicPollCancellable periodicCancellable(params.m_cancellable);
+
+  // A via path is found if its via vertex is reached by both waves. Reduced lengths of the parts
+  // of a via path are not negative and their sum differs from the real length of the path by
+  // the same constant for all paths. So every wave is propagated until its top exceeds the bound
+  // of reduced lengths of admissible paths, unlike FindPathBidirectionalEx() where the sum of
+  // the tops is checked.
+  auto const isPropagated = [&](BidirectionalStepContext const & context)
+  {
+    return context.queue.empty() ||
+           (foundAnyPath && context.TopDistance() >=
+                                bestPathReducedLength + altParams.m_maxStretch * bestPathRealLength);
+  };
+
+  while (true)
+  {
+    // If a wave is exhausted before any path is found, there is no path.
+    if (!foundAnyPath && (cur->queue.empty() || nxt->queue.empty()))
+      break;
+
+    if (isPropagated(*cur) && isPropagated(*nxt))
+      break;
+
+    ++steps;
+
+    if (periodicCancellable.IsCancelled())
+      return Result::Cancelled;
+
+    if (isPropagated(*cur) || (steps % kQueueSwitchPeriod == 0 && !isPropagated(*nxt)))
+      std::swap(cur, nxt);
+
+    State const stateV = cur->queue.top();
+    cur->queue.pop();
+
+    if (cur->ExistsStateWithBetterDistance(stateV))
+      continue;
+
+    auto const endV = cur->forward ? cur->finalVertex : cur->startVertex;
+    params.m_onVisitedVertexCallback(std::make_pair(stateV, cur), endV);
+
+    cur->GetAdjacencyList(stateV, adj);
+    auto const & pV = stateV.heuristic;
+    for (auto const & edge : adj)
+    {
+      State stateW(edge.GetTarget(), kZeroDistance);
+
+      if (stateV.vertex == stateW.vertex)
+        continue;
+
+      auto const weight = edge.GetWeight();
+      auto const pW = cur->ConsistentHeuristic(stateW.vertex);
+      auto const reducedWeight = weight + pW - pV;
+
+      if (reducedWeight < -epsilon && params.m_badReducedWeight(reducedWeight, std::max(pW, pV)))
+      {
+        LOG(LERROR, ("Invariant violated for:", "v =", stateV.vertex, "w =", stateW.vertex,
+                     "reduced weight =", reducedWeight));
+      }
+
+      stateW.distance = stateV.distance + std::max(reducedWeight, kZeroDistance);
+
+      auto const fullLength = weight + stateV.distance + cur->pS - pV;
+      if (!params.m_checkLengthCallback(fullLength))
+        continue;
+
+      if (cur->ExistsStateWithBetterDistance(stateW, epsilon))
+        continue;
+
+      stateW.heuristic = pW;
+      cur->UpdateDistance(stateW);
+      cur->UpdateParent(stateW.vertex, stateV.vertex);
+
+      if (auto op = nxt->GetDistance(stateW.vertex); op)
+      {
+        viaVertices.push_back(stateW.vertex);
+
+        auto const curPathReducedLength = stateW.distance + *op;
+        if ((!foundAnyPath || bestPathReducedLength > curPathReducedLength) &&
+            graph.AreWavesConnectible(forwardParents, stateW.vertex, backwardParents))
+        {
+          bestPathReducedLength = curPathReducedLength;
+          bestPathRealLength = getForwardLength(stateW.vertex) + getBackwardLength(stateW.vertex);
+          foundAnyPath = true;
+        }
+      }
+
+      if (stateW.vertex != endV)
+        cur->queue.push(stateW);
+    }
+  }
+
+  if (!foundAnyPath)
+    return Result::NoPath;
+
+  // Distances of a via vertex may be updated after it's found, so lengths are calculated here.
+  std::sort(viaVertices.begin(), viaVertices.end());
+  viaVertices.erase(std::unique(viaVertices.begin(), viaVertices.end()), viaVertices.end());
+
+  std::vector<std::pair<Weight, Vertex>> viaPaths;
+  viaPaths.reserve(viaVertices.size());
+  for (auto const & vertex : viaVertices)
+    viaPaths.emplace_back(getForwardLength(vertex) + getBackwardLength(vertex), vertex);
+  std::sort(viaPaths.begin(), viaPaths.end());
+
+  // Via vertices of the plateaus of the checked paths. Via vertices of a plateau give the same path.
+  std::set<Vertex> checkedVertices;
+  // Edges of |results| with their weights.
+  std::map<std::pair<Vertex, Vertex>, Weight> takenEdges;
+  std::vector<Vertex> backwardPath;
+  for (auto const & [length, via] : viaPaths)
+  {
+    if (results.size() > altParams.m_maxAlternatives)
+      break;
+
+    Weight const bestLength = results.empty() ? length : results.front().m_distance;
+    if (length > bestLength + altParams.m_maxStretch * bestLength)
+      break;
+
+    if (!checkedVertices.insert(via).second)
+      continue;
+
+    if (!graph.AreWavesConnectible(forwardParents, via, backwardParents) ||
+        !params.m_checkLengthCallback(length))
+    {
+      continue;
+    }
+
+    // The plateau is extended from |via| while the edges are in both trees.
+    Vertex plateauBegin = via;
+    while (true)
+    {
+      auto const prev = forward.GetParent(plateauBegin);
+      if (!prev || backward.GetParent(*prev) != plateauBegin)
+        break;
+      plateauBegin = *prev;
+      checkedVertices.insert(plateauBegin);
+    }
+    Vertex plateauEnd = via;
+    while (true)
+    {
+      auto const next = backward.GetParent(plateauEnd);
+      if (!next || forward.GetParent(*next) != plateauEnd)
+        break;
+      plateauEnd = *next;
+      checkedVertices.insert(plateauEnd);
+    }
+
+    RoutingResult<Vertex, Weight> route;
+    ReconstructPath(via, forwardParents, route.m_path);
+    size_t const viaIdx = route.m_path.size() - 1;
+    ReconstructPath(via, backwardParents, backwardPath);
+    route.m_path.insert(route.m_path.end(), backwardPath.rbegin() + 1, backwardPath.rend());
+    route.m_distance = length;
+
+    if (!results.empty())
+    {
+      auto const plateauLength = getForwardLength(plateauEnd) - getForwardLength(plateauBegin);
+      if (plateauLength < altParams.m_minPlateau * bestLength)
+        continue;
+
+      Weight sharedLength = kZeroDistance;
+      for (size_t i = 1; i < route.m_path.size(); ++i)
+      {
+        auto const it = takenEdges.find(std::make_pair(route.m_path[i - 1], route.m_path[i]));
+        if (it != takenEdges.cend())
+          sharedLength = sharedLength + it->second;
+      }
+
+      if (sharedLength > altParams.m_maxSharing * bestLength)
+        continue;
+    }
+
+    // Distances from start to the vertices of the path give weights of its edges.
+    auto const getPosition = [&](size_t i) {
+      return i <= viaIdx ? getForwardLength(route.m_path[i])
+                         : length - getBackwardLength(route.m_path[i]);
+    };
+    Weight prevPosition = getPosition(0);
+    for (size_t i = 1; i < route.m_path.size(); ++i)
+    {
+      Weight const position = getPosition(i);
+      takenEdges.emplace(std::make_pair(route.m_path[i - 1], route.m_path[i]),
+                         position - prevPosition);
+      prevPosition = position;
+    }
+
+    results.push_back(std::move(route));
+  }
+
+  return results.empty() ? Result::NoPath : Result::OK;
+}
+
+// Parallel version of FindPathBidirectionalEx: the forward wave is propagated in the calling
+// thread and the backward wave is propagated by the worker of the calling thread, see
+// astar::GetBackwardWavePool(), on |params.m_backwardGraph|.
+// A wave finds a meeting vertex with the help of MeetingTable when it updates the distance
+// of a vertex which has the distance of the other wave. The waves stop when the sum of their
+// queue tops reaches the shortest found path. AreWavesConnectible() reads the parents of both
+// waves, so meeting vertices are checked by it only after the waves are stopped. If the shortest
+// meeting vertex is not connectible or |emitter| rejects the path, the waves are resumed
+// from their queues.
+template <typename Vertex, typename Edge, typename Weight>
+template <class P, class Emitter>
+typename AStarAlgorithm<Vertex, Edge, Weight>::Result
+AStarAlgorithm<Vertex, Edge, Weight>::FindPathBidirectionalParallel(P & params,
+                                                                    Emitter && emitter) const
+{
+  CHECK(params.m_backwardGraph, ());
+  CHECK_NOT_EQUAL(&params.m_graph, params.m_backwardGraph, ());
+
+  auto & graph = params.m_graph;
+  auto const & finalVertex = params.m_finalVertex;
+  auto const & startVertex = params.m_startVertex;
+
+  BidirectionalStepContext forward(true /* forward */, startVertex, finalVertex, graph,
+                                   params.m_heuristic);
+  BidirectionalStepContext backward(false /* forward */, startVertex, finalVertex,
+                                    *params.m_backwardGraph, params.m_backwardHeuristic);
+
+  MeetingTable meetingTable;
+  ParallelSearchState state(params.m_weightEpsilon);
+  std::vector<Vertex> forwardMeetingVertices;
+  std::vector<Vertex> backwardMeetingVertices;
+
+  forward.UpdateDistance(State(startVertex, kZeroDistance));
+  forward.queue.push(State(startVertex, kZeroDistance, forward.ConsistentHeuristic(startVertex)));
+  meetingTable.Update(true /* forward */, startVertex, kZeroDistance);
+
+  backward.UpdateDistance(State(finalVertex, kZeroDistance));
+  backward.queue.push(State(finalVertex, kZeroDistance, backward.ConsistentHeuristic(finalVertex)));
+  if (meetingTable.Update(false /* forward */, finalVertex, kZeroDistance))
+  {
+    backwardMeetingVertices.push_back(finalVertex);
+    state.UpdateBestPath(kZeroDistance);
+  }
+
+  auto const getRealLength = [&forward, &backward](Vertex const & meetingVertex)
+  {
+    return *forward.GetDistance(meetingVertex) + forward.pS -
+           forward.ConsistentHeuristic(meetingVertex) + *backward.GetDistance(meetingVertex) +
+           backward.pS - backward.ConsistentHeuristic(meetingVertex);
+  };
+
+  auto const makeResult = [&](Vertex const & meetingVertex)
+  {
+    RoutingResult<Vertex, Weight> result;
+    ReconstructPath(meetingVertex, forward.GetParents(), result.m_path);
+    std::vector<Vertex> backwardPath;
+    ReconstructPath(meetingVertex, backward.GetParents(), backwardPath);
+    // |meetingVertex| is the last vertex of both paths.
+    result.m_path.insert(result.m_path.end(), backwardPath.rbegin() + 1, backwardPath.rend());
+    result.m_distance = getRealLength(meetingVertex);
+    return result;
+  };
+
+  while (true)
+  {
+    auto backwardWave = astar::GetBackwardWavePool().Submit([&]() {
+      try
+      {
+        PropagateParallelWave(params, backward, meetingTable, state, backwardMeetingVertices);
+      }
+      catch (...)
+      {
+        state.Stop(false /* cancelled */);
+        throw;
+      }
+    });
+
+    try
+    {
+      PropagateParallelWave(params, forward, meetingTable, state, forwardMeetingVertices);
+    }
+    catch (...)
+    {
+      state.Stop(false /* cancelled */);
+      backwardWave.wait();
+      throw;
+    }
+
+    // Rethrows an exception of the backward wave.
+    backwardWave.get();
+
+    if (state.IsCancelled())
+      return Result::Cancelled;
+
+    // The distances of a meeting vertex may be updated after it's found, so the lengths
+    // of the paths are calculated after the waves are stopped.
+    auto & meetingVertices = forwardMeetingVertices;
+    meetingVertices.insert(meetingVertices.end(), backwardMeetingVertices.cbegin(),
+                           backwardMeetingVertices.cend());
+    backwardMeetingVertices.clear();
+    std::sort(meetingVertices.begin(), meetingVertices.end());
+    meetingVertices.erase(std::unique(meetingVertices.begin(), meetingVertices.end()),
+                          meetingVertices.end());
+
+    std::vector<std::pair<Weight, Vertex>> paths;
+    paths.reserve(meetingVertices.size());
+    for (auto const & vertex : meetingVertices)
+      paths.emplace_back(*forward.GetDistance(vertex) + *backward.GetDistance(vertex), vertex);
+    meetingVertices.clear();
+
+    std::sort(paths.begin(), paths.end(), [](auto const & lhs, auto const & rhs) {
+      return lhs.first < rhs.first;
+    });
+
+    // Unlike the sequential search the length of the whole path is checked: which parts of
+    // the path are found by each wave depends on the threads scheduling.
+    auto const it = std::find_if(paths.cbegin(), paths.cend(), [&](auto const & path) {
+      return graph.AreWavesConnectible(forward.GetParents(), path.second, backward.GetParents()) &&
+             params.m_checkLengthCallback(getRealLength(path.second));
+    });
+
+    if (it == paths.cend())
+    {
+      if (state.IsExhausted())
+        return Result::NoPath;
+
+      state.Resume(std::nullopt /* bestPathReducedLength */);
+      continue;
+    }
+
+    auto const & [reducedLength, meetingVertex] = *it;
+    if (!state.IsShortest(reducedLength))
+    {
+      // The waves were stopped by a shorter path which is not connectible or too long.
+      for (auto pathIt = it; pathIt != paths.cend(); ++pathIt)
+        meetingVertices.push_back(pathIt->second);
+
+      state.Resume(reducedLength);
+      continue;
+    }
+
+    if (emitter(makeResult(meetingVertex)) || state.IsExhausted())
+      return Result::OK;
+
+    state.Resume(std::nullopt /* bestPathReducedLength */);
+  }
+}
+
+template <typename Vertex, typename Edge, typename Weight>
+template <class P>
+void AStarAlgorithm<Vertex, Edge, Weight>::PropagateParallelWave(
+    P & params, BidirectionalStepContext & context, MeetingTable & meetingTable,
+    ParallelSearchState & state, std::vector<Vertex> & meetingVertices) const
+{
+  auto const epsilon = params.m_weightEpsilon;
+  auto const & endV = context.forward ? context.finalVertex : context.startVertex;
+  auto const & checkLength = context.forward || !params.m_backwardCheckLengthCallback
+                                 ? params.m_checkLengthCallback
+                                 : *params.m_backwardCheckLengthCallback;
+
+  typename Graph::EdgeListT adj;
+  PeriodicPollCancellable periodicCancellable(params.m_cancellable);
+
+  while (true)
+  {
+    if (periodicCancellable.IsCancelled())
+    {
+      state.Stop(true /* cancelled */);
+      return;
+    }
+
+    if (context.queue.empty())
+    {
+      state.SetExhausted(context.forward);
+      return;
+    }
+
+    State const stateV = context.queue.top();
+    if (context.ExistsStateWithBetterDistance(stateV))
+    {
+      context.queue.pop();
+      continue;
+    }
+
+    // The top is popped after it's published, so a stopped wave may be resumed.
+    if (!state.UpdateTop(context.forward, stateV.distance))
+      return;
+
+    context.queue.pop();
+
+    if (context.forward)
+      params.m_onVisitedVertexCallback(std::make_pair(stateV, &context), endV);
+
+    context.GetAdjacencyList(stateV, adj);
+    auto const & pV = stateV.heuristic;
+    for (auto const & edge : adj)
+    {
+      State stateW(edge.GetTarget(), kZeroDistance);
+
+      if (stateV.vertex == stateW.vertex)
+        continue;
+
+      auto const weight = edge.GetWeight();
+      auto const pW = context.ConsistentHeuristic(stateW.vertex);
+      auto const reducedWeight = weight + pW - pV;
+
+      if (reducedWeight < -epsilon && params.m_badReducedWeight(reducedWeight, std::max(pW, pV)))
+      {
+        LOG(LERROR, ("Invariant violated for:", "v =", stateV.vertex, "w =", stateW.vertex,
+                     "reduced weight =", reducedWeight));
+      }
+
+      stateW.distance = stateV.distance + std::max(reducedWeight, kZeroDistance);
+
+      auto const fullLength = weight + stateV.distance + context.pS - pV;
+      if (!checkLength(fullLength))
+        continue;
+
+      if (context.ExistsStateWithBetterDistance(stateW, epsilon))
+        continue;
+
+      stateW.heuristic = pW;
+      context.UpdateDistance(stateW);
+      context.UpdateParent(stateW.vertex, stateV.vertex);
+
+      if (auto const distW = meetingTable.Update(context.forward, stateW.vertex, stateW.distance))
+      {
+        meetingVertices.push_back(stateW.vertex);
+        state.UpdateBestPath(stateW.distance + *distW);
+      }
+
+      if (stateW.vertex != endV)
+        context.queue.push(stateW);
+    }
+  }
+}
+
 template <typename Vertex, typename Edge, typename Weight>
 template <typename P>
 typename AStarAlgorithm<Vertex, Edge, Weight>::Result
@@ -754,13 +1462,22 @@ AStarAlgorithm<Vertex, Edge, Weight>::AdjustRoute(P & params,
   auto minDistance = kInfiniteDistance;
   Vertex returnVertex;
 
-  std::map<Vertex, Weight> remainingDistances;
+  // Index of the edge of |prevRoute| which leads to a vertex and the weight of the rest of the
+  // route from the vertex. The first edge is kept for the vertices which are visited twice.
+  struct RouteVertex
+  {
+    size_t m_edgeIdx = 0;
+    Weight m_remainingDistance = kZeroDistance;
+  };
+  ska::bytell_hash_map<Vertex, RouteVertex> routeVertices;
+  routeVertices.reserve(prevRoute.size());
   auto remainingDistance = kZeroDistance;
 
-  for (auto it = prevRoute.crbegin(); it != prevRoute.crend(); ++it)
+  for (size_t i = prevRoute.size(); i > 0; --i)
   {
-    remainingDistances[it->GetTarget()] = remainingDistance;
-    remainingDistance += it->GetWeight();
+    auto const & edge = prevRoute[i - 1];
+    routeVertices[edge.GetTarget()] = {i - 1, remainingDistance};
+    remainingDistance += edge.GetWeight();
   }
 
   Context context(graph);
@@ -774,12 +1491,18 @@ AStarAlgorithm<Vertex, Edge, Weight>::AdjustRoute(P & params,
       return false;
     }
 
+    // Vertices are visited in order of distance and the rest of the route is never negative,
+    // so the route can't be rejoined better than it's already done.
+    auto const distance = context.GetDistance(vertex);
+    if (distance >= minDistance)
+      return false;
+
     params.m_onVisitedVertexCallback(startVertex, vertex);
 
-    auto it = remainingDistances.find(vertex);
-    if (it != remainingDistances.cend())
+    auto it = routeVertices.find(vertex);
+    if (it != routeVertices.cend())
     {
-      auto const fullDistance = context.GetDistance(vertex) + it->second;
+      auto const fullDistance = distance + it->second.m_remainingDistance;
       if (fullDistance < minDistance)
       {
         minDistance = fullDistance;
@@ -811,25 +1534,114 @@ AStarAlgorithm<Vertex, Edge, Weight>::AdjustRoute(P & params,
   context.ReconstructPath(returnVertex, result.m_path);
 
   // Append remaining route.
-  bool found = false;
-  for (size_t i = 0; i < prevRoute.size(); ++i)
+  auto const & returnRouteVertex = routeVertices[returnVertex];
+  for (size_t i = returnRouteVertex.m_edgeIdx + 1; i < prevRoute.size(); ++i)
+    result.m_path.push_back(prevRoute[i].GetTarget());
+
+  result.m_distance = minDistance;
+  return Result::OK;
+}
+
+template <typename Vertex, typename Edge, typename Weight>
+template <typename P, typename ReachTargets>
+typename AStarAlgorithm<Vertex, Edge, Weight>::Result
+AStarAlgorithm<Vertex, Edge, Weight>::FindPathsToTargets(
+    P & params, size_t targetsNumber, ReachTargets && reachTargets,
+    std::vector<RoutingResult<Vertex, Weight>> & results) const
+{
+  auto const epsilon = params.m_weightEpsilon;
+  auto & graph = params.m_graph;
+  auto const & startVertex = params.m_startVertex;
+
+  results.assign(targetsNumber, {});
+
+  struct TargetState
   {
-    if (prevRoute[i].GetTarget() == returnVertex)
+    bool operator>(TargetState const & rhs) const { return distance > rhs.distance; }
+
+    Weight distance;
+    size_t targetIdx;
+    // The last edge before the target.
+    Vertex parent;
+    Vertex vertex;
+  };
+
+  // A way to a target is emitted when an edge from a settled vertex is relaxed, so its weight
+  // is not less than the distance to the settled vertex. Hence the target is reached
+  // by the shortest way when the wave passes the weight of the way.
+  std::priority_queue<TargetState, std::vector<TargetState>, std::greater<TargetState>> targetQueue;
+  std::vector<std::optional<std::pair<Vertex, Vertex>>> lastEdges(targetsNumber);
+  size_t reachedNumber = 0;
+
+  auto const reachTargetsUpTo = [&](Weight const & distance) {
+    while (!targetQueue.empty() && targetQueue.top().distance <= distance)
     {
-      for (size_t j = i + 1; j < prevRoute.size(); ++j)
-        result.m_path.push_back(prevRoute[j].GetTarget());
+      auto const state = targetQueue.top();
+      targetQueue.pop();
+      if (lastEdges[state.targetIdx])
+        continue;
 
-      found = true;
-      break;
+      lastEdges[state.targetIdx] = std::make_pair(state.parent, state.vertex);
+      results[state.targetIdx].m_distance = state.distance;
+      ++reachedNumber;
+    }
+  };
+
+  bool wasCancelled = false;
+  Context context(graph);
+  PeriodicPollCancellable periodicCancellable(params.m_cancellable);
+
+  auto visitVertex = [&](Vertex const & vertex) {
+    if (periodicCancellable.IsCancelled())
+    {
+      wasCancelled = true;
+      return false;
     }
-  }
 
-  CHECK(found, ("Can't find", returnVertex, ", prev:", prevRoute.size(),
-                ", adjust:", result.m_path.size()));
+    params.m_onVisitedVertexCallback(vertex, startVertex);
+
+    reachTargetsUpTo(context.GetDistance(vertex));
+    return reachedNumber < targetsNumber;
+  };
+
+  auto const adjustEdgeWeight = [&](Vertex const & vertex, Edge const & edge) {
+    auto const distance = context.GetDistance(vertex);
+    reachTargets(vertex, edge, [&](size_t targetIdx, Weight const & weight) {
+      CHECK_LESS(targetIdx, targetsNumber, ());
+      CHECK_GREATER_OR_EQUAL(weight, -epsilon, ("Invariant violated."));
+
+      auto const targetDistance = distance + std::max(weight, kZeroDistance);
+      if (!lastEdges[targetIdx] && params.m_checkLengthCallback(targetDistance))
+        targetQueue.push({targetDistance, targetIdx, vertex, edge.GetTarget()});
+    });
+
+    return edge.GetWeight();
+  };
+
+  auto const filterStates = [&](State const & state) {
+    return params.m_checkLengthCallback(state.distance);
+  };
+
+  auto const reducedToRealLength = [&](State const & state) { return state.distance; };
+
+  PropagateWave(graph, startVertex, visitVertex, adjustEdgeWeight, filterStates,
+                reducedToRealLength, context);
+  if (wasCancelled)
+    return Result::Cancelled;
+
+  reachTargetsUpTo(kInfiniteDistance);
+  if (reachedNumber == 0)
+    return Result::NoPath;
+
+  for (size_t i = 0; i < targetsNumber; ++i)
+  {
+    if (!lastEdges[i])
+      continue;
+
+    context.ReconstructPath(lastEdges[i]->first, results[i].m_path);
+    results[i].m_path.push_back(lastEdges[i]->second);
+  }
 
-  auto const & it = remainingDistances.find(returnVertex);
-  CHECK(it != remainingDistances.end(), ());
-  result.m_distance = context.GetDistance(returnVertex) + it->second;
   return Result::OK;
 }
 
@@ -874,6 +1686,6 @@ void
 AStarAlgorithm<Vertex, Edge, Weight>::Context::ReconstructPath(Vertex const & v,
                                                                std::vector<Vertex> & path) const
 {
-  AStarAlgorithm<Vertex, Edge, Weight>::ReconstructPath(v, m_parents, path);
+  AStarAlgorithm<Vertex, Edge, Weight>::ReconstructPath(v, m_state->m_parents, path);
 }
 }  // namespace routing
@@ -13,6 +13,21 @@
 
 namespace routing
 {
+namespace astar
+{
+/// \brief Lower bound of the weight between two vertices. It may be set to AStarAlgorithm
+/// params to be used instead of AStarGraph::HeuristicCostEstimate().
+/// \note |to| is always the start or the final vertex of the search.
+template <typename VertexType, typename WeightType>
+class Heuristic
+{
+public:
+  virtual ~Heuristic() = default;
+
+  virtual WeightType HeuristicCostEstimate(VertexType const & from, VertexType const & to) = 0;
+};
+}  // namespace astar
+
 template <typename VertexType, typename EdgeType, typename WeightType>
 class AStarGraph
 {
@@ -0,0 +1,351 @@
+#pragma once
+
+#include "base/assert.hpp"
+#include "base/macros.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "3party/skarupke/bytell_hash_map.hpp"
+
+namespace routing
+{
+namespace astar
+{
+/// \brief Counters of search state storage. A search takes its state from a per-thread pool,
+/// so in steady state searches are done without allocations of distance maps and queues.
+struct SearchStateCounters
+{
+  // Number of search states which were created because the pool of the thread was empty.
+  uint64_t m_statesCreated = 0;
+  // Number of search states which were taken from the pool.
+  uint64_t m_statesReused = 0;
+  // Number of reallocations of distance maps and queues of search states.
+  uint64_t m_allocations = 0;
+  uint64_t m_allocatedBytes = 0;
+};
+
+namespace impl
+{
+struct AtomicSearchStateCounters
+{
+  std::atomic<uint64_t> m_statesCreated{0};
+  std::atomic<uint64_t> m_statesReused{0};
+  std::atomic<uint64_t> m_allocations{0};
+  std::atomic<uint64_t> m_allocatedBytes{0};
+};
+
+inline AtomicSearchStateCounters & GetCounters()
+{
+  static AtomicSearchStateCounters counters;
+  return counters;
+}
+
+inline void CountAllocation(size_t bytes)
+{
+  auto & counters = GetCounters();
+  counters.m_allocations.fetch_add(1, std::memory_order_relaxed);
+  counters.m_allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+/// \brief Search state pools of one thread. There's a pool for every type of search states,
+/// the pools share the memory budget of the thread.
+struct ThreadPools
+{
+  std::vector<std::function<void()>> m_clearers;
+  size_t m_pooledBytes = 0;
+};
+
+inline ThreadPools & GetThreadPools()
+{
+  thread_local ThreadPools pools;
+  return pools;
+}
+}  // namespace impl
+
+/// \brief Frees search states pooled by the current thread.
+inline void ClearSearchStatePools()
+{
+  auto & pools = impl::GetThreadPools();
+  for (auto const & clear : pools.m_clearers)
+    clear();
+  pools.m_pooledBytes = 0;
+}
+
+inline SearchStateCounters GetSearchStateCounters()
+{
+  auto const & counters = impl::GetCounters();
+  SearchStateCounters result;
+  result.m_statesCreated = counters.m_statesCreated.load(std::memory_order_relaxed);
+  result.m_statesReused = counters.m_statesReused.load(std::memory_order_relaxed);
+  result.m_allocations = counters.m_allocations.load(std::memory_order_relaxed);
+  result.m_allocatedBytes = counters.m_allocatedBytes.load(std::memory_order_relaxed);
+  return result;
+}
+
+inline void ResetSearchStateCounters()
+{
+  auto & counters = impl::GetCounters();
+  counters.m_statesCreated = 0;
+  counters.m_statesReused = 0;
+  counters.m_allocations = 0;
+  counters.m_allocatedBytes = 0;
+}
+
+inline std::string DebugPrint(SearchStateCounters const & counters)
+{
+  std::ostringstream out;
+  out << "SearchStateCounters [ created: " << counters.m_statesCreated
+      << ", reused: " << counters.m_statesReused << ", allocations: " << counters.m_allocations
+      << ", allocated bytes: " << counters.m_allocatedBytes << " ]";
+  return out.str();
+}
+
+/// \brief Open addressing hash map from vertices to values which is cleared in O(1).
+/// Every slot keeps the generation it was written in, Clear() starts a new generation
+/// and slots of the previous ones are treated as empty. The storage is kept between searches.
+template <typename Key, typename Value>
+class VertexMap final
+{
+public:
+  Value const * Find(Key const & key) const
+  {
+    if (m_slots.empty())
+      return nullptr;
+
+    for (size_t i = GetBucket(key);; i = (i + 1) & m_mask)
+    {
+      auto const & slot = m_slots[i];
+      if (slot.m_generation != m_generation)
+        return nullptr;
+      if (slot.m_key == key)
+        return &slot.m_value;
+    }
+  }
+
+  bool Contains(Key const & key) const { return Find(key) != nullptr; }
+
+  void InsertOrAssign(Key const & key, Value const & value)
+  {
+    if ((m_size + 1) * kMaxLoadFactorInv > m_slots.size())
+      Grow();
+
+    for (size_t i = GetBucket(key);; i = (i + 1) & m_mask)
+    {
+      auto & slot = m_slots[i];
+      if (slot.m_generation != m_generation)
+      {
+        slot.m_generation = m_generation;
+        slot.m_key = key;
+        slot.m_value = value;
+        ++m_size;
+        return;
+      }
+      if (slot.m_key == key)
+      {
+        slot.m_value = value;
+        return;
+      }
+    }
+  }
+
+  void Clear()
+  {
+    m_size = 0;
+    if (++m_generation != 0)
+      return;
+
+    // Generations are overflowed, it happens once in 2^32 searches.
+    for (auto & slot : m_slots)
+      slot.m_generation = 0;
+    m_generation = 1;
+  }
+
+  size_t Size() const { return m_size; }
+  bool Empty() const { return m_size == 0; }
+  size_t GetCapacity() const { return m_slots.size(); }
+  size_t GetMemorySize() const { return m_slots.capacity() * sizeof(Slot); }
+
+private:
+  static size_t constexpr kMaxLoadFactorInv = 2;
+  static size_t constexpr kMinCapacity = 1024;
+
+  struct Slot
+  {
+    uint32_t m_generation = 0;
+    Key m_key = {};
+    Value m_value = {};
+  };
+
+  size_t GetBucket(Key const & key) const
+  {
+    // Fibonacci hashing spreads sequential ids which std::hash leaves as they are.
+    uint64_t const hash = static_cast<uint64_t>(std::hash<Key>()(key)) * 11400714819323198485ULL;
+    return static_cast<size_t>(hash >> 32) & m_mask;
+  }
+
+  void Grow()
+  {
+    std::vector<Slot> slots(std::max(kMinCapacity, m_slots.size() * 2));
+    impl::CountAllocation(slots.size() * sizeof(Slot));
+    m_slots.swap(slots);
+    m_mask = m_slots.size() - 1;
+
+    uint32_t const prevGeneration = m_generation;
+    m_generation = 1;
+    m_size = 0;
+    for (auto const & slot : slots)
+    {
+      if (slot.m_generation == prevGeneration)
+        InsertOrAssign(slot.m_key, slot.m_value);
+    }
+  }
+
+  std::vector<Slot> m_slots;
+  size_t m_mask = 0;
+  size_t m_size = 0;
+  uint32_t m_generation = 1;
+};
+
+/// \brief Min-heap with the interface of std::priority_queue<T, std::vector<T>, std::greater<T>>
+/// which keeps its storage when it's cleared.
+template <typename T>
+class VertexQueue final
+{
+public:
+  bool empty() const { return m_heap.empty(); }
+  size_t size() const { return m_heap.size(); }
+  T const & top() const
+  {
+    ASSERT(!m_heap.empty(), ());
+    return m_heap.front();
+  }
+
+  void push(T const & value)
+  {
+    if (m_heap.size() == m_heap.capacity())
+      impl::CountAllocation(std::max<size_t>(m_heap.capacity(), 1) * 2 * sizeof(T));
+
+    m_heap.push_back(value);
+    std::push_heap(m_heap.begin(), m_heap.end(), std::greater<T>());
+  }
+
+  void pop()
+  {
+    std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<T>());
+    m_heap.pop_back();
+  }
+
+  void clear() { m_heap.clear(); }
+  size_t capacity() const { return m_heap.capacity(); }
+  size_t GetMemorySize() const { return m_heap.capacity() * sizeof(T); }
+
+private:
+  std::vector<T> m_heap;
+};
+
+/// \brief Distances, parents and queue of one wave of a search.
+/// \note Parents are kept in ska::bytell_hash_map because graphs read them by AStarGraph interface.
+/// Its clear() doesn't free memory but it's linear in the number of buckets.
+template <typename Vertex, typename Weight, typename State>
+class SearchState final
+{
+public:
+  using Parents = ska::bytell_hash_map<Vertex, Vertex>;
+
+  void Clear()
+  {
+    m_distances.Clear();
+    m_parents.clear();
+    m_queue.clear();
+  }
+
+  // Bytes of the storage of the state. Every bucket of |m_parents| has a byte of metadata.
+  size_t GetMemorySize() const
+  {
+    return m_distances.GetMemorySize() +
+           m_parents.bucket_count() * (sizeof(typename Parents::value_type) + 1) +
+           m_queue.GetMemorySize();
+  }
+
+  VertexMap<Vertex, Weight> m_distances;
+  Parents m_parents;
+  VertexQueue<State> m_queue;
+};
+
+/// \brief Takes a search state from the pool of the current thread and returns it to the pool
+/// when the search is finished. Searches nested into each other get different states.
+/// A lease may be used by another thread while the search is running but it should be
+/// destroyed by the thread which has created it.
+/// The pooled states are freed by ClearSearchStatePools().
+template <typename SearchStateT>
+class SearchStateLease final
+{
+public:
+  // States of all the pools of a thread take not more than this, so the memory of a huge
+  // search isn't held by the thread after the search.
+  static size_t constexpr kMaxPooledBytes = 64 * 1024 * 1024;
+
+  SearchStateLease()
+  {
+    auto & pool = GetPool();
+    auto & counters = impl::GetCounters();
+    if (pool.empty())
+    {
+      m_state = std::make_unique<SearchStateT>();
+      counters.m_statesCreated.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+      m_state = std::move(pool.back());
+      pool.pop_back();
+      auto & pooledBytes = impl::GetThreadPools().m_pooledBytes;
+      pooledBytes -= std::min(pooledBytes, m_state->GetMemorySize());
+      counters.m_statesReused.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  ~SearchStateLease()
+  {
+    auto & pooledBytes = impl::GetThreadPools().m_pooledBytes;
+    size_t const bytes = m_state->GetMemorySize();
+    if (pooledBytes + bytes > kMaxPooledBytes)
+      return;
+
+    m_state->Clear();
+    GetPool().push_back(std::move(m_state));
+    pooledBytes += bytes;
+  }
+
+  SearchStateLease(SearchStateLease const &) = delete;
+  SearchStateLease & operator=(SearchStateLease const &) = delete;
+
+  SearchStateT & operator*() const { return *m_state; }
+  SearchStateT * operator->() const { return m_state.get(); }
+
+private:
+  using Pool = std::vector<std::unique_ptr<SearchStateT>>;
+
+  static Pool & GetPool()
+  {
+    thread_local Pool pool;
+    thread_local bool const registered = [] {
+      impl::GetThreadPools().m_clearers.emplace_back([] { GetPool().clear(); });
+      return true;
+    }();
+    UNUSED_VALUE(registered);
+    return pool;
+  }
+
+  std::unique_ptr<SearchStateT> m_state;
+};
+}  // namespace astar
+}  // namespace routing
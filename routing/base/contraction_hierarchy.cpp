@@ -0,0 +1,471 @@
+#include "routing/base/contraction_hierarchy.hpp"
+
+#include "base/logging.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <tuple>
+
+#include "3party/skarupke/bytell_hash_map.hpp"
+
+namespace routing
+{
+using namespace std;
+
+namespace
+{
+using Vertex = ContractionHierarchy::Vertex;
+using Edge = ContractionHierarchy::Edge;
+
+template <typename Weight>
+using MinQueue = priority_queue<pair<Weight, Vertex>, vector<pair<Weight, Vertex>>, greater<>>;
+
+// Number of settled vertices between two checks of cancellation.
+uint32_t constexpr kCancellationPollPeriod = 256;
+// Witness search is stopped after settling so many vertices. It leads to some superfluous
+// shortcuts but keeps the preprocessing time reasonable.
+uint32_t constexpr kMaxWitnessSettledVertices = 500;
+
+struct Label
+{
+  double m_weight = 0.0;
+  Vertex m_parent = ContractionHierarchy::kInvalidVertex;
+  Vertex m_middle = ContractionHierarchy::kInvalidVertex;
+};
+
+// One direction of the bidirectional upward search.
+struct SearchState
+{
+  SearchState(vector<uint32_t> const & offsets, vector<Edge> const & edges,
+              vector<uint32_t> const & stallOffsets, vector<Edge> const & stallEdges)
+    : m_offsets(offsets), m_edges(edges), m_stallOffsets(stallOffsets), m_stallEdges(stallEdges)
+  {
+  }
+
+  void Init(vector<ContractionHierarchy::Ending> const & endings, double shift)
+  {
+    for (auto const & [v, weight] : endings)
+    {
+      double const w = weight - shift;
+      auto const it = m_labels.find(v);
+      if (it != m_labels.end() && it->second.m_weight <= w)
+        continue;
+
+      m_labels[v] = {w, ContractionHierarchy::kInvalidVertex, ContractionHierarchy::kInvalidVertex};
+      m_queue.emplace(w, v);
+    }
+  }
+
+  double TopWeight() const { return m_queue.top().first; }
+
+  // Returns true if |v| can't be on a shortest path because a higher vertex reaches it cheaper.
+  bool IsStalled(Vertex v, double weight) const
+  {
+    for (uint32_t i = m_stallOffsets[v]; i < m_stallOffsets[v + 1]; ++i)
+    {
+      auto const & edge = m_stallEdges[i];
+      auto const it = m_labels.find(edge.m_target);
+      if (it != m_labels.end() && it->second.m_weight + edge.m_weight < weight)
+        return true;
+    }
+    return false;
+  }
+
+  void Relax(Vertex v, double weight)
+  {
+    for (uint32_t i = m_offsets[v]; i < m_offsets[v + 1]; ++i)
+    {
+      auto const & edge = m_edges[i];
+      double const w = weight + edge.m_weight;
+      auto const it = m_labels.find(edge.m_target);
+      if (it != m_labels.end() && it->second.m_weight <= w)
+        continue;
+
+      m_labels[edge.m_target] = {w, v, edge.m_middle};
+      m_queue.emplace(w, edge.m_target);
+    }
+  }
+
+  vector<uint32_t> const & m_offsets;
+  vector<Edge> const & m_edges;
+  vector<uint32_t> const & m_stallOffsets;
+  vector<Edge> const & m_stallEdges;
+
+  ska::bytell_hash_map<Vertex, Label> m_labels;
+  MinQueue<double> m_queue;
+  bool m_finished = false;
+};
+
+double GetMinWeight(vector<ContractionHierarchy::Ending> const & endings)
+{
+  double result = 0.0;
+  for (auto const & ending : endings)
+    result = min(result, ending.second);
+  return result;
+}
+}  // namespace
+
+// ContractionHierarchy ----------------------------------------------------------------------------
+ContractionHierarchy::Result ContractionHierarchy::FindPath(
+    vector<Ending> const & sources, vector<Ending> const & targets,
+    base::Cancellable const & cancellable, RoutingResult<Vertex, double> & result) const
+{
+  result.Clear();
+
+  // Dijkstra requires non-negative initial weights, so the endings are shifted.
+  double const sourceShift = GetMinWeight(sources);
+  double const targetShift = GetMinWeight(targets);
+
+  SearchState forward(m_forwardOffsets, m_forwardEdges, m_backwardOffsets, m_backwardEdges);
+  SearchState backward(m_backwardOffsets, m_backwardEdges, m_forwardOffsets, m_forwardEdges);
+  forward.Init(sources, sourceShift);
+  backward.Init(targets, targetShift);
+
+  double bestWeight = numeric_limits<double>::max();
+  Vertex meetingVertex = kInvalidVertex;
+  uint32_t settled = 0;
+
+  while (!forward.m_finished || !backward.m_finished)
+  {
+    if (++settled % kCancellationPollPeriod == 0 && cancellable.IsCancelled())
+      return Result::Cancelled;
+
+    bool const isForward =
+        backward.m_finished ||
+        (!forward.m_finished &&
+         (backward.m_queue.empty() ||
+          (!forward.m_queue.empty() && forward.TopWeight() <= backward.TopWeight())));
+
+    SearchState & cur = isForward ? forward : backward;
+    SearchState const & other = isForward ? backward : forward;
+
+    if (cur.m_queue.empty() || cur.TopWeight() >= bestWeight)
+    {
+      cur.m_finished = true;
+      continue;
+    }
+
+    auto const [weight, v] = cur.m_queue.top();
+    cur.m_queue.pop();
+    if (weight > cur.m_labels[v].m_weight)
+      continue;
+
+    auto const it = other.m_labels.find(v);
+    if (it != other.m_labels.end() && weight + it->second.m_weight < bestWeight)
+    {
+      bestWeight = weight + it->second.m_weight;
+      meetingVertex = v;
+    }
+
+    if (cur.IsStalled(v, weight))
+      continue;
+
+    cur.Relax(v, weight);
+  }
+
+  if (meetingVertex == kInvalidVertex)
+    return Result::NoPath;
+
+  vector<tuple<Vertex, Vertex, Vertex>> forwardEdges;
+  for (Vertex v = meetingVertex; forward.m_labels[v].m_parent != kInvalidVertex;
+       v = forward.m_labels[v].m_parent)
+  {
+    auto const & label = forward.m_labels[v];
+    forwardEdges.emplace_back(label.m_parent, v, label.m_middle);
+  }
+
+  Vertex const source = forwardEdges.empty() ? meetingVertex : get<0>(forwardEdges.back());
+  result.m_path.push_back(source);
+  for (auto it = forwardEdges.crbegin(); it != forwardEdges.crend(); ++it)
+    UnpackEdge(get<0>(*it), get<1>(*it), get<2>(*it), result.m_path);
+
+  for (Vertex v = meetingVertex; backward.m_labels[v].m_parent != kInvalidVertex;
+       v = backward.m_labels[v].m_parent)
+  {
+    auto const & label = backward.m_labels[v];
+    UnpackEdge(v, label.m_parent, label.m_middle, result.m_path);
+  }
+
+  result.m_distance = bestWeight + sourceShift + targetShift;
+  return Result::OK;
+}
+
+string DebugPrint(ContractionHierarchy::Result result)
+{
+  switch (result)
+  {
+  case ContractionHierarchy::Result::OK: return "OK";
+  case ContractionHierarchy::Result::NoPath: return "NoPath";
+  case ContractionHierarchy::Result::Cancelled: return "Cancelled";
+  }
+
+  UNREACHABLE();
+  return string();
+}
+
+Edge const * ContractionHierarchy::FindEdge(vector<uint32_t> const & offsets,
+                                            vector<Edge> const & edges, Vertex v,
+                                            Vertex target) const
+{
+  for (uint32_t i = offsets[v]; i < offsets[v + 1]; ++i)
+  {
+    if (edges[i].m_target == target)
+      return &edges[i];
+  }
+  return nullptr;
+}
+
+void ContractionHierarchy::UnpackEdge(Vertex from, Vertex to, Vertex middle,
+                                      vector<Vertex> & path) const
+{
+  vector<tuple<Vertex, Vertex, Vertex>> stack = {{from, to, middle}};
+  while (!stack.empty())
+  {
+    auto const [f, t, m] = stack.back();
+    stack.pop_back();
+    if (m == kInvalidVertex)
+    {
+      path.push_back(t);
+      continue;
+    }
+
+    // |m| was contracted before |f| and |t|, so f -> m is a backward edge of |m|
+    // and m -> t is a forward edge of |m|.
+    Edge const * first = FindEdge(m_backwardOffsets, m_backwardEdges, m, f);
+    Edge const * second = FindEdge(m_forwardOffsets, m_forwardEdges, m, t);
+    CHECK(first && second, ("Broken shortcut", f, "->", t, "via", m));
+
+    stack.emplace_back(m, t, second->m_middle);
+    stack.emplace_back(f, m, first->m_middle);
+  }
+}
+
+// ContractionHierarchyBuilder ---------------------------------------------------------------------
+ContractionHierarchyBuilder::ContractionHierarchyBuilder(uint32_t numVertices)
+  : m_numVertices(numVertices)
+  , m_outgoing(numVertices)
+  , m_ingoing(numVertices)
+  , m_contracted(numVertices, false)
+  , m_contractedNeighbours(numVertices, 0)
+  , m_levels(numVertices, 0)
+  , m_witnessWeights(numVertices, numeric_limits<double>::max())
+{
+}
+
+void ContractionHierarchyBuilder::AddEdge(Vertex from, Vertex to, double weight)
+{
+  CHECK_LESS(from, m_numVertices, ());
+  CHECK_LESS(to, m_numVertices, ());
+  CHECK_GREATER_OR_EQUAL(weight, 0.0, ());
+  AddArc(from, to, weight, ContractionHierarchy::kInvalidVertex);
+}
+
+void ContractionHierarchyBuilder::AddArc(Vertex from, Vertex to, double weight, Vertex middle)
+{
+  if (from == to)
+    return;
+
+  auto & outgoing = m_outgoing[from];
+  auto const it = find_if(outgoing.begin(), outgoing.end(),
+                          [to](Arc const & arc) { return arc.m_target == to; });
+  if (it == outgoing.end())
+  {
+    outgoing.emplace_back(to, weight, middle);
+    m_ingoing[to].emplace_back(from, weight, middle);
+    return;
+  }
+
+  if (it->m_weight <= weight)
+    return;
+
+  it->m_weight = weight;
+  it->m_middle = middle;
+  for (auto & arc : m_ingoing[to])
+  {
+    if (arc.m_target == from)
+    {
+      arc.m_weight = weight;
+      arc.m_middle = middle;
+      break;
+    }
+  }
+}
+
+void ContractionHierarchyBuilder::RunWitnessSearch(Vertex source, Vertex ignored, double maxWeight)
+{
+  for (auto const v : m_witnessTouched)
+    m_witnessWeights[v] = numeric_limits<double>::max();
+  m_witnessTouched.clear();
+
+  MinQueue<double> queue;
+  m_witnessWeights[source] = 0.0;
+  m_witnessTouched.push_back(source);
+  queue.emplace(0.0, source);
+
+  uint32_t settled = 0;
+  while (!queue.empty() && settled < kMaxWitnessSettledVertices)
+  {
+    auto const [weight, v] = queue.top();
+    queue.pop();
+    if (weight > m_witnessWeights[v])
+      continue;
+    if (weight > maxWeight)
+      break;
+
+    ++settled;
+    for (auto const & arc : m_outgoing[v])
+    {
+      if (arc.m_target == ignored || m_contracted[arc.m_target])
+        continue;
+
+      double const w = weight + arc.m_weight;
+      if (w >= m_witnessWeights[arc.m_target])
+        continue;
+
+      if (m_witnessWeights[arc.m_target] == numeric_limits<double>::max())
+        m_witnessTouched.push_back(arc.m_target);
+      m_witnessWeights[arc.m_target] = w;
+      queue.emplace(w, arc.m_target);
+    }
+  }
+}
+
+uint32_t ContractionHierarchyBuilder::Contract(Vertex v, bool simulate)
+{
+  uint32_t shortcutsNumber = 0;
+  // Note. AddArc() doesn't change arcs of |v| so it's safe to iterate over them by index.
+  for (size_t i = 0; i < m_ingoing[v].size(); ++i)
+  {
+    Vertex const from = m_ingoing[v][i].m_target;
+    if (m_contracted[from])
+      continue;
+
+    double const inWeight = m_ingoing[v][i].m_weight;
+    double maxOutWeight = -1.0;
+    for (auto const & out : m_outgoing[v])
+    {
+      if (out.m_target != from && !m_contracted[out.m_target])
+        maxOutWeight = max(maxOutWeight, out.m_weight);
+    }
+    if (maxOutWeight < 0.0)
+      continue;
+
+    RunWitnessSearch(from, v, inWeight + maxOutWeight);
+    for (size_t j = 0; j < m_outgoing[v].size(); ++j)
+    {
+      auto const & out = m_outgoing[v][j];
+      if (out.m_target == from || m_contracted[out.m_target])
+        continue;
+
+      double const viaWeight = inWeight + out.m_weight;
+      if (m_witnessWeights[out.m_target] <= viaWeight)
+        continue;
+
+      ++shortcutsNumber;
+      if (!simulate)
+        AddArc(from, out.m_target, viaWeight, v);
+    }
+  }
+  return shortcutsNumber;
+}
+
+int64_t ContractionHierarchyBuilder::CalcPriority(Vertex v)
+{
+  int64_t removedArcs = 0;
+  for (auto const & arc : m_outgoing[v])
+    removedArcs += m_contracted[arc.m_target] ? 0 : 1;
+  for (auto const & arc : m_ingoing[v])
+    removedArcs += m_contracted[arc.m_target] ? 0 : 1;
+
+  int64_t const shortcuts = Contract(v, true /* simulate */);
+  return shortcuts - removedArcs + m_contractedNeighbours[v] + m_levels[v];
+}
+
+void ContractionHierarchyBuilder::Build(ContractionHierarchy & ch)
+{
+  vector<int64_t> priorities(m_numVertices);
+  MinQueue<int64_t> queue;
+  for (Vertex v = 0; v < m_numVertices; ++v)
+  {
+    priorities[v] = CalcPriority(v);
+    queue.emplace(priorities[v], v);
+  }
+
+  vector<uint32_t> ranks(m_numVertices, 0);
+  uint32_t rank = 0;
+  while (!queue.empty())
+  {
+    auto const [priority, v] = queue.top();
+    queue.pop();
+    if (m_contracted[v] || priority != priorities[v])
+      continue;
+
+    // Lazy update: the priority may be outdated because of the contraction of other vertices.
+    int64_t const actualPriority = CalcPriority(v);
+    if (actualPriority > priority && !queue.empty() && actualPriority > queue.top().first)
+    {
+      priorities[v] = actualPriority;
+      queue.emplace(actualPriority, v);
+      continue;
+    }
+
+    Contract(v, false /* simulate */);
+    m_contracted[v] = true;
+    ranks[v] = rank++;
+
+    auto const updateNeighbour = [&](Vertex u) {
+      if (m_contracted[u])
+        return;
+      ++m_contractedNeighbours[u];
+      m_levels[u] = max(m_levels[u], m_levels[v] + 1);
+      priorities[u] = CalcPriority(u);
+      queue.emplace(priorities[u], u);
+    };
+
+    for (size_t i = 0; i < m_outgoing[v].size(); ++i)
+      updateNeighbour(m_outgoing[v][i].m_target);
+    for (size_t i = 0; i < m_ingoing[v].size(); ++i)
+      updateNeighbour(m_ingoing[v][i].m_target);
+  }
+  CHECK_EQUAL(rank, m_numVertices, ());
+
+  ch.m_forwardOffsets.assign(m_numVertices + 1, 0);
+  ch.m_backwardOffsets.assign(m_numVertices + 1, 0);
+  for (Vertex u = 0; u < m_numVertices; ++u)
+  {
+    for (auto const & arc : m_outgoing[u])
+    {
+      if (ranks[u] < ranks[arc.m_target])
+        ++ch.m_forwardOffsets[u + 1];
+      else
+        ++ch.m_backwardOffsets[arc.m_target + 1];
+    }
+  }
+
+  for (Vertex v = 0; v < m_numVertices; ++v)
+  {
+    ch.m_forwardOffsets[v + 1] += ch.m_forwardOffsets[v];
+    ch.m_backwardOffsets[v + 1] += ch.m_backwardOffsets[v];
+  }
+
+  ch.m_forwardEdges.resize(ch.m_forwardOffsets.back());
+  ch.m_backwardEdges.resize(ch.m_backwardOffsets.back());
+  vector<uint32_t> forwardPos(ch.m_forwardOffsets.begin(), ch.m_forwardOffsets.end() - 1);
+  vector<uint32_t> backwardPos(ch.m_backwardOffsets.begin(), ch.m_backwardOffsets.end() - 1);
+  for (Vertex u = 0; u < m_numVertices; ++u)
+  {
+    for (auto const & arc : m_outgoing[u])
+    {
+      auto const weight = static_cast<float>(arc.m_weight);
+      if (ranks[u] < ranks[arc.m_target])
+        ch.m_forwardEdges[forwardPos[u]++] = Edge(arc.m_target, weight, arc.m_middle);
+      else
+        ch.m_backwardEdges[backwardPos[arc.m_target]++] = Edge(u, weight, arc.m_middle);
+    }
+  }
+
+  LOG(LINFO, ("Contraction hierarchy is built. Vertices:", m_numVertices,
+              "edges:", ch.GetNumEdges()));
+}
+}  // namespace routing
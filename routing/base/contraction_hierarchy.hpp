@@ -0,0 +1,201 @@
+#pragma once
+
+#include "routing/base/routing_result.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+#include "base/cancellable.hpp"
+#include "base/checked_cast.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace routing
+{
+/// \brief Contraction hierarchy over a static directed graph with non-negative scalar weights.
+/// Vertices are contracted one by one in the order of ascending importance (rank). Contraction
+/// of a vertex |v| adds a shortcut u -> w for every path u -> v -> w which is the only shortest
+/// path between u and w. A query is a bidirectional Dijkstra which relaxes only the edges
+/// leading to vertices of a higher rank, so it settles a tiny part of the graph.
+/// The hierarchy keeps only "upward" edges:
+/// * forward edges of |u| are edges u -> w where rank(w) > rank(u);
+/// * backward edges of |w| are edges u -> w where rank(u) > rank(w), |m_target| of such an edge
+///   is |u|.
+class ContractionHierarchy final
+{
+public:
+  friend class ContractionHierarchyBuilder;
+
+  using Vertex = uint32_t;
+  // Vertex with initial weight.
+  using Ending = std::pair<Vertex, double>;
+
+  static Vertex constexpr kInvalidVertex = std::numeric_limits<Vertex>::max();
+
+  enum class Result
+  {
+    OK,
+    NoPath,
+    Cancelled
+  };
+
+  struct Edge
+  {
+    Edge() = default;
+    Edge(Vertex target, float weight, Vertex middle)
+      : m_target(target), m_weight(weight), m_middle(middle)
+    {
+    }
+
+    bool IsShortcut() const { return m_middle != kInvalidVertex; }
+
+    Vertex m_target = kInvalidVertex;
+    float m_weight = 0.0F;
+    // Vertex which was contracted to produce the shortcut or |kInvalidVertex| for original edges.
+    Vertex m_middle = kInvalidVertex;
+  };
+
+  static_assert(sizeof(Edge) == 12, "Edge is written as is to mwm section.");
+
+  uint32_t GetNumVertices() const
+  {
+    return m_forwardOffsets.empty() ? 0 : base::asserted_cast<uint32_t>(m_forwardOffsets.size() - 1);
+  }
+
+  size_t GetNumEdges() const { return m_forwardEdges.size() + m_backwardEdges.size(); }
+
+  /// \brief Finds the shortest path from any vertex of |sources| to any vertex of |targets|.
+  /// Weights of the endings are added to the weight of the path. The weights of |targets| may
+  /// be negative, it's convenient when a vertex represents something longer than the target.
+  /// \note Vertices of |result.m_path| are the vertices of the original graph, all shortcuts
+  /// are unpacked.
+  Result FindPath(std::vector<Ending> const & sources, std::vector<Ending> const & targets,
+                  base::Cancellable const & cancellable,
+                  RoutingResult<Vertex, double> & result) const;
+
+  template <typename Sink>
+  void Serialize(Sink & sink) const
+  {
+    WriteToSink(sink, GetNumVertices());
+    WriteToSink(sink, base::checked_cast<uint32_t>(m_forwardEdges.size()));
+    WriteToSink(sink, base::checked_cast<uint32_t>(m_backwardEdges.size()));
+    SerializeDirection(sink, m_forwardOffsets, m_forwardEdges);
+    SerializeDirection(sink, m_backwardOffsets, m_backwardEdges);
+  }
+
+  template <typename Source>
+  void Deserialize(Source & src)
+  {
+    auto const numVertices = ReadPrimitiveFromSource<uint32_t>(src);
+    auto const numForwardEdges = ReadPrimitiveFromSource<uint32_t>(src);
+    auto const numBackwardEdges = ReadPrimitiveFromSource<uint32_t>(src);
+    DeserializeDirection(src, numVertices, numForwardEdges, m_forwardOffsets, m_forwardEdges);
+    DeserializeDirection(src, numVertices, numBackwardEdges, m_backwardOffsets, m_backwardEdges);
+  }
+
+private:
+  template <typename Sink>
+  static void SerializeDirection(Sink & sink, std::vector<uint32_t> const & offsets,
+                                 std::vector<Edge> const & edges)
+  {
+    for (auto const offset : offsets)
+      WriteToSink(sink, offset);
+
+    for (auto const & edge : edges)
+    {
+      uint32_t weight;
+      static_assert(sizeof(weight) == sizeof(edge.m_weight), "");
+      std::memcpy(&weight, &edge.m_weight, sizeof(weight));
+
+      WriteToSink(sink, edge.m_target);
+      WriteToSink(sink, weight);
+      WriteToSink(sink, edge.m_middle);
+    }
+  }
+
+  template <typename Source>
+  static void DeserializeDirection(Source & src, uint32_t numVertices, uint32_t numEdges,
+                                   std::vector<uint32_t> & offsets, std::vector<Edge> & edges)
+  {
+    offsets.resize(static_cast<size_t>(numVertices) + 1);
+    for (auto & offset : offsets)
+      offset = ReadPrimitiveFromSource<uint32_t>(src);
+    CHECK_EQUAL(offsets.back(), numEdges, ());
+
+    edges.resize(numEdges);
+    for (auto & edge : edges)
+    {
+      edge.m_target = ReadPrimitiveFromSource<Vertex>(src);
+      auto const weight = ReadPrimitiveFromSource<uint32_t>(src);
+      std::memcpy(&edge.m_weight, &weight, sizeof(weight));
+      edge.m_middle = ReadPrimitiveFromSource<Vertex>(src);
+    }
+  }
+
+  Edge const * FindEdge(std::vector<uint32_t> const & offsets, std::vector<Edge> const & edges,
+                        Vertex v, Vertex target) const;
+  // Appends to |path| vertices of unpacked edge |from| -> |to| except |from|.
+  void UnpackEdge(Vertex from, Vertex to, Vertex middle, std::vector<Vertex> & path) const;
+
+  std::vector<uint32_t> m_forwardOffsets;
+  std::vector<Edge> m_forwardEdges;
+  std::vector<uint32_t> m_backwardOffsets;
+  std::vector<Edge> m_backwardEdges;
+};
+
+std::string DebugPrint(ContractionHierarchy::Result result);
+
+/// \brief Builds ContractionHierarchy by a graph. Priority of a vertex for contraction is
+/// edge difference + number of contracted neighbours + level of the vertex in the hierarchy.
+class ContractionHierarchyBuilder final
+{
+public:
+  using Vertex = ContractionHierarchy::Vertex;
+
+  explicit ContractionHierarchyBuilder(uint32_t numVertices);
+
+  /// \brief Adds directed edge |from| -> |to|. Loops are ignored, for parallel edges
+  /// the lightest one is kept.
+  void AddEdge(Vertex from, Vertex to, double weight);
+
+  void Build(ContractionHierarchy & ch);
+
+private:
+  struct Arc
+  {
+    Arc(Vertex target, double weight, Vertex middle)
+      : m_target(target), m_weight(weight), m_middle(middle)
+    {
+    }
+
+    Vertex m_target;
+    double m_weight;
+    Vertex m_middle;
+  };
+
+  void AddArc(Vertex from, Vertex to, double weight, Vertex middle);
+  // Contracts |v| if |simulate| is false. Returns number of shortcuts which are (or would be)
+  // added for |v|.
+  uint32_t Contract(Vertex v, bool simulate);
+  int64_t CalcPriority(Vertex v);
+  // Bounded Dijkstra from |source| over not contracted vertices except |ignored|.
+  void RunWitnessSearch(Vertex source, Vertex ignored, double maxWeight);
+
+  uint32_t m_numVertices;
+  std::vector<std::vector<Arc>> m_outgoing;
+  std::vector<std::vector<Arc>> m_ingoing;
+  std::vector<bool> m_contracted;
+  std::vector<uint32_t> m_contractedNeighbours;
+  std::vector<uint32_t> m_levels;
+
+  // Witness search state. |m_witnessWeights| contains max double for not reached vertices.
+  std::vector<double> m_witnessWeights;
+  std::vector<Vertex> m_witnessTouched;
+};
+}  // namespace routing
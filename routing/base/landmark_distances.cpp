@@ -0,0 +1,183 @@
+#include "routing/base/landmark_distances.hpp"
+
+#include "base/logging.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+
+namespace routing
+{
+using namespace std;
+
+namespace
+{
+using Vertex = LandmarkDistances::Vertex;
+using Distance = LandmarkDistances::Distance;
+
+uint32_t constexpr kUnreachable = numeric_limits<uint32_t>::max();
+// Number of vertices which are tried as a seed of the landmark selection.
+uint32_t constexpr kSeedCandidatesNumber = 8;
+
+Distance ToDistance(uint32_t weight)
+{
+  if (weight >= LandmarkDistances::kUnknownDistance)
+    return LandmarkDistances::kUnknownDistance;
+  return static_cast<Distance>(weight);
+}
+}  // namespace
+
+double LandmarkDistances::GetLowerBound(Vertex from, Vertex to) const
+{
+  int32_t bound = 0;
+  size_t const fromIdx = GetIndex(0, from);
+  size_t const toIdx = GetIndex(0, to);
+  for (size_t i = 0; i < 2 * m_landmarks.size(); i += 2)
+  {
+    // d(from, to) >= d(L, to) - d(L, from).
+    Distance const fromLandmarkToFrom = m_distances[fromIdx + i];
+    Distance const fromLandmarkToTo = m_distances[toIdx + i];
+    if (fromLandmarkToFrom != kUnknownDistance && fromLandmarkToTo != kUnknownDistance)
+      bound = max(bound, int32_t{fromLandmarkToTo} - int32_t{fromLandmarkToFrom});
+
+    // d(from, to) >= d(from, L) - d(to, L).
+    Distance const fromFromToLandmark = m_distances[fromIdx + i + 1];
+    Distance const fromToToLandmark = m_distances[toIdx + i + 1];
+    if (fromFromToLandmark != kUnknownDistance && fromToToLandmark != kUnknownDistance)
+      bound = max(bound, int32_t{fromFromToLandmark} - int32_t{fromToToLandmark});
+  }
+  return static_cast<double>(bound);
+}
+
+LandmarkDistancesBuilder::LandmarkDistancesBuilder(uint32_t numVertices)
+  : m_numVertices(numVertices), m_outgoing(numVertices), m_ingoing(numVertices)
+{
+}
+
+void LandmarkDistancesBuilder::AddEdge(Vertex from, Vertex to, double weight)
+{
+  CHECK_LESS(from, m_numVertices, ());
+  CHECK_LESS(to, m_numVertices, ());
+  CHECK_GREATER_OR_EQUAL(weight, 0.0, ());
+  auto const rounded = static_cast<uint32_t>(min(floor(weight), static_cast<double>(kUnreachable - 1)));
+  m_outgoing[from].emplace_back(to, rounded);
+  m_ingoing[to].emplace_back(from, rounded);
+}
+
+void LandmarkDistancesBuilder::Build(uint32_t numLandmarks, LandmarkDistances & distances) const
+{
+  distances.m_numVertices = m_numVertices;
+  distances.m_landmarks.clear();
+  distances.m_distances.clear();
+  if (m_numVertices == 0 || numLandmarks == 0)
+    return;
+
+  // The first landmark is the farthest vertex from a seed. The next ones maximize the minimal
+  // round trip distance to the selected landmarks. Only vertices of the strongly connected
+  // component of the first landmark are considered, so small isolated parts of the graph
+  // don't take landmarks.
+  Vertex landmark = SelectSeed();
+  vector<uint32_t> fromLandmark;
+  CalcDistances(landmark, true /* forward */, fromLandmark);
+  for (Vertex v = 0; v < m_numVertices; ++v)
+  {
+    if (fromLandmark[v] != kUnreachable && fromLandmark[v] > fromLandmark[landmark])
+      landmark = v;
+  }
+
+  vector<vector<Distance>> landmarkDistances;
+  vector<uint32_t> toLandmark;
+  // Vertices which are not candidates have -1.
+  vector<int64_t> minRoundTrip(m_numVertices, numeric_limits<int64_t>::max());
+  while (true)
+  {
+    CalcDistances(landmark, true /* forward */, fromLandmark);
+    CalcDistances(landmark, false /* forward */, toLandmark);
+    distances.m_landmarks.push_back(landmark);
+
+    bool const isFirst = distances.m_landmarks.size() == 1;
+    auto & landmarkDistance = landmarkDistances.emplace_back(2 * m_numVertices);
+    for (Vertex v = 0; v < m_numVertices; ++v)
+    {
+      landmarkDistance[2 * v] = ToDistance(fromLandmark[v]);
+      landmarkDistance[2 * v + 1] = ToDistance(toLandmark[v]);
+
+      bool const connected = fromLandmark[v] != kUnreachable && toLandmark[v] != kUnreachable;
+      if (isFirst && !connected)
+        minRoundTrip[v] = -1;
+      else if (minRoundTrip[v] >= 0 && connected)
+        minRoundTrip[v] = min(minRoundTrip[v], int64_t{fromLandmark[v]} + int64_t{toLandmark[v]});
+    }
+
+    if (distances.m_landmarks.size() == numLandmarks)
+      break;
+
+    auto const it = max_element(minRoundTrip.cbegin(), minRoundTrip.cend());
+    if (*it <= 0)
+      break;
+    landmark = static_cast<Vertex>(distance(minRoundTrip.cbegin(), it));
+  }
+
+  size_t const numSelected = distances.m_landmarks.size();
+  distances.m_distances.resize(2 * static_cast<size_t>(m_numVertices) * numSelected);
+  for (size_t i = 0; i < numSelected; ++i)
+  {
+    for (Vertex v = 0; v < m_numVertices; ++v)
+    {
+      size_t const index = distances.GetIndex(static_cast<uint32_t>(i), v);
+      distances.m_distances[index] = landmarkDistances[i][2 * v];
+      distances.m_distances[index + 1] = landmarkDistances[i][2 * v + 1];
+    }
+  }
+
+  LOG(LINFO, ("Landmarks:", distances.m_landmarks));
+}
+
+void LandmarkDistancesBuilder::CalcDistances(Vertex source, bool forward,
+                                             vector<uint32_t> & distances) const
+{
+  auto const & edges = forward ? m_outgoing : m_ingoing;
+  distances.assign(m_numVertices, kUnreachable);
+  priority_queue<pair<uint64_t, Vertex>, vector<pair<uint64_t, Vertex>>, greater<>> queue;
+  distances[source] = 0;
+  queue.emplace(0, source);
+  while (!queue.empty())
+  {
+    auto const [weight, v] = queue.top();
+    queue.pop();
+    if (weight > distances[v])
+      continue;
+
+    for (auto const & [target, edgeWeight] : edges[v])
+    {
+      if (weight + edgeWeight < distances[target])
+      {
+        distances[target] = static_cast<uint32_t>(weight + edgeWeight);
+        queue.emplace(distances[target], target);
+      }
+    }
+  }
+}
+
+Vertex LandmarkDistancesBuilder::SelectSeed() const
+{
+  // The vertex which reaches the most vertices, it's likely in the main component of the graph.
+  Vertex seed = 0;
+  size_t maxReached = 0;
+  vector<uint32_t> distances;
+  uint32_t const step = max(m_numVertices / kSeedCandidatesNumber, uint32_t{1});
+  for (Vertex v = 0; v < m_numVertices; v += step)
+  {
+    CalcDistances(v, true /* forward */, distances);
+    auto const reached = static_cast<size_t>(
+        count_if(distances.cbegin(), distances.cend(), [](uint32_t d) { return d != kUnreachable; }));
+    if (reached > maxReached)
+    {
+      maxReached = reached;
+      seed = v;
+    }
+  }
+  return seed;
+}
+}  // namespace routing
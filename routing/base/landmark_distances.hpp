@@ -0,0 +1,127 @@
+#pragma once
+
+#include "coding/reader.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+#include "base/checked_cast.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace routing
+{
+/// \brief Distances between a few landmark vertices and all vertices of a static directed graph
+/// with non-negative weights. By the triangle inequality they give a lower bound of the distance
+/// between any two vertices (ALT: A*, landmarks, triangle inequality):
+/// d(u, v) >= d(L, v) - d(L, u) and d(u, v) >= d(u, L) - d(v, L) for every landmark L.
+/// The distances are calculated by edge weights rounded down to integers, so weights should be
+/// in units which are small enough to make the integer part precise, e.g. seconds. Rounded
+/// weights are not greater than the original ones and the distances are exact integers, so
+/// the bound is consistent, i.e. it may be used as an A* heuristic without reopening vertices.
+/// Distances which don't fit |Distance| and distances between unreachable vertices are unknown
+/// and give no bound.
+class LandmarkDistances final
+{
+public:
+  friend class LandmarkDistancesBuilder;
+
+  using Vertex = uint32_t;
+  using Distance = uint16_t;
+
+  static Distance constexpr kUnknownDistance = std::numeric_limits<Distance>::max();
+
+  uint32_t GetNumVertices() const { return m_numVertices; }
+  uint32_t GetNumLandmarks() const { return base::asserted_cast<uint32_t>(m_landmarks.size()); }
+  std::vector<Vertex> const & GetLandmarks() const { return m_landmarks; }
+
+  /// \returns d(|landmarkIdx|-th landmark, |v|) or |kUnknownDistance|.
+  Distance GetDistanceFromLandmark(uint32_t landmarkIdx, Vertex v) const
+  {
+    return m_distances[GetIndex(landmarkIdx, v)];
+  }
+
+  /// \returns d(|v|, |landmarkIdx|-th landmark) or |kUnknownDistance|.
+  Distance GetDistanceToLandmark(uint32_t landmarkIdx, Vertex v) const
+  {
+    return m_distances[GetIndex(landmarkIdx, v) + 1];
+  }
+
+  /// \returns lower bound of the distance from |from| to |to|. It's never greater than
+  /// the distance in the graph the landmarks were built by.
+  double GetLowerBound(Vertex from, Vertex to) const;
+
+  template <typename Sink>
+  void Serialize(Sink & sink) const
+  {
+    WriteToSink(sink, m_numVertices);
+    WriteToSink(sink, GetNumLandmarks());
+    for (auto const landmark : m_landmarks)
+      WriteToSink(sink, landmark);
+
+    for (auto const distance : m_distances)
+      WriteToSink(sink, distance);
+  }
+
+  template <typename Source>
+  void Deserialize(Source & src)
+  {
+    m_numVertices = ReadPrimitiveFromSource<uint32_t>(src);
+    m_landmarks.resize(ReadPrimitiveFromSource<uint32_t>(src));
+    for (auto & landmark : m_landmarks)
+    {
+      landmark = ReadPrimitiveFromSource<Vertex>(src);
+      CHECK_LESS(landmark, m_numVertices, ());
+    }
+
+    m_distances.resize(2 * static_cast<size_t>(m_numVertices) * m_landmarks.size());
+    for (auto & distance : m_distances)
+      distance = ReadPrimitiveFromSource<Distance>(src);
+  }
+
+private:
+  size_t GetIndex(uint32_t landmarkIdx, Vertex v) const
+  {
+    ASSERT_LESS(landmarkIdx, m_landmarks.size(), ());
+    ASSERT_LESS(v, m_numVertices, ());
+    return 2 * (static_cast<size_t>(v) * m_landmarks.size() + landmarkIdx);
+  }
+
+  uint32_t m_numVertices = 0;
+  std::vector<Vertex> m_landmarks;
+  // Distances of a vertex are stored together because a lower bound needs all of them:
+  // d(L_0, v), d(v, L_0), d(L_1, v), d(v, L_1), ...
+  std::vector<Distance> m_distances;
+};
+
+/// \brief Selects landmarks of a graph and calculates LandmarkDistances. Landmarks are selected
+/// one by one, every next landmark is the vertex which is the farthest from the selected ones,
+/// so the landmarks are spread over the periphery of the graph where they give the best bounds.
+class LandmarkDistancesBuilder final
+{
+public:
+  using Vertex = LandmarkDistances::Vertex;
+
+  explicit LandmarkDistancesBuilder(uint32_t numVertices);
+
+  /// \brief Adds directed edge |from| -> |to|. |weight| should be non-negative, it's rounded
+  /// down to an integer.
+  void AddEdge(Vertex from, Vertex to, double weight);
+
+  /// \brief Selects up to |numLandmarks| landmarks. Less landmarks are selected if the graph
+  /// is too small.
+  void Build(uint32_t numLandmarks, LandmarkDistances & distances) const;
+
+private:
+  // Dijkstra from |source| along the edges if |forward| is true and against them otherwise.
+  // Unreachable vertices get max uint32_t.
+  void CalcDistances(Vertex source, bool forward, std::vector<uint32_t> & distances) const;
+  Vertex SelectSeed() const;
+
+  uint32_t m_numVertices;
+  std::vector<std::vector<std::pair<Vertex, uint32_t>>> m_outgoing;
+  std::vector<std::vector<std::pair<Vertex, uint32_t>>> m_ingoing;
+};
+}  // namespace routing
@@ -1,5 +1,9 @@
 #include "routing/cross_mwm_connector.hpp"
 
+#include "routing/routing_exceptions.hpp"
+
+#include <algorithm>
+
 namespace routing
 {
 namespace connector
@@ -15,5 +19,64 @@ std::string DebugPrint(WeightsLoadState state)
   }
   UNREACHABLE();
 }
+
+// WeightsBlocks -----------------------------------------------------------------------------------
+WeightsBlocks::WeightsBlocks(Reader const & reader, uint32_t entersNumber, uint32_t exitsNumber,
+                             ReadBlockCallback const & readBlockCallback)
+  : m_reader(reader)
+  , m_entersNumber(entersNumber)
+  , m_exitsNumber(exitsNumber)
+  , m_readBlockCallback(readBlockCallback)
+  , m_cache(kMaxCachedBlocks)
+{
+  m_blockSide = ReadPrimitiveFromPos<uint32_t>(m_reader, 0);
+  if (m_blockSide == 0)
+    MYTHROW(CorruptedDataException, ("Wrong side of cross mwm weights blocks."));
+
+  m_blockCols = GetBlocksNumber(m_exitsNumber, m_blockSide);
+  uint64_t const blocksNumber = uint64_t{GetBlocksNumber(m_entersNumber, m_blockSide)} * m_blockCols;
+  m_blocksOffset = sizeof(uint32_t) * (blocksNumber + 2);
+  if (m_blocksOffset > m_reader.Size())
+    MYTHROW(CorruptedDataException, ("Wrong size of cross mwm weights:", m_reader.Size()));
+}
+
+Weight WeightsBlocks::Get(uint32_t enterIdx, uint32_t exitIdx) const
+{
+  ASSERT_LESS(enterIdx, m_entersNumber, ());
+  ASSERT_LESS(exitIdx, m_exitsNumber, ());
+
+  uint32_t const blockRow = enterIdx / m_blockSide;
+  uint32_t const blockCol = exitIdx / m_blockSide;
+
+  bool found = false;
+  auto & block = m_cache.Find(blockRow * m_blockCols + blockCol, found);
+  // A block which failed to be read stays empty in the cache.
+  if (!found || block.empty())
+    block = ReadBlock(blockRow, blockCol);
+
+  uint32_t const cols = std::min(m_blockSide, m_exitsNumber - blockCol * m_blockSide);
+  size_t const idx = size_t(enterIdx % m_blockSide) * cols + exitIdx % m_blockSide;
+  CHECK_LESS(idx, block.size(), (enterIdx, exitIdx));
+  return block[idx];
+}
+
+std::vector<Weight> WeightsBlocks::ReadBlock(uint32_t blockRow, uint32_t blockCol) const
+{
+  uint64_t const blockIdx = uint64_t{blockRow} * m_blockCols + blockCol;
+  uint64_t const offsetPos = sizeof(uint32_t) * (blockIdx + 1);
+  uint64_t const begin = m_blocksOffset + ReadPrimitiveFromPos<uint32_t>(m_reader, offsetPos);
+  uint64_t const end =
+      m_blocksOffset + ReadPrimitiveFromPos<uint32_t>(m_reader, offsetPos + sizeof(uint32_t));
+  if (begin > end || end > m_reader.Size())
+    MYTHROW(CorruptedDataException, ("Wrong offsets of cross mwm weights block", blockIdx));
+
+  uint32_t const rows = std::min(m_blockSide, m_entersNumber - blockRow * m_blockSide);
+  uint32_t const cols = std::min(m_blockSide, m_exitsNumber - blockCol * m_blockSide);
+
+  NonOwningReaderSource src(m_reader, begin, end);
+  std::vector<Weight> weights;
+  m_readBlockCallback(src, rows * cols, weights);
+  return weights;
+}
 }  // namespace connector
 }  // namespace routing
@@ -13,7 +13,10 @@
 
 #include "base/assert.hpp"
 #include "base/buffer_vector.hpp"
+#include "base/lru_cache.hpp"
 
+#include <functional>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -38,6 +41,49 @@ enum class WeightsLoadState
 };
 
 std::string DebugPrint(WeightsLoadState state);
+
+/// \brief Weights matrix of enters x exits which is split into square blocks. Blocks are encoded
+/// independently and are read on demand, so getting the weights of an enter or of an exit decodes
+/// a row or a column of blocks only. Decoded blocks are kept in LRU cache.
+/// Format:
+/// uint32_t blockSide
+/// uint32_t offsets[blocksNumber + 1] - offsets of the blocks from the end of the table
+/// blocks - row-major by blocks and by weights of a block
+class WeightsBlocks final
+{
+public:
+  /// Decodes |weightsNumber| weights of a block, kNoRouteStored is for no route.
+  using ReadBlockCallback =
+      std::function<void(NonOwningReaderSource &, uint32_t weightsNumber, std::vector<Weight> &)>;
+
+  static size_t constexpr kMaxCachedBlocks = 1024;
+
+  /// \note |reader| must be alive until the destruction of WeightsBlocks.
+  WeightsBlocks(Reader const & reader, uint32_t entersNumber, uint32_t exitsNumber,
+                ReadBlockCallback const & readBlockCallback);
+
+  Weight Get(uint32_t enterIdx, uint32_t exitIdx) const;
+
+  uint32_t GetBlockSide() const { return m_blockSide; }
+
+  static uint32_t GetBlocksNumber(uint32_t count, uint32_t blockSide)
+  {
+    return (count + blockSide - 1) / blockSide;
+  }
+
+private:
+  std::vector<Weight> ReadBlock(uint32_t blockRow, uint32_t blockCol) const;
+
+  Reader const & m_reader;
+  uint32_t m_entersNumber;
+  uint32_t m_exitsNumber;
+  uint32_t m_blockSide = 0;
+  uint32_t m_blockCols = 0;
+  uint64_t m_blocksOffset = 0;
+  ReadBlockCallback m_readBlockCallback;
+
+  mutable LruCache<uint32_t, std::vector<Weight>> m_cache;
+};
 }  // namespace connector
 
 /// @param CrossMwmId Encoded OSM feature (way) ID that should be equal and unique in all MWMs.
@@ -188,6 +234,9 @@ public:
   using WeightT = connector::Weight;
   WeightT GetWeight(uint32_t enterIdx, uint32_t exitIdx) const
   {
+    if (m_weights.m_version >= 3)
+      return m_weights.m_v3->Get(enterIdx, exitIdx);
+
     WeightT weight;
     return (m_weights.Get(GetWeightIndex(enterIdx, exitIdx), weight) ? weight : connector::kNoRouteStored);
   }
@@ -299,19 +348,22 @@ private:
     connector::WeightsLoadState m_loadState = connector::WeightsLoadState::Unknown;
     uint64_t m_offset = 0;
     WeightT m_granularity = 0;
-    uint16_t m_version;
+    uint16_t m_version = 0;
 
     coding::SparseVector<WeightT> m_v1;
 
     std::unique_ptr<MapUint32ToValue<WeightT>> m_v2;
+    std::unique_ptr<connector::WeightsBlocks> m_v3;
     std::unique_ptr<Reader> m_reader;
 
     bool Empty() const
     {
       if (m_version < 2)
         return m_v1.Empty();
-      else
+      else if (m_version == 2)
         return m_v2 == nullptr;
+      else
+        return m_v3 == nullptr;
     }
 
     bool Get(uint32_t idx, WeightT & weight) const
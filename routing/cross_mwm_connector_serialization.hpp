@@ -12,9 +12,11 @@
 #include "coding/bit_streams.hpp"
 #include "coding/geometry_coding.hpp"
 #include "coding/reader.hpp"
+#include "coding/varint.hpp"
 #include "coding/write_to_sink.hpp"
 #include "coding/writer.hpp"
 
+#include "base/bits.hpp"
 #include "base/checked_cast.hpp"
 #include "base/geo_object_id.hpp"
 #include "base/macros.hpp"
@@ -315,7 +317,7 @@ public:
 
       m_c.m_weights.m_v1 = builder.Build();
     }
-    else
+    else if (m_c.m_weights.m_version == 2)
     {
       m_c.m_weights.m_reader = reader.CreateSubReader(m_c.m_weights.m_offset, reader.Size() - m_c.m_weights.m_offset);
       m_c.m_weights.m_v2 = MapUint32ToValue<Weight>::Load(*(m_c.m_weights.m_reader),
@@ -334,6 +336,33 @@ public:
           }
         });
     }
+    else
+    {
+      // Only the side of blocks is read here, blocks are read on demand.
+      m_c.m_weights.m_reader = reader.CreateSubReader(m_c.m_weights.m_offset, reader.Size() - m_c.m_weights.m_offset);
+      m_c.m_weights.m_v3 = std::make_unique<connector::WeightsBlocks>(
+        *(m_c.m_weights.m_reader), m_c.GetNumEnters(), m_c.GetNumExits(),
+        [granularity = m_c.m_weights.m_granularity](NonOwningReaderSource & source, uint32_t weightsNumber,
+                                                    std::vector<Weight> & values)
+        {
+          values.resize(weightsNumber);
+
+          // See CrossMwmConnectorBuilderEx::WriteWeights() for the encoding.
+          Weight prev = 0;
+          for (auto & value : values)
+          {
+            auto const code = ReadVarUint<uint32_t>(source);
+            if (code == 0)
+            {
+              value = connector::kNoRouteStored;
+              continue;
+            }
+
+            prev += bits::ZigZagDecode(code - 1);
+            value = granularity * prev;
+          }
+        });
+    }
 
     m_c.m_weights.m_loadState = connector::WeightsLoadState::Loaded;
   }
@@ -356,7 +385,8 @@ protected:
   // 0 - initial version
   // 1 - removed dummy GeometryCodingParams
   // 2 - store weights as MapUint32ToValue
-  static uint32_t constexpr kLastVersion = 2;
+  // 3 - store weights as connector::WeightsBlocks
+  static uint32_t constexpr kLastVersion = 3;
   static uint8_t constexpr kNoRouteBit = 0;
   static uint8_t constexpr kRouteBit = 1;
 
@@ -508,34 +538,75 @@ private:
       transition.Serialize(bitsPerOsmId, bitsPerMask, memWriter);
   }
 
-  static uint16_t constexpr kBlockSize = 256;
+  // Blocks of 16 x 16 weights: an enter or an exit gets the weights of 16 neighbouring ones
+  // with the same reading.
+  static uint32_t constexpr kBlockSide = 16;
 
   using Weight = typename BaseT::Weight;
   using IdxWeightT = std::pair<uint32_t, Weight>;
 
+  /// \brief Writes |m_weights| as connector::WeightsBlocks. Weights of a block are row-major,
+  /// a weight is varuint: 0 for no route and zigzag delta of the stored weight + 1 otherwise.
   void WriteWeights(std::vector<uint8_t> & buffer) const
   {
-    MapUint32ToValueBuilder<Weight> builder;
-    for (auto const & w : m_weights)
-      builder.Put(w.first, w.second);
+    uint32_t const numEnters = m_connector.GetNumEnters();
+    uint32_t const numExits = m_connector.GetNumExits();
+    uint32_t const blockRows = connector::WeightsBlocks::GetBlocksNumber(numEnters, kBlockSide);
+    uint32_t const blockCols = connector::WeightsBlocks::GetBlocksNumber(numExits, kBlockSide);
 
-    MemWriter writer(buffer);
-    builder.Freeze(writer, [](auto & writer, auto beg, auto end)
+    std::vector<uint32_t> offsets;
+    std::vector<uint8_t> blocks;
     {
-      auto const NextStoredValue = [&beg]()
+      MemWriter<std::vector<uint8_t>> writer(blocks);
+      for (uint32_t blockRow = 0; blockRow < blockRows; ++blockRow)
       {
-        return (*beg++ + BaseT::kGranularity - 1) / BaseT::kGranularity;
-      };
+        uint32_t const enterBegin = blockRow * kBlockSide;
+        uint32_t const enterEnd = std::min(numEnters, enterBegin + kBlockSide);
 
-      Weight prev = NextStoredValue();
-      WriteVarUint(writer, prev);
-      while (beg != end)
-      {
-        Weight const storedWeight = NextStoredValue();
-        WriteVarInt(writer, static_cast<int32_t>(storedWeight) - static_cast<int32_t>(prev));
-        prev = storedWeight;
+        // |m_weights| are sorted by enters, so every enter has a range of weights.
+        std::vector<typename std::vector<IdxWeightT>::const_iterator> rows;
+        for (uint32_t enter = enterBegin; enter < enterEnd; ++enter)
+        {
+          rows.push_back(std::lower_bound(m_weights.cbegin(), m_weights.cend(),
+                                          IdxWeightT(m_connector.GetWeightIndex(enter, 0), 0),
+                                          base::LessBy(&IdxWeightT::first)));
+        }
+
+        for (uint32_t blockCol = 0; blockCol < blockCols; ++blockCol)
+        {
+          offsets.push_back(base::checked_cast<uint32_t>(blocks.size()));
+
+          uint32_t const exitBegin = blockCol * kBlockSide;
+          uint32_t const exitEnd = std::min(numExits, exitBegin + kBlockSide);
+          Weight prev = 0;
+          for (uint32_t enter = enterBegin; enter < enterEnd; ++enter)
+          {
+            auto & row = rows[enter - enterBegin];
+            for (uint32_t exit = exitBegin; exit < exitEnd; ++exit)
+            {
+              if (row == m_weights.cend() || row->first != m_connector.GetWeightIndex(enter, exit))
+              {
+                WriteVarUint(writer, uint32_t{0});
+                continue;
+              }
+
+              Weight const stored = (row->second + BaseT::kGranularity - 1) / BaseT::kGranularity;
+              WriteVarUint(writer, bits::ZigZagEncode(static_cast<int32_t>(stored) -
+                                                      static_cast<int32_t>(prev)) + 1);
+              prev = stored;
+              ++row;
+            }
+          }
+        }
       }
-    }, kBlockSize);
+      offsets.push_back(base::checked_cast<uint32_t>(blocks.size()));
+    }
+
+    MemWriter<std::vector<uint8_t>> writer(buffer);
+    WriteToSink(writer, kBlockSide);
+    for (uint32_t const offset : offsets)
+      WriteToSink(writer, offset);
+    writer.Write(blocks.data(), blocks.size());
   }
 
 public:
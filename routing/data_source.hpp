@@ -6,7 +6,9 @@
 #include "indexer/data_source.hpp"
 
 #include <map>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace routing
 {
@@ -55,6 +57,10 @@ public:
 
   bool IsLoaded(platform::CountryFile const & file) const { return m_dataSource.IsLoaded(file); }
 
+  /// @return The underlying data source. It's used to make MwmDataSource of other threads,
+  /// since mwm handles are not shared between threads.
+  DataSource & GetDataSource() const { return m_dataSource; }
+
   enum SectionStatus
   {
     MwmNotLoaded,
@@ -102,6 +108,13 @@ public:
     m_dataSource.ForEachInRect(fn, rect, scales::GetUpperScale());
   }
 
+  template <class FnT> void ForEachStreet(FnT && fn, m2::RectD const & rect, MwmSet::MwmId const & mwmId)
+  {
+    m_dataSource.ForEachInRectForMWM(fn, rect, scales::GetUpperScale(), mwmId);
+  }
+
+  void GetMwmsInfo(std::vector<std::shared_ptr<MwmInfo>> & infos) const { m_dataSource.GetMwmsInfo(infos); }
+
   MwmSet::MwmHandle const & GetHandle(MwmSet::MwmId const & mwmId)
   {
     if (m_numMwmIDs)
@@ -17,6 +17,8 @@
 #include "geometry/mercator.hpp"
 #include "geometry/point2d.hpp"
 
+#include "base/checked_cast.hpp"
+
 #include <cstdlib>
 #include <utility>
 
@@ -281,6 +283,46 @@ bool DirectionsEngine::Generate(IndexRoadGraph const & graph,
   return true;
 }
 
+bool DirectionsEngine::Generate(IndexRoadGraph const & graph, IndexRoadGraph const & prefixGraph,
+                                vector<geometry::PointWithAltitude> const & path,
+                                size_t directionsSize, base::Cancellable const & cancellable,
+                                vector<RouteSegment> & routeSegments)
+{
+  CHECK_NOT_EQUAL(m_vehicleType, VehicleType::Transit, ());
+
+  size_t const prefixSize = prefixGraph.GetRouteSegments().size();
+  CHECK_LESS_OR_EQUAL(directionsSize, prefixSize, ());
+  CHECK_LESS(prefixSize, path.size(), ());
+
+  vector<geometry::PointWithAltitude> const prefixPath(path.begin(), path.begin() + prefixSize + 1);
+  if (!Generate(prefixGraph, prefixPath, cancellable, routeSegments))
+    return false;
+
+  IndexRoadGraph::EdgeVector routeEdges;
+  graph.GetRouteEdges(routeEdges);
+  CHECK_EQUAL(routeEdges.size() + 1, path.size(), ());
+
+  // Turns of the prefix segments after |directionsSize| are not reliable: the prefix finishes there.
+  routeSegments.resize(directionsSize);
+  routeSegments.reserve(routeEdges.size());
+  for (size_t i = directionsSize; i < routeEdges.size(); ++i)
+  {
+    TurnItem turn;
+    if (i + 1 == routeEdges.size())
+    {
+      auto const index = base::asserted_cast<uint32_t>(routeEdges.size());
+      if (m_vehicleType == VehicleType::Pedestrian)
+        turn = TurnItem(index, turns::PedestrianDirection::ReachedYourDestination);
+      else
+        turn = TurnItem(index, turns::CarDirection::ReachedYourDestination);
+    }
+    routeSegments.emplace_back(ConvertEdgeToSegment(*m_numMwmIds, routeEdges[i]), turn, path[i + 1],
+                               RouteSegment::RoadNameInfo());
+  }
+
+  return true;
+}
+
 /*!
  * \brief Compute turn and time estimation structs for the abstract route result.
  * \param result abstract routing result to annotate.
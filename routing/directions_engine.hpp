@@ -47,6 +47,13 @@ public:
                 std::vector<geometry::PointWithAltitude> const & path,
                 base::Cancellable const & cancellable,
                 std::vector<RouteSegment> & routeSegments);
+  /// \brief Generates route segments of the whole |path| of |graph| but turns and street names
+  /// only for the first |directionsSize| segments. They are taken from directions of |prefixGraph|,
+  /// a graph of a longer prefix of the route, so the route after the |directionsSize| segments is
+  /// taken into account. The other segments get no turns except for the finish one.
+  bool Generate(IndexRoadGraph const & graph, IndexRoadGraph const & prefixGraph,
+                std::vector<geometry::PointWithAltitude> const & path, size_t directionsSize,
+                base::Cancellable const & cancellable, std::vector<RouteSegment> & routeSegments);
   void Clear();
 
   void SetVehicleType(VehicleType const & vehicleType) { m_vehicleType = vehicleType; }
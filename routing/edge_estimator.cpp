@@ -4,6 +4,7 @@
 #include "routing/latlon_with_altitude.hpp"
 #include "routing/routing_exceptions.hpp"
 #include "routing/routing_helpers.hpp"
+#include "routing/speed_profiles.hpp"
 #include "routing/traffic_stash.hpp"
 
 #include "traffic/speed_groups.hpp"
@@ -132,6 +133,14 @@ EdgeEstimator::EdgeEstimator(double maxWeightSpeedKMpH, SpeedKMpH const & offroa
     CHECK_GREATER_OR_EQUAL(m_maxWeightSpeedMpS, KMPH2MPS(m_offroadSpeedKMpH.m_eta), ());
 }
 
+void EdgeEstimator::SetDepartureTime(optional<time_t> departureTime)
+{
+  if (departureTime)
+    m_departureSecondOfWeek = SpeedProfile::GetSecondOfWeek(*departureTime);
+  else
+    m_departureSecondOfWeek.reset();
+}
+
 double EdgeEstimator::CalcHeuristic(ms::LatLon const & from, ms::LatLon const & to) const
 {
   return TimeBetweenSec(from, to, m_maxWeightSpeedMpS);
@@ -276,6 +285,8 @@ public:
 
   // EdgeEstimator overrides:
   double CalcSegmentWeight(Segment const & segment, RoadGeometry const & road, Purpose purpose) const override;
+  double CalcTimeFactor(Segment const & segment, RoadGeometry const & road, Purpose purpose,
+                        double secondsFromDeparture) const override;
   double GetUTurnPenalty(Purpose /* purpose */) const override;
   double GetFerryLandingPenalty(Purpose purpose) const override;
 
@@ -333,6 +344,27 @@ double CarEstimator::CalcSegmentWeight(Segment const & segment, RoadGeometry con
   return result;
 }
 
+double CarEstimator::CalcTimeFactor(Segment const & segment, RoadGeometry const & road,
+                                    Purpose purpose, double secondsFromDeparture) const
+{
+  if (!m_departureSecondOfWeek)
+    return 1.0;
+
+  auto const profile = road.GetSpeedProfile(segment.IsForward());
+  if (!profile.IsValid())
+    return 1.0;
+
+  // Live traffic is applied by CalcSegmentWeight() and it's more accurate than the history.
+  if (m_trafficStash && m_trafficStash->GetSpeedGroup(segment) != SpeedGroup::Unknown)
+    return 1.0;
+
+  double const factor =
+      1.0 / profile.GetSpeedRatio(*m_departureSecondOfWeek + std::max(secondsFromDeparture, 0.0));
+  // Weights are not less than the weights of the vehicle model, so the heuristics, landmarks
+  // and precalculated weights stay lower bounds.
+  return purpose == Purpose::Weight ? std::max(factor, 1.0) : factor;
+}
+
 // EdgeEstimator -----------------------------------------------------------------------------------
 // static
 shared_ptr<EdgeEstimator> EdgeEstimator::Create(VehicleType vehicleType, double maxWeighSpeedKMpH,
@@ -10,7 +10,9 @@
 #include "geometry/point2d.hpp"
 #include "geometry/point_with_altitude.hpp"
 
+#include <ctime>
 #include <memory>
+#include <optional>
 
 class DataSource;
 
@@ -43,11 +45,23 @@ public:
 
   double GetMaxWeightSpeedMpS() const;
 
+  /// \brief Enables time-dependent weights of roads with speed profiles for routes which depart
+  /// at |departureTime|. std::nullopt disables them.
+  void SetDepartureTime(std::optional<time_t> departureTime);
+
   // Estimates time in seconds it takes to go from point |from| to point |to| along direct fake edge.
   double CalcOffroad(ms::LatLon const & from, ms::LatLon const & to, Purpose purpose) const;
 
   virtual double CalcSegmentWeight(Segment const & segment, RoadGeometry const & road,
                                    Purpose purpose) const = 0;
+  /// \returns factor of CalcSegmentWeight() of |segment| which is entered
+  /// |secondsFromDeparture| seconds after the departure time. It's 1.0 if time-dependent
+  /// weights are disabled or the road has no speed profile.
+  virtual double CalcTimeFactor(Segment const & /* segment */, RoadGeometry const & /* road */,
+                                Purpose /* purpose */, double /* secondsFromDeparture */) const
+  {
+    return 1.0;
+  }
   virtual double GetUTurnPenalty(Purpose purpose) const = 0;
   virtual double GetFerryLandingPenalty(Purpose purpose) const = 0;
 
@@ -63,6 +77,10 @@ public:
                                                DataSource * dataSourcePtr,
                                                std::shared_ptr<NumMwmIds> numMwmIds);
 
+protected:
+  // Seconds since the beginning of the week of the departure time, see SpeedProfile.
+  std::optional<uint32_t> m_departureSecondOfWeek;
+
 private:
   double const m_maxWeightSpeedMpS;
   SpeedKMpH const m_offroadSpeedKMpH;
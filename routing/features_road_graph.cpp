@@ -17,8 +17,13 @@
 
 #include "base/logging.hpp"
 #include "base/macros.hpp"
+#include "base/stl_helpers.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <future>
 #include <limits>
+#include <numeric>
 
 namespace routing
 {
@@ -108,8 +113,9 @@ void FeaturesRoadGraph::RoadInfoCache::Clear()
 }
 
 FeaturesRoadGraphBase::FeaturesRoadGraphBase(MwmDataSource & dataSource, IRoadGraph::Mode mode,
-                                             shared_ptr<VehicleModelFactoryInterface> vehicleModelFactory)
-  : m_dataSource(dataSource), m_mode(mode), m_vehicleModel(vehicleModelFactory)
+                                             shared_ptr<VehicleModelFactoryInterface> vehicleModelFactory,
+                                             optional<VehicleType> vehicleType)
+  : m_dataSource(dataSource), m_mode(mode), m_vehicleType(vehicleType), m_vehicleModel(vehicleModelFactory)
 {
 }
 
@@ -165,28 +171,204 @@ void FeaturesRoadGraphBase::FindClosestEdges(m2::RectD const & rect, uint32_t co
   finder.MakeResult(vicinities, count);
 }
 
-vector<IRoadGraph::FullRoadInfo>
-FeaturesRoadGraphBase::FindRoads(m2::RectD const & rect, IsGoodFeatureFn const & isGoodFeature) const
+void FeaturesRoadGraphBase::FindClosestEdges(vector<m2::PointD> const & points, double radiusM,
+                                             uint32_t count, size_t threadsNumber,
+                                             vector<vector<pair<Edge, geometry::PointWithAltitude>>> & vicinities) const
 {
-  vector<IRoadGraph::FullRoadInfo> roads;
+  // Size of a tile to group close points in mercator.
+  double constexpr kTileSize = 0.01;
+
+  vicinities.clear();
+  vicinities.resize(points.size());
+  if (points.empty())
+    return;
+
+  vector<shared_ptr<MwmInfo>> infos;
+  m_dataSource.GetMwmsInfo(infos);
+  base::EraseIf(infos, [](shared_ptr<MwmInfo> const & info)
+  {
+    return !info->IsRegistered() || info->GetType() != MwmInfo::COUNTRY;
+  });
+
+  // Indexes are got in the calling thread since features are read through |m_dataSource|.
+  vector<vector<pair<MwmSet::MwmId, shared_ptr<RoadSegmentsIndex const>>>> pointIndexes(points.size());
+  vector<pair<uint64_t, size_t>> order;
+  order.reserve(points.size());
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    m2::RectD const rect = mercator::RectByCenterXYAndSizeInMeters(points[i], radiusM);
+    for (auto const & info : infos)
+    {
+      if (!info->m_bordersRect.IsIntersect(rect))
+        continue;
+
+      MwmSet::MwmId const mwmId(info);
+      auto index = GetSegmentsIndex(mwmId);
+      if (index)
+        pointIndexes[i].emplace_back(mwmId, move(index));
+    }
+
+    // Tiles may be negative, the key is built of their two's complement bits.
+    auto const tileX = static_cast<uint64_t>(static_cast<int64_t>(std::floor(points[i].x / kTileSize)));
+    auto const tileY = static_cast<uint64_t>(static_cast<int64_t>(std::floor(points[i].y / kTileSize)));
+    order.emplace_back((tileX << 32) ^ (tileY & 0xFFFFFFFF), i);
+  }
+
+  // Points of a tile are snapped one after another by the same thread to share the cells.
+  sort(order.begin(), order.end());
+
+  auto const snap = [&](size_t begin, size_t end)
+  {
+    for (size_t j = begin; j < end; ++j)
+    {
+      size_t const i = order[j].second;
+      m2::RectD const rect = mercator::RectByCenterXYAndSizeInMeters(points[i], radiusM);
+      NearestEdgeFinder finder(points[i], nullptr /* isEdgeProjGood */);
+      for (auto const & [mwmId, index] : pointIndexes[i])
+        index->FindClosestEdges(mwmId, rect, finder);
+      finder.MakeResult(vicinities[i], count);
+    }
+  };
+
+  threadsNumber = std::max(threadsNumber, size_t(1));
+  if (threadsNumber == 1)
+  {
+    snap(0, order.size());
+    return;
+  }
+
+  size_t const chunkSize = (order.size() + threadsNumber - 1) / threadsNumber;
+  auto & pool = GetSnappingPool(threadsNumber);
+  vector<future<void>> results;
+  for (size_t begin = 0; begin < order.size(); begin += chunkSize)
+    results.push_back(pool.Submit(snap, begin, std::min(begin + chunkSize, order.size())));
+
+  for (auto & result : results)
+    result.get();
+}
+
+shared_ptr<RoadSegmentsIndex const> FeaturesRoadGraphBase::FindSegmentsIndex(MwmSet::MwmId const & mwmId) const
+{
+  {
+    lock_guard guard(m_segmentsIndexesMutex);
+    auto const it = m_segmentsIndexes.find(mwmId);
+    if (it != m_segmentsIndexes.end())
+      return it->second;
+  }
+
+  if (!m_vehicleType || !mwmId.GetInfo())
+    return nullptr;
+
+  auto const & handle = m_dataSource.GetHandle(mwmId);
+  if (!handle.IsAlive())
+    return nullptr;
+
+  shared_ptr<RoadSegmentsIndex const> index = RoadSegmentsIndex::Load(*handle.GetValue(), *m_vehicleType);
+  if (!index)
+    return nullptr;
 
+  lock_guard guard(m_segmentsIndexesMutex);
+  return m_segmentsIndexes.emplace(mwmId, move(index)).first->second;
+}
+
+shared_ptr<RoadSegmentsIndex const> FeaturesRoadGraphBase::GetSegmentsIndex(MwmSet::MwmId const & mwmId) const
+{
+  auto index = FindSegmentsIndex(mwmId);
+  if (index)
+    return index;
+
+  auto const info = mwmId.GetInfo();
+  if (!info)
+    return nullptr;
+
+  RoadSegmentsIndexBuilder builder(kPointCoordBits, GetAltitudesLoader(mwmId) != nullptr);
   m_dataSource.ForEachStreet([&](FeatureType & ft)
   {
     if (!m_vehicleModel.IsRoad(ft))
       return;
 
-    FeatureID const & featureId = ft.GetID();
-    if (isGoodFeature && !isGoodFeature(featureId))
-      return;
+    RoadInfo ri;
+    ExtractRoadInfo(ft.GetID(), ft, kInvalidSpeedKMPH, ri);
+    builder.AddRoad(ft.GetID().m_index, ri.m_bidirectional, ri.m_junctions);
+  }, info->m_bordersRect, mwmId);
+
+  index = builder.Build();
+  LOG(LDEBUG, ("Road segments index of", mwmId, "is built:", index->GetRoadsNumber(), "roads,",
+               index->GetMemorySize(), "bytes."));
+
+  lock_guard guard(m_segmentsIndexesMutex);
+  return m_segmentsIndexes.emplace(mwmId, move(index)).first->second;
+}
+
+base::thread_pool::computational::ThreadPool & FeaturesRoadGraphBase::GetSnappingPool(size_t threadsNumber) const
+{
+  lock_guard guard(m_snappingPoolMutex);
+  auto & pool = m_snappingPools[threadsNumber];
+  if (!pool)
+    pool = make_unique<base::thread_pool::computational::ThreadPool>(threadsNumber);
+  return *pool;
+}
+
+vector<IRoadGraph::FullRoadInfo>
+FeaturesRoadGraphBase::FindRoads(m2::RectD const & rect, IsGoodFeatureFn const & isGoodFeature) const
+{
+  vector<IRoadGraph::FullRoadInfo> roads;
 
-    // DataSource::ForEachInRect() gives not only features inside |rect| but some other features
-    // which lie close to the rect. Removes all the features which don't cross |rect|.
+  auto const addRoad = [&](FeatureID const & featureId, FeatureType & ft)
+  {
+    // DataSource::ForEachInRect() and RoadSegmentsIndex::ForEachSegment() give not only features
+    // inside |rect| but some other features which lie close to the rect. Removes all the features
+    // which don't cross |rect|.
     auto const & roadInfo = GetCachedRoadInfo(featureId, ft, kInvalidSpeedKMPH);
     if (!RectCoversPolyline(roadInfo.m_junctions, rect))
       return;
 
     roads.emplace_back(featureId, roadInfo);
-  }, rect);
+  };
+
+  vector<shared_ptr<MwmInfo>> infos;
+  m_dataSource.GetMwmsInfo(infos);
+  for (auto const & info : infos)
+  {
+    if (!info->IsRegistered() || !info->m_bordersRect.IsIntersect(rect))
+      continue;
+
+    MwmSet::MwmId const mwmId(info);
+    // Roads of mwms with ROUTING_SEGMENTS_FILE_TAG section are found by the index, so only
+    // the features of roads are read.
+    auto const index = info->GetType() == MwmInfo::COUNTRY ? FindSegmentsIndex(mwmId) : nullptr;
+    if (!index)
+    {
+      m_dataSource.ForEachStreet([&](FeatureType & ft)
+      {
+        if (!m_vehicleModel.IsRoad(ft))
+          return;
+
+        FeatureID const & featureId = ft.GetID();
+        if (!isGoodFeature || isGoodFeature(featureId))
+          addRoad(featureId, ft);
+      }, rect, mwmId);
+      continue;
+    }
+
+    vector<uint32_t> featureIds;
+    index->ForEachSegment(rect, [&featureIds](RoadSegmentsIndex::RoadSegment const & segment)
+    {
+      featureIds.push_back(segment.m_featureId);
+    });
+    base::SortUnique(featureIds);
+
+    for (auto const featureIdx : featureIds)
+    {
+      FeatureID const featureId(mwmId, featureIdx);
+      if (isGoodFeature && !isGoodFeature(featureId))
+        continue;
+
+      auto ft = m_dataSource.GetFeature(featureId);
+      if (ft)
+        addRoad(featureId, *ft);
+    }
+  }
 
   return roads;
 }
@@ -228,6 +410,9 @@ void FeaturesRoadGraphBase::ClearState()
 {
   m_cache.Clear();
   m_vehicleModel.Clear();
+
+  lock_guard guard(m_segmentsIndexesMutex);
+  m_segmentsIndexes.clear();
 }
 
 bool FeaturesRoadGraphBase::IsRoad(FeatureType & ft) const
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "routing/road_graph.hpp"
+#include "routing/road_segments_index.hpp"
+#include "routing/vehicle_mask.hpp"
 
 #include "routing_common/vehicle_model.hpp"
 
@@ -12,10 +14,12 @@
 #include "geometry/point_with_altitude.hpp"
 
 #include "base/cache.hpp"
+#include "base/thread_pool_computational.hpp"
 
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -75,7 +79,10 @@ private:
 public:
   static double constexpr kClosestEdgesRadiusM = 150.0;
 
-  FeaturesRoadGraphBase(MwmDataSource & dataSource, IRoadGraph::Mode mode, VehicleModelFactoryPtrT modelFactory);
+  /// \param vehicleType should be set if |modelFactory| is the default factory of the vehicle type.
+  /// Then indexes of road segments are loaded from ROUTING_SEGMENTS_FILE_TAG section if mwms have it.
+  FeaturesRoadGraphBase(MwmDataSource & dataSource, IRoadGraph::Mode mode, VehicleModelFactoryPtrT modelFactory,
+                        std::optional<VehicleType> vehicleType = {});
 
   static int GetStreetReadScale();
 
@@ -96,6 +103,19 @@ public:
 
   bool IsRoad(FeatureType & ft) const;
 
+  /// \brief Finds |count| closest edges for every point of |points| the same way as FindClosestEdges()
+  /// does for a rect of |radiusM| around the point. RoadSegmentsIndex of an mwm is got when the first
+  /// point gets into the mwm, the indexes are kept till ClearState().
+  /// Points are sorted by tiles and snapped by |threadsNumber| threads. A thread pool of every
+  /// |threadsNumber| is created on the first call with it and is reused by the next ones.
+  void FindClosestEdges(std::vector<m2::PointD> const & points, double radiusM, uint32_t count,
+                        size_t threadsNumber,
+                        std::vector<std::vector<std::pair<Edge, geometry::PointWithAltitude>>> & vicinities) const;
+
+  /// \returns index of roads of |mwmId|. It's loaded from the mwm section if there is one or
+  /// built from features otherwise on the first call.
+  std::shared_ptr<RoadSegmentsIndex const> GetSegmentsIndex(MwmSet::MwmId const & mwmId) const;
+
 protected:
   MwmDataSource & m_dataSource;
 
@@ -120,9 +140,21 @@ private:
   RoadInfo const & GetCachedRoadInfo(FeatureID const & featureId, FeatureType & ft, double speedKMPH) const;
   void ExtractRoadInfo(FeatureID const & featureId, FeatureType & ft, double speedKMpH, RoadInfo & ri) const;
 
+  // Returns the index from the cache or from ROUTING_SEGMENTS_FILE_TAG section, the index isn't
+  // built from features.
+  std::shared_ptr<RoadSegmentsIndex const> FindSegmentsIndex(MwmSet::MwmId const & mwmId) const;
+  base::thread_pool::computational::ThreadPool & GetSnappingPool(size_t threadsNumber) const;
+
   IRoadGraph::Mode const m_mode;
+  std::optional<VehicleType> const m_vehicleType;
   mutable RoadInfoCache m_cache;
   mutable CrossCountryVehicleModel m_vehicleModel;
+
+  mutable std::mutex m_segmentsIndexesMutex;
+  mutable std::map<MwmSet::MwmId, std::shared_ptr<RoadSegmentsIndex const>> m_segmentsIndexes;
+
+  mutable std::mutex m_snappingPoolMutex;
+  mutable std::map<size_t, std::unique_ptr<base::thread_pool::computational::ThreadPool>> m_snappingPools;
 };
 
 class FeaturesRoadGraph : public FeaturesRoadGraphBase
@@ -130,8 +162,9 @@ class FeaturesRoadGraph : public FeaturesRoadGraphBase
   mutable std::map<MwmSet::MwmId, feature::AltitudeLoaderCached> m_altitudes;
 
 public:
-  FeaturesRoadGraph(MwmDataSource & dataSource, IRoadGraph::Mode mode, VehicleModelFactoryPtrT modelFactory)
-    : FeaturesRoadGraphBase(dataSource, mode, modelFactory)
+  FeaturesRoadGraph(MwmDataSource & dataSource, IRoadGraph::Mode mode, VehicleModelFactoryPtrT modelFactory,
+                    std::optional<VehicleType> vehicleType = {})
+    : FeaturesRoadGraphBase(dataSource, mode, modelFactory, vehicleType)
   {
   }
 
@@ -3,6 +3,7 @@
 #include "routing/city_roads.hpp"
 #include "routing/data_source.hpp"
 #include "routing/maxspeeds.hpp"
+#include "routing/road_geometry_section.hpp"
 #include "routing/routing_exceptions.hpp"
 
 #include "indexer/altitude_loader.hpp"
@@ -76,6 +77,17 @@ public:
 
 namespace
 {
+void LoadSpeedProfiles(SpeedProfilesSection const * section, uint32_t featureId,
+                       RoadGeometry & road)
+{
+  if (!section)
+    return;
+
+  auto const highwayType = road.GetHighwayType();
+  road.SetSpeedProfiles(section->GetProfile(featureId, true /* forward */, highwayType),
+                        section->GetProfile(featureId, false /* forward */, highwayType));
+}
+
 class GeometryLoaderImpl final : public GeometryLoader
 {
 public:
@@ -84,6 +96,7 @@ public:
     , m_source(handle)
     , m_altitudeLoader(*handle.GetValue())
     , m_loadAltitudes(loadAltitudes)
+    , m_speedProfiles(SpeedProfilesSection::Load(*handle.GetValue()))
   {
     m_attrsGetter.Load(handle.GetValue()->m_cont);
   }
@@ -98,6 +111,7 @@ public:
       altitudes = m_altitudeLoader.GetAltitudes(featureId, feature->GetPointsCount());
 
     road.Load(*m_vehicleModel, *feature, altitudes.empty() ? nullptr : &altitudes, m_attrsGetter);
+    LoadSpeedProfiles(m_speedProfiles.get(), featureId, road);
   }
 
   SpeedInUnits GetSavedMaxspeed(uint32_t featureId, bool forward) override
@@ -112,6 +126,57 @@ private:
   FeatureSource m_source;
   feature::AltitudeLoaderBase m_altitudeLoader;
   bool const m_loadAltitudes;
+  // May be nullptr.
+  unique_ptr<SpeedProfilesSection> m_speedProfiles;
+};
+
+class SectionGeometryLoader final : public GeometryLoader
+{
+public:
+  SectionGeometryLoader(MwmSet::MwmHandle const & handle,
+                        unique_ptr<RoadGeometrySection> && section, VehicleType vehicleType,
+                        bool loadAltitudes)
+    : m_handle(handle)
+    , m_section(move(section))
+    , m_vehicleType(vehicleType)
+    , m_loadAltitudes(loadAltitudes)
+    , m_speedProfiles(SpeedProfilesSection::Load(*handle.GetValue()))
+  {
+    CHECK(m_section, ());
+  }
+
+  void Load(uint32_t featureId, RoadGeometry & road) override
+  {
+    // A feature which isn't in the section isn't a road for any vehicle, |road| stays invalid.
+    if (auto const roadIdx = m_section->FindRoad(featureId))
+    {
+      road.Load(*m_section, *roadIdx, m_vehicleType, m_loadAltitudes);
+      LoadSpeedProfiles(m_speedProfiles.get(), featureId, road);
+    }
+  }
+
+  SpeedInUnits GetSavedMaxspeed(uint32_t featureId, bool forward) override
+  {
+    // Maxspeeds are needed for the final route only, so they are loaded lazily.
+    if (!m_maxspeeds)
+    {
+      m_maxspeeds = LoadMaxspeeds(m_handle);
+      if (!m_maxspeeds)
+        m_maxspeeds = make_unique<Maxspeeds>();
+    }
+
+    auto const speed = m_maxspeeds->GetMaxspeed(featureId);
+    return { speed.GetSpeedInUnits(forward), speed.GetUnits() };
+  }
+
+private:
+  MwmSet::MwmHandle const & m_handle;
+  unique_ptr<RoadGeometrySection> m_section;
+  VehicleType const m_vehicleType;
+  bool const m_loadAltitudes;
+  unique_ptr<Maxspeeds> m_maxspeeds;
+  // May be nullptr.
+  unique_ptr<SpeedProfilesSection> m_speedProfiles;
 };
 
 class FileGeometryLoader final : public GeometryLoader
@@ -161,6 +226,7 @@ void RoadGeometry::Load(VehicleModelInterface const & vehicleModel, FeatureType
   CHECK(altitudes == nullptr || altitudes->size() == feature.GetPointsCount(), ());
 
   m_highwayType = vehicleModel.GetHighwayType(feature);
+  m_forwardProfile = m_backwardProfile = {};
 
   m_valid = vehicleModel.IsRoad(feature);
   m_isOneWay = vehicleModel.IsOneWay(feature);
@@ -219,6 +285,33 @@ void RoadGeometry::Load(VehicleModelInterface const & vehicleModel, FeatureType
   }
 }
 
+void RoadGeometry::Load(RoadGeometrySection const & section, uint32_t roadIdx,
+                        VehicleType vehicleType, bool loadAltitudes)
+{
+  uint8_t const flags = section.GetFlags(vehicleType, roadIdx);
+  m_valid = (flags & RoadGeometrySection::kValid) != 0;
+  m_isOneWay = (flags & RoadGeometrySection::kOneWay) != 0;
+  m_isPassThroughAllowed = (flags & RoadGeometrySection::kPassThroughAllowed) != 0;
+  m_inCity = (flags & RoadGeometrySection::kInCity) != 0;
+
+  m_highwayType = section.GetHighwayType(vehicleType, roadIdx);
+  m_forwardSpeed = section.GetSpeed(vehicleType, roadIdx, true /* forward */);
+  m_backwardSpeed = section.GetSpeed(vehicleType, roadIdx, false /* forward */);
+  m_routingOptions = section.GetRoutingOptions(roadIdx);
+  m_forwardProfile = m_backwardProfile = {};
+
+  loadAltitudes = loadAltitudes && section.HasAltitudes();
+  uint32_t const end = section.GetPointsEnd(roadIdx);
+  m_junctions.clear();
+  m_junctions.reserve(end - section.GetPointsBegin(roadIdx));
+  for (uint32_t i = section.GetPointsBegin(roadIdx); i < end; ++i)
+  {
+    m_junctions.emplace_back(mercator::ToLatLon(section.GetPoint(i)),
+                             loadAltitudes ? section.GetAltitude(i)
+                                           : geometry::kDefaultAltitudeMeters);
+  }
+}
+
 SpeedKMpH const & RoadGeometry::GetSpeed(bool forward) const
 {
   return forward ? m_forwardSpeed : m_backwardSpeed;
@@ -270,6 +363,22 @@ unique_ptr<GeometryLoader> GeometryLoader::Create(MwmSet::MwmHandle const & hand
   return make_unique<GeometryLoaderImpl>(handle, vehicleModel, loadAltitudes);
 }
 
+// static
+unique_ptr<GeometryLoader> GeometryLoader::CreateFromSection(MwmSet::MwmHandle const & handle,
+                                                             VehicleType vehicleType,
+                                                             bool loadAltitudes)
+{
+  CHECK(handle.IsAlive(), ());
+  if (static_cast<size_t>(vehicleType) >= RoadGeometrySection::kVehiclesNumber)
+    return nullptr;
+
+  auto section = RoadGeometrySection::Load(*handle.GetValue());
+  if (!section)
+    return nullptr;
+
+  return make_unique<SectionGeometryLoader>(handle, move(section), vehicleType, loadAltitudes);
+}
+
 // static
 unique_ptr<GeometryLoader> GeometryLoader::CreateFromFile(
     string const & fileName, VehicleModelPtrT const & vehicleModel)
@@ -3,6 +3,8 @@
 #include "routing/latlon_with_altitude.hpp"
 #include "routing/road_point.hpp"
 #include "routing/routing_options.hpp"
+#include "routing/speed_profiles.hpp"
+#include "routing/vehicle_mask.hpp"
 
 #include "routing_common/vehicle_model.hpp"
 
@@ -29,6 +31,7 @@ namespace routing
 size_t constexpr kRoadsCacheSize = 5000;
 
 class RoadAttrsGetter;
+class RoadGeometrySection;
 
 class RoadGeometry final
 {
@@ -43,7 +46,23 @@ public:
   void Load(VehicleModelInterface const & vehicleModel, FeatureType & feature,
             geometry::Altitudes const * altitudes, RoadAttrsGetter & attrs);
 
+  /// \brief Loads the road with index |roadIdx| of ROUTING_GEOMETRY_FILE_TAG section.
+  /// Altitudes are loaded if |loadAltitudes| is true and the section has them.
+  void Load(RoadGeometrySection const & section, uint32_t roadIdx, VehicleType vehicleType,
+            bool loadAltitudes);
+
   SpeedKMpH const & GetSpeed(bool forward) const;
+  /// \returns weekly profile of the speed in |forward| direction. It's invalid if the road
+  /// has no profile.
+  SpeedProfile GetSpeedProfile(bool forward) const
+  {
+    return forward ? m_forwardProfile : m_backwardProfile;
+  }
+  void SetSpeedProfiles(SpeedProfile forward, SpeedProfile backward)
+  {
+    m_forwardProfile = forward;
+    m_backwardProfile = backward;
+  }
   std::optional<HighwayType> GetHighwayType() const { return m_highwayType; }
   bool IsOneWay() const { return m_isOneWay; }
   bool IsPassThroughAllowed() const { return m_isPassThroughAllowed; }
@@ -90,6 +109,8 @@ private:
 
   SpeedKMpH m_forwardSpeed;
   SpeedKMpH m_backwardSpeed;
+  SpeedProfile m_forwardProfile;
+  SpeedProfile m_backwardProfile;
   std::optional<HighwayType> m_highwayType;
   RoutingOptions m_routingOptions;
   bool m_isOneWay : 1;
@@ -115,6 +136,13 @@ public:
                                                 VehicleModelPtrT const & vehicleModel,
                                                 bool loadAltitudes);
 
+  /// \returns loader which reads roads from ROUTING_GEOMETRY_FILE_TAG section without decoding
+  /// of features or nullptr if the mwm has no such section.
+  /// @param[in] handle should be alive, its caller responsibility to check it.
+  static std::unique_ptr<GeometryLoader> CreateFromSection(MwmSet::MwmHandle const & handle,
+                                                           VehicleType vehicleType,
+                                                           bool loadAltitudes);
+
   /// This is for stand-alone work.
   /// Use in generator_tool and unit tests.
   static std::unique_ptr<GeometryLoader> CreateFromFile(
@@ -45,7 +45,7 @@ IndexGraph::IndexGraph(shared_ptr<Geometry> geometry, shared_ptr<EdgeEstimator>
 
 bool IndexGraph::IsJoint(RoadPoint const & roadPoint) const
 {
-  return m_roadIndex.GetJointId(roadPoint) != Joint::kInvalidId;
+  return m_data->m_roadIndex.GetJointId(roadPoint) != Joint::kInvalidId;
 }
 
 bool IndexGraph::IsJointOrEnd(Segment const & segment, bool fromStart) const
@@ -86,11 +86,11 @@ void IndexGraph::GetEdgeListImpl(astar::VertexData<Segment, RouteWeight> const &
   auto const & segment = vertexData.m_vertex;
 
   RoadPoint const roadPoint = segment.GetRoadPoint(isOutgoing);
-  Joint::Id const jointId = m_roadIndex.GetJointId(roadPoint);
+  Joint::Id const jointId = m_data->m_roadIndex.GetJointId(roadPoint);
 
   if (jointId != Joint::kInvalidId)
   {
-    m_jointIndex.ForEachPoint(jointId, [&](RoadPoint const & rp) {
+    m_data->m_jointIndex.ForEachPoint(jointId, [&](RoadPoint const & rp) {
       GetNeighboringEdges(vertexData, rp, isOutgoing, useRoutingOptions, edges, parents,
                           useAccessConditional);
     });
@@ -197,33 +197,55 @@ optional<JointEdge> IndexGraph::GetJointEdgeByLastPoint(Segment const & parent,
   return {};
 }
 
+size_t IndexGraphData::GetMemorySize() const
+{
+  auto const getRestrictionsSize = [](Restrictions const & restrictions) {
+    size_t size = 0;
+    for (auto const & [featureId, featureRestrictions] : restrictions)
+    {
+      size += sizeof(featureId) + sizeof(featureRestrictions);
+      for (auto const & restriction : featureRestrictions)
+        size += sizeof(restriction) + restriction.capacity() * sizeof(uint32_t);
+    }
+    return size;
+  };
+
+  return m_roadIndex.GetMemorySize() + m_jointIndex.GetMemorySize() +
+         getRestrictionsSize(m_restrictionsForward) + getRestrictionsSize(m_restrictionsBackward) +
+         m_noUTurnRestrictions.size() * (sizeof(uint32_t) + sizeof(UTurnEnding));
+}
+
 void IndexGraph::Build(uint32_t numJoints)
 {
-  m_jointIndex.Build(m_roadIndex, numJoints);
+  auto & data = GetOwnData();
+  data.m_roadIndex.Build();
+  data.m_jointIndex.Build(data.m_roadIndex, numJoints);
 }
 
 void IndexGraph::Import(vector<Joint> const & joints)
 {
-  m_roadIndex.Import(joints);
+  GetOwnData().m_roadIndex.Import(joints);
   CHECK_LESS_OR_EQUAL(joints.size(), numeric_limits<uint32_t>::max(), ());
   Build(checked_cast<uint32_t>(joints.size()));
 }
 
 void IndexGraph::SetRestrictions(RestrictionVec && restrictions)
 {
-  m_restrictionsForward.clear();
-  m_restrictionsBackward.clear();
+  auto & data = GetOwnData();
+  data.m_restrictionsForward.clear();
+  data.m_restrictionsBackward.clear();
 
   base::HighResTimer timer;
   for (auto const & restriction : restrictions)
   {
     ASSERT(!restriction.empty(), ());
 
-    auto & forward = m_restrictionsForward[restriction.back()];
+    auto & forward = data.m_restrictionsForward[restriction.back()];
     forward.emplace_back(restriction.begin(), prev(restriction.end()));
     reverse(forward.back().begin(), forward.back().end());
 
-    m_restrictionsBackward[restriction.front()].emplace_back(next(restriction.begin()), restriction.end());
+    data.m_restrictionsBackward[restriction.front()].emplace_back(next(restriction.begin()),
+                                                                  restriction.end());
   }
 
   LOG(LDEBUG, ("Restrictions are loaded in:", timer.ElapsedMilliseconds(), "ms"));
@@ -231,15 +253,30 @@ void IndexGraph::SetRestrictions(RestrictionVec && restrictions)
 
 void IndexGraph::SetUTurnRestrictions(vector<RestrictionUTurn> && noUTurnRestrictions)
 {
+  auto & data = GetOwnData();
   for (auto const & noUTurn : noUTurnRestrictions)
   {
     if (noUTurn.m_viaIsFirstPoint)
-      m_noUTurnRestrictions[noUTurn.m_featureId].m_atTheBegin = true;
+      data.m_noUTurnRestrictions[noUTurn.m_featureId].m_atTheBegin = true;
     else
-      m_noUTurnRestrictions[noUTurn.m_featureId].m_atTheEnd = true;
+      data.m_noUTurnRestrictions[noUTurn.m_featureId].m_atTheEnd = true;
   }
 }
 
+void IndexGraph::SetData(shared_ptr<IndexGraphData const> data)
+{
+  CHECK(data, ());
+  m_ownData.reset();
+  m_data = move(data);
+}
+
+IndexGraphData & IndexGraph::GetOwnData()
+{
+  CHECK(m_ownData, ("Shared data must not be changed."));
+  ASSERT_EQUAL(m_ownData.get(), m_data.get(), ());
+  return *m_ownData;
+}
+
 void IndexGraph::SetRoadAccess(RoadAccess && roadAccess)
 {
   m_roadAccess = move(roadAccess);
@@ -301,12 +338,12 @@ void IndexGraph::GetSegmentCandidateForJoint(Segment const & parent, bool isOutg
                                              SegmentListT & children) const
 {
   RoadPoint const roadPoint = parent.GetRoadPoint(isOutgoing);
-  Joint::Id const jointId = m_roadIndex.GetJointId(roadPoint);
+  Joint::Id const jointId = m_data->m_roadIndex.GetJointId(roadPoint);
 
   if (jointId == Joint::kInvalidId)
     return;
 
-  m_jointIndex.ForEachPoint(jointId, [&](RoadPoint const & rp) {
+  m_data->m_jointIndex.ForEachPoint(jointId, [&](RoadPoint const & rp) {
     GetSegmentCandidateForRoadPoint(rp, parent.GetMwmId(), isOutgoing, children);
   });
 }
@@ -535,11 +572,11 @@ bool IndexGraph::IsUTurnAndRestricted(Segment const & parent, Segment const & ch
   auto const & roadGeometry = GetRoadGeometry(featureId);
 
   RoadPoint const rp = parent.GetRoadPoint(isOutgoing);
-  if (m_roadIndex.GetJointId(rp) == Joint::kInvalidId && !roadGeometry.IsEndPointId(turnPoint))
+  if (m_data->m_roadIndex.GetJointId(rp) == Joint::kInvalidId && !roadGeometry.IsEndPointId(turnPoint))
     return true;
 
-  auto const it = m_noUTurnRestrictions.find(featureId);
-  if (it == m_noUTurnRestrictions.cend())
+  auto const it = m_data->m_noUTurnRestrictions.find(featureId);
+  if (it == m_data->m_noUTurnRestrictions.cend())
     return false;
 
   auto const & uTurn = it->second;
@@ -558,9 +595,14 @@ RouteWeight IndexGraph::CalculateEdgeWeight(EdgeEstimator::Purpose purpose, bool
   auto const & segment = isOutgoing ? to : from;
   auto const & road = GetRoadGeometry(segment.GetFeatureId());
 
-  auto const weight = RouteWeight(m_estimator->CalcSegmentWeight(segment, road, purpose));
+  double weight = m_estimator->CalcSegmentWeight(segment, road, purpose);
+  // Weights of edges of the search depend on the moment |segment| is entered. It's known in
+  // the forward wave only. The backward wave keeps static weights which are not greater than
+  // time-dependent ones, so bidirectional searches over them stay admissible.
+  if (prevWeight && isOutgoing)
+    weight *= m_estimator->CalcTimeFactor(segment, road, purpose, prevWeight->GetWeight());
   auto const penalties = GetPenalties(purpose, isOutgoing ? from : to, isOutgoing ? to : from, prevWeight);
 
-  return weight + penalties;
+  return RouteWeight(weight) + penalties;
 }
 }  // namespace routing
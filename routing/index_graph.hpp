@@ -15,6 +15,8 @@
 #include "routing/routing_options.hpp"
 #include "routing/segment.hpp"
 
+#include "coding/memory_region.hpp"
+
 #include "geometry/point2d.hpp"
 
 #include <memory>
@@ -28,6 +30,38 @@ bool IsUTurn(Segment const & u, Segment const & v);
 
 enum class WorldGraphMode;
 
+/// \brief Road and joint indexes and restrictions of an mwm which are read from the routing
+/// section. They aren't changed after loading, so one copy may be shared by several graphs.
+struct IndexGraphData
+{
+  using Restrictions = std::unordered_map<uint32_t, std::vector<std::vector<uint32_t>>>;
+
+  // u_turn can be in both sides of feature.
+  struct UTurnEnding
+  {
+    bool m_atTheBegin = false;
+    bool m_atTheEnd = false;
+  };
+
+  /// \returns approximate size of the data in bytes.
+  size_t GetMemorySize() const;
+
+  RoadIndex m_roadIndex;
+  JointIndex m_jointIndex;
+  // Memory of the routing section if |m_roadIndex| and |m_jointIndex| are used in place.
+  std::unique_ptr<MemoryRegion> m_region;
+
+  Restrictions m_restrictionsForward;
+  Restrictions m_restrictionsBackward;
+
+  // Stored featureId and it's UTurnEnding, which shows where is
+  // u_turn restriction is placed - at the beginning or at the ending of feature.
+  //
+  // If m_noUTurnRestrictions.count(featureId) == 0, that means, that there are no any
+  // no_u_turn restriction at the feature with id = featureId.
+  std::unordered_map<uint32_t, UTurnEnding> m_noUTurnRestrictions;
+};
+
 class IndexGraph final
 {
 public:
@@ -39,7 +73,7 @@ public:
   template <typename VertexType>
   using Parents = typename AStarGraph<VertexType, void, void>::Parents;
 
-  using Restrictions = std::unordered_map<uint32_t, std::vector<std::vector<uint32_t>>>;
+  using Restrictions = IndexGraphData::Restrictions;
 
   using SegmentEdgeListT = SmallList<SegmentEdge>;
   using JointEdgeListT = SmallList<JointEdge>;
@@ -70,10 +104,13 @@ public:
                                                    Segment const & firstChild, bool isOutgoing,
                                                    uint32_t lastPoint) const;
 
-  Joint::Id GetJointId(RoadPoint const & rp) const { return m_roadIndex.GetJointId(rp); }
+  Joint::Id GetJointId(RoadPoint const & rp) const { return m_data->m_roadIndex.GetJointId(rp); }
 
-  bool IsRoad(uint32_t featureId) const { return m_roadIndex.IsRoad(featureId); }
-  RoadJointIds const & GetRoad(uint32_t featureId) const { return m_roadIndex.GetRoad(featureId); }
+  bool IsRoad(uint32_t featureId) const { return m_data->m_roadIndex.IsRoad(featureId); }
+  RoadJointIds GetRoad(uint32_t featureId) const
+  {
+    return m_data->m_roadIndex.GetRoad(featureId);
+  }
   RoadGeometry const & GetRoadGeometry(uint32_t featureId) const { return m_geometry->GetRoad(featureId); }
 
   Geometry & GetGeometry() const { return *m_geometry; }
@@ -83,9 +120,9 @@ public:
     return m_roadAccess.GetAccessWithoutConditional(segment.GetFeatureId()).first;
   }
 
-  uint32_t GetNumRoads() const { return m_roadIndex.GetSize(); }
-  uint32_t GetNumJoints() const { return m_jointIndex.GetNumJoints(); }
-  uint32_t GetNumPoints() const { return m_jointIndex.GetNumPoints(); }
+  uint32_t GetNumRoads() const { return m_data->m_roadIndex.GetSize(); }
+  uint32_t GetNumJoints() const { return m_data->m_jointIndex.GetNumJoints(); }
+  uint32_t GetNumPoints() const { return m_data->m_jointIndex.GetNumPoints(); }
 
   void Build(uint32_t numJoints);
   void Import(std::vector<Joint> const & joints);
@@ -96,19 +133,19 @@ public:
 
   void PushFromSerializer(Joint::Id jointId, RoadPoint const & rp)
   {
-    m_roadIndex.PushFromSerializer(jointId, rp);
+    GetOwnData().m_roadIndex.PushFromSerializer(jointId, rp);
   }
 
   template <typename F>
   void ForEachRoad(F && f) const
   {
-    m_roadIndex.ForEachRoad(std::forward<F>(f));
+    m_data->m_roadIndex.ForEachRoad(std::forward<F>(f));
   }
 
   template <typename F>
   void ForEachPoint(Joint::Id jointId, F && f) const
   {
-    m_jointIndex.ForEachPoint(jointId, std::forward<F>(f));
+    m_data->m_jointIndex.ForEachPoint(jointId, std::forward<F>(f));
   }
 
   bool IsJoint(RoadPoint const & roadPoint) const;
@@ -144,7 +181,17 @@ public:
   template <typename T>
   void SetCurrentTimeGetter(T && t) { m_currentTimeGetter = std::forward<T>(t); }
 
+  /// \brief Road and joint indexes and restrictions. The data may be shared by several graphs
+  /// after the graph is loaded, see IndexGraphStore, so it's immutable.
+  std::shared_ptr<IndexGraphData const> const & GetData() const { return m_data; }
+  void SetData(std::shared_ptr<IndexGraphData const> data);
+
 private:
+  friend class IndexGraphSerializer;
+
+  /// \returns data which is being loaded by the graph. Must not be called after SetData().
+  IndexGraphData & GetOwnData();
+
   void GetEdgeListImpl(astar::VertexData<Segment, RouteWeight> const & vertexData, bool isOutgoing,
                        bool useRoutingOptions, bool useAccessConditional,
                        SegmentEdgeListT & edges, Parents<Segment> const & parents) const;
@@ -199,24 +246,10 @@ private:
 
   std::shared_ptr<Geometry> m_geometry;
   std::shared_ptr<EdgeEstimator> m_estimator;
-  RoadIndex m_roadIndex;
-  JointIndex m_jointIndex;
-
-  Restrictions m_restrictionsForward;
-  Restrictions m_restrictionsBackward;
-
-  // u_turn can be in both sides of feature.
-  struct UTurnEnding
-  {
-    bool m_atTheBegin = false;
-    bool m_atTheEnd = false;
-  };
-  // Stored featureId and it's UTurnEnding, which shows where is
-  // u_turn restriction is placed - at the beginning or at the ending of feature.
-  //
-  // If m_noUTurnRestrictions.count(featureId) == 0, that means, that there are no any
-  // no_u_turn restriction at the feature with id = featureId.
-  std::unordered_map<uint32_t, UTurnEnding> m_noUTurnRestrictions;
+  // Data which is filled while the graph is loaded. It's reset by SetData(), so data which
+  // may be shared with graphs of other routers is never changed.
+  std::shared_ptr<IndexGraphData> m_ownData = std::make_shared<IndexGraphData>();
+  std::shared_ptr<IndexGraphData const> m_data = m_ownData;
 
   RoadAccess m_roadAccess;
   RoutingOptions m_avoidRoutingOptions;
@@ -246,7 +279,8 @@ bool IndexGraph::IsRestricted(ParentVertex const & parent,
   if (parentFeatureId == currentFeatureId)
     return false;
 
-  auto const & restrictions = isOutgoing ? m_restrictionsForward : m_restrictionsBackward;
+  auto const & restrictions =
+      isOutgoing ? m_data->m_restrictionsForward : m_data->m_restrictionsBackward;
   auto const it = restrictions.find(currentFeatureId);
   if (it == restrictions.cend())
     return false;
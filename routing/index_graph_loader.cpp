@@ -1,9 +1,12 @@
 #include "routing/index_graph_loader.hpp"
 
+#include "routing/aligned_arrays.hpp"
 #include "routing/city_roads.hpp"
 #include "routing/data_source.hpp"
 #include "routing/index_graph_serialization.hpp"
+#include "routing/index_graph_store.hpp"
 #include "routing/restriction_loader.hpp"
+#include "routing/route_build_stats.hpp"
 #include "routing/road_access.hpp"
 #include "routing/road_access_serialization.hpp"
 #include "routing/route.hpp"
@@ -11,6 +14,7 @@
 #include "routing/speed_camera_ser_des.hpp"
 
 #include "platform/country_defines.hpp"
+#include "platform/local_country_file.hpp"
 
 #include "coding/files_container.hpp"
 
@@ -27,18 +31,28 @@ namespace
 using namespace routing;
 using namespace std;
 
+bool ReadRoadAccessFromMwm(MwmValue const & mwmValue, VehicleType vehicleType,
+                           RoadAccess & roadAccess);
+
+// Deserializes road and joint indexes and restrictions, i.e. IndexGraphData of |graph|.
+void DeserializeIndexGraphData(MwmValue const & mwmValue, VehicleType vehicleType,
+                               IndexGraph & graph);
+
 class IndexGraphLoaderImpl final : public IndexGraphLoader
 {
 public:
   IndexGraphLoaderImpl(VehicleType vehicleType, bool loadAltitudes,
                        shared_ptr<VehicleModelFactoryInterface> vehicleModelFactory,
                        shared_ptr<EdgeEstimator> estimator, MwmDataSource & dataSource,
-                       RoutingOptions routingOptions = RoutingOptions())
+                       RoutingOptions routingOptions, shared_ptr<IndexGraphStore> graphStore,
+                       RouteBuildStats * stats)
     : m_vehicleType(vehicleType)
     , m_loadAltitudes(loadAltitudes)
     , m_dataSource(dataSource)
     , m_vehicleModelFactory(move(vehicleModelFactory))
     , m_estimator(move(estimator))
+    , m_graphStore(move(graphStore))
+    , m_stats(stats)
     , m_avoidRoutingOptions(routingOptions)
   {
     CHECK(m_vehicleModelFactory, ());
@@ -62,6 +76,10 @@ private:
   MwmDataSource & m_dataSource;
   shared_ptr<VehicleModelFactoryInterface> m_vehicleModelFactory;
   shared_ptr<EdgeEstimator> m_estimator;
+  // May be nullptr.
+  shared_ptr<IndexGraphStore> m_graphStore;
+  // May be nullptr.
+  RouteBuildStats * m_stats;
 
   struct GraphAttrs
   {
@@ -86,6 +104,7 @@ IndexGraph & IndexGraphLoaderImpl::GetIndexGraph(NumMwmId numMwmId)
   auto res = m_graphs.try_emplace(numMwmId, GraphAttrs());
   if (res.second || res.first->second.m_graph == nullptr)
   {
+    RouteBuildStats::ScopedTimer timer(m_stats, RouteBuildStats::Phase::GraphLoading);
     // Create graph using (or initializing) existing geometry.
     res.first->second.m_graph = CreateIndexGraph(numMwmId, res.first->second.m_geometry);
   }
@@ -97,6 +116,7 @@ Geometry & IndexGraphLoaderImpl::GetGeometry(NumMwmId numMwmId)
   auto res = m_graphs.try_emplace(numMwmId, GraphAttrs());
   if (res.second)
   {
+    RouteBuildStats::ScopedTimer timer(m_stats, RouteBuildStats::Phase::GraphLoading);
     // Create geometry only, graph stays nullptr.
     res.first->second.m_geometry = CreateGeometry(numMwmId);
   }
@@ -164,17 +184,35 @@ IndexGraphLoaderImpl::GraphPtrT IndexGraphLoaderImpl::CreateIndexGraph(NumMwmId
   MwmValue const * value = handle.GetValue();
 
   if (!geometry)
-  {
-    auto vehicleModel = m_vehicleModelFactory->GetVehicleModelForCountry(value->GetCountryFileName());
-    geometry = make_shared<Geometry>(GeometryLoader::Create(handle, std::move(vehicleModel), m_loadAltitudes));
-  }
+    geometry = CreateGeometry(numMwmId);
 
   auto graph = make_unique<IndexGraph>(geometry, m_estimator, m_avoidRoutingOptions);
   graph->SetCurrentTimeGetter(m_currentTimeGetter);
 
   base::Timer timer;
-  DeserializeIndexGraph(*value, m_vehicleType, *graph);
-  LOG(LINFO, (ROUTING_FILE_TAG, "section for", value->GetCountryFileName(), "loaded in", timer.ElapsedSeconds(), "seconds"));
+  if (!m_graphStore)
+  {
+    DeserializeIndexGraph(*value, m_vehicleType, *graph);
+    LOG(LINFO, (ROUTING_FILE_TAG, "section for", value->GetCountryFileName(), "loaded in", timer.ElapsedSeconds(), "seconds"));
+    return graph;
+  }
+
+  IndexGraphStore::Key key;
+  key.m_mwmPath = value->m_file.GetPath(MapFileType::Map);
+  key.m_mwmVersion = value->GetMwmVersion().GetSecondsSinceEpoch();
+  key.m_vehicleType = m_vehicleType;
+
+  graph->SetData(m_graphStore->Get(key, [&]() {
+    DeserializeIndexGraphData(*value, m_vehicleType, *graph);
+    LOG(LINFO, (ROUTING_FILE_TAG, "section for", value->GetCountryFileName(), "loaded in",
+                timer.ElapsedSeconds(), "seconds"));
+    return graph->GetData();
+  }));
+
+  // Road access depends on the current time getter of the graph, so it isn't shared.
+  RoadAccess roadAccess;
+  if (ReadRoadAccessFromMwm(*value, m_vehicleType, roadAccess))
+    graph->SetRoadAccess(move(roadAccess));
 
   return graph;
 }
@@ -184,8 +222,15 @@ IndexGraphLoaderImpl::GeometryPtrT IndexGraphLoaderImpl::CreateGeometry(NumMwmId
   MwmSet::MwmHandle const & handle = m_dataSource.GetHandle(numMwmId);
   MwmValue const * value = handle.GetValue();
 
-  auto vehicleModel = m_vehicleModelFactory->GetVehicleModelForCountry(value->GetCountryFileName());
-  return make_shared<Geometry>(GeometryLoader::Create(handle, std::move(vehicleModel), m_loadAltitudes));
+  // Roads are read from the routing geometry section if the mwm has it, it's much faster
+  // than decoding of features.
+  auto loader = GeometryLoader::CreateFromSection(handle, m_vehicleType, m_loadAltitudes);
+  if (!loader)
+  {
+    auto vehicleModel = m_vehicleModelFactory->GetVehicleModelForCountry(value->GetCountryFileName());
+    loader = GeometryLoader::Create(handle, std::move(vehicleModel), m_loadAltitudes);
+  }
+  return make_shared<Geometry>(std::move(loader));
 }
 
 void IndexGraphLoaderImpl::Clear() { m_graphs.clear(); }
@@ -211,27 +256,21 @@ bool ReadRoadAccessFromMwm(MwmValue const & mwmValue, VehicleType vehicleType,
   }
   return true;
 }
-}  // namespace
-
-namespace routing
-{
-// static
-unique_ptr<IndexGraphLoader> IndexGraphLoader::Create(
-    VehicleType vehicleType, bool loadAltitudes,
-    shared_ptr<VehicleModelFactoryInterface> vehicleModelFactory,
-    shared_ptr<EdgeEstimator> estimator, MwmDataSource & dataSource,
-    RoutingOptions routingOptions)
-{
-  return make_unique<IndexGraphLoaderImpl>(vehicleType, loadAltitudes, vehicleModelFactory,
-                                           estimator, dataSource, routingOptions);
-}
 
-void DeserializeIndexGraph(MwmValue const & mwmValue, VehicleType vehicleType, IndexGraph & graph)
+void DeserializeIndexGraphData(MwmValue const & mwmValue, VehicleType vehicleType,
+                               IndexGraph & graph)
 {
   FilesContainerR::TReader reader(mwmValue.m_cont.GetReader(ROUTING_FILE_TAG));
-  ReaderSource<FilesContainerR::TReader> src(reader);
 
-  IndexGraphSerializer::Deserialize(graph, src, GetVehicleMask(vehicleType));
+  // Road and joint indexes of the last section versions are used right from the mapped section
+  // instead of decoding.
+  if (!IndexGraphSerializer::HasInPlaceIndexes(reader) ||
+      !IndexGraphSerializer::DeserializeInPlace(MapSection(mwmValue, ROUTING_FILE_TAG),
+                                                vehicleType, graph))
+  {
+    ReaderSource<FilesContainerR::TReader> src(reader);
+    IndexGraphSerializer::Deserialize(graph, src, GetVehicleMask(vehicleType));
+  }
 
   // Do not load restrictions (relation type = restriction) for pedestrian routing.
   // https://wiki.openstreetmap.org/wiki/Relation:restriction
@@ -247,6 +286,27 @@ void DeserializeIndexGraph(MwmValue const & mwmValue, VehicleType vehicleType, I
       graph.SetUTurnRestrictions(restrictionLoader.StealNoUTurnRestrictions());
     }
   }
+}
+}  // namespace
+
+namespace routing
+{
+// static
+unique_ptr<IndexGraphLoader> IndexGraphLoader::Create(
+    VehicleType vehicleType, bool loadAltitudes,
+    shared_ptr<VehicleModelFactoryInterface> vehicleModelFactory,
+    shared_ptr<EdgeEstimator> estimator, MwmDataSource & dataSource,
+    RoutingOptions routingOptions, shared_ptr<IndexGraphStore> graphStore,
+    RouteBuildStats * stats)
+{
+  return make_unique<IndexGraphLoaderImpl>(vehicleType, loadAltitudes, vehicleModelFactory,
+                                           estimator, dataSource, routingOptions,
+                                           move(graphStore), stats);
+}
+
+void DeserializeIndexGraph(MwmValue const & mwmValue, VehicleType vehicleType, IndexGraph & graph)
+{
+  DeserializeIndexGraphData(mwmValue, vehicleType, graph);
 
   RoadAccess roadAccess;
   if (ReadRoadAccessFromMwm(mwmValue, vehicleType, roadAccess))
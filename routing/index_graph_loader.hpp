@@ -15,7 +15,9 @@ class MwmValue;
 
 namespace routing
 {
+class IndexGraphStore;
 class MwmDataSource;
+class RouteBuildStats;
 
 class IndexGraphLoader
 {
@@ -29,11 +31,15 @@ public:
   virtual std::vector<RouteSegment::SpeedCamera> GetSpeedCameraInfo(Segment const & segment) = 0;
   virtual void Clear() = 0;
 
+  /// \param graphStore if it's not nullptr road and joint indexes are taken from the store
+  /// and shared with the other loaders which use the same store.
+  /// \param stats if it's not nullptr time of loading of graphs is added to it.
   static std::unique_ptr<IndexGraphLoader> Create(
       VehicleType vehicleType, bool loadAltitudes,
       std::shared_ptr<VehicleModelFactoryInterface> vehicleModelFactory,
       std::shared_ptr<EdgeEstimator> estimator, MwmDataSource & dataSource,
-      RoutingOptions routingOptions = RoutingOptions());
+      RoutingOptions routingOptions = RoutingOptions(),
+      std::shared_ptr<IndexGraphStore> graphStore = nullptr, RouteBuildStats * stats = nullptr);
 };
 
 void DeserializeIndexGraph(MwmValue const & mwmValue, VehicleType vehicleType, IndexGraph & graph);
@@ -1,9 +1,12 @@
 #include "routing/index_graph_serialization.hpp"
 
+#include "routing/aligned_arrays.hpp"
+
 namespace routing
 {
 // static
 uint8_t constexpr IndexGraphSerializer::kLastVersion;
+uint8_t constexpr IndexGraphSerializer::kInPlaceIndexesVersion;
 uint32_t constexpr IndexGraphSerializer::JointsFilter::kEmptyEntry;
 uint32_t constexpr IndexGraphSerializer::JointsFilter::kPushedEntry;
 
@@ -64,6 +67,64 @@ void IndexGraphSerializer::JointsFilter::Push(Joint::Id jointIdInFile, RoadPoint
 }
 
 // IndexGraphSerializer ----------------------------------------------------------------------------
+// static
+bool IndexGraphSerializer::DeserializeInPlace(std::unique_ptr<MemoryRegion> region,
+                                              VehicleType vehicleType, IndexGraph & graph)
+{
+  CHECK(region, ());
+  auto const vehicleIdx = static_cast<size_t>(vehicleType);
+  if (vehicleIdx >= kInPlaceVehiclesNumber)
+    return false;
+
+  MemReader memReader(region->ImmutableData(), region->Size());
+  ReaderSource<MemReader> src(memReader);
+  Header header;
+  header.Deserialize(src);
+  if (header.GetVersion() < kInPlaceIndexesVersion)
+    return false;
+
+  uint64_t pos = src.Pos();
+  for (uint32_t i = 0; i < header.GetNumSections(); ++i)
+    pos += header.GetSection(i).GetSize();
+  pos += (kArraysAlignment - pos % kArraysAlignment) % kArraysAlignment;
+
+  auto & data = graph.GetOwnData();
+  ArraysReader reader(region->ImmutableData(), region->Size(), pos, "Routing section");
+  // Indexes of the previous vehicle types are skipped. Reading of arrays is just moving of
+  // the position, so it's cheap.
+  for (size_t i = 0; i <= vehicleIdx; ++i)
+  {
+    data.m_roadIndex.ReadArrays(reader);
+    data.m_jointIndex.ReadArrays(reader);
+  }
+
+  data.m_region = std::move(region);
+  return true;
+}
+
+// static
+void IndexGraphSerializer::SerializeInPlaceIndexes(std::vector<uint8_t> const & sectionsBuffer,
+                                                   Writer & writer)
+{
+  // The section is aligned in the mwm, so the arrays are aligned with respect to its start.
+  WriteZeroesToSink(writer, (kArraysAlignment - sectionsBuffer.size() % kArraysAlignment) %
+                                kArraysAlignment);
+
+  ArraysWriter arraysWriter(writer);
+  for (size_t i = 0; i < kInPlaceVehiclesNumber; ++i)
+  {
+    // The graph of a vehicle type is the same graph which is deserialized from the bit coded
+    // sections, so joint ids are the same as well.
+    IndexGraph graph;
+    MemReader memReader(sectionsBuffer.data(), sectionsBuffer.size());
+    ReaderSource<MemReader> src(memReader);
+    Deserialize(graph, src, GetVehicleMask(static_cast<VehicleType>(i)));
+
+    graph.GetData()->m_roadIndex.WriteArrays(arraysWriter);
+    graph.GetData()->m_jointIndex.WriteArrays(arraysWriter);
+  }
+}
+
 // static
 VehicleMask IndexGraphSerializer::GetRoadMask(std::unordered_map<uint32_t, VehicleMask> const & masks,
                                               uint32_t featureId)
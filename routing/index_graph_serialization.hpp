@@ -7,14 +7,18 @@
 #include "routing/vehicle_mask.hpp"
 
 #include "coding/bit_streams.hpp"
+#include "coding/endianness.hpp"
+#include "coding/memory_region.hpp"
 #include "coding/reader.hpp"
 #include "coding/write_to_sink.hpp"
+#include "coding/writer.hpp"
 
 #include "base/checked_cast.hpp"
 
 #include <algorithm>
 #include <cstdint>
 #include <limits>
+#include <memory>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -22,6 +26,11 @@
 
 namespace routing
 {
+/// \brief Routing section. It's a header and bit coded sections of roads with joints, one for
+/// every vehicle mask. Since version 1 the bit coded sections are followed by road and joint
+/// indexes of Pedestrian, Bicycle and Car graphs, see RoadIndex::WriteArrays() and
+/// JointIndex::WriteArrays(). They are 4-byte aligned arrays, so they are used right from
+/// the mapped section without decoding, see DeserializeInPlace().
 class IndexGraphSerializer final
 {
 public:
@@ -31,25 +40,14 @@ public:
   static void Serialize(IndexGraph const & graph,
                         std::unordered_map<uint32_t, VehicleMask> const & masks, Sink & sink)
   {
-    Header header(graph);
-    JointIdEncoder jointEncoder;
-
-    std::vector<SectionSerializer> serializers;
-    PrepareSectionSerializers(graph, masks, serializers);
-
-    for (SectionSerializer & serializer : serializers)
+    std::vector<uint8_t> buffer;
     {
-      Joint::Id const begin = jointEncoder.GetCount();
-      serializer.PreSerialize(graph, masks, jointEncoder);
-      header.AddSection({
-          serializer.GetBufferSize(), static_cast<uint32_t>(serializer.GetNumRoads()), begin,
-          jointEncoder.GetCount(), serializer.GetMask(),
-      });
+      MemWriter<std::vector<uint8_t>> writer(buffer);
+      SerializeSections(graph, masks, writer);
     }
 
-    header.Serialize(sink);
-    for (SectionSerializer & section : serializers)
-      section.Flush(sink);
+    sink.Write(buffer.data(), buffer.size());
+    SerializeInPlaceIndexes(buffer, sink);
   }
 
   template <class Source>
@@ -123,6 +121,26 @@ public:
     graph.Build(jointsFilter.GetCount());
   }
 
+  /// \returns true if the section of |reader| has road and joint indexes which may be used
+  /// in place.
+  template <class Reader>
+  static bool HasInPlaceIndexes(Reader const & reader)
+  {
+    // Arrays are used in place, so they must have the host byte order.
+    if (IsBigEndianMacroBased() || reader.Size() == 0)
+      return false;
+
+    uint8_t version = 0;
+    reader.Read(0 /* pos */, &version, sizeof(version));
+    return version >= kInPlaceIndexesVersion;
+  }
+
+  /// \brief Sets road and joint indexes of |vehicleType| of the section in |region| to |graph|.
+  /// The indexes are used in place and |region| is kept by the graph data.
+  /// \returns false if the section has no such indexes.
+  static bool DeserializeInPlace(std::unique_ptr<MemoryRegion> region, VehicleType vehicleType,
+                                 IndexGraph & graph);
+
   template <class Source>
   static uint32_t DeserializeNumRoads(Source & src, VehicleMask requiredMask)
   {
@@ -145,9 +163,41 @@ public:
   }
 
 private:
-  static uint8_t constexpr kLastVersion = 0;
+  static uint8_t constexpr kLastVersion = 1;
+  static uint8_t constexpr kInPlaceIndexesVersion = 1;
   static uint8_t constexpr kNewJointIdBit = 0;
   static uint8_t constexpr kRepeatJointIdBit = 1;
+  // Graphs of vehicle types from Pedestrian to Car have indexes which are used in place.
+  // Transit uses pedestrian roads.
+  static size_t constexpr kInPlaceVehiclesNumber = static_cast<size_t>(VehicleType::Car) + 1;
+
+  template <class Sink>
+  static void SerializeSections(IndexGraph const & graph,
+                                std::unordered_map<uint32_t, VehicleMask> const & masks, Sink & sink)
+  {
+    Header header(graph);
+    JointIdEncoder jointEncoder;
+
+    std::vector<SectionSerializer> serializers;
+    PrepareSectionSerializers(graph, masks, serializers);
+
+    for (SectionSerializer & serializer : serializers)
+    {
+      Joint::Id const begin = jointEncoder.GetCount();
+      serializer.PreSerialize(graph, masks, jointEncoder);
+      header.AddSection({
+          serializer.GetBufferSize(), static_cast<uint32_t>(serializer.GetNumRoads()), begin,
+          jointEncoder.GetCount(), serializer.GetMask(),
+      });
+    }
+
+    header.Serialize(sink);
+    for (SectionSerializer & section : serializers)
+      section.Flush(sink);
+  }
+
+  // Writes road and joint indexes of the graphs of the sections in |sectionsBuffer|.
+  static void SerializeInPlaceIndexes(std::vector<uint8_t> const & sectionsBuffer, Writer & writer);
 
   class Section final
   {
@@ -224,7 +274,7 @@ private:
     void Deserialize(Source & src)
     {
       m_version = ReadPrimitiveFromSource<decltype(m_version)>(src);
-      if (m_version != kLastVersion)
+      if (m_version > kLastVersion)
       {
         MYTHROW(CorruptedDataException,
                 ("Unknown index graph version ", m_version, ", current version ", kLastVersion));
@@ -239,6 +289,7 @@ private:
         section.Deserialize(src);
     }
 
+    uint8_t GetVersion() const { return m_version; }
     uint32_t GetNumRoads() const { return m_numRoads; }
     Joint::Id GetNumJoints() const { return m_numJoints; }
     uint32_t GetNumSections() const { return base::asserted_cast<uint32_t>(m_sections.size()); }
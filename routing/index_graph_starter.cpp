@@ -64,6 +64,21 @@ IndexGraphStarter::IndexGraphStarter(FakeEnding const & startEnding,
   m_startToFinishDistanceM = ms::DistanceOnEarth(startPoint, finishPoint);
 }
 
+IndexGraphStarter::IndexGraphStarter(IndexGraphStarter const & starter, WorldGraph & graph)
+  : m_graph(graph)
+  , m_start(starter.m_start)
+  , m_finish(starter.m_finish)
+  , m_startToFinishDistanceM(starter.m_startToFinishDistanceM)
+  , m_fake(starter.m_fake)
+  , m_guides(starter.m_guides)
+  , m_fakeNumerationStart(starter.m_fakeNumerationStart)
+  , m_otherEndings(starter.m_otherEndings)
+  , m_regionsGraph(starter.m_regionsGraph)
+{
+  if (m_regionsGraph)
+    m_graph.SetRegionsGraphMode(true);
+}
+
 void IndexGraphStarter::Append(FakeEdgesContainer const & container)
 {
   m_finish = container.m_finish;
@@ -344,6 +359,26 @@ double IndexGraphStarter::CalculateETAWithoutPenalty(Segment const & segment) co
   return m_graph.CalculateETAWithoutPenalty(segment);
 }
 
+double IndexGraphStarter::CalcETAFactor(Segment const & segment, double secondsFromDeparture) const
+{
+  if (IsFakeSegment(segment) || IsGuidesSegment(segment) || IsRegionsGraphMode())
+    return 1.0;
+
+  return m_graph.CalcETAFactor(segment, secondsFromDeparture);
+}
+
+double IndexGraphStarter::CalcTransitWaitingTime(Segment const & from, Segment const & to,
+                                                 time_t time) const
+{
+  if (IsFakeSegment(from) || IsFakeSegment(to) || IsGuidesSegment(from) || IsGuidesSegment(to) ||
+      IsRegionsGraphMode())
+  {
+    return 0.0;
+  }
+
+  return m_graph.CalcTransitWaitingTime(from, to, time);
+}
+
 void IndexGraphStarter::AddEnding(FakeEnding const & thisEnding)
 {
   Segment const dummy = Segment();
@@ -63,6 +63,10 @@ public:
   IndexGraphStarter(FakeEnding const & startEnding, FakeEnding const & finishEnding,
                     uint32_t fakeNumerationStart, bool strictForward, WorldGraph & graph);
 
+  // Copies fake vertices of |starter| to a starter on |graph|. |graph| should be a world graph
+  // with the same mode and mwms as the graph of |starter|, e.g. a graph for a separate thread.
+  IndexGraphStarter(IndexGraphStarter const & starter, WorldGraph & graph);
+
   void Append(FakeEdgesContainer const & container);
 
   void SetGuides(GuidesGraph const & guides);
@@ -163,6 +167,12 @@ public:
                                       EdgeEstimator::Purpose purpose) const;
   double CalculateETA(Segment const & from, Segment const & to) const;
   double CalculateETAWithoutPenalty(Segment const & segment) const;
+  /// \returns factor of CalculateETAWithoutPenalty() of |segment| which is entered
+  /// |secondsFromDeparture| seconds after the departure. It's 1.0 for fake and guides segments.
+  double CalcETAFactor(Segment const & segment, double secondsFromDeparture) const;
+  /// \returns seconds to wait for public transport going from |from| to |to| at |time|.
+  /// It's zero for fake and guides segments.
+  double CalcTransitWaitingTime(Segment const & from, Segment const & to, time_t time) const;
 
   // For compatibility with IndexGraphStarterJoints
   // @{
@@ -0,0 +1,99 @@
+#include "routing/index_graph_store.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+#include <utility>
+
+namespace routing
+{
+using namespace std;
+
+IndexGraphStore::IndexGraphStore(size_t memoryBudgetBytes) : m_memoryBudget(memoryBudgetBytes) {}
+
+IndexGraphStore::DataPtr IndexGraphStore::Get(Key const & key, Loader const & loader)
+{
+  {
+    lock_guard<mutex> lock(m_mutex);
+    auto const it = m_entries.find(key);
+    if (it != m_entries.cend())
+    {
+      m_usage.splice(m_usage.end(), m_usage, it->second.m_usage);
+      return it->second.m_data;
+    }
+  }
+
+  auto data = loader();
+  CHECK(data, (key.m_mwmPath));
+  size_t const memorySize = data->GetMemorySize();
+
+  lock_guard<mutex> lock(m_mutex);
+  // The same data may have been loaded by another thread meanwhile.
+  auto const [it, inserted] = m_entries.try_emplace(key);
+  if (!inserted)
+  {
+    m_usage.splice(m_usage.end(), m_usage, it->second.m_usage);
+    return it->second.m_data;
+  }
+
+  it->second.m_data = move(data);
+  it->second.m_memorySize = memorySize;
+  it->second.m_usage = m_usage.insert(m_usage.end(), key);
+  m_memorySize += memorySize;
+
+  // The handle is taken before shrinking to keep the new entry in the store.
+  auto result = it->second.m_data;
+  Shrink();
+  return result;
+}
+
+void IndexGraphStore::SetMemoryBudget(size_t memoryBudgetBytes)
+{
+  lock_guard<mutex> lock(m_mutex);
+  m_memoryBudget = memoryBudgetBytes;
+  Shrink();
+}
+
+size_t IndexGraphStore::GetMemorySize() const
+{
+  lock_guard<mutex> lock(m_mutex);
+  return m_memorySize;
+}
+
+size_t IndexGraphStore::GetSize() const
+{
+  lock_guard<mutex> lock(m_mutex);
+  return m_entries.size();
+}
+
+void IndexGraphStore::Clear()
+{
+  lock_guard<mutex> lock(m_mutex);
+  m_entries.clear();
+  m_usage.clear();
+  m_memorySize = 0;
+}
+
+void IndexGraphStore::Shrink()
+{
+  auto usageIt = m_usage.begin();
+  while (m_memorySize > m_memoryBudget && usageIt != m_usage.end())
+  {
+    auto const it = m_entries.find(*usageIt);
+    CHECK(it != m_entries.end(), ());
+
+    // Data which is used by a graph stays in memory anyway, so it's not evicted.
+    if (it->second.m_data.use_count() > 1)
+    {
+      ++usageIt;
+      continue;
+    }
+
+    LOG(LDEBUG, ("Index graph data of", it->first.m_mwmPath, "is evicted, size:",
+                 it->second.m_memorySize));
+    m_memorySize -= it->second.m_memorySize;
+    usageIt = m_usage.erase(usageIt);
+    m_entries.erase(it);
+  }
+}
+}  // namespace routing
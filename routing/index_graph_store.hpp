@@ -0,0 +1,75 @@
+#pragma once
+
+#include "routing/index_graph.hpp"
+#include "routing/vehicle_mask.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace routing
+{
+/// \brief Thread-safe store of IndexGraphData which lets routers of several threads share one
+/// copy of road and joint indexes and restrictions of an mwm. Entries are kept per mwm file and
+/// vehicle type. A caller gets a reference-counted handle, the data is immutable and alive
+/// while the handle is alive. If the memory budget is exceeded the least recently used entries
+/// which aren't held by anybody except the store are evicted.
+class IndexGraphStore final
+{
+public:
+  using DataPtr = std::shared_ptr<IndexGraphData const>;
+  using Loader = std::function<DataPtr()>;
+
+  struct Key
+  {
+    bool operator<(Key const & rhs) const
+    {
+      return std::tie(m_mwmPath, m_mwmVersion, m_vehicleType) <
+             std::tie(rhs.m_mwmPath, rhs.m_mwmVersion, rhs.m_vehicleType);
+    }
+
+    std::string m_mwmPath;
+    int64_t m_mwmVersion = 0;
+    VehicleType m_vehicleType = VehicleType::Count;
+  };
+
+  static size_t constexpr kDefaultMemoryBudgetBytes = 1024 * 1024 * 1024;
+
+  explicit IndexGraphStore(size_t memoryBudgetBytes = kDefaultMemoryBudgetBytes);
+
+  /// \returns data of |key|. If there's no such data in the store it's loaded by |loader|.
+  /// |loader| is called without the lock, so different mwms are loaded concurrently.
+  DataPtr Get(Key const & key, Loader const & loader);
+
+  void SetMemoryBudget(size_t memoryBudgetBytes);
+  size_t GetMemorySize() const;
+  size_t GetSize() const;
+
+  /// \brief Removes all the entries. Handles which are alive stay valid.
+  void Clear();
+
+private:
+  struct Entry
+  {
+    DataPtr m_data;
+    size_t m_memorySize = 0;
+    std::list<Key>::iterator m_usage;
+  };
+
+  // Evicts unused entries while the budget is exceeded. |m_mutex| must be locked.
+  void Shrink();
+
+  mutable std::mutex m_mutex;
+  size_t m_memoryBudget;
+  size_t m_memorySize = 0;
+  std::map<Key, Entry> m_entries;
+  // Keys from the least recently used to the most recently used.
+  std::list<Key> m_usage;
+};
+}  // namespace routing
@@ -1,6 +1,7 @@
 #include "routing/index_router.hpp"
 
 #include "routing/base/astar_progress.hpp"
+#include "routing/base/astar_search_state.hpp"
 #include "routing/base/bfs.hpp"
 #include "routing/car_directions.hpp"
 #include "routing/fake_ending.hpp"
@@ -13,6 +14,7 @@
 #include "routing/leaps_postprocessor.hpp"
 #include "routing/mwm_hierarchy_handler.hpp"
 #include "routing/pedestrian_directions.hpp"
+#include "routing/road_access.hpp"
 #include "routing/route.hpp"
 #include "routing/routing_exceptions.hpp"
 #include "routing/routing_helpers.hpp"
@@ -35,6 +37,7 @@
 #include "platform/mwm_traits.hpp"
 #include "platform/settings.hpp"
 
+#include "geometry/convex_hull.hpp"
 #include "geometry/distance_on_sphere.hpp"
 #include "geometry/mercator.hpp"
 #include "geometry/parametrized_segment.hpp"
@@ -42,21 +45,27 @@
 #include "geometry/segment2d.hpp"
 
 #include "base/assert.hpp"
+#include "base/checked_cast.hpp"
 #include "base/exception.hpp"
 #include "base/limited_priority_queue.hpp"
 #include "base/logging.hpp"
 #include "base/scope_guard.hpp"
 #include "base/stl_helpers.hpp"
+#include "base/thread_pool_computational.hpp"
+#include "base/timer.hpp"
 
 #include "defines.hpp"
 
 #include <algorithm>
 #include <cstdlib>
 #include <deque>
+#include <functional>
+#include <future>
 #include <iterator>
 #include <limits>
 #include <map>
 #include <optional>
+#include <unordered_map>
 
 namespace routing
 {
@@ -77,6 +86,18 @@ double constexpr kAdjustRangeM = 5000.0;
 // Full rebuild if distance(meters) is less.
 double constexpr kMinDistanceToFinishM = 10000;
 
+// The wave of a matrix row is limited by the weight of the way to the farthest target at
+// the maximum speed multiplied by the factor plus the minimum, so an unreachable target
+// doesn't make the wave cover the whole road graph.
+double constexpr kMatrixMaxWeightFactor = 4.0;
+double constexpr kMatrixMinMaxWeightSec = 30 * 60;
+
+// Turns depend on the route around them. So directions of a part of a route are generated on
+// a road graph which starts |kDirectionsLookBackM| earlier and finishes |kDirectionsLookAheadM|
+// later than the part.
+double constexpr kDirectionsLookBackM = 1000.0;
+double constexpr kDirectionsLookAheadM = 5000.0;
+
 double CalcMaxSpeed(NumMwmIds const & numMwmIds,
                     VehicleModelFactoryInterface const & vehicleModelFactory,
                     VehicleType vehicleType)
@@ -100,6 +121,97 @@ SpeedKMpH const & CalcOffroadSpeed(VehicleModelFactoryInterface const & vehicleM
   return vehicleModelFactory.GetVehicleModel()->GetOffroadSpeed();
 }
 
+// Lets A* pass through real segments of |corridor| only. Fake segments are always available.
+class CorridorGraph final : public AStarGraph<Segment, SegmentEdge, RouteWeight>
+{
+public:
+  CorridorGraph(IndexGraphStarter & starter, set<Segment> const & corridor)
+    : m_starter(starter), m_corridor(corridor)
+  {
+  }
+
+  // AStarGraph overrides:
+  // @{
+  Weight HeuristicCostEstimate(Vertex const & from, Vertex const & to) override
+  {
+    return m_starter.HeuristicCostEstimate(from, to);
+  }
+
+  void GetOutgoingEdgesList(astar::VertexData<Vertex, Weight> const & vertexData,
+                            EdgeListT & edges) override
+  {
+    m_starter.GetOutgoingEdgesList(vertexData, edges);
+    FilterEdges(edges);
+  }
+
+  void GetIngoingEdgesList(astar::VertexData<Vertex, Weight> const & vertexData,
+                           EdgeListT & edges) override
+  {
+    m_starter.GetIngoingEdgesList(vertexData, edges);
+    FilterEdges(edges);
+  }
+
+  void SetAStarParents(bool forward, Parents & parents) override
+  {
+    m_starter.SetAStarParents(forward, parents);
+  }
+
+  void DropAStarParents() override { m_starter.DropAStarParents(); }
+
+  bool AreWavesConnectible(Parents & forwardParents, Vertex const & commonVertex,
+                           Parents & backwardParents) override
+  {
+    return m_starter.AreWavesConnectible(forwardParents, commonVertex, backwardParents);
+  }
+
+  Weight GetAStarWeightEpsilon() override { return m_starter.GetAStarWeightEpsilon(); }
+  // @}
+
+private:
+  void FilterEdges(EdgeListT & edges) const
+  {
+    base::EraseIf(edges, [this](SegmentEdge const & edge) {
+      auto const & target = edge.GetTarget();
+      return !IndexGraphStarter::IsFakeSegment(target) && m_corridor.count(target) == 0;
+    });
+  }
+
+  IndexGraphStarter & m_starter;
+  set<Segment> const & m_corridor;
+};
+
+// Calls |f| for real segments which are the first (|isOutgoing| == true) or the last
+// (|isOutgoing| == false) real segments of routes from |ending|.
+template <typename F>
+void ForEachRealSegmentOfEnding(IndexGraphStarter const & starter, Segment const & ending,
+                                bool isOutgoing, F && f)
+{
+  set<Segment> visited = {ending};
+  vector<Segment> queue = {ending};
+  IndexGraphStarter::EdgeListT edges;
+  while (!queue.empty())
+  {
+    Segment const fake = queue.back();
+    queue.pop_back();
+
+    Segment real = fake;
+    if (starter.ConvertToReal(real))
+    {
+      f(real);
+      continue;
+    }
+
+    edges.clear();
+    starter.GetEdgesList(fake, isOutgoing, edges);
+    for (auto const & edge : edges)
+    {
+      auto const & target = edge.GetTarget();
+      if (IndexGraphStarter::IsFakeSegment(target) && visited.insert(target).second)
+        queue.push_back(target);
+    }
+  }
+}
+
 shared_ptr<VehicleModelFactoryInterface> CreateVehicleModelFactory(
     VehicleType vehicleType, CountryParentNameGetterFn const & countryParentNameGetterFn)
 {
@@ -170,6 +282,185 @@ bool IsTheSameSegments(m2::PointD const & seg1From, m2::PointD const & seg1To,
   return (seg1From == seg2From && seg1To == seg2To) || (seg1From == seg2To && seg1To == seg2From);
 }
 
+// Projection of a target of a matrix to a real segment.
+struct MatrixTarget
+{
+  size_t m_targetIdx;
+  LatLonWithAltitude m_projection;
+  LatLonWithAltitude m_point;
+};
+using MatrixTargets = unordered_map<Segment, vector<MatrixTarget>>;
+
+// Calls |f(target, part)| for every target of |targets| with a projection to |segment|.
+// |segment| is a real segment or a fake part of a real one, |part| is the part of |segment|
+// from its beginning to the projection.
+template <typename F>
+void ForEachMatrixTarget(IndexGraphStarter const & starter, MatrixTargets const & targets,
+                         Segment const & segment, F && f)
+{
+  Segment real = segment;
+  if (!starter.ConvertToReal(real))
+    return;
+
+  auto const it = targets.find(real);
+  if (it == targets.cend())
+    return;
+
+  auto const & from = starter.GetPoint(segment, false /* front */);
+  auto const & to = starter.GetPoint(segment, true /* front */);
+  double const length = ms::DistanceOnEarth(from, to);
+  for (auto const & target : it->second)
+  {
+    auto const & projection = target.m_projection.GetLatLon();
+    double const lengthToProjection = ms::DistanceOnEarth(from, projection);
+    // A fake part of a real segment may not contain the projection.
+    double constexpr kEpsM = 0.1;
+    if (IndexGraphStarter::IsFakeSegment(segment) &&
+        lengthToProjection + ms::DistanceOnEarth(projection, to) > length + kEpsM)
+    {
+      continue;
+    }
+
+    f(target, length == 0.0 ? 0.0 : min(lengthToProjection / length, 1.0));
+  }
+}
+
+// Calculates |row| of a matrix for the source of |starter|. Ways which are heavier than
+// |maxWeight| are not found.
+RouterResultCode CalculateMatrixRow(IndexGraphStarter & starter, MatrixTargets const & targets,
+                                    double maxWeight, RouterDelegate const & delegate,
+                                    vector<IndexRouter::MatrixRoute> & row)
+{
+  using Vertex = IndexGraphStarter::Vertex;
+  using Edge = IndexGraphStarter::Edge;
+  using Weight = IndexGraphStarter::Weight;
+
+  auto & graph = starter.GetGraph();
+  // Weight of the way from the beginning of |segment| to the target through |part| of |segment|.
+  auto const getTargetWeight = [&](Segment const & segment, MatrixTarget const & target,
+                                   double part, EdgeEstimator::Purpose purpose) {
+    return part * starter.CalcSegmentWeight(segment, purpose).GetWeight() +
+           graph.CalcOffroadWeight(target.m_projection.GetLatLon(), target.m_point.GetLatLon(),
+                                   purpose).GetWeight();
+  };
+
+  // A target on a segment is reached by an edge to the segment. The weight of the edge includes
+  // the weight of the whole segment, the rest of the segment after the projection is subtracted.
+  auto const reachTargets = [&](Vertex const & /* vertex */, Edge const & edge, auto && emit) {
+    auto const & segment = edge.GetTarget();
+    ForEachMatrixTarget(starter, targets, segment, [&](MatrixTarget const & target, double part) {
+      auto const segmentWeight =
+          starter.CalcSegmentWeight(segment, EdgeEstimator::Purpose::Weight).GetWeight();
+      emit(target.m_targetIdx,
+           edge.GetWeight() - RouteWeight(segmentWeight) +
+               RouteWeight(getTargetWeight(segment, target, part, EdgeEstimator::Purpose::Weight)));
+    });
+  };
+
+  using Visitor = JunctionVisitor<IndexGraphStarter>;
+  AStarAlgorithm<Vertex, Edge, Weight> algorithm;
+  AStarAlgorithm<Vertex, Edge, Weight>::Params<Visitor, MaxWeightLengthChecker> params(
+      starter, starter.GetStartSegment(), {} /* finalVertex */, delegate.GetCancellable(),
+      Visitor(starter, delegate, kVisitPeriod), MaxWeightLengthChecker(starter, maxWeight));
+
+  vector<RoutingResult<Vertex, Weight>> results;
+  auto const result = algorithm.FindPathsToTargets(params, row.size(), reachTargets, results);
+  if (result == AStarAlgorithm<Vertex, Edge, Weight>::Result::Cancelled)
+    return RouterResultCode::Cancelled;
+
+  for (size_t i = 0; i < row.size(); ++i)
+  {
+    auto const & path = results[i].m_path;
+    if (path.empty())
+      continue;
+
+    // The projection of the target which the route goes to.
+    MatrixTarget const * target = nullptr;
+    double part = 0.0;
+    double minWeight = numeric_limits<double>::max();
+    ForEachMatrixTarget(starter, targets, path.back(), [&](MatrixTarget const & t, double p) {
+      if (t.m_targetIdx != i)
+        return;
+
+      double const weight = getTargetWeight(path.back(), t, p, EdgeEstimator::Purpose::Weight);
+      if (weight < minWeight)
+      {
+        minWeight = weight;
+        target = &t;
+        part = p;
+      }
+    });
+    CHECK(target, (i, path.back()));
+
+    // The same as times and distances in RedressRoute() but the last segment is passed
+    // up to the projection of the target.
+    auto & route = row[i];
+    route.m_code = RouterResultCode::NoError;
+    route.m_etaSeconds = starter.CalculateETAWithoutPenalty(path.front());
+    for (size_t j = 1; j < path.size(); ++j)
+      route.m_etaSeconds += starter.CalculateETA(path[j - 1], path[j]);
+    route.m_etaSeconds += getTargetWeight(path.back(), *target, part, EdgeEstimator::Purpose::ETA) -
+                          starter.CalculateETAWithoutPenalty(path.back());
+
+    route.m_distanceMeters = 0.0;
+    for (auto const & segment : path)
+    {
+      route.m_distanceMeters += ms::DistanceOnEarth(starter.GetPoint(segment, false /* front */),
+                                                    starter.GetPoint(segment, true /* front */));
+    }
+    route.m_distanceMeters +=
+        ms::DistanceOnEarth(target->m_projection.GetLatLon(), target->m_point.GetLatLon()) -
+        (1.0 - part) * ms::DistanceOnEarth(starter.GetPoint(path.back(), false /* front */),
+                                           starter.GetPoint(path.back(), true /* front */));
+  }
+
+  return RouterResultCode::NoError;
+}
+
+// Returns the number of the first segments of the path |junctions| which are |distanceMeters| long
+// or the number of all the segments if the path is shorter.
+size_t GetPrefixSegmentsNumber(vector<geometry::PointWithAltitude> const & junctions,
+                               double distanceMeters)
+{
+  double distance = 0.0;
+  for (size_t i = 1; i < junctions.size(); ++i)
+  {
+    distance += mercator::DistanceOnEarth(junctions[i - 1].GetPoint(), junctions[i].GetPoint());
+    if (distance >= distanceMeters)
+      return i;
+  }
+  return junctions.size() - 1;
+}
+
+// Returns pairs of indexes of |input| leaps path, which are the end of the leap from start and
+// the beginning of the leap to finish, for all the variants of ProcessLeapsJoints().
+buffer_vector<pair<size_t, size_t>, 4> GetLeapsBegEnd(vector<Segment> const & input)
+{
+  buffer_vector<pair<size_t, size_t>, 4> arrBegEnd;
+  arrBegEnd.emplace_back(1, input.size() - 2);
+
+  auto const firstMwmId = input[1].GetMwmId();
+  auto const startLeapEndReverseIt = find_if(input.rbegin() + 2, input.rend(),
+                                             [firstMwmId](Segment const & s) { return s.GetMwmId() == firstMwmId; });
+  auto const startLeapEndIt = startLeapEndReverseIt.base() - 1;
+  auto const startLeapEnd = static_cast<size_t>(distance(input.begin(), startLeapEndIt));
+  if (startLeapEnd != arrBegEnd[0].first)
+    arrBegEnd.emplace_back(startLeapEnd, arrBegEnd[0].second);
+
+  // The last leap processed the same way. See the comment in ProcessLeapsJoints().
+  auto const lastMwmId = input[input.size() - 2].GetMwmId();
+  auto const finishLeapStartIt = find_if(startLeapEndIt, input.end(),
+                                         [lastMwmId](Segment const & s) { return s.GetMwmId() == lastMwmId; });
+  auto const finishLeapStart = static_cast<size_t>(distance(input.begin(), finishLeapStartIt));
+  if (finishLeapStart != arrBegEnd[0].second)
+    arrBegEnd.emplace_back(arrBegEnd[0].first, finishLeapStart);
+
+  if (arrBegEnd.size() == 3)
+    arrBegEnd.emplace_back(startLeapEnd, finishLeapStart);
+
+  return arrBegEnd;
+}
+
 bool IsDeadEnd(Segment const & segment, bool isOutgoing, bool useRoutingOptions,
                WorldGraph & worldGraph, set<Segment> & visitedSegments)
 {
@@ -252,6 +543,8 @@ IndexRouter::IndexRouter(VehicleType vehicleType, bool loadAltitudes,
   , m_loadAltitudes(loadAltitudes)
   , m_name("astar-bidirectional-" + ToString(m_vehicleType))
   , m_dataSource(dataSource, numMwmIds)
+  , m_backwardDataSource(dataSource, numMwmIds)
+  , m_directionsDataSource(dataSource, numMwmIds)
   , m_vehicleModelFactory(CreateVehicleModelFactory(m_vehicleType, countryParentNameGetterFn))
   , m_countryFileFn(countryFileFn)
   , m_countryRectFn(countryRectFn)
@@ -262,7 +555,7 @@ IndexRouter::IndexRouter(VehicleType vehicleType, bool loadAltitudes,
                 vehicleType == VehicleType::Pedestrian || vehicleType == VehicleType::Transit
                     ? IRoadGraph::Mode::IgnoreOnewayTag
                     : IRoadGraph::Mode::ObeyOnewayTag,
-                m_vehicleModelFactory)
+                m_vehicleModelFactory, m_vehicleType)
   , m_estimator(EdgeEstimator::Create(
         m_vehicleType, CalcMaxSpeed(*m_numMwmIds, *m_vehicleModelFactory, m_vehicleType),
         CalcOffroadSpeed(*m_vehicleModelFactory), m_trafficStash,
@@ -285,10 +578,21 @@ unique_ptr<WorldGraph> IndexRouter::MakeSingleMwmWorldGraph()
 }
 
 void IndexRouter::ClearState()
+{
+  m_pendingDirections.reset();
+  m_directionsDataSource.FreeHandles();
+  ClearBuffers();
+  // Storage of searches is kept by the thread between routes till the state is cleared.
+  astar::ClearSearchStatePools();
+}
+
+void IndexRouter::ClearBuffers()
 {
   m_roadGraph.ClearState();
   m_directionsEngine->Clear();
   m_dataSource.FreeHandles();
+  m_backwardGraph.reset();
+  m_backwardDataSource.FreeHandles();
 }
 
 bool IndexRouter::FindClosestProjectionToRoad(m2::PointD const & point,
@@ -332,6 +636,50 @@ bool IndexRouter::FindClosestProjectionToRoad(m2::PointD const & point,
 
 void IndexRouter::SetGuides(GuidesTracks && guides) { m_guides = GuidesConnections(guides); }
 
+bool IndexRouter::GeneratePendingDirections(base::Cancellable const & cancellable,
+                                            size_t & firstSegmentIdx,
+                                            vector<RouteSegment> & routeSegments)
+{
+  if (!m_pendingDirections)
+    return false;
+
+  RouteBuildStats::ScopedTimer statsTimer(&m_stats, RouteBuildStats::Phase::Directions);
+  auto const & pending = *m_pendingDirections;
+  IndexRoadGraph roadGraph(*pending.m_starter, pending.m_segments, pending.m_junctions,
+                           m_directionsDataSource);
+
+  m_directionsEngine->SetVehicleType(m_vehicleType);
+  vector<RouteSegment> graphSegments;
+  if (!m_directionsEngine->Generate(roadGraph, pending.m_junctions, cancellable, graphSegments) ||
+      cancellable.IsCancelled())
+  {
+    // The state is kept for the next attempt unless the generation is cancelled.
+    if (cancellable.IsCancelled())
+      ClearState();
+    return false;
+  }
+
+  CHECK_EQUAL(graphSegments.size(), pending.m_segments.size(), ());
+  CHECK_LESS_OR_EQUAL(pending.m_firstSegmentIdx, pending.m_firstPendingSegmentIdx, ());
+
+  // Turn indexes are indexes of points of the graph, the graph starts at |m_firstSegmentIdx|.
+  routeSegments.clear();
+  routeSegments.reserve(graphSegments.size());
+  for (size_t i = pending.m_firstPendingSegmentIdx - pending.m_firstSegmentIdx;
+       i < graphSegments.size(); ++i)
+  {
+    auto & segment = graphSegments[i];
+    auto turn = segment.GetTurn();
+    turn.m_index += base::asserted_cast<uint32_t>(pending.m_firstSegmentIdx);
+    segment.SetDirections(turn, segment.GetRoadNameInfo());
+    routeSegments.push_back(move(segment));
+  }
+  firstSegmentIdx = pending.m_firstPendingSegmentIdx;
+
+  ClearState();
+  return true;
+}
+
 RouterResultCode IndexRouter::CalculateRoute(Checkpoints const & checkpoints,
                                              m2::PointD const & startDirection,
                                              bool adjustToPrevRoute,
@@ -340,11 +688,17 @@ RouterResultCode IndexRouter::CalculateRoute(Checkpoints const & checkpoints,
   auto const & startPoint = checkpoints.GetStart();
   auto const & finalPoint = checkpoints.GetFinish();
 
+  m_stats.Clear();
+  m_pendingDirections.reset();
+  m_directionsDataSource.FreeHandles();
+  m_estimator->SetDepartureTime(m_timeDependentWeights ? make_optional(GetCurrentTimestamp())
+                                                       : nullopt);
   try
   {
+    // Directions which are left for GeneratePendingDirections() keep their graph.
     SCOPE_GUARD(featureRoadGraphClear, [this]
     {
-      ClearState();
+      ClearBuffers();
     });
 
     if (adjustToPrevRoute && m_lastRoute && m_lastFakeEdges &&
@@ -572,6 +926,12 @@ RouterResultCode IndexRouter::DoCalculateRoute(Checkpoints const & checkpoints,
 
   PointsOnEdgesSnapping snapping(*this, *graph);
   size_t const subroutesCount = checkpoints.GetNumSubroutes();
+
+  vector<vector<Segment>> alternatives;
+  // Alternatives are found by the bidirectional search which can't evaluate time-dependent weights.
+  bool const findAlternatives = m_alternativesNumber > 0 && !m_guides.IsAttached() &&
+                                !m_timeDependentWeights &&
+                                checkpoints.GetPassedIdx() + 1 == subroutesCount;
   for (size_t i = checkpoints.GetPassedIdx(); i < subroutesCount; ++i)
   {
     auto const & startCheckpoint = checkpoints.GetPoint(i);
@@ -587,6 +947,7 @@ RouterResultCode IndexRouter::DoCalculateRoute(Checkpoints const & checkpoints,
       bool const isLastSubroute = (i == subroutesCount - 1);
 
       bool startIsCodirectional = false;
+      RouteBuildStats::ScopedTimer statsTimer(&m_stats, RouteBuildStats::Phase::FakeEndings);
       switch (snapping.Snap(startCheckpoint, finishCheckpoint, startDirection,
                             startFakeEnding, finishFakeEnding, startIsCodirectional))
       {
@@ -622,7 +983,8 @@ RouterResultCode IndexRouter::DoCalculateRoute(Checkpoints const & checkpoints,
     SCOPE_GUARD(eraseProgress, [&progress]() { progress->PushAndDropLastSubProgress(); });
 
     auto const result = CalculateSubroute(checkpoints, i, delegate, progress, subrouteStarter,
-                                          subroute, m_guides.IsAttached());
+                                          subroute, m_guides.IsAttached(),
+                                          findAlternatives ? &alternatives : nullptr);
 
     if (result != RouterResultCode::NoError)
       return result;
@@ -664,10 +1026,44 @@ RouterResultCode IndexRouter::DoCalculateRoute(Checkpoints const & checkpoints,
   LOG(LINFO, ("Route length:", route.GetTotalDistanceMeters(), "meters. ETA:",
       route.GetTotalTimeSec(), "seconds."));
 
+  if (!alternatives.empty())
+  {
+    vector<shared_ptr<Route>> alternativeRoutes;
+    for (auto const & alternative : alternatives)
+    {
+      IndexGraphStarter::CheckValidRoute(alternative);
+
+      vector<Route::SubrouteAttrs> alternativeSubroutes;
+      PushPassedSubroutes(checkpoints, alternativeSubroutes);
+      alternativeSubroutes.emplace_back(starter->GetStartJunction().ToPointWithAltitude(),
+                                        starter->GetFinishJunction().ToPointWithAltitude(),
+                                        0 /* beginSegmentIdx */, alternative.size());
+
+      auto alternativeRoute = make_shared<Route>(route.GetRouterId(), route.GetRouteId());
+      alternativeRoute->SetCurrentSubrouteIdx(checkpoints.GetPassedIdx());
+      alternativeRoute->SetSubroteAttrs(move(alternativeSubroutes));
+
+      auto const alternativeResult = RedressRoute(alternative, delegate.GetCancellable(), *starter,
+                                                  *alternativeRoute, false /* pendingDirections */);
+      if (alternativeResult == RouterResultCode::Cancelled)
+        return alternativeResult;
+      if (alternativeResult != RouterResultCode::NoError)
+        continue;
+
+      LOG(LINFO, ("Alternative route length:", alternativeRoute->GetTotalDistanceMeters(),
+                  "meters. ETA:", alternativeRoute->GetTotalTimeSec(), "seconds."));
+      alternativeRoutes.push_back(move(alternativeRoute));
+    }
+    route.SetAlternatives(move(alternativeRoutes));
+  }
+
   m_lastRoute = make_unique<SegmentedRoute>(checkpoints.GetStart(), checkpoints.GetFinish(),
                                             route.GetSubroutes());
   for (Segment const & segment : segments)
-    m_lastRoute->AddStep(segment, mercator::FromLatLon(starter->GetPoint(segment, true /* front */)));
+  {
+    m_lastRoute->AddStep(segment, mercator::FromLatLon(starter->GetPoint(segment, true /* front */)),
+                         starter->CalcSegmentWeight(segment, EdgeEstimator::Purpose::Weight));
+  }
 
   m_lastFakeEdges = make_unique<FakeEdgesContainer>(move(*starter));
 
@@ -705,7 +1101,8 @@ RouterResultCode IndexRouter::CalculateSubroute(Checkpoints const & checkpoints,
                                                 shared_ptr<AStarProgress> const & progress,
                                                 IndexGraphStarter & starter,
                                                 vector<Segment> & subroute,
-                                                bool guidesActive /* = false */)
+                                                bool guidesActive /* = false */,
+                                                vector<vector<Segment>> * alternatives /* = nullptr */)
 {
   subroute.clear();
 
@@ -715,10 +1112,11 @@ RouterResultCode IndexRouter::CalculateSubroute(Checkpoints const & checkpoints,
   LOG(LINFO, ("Routing in mode:", mode));
 
   base::ScopedTimerWithLog timer("Route build");
+  RouteBuildStats::ScopedTimer statsTimer(&m_stats, RouteBuildStats::Phase::AStar);
   switch (mode)
   {
   case WorldGraphMode::Joints:
-    return CalculateSubrouteJointsMode(starter, delegate, progress, subroute);
+    return CalculateSubrouteJointsMode(starter, delegate, progress, subroute, alternatives);
   case WorldGraphMode::NoLeaps:
     return CalculateSubrouteNoLeapsMode(starter, delegate, progress, subroute);
   case WorldGraphMode::LeapsOnly:
@@ -731,8 +1129,52 @@ RouterResultCode IndexRouter::CalculateSubroute(Checkpoints const & checkpoints,
 
 RouterResultCode IndexRouter::CalculateSubrouteJointsMode(
     IndexGraphStarter & starter, RouterDelegate const & delegate,
-    shared_ptr<AStarProgress> const & progress, vector<Segment> & subroute)
+    shared_ptr<AStarProgress> const & progress, vector<Segment> & subroute,
+    vector<vector<Segment>> * alternatives /* = nullptr */)
 {
+  if (m_vehicleType == VehicleType::Car)
+  {
+    auto const result = CalculateSubrouteContractionMode(starter, delegate, progress, subroute);
+    if (result == RouterResultCode::Cancelled)
+      return result;
+    if (result == RouterResultCode::NoError)
+    {
+      // The route is found by the hierarchy, alternatives are found by a separate search.
+      // The route is kept if the search fails.
+      if (alternatives)
+      {
+        vector<vector<Segment>> routes;
+        if (CalculateAlternativesJointsMode(starter, delegate, progress, routes) ==
+            RouterResultCode::Cancelled)
+        {
+          return RouterResultCode::Cancelled;
+        }
+
+        // The best route of the search is the route of the hierarchy. If there are several routes
+        // of the same weight, the route of the hierarchy may be among the alternatives.
+        for (size_t i = 1; i < routes.size(); ++i)
+        {
+          if (routes[i] != subroute)
+            alternatives->push_back(move(routes[i]));
+        }
+      }
+      return result;
+    }
+  }
+
+  if (alternatives)
+  {
+    vector<vector<Segment>> routes;
+    auto const result = CalculateAlternativesJointsMode(starter, delegate, progress, routes);
+    if (result != RouterResultCode::NoError)
+      return result;
+
+    subroute = move(routes.front());
+    for (size_t i = 1; i < routes.size(); ++i)
+      alternatives->push_back(move(routes[i]));
+    return result;
+  }
+
   using JointsStarter = IndexGraphStarterJoints<IndexGraphStarter>;
   JointsStarter jointStarter(starter, starter.GetStartSegment(), starter.GetFinishSegment());
 
@@ -747,6 +1189,25 @@ RouterResultCode IndexRouter::CalculateSubrouteJointsMode(
       jointStarter, jointStarter.GetStartJoint(), jointStarter.GetFinishJoint(),
       delegate.GetCancellable(), move(visitor),
       AStarLengthChecker(starter));
+  auto const heuristic = MakeLandmarkHeuristic(starter, jointStarter, starter.GetStartSegment(),
+                                               starter.GetFinishSegment());
+  params.m_heuristic = heuristic.get();
+
+  auto const backward = MakeBackwardStarter(starter);
+  optional<JointsStarter> backwardJointStarter;
+  unique_ptr<LandmarkHeuristic> backwardHeuristic;
+  if (backward)
+  {
+    auto & backwardStarter = *backward;
+    backwardJointStarter.emplace(backwardStarter, backwardStarter.GetStartSegment(),
+                                 backwardStarter.GetFinishSegment());
+    backwardHeuristic = MakeLandmarkHeuristic(backwardStarter, *backwardJointStarter,
+                                              backwardStarter.GetStartSegment(),
+                                              backwardStarter.GetFinishSegment());
+    params.m_backwardGraph = &*backwardJointStarter;
+    params.m_backwardHeuristic = backwardHeuristic.get();
+    params.m_backwardCheckLengthCallback.emplace(backwardStarter);
+  }
 
   RoutingResult<Vertex, Weight> routingResult;
   RouterResultCode const result = FindPath<Vertex, Edge, Weight>(params, {} /* mwmIds */, routingResult);
@@ -759,6 +1220,241 @@ RouterResultCode IndexRouter::CalculateSubrouteJointsMode(
   return result;
 }
 
+RouterResultCode IndexRouter::CalculateAlternativesJointsMode(
+    IndexGraphStarter & starter, RouterDelegate const & delegate,
+    shared_ptr<AStarProgress> const & progress, vector<vector<Segment>> & routes)
+{
+  routes.clear();
+
+  using JointsStarter = IndexGraphStarterJoints<IndexGraphStarter>;
+  JointsStarter jointStarter(starter, starter.GetStartSegment(), starter.GetFinishSegment());
+
+  using Visitor = JunctionVisitor<JointsStarter>;
+  Visitor visitor(jointStarter, delegate, kVisitPeriod, progress);
+
+  using Vertex = JointsStarter::Vertex;
+  using Edge = JointsStarter::Edge;
+  using Weight = JointsStarter::Weight;
+
+  AStarAlgorithm<Vertex, Edge, Weight>::Params<Visitor, AStarLengthChecker> params(
+      jointStarter, jointStarter.GetStartJoint(), jointStarter.GetFinishJoint(),
+      delegate.GetCancellable(), move(visitor),
+      AStarLengthChecker(starter));
+  auto const heuristic = MakeLandmarkHeuristic(starter, jointStarter, starter.GetStartSegment(),
+                                               starter.GetFinishSegment());
+  params.m_heuristic = heuristic.get();
+
+  AStarAlgorithm<Vertex, Edge, Weight> algorithm;
+  AStarAlgorithm<Vertex, Edge, Weight>::AlternativesParams altParams;
+  altParams.m_maxAlternatives = m_alternativesNumber;
+
+  vector<RoutingResult<Vertex, Weight>> routingResults;
+  auto const result = ConvertResult<Vertex, Edge, Weight>(
+      algorithm.FindPathBidirectionalAlternatives(params, altParams, routingResults));
+  m_stats.AddSettledVertices(params.m_onVisitedVertexCallback.GetVisitsNumber());
+  if (result != RouterResultCode::NoError)
+    return result;
+
+  LOG(LDEBUG, ("Result route weight:", routingResults.front().m_distance, "alternatives:",
+               routingResults.size() - 1));
+  for (auto const & routingResult : routingResults)
+    routes.push_back(ProcessJoints(routingResult.m_path, jointStarter));
+  return result;
+}
+
+RouterResultCode IndexRouter::CalculateSubrouteContractionMode(
+    IndexGraphStarter & starter, RouterDelegate const & delegate,
+    shared_ptr<AStarProgress> const & progress, vector<Segment> & subroute)
+{
+  using Vertex = IndexGraphStarter::Vertex;
+  using Edge = IndexGraphStarter::Edge;
+  using Weight = IndexGraphStarter::Weight;
+  using ChVertex = JointContractionHierarchy::Vertex;
+
+  if (!m_contractionHierarchyEnabled)
+    return RouterResultCode::RouteNotFound;
+
+  // Contraction hierarchy is built without traffic, speed profiles and avoid routing options.
+  auto const & mwmIds = starter.GetStartMwms();
+  if (mwmIds.size() != 1 || mwmIds != starter.GetFinishMwms())
+    return RouterResultCode::RouteNotFound;
+
+  NumMwmId const mwmId = *mwmIds.begin();
+  if (m_trafficStash && m_trafficStash->Has(mwmId))
+    return RouterResultCode::RouteNotFound;
+  if (m_timeDependentWeights &&
+      m_dataSource.GetSectionStatus(mwmId, SPEED_PROFILES_FILE_TAG) == MwmDataSource::SectionExists)
+  {
+    return RouterResultCode::RouteNotFound;
+  }
+  if (RoutingOptions::LoadCarOptionsFromSettings().GetOptions() != 0)
+    return RouterResultCode::RouteNotFound;
+
+  auto const * hierarchy = GetContractionHierarchy(mwmId);
+  if (!hierarchy)
+    return RouterResultCode::RouteNotFound;
+
+  // Weight of the piece of |segment| from |segment| to the end of the piece. |segment| itself
+  // is included if |inclusive| is true.
+  auto const calcWeightToPieceEnd = [&](ChVertex v, Segment const & segment, bool inclusive) {
+    double weight = 0.0;
+    bool found = false;
+    hierarchy->ForEachSegment(v, mwmId, [&](Segment const & s) {
+      if (s == segment)
+        found = true;
+      if (found && (inclusive || s != segment))
+        weight += starter.CalcSegmentWeight(s, EdgeEstimator::Purpose::Weight).GetIntegratedWeight();
+    });
+    return weight;
+  };
+
+  vector<ContractionHierarchy::Ending> sources;
+  ForEachRealSegmentOfEnding(starter, starter.GetStartSegment(), true /* isOutgoing */,
+                             [&](Segment const & s) {
+    ChVertex const v = hierarchy->GetVertex(s);
+    if (v != ContractionHierarchy::kInvalidVertex)
+      sources.emplace_back(v, calcWeightToPieceEnd(v, s, false /* inclusive */));
+  });
+
+  // A path in the hierarchy includes the whole last piece, so the rest of the piece after
+  // the finish is subtracted.
+  vector<ContractionHierarchy::Ending> targets;
+  ForEachRealSegmentOfEnding(starter, starter.GetFinishSegment(), false /* isOutgoing */,
+                             [&](Segment const & s) {
+    ChVertex const v = hierarchy->GetVertex(s);
+    if (v != ContractionHierarchy::kInvalidVertex)
+      targets.emplace_back(v, -calcWeightToPieceEnd(v, s, true /* inclusive */));
+  });
+
+  if (sources.empty() || targets.empty())
+    return RouterResultCode::RouteNotFound;
+
+  // Start and finish on the same piece are left for the ordinary search.
+  for (auto const & source : sources)
+  {
+    for (auto const & target : targets)
+    {
+      if (source.first == target.first)
+        return RouterResultCode::RouteNotFound;
+    }
+  }
+
+  RoutingResult<ChVertex, double> chResult;
+  switch (hierarchy->GetHierarchy().FindPath(sources, targets, delegate.GetCancellable(), chResult))
+  {
+  case ContractionHierarchy::Result::OK: break;
+  case ContractionHierarchy::Result::NoPath: return RouterResultCode::RouteNotFound;
+  case ContractionHierarchy::Result::Cancelled: return RouterResultCode::Cancelled;
+  }
+
+  set<Segment> corridor;
+  for (auto const v : chResult.m_path)
+    hierarchy->ForEachSegment(v, mwmId, [&corridor](Segment const & s) { corridor.insert(s); });
+
+  CorridorGraph graph(starter, corridor);
+  using Visitor = JunctionVisitor<IndexGraphStarter>;
+  Visitor visitor(starter, delegate, kVisitPeriod, progress);
+
+  AStarAlgorithm<Vertex, Edge, Weight>::Params<Visitor, AStarLengthChecker> params(
+      graph, starter.GetStartSegment(), starter.GetFinishSegment(), delegate.GetCancellable(),
+      move(visitor), AStarLengthChecker(starter));
+
+  RoutingResult<Vertex, Weight> routingResult;
+  RouterResultCode const result = FindPath<Vertex, Edge, Weight>(params, {} /* mwmIds */, routingResult);
+  if (result != RouterResultCode::NoError)
+  {
+    LOG(LDEBUG, ("Route in contraction hierarchy corridor is not found:", result));
+    return result;
+  }
+
+  LOG(LDEBUG, ("Contraction hierarchy route weight:", routingResult.m_distance, "corridor size:",
+               corridor.size()));
+  subroute = move(routingResult.m_path);
+  return RouterResultCode::NoError;
+}
+
+JointContractionHierarchy const * IndexRouter::GetContractionHierarchy(NumMwmId mwmId)
+{
+  auto it = m_contractionHierarchies.find(mwmId);
+  if (it == m_contractionHierarchies.end())
+  {
+    unique_ptr<JointContractionHierarchy> hierarchy;
+    if (m_dataSource.GetSectionStatus(mwmId, ROUTING_CH_FILE_TAG) == MwmDataSource::SectionExists)
+      hierarchy = LoadJointContractionHierarchy(m_dataSource.GetMwmValue(mwmId));
+
+    // nullptr is cached too to avoid checking the section for every route.
+    it = m_contractionHierarchies.emplace(mwmId, move(hierarchy)).first;
+  }
+  return it->second.get();
+}
+
+JointLandmarks const * IndexRouter::GetJointLandmarks(NumMwmId mwmId)
+{
+  auto it = m_landmarks.find(mwmId);
+  if (it == m_landmarks.end())
+  {
+    unique_ptr<JointLandmarks> landmarks;
+    if (m_dataSource.GetSectionStatus(mwmId, ROUTING_LANDMARKS_FILE_TAG) == MwmDataSource::SectionExists)
+      landmarks = LoadJointLandmarks(m_dataSource.GetMwmValue(mwmId));
+
+    it = m_landmarks.emplace(mwmId, move(landmarks)).first;
+  }
+  return it->second.get();
+}
+
+unique_ptr<LandmarkHeuristic> IndexRouter::MakeLandmarkHeuristic(
+    IndexGraphStarter const & starter, IndexGraphStarterJoints<IndexGraphStarter> & jointStarter,
+    Segment const & start, Segment const & finish)
+{
+  // Landmark distances are calculated by car weights, they are not lower bounds for
+  // other vehicles.
+  if (m_vehicleType != VehicleType::Car)
+    return nullptr;
+
+  auto const makeEnding = [&](Segment const & ending, bool isStart) {
+    vector<Segment> segments;
+    ForEachRealSegmentOfEnding(starter, ending, isStart /* isOutgoing */,
+                               [&segments](Segment const & s) { segments.push_back(s); });
+    if (segments.empty())
+      return LandmarkHeuristic::Ending();
+
+    NumMwmId const mwmId = segments.front().GetMwmId();
+    auto const * landmarks = GetJointLandmarks(mwmId);
+    if (!landmarks)
+      return LandmarkHeuristic::Ending();
+
+    LandmarkHeuristic::Ending result;
+    result.m_mwmId = mwmId;
+    result.m_landmarks = landmarks;
+    for (auto const & segment : segments)
+    {
+      // The bound is a minimum over all pieces of the ending, it's not a bound without any of them.
+      auto const v = landmarks->GetVertex(segment);
+      if (segment.GetMwmId() != mwmId || v == RoadPieces::kInvalidVertex)
+        return LandmarkHeuristic::Ending();
+
+      double weight = 0.0;
+      if (!isStart)
+      {
+        landmarks->GetPieces().ForEachSegment(v, mwmId, [&](Segment const & s) {
+          weight += starter.CalcSegmentWeight(s, EdgeEstimator::Purpose::Weight).GetWeight();
+        });
+      }
+      result.m_vertices.emplace_back(v, weight);
+    }
+    return result;
+  };
+
+  auto startEnding = makeEnding(start, true /* isStart */);
+  auto finishEnding = makeEnding(finish, false /* isStart */);
+  if (startEnding.IsEmpty() && finishEnding.IsEmpty())
+    return nullptr;
+
+  return make_unique<LandmarkHeuristic>(jointStarter, jointStarter.GetStartJoint(),
+                                        jointStarter.GetFinishJoint(), move(startEnding),
+                                        move(finishEnding));
+}
+
 RouterResultCode IndexRouter::CalculateSubrouteNoLeapsMode(
     IndexGraphStarter & starter, RouterDelegate const & delegate,
     shared_ptr<AStarProgress> const & progress, vector<Segment> & subroute)
@@ -774,6 +1470,13 @@ RouterResultCode IndexRouter::CalculateSubrouteNoLeapsMode(
       starter, starter.GetStartSegment(), starter.GetFinishSegment(),
       delegate.GetCancellable(), move(visitor), AStarLengthChecker(starter));
 
+  auto const backward = MakeBackwardStarter(starter);
+  if (backward)
+  {
+    params.m_backwardGraph = backward.get();
+    params.m_backwardCheckLengthCallback.emplace(*backward);
+  }
+
   RoutingResult<Vertex, Weight> routingResult;
   set<NumMwmId> const mwmIds = starter.GetMwms();
   RouterResultCode const result = FindPath<Vertex, Edge, Weight>(params, mwmIds, routingResult);
@@ -797,6 +1500,7 @@ RouterResultCode IndexRouter::CalculateSubrouteLeapsOnlyMode(
   // Get cross-mwm routes-candidates.
   std::vector<RoutingResultT> candidates;
   {
+    RouteBuildStats::ScopedTimer statsTimer(&m_stats, RouteBuildStats::Phase::LeapsSearch);
     LeapsGraph leapsGraph(starter, MwmHierarchyHandler(m_numMwmIds, m_countryParentNameGetterFn));
 
     AStarSubProgress leapsProgress(mercator::ToLatLon(checkpoints.GetPoint(subrouteIdx)),
@@ -824,6 +1528,15 @@ RouterResultCode IndexRouter::CalculateSubrouteLeapsOnlyMode(
       return false;
     };
 
+    auto const backward = MakeBackwardStarter(starter);
+    unique_ptr<LeapsGraph> backwardLeapsGraph;
+    if (backward)
+    {
+      backwardLeapsGraph = make_unique<LeapsGraph>(
+          *backward, MwmHierarchyHandler(m_numMwmIds, m_countryParentNameGetterFn));
+      params.m_backwardGraph = backwardLeapsGraph.get();
+    }
+
     std::set<std::pair<Vertex, Vertex>> edges;
     std::set<Vertex> keys[2];    // 0 - end vertex of the first edge; 1 - beg vertex of the last edge
 
@@ -858,6 +1571,7 @@ RouterResultCode IndexRouter::CalculateSubrouteLeapsOnlyMode(
 
       return keys[0].size() >= maxVertices && keys[1].size() >= maxVertices;
     });
+    m_stats.AddSettledVertices(params.m_onVisitedVertexCallback.GetVisitsNumber());
 
     if (routes.empty() || result == AlgoT::Result::Cancelled)
       return ConvertResult<Vertex, Edge, Weight>(result);
@@ -877,6 +1591,9 @@ RouterResultCode IndexRouter::CalculateSubrouteLeapsOnlyMode(
 
   RoutingResultT result;
   RoutesCacheT cache;
+  if (m_leapsThreadsNumber > 1)
+    CalculateLeapsSubroutes(candidates, delegate, starter, cache);
+
   for (auto const & e : candidates)
   {
     LOG(LDEBUG, ("Process leaps:", e.m_distance, e.m_path));
@@ -931,12 +1648,11 @@ RouterResultCode IndexRouter::AdjustRoute(Checkpoints const & checkpoints,
 
   vector<SegmentEdge> prevEdges;
   CHECK_LESS_OR_EQUAL(lastSubroute.GetEndSegmentIdx(), steps.size(), ());
+  prevEdges.reserve(lastSubroute.GetEndSegmentIdx() - lastSubroute.GetBeginSegmentIdx());
+  // Weights are calculated when the route is built, so geometry of the whole route is not loaded
+  // again on every adjustment.
   for (size_t i = lastSubroute.GetBeginSegmentIdx(); i < lastSubroute.GetEndSegmentIdx(); ++i)
-  {
-    auto const & step = steps[i];
-    prevEdges.emplace_back(step.GetSegment(), starter.CalcSegmentWeight(step.GetSegment(),
-                           EdgeEstimator::Purpose::Weight));
-  }
+    prevEdges.emplace_back(steps[i].GetSegment(), steps[i].GetWeight());
 
   using Visitor = JunctionVisitor<IndexGraphStarter>;
   Visitor visitor(starter, delegate, kVisitPeriod);
@@ -994,7 +1710,252 @@ RouterResultCode IndexRouter::AdjustRoute(Checkpoints const & checkpoints,
   return RouterResultCode::NoError;
 }
 
+RouterResultCode IndexRouter::CalculateMatrix(vector<m2::PointD> const & sources,
+                                              vector<m2::PointD> const & targets,
+                                              RouterDelegate const & delegate, Matrix & matrix)
+{
+  base::Timer timer;
+  matrix.assign(sources.size(), vector<MatrixRoute>(targets.size()));
+
+  TrafficStash::Guard guard(m_trafficStash);
+  auto graph = MakeWorldGraph(m_dataSource, &m_stats, false /* withTransit */);
+  graph->SetMode(WorldGraphMode::NoLeaps);
+
+  // Both directions of two-way segments are added for the targets as for a finish of a route.
+  MatrixTargets matrixTargets;
+  for (size_t i = 0; i < targets.size(); ++i)
+  {
+    PointsOnEdgesSnapping snapping(*this, *graph);
+    vector<Segment> segments;
+    bool dummy = false;
+    if (!snapping.FindBestSegments(targets[i], m2::PointD::Zero() /* direction */,
+                                   false /* isOutgoing */, segments, dummy))
+    {
+      for (auto & row : matrix)
+        row[i].m_code = RouterResultCode::EndPointNotFound;
+      continue;
+    }
+
+    auto const ending = MakeFakeEnding(segments, targets[i], *graph);
+    for (auto const & projection : ending.m_projections)
+    {
+      MatrixTarget const target = {i, projection.m_junction, ending.m_originJunction};
+      auto const & segment = projection.m_segment;
+      matrixTargets[segment].push_back(target);
+      if (!projection.m_isOneWay)
+      {
+        matrixTargets[Segment(segment.GetMwmId(), segment.GetFeatureId(), segment.GetSegmentIdx(),
+                              !segment.IsForward())]
+            .push_back(target);
+      }
+    }
+  }
+
+  // No target is snapped to roads.
+  if (matrixTargets.empty())
+    return RouterResultCode::NoError;
+
+  for (size_t i = 0; i < sources.size(); ++i)
+  {
+    if (delegate.IsCancelled())
+      return RouterResultCode::Cancelled;
+
+    PointsOnEdgesSnapping snapping(*this, *graph);
+    vector<Segment> segments;
+    bool dummy = false;
+    if (!snapping.FindBestSegments(sources[i], m2::PointD::Zero() /* direction */,
+                                   true /* isOutgoing */, segments, dummy))
+    {
+      for (auto & route : matrix[i])
+        route.m_code = RouterResultCode::StartPointNotFound;
+      continue;
+    }
+
+    // The finish of the starter has no projections and is placed at the farthest target,
+    // so the length checks of the starter are the same as for a route to it.
+    auto const source = mercator::ToLatLon(sources[i]);
+    FakeEnding farthestFinish{};
+    double maxDistanceM = -1.0;
+    for (auto const & [segment, segmentTargets] : matrixTargets)
+    {
+      for (auto const & target : segmentTargets)
+      {
+        double const distanceM = ms::DistanceOnEarth(source, target.m_point.GetLatLon());
+        if (distanceM > maxDistanceM)
+        {
+          maxDistanceM = distanceM;
+          farthestFinish.m_originJunction = target.m_point;
+        }
+      }
+    }
+
+    IndexGraphStarter starter(MakeFakeEnding(segments, sources[i], *graph), farthestFinish,
+                              0 /* fakeNumerationStart */, false /* strictForward */, *graph);
+    double const maxWeight =
+        kMatrixMinMaxWeightSec +
+        kMatrixMaxWeightFactor *
+            starter.HeuristicCostEstimate(starter.GetStartSegment(),
+                                          farthestFinish.m_originJunction.GetLatLon())
+                .GetWeight();
+    if (CalculateMatrixRow(starter, matrixTargets, maxWeight, delegate, matrix[i]) ==
+        RouterResultCode::Cancelled)
+    {
+      return RouterResultCode::Cancelled;
+    }
+  }
+
+  LOG(LINFO, ("Matrix", sources.size(), "x", targets.size(), "is calculated in",
+              timer.ElapsedSeconds(), "seconds."));
+  return RouterResultCode::NoError;
+}
+
+RouterResultCode IndexRouter::CalculateTransitJourney(m2::PointD const & start,
+                                                      m2::PointD const & finish,
+                                                      time_t departureTime,
+                                                      RouterDelegate const & delegate,
+                                                      TransitRaptor::Journey & journey)
+{
+  CHECK_EQUAL(m_vehicleType, VehicleType::Transit, ());
+  base::Timer timer;
+  journey = {};
+
+  auto const startCountry = platform::CountryFile(m_countryFileFn(start));
+  auto const finishCountry = platform::CountryFile(m_countryFileFn(finish));
+  if (startCountry.IsEmpty() || !m_dataSource.IsLoaded(startCountry))
+    return RouterResultCode::StartPointNotFound;
+  if (finishCountry.IsEmpty() || !m_dataSource.IsLoaded(finishCountry))
+    return RouterResultCode::EndPointNotFound;
+  if (startCountry != finishCountry)
+    return RouterResultCode::RouteNotFound;
+
+  auto graph = MakeWorldGraph();
+  auto const raptor = graph->GetTransitRaptor(m_numMwmIds->GetId(startCountry));
+  if (!raptor)
+    return RouterResultCode::TransitRouteNotFoundNoNetwork;
+
+  auto const access = raptor->FindAccessLegs(*this, start, kTransitAccessRadiusM,
+                                             true /* toStops */, delegate);
+  if (delegate.IsCancelled())
+    return RouterResultCode::Cancelled;
+  auto const egress = raptor->FindAccessLegs(*this, finish, kTransitAccessRadiusM,
+                                             false /* toStops */, delegate);
+  if (delegate.IsCancelled())
+    return RouterResultCode::Cancelled;
+  if (access.empty() || egress.empty())
+    return RouterResultCode::TransitRouteNotFoundTooLongPedestrian;
+
+  if (!raptor->FindEarliestArrival(access, egress, departureTime,
+                                   TransitRaptor::kDefaultMaxTransfers, journey))
+  {
+    return RouterResultCode::RouteNotFound;
+  }
+
+  LOG(LINFO, ("Transit journey with", journey.GetRidesNumber(), "rides is found in",
+              timer.ElapsedSeconds(), "seconds."));
+  return RouterResultCode::NoError;
+}
+
+RouterResultCode IndexRouter::CalculateIsochrone(m2::PointD const & point, double maxWeightSeconds,
+                                                 size_t maxSegmentsNumber,
+                                                 RouterDelegate const & delegate,
+                                                 Isochrone & isochrone)
+{
+  base::Timer timer;
+  isochrone = {};
+
+  TrafficStash::Guard guard(m_trafficStash);
+  auto graph = MakeWorldGraph();
+  graph->SetMode(WorldGraphMode::NoLeaps);
+
+  PointsOnEdgesSnapping snapping(*this, *graph);
+  vector<Segment> segments;
+  bool dummy = false;
+  if (!snapping.FindBestSegments(point, m2::PointD::Zero() /* direction */, true /* isOutgoing */,
+                                 segments, dummy))
+  {
+    return RouterResultCode::StartPointNotFound;
+  }
+
+  FakeEnding dummyFinish{};
+  IndexGraphStarter starter(MakeFakeEnding(segments, point, *graph), dummyFinish,
+                            0 /* fakeNumerationStart */, false /* strictForward */, *graph);
+
+  using Algorithm = AStarAlgorithm<Segment, SegmentEdge, RouteWeight>;
+  Algorithm algorithm;
+  Algorithm::Context context(starter);
+  JunctionVisitor<IndexGraphStarter> visitor(starter, delegate, kVisitPeriod);
+
+  auto const startSegment = starter.GetStartSegment();
+  vector<m2::PointD> points = {point};
+  size_t segmentsNumber = 0;
+  bool isCancelled = false;
+
+  auto const visitVertex = [&](Segment const & vertex) {
+    if (segmentsNumber % kVisitPeriod == 0 && delegate.IsCancelled())
+    {
+      isCancelled = true;
+      return false;
+    }
+
+    if (segmentsNumber == maxSegmentsNumber)
+    {
+      isochrone.m_isTruncated = true;
+      return false;
+    }
+
+    ++segmentsNumber;
+    // There's no final vertex, the visitor has no progress, so only |vertex| matters.
+    visitor(vertex, startSegment);
+
+    if (!IndexGraphStarter::IsFakeSegment(vertex))
+      isochrone.m_segments.emplace_back(vertex, context.GetDistance(vertex).GetWeight());
+
+    points.push_back(mercator::FromLatLon(starter.GetPoint(vertex, true /* front */)));
+    return true;
+  };
+
+  auto const adjustEdgeWeight = [&](Segment const & vertex, SegmentEdge const & edge) {
+    auto const & weight = edge.GetWeight();
+    double const distance = context.GetDistance(vertex).GetWeight();
+    if (distance + weight.GetWeight() > maxWeightSeconds && weight.GetWeight() > 0.0)
+    {
+      // The time limit is reached inside the segment, the reachable part of it is added.
+      auto const & target = edge.GetTarget();
+      auto const from = mercator::FromLatLon(starter.GetPoint(target, false /* front */));
+      auto const to = mercator::FromLatLon(starter.GetPoint(target, true /* front */));
+      double const part = (maxWeightSeconds - distance) / weight.GetWeight();
+      points.push_back(from + (to - from) * part);
+    }
+    return weight;
+  };
+
+  auto const filterStates = [&](auto const & state) {
+    return state.distance.GetWeight() <= maxWeightSeconds;
+  };
+
+  auto const reducedToRealLength = [](auto const & state) { return state.distance; };
+
+  algorithm.PropagateWave(starter, startSegment, visitVertex, adjustEdgeWeight, filterStates,
+                          reducedToRealLength, context);
+  if (isCancelled)
+    return RouterResultCode::Cancelled;
+
+  double constexpr kHullEps = 1e-9;
+  isochrone.m_hull = m2::ConvexHull(points, kHullEps).Points();
+
+  LOG(LINFO, ("Isochrone of", maxWeightSeconds, "seconds from", mercator::ToLatLon(point),
+              "segments:", isochrone.m_segments.size(), "truncated:", isochrone.m_isTruncated,
+              "elapsed:", timer.ElapsedSeconds()));
+  return RouterResultCode::NoError;
+}
+
 unique_ptr<WorldGraph> IndexRouter::MakeWorldGraph()
+{
+  return MakeWorldGraph(m_dataSource, &m_stats);
+}
+
+unique_ptr<WorldGraph> IndexRouter::MakeWorldGraph(MwmDataSource & dataSource,
+                                                   RouteBuildStats * stats, bool withTransit)
 {
   // Use saved routing options for all types (car, bicycle, pedestrian).
   RoutingOptions const routingOptions = RoutingOptions::LoadCarOptionsFromSettings();
@@ -1003,13 +1964,14 @@ unique_ptr<WorldGraph> IndexRouter::MakeWorldGraph()
   auto crossMwmGraph = make_unique<CrossMwmGraph>(
       m_numMwmIds, m_numMwmTree,
       m_vehicleType == VehicleType::Transit ? VehicleType::Pedestrian : m_vehicleType,
-      m_countryRectFn, m_dataSource);
+      m_countryRectFn, dataSource);
 
   auto indexGraphLoader = IndexGraphLoader::Create(
       m_vehicleType == VehicleType::Transit ? VehicleType::Pedestrian : m_vehicleType,
-      m_loadAltitudes, m_vehicleModelFactory, m_estimator, m_dataSource, routingOptions);
+      m_loadAltitudes, m_vehicleModelFactory, m_estimator, dataSource, routingOptions,
+      m_indexGraphStore, stats);
 
-  if (m_vehicleType != VehicleType::Transit)
+  if (m_vehicleType != VehicleType::Transit || !withTransit)
   {
     auto graph = make_unique<SingleVehicleWorldGraph>(
         move(crossMwmGraph), move(indexGraphLoader), m_estimator,
@@ -1018,11 +1980,24 @@ unique_ptr<WorldGraph> IndexRouter::MakeWorldGraph()
     return graph;
   }
 
-  auto transitGraphLoader = TransitGraphLoader::Create(m_dataSource, m_estimator);
+  auto transitGraphLoader = TransitGraphLoader::Create(dataSource, m_estimator);
   return make_unique<TransitWorldGraph>(move(crossMwmGraph), move(indexGraphLoader),
                                         move(transitGraphLoader), m_estimator);
 }
 
+unique_ptr<IndexGraphStarter> IndexRouter::MakeBackwardStarter(IndexGraphStarter const & starter)
+{
+  if (!m_parallelBidirectional || m_timeDependentWeights)
+    return nullptr;
+
+  // Loading of the backward graph is concurrent with the forward wave, so it isn't measured.
+  if (!m_backwardGraph)
+    m_backwardGraph = MakeWorldGraph(m_backwardDataSource, nullptr /* stats */);
+
+  m_backwardGraph->SetMode(starter.GetGraph().GetMode());
+  return make_unique<IndexGraphStarter>(starter, *m_backwardGraph);
+}
+
 int IndexRouter::PointsOnEdgesSnapping::Snap(
         m2::PointD const & start, m2::PointD const & finish, m2::PointD const & direction,
         FakeEnding & startEnding, FakeEnding & finishEnding, bool & startIsCodirectional)
@@ -1318,28 +2293,7 @@ RouterResultCode IndexRouter::ProcessLeapsJoints(vector<Segment> const & input,
   // https://github.com/organicmaps/organicmaps/issues/821
   // https://github.com/organicmaps/organicmaps/issues/2085
 
-  buffer_vector<std::pair<size_t, size_t>, 4> arrBegEnd;
-  arrBegEnd.emplace_back(1, input.size() - 2);
-  {
-    auto const firstMwmId = input[1].GetMwmId();
-    auto const startLeapEndReverseIt = find_if(input.rbegin() + 2, input.rend(),
-                                               [firstMwmId](Segment const & s) { return s.GetMwmId() == firstMwmId; });
-    auto const startLeapEndIt = startLeapEndReverseIt.base() - 1;
-    auto const startLeapEnd = static_cast<size_t>(distance(input.begin(), startLeapEndIt));
-    if (startLeapEnd != arrBegEnd[0].first)
-      arrBegEnd.emplace_back(startLeapEnd, arrBegEnd[0].second);
-
-    // The last leap processed the same way. See the comment above.
-    auto const lastMwmId = input[input.size() - 2].GetMwmId();
-    auto const finishLeapStartIt = find_if(startLeapEndIt, input.end(),
-                                           [lastMwmId](Segment const & s) { return s.GetMwmId() == lastMwmId; });
-    auto const finishLeapStart = static_cast<size_t>(distance(input.begin(), finishLeapStartIt));
-    if (finishLeapStart != arrBegEnd[0].second)
-      arrBegEnd.emplace_back(arrBegEnd[0].first, finishLeapStart);
-
-    if (arrBegEnd.size() == 3)
-      arrBegEnd.emplace_back(startLeapEnd, finishLeapStart);
-  }
+  auto const arrBegEnd = GetLeapsBegEnd(input);
 
   for (auto const & eBegEnd : arrBegEnd)
   {
@@ -1411,6 +2365,9 @@ RouterResultCode IndexRouter::ProcessLeapsJoints(vector<Segment> const & input,
           jointStarter, jointStarter.GetStartJoint(), jointStarter.GetFinishJoint(),
           delegate.GetCancellable(), Visitor(jointStarter, delegate, kVisitPeriod, progress),
           AStarLengthChecker(starter));
+      auto const heuristic =
+          MakeLandmarkHeuristic(starter, jointStarter, input[start], input[end]);
+      params.m_heuristic = heuristic.get();
 
       RoutingResult<JointSegment, RouteWeight> route;
       if (FindPath<Vertex, Edge, Weight>(params, mwmIds, route) == RouterResultCode::NoError)
@@ -1546,13 +2503,163 @@ RouterResultCode IndexRouter::ProcessLeapsJoints(vector<Segment> const & input,
   return RouterResultCode::NoError;
 }
 
+void IndexRouter::CalculateLeapsSubroutes(vector<RoutingResultT> const & candidates,
+                                          RouterDelegate const & delegate,
+                                          IndexGraphStarter & starter, RoutesCacheT & cache)
+{
+  // Subroute from |m_start| to |m_end| of |m_input| leaps path, which is calculated on its own
+  // copy of the starter. Mwm handles are not shared between threads.
+  struct Task
+  {
+    vector<Segment> const * m_input = nullptr;
+    size_t m_start = 0;
+    size_t m_end = 0;
+    unique_ptr<MwmDataSource> m_dataSource;
+    unique_ptr<WorldGraph> m_graph;
+    unique_ptr<IndexGraphStarter> m_starter;
+    optional<RoutingResultT> m_result;
+  };
+
+  // The same subroutes as tryBuildRoute() of ProcessLeapsJoints() tries first, in the same order.
+  vector<Task> tasks;
+  set<pair<Segment, Segment>> keys;
+  set<NumMwmId> mwmIds = starter.GetStartMwms();
+  mwmIds.insert(starter.GetFinishMwms().begin(), starter.GetFinishMwms().end());
+  auto const addTask = [&](vector<Segment> const & input, size_t start, size_t end)
+  {
+    if (cache.count({input[start], input[end]}) != 0 || !keys.emplace(input[start], input[end]).second)
+      return;
+
+    for (size_t i = start; i <= end; ++i)
+    {
+      if (input[i].GetMwmId() != kFakeNumMwmId)
+        mwmIds.insert(input[i].GetMwmId());
+    }
+
+    Task task;
+    task.m_input = &input;
+    task.m_start = start;
+    task.m_end = end;
+    tasks.push_back(move(task));
+  };
+
+  for (auto const & candidate : candidates)
+  {
+    auto const & input = candidate.m_path;
+    CHECK_GREATER_OR_EQUAL(input.size(), 4, ());
+    for (auto const & [startLeapEnd, finishLeapStart] : GetLeapsBegEnd(input))
+    {
+      for (size_t i = startLeapEnd; i <= finishLeapStart; ++i)
+      {
+        if (i == startLeapEnd)
+        {
+          addTask(input, 0, i);
+        }
+        else if (i == finishLeapStart)
+        {
+          addTask(input, i, input.size() - 1);
+        }
+        else
+        {
+          addTask(input, i, i + 1);
+          ++i;
+        }
+      }
+    }
+  }
+
+  if (tasks.empty())
+    return;
+
+  // Landmarks are loaded lazily by MakeLandmarkHeuristic(), so they are loaded here, and
+  // the tasks only read |m_landmarks|.
+  if (m_vehicleType == VehicleType::Car)
+  {
+    for (NumMwmId const mwmId : mwmIds)
+      GetJointLandmarks(mwmId);
+  }
+
+  // Graphs are made and the starter is copied here since they aren't thread-safe.
+  for (auto & task : tasks)
+  {
+    task.m_dataSource = make_unique<MwmDataSource>(m_dataSource.GetDataSource(), m_numMwmIds);
+    task.m_graph = MakeWorldGraph(*task.m_dataSource, nullptr /* stats */);
+    task.m_graph->SetMode(WorldGraphMode::JointSingleMwm);
+    task.m_starter = make_unique<IndexGraphStarter>(starter, *task.m_graph);
+  }
+
+  LOG(LDEBUG, ("Calculating", tasks.size(), "leaps subroutes on", m_leapsThreadsNumber, "threads."));
+
+  auto const calculate = [this, &delegate](Task & task)
+  {
+    Segment const & start = (*task.m_input)[task.m_start];
+    Segment const & end = (*task.m_input)[task.m_end];
+
+    using JointsStarter = IndexGraphStarterJoints<IndexGraphStarter>;
+    JointsStarter jointStarter(*task.m_starter);
+    jointStarter.Init(start, end);
+
+    using Vertex = JointsStarter::Vertex;
+    using Edge = JointsStarter::Edge;
+    using Weight = JointsStarter::Weight;
+
+    // Visitor isn't used since |delegate| callbacks are called from the routing thread only.
+    AStarAlgorithm<Vertex, Edge, Weight>::Params<astar::DefaultVisitor, AStarLengthChecker> params(
+        jointStarter, jointStarter.GetStartJoint(), jointStarter.GetFinishJoint(),
+        delegate.GetCancellable(), astar::DefaultVisitor(), AStarLengthChecker(*task.m_starter));
+    auto const heuristic = MakeLandmarkHeuristic(*task.m_starter, jointStarter, start, end);
+    params.m_heuristic = heuristic.get();
+
+    RoutingResult<JointSegment, RouteWeight> route;
+    AStarAlgorithm<Vertex, Edge, Weight> algorithm;
+    auto const result = m_timeDependentWeights ? algorithm.FindPath(params, route)
+                                               : algorithm.FindPathBidirectional(params, route);
+    if (result != AStarAlgorithm<Vertex, Edge, Weight>::Result::OK)
+      return;
+
+    task.m_result.emplace();
+    task.m_result->m_path = ProcessJoints(route.m_path, jointStarter);
+    task.m_result->m_distance = route.m_distance;
+  };
+
+  {
+    // The pool is kept by the router between routes and is recreated if the number changes.
+    if (!m_leapsPool || m_leapsPoolThreadsNumber != m_leapsThreadsNumber)
+    {
+      m_leapsPool = make_unique<base::thread_pool::computational::ThreadPool>(m_leapsThreadsNumber);
+      m_leapsPoolThreadsNumber = m_leapsThreadsNumber;
+    }
+
+    vector<future<void>> results;
+    results.reserve(tasks.size());
+    for (auto & task : tasks)
+      results.push_back(m_leapsPool->Submit(calculate, ref(task)));
+
+    for (auto & result : results)
+      result.get();
+  }
+
+  // Subroutes which aren't found are not cached, so ProcessLeapsJoints() tries them again with
+  // the ordinary fallbacks.
+  for (auto & task : tasks)
+  {
+    if (task.m_result)
+    {
+      auto const & input = *task.m_input;
+      cache.emplace(make_pair(input[task.m_start], input[task.m_end]), move(*task.m_result));
+    }
+  }
+}
+
 RouterResultCode IndexRouter::RedressRoute(vector<Segment> const & segments,
                                            base::Cancellable const & cancellable,
-                                           IndexGraphStarter & starter, Route & route)
+                                           IndexGraphStarter & starter, Route & route,
+                                           bool pendingDirections /* = true */)
 {
   CHECK(!segments.empty(), ());
   IndexGraphStarter::CheckValidRoute(segments);
 
+  RouteBuildStats::ScopedTimer statsTimer(&m_stats, RouteBuildStats::Phase::Directions);
   size_t const segsCount = segments.size();
   vector<geometry::PointWithAltitude> junctions;
   junctions.reserve(segsCount + 1);
@@ -1566,18 +2673,68 @@ RouterResultCode IndexRouter::RedressRoute(vector<Segment> const & segments,
   vector<double> times;
   times.reserve(segments.size());
 
+  // Segments of roads with speed profiles are passed at the speed of the moment they're entered.
+  auto const getProfileCorrection = [&starter](Segment const & segment, double enterTime) {
+    double const factor = starter.CalcETAFactor(segment, enterTime);
+    return factor == 1.0 ? 0.0 : (factor - 1.0) * starter.CalculateETAWithoutPenalty(segment);
+  };
+
+  // Public transport is waited for the trips which depart after the stops are reached.
+  time_t const departureTime = GetCurrentTimestamp();
+
   // Time at first route point - weight of first segment.
   double time = starter.CalculateETAWithoutPenalty(segments.front());
+  time += getProfileCorrection(segments.front(), 0.0 /* enterTime */);
   times.emplace_back(time);
 
   for (size_t i = 1; i < segments.size(); ++i)
   {
+    double const enterTime = time;
+    if (m_vehicleType == VehicleType::Transit)
+    {
+      time += starter.CalcTransitWaitingTime(segments[i - 1], segments[i],
+                                             departureTime + static_cast<time_t>(enterTime));
+    }
     time += starter.CalculateETA(segments[i - 1], segments[i]);
+    time += getProfileCorrection(segments[i], enterTime);
     times.emplace_back(time);
   }
 
   m_directionsEngine->SetVehicleType(m_vehicleType);
-  ReconstructRoute(*m_directionsEngine, roadGraph, cancellable, junctions, times, route);
+
+  // Directions are generated for a longer prefix than the synchronous one since turns depend on
+  // the route after them.
+  size_t prefixSize = segsCount;
+  if (pendingDirections && m_syncDirectionsDistanceM > 0.0 && m_vehicleType != VehicleType::Transit)
+    prefixSize = GetPrefixSegmentsNumber(junctions, m_syncDirectionsDistanceM + kDirectionsLookAheadM);
+
+  if (prefixSize == segsCount)
+  {
+    ReconstructRoute(*m_directionsEngine, roadGraph, cancellable, junctions, times, route);
+  }
+  else
+  {
+    vector<Segment> const prefixSegments(segments.begin(), segments.begin() + prefixSize);
+    vector<geometry::PointWithAltitude> const prefixJunctions(junctions.begin(),
+                                                              junctions.begin() + prefixSize + 1);
+    IndexRoadGraph prefixGraph(starter, prefixSegments, prefixJunctions, m_dataSource);
+    size_t const directionsSize = GetPrefixSegmentsNumber(junctions, m_syncDirectionsDistanceM);
+    ReconstructRoute(*m_directionsEngine, roadGraph, prefixGraph, directionsSize, cancellable,
+                     junctions, times, route);
+
+    // Only the segments without directions and the look back part before them are kept.
+    size_t const firstSegmentIdx = GetPrefixSegmentsNumber(
+        junctions, max(m_syncDirectionsDistanceM - kDirectionsLookBackM, 0.0));
+    auto pending = make_unique<PendingDirections>();
+    pending->m_graph = MakeWorldGraph(m_directionsDataSource, nullptr /* stats */);
+    pending->m_graph->SetMode(WorldGraphMode::NoLeaps);
+    pending->m_starter = make_unique<IndexGraphStarter>(starter, *pending->m_graph);
+    pending->m_segments.assign(segments.begin() + firstSegmentIdx, segments.end());
+    pending->m_junctions.assign(junctions.begin() + firstSegmentIdx, junctions.end());
+    pending->m_firstSegmentIdx = firstSegmentIdx;
+    pending->m_firstPendingSegmentIdx = directionsSize;
+    m_pendingDirections = move(pending);
+  }
 
   /// @todo I suspect that we can avoid calculating segments inside ReconstructRoute
   /// and use original |segments| (IndexRoadGraph::GetRouteSegments).
@@ -12,12 +12,17 @@
 #include "routing/guides_connections.hpp"
 #include "routing/index_graph_starter_joints.hpp"
 #include "routing/joint.hpp"
+#include "routing/joint_contraction_hierarchy.hpp"
+#include "routing/joint_landmarks.hpp"
+#include "routing/landmark_heuristic.hpp"
 #include "routing/nearest_edge_finder.hpp"
 #include "routing/regions_decl.hpp"
+#include "routing/route_build_stats.hpp"
 #include "routing/router.hpp"
 #include "routing/routing_callbacks.hpp"
 #include "routing/segment.hpp"
 #include "routing/segmented_route.hpp"
+#include "routing/transit_raptor.hpp"
 
 #include "routing_common/num_mwm_id.hpp"
 #include "routing_common/vehicle_model.hpp"
@@ -29,7 +34,11 @@
 #include "geometry/rect2d.hpp"
 #include "geometry/tree4d.hpp"
 
+#include "base/thread_pool_computational.hpp"
+
+#include <ctime>
 #include <functional>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -42,6 +51,7 @@ namespace routing
 {
 class IndexGraph;
 class IndexGraphStarter;
+class IndexGraphStore;
 
 class IndexRouter : public IRouter
 {
@@ -90,15 +100,133 @@ public:
   bool FindClosestProjectionToRoad(m2::PointD const & point, m2::PointD const & direction,
                                    double radius, EdgeProj & proj) override;
 
+  bool GeneratePendingDirections(base::Cancellable const & cancellable, size_t & firstSegmentIdx,
+                                 std::vector<RouteSegment> & routeSegments) override;
+
   bool GetBestOutgoingEdges(m2::PointD const & checkpoint, WorldGraph & graph, std::vector<Edge> & edges);
 
   VehicleType GetVehicleType() const { return m_vehicleType; }
 
+  /// \brief Duration and distance of the fastest route between two points of a matrix.
+  struct MatrixRoute
+  {
+    RouterResultCode m_code = RouterResultCode::RouteNotFound;
+    double m_etaSeconds = 0.0;
+    double m_distanceMeters = 0.0;
+  };
+  using Matrix = std::vector<std::vector<MatrixRoute>>;
+
+  /// \brief Calculates durations and distances of the fastest routes from every point of
+  /// |sources| to every point of |targets|: |matrix[i][j]| is the route from |sources[i]| to
+  /// |targets[j]|. Geometry and directions of the routes are not built. One Dijkstra wave is
+  /// propagated from every source until all targets are reached and the road graph is loaded
+  /// once for all of them, so it's much cheaper than building every route separately.
+  /// The wave is limited by a weight derived from the distance to the farthest target, so
+  /// routes which are much longer than the straight line may be not found.
+  /// Routes of the transit router are walks, public transport isn't used for them.
+  /// \returns RouterResultCode::NoError if the matrix is calculated. Some of its routes may be
+  /// not found anyway, see their codes.
+  RouterResultCode CalculateMatrix(std::vector<m2::PointD> const & sources,
+                                   std::vector<m2::PointD> const & targets,
+                                   RouterDelegate const & delegate, Matrix & matrix);
+
+  /// \brief Part of the road graph which is reachable from a point within a time limit.
+  struct Isochrone
+  {
+    /// Real segments which are reachable entirely with weights of the ways to their ends in seconds.
+    std::vector<std::pair<Segment, double>> m_segments;
+    /// Convex hull of the reachable points including reachable parts of the segments on the border.
+    std::vector<m2::PointD> m_hull;
+    /// True if the search was stopped by the limit of visited segments before the time limit.
+    bool m_isTruncated = false;
+  };
+
+  /// \brief Calculates the isochrone of |maxWeightSeconds| from |point|. Weights of route segments
+  /// are used, i.e. estimated time with penalties. Mwm borders are crossed as well. Not more than
+  /// |maxSegmentsNumber| segments are visited.
+  RouterResultCode CalculateIsochrone(m2::PointD const & point, double maxWeightSeconds,
+                                      size_t maxSegmentsNumber, RouterDelegate const & delegate,
+                                      Isochrone & isochrone);
+
+  static double constexpr kTransitAccessRadiusM = 1500.0;
+
+  /// \brief Finds the public transport journey with the earliest arrival from |start| to
+  /// |finish| if |start| is left at |departureTime|. The journey is found by TransitRaptor over
+  /// the trips of the transit section of the mwm of the points, walks from |start| to the stops
+  /// and from the stops to |finish| within |kTransitAccessRadiusM| are found by
+  /// CalculateMatrix(). Geometry of the journey isn't built. Both points should be in the same
+  /// mwm. Should be called for the transit router only.
+  RouterResultCode CalculateTransitJourney(m2::PointD const & start, m2::PointD const & finish,
+                                           time_t departureTime, RouterDelegate const & delegate,
+                                           TransitRaptor::Journey & journey);
+
+  /// \brief Car routes inside mwms with ROUTING_CH_FILE_TAG section are found by the contraction
+  /// hierarchy if it's enabled. It's enabled by default.
+  void SetContractionHierarchyEnabled(bool enabled) { m_contractionHierarchyEnabled = enabled; }
+
+  /// \brief Propagates the forward and the backward waves of bidirectional A* concurrently.
+  /// The backward wave uses its own copy of the road graph, so routing takes more memory.
+  void SetParallelBidirectional(bool parallel) { m_parallelBidirectional = parallel; }
+
+  /// \brief Subroutes inside mwms of cross-mwm routes are calculated concurrently on
+  /// |threadsNumber| threads, each with its own copy of the starter and its own world graph.
+  /// Road and joint indexes are shared between the threads only if SetIndexGraphStore() is called.
+  void SetLeapsThreadsNumber(size_t threadsNumber) { m_leapsThreadsNumber = threadsNumber; }
+
+  /// \brief Up to |alternativesNumber| alternative routes are found besides the best one by
+  /// the same bidirectional search, see AStarAlgorithm::FindPathBidirectionalAlternatives().
+  /// They are put to Route::GetAlternatives(). Alternatives are found for routes without
+  /// intermediate points and guides inside mwms and between near mwms only. If the best route is
+  /// found by the contraction hierarchy, the alternatives are found by a separate search.
+  void SetAlternativesNumber(size_t alternativesNumber) { m_alternativesNumber = alternativesNumber; }
+
+  /// \brief Weights of roads with weekly speed profiles of SPEED_PROFILES_FILE_TAG section are
+  /// evaluated at the moment the roads are entered if a route departs now. The moment is known
+  /// in the forward wave only, so routes inside mwms are found by the forward A* then, without
+  /// alternatives and the parallel backward wave. ETA of the route is calculated with
+  /// the profiles along the whole route. The contraction hierarchy, which has static weights,
+  /// isn't used for mwms with the section then.
+  void SetTimeDependentWeights(bool enabled) { m_timeDependentWeights = enabled; }
+
+  /// \brief Turns and street names of routes longer than |distanceMeters| are generated for
+  /// the first |distanceMeters| while the route is built. The rest is generated by
+  /// GeneratePendingDirections(). Zero means that all the directions are generated while the route
+  /// is built.
+  void SetSyncDirectionsDistance(double distanceMeters) { m_syncDirectionsDistanceM = distanceMeters; }
+
+  /// \brief Takes road and joint indexes of mwms from |graphStore| which may be shared by routers
+  /// of several threads instead of loading them for every route. nullptr disables the sharing.
+  void SetIndexGraphStore(std::shared_ptr<IndexGraphStore> graphStore)
+  {
+    m_indexGraphStore = std::move(graphStore);
+  }
+
+  /// \returns time of the phases of the last CalculateRoute() call and the number of vertices
+  /// settled by its searches. Vertices of the backward wave of the parallel search are not counted.
+  RouteBuildStats const & GetLastRouteStats() const { return m_stats; }
+
 private:
-  RouterResultCode CalculateSubrouteJointsMode(IndexGraphStarter & starter,
-                                               RouterDelegate const & delegate,
-                                               std::shared_ptr<AStarProgress> const & progress,
-                                               std::vector<Segment> & subroute);
+  /// \brief Frees buffers and mwm handles of the route calculation.
+  void ClearBuffers();
+
+  /// \param alternatives is filled with alternatives of |subroute| if it isn't nullptr.
+  RouterResultCode CalculateSubrouteJointsMode(
+      IndexGraphStarter & starter, RouterDelegate const & delegate,
+      std::shared_ptr<AStarProgress> const & progress, std::vector<Segment> & subroute,
+      std::vector<std::vector<Segment>> * alternatives = nullptr);
+  /// \brief Finds the best route and its alternatives by the bidirectional search with
+  /// alternatives. |routes| are sorted by weight, the best route is the first one.
+  RouterResultCode CalculateAlternativesJointsMode(
+      IndexGraphStarter & starter, RouterDelegate const & delegate,
+      std::shared_ptr<AStarProgress> const & progress,
+      std::vector<std::vector<Segment>> & routes);
+  /// \brief Finds a corridor with the contraction hierarchy of the mwm and runs the ordinary
+  /// search inside the corridor. It's applicable for car routes inside one mwm only.
+  /// \returns RouterResultCode::RouteNotFound if the hierarchy is not applicable.
+  RouterResultCode CalculateSubrouteContractionMode(IndexGraphStarter & starter,
+                                                    RouterDelegate const & delegate,
+                                                    std::shared_ptr<AStarProgress> const & progress,
+                                                    std::vector<Segment> & subroute);
   RouterResultCode CalculateSubrouteNoLeapsMode(IndexGraphStarter & starter,
                                                 RouterDelegate const & delegate,
                                                 std::shared_ptr<AStarProgress> const & progress,
@@ -116,13 +244,47 @@ private:
                                      RouterDelegate const & delegate,
                                      std::shared_ptr<AStarProgress> const & progress,
                                      IndexGraphStarter & graph, std::vector<Segment> & subroute,
-                                     bool guidesActive = false);
+                                     bool guidesActive = false,
+                                     std::vector<std::vector<Segment>> * alternatives = nullptr);
 
   RouterResultCode AdjustRoute(Checkpoints const & checkpoints,
                                m2::PointD const & startDirection,
                                RouterDelegate const & delegate, Route & route);
 
   std::unique_ptr<WorldGraph> MakeWorldGraph();
+  /// \param withTransit public transport is added to the graph of the transit router.
+  std::unique_ptr<WorldGraph> MakeWorldGraph(MwmDataSource & dataSource, RouteBuildStats * stats,
+                                             bool withTransit = true);
+
+  /// \returns copy of |starter| on |m_backwardGraph| for the backward wave of the parallel
+  /// bidirectional search or nullptr if the parallel search is disabled or weights are
+  /// time-dependent.
+  std::unique_ptr<IndexGraphStarter> MakeBackwardStarter(IndexGraphStarter const & starter);
+
+  /// \brief Route which turns and street names are generated by GeneratePendingDirections().
+  /// The starter is copied on a separate world graph since the graph of the route calculation
+  /// is destroyed with its mwm handles.
+  struct PendingDirections
+  {
+    std::unique_ptr<WorldGraph> m_graph;
+    std::unique_ptr<IndexGraphStarter> m_starter;
+    /// Segments of the route starting from |m_firstSegmentIdx| and their junctions.
+    std::vector<Segment> m_segments;
+    std::vector<geometry::PointWithAltitude> m_junctions;
+    size_t m_firstSegmentIdx = 0;
+    /// Index of the first route segment without directions, it's not less than |m_firstSegmentIdx|.
+    size_t m_firstPendingSegmentIdx = 0;
+  };
+
+  /// \returns contraction hierarchy of |mwmId| or nullptr if the mwm doesn't have it.
+  JointContractionHierarchy const * GetContractionHierarchy(NumMwmId mwmId);
+  /// \returns landmarks of |mwmId| or nullptr if the mwm doesn't have them.
+  JointLandmarks const * GetJointLandmarks(NumMwmId mwmId);
+  /// \returns landmark heuristic for a search from |start| to |finish| or nullptr if landmarks
+  /// can't be used for it.
+  std::unique_ptr<LandmarkHeuristic> MakeLandmarkHeuristic(
+      IndexGraphStarter const & starter, IndexGraphStarterJoints<IndexGraphStarter> & jointStarter,
+      Segment const & start, Segment const & finish);
 
   using EdgeProjectionT = IRoadGraph::EdgeProjectionT;
   class PointsOnEdgesSnapping
@@ -205,9 +367,16 @@ private:
                                       std::shared_ptr<AStarProgress> const & progress,
                                       RoutesCacheT & cache,
                                       RoutingResultT & result);
+  /// \brief Calculates in parallel the subroutes which ProcessLeapsJoints() tries first for
+  /// |candidates| and puts them to |cache|.
+  void CalculateLeapsSubroutes(std::vector<RoutingResultT> const & candidates,
+                               RouterDelegate const & delegate, IndexGraphStarter & starter,
+                               RoutesCacheT & cache);
+  /// \param pendingDirections allows to generate a part of directions later,
+  /// see SetSyncDirectionsDistance().
   RouterResultCode RedressRoute(std::vector<Segment> const & segments,
                                 base::Cancellable const & cancellable, IndexGraphStarter & starter,
-                                Route & route);
+                                Route & route, bool pendingDirections = true);
 
   bool AreSpeedCamerasProhibited(NumMwmId mwmID) const;
   bool AreMwmsNear(IndexGraphStarter const & starter) const;
@@ -238,8 +407,10 @@ private:
                             RoutingResult<Vertex, Weight> & routingResult)
   {
     AStarAlgorithm<Vertex, Edge, Weight> algorithm;
-    return ConvertTransitResult(
-        mwmIds, ConvertResult<Vertex, Edge, Weight>(algorithm.FindPathBidirectional(params, routingResult)));
+    auto const result = m_timeDependentWeights ? algorithm.FindPath(params, routingResult)
+                                               : algorithm.FindPathBidirectional(params, routingResult);
+    m_stats.AddSettledVertices(params.m_onVisitedVertexCallback.GetVisitsNumber());
+    return ConvertTransitResult(mwmIds, ConvertResult<Vertex, Edge, Weight>(result));
   }
 
   void SetupAlgorithmMode(IndexGraphStarter & starter, bool guidesActive = false) const;
@@ -261,6 +432,16 @@ private:
   bool m_loadAltitudes;
   std::string const m_name;
   MwmDataSource m_dataSource;
+  // Used by the backward wave of the parallel bidirectional search. Mwm handles
+  // are not shared between threads.
+  MwmDataSource m_backwardDataSource;
+  // World graph of the backward wave of the parallel bidirectional search. Like the graph of
+  // the forward wave, it's made once per route and used by all its subroutes and leaps.
+  // It's destroyed before the handles of |m_backwardDataSource| are freed.
+  std::unique_ptr<WorldGraph> m_backwardGraph;
+  // Used by the graph of |m_pendingDirections|. Its handles are kept till the directions
+  // are generated.
+  MwmDataSource m_directionsDataSource;
   std::shared_ptr<VehicleModelFactoryInterface> m_vehicleModelFactory;
 
   TCountryFileFn const m_countryFileFn;
@@ -275,9 +456,29 @@ private:
   std::unique_ptr<SegmentedRoute> m_lastRoute;
   std::unique_ptr<FakeEdgesContainer> m_lastFakeEdges;
 
+  // Contraction hierarchies are loaded lazily, nullptr means that the mwm has no hierarchy.
+  std::map<NumMwmId, std::unique_ptr<JointContractionHierarchy>> m_contractionHierarchies;
+  // Landmarks are loaded lazily too, nullptr means that the mwm has no landmarks.
+  std::map<NumMwmId, std::unique_ptr<JointLandmarks>> m_landmarks;
+
   // If a ckeckpoint is near to the guide track we need to build route through this track.
   GuidesConnections m_guides;
 
   CountryParentNameGetterFn m_countryParentNameGetterFn;
+
+  bool m_contractionHierarchyEnabled = true;
+  bool m_parallelBidirectional = false;
+  size_t m_leapsThreadsNumber = 1;
+  // Subroutes of leaps are calculated by this pool, see CalculateLeapsSubroutes().
+  std::unique_ptr<base::thread_pool::computational::ThreadPool> m_leapsPool;
+  size_t m_leapsPoolThreadsNumber = 0;
+  size_t m_alternativesNumber = 0;
+  bool m_timeDependentWeights = false;
+  double m_syncDirectionsDistanceM = 0.0;
+  std::unique_ptr<PendingDirections> m_pendingDirections;
+  // May be nullptr.
+  std::shared_ptr<IndexGraphStore> m_indexGraphStore;
+
+  RouteBuildStats m_stats;
 };
 }  // namespace routing
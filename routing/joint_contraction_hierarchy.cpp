@@ -0,0 +1,68 @@
+#include "routing/joint_contraction_hierarchy.hpp"
+
+#include "routing/index_graph.hpp"
+
+#include "indexer/data_source.hpp"
+
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include <utility>
+
+#include "defines.hpp"
+
+namespace routing
+{
+using namespace std;
+
+JointContractionHierarchy::JointContractionHierarchy(RoadPieces && pieces,
+                                                     ContractionHierarchy && hierarchy)
+  : m_pieces(move(pieces)), m_hierarchy(move(hierarchy))
+{
+  CHECK_EQUAL(m_hierarchy.GetNumVertices(), m_pieces.GetNumVertices(), ());
+}
+
+JointContractionHierarchy BuildJointContractionHierarchy(IndexGraph const & graph)
+{
+  base::Timer timer;
+
+  RoadPieces pieces(graph);
+  ContractionHierarchyBuilder builder(pieces.GetNumVertices());
+  uint32_t numEdges = 0;
+  pieces.ForEachEdge(graph, [&](RoadPieces::Vertex from, RoadPieces::Vertex to,
+                                RouteWeight const & weight) {
+    builder.AddEdge(from, to, weight.GetIntegratedWeight());
+    ++numEdges;
+  });
+
+  LOG(LINFO, ("Road pieces:", pieces.GetSize(), "edges:", numEdges));
+
+  ContractionHierarchy hierarchy;
+  builder.Build(hierarchy);
+
+  LOG(LINFO, ("Contraction hierarchy is built in", timer.ElapsedSeconds(), "seconds"));
+  return JointContractionHierarchy(move(pieces), move(hierarchy));
+}
+
+unique_ptr<JointContractionHierarchy> LoadJointContractionHierarchy(MwmValue const & mwmValue)
+{
+  if (!mwmValue.m_cont.IsExist(ROUTING_CH_FILE_TAG))
+    return nullptr;
+
+  try
+  {
+    auto const reader = mwmValue.m_cont.GetReader(ROUTING_CH_FILE_TAG);
+    ReaderSource<FilesContainerR::TReader> src(reader);
+
+    auto hierarchy = make_unique<JointContractionHierarchy>();
+    hierarchy->Deserialize(src);
+    return hierarchy;
+  }
+  catch (Reader::Exception const & e)
+  {
+    LOG(LERROR, ("File", mwmValue.GetCountryFileName(), "Error while reading",
+                 ROUTING_CH_FILE_TAG, "section.", e.Msg()));
+    return nullptr;
+  }
+}
+}  // namespace routing
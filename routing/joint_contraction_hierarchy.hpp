@@ -0,0 +1,111 @@
+#pragma once
+
+#include "routing/base/contraction_hierarchy.hpp"
+#include "routing/road_pieces.hpp"
+#include "routing/segment.hpp"
+
+#include "routing_common/num_mwm_id.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+class MwmValue;
+
+namespace routing
+{
+class IndexGraph;
+
+/// \brief Contraction hierarchy over the car IndexGraph of one mwm. A vertex of the hierarchy is
+/// a vertex of RoadPieces, i.e. a directed road piece between two neighbouring joints. An edge
+/// u -> v means that it's possible to enter piece |v| right after passing piece |u|, its weight
+/// is the transition penalty plus the weight of |v|.
+/// The hierarchy is built with restrictions and road access of the mwm but without
+/// traffic and conditional restrictions, so the router uses it only to find a corridor
+/// and then runs the ordinary search inside the corridor.
+class JointContractionHierarchy final
+{
+public:
+  using Vertex = ContractionHierarchy::Vertex;
+
+  struct Header
+  {
+    template <typename Sink>
+    void Serialize(Sink & sink) const
+    {
+      WriteToSink(sink, m_version);
+      WriteToSink(sink, m_endianness);
+    }
+
+    template <typename Source>
+    void Deserialize(Source & src)
+    {
+      m_version = ReadPrimitiveFromSource<uint16_t>(src);
+      m_endianness = ReadPrimitiveFromSource<uint16_t>(src);
+    }
+
+    uint16_t m_version = 0;
+    // Field |m_endianness| is reserved for endianness of the section.
+    uint16_t m_endianness = 0;
+  };
+
+  static uint16_t constexpr kLastVersion = 0;
+
+  JointContractionHierarchy() = default;
+  JointContractionHierarchy(RoadPieces && pieces, ContractionHierarchy && hierarchy);
+
+  ContractionHierarchy const & GetHierarchy() const { return m_hierarchy; }
+  size_t GetNumPieces() const { return m_pieces.GetSize(); }
+
+  /// \returns vertex of the directed road piece which contains |segment| or
+  /// |ContractionHierarchy::kInvalidVertex| if there's no such piece.
+  Vertex GetVertex(Segment const & segment) const { return m_pieces.GetVertex(segment); }
+
+  /// \brief Calls |f| for all segments of the piece of |v| in the direction of movement.
+  template <typename F>
+  void ForEachSegment(Vertex v, NumMwmId mwmId, F && f) const
+  {
+    m_pieces.ForEachSegment(v, mwmId, std::forward<F>(f));
+  }
+
+  template <typename Sink>
+  void Serialize(Sink & sink) const
+  {
+    Header header;
+    header.m_version = kLastVersion;
+    header.Serialize(sink);
+
+    m_pieces.Serialize(sink);
+    m_hierarchy.Serialize(sink);
+  }
+
+  template <typename Source>
+  void Deserialize(Source & src)
+  {
+    Header header;
+    header.Deserialize(src);
+    CHECK_EQUAL(header.m_version, kLastVersion, ("Unknown contraction hierarchy section version."));
+
+    m_pieces.Deserialize(src);
+    m_hierarchy.Deserialize(src);
+    CHECK_EQUAL(m_hierarchy.GetNumVertices(), m_pieces.GetNumVertices(), ());
+  }
+
+private:
+  RoadPieces m_pieces;
+  ContractionHierarchy m_hierarchy;
+};
+
+/// \brief Builds contraction hierarchy over road pieces of |graph|.
+/// \note |graph| should be loaded with restrictions and road access.
+JointContractionHierarchy BuildJointContractionHierarchy(IndexGraph const & graph);
+
+/// \returns contraction hierarchy of the mwm or nullptr if there's no ROUTING_CH_FILE_TAG
+/// section or it can't be read.
+std::unique_ptr<JointContractionHierarchy> LoadJointContractionHierarchy(MwmValue const & mwmValue);
+}  // namespace routing
@@ -1,47 +1,93 @@
 #include "routing/joint_index.hpp"
 
+#include "routing/aligned_arrays.hpp"
 #include "routing/routing_exceptions.hpp"
 
+#include "base/checked_cast.hpp"
+
 namespace routing
 {
 void JointIndex::Build(RoadIndex const & roadIndex, uint32_t numJoints)
 {
   // + 1 is protection for 'End' method from out of bounds.
   // Call End(numJoints-1) requires more size, so add one more item.
-  // Therefore m_offsets.size() == numJoints + 1,
-  // And m_offsets.back() == m_points.size()
-  m_offsets.assign(numJoints + 1, 0);
+  // Therefore offsets.size() == numJoints + 1,
+  // And offsets.back() == number of points
+  std::vector<uint32_t> & offsets = m_offsetsStorage;
+  offsets.assign(numJoints + 1, 0);
 
   // Calculate sizes.
   // Example for numJoints = 6:
   // 2, 5, 3, 4, 2, 3, 0
-  roadIndex.ForEachRoad([this, numJoints](uint32_t /* featureId */, RoadJointIds const & road) {
-    road.ForEachJoint([this, numJoints](uint32_t /* pointId */, Joint::Id jointId) {
+  roadIndex.ForEachRoad([&offsets, numJoints](uint32_t /* featureId */, RoadJointIds const & road) {
+    road.ForEachJoint([&offsets, numJoints](uint32_t /* pointId */, Joint::Id jointId) {
       UNUSED_VALUE(numJoints);
       ASSERT_LESS(jointId, numJoints, ());
-      ++m_offsets[jointId];
+      ++offsets[jointId];
     });
   });
 
   // Fill offsets with end bounds.
   // Example: 2, 7, 10, 14, 16, 19, 19
-  for (size_t i = 1; i < m_offsets.size(); ++i)
-    m_offsets[i] += m_offsets[i - 1];
+  for (size_t i = 1; i < offsets.size(); ++i)
+    offsets[i] += offsets[i - 1];
 
-  m_points.resize(m_offsets.back());
+  m_featureIdsStorage.resize(offsets.back());
+  m_pointIdsStorage.resize(offsets.back());
 
   // Now fill points.
   // Offsets after this operation are begin bounds:
   // 0, 2, 7, 10, 14, 16, 19
-  roadIndex.ForEachRoad([this](uint32_t featureId, RoadJointIds const & road) {
-    road.ForEachJoint([this, featureId](uint32_t pointId, Joint::Id jointId) {
-      uint32_t & offset = m_offsets[jointId];
+  roadIndex.ForEachRoad([this, &offsets](uint32_t featureId, RoadJointIds const & road) {
+    road.ForEachJoint([this, &offsets, featureId](uint32_t pointId, Joint::Id jointId) {
+      uint32_t & offset = offsets[jointId];
       --offset;
-      m_points[offset] = {featureId, pointId};
+      m_featureIdsStorage[offset] = featureId;
+      m_pointIdsStorage[offset] = pointId;
     });
   });
 
-  CHECK_EQUAL(m_offsets[0], 0, ());
-  CHECK_EQUAL(m_offsets.back(), m_points.size(), ());
+  CHECK_EQUAL(offsets[0], 0, ());
+  CHECK_EQUAL(offsets.back(), m_featureIdsStorage.size(), ());
+
+  m_offsets = offsets.data();
+  m_offsetsNumber = base::checked_cast<uint32_t>(offsets.size());
+  m_featureIds = m_featureIdsStorage.data();
+  m_pointIds = m_pointIdsStorage.data();
+  m_pointsNumber = base::checked_cast<uint32_t>(m_featureIdsStorage.size());
+}
+
+void JointIndex::WriteArrays(ArraysWriter & writer) const
+{
+  uint32_t const header[] = {m_offsetsNumber, m_pointsNumber};
+  writer.Write<uint32_t>(2 /* count */, [&header](uint64_t i) { return header[i]; });
+  writer.Write<uint32_t>(m_offsetsNumber, [this](uint64_t i) { return m_offsets[i]; });
+  writer.Write<uint32_t>(m_pointsNumber, [this](uint64_t i) { return m_featureIds[i]; });
+  writer.Write<uint32_t>(m_pointsNumber, [this](uint64_t i) { return m_pointIds[i]; });
+}
+
+void JointIndex::ReadArrays(ArraysReader & reader)
+{
+  uint32_t const * header = reader.Read<uint32_t>(2 /* count */);
+  uint32_t const offsetsNumber = header[0];
+  uint32_t const pointsNumber = header[1];
+
+  uint32_t const * offsets = reader.Read<uint32_t>(offsetsNumber);
+  uint32_t const * featureIds = reader.Read<uint32_t>(pointsNumber);
+  uint32_t const * pointIds = reader.Read<uint32_t>(pointsNumber);
+  if (offsetsNumber == 0 || offsets[0] != 0 || offsets[offsetsNumber - 1] != pointsNumber)
+  {
+    MYTHROW(CorruptedDataException,
+            ("Wrong joint index, offsets:", offsetsNumber, "points:", pointsNumber));
+  }
+
+  m_offsetsStorage.clear();
+  m_featureIdsStorage.clear();
+  m_pointIdsStorage.clear();
+  m_offsets = offsets;
+  m_offsetsNumber = offsetsNumber;
+  m_featureIds = featureIds;
+  m_pointIds = pointIds;
+  m_pointsNumber = pointsNumber;
 }
 }  // namespace routing
@@ -11,37 +11,59 @@
 
 namespace routing
 {
+class ArraysReader;
+class ArraysWriter;
+
 // JointIndex contains mapping from Joint::Id to RoadPoints.
 //
 // It is vector<Joint> conceptually.
-// Technically Joint entries are joined into the single vector to reduce allocations overheads.
+// Technically Joint entries are joined into the single array to reduce allocations overheads.
+// The arrays are either kept by the index or used in place, see ReadArrays().
 class JointIndex final
 {
 public:
+  JointIndex() = default;
+  // The arrays may point to the vectors of the index.
+  JointIndex(JointIndex const &) = delete;
+  JointIndex & operator=(JointIndex const &) = delete;
+
   // Read comments in Build method about -1.
   uint32_t GetNumJoints() const
   {
-    CHECK_GREATER(m_offsets.size(), 0, ());
-    return static_cast<uint32_t>(m_offsets.size() - 1);
+    CHECK_GREATER(m_offsetsNumber, 0, ());
+    return m_offsetsNumber - 1;
   }
 
-  uint32_t GetNumPoints() const { return static_cast<uint32_t>(m_points.size()); }
-  RoadPoint GetPoint(Joint::Id jointId) const { return m_points[Begin(jointId)]; }
+  uint32_t GetNumPoints() const { return m_pointsNumber; }
+  RoadPoint GetPoint(Joint::Id jointId) const { return GetPointByIndex(Begin(jointId)); }
 
   template <typename F>
   void ForEachPoint(Joint::Id jointId, F && f) const
   {
     for (uint32_t i = Begin(jointId); i < End(jointId); ++i)
-      f(m_points[i]);
+      f(GetPointByIndex(i));
+  }
+
+  /// \returns approximate size of the index in bytes. Arrays which are used in place
+  /// aren't counted.
+  size_t GetMemorySize() const
+  {
+    return (m_offsetsStorage.capacity() + m_featureIdsStorage.capacity() +
+            m_pointIdsStorage.capacity()) *
+           sizeof(uint32_t);
   }
 
   void Build(RoadIndex const & roadIndex, uint32_t numJoints);
 
+  void WriteArrays(ArraysWriter & writer) const;
+  /// \brief Uses the arrays of |reader| in place. The memory of the reader must outlive the index.
+  void ReadArrays(ArraysReader & reader);
+
 private:
   // Begin index for jointId entries.
   uint32_t Begin(Joint::Id jointId) const
   {
-    ASSERT_LESS(jointId, m_offsets.size(), ());
+    ASSERT_LESS(jointId, m_offsetsNumber, ());
     return m_offsets[jointId];
   }
 
@@ -49,11 +71,25 @@ private:
   uint32_t End(Joint::Id jointId) const
   {
     Joint::Id const nextId = jointId + 1;
-    ASSERT_LESS(nextId, m_offsets.size(), ());
+    ASSERT_LESS(nextId, m_offsetsNumber, ());
     return m_offsets[nextId];
   }
 
-  std::vector<uint32_t> m_offsets;
-  std::vector<RoadPoint> m_points;
+  RoadPoint GetPointByIndex(uint32_t i) const
+  {
+    ASSERT_LESS(i, m_pointsNumber, ());
+    return {m_featureIds[i], m_pointIds[i]};
+  }
+
+  std::vector<uint32_t> m_offsetsStorage;
+  std::vector<uint32_t> m_featureIdsStorage;
+  std::vector<uint32_t> m_pointIdsStorage;
+
+  uint32_t const * m_offsets = nullptr;
+  uint32_t m_offsetsNumber = 0;
+  // Road points are kept as two arrays of feature ids and point ids.
+  uint32_t const * m_featureIds = nullptr;
+  uint32_t const * m_pointIds = nullptr;
+  uint32_t m_pointsNumber = 0;
 };
 }  // namespace routing
@@ -0,0 +1,65 @@
+#include "routing/joint_landmarks.hpp"
+
+#include "routing/index_graph.hpp"
+
+#include "indexer/data_source.hpp"
+
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include <utility>
+
+#include "defines.hpp"
+
+namespace routing
+{
+using namespace std;
+
+JointLandmarks::JointLandmarks(RoadPieces && pieces, LandmarkDistances && distances)
+  : m_pieces(move(pieces)), m_distances(move(distances))
+{
+  CHECK_EQUAL(m_distances.GetNumVertices(), m_pieces.GetNumVertices(), ());
+}
+
+JointLandmarks BuildJointLandmarks(IndexGraph const & graph, uint32_t numLandmarks)
+{
+  base::Timer timer;
+
+  RoadPieces pieces(graph);
+  LandmarkDistancesBuilder builder(pieces.GetNumVertices());
+  pieces.ForEachEdge(graph, [&builder](RoadPieces::Vertex from, RoadPieces::Vertex to,
+                                       RouteWeight const & weight) {
+    // Only the weight itself, penalties of RouteWeight depend on road access.
+    builder.AddEdge(from, to, weight.GetWeight());
+  });
+
+  LandmarkDistances distances;
+  builder.Build(numLandmarks, distances);
+
+  LOG(LINFO, ("Landmarks are built in", timer.ElapsedSeconds(), "seconds. Road pieces:",
+              pieces.GetSize(), "landmarks:", distances.GetNumLandmarks()));
+  return JointLandmarks(move(pieces), move(distances));
+}
+
+unique_ptr<JointLandmarks> LoadJointLandmarks(MwmValue const & mwmValue)
+{
+  if (!mwmValue.m_cont.IsExist(ROUTING_LANDMARKS_FILE_TAG))
+    return nullptr;
+
+  try
+  {
+    auto const reader = mwmValue.m_cont.GetReader(ROUTING_LANDMARKS_FILE_TAG);
+    ReaderSource<FilesContainerR::TReader> src(reader);
+
+    auto landmarks = make_unique<JointLandmarks>();
+    landmarks->Deserialize(src);
+    return landmarks;
+  }
+  catch (Reader::Exception const & e)
+  {
+    LOG(LERROR, ("File", mwmValue.GetCountryFileName(), "Error while reading",
+                 ROUTING_LANDMARKS_FILE_TAG, "section.", e.Msg()));
+    return nullptr;
+  }
+}
+}  // namespace routing
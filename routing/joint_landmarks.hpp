@@ -0,0 +1,101 @@
+#pragma once
+
+#include "routing/base/landmark_distances.hpp"
+#include "routing/road_pieces.hpp"
+#include "routing/segment.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+
+#include <cstdint>
+#include <memory>
+
+class MwmValue;
+
+namespace routing
+{
+class IndexGraph;
+
+/// \brief Landmark distances over road pieces of the car IndexGraph of one mwm. A vertex is
+/// a vertex of RoadPieces, the distance from piece |u| to piece |v| is the weight of a route
+/// from the end of |u| to the end of |v| in seconds. The distances are calculated without
+/// restrictions, road access and traffic, so they are not greater than the weights the router
+/// calculates and may be used for an admissible A* heuristic.
+class JointLandmarks final
+{
+public:
+  using Vertex = RoadPieces::Vertex;
+
+  struct Header
+  {
+    template <typename Sink>
+    void Serialize(Sink & sink) const
+    {
+      WriteToSink(sink, m_version);
+      WriteToSink(sink, m_endianness);
+    }
+
+    template <typename Source>
+    void Deserialize(Source & src)
+    {
+      m_version = ReadPrimitiveFromSource<uint16_t>(src);
+      m_endianness = ReadPrimitiveFromSource<uint16_t>(src);
+    }
+
+    uint16_t m_version = 0;
+    // Field |m_endianness| is reserved for endianness of the section.
+    uint16_t m_endianness = 0;
+  };
+
+  static uint16_t constexpr kLastVersion = 0;
+
+  JointLandmarks() = default;
+  JointLandmarks(RoadPieces && pieces, LandmarkDistances && distances);
+
+  RoadPieces const & GetPieces() const { return m_pieces; }
+  LandmarkDistances const & GetDistances() const { return m_distances; }
+
+  /// \returns vertex of the directed road piece which contains |segment| or
+  /// |RoadPieces::kInvalidVertex| if there's no such piece.
+  Vertex GetVertex(Segment const & segment) const { return m_pieces.GetVertex(segment); }
+
+  template <typename Sink>
+  void Serialize(Sink & sink) const
+  {
+    Header header;
+    header.m_version = kLastVersion;
+    header.Serialize(sink);
+
+    m_pieces.Serialize(sink);
+    m_distances.Serialize(sink);
+  }
+
+  template <typename Source>
+  void Deserialize(Source & src)
+  {
+    Header header;
+    header.Deserialize(src);
+    CHECK_EQUAL(header.m_version, kLastVersion, ("Unknown landmarks section version."));
+
+    m_pieces.Deserialize(src);
+    m_distances.Deserialize(src);
+    CHECK_EQUAL(m_distances.GetNumVertices(), m_pieces.GetNumVertices(), ());
+  }
+
+private:
+  RoadPieces m_pieces;
+  LandmarkDistances m_distances;
+};
+
+/// \brief Selects |numLandmarks| landmarks on road pieces of |graph| and calculates
+/// the distances.
+/// \note |graph| should be loaded without restrictions and road access, otherwise
+/// the distances may be greater than the weights of routes built with another road access.
+JointLandmarks BuildJointLandmarks(IndexGraph const & graph, uint32_t numLandmarks);
+
+/// \returns landmarks of the mwm or nullptr if there's no ROUTING_LANDMARKS_FILE_TAG section
+/// or it can't be read.
+std::unique_ptr<JointLandmarks> LoadJointLandmarks(MwmValue const & mwmValue);
+}  // namespace routing
@@ -0,0 +1,53 @@
+#include "routing/landmark_heuristic.hpp"
+
+#include "base/assert.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace routing
+{
+using namespace std;
+
+LandmarkHeuristic::LandmarkHeuristic(Graph & graph, JointSegment const & startJoint,
+                                     JointSegment const & finishJoint, Ending && start,
+                                     Ending && finish)
+  : m_graph(graph)
+  , m_startJoint(startJoint)
+  , m_finishJoint(finishJoint)
+  , m_start(move(start))
+  , m_finish(move(finish))
+{
+}
+
+RouteWeight LandmarkHeuristic::HeuristicCostEstimate(JointSegment const & from,
+                                                     JointSegment const & to)
+{
+  ASSERT(to == m_startJoint || to == m_finishJoint, ());
+
+  RouteWeight const heuristic = m_graph.HeuristicCostEstimate(from, to);
+
+  bool const toFinish = to == m_finishJoint;
+  auto const & ending = toFinish ? m_finish : m_start;
+  if (ending.IsEmpty() || from.IsFake() || from.GetMwmId() != ending.m_mwmId)
+    return heuristic;
+
+  Vertex const v = ending.m_landmarks->GetVertex(from.GetSegment(false /* start */));
+  if (v == RoadPieces::kInvalidVertex)
+    return heuristic;
+
+  return max(heuristic, RouteWeight(GetLowerBound(ending, v, toFinish)));
+}
+
+double LandmarkHeuristic::GetLowerBound(Ending const & ending, Vertex v, bool toEnding) const
+{
+  auto const & distances = ending.m_landmarks->GetDistances();
+  double bound = numeric_limits<double>::max();
+  for (auto const & [u, weight] : ending.m_vertices)
+  {
+    double const distance = toEnding ? distances.GetLowerBound(v, u) : distances.GetLowerBound(u, v);
+    bound = min(bound, distance - weight);
+  }
+  return max(bound, 0.0);
+}
+}  // namespace routing
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "routing/base/astar_graph.hpp"
+#include "routing/joint_landmarks.hpp"
+#include "routing/joint_segment.hpp"
+#include "routing/route_weight.hpp"
+
+#include "routing_common/num_mwm_id.hpp"
+
+#include <utility>
+#include <vector>
+
+namespace routing
+{
+/// \brief A* heuristic for the graph of JointSegment (IndexGraphStarterJoints) which is
+/// the maximum of the heuristic of the graph and the landmark lower bound (ALT).
+/// Landmarks of an mwm are used only for vertices of the same mwm as the start or the finish,
+/// for the rest of vertices the heuristic of the graph is returned.
+class LandmarkHeuristic final : public astar::Heuristic<JointSegment, RouteWeight>
+{
+public:
+  using Graph = AStarGraph<JointSegment, JointEdge, RouteWeight>;
+  using Vertex = JointLandmarks::Vertex;
+
+  /// \brief The start or the finish of a search with landmarks of its mwm.
+  struct Ending
+  {
+    bool IsEmpty() const { return m_landmarks == nullptr || m_vertices.empty(); }
+
+    NumMwmId m_mwmId = kFakeNumMwmId;
+    JointLandmarks const * m_landmarks = nullptr;
+    // Road pieces of the ending with weights which are subtracted from the bound. A distance
+    // between pieces is measured between their ends, so the weight of a finish piece is
+    // the weight of the whole piece, the finish may be at its beginning.
+    std::vector<std::pair<Vertex, double>> m_vertices;
+  };
+
+  LandmarkHeuristic(Graph & graph, JointSegment const & startJoint,
+                    JointSegment const & finishJoint, Ending && start, Ending && finish);
+
+  // astar::Heuristic overrides:
+  RouteWeight HeuristicCostEstimate(JointSegment const & from, JointSegment const & to) override;
+
+private:
+  // \returns lower bound of the weight from |ending| to |v| if |toEnding| is false and from |v|
+  // to |ending| otherwise.
+  double GetLowerBound(Ending const & ending, Vertex v, bool toEnding) const;
+
+  Graph & m_graph;
+  JointSegment const m_startJoint;
+  JointSegment const m_finishJoint;
+  Ending const m_start;
+  Ending const m_finish;
+};
+}  // namespace routing
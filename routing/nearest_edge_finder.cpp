@@ -45,12 +45,19 @@ void NearestEdgeFinder::AddInformationSource(IRoadGraph::FullRoadInfo const & ro
 
   // Closest point to |this->m_point| found. It has index |res.m_segId + 1| in |junctions|.
   size_t const idx = res.m_segId + 1;
-  geometry::PointWithAltitude const & segStart = junctions[idx - 1];
-  geometry::PointWithAltitude const & segEnd = junctions[idx];
+  AddClosestSegment(roadInfo.m_featureId, roadInfo.m_roadInfo.m_bidirectional, res.m_segId,
+                    junctions[idx - 1], junctions[idx]);
+}
+
+void NearestEdgeFinder::AddClosestSegment(FeatureID const & featureId, bool bidirectional,
+                                          uint32_t segId,
+                                          geometry::PointWithAltitude const & segStart,
+                                          geometry::PointWithAltitude const & segEnd)
+{
+  Candidate res;
   geometry::Altitude const startAlt = segStart.GetAltitude();
   geometry::Altitude const endAlt = segEnd.GetAltitude();
-  m2::ParametrizedSegment<m2::PointD> segment(junctions[idx - 1].GetPoint(),
-                                              junctions[idx].GetPoint());
+  m2::ParametrizedSegment<m2::PointD> segment(segStart.GetPoint(), segEnd.GetPoint());
   m2::PointD const closestPoint = segment.ClosestPointTo(m_point);
 
   double const segLenM = mercator::DistanceOnEarth(segStart.GetPoint(), segEnd.GetPoint());
@@ -62,15 +69,17 @@ void NearestEdgeFinder::AddInformationSource(IRoadGraph::FullRoadInfo const & ro
   else
   {
     double const distFromStartM = mercator::DistanceOnEarth(segStart.GetPoint(), closestPoint);
-    ASSERT_LESS_OR_EQUAL(distFromStartM, segLenM, (roadInfo.m_featureId));
+    ASSERT_LESS_OR_EQUAL(distFromStartM, segLenM, (featureId));
     projPointAlt =
         startAlt + static_cast<geometry::Altitude>((endAlt - startAlt) * distFromStartM / segLenM);
   }
 
-  res.m_fid = roadInfo.m_featureId;
+  res.m_squaredDist = m_point.SquaredLength(closestPoint);
+  res.m_segId = segId;
+  res.m_fid = featureId;
   res.m_segStart = segStart;
   res.m_segEnd = segEnd;
-  res.m_bidirectional = roadInfo.m_roadInfo.m_bidirectional;
+  res.m_bidirectional = bidirectional;
 
   ASSERT_NOT_EQUAL(res.m_segStart.GetAltitude(), geometry::kInvalidAltitude, ());
   ASSERT_NOT_EQUAL(res.m_segEnd.GetAltitude(), geometry::kInvalidAltitude, ());
@@ -31,7 +31,14 @@ public:
 
   inline bool HasCandidates() const { return !m_candidates.empty(); }
 
+  m2::PointD const & GetPoint() const { return m_point; }
+
   void AddInformationSource(IRoadGraph::FullRoadInfo const & roadInfo);
+  /// \brief Adds segment |segId| of road |featureId| which is the closest segment of the road to
+  /// the point. It's the same as AddInformationSource() when the closest segment is already known.
+  void AddClosestSegment(FeatureID const & featureId, bool bidirectional, uint32_t segId,
+                         geometry::PointWithAltitude const & segStart,
+                         geometry::PointWithAltitude const & segEnd);
 
   using EdgeProjectionT = std::pair<Edge, geometry::PointWithAltitude>;
   void MakeResult(std::vector<EdgeProjectionT> & res, size_t maxCountFeatures);
@@ -0,0 +1,204 @@
+#include "routing/road_geometry_section.hpp"
+
+#include "routing/aligned_arrays.hpp"
+#include "routing/routing_exceptions.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include "platform/local_country_file.hpp"
+
+#include "coding/endianness.hpp"
+#include "coding/files_container.hpp"
+#include "coding/reader.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/checked_cast.hpp"
+#include "base/logging.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "defines.hpp"
+
+namespace routing
+{
+using namespace std;
+
+// RoadGeometrySection -----------------------------------------------------------------------------
+RoadGeometrySection::RoadGeometrySection(unique_ptr<MemoryRegion> region) : m_region(move(region))
+{
+  CHECK(m_region, ());
+
+  MemReader memReader(m_region->ImmutableData(), m_region->Size());
+  ReaderSource<MemReader> src(memReader);
+  m_header.m_version = ReadPrimitiveFromSource<uint16_t>(src);
+  if (m_header.m_version != kLastVersion)
+    MYTHROW(CorruptedDataException, ("Unknown routing geometry version:", m_header.m_version));
+
+  m_header.m_coordBits = ReadPrimitiveFromSource<uint8_t>(src);
+  m_header.m_flags = ReadPrimitiveFromSource<uint8_t>(src);
+  m_header.m_roadsNumber = ReadPrimitiveFromSource<uint32_t>(src);
+  m_header.m_pointsNumber = ReadPrimitiveFromSource<uint32_t>(src);
+
+  ArraysReader reader(m_region->ImmutableData(), m_region->Size(), src.Pos(),
+                      "Routing geometry section");
+  uint64_t const roadsNumber = m_header.m_roadsNumber;
+  uint64_t const pointsNumber = m_header.m_pointsNumber;
+
+  m_featureIds = reader.Read<uint32_t>(roadsNumber);
+  m_pointOffsets = reader.Read<uint32_t>(roadsNumber + 1);
+  m_pointsX = reader.Read<uint32_t>(pointsNumber);
+  m_pointsY = reader.Read<uint32_t>(pointsNumber);
+  if (HasAltitudes())
+    m_altitudes = reader.Read<int16_t>(pointsNumber);
+  m_routingOptions = reader.Read<uint8_t>(roadsNumber);
+
+  for (auto & vehicle : m_vehicles)
+  {
+    vehicle.m_flags = reader.Read<uint8_t>(roadsNumber);
+    vehicle.m_highwayTypes = reader.Read<uint16_t>(roadsNumber);
+    for (auto & speeds : vehicle.m_speeds)
+      speeds = reader.Read<float>(roadsNumber);
+  }
+
+  if (m_pointOffsets[roadsNumber] != pointsNumber)
+  {
+    MYTHROW(CorruptedDataException, ("Wrong points number:", m_pointOffsets[roadsNumber],
+                                     "expected:", pointsNumber));
+  }
+}
+
+// static
+unique_ptr<RoadGeometrySection> RoadGeometrySection::Load(MwmValue const & mwmValue)
+{
+  // Arrays are used in place, so they must have the host byte order.
+  if (IsBigEndianMacroBased() || !mwmValue.m_cont.IsExist(ROUTING_GEOMETRY_FILE_TAG))
+    return nullptr;
+
+  try
+  {
+    return make_unique<RoadGeometrySection>(MapSection(mwmValue, ROUTING_GEOMETRY_FILE_TAG));
+  }
+  catch (RootException const & e)
+  {
+    LOG(LERROR, ("File", mwmValue.GetCountryFileName(), "Error while reading",
+                 ROUTING_GEOMETRY_FILE_TAG, "section.", e.Msg()));
+    return nullptr;
+  }
+}
+
+optional<uint32_t> RoadGeometrySection::FindRoad(uint32_t featureId) const
+{
+  auto const * end = m_featureIds + m_header.m_roadsNumber;
+  auto const * it = lower_bound(m_featureIds, end, featureId);
+  if (it == end || *it != featureId)
+    return {};
+
+  return static_cast<uint32_t>(it - m_featureIds);
+}
+
+optional<HighwayType> RoadGeometrySection::GetHighwayType(VehicleType vehicleType,
+                                                          uint32_t roadIdx) const
+{
+  uint16_t const type = GetVehicle(vehicleType).m_highwayTypes[CheckRoad(roadIdx)];
+  if (type == 0)
+    return {};
+
+  return static_cast<HighwayType>(type);
+}
+
+SpeedKMpH RoadGeometrySection::GetSpeed(VehicleType vehicleType, uint32_t roadIdx,
+                                        bool forward) const
+{
+  auto const & speeds = GetVehicle(vehicleType).m_speeds;
+  CheckRoad(roadIdx);
+  return forward ? SpeedKMpH(speeds[kForwardWeight][roadIdx], speeds[kForwardEta][roadIdx])
+                 : SpeedKMpH(speeds[kBackwardWeight][roadIdx], speeds[kBackwardEta][roadIdx]);
+}
+
+// RoadGeometrySectionBuilder ----------------------------------------------------------------------
+RoadGeometrySectionBuilder::RoadGeometrySectionBuilder(uint8_t coordBits, bool hasAltitudes)
+  : m_coordBits(coordBits), m_hasAltitudes(hasAltitudes)
+{
+}
+
+void RoadGeometrySectionBuilder::AddRoad(Road && road)
+{
+  CHECK(m_roads.empty() || m_roads.back().m_featureId < road.m_featureId, (road.m_featureId));
+  CHECK(road.m_altitudes.empty() || road.m_altitudes.size() == road.m_points.size(),
+        (road.m_featureId));
+
+  m_pointsNumber += base::checked_cast<uint32_t>(road.m_points.size());
+  m_roads.push_back(move(road));
+}
+
+void RoadGeometrySectionBuilder::Serialize(Writer & writer) const
+{
+  using Section = RoadGeometrySection;
+
+  vector<uint32_t> pointOffsets = {0};
+  vector<m2::PointU> points;
+  geometry::Altitudes altitudes;
+  points.reserve(m_pointsNumber);
+  for (auto const & road : m_roads)
+  {
+    for (size_t i = 0; i < road.m_points.size(); ++i)
+    {
+      points.push_back(PointDToPointU(road.m_points[i], m_coordBits));
+      if (m_hasAltitudes)
+      {
+        altitudes.push_back(road.m_altitudes.empty() ? geometry::kDefaultAltitudeMeters
+                                                     : road.m_altitudes[i]);
+      }
+    }
+    pointOffsets.push_back(base::checked_cast<uint32_t>(points.size()));
+  }
+
+  WriteToSink(writer, Section::kLastVersion);
+  WriteToSink(writer, m_coordBits);
+  WriteToSink(writer, static_cast<uint8_t>(m_hasAltitudes ? Section::kHasAltitudes : 0));
+  WriteToSink(writer, base::checked_cast<uint32_t>(m_roads.size()));
+  WriteToSink(writer, m_pointsNumber);
+
+  ArraysWriter arrays(writer);
+  auto const roadsNumber = m_roads.size();
+  arrays.Write<uint32_t>(roadsNumber, [&](uint64_t i) { return m_roads[i].m_featureId; });
+  arrays.Write<uint32_t>(pointOffsets.size(), [&](uint64_t i) { return pointOffsets[i]; });
+  arrays.Write<uint32_t>(points.size(), [&](uint64_t i) { return points[i].x; });
+  arrays.Write<uint32_t>(points.size(), [&](uint64_t i) { return points[i].y; });
+  if (m_hasAltitudes)
+    arrays.Write<int16_t>(altitudes.size(), [&](uint64_t i) { return altitudes[i]; });
+  arrays.Write<uint8_t>(roadsNumber, [&](uint64_t i) {
+    return m_roads[i].m_routingOptions.GetOptions();
+  });
+
+  for (size_t v = 0; v < Section::kVehiclesNumber; ++v)
+  {
+    auto const getAttrs = [&](uint64_t i) -> VehicleAttrs const & {
+      return m_roads[i].m_vehicles[v];
+    };
+
+    arrays.Write<uint8_t>(roadsNumber, [&](uint64_t i) {
+      auto const & attrs = getAttrs(i);
+      uint8_t flags = 0;
+      if (attrs.m_valid)
+        flags |= Section::kValid;
+      if (attrs.m_isOneWay)
+        flags |= Section::kOneWay;
+      if (attrs.m_isPassThroughAllowed)
+        flags |= Section::kPassThroughAllowed;
+      if (m_roads[i].m_inCity)
+        flags |= Section::kInCity;
+      return flags;
+    });
+    arrays.Write<uint16_t>(roadsNumber, [&](uint64_t i) {
+      auto const & type = getAttrs(i).m_highwayType;
+      return type ? static_cast<uint16_t>(*type) : 0;
+    });
+    arrays.WriteFloats(roadsNumber, [&](uint64_t i) { return getAttrs(i).m_forwardSpeed.m_weight; });
+    arrays.WriteFloats(roadsNumber, [&](uint64_t i) { return getAttrs(i).m_forwardSpeed.m_eta; });
+    arrays.WriteFloats(roadsNumber, [&](uint64_t i) { return getAttrs(i).m_backwardSpeed.m_weight; });
+    arrays.WriteFloats(roadsNumber, [&](uint64_t i) { return getAttrs(i).m_backwardSpeed.m_eta; });
+  }
+}
+}  // namespace routing
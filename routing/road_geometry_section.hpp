@@ -0,0 +1,196 @@
+#pragma once
+
+#include "routing/routing_options.hpp"
+#include "routing/vehicle_mask.hpp"
+
+#include "routing_common/vehicle_model.hpp"
+
+#include "coding/memory_region.hpp"
+#include "coding/point_coding.hpp"
+#include "coding/writer.hpp"
+
+#include "geometry/point2d.hpp"
+#include "geometry/point_with_altitude.hpp"
+
+#include "base/assert.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+class MwmValue;
+
+namespace routing
+{
+/// \brief ROUTING_GEOMETRY_FILE_TAG section. It keeps points of roads and road attributes which
+/// routing needs, so roads are loaded without decoding of features, their types and maxspeeds.
+/// Attributes are calculated with vehicle models, city roads and maxspeeds at the time of
+/// generation, the same way as the routing section is.
+/// The section is a structure of arrays. All the arrays are little-endian and 4-byte aligned,
+/// so the section is used right from the mapped memory without deserialization:
+///   Header
+///   uint32_t featureIds[roadsNumber], ascending
+///   uint32_t pointOffsets[roadsNumber + 1]
+///   uint32_t pointsX[pointsNumber], pointsY[pointsNumber], coded with |coordBits| of the header
+///   int16_t altitudes[pointsNumber], if the header has kHasAltitudes flag
+///   uint8_t routingOptions[roadsNumber]
+///   for every VehicleType from Pedestrian to Car:
+///     uint8_t flags[roadsNumber], see RoadFlags
+///     uint16_t highwayTypes[roadsNumber], 0 means no highway type
+///     float speeds[kSpeedsNumber][roadsNumber], see Speed
+class RoadGeometrySection final
+{
+public:
+  static uint16_t constexpr kLastVersion = 0;
+  // Transit has no attributes of its own, it uses pedestrian roads.
+  static size_t constexpr kVehiclesNumber = static_cast<size_t>(VehicleType::Car) + 1;
+
+  enum HeaderFlags : uint8_t
+  {
+    kHasAltitudes = 1 << 0,
+  };
+
+  enum RoadFlags : uint8_t
+  {
+    kValid = 1 << 0,
+    kOneWay = 1 << 1,
+    kPassThroughAllowed = 1 << 2,
+    kInCity = 1 << 3,
+  };
+
+  enum Speed : uint8_t
+  {
+    kForwardWeight = 0,
+    kForwardEta,
+    kBackwardWeight,
+    kBackwardEta,
+    kSpeedsNumber
+  };
+
+  struct Header
+  {
+    uint16_t m_version = kLastVersion;
+    uint8_t m_coordBits = 0;
+    uint8_t m_flags = 0;
+    uint32_t m_roadsNumber = 0;
+    uint32_t m_pointsNumber = 0;
+  };
+
+  explicit RoadGeometrySection(std::unique_ptr<MemoryRegion> region);
+
+  /// \returns the section of |mwmValue| mapped to memory or nullptr if there's no such section
+  /// or it can't be used.
+  static std::unique_ptr<RoadGeometrySection> Load(MwmValue const & mwmValue);
+
+  Header const & GetHeader() const { return m_header; }
+  uint32_t GetRoadsNumber() const { return m_header.m_roadsNumber; }
+  bool HasAltitudes() const { return (m_header.m_flags & kHasAltitudes) != 0; }
+
+  /// \returns index of the road of |featureId| or std::nullopt if the feature isn't a road.
+  std::optional<uint32_t> FindRoad(uint32_t featureId) const;
+
+  uint32_t GetFeatureId(uint32_t roadIdx) const { return m_featureIds[CheckRoad(roadIdx)]; }
+  uint32_t GetPointsBegin(uint32_t roadIdx) const { return m_pointOffsets[CheckRoad(roadIdx)]; }
+  uint32_t GetPointsEnd(uint32_t roadIdx) const { return m_pointOffsets[CheckRoad(roadIdx) + 1]; }
+
+  m2::PointD GetPoint(uint32_t pointIdx) const
+  {
+    ASSERT_LESS(pointIdx, m_header.m_pointsNumber, ());
+    return PointUToPointD(m2::PointU(m_pointsX[pointIdx], m_pointsY[pointIdx]),
+                          m_header.m_coordBits);
+  }
+
+  geometry::Altitude GetAltitude(uint32_t pointIdx) const
+  {
+    ASSERT(HasAltitudes(), ());
+    ASSERT_LESS(pointIdx, m_header.m_pointsNumber, ());
+    return m_altitudes[pointIdx];
+  }
+
+  RoutingOptions GetRoutingOptions(uint32_t roadIdx) const
+  {
+    return RoutingOptions(m_routingOptions[CheckRoad(roadIdx)]);
+  }
+
+  uint8_t GetFlags(VehicleType vehicleType, uint32_t roadIdx) const
+  {
+    return GetVehicle(vehicleType).m_flags[CheckRoad(roadIdx)];
+  }
+
+  std::optional<HighwayType> GetHighwayType(VehicleType vehicleType, uint32_t roadIdx) const;
+  SpeedKMpH GetSpeed(VehicleType vehicleType, uint32_t roadIdx, bool forward) const;
+
+private:
+  struct Vehicle
+  {
+    uint8_t const * m_flags = nullptr;
+    uint16_t const * m_highwayTypes = nullptr;
+    std::array<float const *, kSpeedsNumber> m_speeds = {};
+  };
+
+  uint32_t CheckRoad(uint32_t roadIdx) const
+  {
+    ASSERT_LESS(roadIdx, m_header.m_roadsNumber, ());
+    return roadIdx;
+  }
+
+  Vehicle const & GetVehicle(VehicleType vehicleType) const
+  {
+    auto const idx = static_cast<size_t>(vehicleType);
+    ASSERT_LESS(idx, kVehiclesNumber, ());
+    return m_vehicles[idx];
+  }
+
+  std::unique_ptr<MemoryRegion> m_region;
+  Header m_header;
+
+  uint32_t const * m_featureIds = nullptr;
+  uint32_t const * m_pointOffsets = nullptr;
+  uint32_t const * m_pointsX = nullptr;
+  uint32_t const * m_pointsY = nullptr;
+  int16_t const * m_altitudes = nullptr;
+  uint8_t const * m_routingOptions = nullptr;
+  std::array<Vehicle, kVehiclesNumber> m_vehicles;
+};
+
+/// \brief Collects roads and writes RoadGeometrySection.
+class RoadGeometrySectionBuilder final
+{
+public:
+  struct VehicleAttrs
+  {
+    bool m_valid = false;
+    bool m_isOneWay = false;
+    bool m_isPassThroughAllowed = false;
+    std::optional<HighwayType> m_highwayType;
+    SpeedKMpH m_forwardSpeed;
+    SpeedKMpH m_backwardSpeed;
+  };
+
+  struct Road
+  {
+    uint32_t m_featureId = 0;
+    std::vector<m2::PointD> m_points;
+    // Empty or one altitude for every point.
+    geometry::Altitudes m_altitudes;
+    RoutingOptions m_routingOptions;
+    bool m_inCity = false;
+    std::array<VehicleAttrs, RoadGeometrySection::kVehiclesNumber> m_vehicles;
+  };
+
+  RoadGeometrySectionBuilder(uint8_t coordBits, bool hasAltitudes);
+
+  /// \brief Roads should be added in ascending order of feature ids.
+  void AddRoad(Road && road);
+
+  void Serialize(Writer & writer) const;
+
+private:
+  uint8_t m_coordBits;
+  bool m_hasAltitudes;
+  std::vector<Road> m_roads;
+  uint32_t m_pointsNumber = 0;
+};
+}  // namespace routing
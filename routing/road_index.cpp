@@ -1,7 +1,10 @@
 #include "routing/road_index.hpp"
 
+#include "routing/aligned_arrays.hpp"
 #include "routing/routing_exceptions.hpp"
 
+#include <algorithm>
+
 namespace routing
 {
 void RoadIndex::Import(std::vector<Joint> const & joints)
@@ -10,11 +13,82 @@ void RoadIndex::Import(std::vector<Joint> const & joints)
   {
     Joint const & joint = joints[jointId];
     for (uint32_t i = 0; i < joint.GetSize(); ++i)
-    {
-      RoadPoint const & entry = joint.GetEntry(i);
-      RoadJointIds & roadJoints = m_roads[entry.GetFeatureId()];
-      roadJoints.AddJoint(entry.GetPointId(), jointId);
-    }
+      AddJoint(joint.GetEntry(i), jointId);
+  }
+}
+
+void RoadIndex::AddJoint(RoadPoint const & rp, Joint::Id jointId)
+{
+  ASSERT_NOT_EQUAL(jointId, Joint::kInvalidId, ());
+
+  auto & jointIds = m_addedRoads[rp.GetFeatureId()];
+  uint32_t const pointId = rp.GetPointId();
+  if (pointId >= jointIds.size())
+    jointIds.insert(jointIds.end(), pointId + 1 - jointIds.size(), Joint::kInvalidId);
+
+  ASSERT_EQUAL(jointIds[pointId], Joint::kInvalidId, ());
+  jointIds[pointId] = jointId;
+}
+
+void RoadIndex::Build()
+{
+  uint32_t featuresNumber = 0;
+  size_t jointIdsNumber = 0;
+  for (auto const & [featureId, jointIds] : m_addedRoads)
+  {
+    featuresNumber = std::max(featuresNumber, featureId + 1);
+    jointIdsNumber += jointIds.size();
+  }
+
+  m_offsetsStorage.assign(featuresNumber + 1, 0);
+  for (auto const & [featureId, jointIds] : m_addedRoads)
+    m_offsetsStorage[featureId + 1] = base::checked_cast<uint32_t>(jointIds.size());
+  for (size_t i = 1; i < m_offsetsStorage.size(); ++i)
+    m_offsetsStorage[i] += m_offsetsStorage[i - 1];
+
+  m_jointIdsStorage.resize(jointIdsNumber);
+  for (auto const & [featureId, jointIds] : m_addedRoads)
+    std::copy(jointIds.cbegin(), jointIds.cend(), m_jointIdsStorage.begin() + m_offsetsStorage[featureId]);
+
+  m_offsets = m_offsetsStorage.data();
+  m_jointIds = m_jointIdsStorage.data();
+  m_featuresNumber = featuresNumber;
+  m_roadsNumber = base::checked_cast<uint32_t>(m_addedRoads.size());
+  m_addedRoads.clear();
+}
+
+void RoadIndex::WriteArrays(ArraysWriter & writer) const
+{
+  uint32_t const jointIdsNumber = m_featuresNumber == 0 ? 0 : m_offsets[m_featuresNumber];
+  uint32_t const header[] = {m_featuresNumber, m_roadsNumber, jointIdsNumber};
+  writer.Write<uint32_t>(3 /* count */, [&header](uint64_t i) { return header[i]; });
+  writer.Write<uint32_t>(m_featuresNumber + 1, [this](uint64_t i) {
+    return m_featuresNumber == 0 ? 0 : m_offsets[i];
+  });
+  writer.Write<Joint::Id>(jointIdsNumber, [this](uint64_t i) { return m_jointIds[i]; });
+}
+
+void RoadIndex::ReadArrays(ArraysReader & reader)
+{
+  uint32_t const * header = reader.Read<uint32_t>(3 /* count */);
+  uint32_t const featuresNumber = header[0];
+  uint32_t const roadsNumber = header[1];
+  uint32_t const jointIdsNumber = header[2];
+
+  uint32_t const * offsets = reader.Read<uint32_t>(static_cast<uint64_t>(featuresNumber) + 1);
+  Joint::Id const * jointIds = reader.Read<Joint::Id>(jointIdsNumber);
+  if (offsets[featuresNumber] != jointIdsNumber || roadsNumber > featuresNumber)
+  {
+    MYTHROW(CorruptedDataException, ("Wrong road index, features:", featuresNumber, "roads:",
+                                     roadsNumber, "joint ids:", jointIdsNumber));
   }
+
+  m_addedRoads.clear();
+  m_offsetsStorage.clear();
+  m_jointIdsStorage.clear();
+  m_offsets = offsets;
+  m_jointIds = jointIds;
+  m_featuresNumber = featuresNumber;
+  m_roadsNumber = roadsNumber;
 }
 }  // namespace routing
@@ -13,18 +13,19 @@
 
 namespace routing
 {
+class ArraysReader;
+class ArraysWriter;
+
+/// \brief Joint ids of a road indexed by point id. The ids are kept by RoadIndex.
 class RoadJointIds final
 {
 public:
-  void Init(uint32_t maxPointId)
-  {
-    m_jointIds.clear();
-    m_jointIds.reserve(maxPointId + 1);
-  }
+  RoadJointIds() = default;
+  RoadJointIds(Joint::Id const * jointIds, uint32_t size) : m_jointIds(jointIds), m_size(size) {}
 
   Joint::Id GetJointId(uint32_t pointId) const
   {
-    if (pointId < m_jointIds.size())
+    if (pointId < m_size)
       return m_jointIds[pointId];
 
     return Joint::kInvalidId;
@@ -32,31 +33,20 @@ public:
 
   Joint::Id GetEndingJointId() const
   {
-    if (m_jointIds.empty())
+    if (m_size == 0)
       return Joint::kInvalidId;
 
-    ASSERT_NOT_EQUAL(m_jointIds.back(), Joint::kInvalidId, ());
-    return m_jointIds.back();
-  }
-
-  void AddJoint(uint32_t pointId, Joint::Id jointId)
-  {
-    ASSERT_NOT_EQUAL(jointId, Joint::kInvalidId, ());
-
-    if (pointId >= m_jointIds.size())
-      m_jointIds.insert(m_jointIds.end(), pointId + 1 - m_jointIds.size(), Joint::kInvalidId);
-
-    ASSERT_EQUAL(m_jointIds[pointId], Joint::kInvalidId, ());
-    m_jointIds[pointId] = jointId;
+    ASSERT_NOT_EQUAL(m_jointIds[m_size - 1], Joint::kInvalidId, ());
+    return m_jointIds[m_size - 1];
   }
 
   uint32_t GetJointsNumber() const
   {
     uint32_t count = 0;
 
-    for (Joint::Id const jointId : m_jointIds)
+    for (uint32_t pointId = 0; pointId < m_size; ++pointId)
     {
-      if (jointId != Joint::kInvalidId)
+      if (m_jointIds[pointId] != Joint::kInvalidId)
         ++count;
     }
 
@@ -66,7 +56,7 @@ public:
   template <typename F>
   void ForEachJoint(F && f) const
   {
-    for (uint32_t pointId = 0; pointId < m_jointIds.size(); ++pointId)
+    for (uint32_t pointId = 0; pointId < m_size; ++pointId)
     {
       Joint::Id const jointId = m_jointIds[pointId];
       if (jointId != Joint::kInvalidId)
@@ -105,32 +95,43 @@ public:
 
 private:
   // Joint ids indexed by point id.
-  // If some point id doesn't match any joint id, this vector contains Joint::kInvalidId.
-  std::vector<Joint::Id> m_jointIds;
+  // If some point id doesn't match any joint id, it contains Joint::kInvalidId.
+  // The last id is a joint id.
+  Joint::Id const * m_jointIds = nullptr;
+  uint32_t m_size = 0;
 };
 
+/// \brief Joint ids of roads. Joints are added with AddJoint() or PushFromSerializer() and
+/// then Build() puts them to two arrays indexed by feature id, so a road is found without
+/// hashing. The arrays are either kept by the index or used in place, e.g. right from the mapped
+/// routing section, see ReadArrays().
 class RoadIndex final
 {
 public:
+  RoadIndex() = default;
+  // The arrays may point to the vectors of the index.
+  RoadIndex(RoadIndex const &) = delete;
+  RoadIndex & operator=(RoadIndex const &) = delete;
+
   void Import(std::vector<Joint> const & joints);
 
-  void AddJoint(RoadPoint const & rp, Joint::Id jointId)
-  {
-    m_roads[rp.GetFeatureId()].AddJoint(rp.GetPointId(), jointId);
-  }
+  void AddJoint(RoadPoint const & rp, Joint::Id jointId);
 
-  bool IsRoad(uint32_t featureId) const { return m_roads.count(featureId) != 0; }
+  void PushFromSerializer(Joint::Id jointId, RoadPoint const & rp) { AddJoint(rp, jointId); }
 
-  RoadJointIds const & GetRoad(uint32_t featureId) const
+  /// \brief Builds the arrays of the joints which are added. It must be called before using of
+  /// the index.
+  void Build();
+
+  bool IsRoad(uint32_t featureId) const
   {
-    auto const & it = m_roads.find(featureId);
-    CHECK(it != m_roads.cend(), ("Feature id:", featureId));
-    return it->second;
+    return featureId < m_featuresNumber && m_offsets[featureId] != m_offsets[featureId + 1];
   }
 
-  void PushFromSerializer(Joint::Id jointId, RoadPoint const & rp)
+  RoadJointIds GetRoad(uint32_t featureId) const
   {
-    m_roads[rp.GetFeatureId()].AddJoint(rp.GetPointId(), jointId);
+    CHECK(IsRoad(featureId), ("Feature id:", featureId));
+    return MakeRoad(featureId);
   }
 
   // Find nearest point with normal joint id.
@@ -140,26 +141,58 @@ public:
   // If there is no nearest point, return {Joint::kInvalidId, 0}
   std::pair<Joint::Id, uint32_t> FindNeighbor(RoadPoint const & rp, bool forward) const;
 
-  uint32_t GetSize() const { return base::asserted_cast<uint32_t>(m_roads.size()); }
+  uint32_t GetSize() const { return m_roadsNumber; }
 
   Joint::Id GetJointId(RoadPoint const & rp) const
   {
-    auto const it = m_roads.find(rp.GetFeatureId());
-    if (it == m_roads.end())
+    if (rp.GetFeatureId() >= m_featuresNumber)
       return Joint::kInvalidId;
 
-    return it->second.GetJointId(rp.GetPointId());
+    return MakeRoad(rp.GetFeatureId()).GetJointId(rp.GetPointId());
+  }
+
+  /// \returns approximate size of the index in bytes. Arrays which are used in place
+  /// aren't counted.
+  size_t GetMemorySize() const
+  {
+    return m_offsetsStorage.capacity() * sizeof(uint32_t) +
+           m_jointIdsStorage.capacity() * sizeof(Joint::Id);
   }
 
   template <typename F>
   void ForEachRoad(F && f) const
   {
-    for (auto const & it : m_roads)
-      f(it.first, it.second);
+    for (uint32_t featureId = 0; featureId < m_featuresNumber; ++featureId)
+    {
+      if (IsRoad(featureId))
+        f(featureId, MakeRoad(featureId));
+    }
   }
 
+  void WriteArrays(ArraysWriter & writer) const;
+  /// \brief Uses the arrays of |reader| in place. The memory of the reader must outlive the index.
+  void ReadArrays(ArraysReader & reader);
+
 private:
-  // Map from feature id to RoadJointIds.
-  std::unordered_map<uint32_t, RoadJointIds> m_roads;
+  RoadJointIds MakeRoad(uint32_t featureId) const
+  {
+    ASSERT_LESS(featureId, m_featuresNumber, ());
+    uint32_t const begin = m_offsets[featureId];
+    return RoadJointIds(m_jointIds + begin, m_offsets[featureId + 1] - begin);
+  }
+
+  // Joint ids indexed by point id of the roads which are added before Build().
+  std::unordered_map<uint32_t, std::vector<Joint::Id>> m_addedRoads;
+
+  std::vector<uint32_t> m_offsetsStorage;
+  std::vector<Joint::Id> m_jointIdsStorage;
+
+  // Joint ids of feature |featureId| are [m_offsets[featureId], m_offsets[featureId + 1]) of
+  // |m_jointIds|. A feature without joints isn't a road.
+  uint32_t const * m_offsets = nullptr;
+  Joint::Id const * m_jointIds = nullptr;
+  // Max road feature id + 1.
+  uint32_t m_featuresNumber = 0;
+  uint32_t m_roadsNumber = 0;
 };
 }  // namespace routing
@@ -0,0 +1,94 @@
+#include "routing/road_pieces.hpp"
+
+#include "routing/index_graph.hpp"
+#include "routing/joint_segment.hpp"
+#include "routing/road_index.hpp"
+
+#include "base/logging.hpp"
+#include "base/stl_helpers.hpp"
+
+#include <algorithm>
+
+namespace routing
+{
+using namespace std;
+
+RoadPieces::RoadPieces(IndexGraph const & graph)
+{
+  graph.ForEachRoad([&](uint32_t featureId, RoadJointIds const & road) {
+    auto const & geometry = graph.GetRoadGeometry(featureId);
+    if (!geometry.IsValid() || geometry.GetPointsCount() < 2)
+      return;
+
+    uint32_t const pointsCount = geometry.GetPointsCount();
+    vector<uint32_t> bounds = {0, pointsCount - 1};
+    road.ForEachJoint([&](uint32_t pointId, Joint::Id /* jointId */) {
+      if (pointId < pointsCount)
+        bounds.push_back(pointId);
+    });
+    base::SortUnique(bounds);
+
+    for (size_t i = 1; i < bounds.size(); ++i)
+      m_pieces.emplace_back(featureId, bounds[i - 1], bounds[i]);
+  });
+  sort(m_pieces.begin(), m_pieces.end());
+}
+
+RoadPieces::Vertex RoadPieces::GetVertex(Segment const & segment) const
+{
+  uint32_t const featureId = segment.GetFeatureId();
+  uint32_t const segmentIdx = segment.GetSegmentIdx();
+
+  // First piece which starts after the segment.
+  auto const it = upper_bound(m_pieces.cbegin(), m_pieces.cend(), Piece(featureId, segmentIdx, 0));
+  if (it == m_pieces.cbegin())
+    return kInvalidVertex;
+
+  auto const & piece = *prev(it);
+  if (piece.m_featureId != featureId || segmentIdx >= piece.m_endPointId)
+    return kInvalidVertex;
+
+  auto const pieceIdx = static_cast<uint32_t>(distance(m_pieces.cbegin(), prev(it)));
+  return MakeVertex(pieceIdx, segment.IsForward());
+}
+
+void RoadPieces::ForEachEdge(IndexGraph const & graph, EdgeFn const & f) const
+{
+  IndexGraph::Parents<JointSegment> const emptyParents;
+  IndexGraph::JointEdgeListT edges;
+  IndexGraph::WeightListT parentWeights;
+  for (uint32_t i = 0; i < m_pieces.size(); ++i)
+  {
+    auto const & piece = m_pieces[i];
+    bool const oneWay = graph.GetRoadGeometry(piece.m_featureId).IsOneWay();
+    for (bool const forward : {true, false})
+    {
+      if (!forward && oneWay)
+        continue;
+
+      uint32_t const firstIdx = forward ? piece.m_startPointId : piece.m_endPointId - 1;
+      uint32_t const lastIdx = forward ? piece.m_endPointId - 1 : piece.m_startPointId;
+      Segment const first(kFakeNumMwmId, piece.m_featureId, firstIdx, forward);
+      Segment const last(kFakeNumMwmId, piece.m_featureId, lastIdx, forward);
+
+      edges.clear();
+      parentWeights.clear();
+      graph.GetEdgeList(JointSegment(first, last), last, true /* isOutgoing */, edges,
+                        parentWeights, emptyParents);
+
+      Vertex const from = MakeVertex(i, forward);
+      for (auto const & edge : edges)
+      {
+        Vertex const to = GetVertex(edge.GetTarget().GetSegment(true /* start */));
+        if (to == kInvalidVertex)
+        {
+          LOG(LWARNING, ("No road piece for", edge.GetTarget()));
+          continue;
+        }
+
+        f(from, to, edge.GetWeight());
+      }
+    }
+  }
+}
+}  // namespace routing
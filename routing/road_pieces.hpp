@@ -0,0 +1,118 @@
+#pragma once
+
+#include "routing/route_weight.hpp"
+#include "routing/segment.hpp"
+
+#include "routing_common/num_mwm_id.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+#include "base/checked_cast.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace routing
+{
+class IndexGraph;
+
+/// \brief Directed road pieces between two neighbouring joints (or a joint and a road end) of
+/// all roads of IndexGraph of one mwm, i.e. the same thing as JointSegment. Piece with index |i|
+/// gives two vertices: 2 * i for movement along the feature and 2 * i + 1 for the opposite one.
+/// The pieces are used as vertices of precomputed graphs stored in mwm sections.
+class RoadPieces final
+{
+public:
+  using Vertex = uint32_t;
+
+  static Vertex constexpr kInvalidVertex = std::numeric_limits<Vertex>::max();
+
+  struct Piece
+  {
+    Piece() = default;
+    Piece(uint32_t featureId, uint32_t startPointId, uint32_t endPointId)
+      : m_featureId(featureId), m_startPointId(startPointId), m_endPointId(endPointId)
+    {
+    }
+
+    bool operator<(Piece const & rhs) const
+    {
+      if (m_featureId != rhs.m_featureId)
+        return m_featureId < rhs.m_featureId;
+      return m_startPointId < rhs.m_startPointId;
+    }
+
+    uint32_t m_featureId = 0;
+    // |m_startPointId| < |m_endPointId|.
+    uint32_t m_startPointId = 0;
+    uint32_t m_endPointId = 0;
+  };
+
+  using EdgeFn = std::function<void(Vertex from, Vertex to, RouteWeight const & weight)>;
+
+  RoadPieces() = default;
+  /// \brief Splits all valid roads of |graph| by their joints.
+  explicit RoadPieces(IndexGraph const & graph);
+
+  size_t GetSize() const { return m_pieces.size(); }
+  uint32_t GetNumVertices() const { return base::checked_cast<uint32_t>(2 * m_pieces.size()); }
+
+  /// \returns vertex of the directed road piece which contains |segment| or |kInvalidVertex|
+  /// if there's no such piece.
+  Vertex GetVertex(Segment const & segment) const;
+
+  /// \brief Calls |f| for all segments of the piece of |v| in the direction of movement.
+  template <typename F>
+  void ForEachSegment(Vertex v, NumMwmId mwmId, F && f) const
+  {
+    CHECK_LESS(v / 2, m_pieces.size(), ());
+    auto const & piece = m_pieces[v / 2];
+    bool const forward = IsForward(v);
+    for (uint32_t i = piece.m_startPointId; i < piece.m_endPointId; ++i)
+    {
+      uint32_t const segmentIdx = forward ? i : piece.m_endPointId - 1 - (i - piece.m_startPointId);
+      f(Segment(mwmId, piece.m_featureId, segmentIdx, forward));
+    }
+  }
+
+  /// \brief Calls |f| for all transitions between pieces of |graph| which are allowed by
+  /// IndexGraph::GetEdgeList(). |weight| is the weight of the corresponding JointEdge.
+  /// \note |graph| should be the graph the pieces were built by.
+  void ForEachEdge(IndexGraph const & graph, EdgeFn const & f) const;
+
+  static Vertex MakeVertex(uint32_t pieceIdx, bool forward) { return 2 * pieceIdx + (forward ? 0 : 1); }
+  static bool IsForward(Vertex v) { return v % 2 == 0; }
+
+  template <typename Sink>
+  void Serialize(Sink & sink) const
+  {
+    WriteToSink(sink, base::checked_cast<uint32_t>(m_pieces.size()));
+    for (auto const & piece : m_pieces)
+    {
+      WriteToSink(sink, piece.m_featureId);
+      WriteToSink(sink, piece.m_startPointId);
+      WriteToSink(sink, piece.m_endPointId);
+    }
+  }
+
+  template <typename Source>
+  void Deserialize(Source & src)
+  {
+    m_pieces.resize(ReadPrimitiveFromSource<uint32_t>(src));
+    for (auto & piece : m_pieces)
+    {
+      piece.m_featureId = ReadPrimitiveFromSource<uint32_t>(src);
+      piece.m_startPointId = ReadPrimitiveFromSource<uint32_t>(src);
+      piece.m_endPointId = ReadPrimitiveFromSource<uint32_t>(src);
+    }
+  }
+
+private:
+  // Sorted road pieces of all roads of the mwm.
+  std::vector<Piece> m_pieces;
+};
+}  // namespace routing
@@ -0,0 +1,362 @@
+#include "routing/road_segments_index.hpp"
+
+#include "routing/aligned_arrays.hpp"
+#include "routing/nearest_edge_finder.hpp"
+#include "routing/routing_exceptions.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include "platform/local_country_file.hpp"
+
+#include "coding/endianness.hpp"
+#include "coding/files_container.hpp"
+#include "coding/reader.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "geometry/mercator.hpp"
+#include "geometry/parametrized_segment.hpp"
+
+#include "base/checked_cast.hpp"
+#include "base/logging.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "defines.hpp"
+
+namespace routing
+{
+using namespace std;
+
+namespace
+{
+// Cells are not much more numerous than segments to keep the grid compact for sparse mwms.
+uint64_t constexpr kMaxCellsPerSegment = 4;
+uint64_t constexpr kMinMaxCellsNumber = 1024;
+}  // namespace
+
+// RoadSegmentsIndex -------------------------------------------------------------------------------
+RoadSegmentsIndex::RoadSegmentsIndex(unique_ptr<MemoryRegion> region, uint64_t pos)
+  : m_region(move(region))
+{
+  CHECK(m_region, ());
+  if (pos > m_region->Size() || pos % kArraysAlignment != 0)
+    MYTHROW(CorruptedDataException, ("Wrong road segments index offset:", pos));
+
+  uint8_t const * data = m_region->ImmutableData() + pos;
+  m_size = m_region->Size() - pos;
+  MemReader memReader(data, m_size);
+  ReaderSource<MemReader> src(memReader);
+  m_header.m_version = ReadPrimitiveFromSource<uint16_t>(src);
+  if (m_header.m_version != kLastVersion)
+    MYTHROW(CorruptedDataException, ("Unknown road segments index version:", m_header.m_version));
+
+  m_header.m_coordBits = ReadPrimitiveFromSource<uint8_t>(src);
+  m_header.m_flags = ReadPrimitiveFromSource<uint8_t>(src);
+  m_header.m_roadsNumber = ReadPrimitiveFromSource<uint32_t>(src);
+  m_header.m_pointsNumber = ReadPrimitiveFromSource<uint32_t>(src);
+  m_header.m_cellsX = ReadPrimitiveFromSource<uint32_t>(src);
+  m_header.m_cellsY = ReadPrimitiveFromSource<uint32_t>(src);
+  m_header.m_cellSegmentsNumber = ReadPrimitiveFromSource<uint32_t>(src);
+  m_header.m_minX = ReadPrimitiveFromSource<uint32_t>(src);
+  m_header.m_minY = ReadPrimitiveFromSource<uint32_t>(src);
+  m_header.m_cellSize = ReadPrimitiveFromSource<uint32_t>(src);
+
+  if (m_header.m_roadsNumber != 0 &&
+      (m_header.m_cellsX == 0 || m_header.m_cellsY == 0 || m_header.m_cellSize == 0))
+  {
+    MYTHROW(CorruptedDataException, ("Wrong grid of road segments index:", m_header.m_cellsX,
+                                     m_header.m_cellsY, m_header.m_cellSize));
+  }
+
+  ArraysReader reader(data, m_size, src.Pos(), "Road segments index");
+  uint64_t const roadsNumber = m_header.m_roadsNumber;
+  uint64_t const pointsNumber = m_header.m_pointsNumber;
+  uint64_t const cellsNumber = static_cast<uint64_t>(m_header.m_cellsX) * m_header.m_cellsY;
+
+  m_featureIds = reader.Read<uint32_t>(roadsNumber);
+  m_pointOffsets = reader.Read<uint32_t>(roadsNumber + 1);
+  m_bidirectional = reader.Read<uint8_t>(roadsNumber);
+  m_pointsX = reader.Read<uint32_t>(pointsNumber);
+  m_pointsY = reader.Read<uint32_t>(pointsNumber);
+  if (HasAltitudes())
+    m_altitudes = reader.Read<int16_t>(pointsNumber);
+  m_cellOffsets = reader.Read<uint32_t>(cellsNumber + 1);
+  m_cellSegments = reader.Read<uint32_t>(m_header.m_cellSegmentsNumber);
+}
+
+// static
+unique_ptr<RoadSegmentsIndex> RoadSegmentsIndex::Load(MwmValue const & mwmValue,
+                                                      VehicleType vehicleType)
+{
+  if (vehicleType == VehicleType::Transit)
+    vehicleType = VehicleType::Pedestrian;
+
+  auto const vehicleIdx = static_cast<size_t>(vehicleType);
+  // Arrays are used in place, so they must have the host byte order.
+  if (IsBigEndianMacroBased() || vehicleIdx >= kVehiclesNumber ||
+      !mwmValue.m_cont.IsExist(ROUTING_SEGMENTS_FILE_TAG))
+  {
+    return nullptr;
+  }
+
+  try
+  {
+    auto region = MapSection(mwmValue, ROUTING_SEGMENTS_FILE_TAG);
+    MemReader memReader(region->ImmutableData(), region->Size());
+    ReaderSource<MemReader> src(memReader);
+    auto const version = ReadPrimitiveFromSource<uint16_t>(src);
+    auto const vehiclesNumber = ReadPrimitiveFromSource<uint16_t>(src);
+    if (version != kLastSectionVersion || vehicleIdx >= vehiclesNumber)
+    {
+      LOG(LWARNING, ("File", mwmValue.GetCountryFileName(), "has unsupported",
+                     ROUTING_SEGMENTS_FILE_TAG, "section, version:", version, "vehicles:",
+                     vehiclesNumber));
+      return nullptr;
+    }
+
+    src.Skip(vehicleIdx * sizeof(uint32_t));
+    auto const pos = ReadPrimitiveFromSource<uint32_t>(src);
+    return make_unique<RoadSegmentsIndex>(move(region), pos);
+  }
+  catch (RootException const & e)
+  {
+    LOG(LERROR, ("File", mwmValue.GetCountryFileName(), "Error while reading",
+                 ROUTING_SEGMENTS_FILE_TAG, "section.", e.Msg()));
+    return nullptr;
+  }
+}
+
+void RoadSegmentsIndex::FindClosestEdges(MwmSet::MwmId const & mwmId, m2::RectD const & rect,
+                                         NearestEdgeFinder & finder) const
+{
+  // The closest segment of every road is added as NearestEdgeFinder::AddInformationSource() does.
+  vector<pair<double, RoadSegment>> closest;
+  m2::PointD const & point = finder.GetPoint();
+  ForEachSegment(rect, [&](RoadSegment const & segment) {
+    m2::ParametrizedSegment<m2::PointD> const parametrized(segment.m_start.GetPoint(),
+                                                           segment.m_end.GetPoint());
+    closest.emplace_back(point.SquaredLength(parametrized.ClosestPointTo(point)), segment);
+  });
+
+  sort(closest.begin(), closest.end(), [](auto const & lhs, auto const & rhs) {
+    if (lhs.second.m_featureId != rhs.second.m_featureId)
+      return lhs.second.m_featureId < rhs.second.m_featureId;
+    if (lhs.first != rhs.first)
+      return lhs.first < rhs.first;
+    return lhs.second.m_segmentIdx < rhs.second.m_segmentIdx;
+  });
+
+  for (size_t i = 0; i < closest.size(); ++i)
+  {
+    auto const & segment = closest[i].second;
+    if (i != 0 && closest[i - 1].second.m_featureId == segment.m_featureId)
+      continue;
+
+    finder.AddClosestSegment(FeatureID(mwmId, segment.m_featureId), segment.m_bidirectional,
+                             segment.m_segmentIdx, segment.m_start, segment.m_end);
+  }
+}
+
+RoadSegmentsIndex::RoadSegment RoadSegmentsIndex::MakeSegment(uint32_t pointIdx,
+                                                              m2::PointD const & start,
+                                                              m2::PointD const & end) const
+{
+  // Road of the segment is the last one which starts not after the segment.
+  auto const * it = upper_bound(m_pointOffsets, m_pointOffsets + m_header.m_roadsNumber, pointIdx);
+  CHECK(it != m_pointOffsets, (pointIdx));
+  auto const roadIdx = static_cast<uint32_t>(distance(m_pointOffsets, it) - 1);
+
+  RoadSegment segment;
+  segment.m_featureId = m_featureIds[roadIdx];
+  segment.m_segmentIdx = pointIdx - m_pointOffsets[roadIdx];
+  segment.m_bidirectional = m_bidirectional[roadIdx] != 0;
+
+  auto const startAltitude =
+      HasAltitudes() ? m_altitudes[pointIdx] : geometry::kDefaultAltitudeMeters;
+  auto const endAltitude =
+      HasAltitudes() ? m_altitudes[pointIdx + 1] : geometry::kDefaultAltitudeMeters;
+  segment.m_start = geometry::PointWithAltitude(start, startAltitude);
+  segment.m_end = geometry::PointWithAltitude(end, endAltitude);
+  return segment;
+}
+
+// RoadSegmentsIndexBuilder ------------------------------------------------------------------------
+RoadSegmentsIndexBuilder::RoadSegmentsIndexBuilder(uint8_t coordBits, bool hasAltitudes,
+                                                   double cellSizeMeters)
+  : m_coordBits(coordBits), m_hasAltitudes(hasAltitudes), m_cellSizeMeters(cellSizeMeters)
+{
+  CHECK_GREATER(m_cellSizeMeters, 0.0, ());
+}
+
+void RoadSegmentsIndexBuilder::AddRoad(uint32_t featureId, bool bidirectional,
+                                       IRoadGraph::PointWithAltitudeVec const & junctions)
+{
+  if (junctions.size() < 2)
+    return;
+
+  m_roads.push_back({featureId, base::checked_cast<uint32_t>(m_points.size()), bidirectional});
+  for (auto const & junction : junctions)
+  {
+    m_points.push_back(PointDToPointU(junction.GetPoint(), m_coordBits));
+    if (m_hasAltitudes)
+      m_altitudes.push_back(junction.GetAltitude());
+  }
+}
+
+void RoadSegmentsIndexBuilder::Serialize(Writer & writer) const
+{
+  RoadSegmentsIndex::Header header;
+  header.m_coordBits = m_coordBits;
+  header.m_flags = m_hasAltitudes ? RoadSegmentsIndex::kHasAltitudes : 0;
+  header.m_roadsNumber = base::checked_cast<uint32_t>(m_roads.size());
+  header.m_pointsNumber = base::checked_cast<uint32_t>(m_points.size());
+
+  // A segment is identified by the index of its first point, the last point of a road starts none.
+  vector<uint32_t> segments;
+  segments.reserve(m_points.size());
+  for (size_t i = 0; i < m_roads.size(); ++i)
+  {
+    uint32_t const end = i + 1 == m_roads.size() ? header.m_pointsNumber : m_roads[i + 1].m_pointsBegin;
+    for (uint32_t pointIdx = m_roads[i].m_pointsBegin; pointIdx + 1 < end; ++pointIdx)
+      segments.push_back(pointIdx);
+  }
+
+  vector<uint32_t> cellOffsets;
+  vector<uint32_t> cellSegments;
+  if (!m_points.empty())
+  {
+    m2::PointU minPoint(numeric_limits<uint32_t>::max(), numeric_limits<uint32_t>::max());
+    m2::PointU maxPoint(0, 0);
+    for (auto const & point : m_points)
+    {
+      minPoint.x = min(minPoint.x, point.x);
+      minPoint.y = min(minPoint.y, point.y);
+      maxPoint.x = max(maxPoint.x, point.x);
+      maxPoint.y = max(maxPoint.y, point.y);
+    }
+
+    m2::PointU const cellSizePoint =
+        PointDToPointU(m2::PointD(mercator::Bounds::kMinX + mercator::MetersToMercator(m_cellSizeMeters),
+                                  mercator::Bounds::kMinY),
+                       m_coordBits);
+    uint64_t cellSize = max<uint64_t>(cellSizePoint.x, 1);
+    uint64_t const maxCellsNumber =
+        max<uint64_t>(kMinMaxCellsNumber, kMaxCellsPerSegment * segments.size());
+    auto const getCellsNumber = [&cellSize](uint32_t min, uint32_t max) {
+      return (static_cast<uint64_t>(max) - min) / cellSize + 1;
+    };
+    while (getCellsNumber(minPoint.x, maxPoint.x) * getCellsNumber(minPoint.y, maxPoint.y) >
+           maxCellsNumber)
+    {
+      cellSize *= 2;
+    }
+
+    header.m_minX = minPoint.x;
+    header.m_minY = minPoint.y;
+    header.m_cellSize = base::checked_cast<uint32_t>(cellSize);
+    header.m_cellsX = base::checked_cast<uint32_t>(getCellsNumber(minPoint.x, maxPoint.x));
+    header.m_cellsY = base::checked_cast<uint32_t>(getCellsNumber(minPoint.y, maxPoint.y));
+
+    auto const getCell = [&](uint32_t coord, uint32_t min) {
+      return static_cast<uint32_t>((coord - min) / cellSize);
+    };
+    // Calls |fn| for every cell the bounding rect of the segment covers.
+    auto const forEachCell = [&](uint32_t pointIdx, auto && fn) {
+      auto const & start = m_points[pointIdx];
+      auto const & end = m_points[pointIdx + 1];
+      uint32_t const minCellX = getCell(min(start.x, end.x), minPoint.x);
+      uint32_t const maxCellX = getCell(max(start.x, end.x), minPoint.x);
+      uint32_t const minCellY = getCell(min(start.y, end.y), minPoint.y);
+      uint32_t const maxCellY = getCell(max(start.y, end.y), minPoint.y);
+      for (uint32_t cellY = minCellY; cellY <= maxCellY; ++cellY)
+      {
+        for (uint32_t cellX = minCellX; cellX <= maxCellX; ++cellX)
+          fn(cellY * header.m_cellsX + cellX);
+      }
+    };
+
+    cellOffsets.assign(static_cast<size_t>(header.m_cellsX) * header.m_cellsY + 1, 0);
+    for (auto const pointIdx : segments)
+      forEachCell(pointIdx, [&cellOffsets](uint32_t cell) { ++cellOffsets[cell + 1]; });
+    for (size_t i = 1; i < cellOffsets.size(); ++i)
+      cellOffsets[i] += cellOffsets[i - 1];
+
+    cellSegments.resize(cellOffsets.back());
+    vector<uint32_t> filled(cellOffsets.cbegin(), cellOffsets.cend() - 1);
+    for (auto const pointIdx : segments)
+    {
+      forEachCell(pointIdx,
+                  [&](uint32_t cell) { cellSegments[filled[cell]++] = pointIdx; });
+    }
+  }
+  header.m_cellSegmentsNumber = base::checked_cast<uint32_t>(cellSegments.size());
+
+  WriteToSink(writer, header.m_version);
+  WriteToSink(writer, header.m_coordBits);
+  WriteToSink(writer, header.m_flags);
+  WriteToSink(writer, header.m_roadsNumber);
+  WriteToSink(writer, header.m_pointsNumber);
+  WriteToSink(writer, header.m_cellsX);
+  WriteToSink(writer, header.m_cellsY);
+  WriteToSink(writer, header.m_cellSegmentsNumber);
+  WriteToSink(writer, header.m_minX);
+  WriteToSink(writer, header.m_minY);
+  WriteToSink(writer, header.m_cellSize);
+
+  ArraysWriter arrays(writer);
+  arrays.Write<uint32_t>(m_roads.size(), [this](uint64_t i) { return m_roads[i].m_featureId; });
+  arrays.Write<uint32_t>(m_roads.size() + 1, [this, &header](uint64_t i) {
+    return i == m_roads.size() ? header.m_pointsNumber : m_roads[i].m_pointsBegin;
+  });
+  arrays.Write<uint8_t>(m_roads.size(),
+                        [this](uint64_t i) { return m_roads[i].m_bidirectional ? 1 : 0; });
+  arrays.Write<uint32_t>(m_points.size(), [this](uint64_t i) { return m_points[i].x; });
+  arrays.Write<uint32_t>(m_points.size(), [this](uint64_t i) { return m_points[i].y; });
+  if (m_hasAltitudes)
+    arrays.Write<int16_t>(m_altitudes.size(), [this](uint64_t i) { return m_altitudes[i]; });
+  // An empty grid has one cell offset.
+  arrays.Write<uint32_t>(max<size_t>(cellOffsets.size(), 1), [&cellOffsets](uint64_t i) {
+    return cellOffsets.empty() ? 0 : cellOffsets[i];
+  });
+  arrays.Write<uint32_t>(cellSegments.size(), [&cellSegments](uint64_t i) { return cellSegments[i]; });
+}
+
+unique_ptr<RoadSegmentsIndex> RoadSegmentsIndexBuilder::Build() const
+{
+  vector<uint8_t> buffer;
+  {
+    MemWriter<vector<uint8_t>> writer(buffer);
+    Serialize(writer);
+  }
+  return make_unique<RoadSegmentsIndex>(make_unique<CopiedMemoryRegion>(move(buffer)));
+}
+
+// static
+void RoadSegmentsIndexBuilder::SerializeSection(vector<RoadSegmentsIndexBuilder> const & builders,
+                                                Writer & writer)
+{
+  // The header size is a multiple of 4 as well as the size of every index, so the indexes
+  // are aligned.
+  uint64_t const headerSize = 2 * sizeof(uint16_t) + (builders.size() + 1) * sizeof(uint32_t);
+  vector<uint8_t> buffer;
+  vector<uint32_t> offsets;
+  {
+    MemWriter<vector<uint8_t>> indexesWriter(buffer);
+    for (auto const & builder : builders)
+    {
+      offsets.push_back(base::checked_cast<uint32_t>(headerSize + buffer.size()));
+      builder.Serialize(indexesWriter);
+    }
+  }
+  offsets.push_back(base::checked_cast<uint32_t>(headerSize + buffer.size()));
+
+  WriteToSink(writer, RoadSegmentsIndex::kLastSectionVersion);
+  WriteToSink(writer, base::checked_cast<uint16_t>(builders.size()));
+  for (auto const offset : offsets)
+    WriteToSink(writer, offset);
+  writer.Write(buffer.data(), buffer.size());
+}
+}  // namespace routing
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "routing/road_graph.hpp"
+#include "routing/vehicle_mask.hpp"
+
+#include "indexer/feature_decl.hpp"
+#include "indexer/mwm_set.hpp"
+
+#include "coding/memory_region.hpp"
+#include "coding/point_coding.hpp"
+#include "coding/writer.hpp"
+
+#include "geometry/point2d.hpp"
+#include "geometry/point_with_altitude.hpp"
+#include "geometry/rect2d.hpp"
+
+#include "base/assert.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class MwmValue;
+
+namespace routing
+{
+class NearestEdgeFinder;
+
+/// \brief Uniform grid over road segments of an mwm. Roads are read from features once and
+/// segments near a point are found without reading of features.
+/// The index is a structure of 4-byte aligned arrays, so it's used right from the mapped memory
+/// of a file as well as from the memory it's built in:
+///   Header
+///   uint32_t featureIds[roadsNumber]
+///   uint32_t pointOffsets[roadsNumber + 1]
+///   uint8_t bidirectional[roadsNumber]
+///   uint32_t pointsX[pointsNumber], pointsY[pointsNumber], coded with |coordBits| of the header
+///   int16_t altitudes[pointsNumber], if the header has kHasAltitudes flag
+///   uint32_t cellOffsets[cellsX * cellsY + 1]
+///   uint32_t cellSegments[cellSegmentsNumber], index of the first point of a segment
+/// A segment is put into all the cells its bounding rect covers.
+///
+/// ROUTING_SEGMENTS_FILE_TAG section keeps the indexes of roads of every VehicleType from
+/// Pedestrian to Car, so they aren't built from features at runtime:
+///   uint16_t version
+///   uint16_t vehiclesNumber
+///   uint32_t indexOffsets[vehiclesNumber + 1], from the start of the section
+///   the indexes, each one is 4-byte aligned
+class RoadSegmentsIndex final
+{
+public:
+  static uint16_t constexpr kLastVersion = 0;
+  static uint16_t constexpr kLastSectionVersion = 0;
+  // Transit uses pedestrian roads.
+  static size_t constexpr kVehiclesNumber = static_cast<size_t>(VehicleType::Car) + 1;
+
+  enum HeaderFlags : uint8_t
+  {
+    kHasAltitudes = 1 << 0,
+  };
+
+  struct Header
+  {
+    uint16_t m_version = kLastVersion;
+    uint8_t m_coordBits = 0;
+    uint8_t m_flags = 0;
+    uint32_t m_roadsNumber = 0;
+    uint32_t m_pointsNumber = 0;
+    uint32_t m_cellsX = 0;
+    uint32_t m_cellsY = 0;
+    uint32_t m_cellSegmentsNumber = 0;
+    // Origin of the grid and size of a cell coded with |m_coordBits|.
+    uint32_t m_minX = 0;
+    uint32_t m_minY = 0;
+    uint32_t m_cellSize = 0;
+  };
+
+  struct RoadSegment
+  {
+    uint32_t m_featureId = 0;
+    uint32_t m_segmentIdx = 0;
+    bool m_bidirectional = true;
+    geometry::PointWithAltitude m_start;
+    geometry::PointWithAltitude m_end;
+  };
+
+  /// \param pos is the offset of the index in |region|, it should be 4-byte aligned.
+  explicit RoadSegmentsIndex(std::unique_ptr<MemoryRegion> region, uint64_t pos = 0);
+
+  /// \returns index of roads of |vehicleType| from ROUTING_SEGMENTS_FILE_TAG section or nullptr
+  /// if there's no section in |mwmValue|.
+  static std::unique_ptr<RoadSegmentsIndex> Load(MwmValue const & mwmValue, VehicleType vehicleType);
+
+  Header const & GetHeader() const { return m_header; }
+  uint32_t GetRoadsNumber() const { return m_header.m_roadsNumber; }
+  uint64_t GetMemorySize() const { return m_size; }
+  bool HasAltitudes() const { return (m_header.m_flags & kHasAltitudes) != 0; }
+
+  /// \brief Calls |fn| for every segment which bounding rect intersects |rect|. Every segment is
+  /// visited once.
+  template <typename Fn>
+  void ForEachSegment(m2::RectD const & rect, Fn && fn) const
+  {
+    if (m_header.m_roadsNumber == 0)
+      return;
+
+    m2::PointU const minPoint = PointDToPointU(rect.LeftBottom(), m_header.m_coordBits);
+    m2::PointU const maxPoint = PointDToPointU(rect.RightTop(), m_header.m_coordBits);
+    uint32_t const minCellX = GetCellX(minPoint.x);
+    uint32_t const minCellY = GetCellY(minPoint.y);
+    uint32_t const maxCellX = GetCellX(maxPoint.x);
+    uint32_t const maxCellY = GetCellY(maxPoint.y);
+    for (uint32_t cellY = minCellY; cellY <= maxCellY; ++cellY)
+    {
+      for (uint32_t cellX = minCellX; cellX <= maxCellX; ++cellX)
+      {
+        uint32_t const cell = cellY * m_header.m_cellsX + cellX;
+        for (uint32_t i = m_cellOffsets[cell]; i < m_cellOffsets[cell + 1]; ++i)
+        {
+          uint32_t const pointIdx = m_cellSegments[i];
+          // The segment is visited in the first cell of the query it's put into.
+          uint32_t const segmentCellX =
+              GetCellX(std::min(m_pointsX[pointIdx], m_pointsX[pointIdx + 1]));
+          uint32_t const segmentCellY =
+              GetCellY(std::min(m_pointsY[pointIdx], m_pointsY[pointIdx + 1]));
+          if (std::max(segmentCellX, minCellX) != cellX || std::max(segmentCellY, minCellY) != cellY)
+            continue;
+
+          m2::PointD const start = GetPoint(pointIdx);
+          m2::PointD const end = GetPoint(pointIdx + 1);
+          if (rect.IsIntersect(m2::RectD(start, end)))
+            fn(MakeSegment(pointIdx, start, end));
+        }
+      }
+    }
+  }
+
+  /// \brief Adds the closest segments of roads of |mwmId| within |rect| to |finder|.
+  void FindClosestEdges(MwmSet::MwmId const & mwmId, m2::RectD const & rect,
+                        NearestEdgeFinder & finder) const;
+
+private:
+  m2::PointD GetPoint(uint32_t pointIdx) const
+  {
+    ASSERT_LESS(pointIdx, m_header.m_pointsNumber, ());
+    return PointUToPointD(m2::PointU(m_pointsX[pointIdx], m_pointsY[pointIdx]),
+                          m_header.m_coordBits);
+  }
+
+  uint32_t GetCell(uint32_t coord, uint32_t min, uint32_t cellsNumber) const
+  {
+    if (coord <= min)
+      return 0;
+    return std::min((coord - min) / m_header.m_cellSize, cellsNumber - 1);
+  }
+
+  uint32_t GetCellX(uint32_t x) const { return GetCell(x, m_header.m_minX, m_header.m_cellsX); }
+  uint32_t GetCellY(uint32_t y) const { return GetCell(y, m_header.m_minY, m_header.m_cellsY); }
+
+  RoadSegment MakeSegment(uint32_t pointIdx, m2::PointD const & start, m2::PointD const & end) const;
+
+  std::unique_ptr<MemoryRegion> m_region;
+  uint64_t m_size = 0;
+  Header m_header;
+
+  uint32_t const * m_featureIds = nullptr;
+  uint32_t const * m_pointOffsets = nullptr;
+  uint8_t const * m_bidirectional = nullptr;
+  uint32_t const * m_pointsX = nullptr;
+  uint32_t const * m_pointsY = nullptr;
+  int16_t const * m_altitudes = nullptr;
+  uint32_t const * m_cellOffsets = nullptr;
+  uint32_t const * m_cellSegments = nullptr;
+};
+
+/// \brief Collects roads and writes RoadSegmentsIndex.
+class RoadSegmentsIndexBuilder final
+{
+public:
+  static double constexpr kDefaultCellSizeMeters = 100.0;
+
+  RoadSegmentsIndexBuilder(uint8_t coordBits, bool hasAltitudes,
+                           double cellSizeMeters = kDefaultCellSizeMeters);
+
+  void AddRoad(uint32_t featureId, bool bidirectional,
+               IRoadGraph::PointWithAltitudeVec const & junctions);
+
+  void Serialize(Writer & writer) const;
+  /// \returns index which is kept in memory.
+  std::unique_ptr<RoadSegmentsIndex> Build() const;
+
+  /// \brief Writes ROUTING_SEGMENTS_FILE_TAG section. |builders| are indexed by VehicleType.
+  static void SerializeSection(std::vector<RoadSegmentsIndexBuilder> const & builders,
+                               Writer & writer);
+
+private:
+  struct Road
+  {
+    uint32_t m_featureId = 0;
+    uint32_t m_pointsBegin = 0;
+    bool m_bidirectional = true;
+  };
+
+  uint8_t m_coordBits;
+  bool m_hasAltitudes;
+  double m_cellSizeMeters;
+  std::vector<Road> m_roads;
+  std::vector<m2::PointU> m_points;
+  geometry::Altitudes m_altitudes;
+};
+}  // namespace routing
@@ -315,6 +315,18 @@ void Route::SetRouteSegments(vector<RouteSegment> && routeSegments)
   m_poly.SetFakeSegmentIndexes(move(fakeSegmentIndexes));
 }
 
+void Route::SetDirections(size_t firstSegmentIdx, vector<RouteSegment> const & routeSegments)
+{
+  CHECK_EQUAL(firstSegmentIdx + routeSegments.size(), m_routeSegments.size(), ());
+  for (size_t i = 0; i < routeSegments.size(); ++i)
+  {
+    auto const & routeSegment = routeSegments[i];
+    m_routeSegments[firstSegmentIdx + i].SetDirections(routeSegment.GetTurn(),
+                                                       routeSegment.GetRoadNameInfo());
+  }
+  m_pendingDirections = false;
+}
+
 bool Route::MoveIterator(location::GpsInfo const & info)
 {
   m2::RectD const rect = mercator::MetersToXY(
@@ -97,6 +97,12 @@ public:
 
   void SetTurnExits(uint32_t exitNum) { m_turn.m_exitNum = exitNum; }
 
+  void SetDirections(turns::TurnItem const & turn, RoadNameInfo const & roadNameInfo)
+  {
+    m_turn = turn;
+    m_roadNameInfo = roadNameInfo;
+  }
+
   std::vector<turns::SingleLaneInfo> & GetTurnLanes() { return m_turn.m_lanes; };
 
   void SetDistancesAndTime(double distFromBeginningMeters, double distFromBeginningMerc, double timeFromBeginningS)
@@ -276,6 +282,14 @@ public:
 
   void SetRouteSegments(std::vector<RouteSegment> && routeSegments);
 
+  /// \brief Replaces turns and street names of the route segments starting from |firstSegmentIdx|
+  /// with the ones of |routeSegments| which are generated later than the route is built.
+  void SetDirections(size_t firstSegmentIdx, std::vector<RouteSegment> const & routeSegments);
+  void SetPendingDirections(bool pending) { m_pendingDirections = pending; }
+  /// \returns true if turns and street names are generated only for the beginning of the route
+  /// and the rest is being generated.
+  bool HasPendingDirections() const { return m_pendingDirections; }
+
   std::vector<RouteSegment> & GetRouteSegments() { return m_routeSegments; }
   std::vector<RouteSegment> const & GetRouteSegments() const { return m_routeSegments; }
   RoutingSettings const & GetCurrentRoutingSettings() const { return m_routingSettings; }
@@ -404,6 +418,15 @@ public:
 
   void GetTurnsForTesting(std::vector<turns::TurnItem> & turns) const;
   bool IsRouteId(uint64_t routeId) const { return routeId == m_routeId; }
+  uint64_t GetRouteId() const { return m_routeId; }
+
+  /// \brief Alternatives are routes between the same points which are found by the same search
+  /// as the route. They are shown to a user but not followed, so they have no alternatives.
+  void SetAlternatives(std::vector<std::shared_ptr<Route>> && alternatives)
+  {
+    m_alternatives = std::move(alternatives);
+  }
+  std::vector<std::shared_ptr<Route>> const & GetAlternatives() const { return m_alternatives; }
 
   /// \returns Length of the route segment with |segIdx| in meters.
   double GetSegLenMeters(size_t segIdx) const;
@@ -440,6 +463,7 @@ private:
   std::vector<RouteSegment> m_routeSegments;
   // |m_haveAltitudes| is true if and only if all route points have altitude information.
   bool m_haveAltitudes = false;
+  bool m_pendingDirections = false;
 
   // Subroute
   SubrouteUid m_subrouteUid = kInvalidSubrouteId;
@@ -450,6 +474,9 @@ private:
 
   // Mwms which are crossed by the route where speed cameras are prohibited.
   std::vector<platform::CountryFile> m_speedCamPartlyProhibitedMwms;
+
+  // Sorted by length.
+  std::vector<std::shared_ptr<Route>> m_alternatives;
 };
 
 /// \returns true if |turn| is not equal to turns::CarDirection::None or
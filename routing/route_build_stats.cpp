@@ -0,0 +1,92 @@
+#include "routing/route_build_stats.hpp"
+
+#include "base/assert.hpp"
+
+#include <numeric>
+#include <sstream>
+
+namespace routing
+{
+using namespace std;
+
+// RouteBuildStats::ScopedTimer --------------------------------------------------------------------
+RouteBuildStats::ScopedTimer::ScopedTimer(RouteBuildStats * stats, Phase phase) : m_stats(stats)
+{
+  if (!m_stats)
+    return;
+
+  m_enclosingPhase = m_stats->m_currentPhase;
+  m_stats->SwitchPhase(phase);
+}
+
+RouteBuildStats::ScopedTimer::~ScopedTimer()
+{
+  if (m_stats)
+    m_stats->SwitchPhase(m_enclosingPhase);
+}
+
+// RouteBuildStats ---------------------------------------------------------------------------------
+void RouteBuildStats::Clear()
+{
+  ASSERT(!m_currentPhase, ("Stats are cleared while", *m_currentPhase, "is measured."));
+  m_seconds.fill(0.0);
+  m_settledVertices = 0;
+}
+
+double RouteBuildStats::GetTotalSeconds() const
+{
+  return accumulate(m_seconds.cbegin(), m_seconds.cend(), 0.0);
+}
+
+RouteBuildStats & RouteBuildStats::operator+=(RouteBuildStats const & rhs)
+{
+  for (size_t i = 0; i < kPhasesNumber; ++i)
+    m_seconds[i] += rhs.m_seconds[i];
+  m_settledVertices += rhs.m_settledVertices;
+  return *this;
+}
+
+void RouteBuildStats::Average(uint32_t launchesNumber)
+{
+  CHECK_GREATER(launchesNumber, 0, ());
+  for (auto & seconds : m_seconds)
+    seconds /= launchesNumber;
+  m_settledVertices /= launchesNumber;
+}
+
+void RouteBuildStats::SwitchPhase(optional<Phase> phase)
+{
+  if (m_currentPhase)
+    m_seconds[static_cast<size_t>(*m_currentPhase)] += m_phaseTimer.ElapsedSeconds();
+
+  m_currentPhase = phase;
+  m_phaseTimer.Reset();
+}
+
+string DebugPrint(RouteBuildStats::Phase phase)
+{
+  switch (phase)
+  {
+  case RouteBuildStats::Phase::GraphLoading: return "GraphLoading";
+  case RouteBuildStats::Phase::FakeEndings: return "FakeEndings";
+  case RouteBuildStats::Phase::LeapsSearch: return "LeapsSearch";
+  case RouteBuildStats::Phase::AStar: return "AStar";
+  case RouteBuildStats::Phase::Directions: return "Directions";
+  case RouteBuildStats::Phase::Count: return "Count";
+  }
+  UNREACHABLE();
+}
+
+string DebugPrint(RouteBuildStats const & stats)
+{
+  ostringstream out;
+  out << "RouteBuildStats [ ";
+  for (size_t i = 0; i < RouteBuildStats::kPhasesNumber; ++i)
+  {
+    auto const phase = static_cast<RouteBuildStats::Phase>(i);
+    out << DebugPrint(phase) << ": " << stats.GetSeconds(phase) << " s, ";
+  }
+  out << "settled vertices: " << stats.GetSettledVertices() << " ]";
+  return out.str();
+}
+}  // namespace routing
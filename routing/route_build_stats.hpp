@@ -0,0 +1,79 @@
+#pragma once
+
+#include "base/timer.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace routing
+{
+/// \brief Time which IndexRouter spends in phases of route building and the size of its search.
+/// Time of a phase doesn't include time of the phases nested into it. E.g. road graphs are loaded
+/// lazily while A* is running and that time is counted as GraphLoading, not as AStar.
+class RouteBuildStats final
+{
+public:
+  enum class Phase : uint8_t
+  {
+    // Loading of road graphs and their geometry.
+    GraphLoading,
+    // Snapping of checkpoints to roads and construction of FakeEnding.
+    FakeEndings,
+    // Search of cross-mwm routes by LeapsGraph.
+    LeapsSearch,
+    // Searches by road graphs inside mwms.
+    AStar,
+    // Reconstruction of route geometry and directions by DirectionsEngine.
+    Directions,
+    Count
+  };
+
+  static size_t constexpr kPhasesNumber = static_cast<size_t>(Phase::Count);
+
+  /// \brief Measures time of |phase| while it's alive. Time of the enclosing phase is not measured
+  /// meanwhile. Nothing is measured if |stats| is nullptr.
+  /// \note Timers of the same stats should be used by one thread.
+  class ScopedTimer final
+  {
+  public:
+    ScopedTimer(RouteBuildStats * stats, Phase phase);
+    ~ScopedTimer();
+
+    ScopedTimer(ScopedTimer const &) = delete;
+    ScopedTimer & operator=(ScopedTimer const &) = delete;
+
+  private:
+    RouteBuildStats * m_stats;
+    std::optional<Phase> m_enclosingPhase;
+  };
+
+  void Clear();
+
+  double GetSeconds(Phase phase) const { return m_seconds[static_cast<size_t>(phase)]; }
+  double GetTotalSeconds() const;
+
+  uint64_t GetSettledVertices() const { return m_settledVertices; }
+  void AddSettledVertices(uint64_t number) { m_settledVertices += number; }
+
+  /// \brief Sums time and vertices of the finished measurements.
+  RouteBuildStats & operator+=(RouteBuildStats const & rhs);
+  /// \brief Divides time and vertices by |launchesNumber| to average measurements.
+  void Average(uint32_t launchesNumber);
+
+private:
+  // Adds the time elapsed since the last switch to the current phase and switches to |phase|.
+  void SwitchPhase(std::optional<Phase> phase);
+
+  std::array<double, kPhasesNumber> m_seconds = {};
+  uint64_t m_settledVertices = 0;
+
+  std::optional<Phase> m_currentPhase;
+  base::Timer m_phaseTimer;
+};
+
+std::string DebugPrint(RouteBuildStats::Phase phase);
+std::string DebugPrint(RouteBuildStats const & stats);
+}  // namespace routing
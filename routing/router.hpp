@@ -12,6 +12,7 @@
 
 #include "base/cancellable.hpp"
 
+#include <cstddef>
 #include <functional>
 #include <map>
 #include <string>
@@ -28,6 +29,7 @@ using GuidesTracks =
     std::map<kml::MarkGroupId, std::vector<std::vector<geometry::PointWithAltitude>>>;
 
 class Route;
+class RouteSegment;
 
 struct EdgeProj
 {
@@ -81,6 +83,19 @@ public:
 
   virtual bool FindClosestProjectionToRoad(m2::PointD const & point, m2::PointD const & direction,
                                            double radius, EdgeProj & proj) = 0;
+
+  /// \brief Generates turns and street names of the last route calculated by CalculateRoute()
+  /// if they are generated for the beginning of the route only (Route::HasPendingDirections()).
+  /// It's called in the same thread as CalculateRoute() after the route is passed to the caller.
+  /// \param firstSegmentIdx is set to the index of the first route segment without directions.
+  /// \param routeSegments is filled with the route segments from |firstSegmentIdx| to the finish.
+  /// \returns false if there are no pending directions or generation is cancelled.
+  virtual bool GeneratePendingDirections(base::Cancellable const & /* cancellable */,
+                                         size_t & /* firstSegmentIdx */,
+                                         std::vector<RouteSegment> & /* routeSegments */)
+  {
+    return false;
+  }
 };
 
 }  // namespace routing
@@ -16,6 +16,7 @@
 #include "base/assert.hpp"
 #include "base/logging.hpp"
 #include "base/scope_guard.hpp"
+#include "base/timer.hpp"
 
 #include <limits>
 
@@ -132,13 +133,26 @@ RoutesBuilder::RoutesBuilder(size_t threadsNumber) : m_threadPool(threadsNumber)
 
 RoutesBuilder::Result RoutesBuilder::ProcessTask(Params const & params)
 {
-  Processor processor(m_numMwmIds, m_dataSourcesStorage, m_cpg, m_cig);
+  Processor processor(m_numMwmIds, m_dataSourcesStorage, m_cpg, m_cig, m_indexGraphStore);
   return processor(params);
 }
 
 std::future<RoutesBuilder::Result> RoutesBuilder::ProcessTaskAsync(Params const & params)
 {
-  Processor processor(m_numMwmIds, m_dataSourcesStorage, m_cpg, m_cig);
+  Processor processor(m_numMwmIds, m_dataSourcesStorage, m_cpg, m_cig, m_indexGraphStore);
+  return m_threadPool.Submit(std::move(processor), params);
+}
+
+RoutesBuilder::MatrixResult RoutesBuilder::ProcessMatrixTask(MatrixParams const & params)
+{
+  Processor processor(m_numMwmIds, m_dataSourcesStorage, m_cpg, m_cig, m_indexGraphStore);
+  return processor(params);
+}
+
+std::future<RoutesBuilder::MatrixResult> RoutesBuilder::ProcessMatrixTaskAsync(
+    MatrixParams const & params)
+{
+  Processor processor(m_numMwmIds, m_dataSourcesStorage, m_cpg, m_cig, m_indexGraphStore);
   return m_threadPool.Submit(std::move(processor), params);
 }
 
@@ -228,11 +242,13 @@ std::vector<ms::LatLon> RoutesBuilder::Route::GetWaypoints() const
 RoutesBuilder::Processor::Processor(std::shared_ptr<NumMwmIds> numMwmIds,
                                     DataSourceStorage & dataSourceStorage,
                                     std::weak_ptr<storage::CountryParentGetter> cpg,
-                                    std::weak_ptr<storage::CountryInfoGetter> cig)
+                                    std::weak_ptr<storage::CountryInfoGetter> cig,
+                                    std::shared_ptr<IndexGraphStore> indexGraphStore)
     : m_numMwmIds(std::move(numMwmIds))
     , m_dataSourceStorage(dataSourceStorage)
     , m_cpg(std::move(cpg))
     , m_cig(std::move(cig))
+    , m_indexGraphStore(std::move(indexGraphStore))
 {
 }
 
@@ -249,6 +265,7 @@ RoutesBuilder::Processor::Processor(Processor && rhs) noexcept
   m_cpg = std::move(rhs.m_cpg);
   m_cig = std::move(rhs.m_cig);
   m_dataSource = std::move(rhs.m_dataSource);
+  m_indexGraphStore = std::move(rhs.m_indexGraphStore);
 }
 
 void RoutesBuilder::Processor::InitRouter(VehicleType type)
@@ -280,12 +297,17 @@ void RoutesBuilder::Processor::InitRouter(VehicleType type)
                                            MakeNumMwmTree(*m_numMwmIds, *m_cig.lock()),
                                            *m_trafficCache,
                                            *m_dataSource);
+  m_router->SetIndexGraphStore(m_indexGraphStore);
 }
 
 RoutesBuilder::Result
 RoutesBuilder::Processor::operator()(Params const & params)
 {
+  base::Timer taskTimer;
   InitRouter(params.m_type);
+  m_router->SetParallelBidirectional(params.m_parallelBidirectional);
+  m_router->SetLeapsThreadsNumber(params.m_leapsThreadsNumber);
+  m_router->SetAlternativesNumber(params.m_alternativesNumber);
   SCOPE_GUARD(returnDataSource, [&]() {
     m_dataSourceStorage.PushDataSource(std::move(m_dataSource));
   });
@@ -298,6 +320,7 @@ RoutesBuilder::Processor::operator()(Params const & params)
   CHECK(m_dataSource, ());
 
   double timeSum = 0.0;
+  RouteBuildStats statsSum;
   for (size_t i = 0; i < params.m_launchesNumber; ++i)
   {
     m_delegate->SetTimeout(params.m_timeoutSeconds);
@@ -309,21 +332,55 @@ RoutesBuilder::Processor::operator()(Params const & params)
       break;
 
     timeSum += timer.ElapsedSeconds();
+    statsSum += m_router->GetLastRouteStats();
   }
 
   Result result;
   result.m_params.m_checkpoints = params.m_checkpoints;
   result.m_code = resultCode;
   result.m_buildTimeSeconds = timeSum / static_cast<double>(params.m_launchesNumber);
+  result.m_stats = statsSum;
+  result.m_stats.Average(params.m_launchesNumber);
+  result.m_threadId = std::this_thread::get_id();
+
+  auto const addRoute = [&result](routing::Route const & route)
+  {
+    RoutesBuilder::Route routeResult;
+    routeResult.m_distance = route.GetTotalDistanceMeters();
+    routeResult.m_eta = route.GetTotalTimeSec();
+
+    routeResult.m_followedPolyline = route.GetFollowedPolyline();
+
+    result.m_routes.emplace_back(std::move(routeResult));
+  };
+
+  addRoute(route);
+  for (auto const & alternative : route.GetAlternatives())
+    addRoute(*alternative);
+
+  result.m_taskSeconds = taskTimer.ElapsedSeconds();
+  return result;
+}
+
+RoutesBuilder::MatrixResult
+RoutesBuilder::Processor::operator()(MatrixParams const & params)
+{
+  InitRouter(params.m_type);
+  SCOPE_GUARD(returnDataSource, [&]() {
+    m_dataSourceStorage.PushDataSource(std::move(m_dataSource));
+  });
 
-  RoutesBuilder::Route routeResult;
-  routeResult.m_distance = route.GetTotalDistanceMeters();
-  routeResult.m_eta = route.GetTotalTimeSec();
+  LOG(LINFO, ("Start building matrix:", params.m_sources.size(), "x", params.m_targets.size()));
 
-  routeResult.m_followedPolyline = route.GetFollowedPolyline();
+  CHECK(m_dataSource, ());
 
-  result.m_routes.emplace_back(std::move(routeResult));
+  m_delegate->SetTimeout(params.m_timeoutSeconds);
+  base::Timer timer;
 
+  MatrixResult result;
+  result.m_code = m_router->CalculateMatrix(params.m_sources, params.m_targets, *m_delegate,
+                                            result.m_matrix);
+  result.m_buildTimeSeconds = timer.ElapsedSeconds();
   return result;
 }
 }  // namespace routes_builder
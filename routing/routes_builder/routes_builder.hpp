@@ -3,7 +3,9 @@
 #include "routing/routes_builder/data_source_storage.hpp"
 
 #include "routing/checkpoints.hpp"
+#include "routing/index_graph_store.hpp"
 #include "routing/index_router.hpp"
+#include "routing/route_build_stats.hpp"
 #include "routing/router_delegate.hpp"
 #include "routing/routing_callbacks.hpp"
 #include "routing/segment.hpp"
@@ -33,6 +35,7 @@
 #include <future>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace routing
@@ -62,6 +65,13 @@ public:
     Checkpoints m_checkpoints;
     uint32_t m_timeoutSeconds = RouterDelegate::kNoTimeout;
     uint32_t m_launchesNumber = 1;
+    // Propagate the waves of bidirectional A* concurrently. It's not dumped.
+    bool m_parallelBidirectional = false;
+    // Number of threads calculating subroutes inside mwms of cross-mwm routes. It's not dumped.
+    size_t m_leapsThreadsNumber = 1;
+    // Max number of alternatives which are put to Result::m_routes after the best route.
+    // It's not dumped.
+    size_t m_alternativesNumber = 0;
   };
 
   struct Route
@@ -93,11 +103,36 @@ public:
     Params m_params;
     std::vector<Route> m_routes;
     double m_buildTimeSeconds = 0.0;
+    // Time of the phases of route building averaged over launches. It's not dumped.
+    RouteBuildStats m_stats;
+    // Thread which processed the task and the time of the processing including initialization
+    // of the router and failed launches. They are not dumped.
+    std::thread::id m_threadId;
+    double m_taskSeconds = 0.0;
   };
 
   Result ProcessTask(Params const & params);
   std::future<Result> ProcessTaskAsync(Params const & params);
 
+  struct MatrixParams
+  {
+    VehicleType m_type = VehicleType::Car;
+    std::vector<m2::PointD> m_sources;
+    std::vector<m2::PointD> m_targets;
+    uint32_t m_timeoutSeconds = RouterDelegate::kNoTimeout;
+  };
+
+  struct MatrixResult
+  {
+    RouterResultCode m_code = RouterResultCode::RouteNotFound;
+    // Durations and distances of routes from every source to every target.
+    IndexRouter::Matrix m_matrix;
+    double m_buildTimeSeconds = 0.0;
+  };
+
+  MatrixResult ProcessMatrixTask(MatrixParams const & params);
+  std::future<MatrixResult> ProcessMatrixTaskAsync(MatrixParams const & params);
+
 private:
 
   class Processor
@@ -106,11 +141,13 @@ private:
     Processor(std::shared_ptr<NumMwmIds> numMwmIds,
               DataSourceStorage & dataSourceStorage,
               std::weak_ptr<storage::CountryParentGetter> cpg,
-              std::weak_ptr<storage::CountryInfoGetter> cig);
+              std::weak_ptr<storage::CountryInfoGetter> cig,
+              std::shared_ptr<IndexGraphStore> indexGraphStore);
 
     Processor(Processor && rhs) noexcept;
 
     Result operator()(Params const & params);
+    MatrixResult operator()(MatrixParams const & params);
 
   private:
     void InitRouter(VehicleType type);
@@ -127,6 +164,7 @@ private:
     std::weak_ptr<storage::CountryParentGetter> m_cpg;
     std::weak_ptr<storage::CountryInfoGetter> m_cig;
     std::unique_ptr<FrozenDataSource> m_dataSource;
+    std::shared_ptr<IndexGraphStore> m_indexGraphStore;
   };
 
   base::thread_pool::computational::ThreadPool m_threadPool;
@@ -140,6 +178,9 @@ private:
   std::shared_ptr<NumMwmIds> m_numMwmIds = std::make_shared<NumMwmIds>();
 
   DataSourceStorage m_dataSourcesStorage;
+
+  // Road and joint indexes are shared by routers of all the threads.
+  std::shared_ptr<IndexGraphStore> m_indexGraphStore = std::make_shared<IndexGraphStore>();
 };
 }  // namespace routes_builder
 }  // namespace routing
@@ -41,6 +41,29 @@ DEFINE_bool(verbose, false, "Verbose logging (default: false)");
 
 DEFINE_int32(launches_number, 1, "Number of launches of routes buildings. Needs for benchmarking (default: 1)");
 DEFINE_string(vehicle_type, "car", "Vehicle type: car|pedestrian|bicycle|transit. (Only for mapsme).");
+DEFINE_bool(matrix, false, "Build a matrix of route durations and distances instead of routes. "
+                           "--routes_file should contain points in format: \n\t"
+                           "lat lon\n\tlat lon\n\t...\nRoutes are built from every point of "
+                           "--routes_file to every point of --matrix_targets_file. (Only for mapsme).");
+DEFINE_string(matrix_targets_file, "", "Path to file with target points of matrix in the same "
+                                       "format as --routes_file. --routes_file is used if it's empty.");
+DEFINE_bool(parallel_bidirectional, false,
+            "Propagate forward and backward waves of A* in parallel threads. (Only for mapsme).");
+DEFINE_uint64(leaps_threads, 1, "Number of threads which calculate subroutes inside mwms of "
+                                "cross-mwm routes. (Only for mapsme).");
+DEFINE_uint64(alternatives, 0, "Max number of alternative routes which are dumped after the best "
+                               "route. (Only for mapsme).");
+DEFINE_bool(benchmark, false, "Build routes of --routes_file for every vehicle type of "
+                              "--benchmark_vehicle_types and dump time of route building phases, "
+                              "settled vertices and peak memory. (Only for mapsme).");
+DEFINE_string(benchmark_vehicle_types, "car", "Comma separated vehicle types for --benchmark.");
+DEFINE_string(benchmark_format, "json", "Format of --benchmark results: json|csv.");
+DEFINE_bool(streaming, false, "Read --routes_file lazily and append ETA and distance of every route "
+                              "to streaming_routes.csv in --dump_path with bounded memory. "
+                              "(Only for mapsme).");
+DEFINE_uint64(in_flight, 0, "Max number of routes which are built or wait for writing in "
+                            "--streaming mode. 4 * --threads is used by default.");
+DEFINE_bool(resume, false, "Continue --streaming build from the checkpoint in --dump_path.");
 
 using namespace routing;
 using namespace routes_builder;
@@ -98,6 +121,29 @@ int Main(int argc, char ** argv)
   else
     CHECK_EQUAL(Platform::MkDir(FLAGS_dump_path), Platform::EError::ERR_OK,());
 
+  if (IsLocalBuild() && FLAGS_matrix)
+  {
+    BuildMatrix(FLAGS_routes_file, FLAGS_matrix_targets_file, FLAGS_dump_path, FLAGS_threads,
+                FLAGS_timeout, FLAGS_vehicle_type, FLAGS_verbose);
+    return 0;
+  }
+
+  if (IsLocalBuild() && FLAGS_benchmark)
+  {
+    RunBenchmark(FLAGS_routes_file, FLAGS_dump_path, FLAGS_benchmark_vehicle_types, FLAGS_threads,
+                 FLAGS_timeout, static_cast<uint32_t>(FLAGS_launches_number),
+                 FLAGS_benchmark_format);
+    return 0;
+  }
+
+  if (IsLocalBuild() && FLAGS_streaming)
+  {
+    BuildRoutesStreaming(FLAGS_routes_file, FLAGS_dump_path, FLAGS_threads, FLAGS_timeout,
+                         FLAGS_vehicle_type, FLAGS_verbose, FLAGS_parallel_bidirectional,
+                         FLAGS_leaps_threads, FLAGS_in_flight, FLAGS_resume);
+    return 0;
+  }
+
   if (IsLocalBuild())
   {
     auto const launchesNumber = static_cast<uint32_t>(FLAGS_launches_number);
@@ -108,7 +154,8 @@ int Main(int argc, char ** argv)
     }
 
     BuildRoutes(FLAGS_routes_file, FLAGS_dump_path, FLAGS_start_from, FLAGS_threads, FLAGS_timeout,
-                FLAGS_vehicle_type, FLAGS_verbose, launchesNumber);
+                FLAGS_vehicle_type, FLAGS_verbose, launchesNumber,
+                FLAGS_parallel_bidirectional, FLAGS_leaps_threads, FLAGS_alternatives);
   }
 
   if (IsApiBuild())
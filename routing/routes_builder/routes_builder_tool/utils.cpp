@@ -8,23 +8,38 @@
 
 #include "platform/platform.hpp"
 
+#include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+
 #include "geometry/latlon.hpp"
 #include "geometry/mercator.hpp"
 
 #include "base/assert.hpp"
 #include "base/file_name_utils.hpp"
 #include "base/logging.hpp"
+#include "base/macros.hpp"
+#include "base/string_utils.hpp"
 #include "base/timer.hpp"
 
+#include "std/target_os.hpp"
+
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <cmath>
+#include <deque>
+#include <fstream>
 #include <future>
 #include <iostream>
+#include <map>
 #include <optional>
+#include <sstream>
 #include <thread>
 #include <tuple>
 
+#if defined(OMIM_OS_LINUX) || defined(OMIM_OS_MAC)
+#include <sys/resource.h>
+#endif
 
 namespace routing
 {
@@ -34,6 +49,10 @@ using namespace routing_quality;
 
 namespace
 {
+std::string const kStreamingResultsFile = "streaming_routes.csv";
+std::string const kStreamingCheckpointFile = "streaming_routes.checkpoint";
+double constexpr kStreamingCheckpointPeriodSeconds = 10.0;
+
 size_t GetNumberOfLines(std::string const & filename)
 {
   std::ifstream input(filename);
@@ -61,6 +80,316 @@ routing::VehicleType ConvertVehicleTypeFromString(std::string const & str)
   CHECK(false, ("Unknown vehicle type:", str));
   UNREACHABLE();
 }
+
+std::vector<m2::PointD> LoadPoints(std::string const & path)
+{
+  CHECK(Platform::IsFileExistsByFullPath(path), ("Can not find file:", path));
+  std::ifstream input(path);
+  CHECK(input.good(), ("Error during opening:", path));
+
+  std::vector<m2::PointD> points;
+  ms::LatLon latlon;
+  while (input >> latlon.m_lat >> latlon.m_lon)
+    points.emplace_back(mercator::FromLatLon(latlon));
+
+  return points;
+}
+
+// Peak resident set size of the process. Zero if it's unknown.
+uint64_t GetPeakMemoryBytes()
+{
+#if defined(OMIM_OS_LINUX) || defined(OMIM_OS_MAC)
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#if defined(OMIM_OS_MAC)
+  return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+  // ru_maxrss is in kilobytes on Linux.
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#else
+  return 0;
+#endif
+}
+
+struct BenchmarkRecord
+{
+  std::string m_vehicleType;
+  size_t m_routeIdx = 0;
+  RouterResultCode m_code = RouterResultCode::RouteNotFound;
+  double m_distanceMeters = 0.0;
+  double m_etaSeconds = 0.0;
+  double m_totalSeconds = 0.0;
+  RouteBuildStats m_stats;
+};
+
+// Metrics of a route which are summarized over all routes of a vehicle type.
+std::vector<std::string> const kPhaseMetrics = {"graph_loading_seconds", "fake_endings_seconds",
+                                                "leaps_search_seconds", "astar_seconds",
+                                                "directions_seconds"};
+
+std::vector<std::pair<std::string, double>> GetMetrics(BenchmarkRecord const & record)
+{
+  static_assert(RouteBuildStats::kPhasesNumber == 5, "Update kPhaseMetrics.");
+
+  std::vector<std::pair<std::string, double>> metrics;
+  metrics.emplace_back("total_seconds", record.m_totalSeconds);
+  for (size_t i = 0; i < RouteBuildStats::kPhasesNumber; ++i)
+  {
+    metrics.emplace_back(kPhaseMetrics[i],
+                         record.m_stats.GetSeconds(static_cast<RouteBuildStats::Phase>(i)));
+  }
+  // Time which is not covered by the phases: checkpoints preparation, route postprocessing, etc.
+  metrics.emplace_back("other_seconds",
+                       std::max(record.m_totalSeconds - record.m_stats.GetTotalSeconds(), 0.0));
+  metrics.emplace_back("settled_vertices", static_cast<double>(record.m_stats.GetSettledVertices()));
+  return metrics;
+}
+
+// Nearest-rank percentile of sorted |values|.
+double GetPercentile(std::vector<double> const & values, double percent)
+{
+  CHECK(!values.empty(), ());
+  auto const rank = static_cast<size_t>(std::ceil(percent / 100.0 * values.size()));
+  return values[std::min(std::max<size_t>(rank, 1), values.size()) - 1];
+}
+
+struct BenchmarkSummary
+{
+  struct Metric
+  {
+    std::string m_name;
+    double m_mean = 0.0;
+    double m_p50 = 0.0;
+    double m_p95 = 0.0;
+    double m_max = 0.0;
+  };
+
+  std::string m_vehicleType;
+  size_t m_routesNumber = 0;
+  size_t m_failedNumber = 0;
+  uint64_t m_peakMemoryBytes = 0;
+  // Metrics are summarized over successfully built routes only.
+  std::vector<Metric> m_metrics;
+};
+
+BenchmarkSummary Summarize(std::string const & vehicleType,
+                           std::vector<BenchmarkRecord> const & records, uint64_t peakMemoryBytes)
+{
+  BenchmarkSummary summary;
+  summary.m_vehicleType = vehicleType;
+  summary.m_peakMemoryBytes = peakMemoryBytes;
+
+  std::vector<std::pair<std::string, std::vector<double>>> values;
+  for (auto const & record : records)
+  {
+    if (record.m_vehicleType != vehicleType)
+      continue;
+
+    ++summary.m_routesNumber;
+    if (record.m_code != RouterResultCode::NoError)
+    {
+      ++summary.m_failedNumber;
+      continue;
+    }
+
+    auto const metrics = GetMetrics(record);
+    if (values.empty())
+    {
+      for (auto const & metric : metrics)
+        values.emplace_back(metric.first, std::vector<double>());
+    }
+
+    for (size_t i = 0; i < metrics.size(); ++i)
+      values[i].second.push_back(metrics[i].second);
+  }
+
+  for (auto & [name, metricValues] : values)
+  {
+    std::sort(metricValues.begin(), metricValues.end());
+
+    BenchmarkSummary::Metric metric;
+    metric.m_name = name;
+    for (auto const value : metricValues)
+      metric.m_mean += value;
+    metric.m_mean /= metricValues.size();
+    metric.m_p50 = GetPercentile(metricValues, 50.0);
+    metric.m_p95 = GetPercentile(metricValues, 95.0);
+    metric.m_max = metricValues.back();
+    summary.m_metrics.push_back(std::move(metric));
+  }
+
+  return summary;
+}
+
+void DumpBenchmarkJson(std::string const & dumpPath, std::vector<BenchmarkRecord> const & records,
+                       std::vector<BenchmarkSummary> const & summaries)
+{
+  std::string const fullPath = base::JoinPath(dumpPath, "benchmark.json");
+  std::ofstream output(fullPath);
+  CHECK(output.good(), ("Error during opening:", fullPath));
+  output.precision(9);
+
+  output << "{\n  \"routes\": [";
+  for (size_t i = 0; i < records.size(); ++i)
+  {
+    auto const & record = records[i];
+    output << (i == 0 ? "" : ",") << "\n    {\"vehicle_type\": \"" << record.m_vehicleType
+           << "\", \"route\": " << record.m_routeIdx << ", \"code\": \""
+           << ToString(record.m_code) << "\", \"distance_meters\": " << record.m_distanceMeters
+           << ", \"eta_seconds\": " << record.m_etaSeconds;
+    for (auto const & [name, value] : GetMetrics(record))
+      output << ", \"" << name << "\": " << value;
+    output << "}";
+  }
+
+  output << "\n  ],\n  \"summary\": [";
+  for (size_t i = 0; i < summaries.size(); ++i)
+  {
+    auto const & summary = summaries[i];
+    output << (i == 0 ? "" : ",") << "\n    {\"vehicle_type\": \"" << summary.m_vehicleType
+           << "\", \"routes\": " << summary.m_routesNumber
+           << ", \"failed\": " << summary.m_failedNumber
+           << ", \"peak_memory_bytes\": " << summary.m_peakMemoryBytes;
+    for (auto const & metric : summary.m_metrics)
+    {
+      output << ", \"" << metric.m_name << "\": {\"mean\": " << metric.m_mean
+             << ", \"p50\": " << metric.m_p50 << ", \"p95\": " << metric.m_p95
+             << ", \"max\": " << metric.m_max << "}";
+    }
+    output << "}";
+  }
+  output << "\n  ]\n}\n";
+}
+
+void DumpBenchmarkCsv(std::string const & dumpPath, std::vector<BenchmarkRecord> const & records,
+                      std::vector<BenchmarkSummary> const & summaries)
+{
+  {
+    std::string const fullPath = base::JoinPath(dumpPath, "benchmark_routes.csv");
+    std::ofstream output(fullPath);
+    CHECK(output.good(), ("Error during opening:", fullPath));
+    output.precision(9);
+
+    output << "vehicle_type,route,code,distance_meters,eta_seconds";
+    if (!records.empty())
+    {
+      for (auto const & metric : GetMetrics(records.front()))
+        output << ',' << metric.first;
+    }
+    output << '\n';
+
+    for (auto const & record : records)
+    {
+      output << record.m_vehicleType << ',' << record.m_routeIdx << ',' << ToString(record.m_code)
+             << ',' << record.m_distanceMeters << ',' << record.m_etaSeconds;
+      for (auto const & metric : GetMetrics(record))
+        output << ',' << metric.second;
+      output << '\n';
+    }
+  }
+
+  std::string const fullPath = base::JoinPath(dumpPath, "benchmark_summary.csv");
+  std::ofstream output(fullPath);
+  CHECK(output.good(), ("Error during opening:", fullPath));
+  output.precision(9);
+
+  output << "vehicle_type,metric,mean,p50,p95,max\n";
+  for (auto const & summary : summaries)
+  {
+    output << summary.m_vehicleType << ",routes," << summary.m_routesNumber << ",,,\n"
+           << summary.m_vehicleType << ",failed," << summary.m_failedNumber << ",,,\n"
+           << summary.m_vehicleType << ",peak_memory_bytes," << summary.m_peakMemoryBytes
+           << ",,,\n";
+    for (auto const & metric : summary.m_metrics)
+    {
+      output << summary.m_vehicleType << ',' << metric.m_name << ',' << metric.m_mean << ','
+             << metric.m_p50 << ',' << metric.m_p95 << ',' << metric.m_max << '\n';
+    }
+  }
+}
+
+// Throughput of the streaming build: routes per second and utilisation of the threads, i.e. the
+// part of the time which the threads spend on the tasks.
+class StreamingStats
+{
+public:
+  explicit StreamingStats(size_t threadsNumber) : m_threadsNumber(threadsNumber) {}
+
+  void Add(RoutesBuilder::Result const & result)
+  {
+    ++m_routesNumber;
+    if (!result.IsCodeOK())
+      ++m_failedNumber;
+    m_threadSeconds[result.m_threadId] += result.m_taskSeconds;
+  }
+
+  void Log(bool force)
+  {
+    double const elapsedSeconds = m_timer.ElapsedSeconds();
+    if (!force && elapsedSeconds - m_lastLogSeconds < kLogPeriodSeconds)
+      return;
+
+    double const periodSeconds = elapsedSeconds - m_lastLogSeconds;
+    double const recentRate =
+        periodSeconds > 0.0 ? (m_routesNumber - m_lastLogRoutesNumber) / periodSeconds : 0.0;
+
+    std::ostringstream utilisation;
+    utilisation.precision(2);
+    double busySeconds = 0.0;
+    for (auto const & [threadId, seconds] : m_threadSeconds)
+    {
+      UNUSED_VALUE(threadId);
+      busySeconds += seconds;
+      utilisation << (elapsedSeconds > 0.0 ? seconds / elapsedSeconds : 0.0) << " ";
+    }
+
+    LOG_FORCE(LINFO, ("Routes:", m_routesNumber, "failed:", m_failedNumber, "routes/s:",
+                      elapsedSeconds > 0.0 ? m_routesNumber / elapsedSeconds : 0.0,
+                      "recent routes/s:", recentRate, "utilisation:",
+                      elapsedSeconds > 0.0 ? busySeconds / (elapsedSeconds * m_threadsNumber) : 0.0,
+                      "per thread:", utilisation.str()));
+
+    m_lastLogSeconds = elapsedSeconds;
+    m_lastLogRoutesNumber = m_routesNumber;
+  }
+
+private:
+  static double constexpr kLogPeriodSeconds = 30.0;
+
+  size_t m_threadsNumber;
+  base::Timer m_timer;
+  uint64_t m_routesNumber = 0;
+  uint64_t m_failedNumber = 0;
+  std::map<std::thread::id, double> m_threadSeconds;
+  double m_lastLogSeconds = 0.0;
+  uint64_t m_lastLogRoutesNumber = 0;
+};
+
+// Number of processed lines of the routes file and the size of the results file which are
+// written atomically, so a build can be resumed after a crash.
+struct StreamingCheckpoint
+{
+  bool Load(std::string const & path)
+  {
+    std::ifstream input(path);
+    return static_cast<bool>(input >> m_linesNumber >> m_resultsSize);
+  }
+
+  void Save(std::string const & path) const
+  {
+    bool const saved = base::WriteToTempAndRenameToFile(path, [this](std::string const & tmpPath) {
+      std::ofstream output(tmpPath);
+      output << m_linesNumber << ' ' << m_resultsSize << '\n';
+      return static_cast<bool>(output);
+    });
+    CHECK(saved, ("Can't save checkpoint:", path));
+  }
+
+  uint64_t m_linesNumber = 0;
+  uint64_t m_resultsSize = 0;
+};
 }  // namespace
 
 void BuildRoutes(std::string const & routesPath,
@@ -70,7 +399,10 @@ void BuildRoutes(std::string const & routesPath,
                  uint32_t timeoutPerRouteSeconds,
                  std::string const & vehicleTypeStr,
                  bool verbose,
-                 uint32_t launchesNumber)
+                 uint32_t launchesNumber,
+                 bool parallelBidirectional,
+                 size_t leapsThreadsNumber,
+                 size_t alternativesNumber)
 {
   CHECK(Platform::IsFileExistsByFullPath(routesPath), ("Can not find file:", routesPath));
   CHECK(!dumpPath.empty(), ("Empty dumpPath."));
@@ -95,6 +427,9 @@ void BuildRoutes(std::string const & routesPath,
     params.m_type = vehicleType;
     params.m_timeoutSeconds = timeoutPerRouteSeconds;
     params.m_launchesNumber = launchesNumber;
+    params.m_parallelBidirectional = parallelBidirectional;
+    params.m_leapsThreadsNumber = leapsThreadsNumber;
+    params.m_alternativesNumber = alternativesNumber;
 
     base::ScopedLogLevelChanger changer(verbose ? base::LogLevel::LINFO : base::LogLevel::LERROR);
     ms::LatLon start;
@@ -145,6 +480,288 @@ void BuildRoutes(std::string const & routesPath,
   }
 }
 
+void BuildRoutesStreaming(std::string const & routesPath,
+                          std::string const & dumpPath,
+                          uint64_t threadsNumber,
+                          uint32_t timeoutPerRouteSeconds,
+                          std::string const & vehicleTypeStr,
+                          bool verbose,
+                          bool parallelBidirectional,
+                          size_t leapsThreadsNumber,
+                          size_t inFlightNumber,
+                          bool resume)
+{
+  CHECK(Platform::IsFileExistsByFullPath(routesPath), ("Can not find file:", routesPath));
+  CHECK(!dumpPath.empty(), ("Empty dumpPath."));
+
+  std::ifstream input(routesPath);
+  CHECK(input.good(), ("Error during opening:", routesPath));
+
+  if (!threadsNumber)
+  {
+    auto const hardwareConcurrency = std::thread::hardware_concurrency();
+    threadsNumber = hardwareConcurrency > 0 ? hardwareConcurrency : 2;
+  }
+
+  if (!inFlightNumber)
+    inFlightNumber = 4 * threadsNumber;
+
+  std::string const resultsPath = base::JoinPath(dumpPath, kStreamingResultsFile);
+  std::string const checkpointPath = base::JoinPath(dumpPath, kStreamingCheckpointFile);
+
+  StreamingCheckpoint checkpoint;
+  if (resume && checkpoint.Load(checkpointPath))
+  {
+    LOG_FORCE(LINFO, ("Resuming from line", checkpoint.m_linesNumber + 1, "of", routesPath));
+  }
+  else
+  {
+    checkpoint = {};
+    base::DeleteFileX(checkpointPath);
+  }
+
+  // Results which were written after the last checkpoint are cut off.
+  TruncatingFileWriter results(resultsPath);
+  results.Seek(checkpoint.m_resultsSize);
+  auto const writeLine = [&results](std::string const & line) {
+    results.Write(line.data(), line.size());
+  };
+  if (checkpoint.m_resultsSize == 0)
+    writeLine("route,code,eta_seconds,distance_meters,task_seconds\n");
+
+  std::string line;
+  uint64_t linesNumber = 0;
+  for (; linesNumber < checkpoint.m_linesNumber && std::getline(input, line); ++linesNumber)
+    ;
+
+  RoutesBuilder routesBuilder(threadsNumber);
+  RoutesBuilder::Params params;
+  params.m_type = ConvertVehicleTypeFromString(vehicleTypeStr);
+  params.m_timeoutSeconds = timeoutPerRouteSeconds;
+  params.m_parallelBidirectional = parallelBidirectional;
+  params.m_leapsThreadsNumber = leapsThreadsNumber;
+
+  base::ScopedLogLevelChanger changer(verbose ? base::LogLevel::LINFO : base::LogLevel::LERROR);
+
+  // Routes are read lazily and at most |inFlightNumber| of them are built or wait for writing.
+  // Results are written in the order of the routes file, so the checkpoint is a number of lines.
+  std::deque<std::pair<uint64_t, std::future<RoutesBuilder::Result>>> inFlight;
+  auto const submitNext = [&]() {
+    while (std::getline(input, line))
+    {
+      uint64_t const routeIdx = linesNumber++;
+      std::istringstream lineStream(line);
+      ms::LatLon start;
+      ms::LatLon finish;
+      if (!(lineStream >> start.m_lat >> start.m_lon >> finish.m_lat >> finish.m_lon))
+      {
+        LOG_FORCE(LWARNING, ("Wrong route at line", routeIdx + 1, ":", line));
+        continue;
+      }
+
+      params.m_checkpoints = Checkpoints(
+          std::vector<m2::PointD>({mercator::FromLatLon(start), mercator::FromLatLon(finish)}));
+      inFlight.emplace_back(routeIdx, routesBuilder.ProcessTaskAsync(params));
+      return true;
+    }
+    return false;
+  };
+
+  while (inFlight.size() < inFlightNumber && submitNext())
+    ;
+
+  StreamingStats stats(threadsNumber);
+  base::Timer checkpointTimer;
+  while (!inFlight.empty())
+  {
+    auto [routeIdx, task] = std::move(inFlight.front());
+    inFlight.pop_front();
+
+    auto const result = task.get();
+    submitNext();
+
+    std::ostringstream row;
+    row.precision(9);
+    row << routeIdx << ',' << ToString(result.m_code) << ',';
+    if (result.IsCodeOK() && !result.m_routes.empty())
+      row << result.m_routes.front().m_eta << ',' << result.m_routes.front().m_distance;
+    else
+      row << ',';
+    row << ',' << result.m_taskSeconds << '\n';
+    writeLine(row.str());
+
+    stats.Add(result);
+    stats.Log(false /* force */);
+
+    if (checkpointTimer.ElapsedSeconds() > kStreamingCheckpointPeriodSeconds)
+    {
+      results.Flush();
+      checkpoint.m_linesNumber = routeIdx + 1;
+      checkpoint.m_resultsSize = results.Pos();
+      checkpoint.Save(checkpointPath);
+      checkpointTimer.Reset();
+    }
+  }
+
+  results.Flush();
+  checkpoint.m_linesNumber = linesNumber;
+  checkpoint.m_resultsSize = results.Pos();
+  checkpoint.Save(checkpointPath);
+  stats.Log(true /* force */);
+}
+
+void BuildMatrix(std::string const & sourcesPath,
+                 std::string const & targetsPath,
+                 std::string const & dumpPath,
+                 uint64_t threadsNumber,
+                 uint32_t timeoutSeconds,
+                 std::string const & vehicleTypeStr,
+                 bool verbose)
+{
+  CHECK(!dumpPath.empty(), ("Empty dumpPath."));
+
+  auto const sources = LoadPoints(sourcesPath);
+  auto const targets = targetsPath.empty() ? sources : LoadPoints(targetsPath);
+
+  if (!threadsNumber)
+  {
+    auto const hardwareConcurrency = std::thread::hardware_concurrency();
+    threadsNumber = hardwareConcurrency > 0 ? hardwareConcurrency : 2;
+  }
+
+  RoutesBuilder routesBuilder(threadsNumber);
+
+  auto const vehicleType = ConvertVehicleTypeFromString(vehicleTypeStr);
+  base::ScopedLogLevelChanger changer(verbose ? base::LogLevel::LINFO : base::LogLevel::LERROR);
+
+  // Sources are split between threads, every task calculates rows of its sources.
+  size_t const rowsPerTask = std::max<size_t>((sources.size() + threadsNumber - 1) / threadsNumber, 1);
+  std::vector<std::future<RoutesBuilder::MatrixResult>> tasks;
+  {
+    RoutesBuilder::MatrixParams params;
+    params.m_type = vehicleType;
+    params.m_targets = targets;
+    params.m_timeoutSeconds = timeoutSeconds;
+    for (size_t begin = 0; begin < sources.size(); begin += rowsPerTask)
+    {
+      auto const end = std::min(begin + rowsPerTask, sources.size());
+      params.m_sources.assign(sources.begin() + begin, sources.begin() + end);
+      tasks.emplace_back(routesBuilder.ProcessMatrixTaskAsync(params));
+    }
+  }
+
+  LOG_FORCE(LINFO, ("Created:", tasks.size(), "tasks for matrix", sources.size(), "x",
+                    targets.size(), "vehicle type:", vehicleType));
+
+  std::string const fullPath = base::JoinPath(dumpPath, "matrix.csv");
+  std::ofstream output(fullPath);
+  CHECK(output.good(), ("Error during opening:", fullPath));
+  output << "source,target,code,eta_seconds,distance_meters\n";
+
+  base::Timer timer;
+  size_t sourceIdx = 0;
+  for (auto & task : tasks)
+  {
+    auto const result = task.get();
+    if (result.m_code != RouterResultCode::NoError)
+      LOG_FORCE(LINFO, ("Matrix rows from", sourceIdx, "are not built:", result.m_code));
+
+    for (auto const & row : result.m_matrix)
+    {
+      for (size_t targetIdx = 0; targetIdx < row.size(); ++targetIdx)
+      {
+        auto const & route = row[targetIdx];
+        output << sourceIdx << ',' << targetIdx << ',' << ToString(route.m_code) << ','
+               << route.m_etaSeconds << ',' << route.m_distanceMeters << '\n';
+      }
+      ++sourceIdx;
+    }
+
+    LOG_FORCE(LINFO, ("Progress:", static_cast<double>(sourceIdx) / sources.size() * 100.0, "%"));
+  }
+
+  LOG_FORCE(LINFO, ("BuildMatrix() took:", timer.ElapsedSeconds(), "seconds."));
+}
+
+void RunBenchmark(std::string const & routesPath,
+                  std::string const & dumpPath,
+                  std::string const & vehicleTypes,
+                  uint64_t threadsNumber,
+                  uint32_t timeoutPerRouteSeconds,
+                  uint32_t launchesNumber,
+                  std::string const & format)
+{
+  CHECK(Platform::IsFileExistsByFullPath(routesPath), ("Can not find file:", routesPath));
+  CHECK(!dumpPath.empty(), ("Empty dumpPath."));
+  CHECK(format == "json" || format == "csv", ("Unknown benchmark format:", format));
+
+  std::vector<std::pair<m2::PointD, m2::PointD>> routes;
+  {
+    std::ifstream input(routesPath);
+    CHECK(input.good(), ("Error during opening:", routesPath));
+
+    ms::LatLon start;
+    ms::LatLon finish;
+    while (input >> start.m_lat >> start.m_lon >> finish.m_lat >> finish.m_lon)
+      routes.emplace_back(mercator::FromLatLon(start), mercator::FromLatLon(finish));
+  }
+
+  // Routes are built one by one by default so that phases of different routes don't compete
+  // for cpu and caches.
+  if (!threadsNumber)
+    threadsNumber = 1;
+
+  RoutesBuilder routesBuilder(threadsNumber);
+  base::ScopedLogLevelChanger changer(base::LogLevel::LERROR);
+
+  std::vector<BenchmarkRecord> records;
+  std::vector<BenchmarkSummary> summaries;
+  for (auto const & vehicleTypeStr : strings::Tokenize<std::string>(vehicleTypes, ","))
+  {
+    RoutesBuilder::Params params;
+    params.m_type = ConvertVehicleTypeFromString(vehicleTypeStr);
+    params.m_timeoutSeconds = timeoutPerRouteSeconds;
+    params.m_launchesNumber = launchesNumber;
+
+    std::vector<std::future<RoutesBuilder::Result>> tasks;
+    for (auto const & [start, finish] : routes)
+    {
+      params.m_checkpoints = Checkpoints(start, finish);
+      tasks.emplace_back(routesBuilder.ProcessTaskAsync(params));
+    }
+
+    LOG_FORCE(LINFO, ("Benchmark of", tasks.size(), "routes, vehicle type:", params.m_type));
+    base::Timer timer;
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+      auto const result = tasks[i].get();
+
+      BenchmarkRecord record;
+      record.m_vehicleType = vehicleTypeStr;
+      record.m_routeIdx = i;
+      record.m_code = result.m_code;
+      record.m_totalSeconds = result.m_buildTimeSeconds;
+      record.m_stats = result.m_stats;
+      if (result.IsCodeOK() && !result.GetRoutes().empty())
+      {
+        record.m_distanceMeters = result.GetRoutes().front().m_distance;
+        record.m_etaSeconds = result.GetRoutes().front().m_eta;
+      }
+      records.push_back(std::move(record));
+    }
+
+    // Peak memory is of the whole process, so it doesn't decrease for the next vehicle types.
+    summaries.push_back(Summarize(vehicleTypeStr, records, GetPeakMemoryBytes()));
+    LOG_FORCE(LINFO, ("Benchmark of vehicle type", params.m_type, "took:", timer.ElapsedSeconds(),
+                      "seconds."));
+  }
+
+  if (format == "json")
+    DumpBenchmarkJson(dumpPath, records, summaries);
+  else
+    DumpBenchmarkCsv(dumpPath, records, summaries);
+}
+
 std::optional<std::tuple<ms::LatLon, ms::LatLon, int32_t>> ParseApiLine(std::ifstream & input)
 {
   std::string line;
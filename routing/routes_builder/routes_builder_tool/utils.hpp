@@ -20,7 +20,51 @@ void BuildRoutes(std::string const & routesPath,
                  uint32_t timeoutPerRouteSeconds,
                  std::string const & vehicleType,
                  bool verbose,
-                 uint32_t launchesNumber);
+                 uint32_t launchesNumber,
+                 bool parallelBidirectional,
+                 size_t leapsThreadsNumber,
+                 size_t alternativesNumber);
+
+/// \brief Builds routes of |routesPath| with bounded memory for files with millions of routes.
+/// Routes are read lazily and at most |inFlightNumber| routes (4 * |threadsNumber| if it's 0) are
+/// built or wait for writing at a time. ETA and distance of the best route of every line are
+/// appended to |dumpPath|/streaming_routes.csv in the order of the lines. Progress is saved to
+/// |dumpPath|/streaming_routes.checkpoint periodically, so with |resume| the build continues
+/// from the last checkpoint. Throughput and utilisation of the threads are logged as it runs.
+void BuildRoutesStreaming(std::string const & routesPath,
+                          std::string const & dumpPath,
+                          uint64_t threadsNumber,
+                          uint32_t timeoutPerRouteSeconds,
+                          std::string const & vehicleType,
+                          bool verbose,
+                          bool parallelBidirectional,
+                          size_t leapsThreadsNumber,
+                          size_t inFlightNumber,
+                          bool resume);
+
+/// \brief Builds durations and distances of routes from every point of |sourcesPath| to every
+/// point of |targetsPath| or of |sourcesPath| if |targetsPath| is empty. Files contain points in
+/// format "lat lon" on each line. The matrix is dumped to |dumpPath|/matrix.csv.
+void BuildMatrix(std::string const & sourcesPath,
+                 std::string const & targetsPath,
+                 std::string const & dumpPath,
+                 uint64_t threadsNumber,
+                 uint32_t timeoutSeconds,
+                 std::string const & vehicleType,
+                 bool verbose);
+
+/// \brief Builds every route of |routesPath| for every vehicle type of |vehicleTypes| (comma
+/// separated) and dumps time of route building phases, number of settled vertices and peak
+/// memory to |dumpPath|. |format| is "json" (benchmark.json) or "csv" (benchmark_routes.csv and
+/// benchmark_summary.csv). Results of different builds are comparable if they are run with the
+/// same routes, maps and number of threads.
+void RunBenchmark(std::string const & routesPath,
+                  std::string const & dumpPath,
+                  std::string const & vehicleTypes,
+                  uint64_t threadsNumber,
+                  uint32_t timeoutPerRouteSeconds,
+                  uint32_t launchesNumber,
+                  std::string const & format);
 
 void BuildRoutesWithApi(std::unique_ptr<routing_quality::api::RoutingApi> routingApi,
                         std::string const & routesPath,
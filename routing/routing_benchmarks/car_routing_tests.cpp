@@ -10,6 +10,10 @@
 #include "geometry/latlon.hpp"
 #include "geometry/mercator.hpp"
 
+#include "base/logging.hpp"
+#include "base/math.hpp"
+#include "base/timer.hpp"
+
 #include <memory>
 #include <set>
 #include <string>
@@ -37,6 +41,35 @@ public:
       TestRouter(*router, startMerc, finalMerc, routeFoundByAstarBidirectional);
   }
 
+  // Builds the route |reiterations| times by the contraction hierarchy and by the joints search
+  // and logs time of both.
+  void CompareContractionHierarchy(ms::LatLon const & start, ms::LatLon const & final,
+                                   size_t reiterations)
+  {
+    m2::PointD const startMerc = mercator::FromLatLon(start);
+    m2::PointD const finalMerc = mercator::FromLatLon(final);
+
+    auto const calculate = [&](bool contractionHierarchy, routing::Route & route) {
+      auto router = CreateIndexRouter();
+      router->SetContractionHierarchyEnabled(contractionHierarchy);
+      base::Timer timer;
+      for (size_t i = 0; i < reiterations; ++i)
+        TestRouter(*router, startMerc, finalMerc, route);
+      return timer.ElapsedSeconds();
+    };
+
+    routing::Route chRoute("", 0 /* route id */);
+    double const chSec = calculate(true /* contractionHierarchy */, chRoute);
+    routing::Route jointsRoute("", 0 /* route id */);
+    double const jointsSec = calculate(false /* contractionHierarchy */, jointsRoute);
+
+    LOG(LINFO, ("Routes:", reiterations, "contraction hierarchy, seconds:", chSec,
+                "joints, seconds:", jointsSec));
+    // Both searches find the best route, only routes of the same weight may differ.
+    TEST(base::AlmostEqualRel(chRoute.GetTotalTimeSec(), jointsRoute.GetTotalTimeSec(), 1e-3),
+         (chRoute.GetTotalTimeSec(), jointsRoute.GetTotalTimeSec()));
+  }
+
 protected:
   std::unique_ptr<routing::VehicleModelFactoryInterface> CreateModelFactory() override
   {
@@ -64,4 +97,16 @@ UNIT_CLASS_TEST(CarTest, InAirport)
 {
   TestCarRouter(ms::LatLon(55.97285, 37.41275), ms::LatLon(55.96396, 37.41922), 30);
 }
+
+// Long routes across the city are built by the contraction hierarchy if the mwm has
+// ROUTING_CH_FILE_TAG section, see generator_tool --make_routing_contraction_hierarchy.
+UNIT_CLASS_TEST(CarTest, ContractionHierarchyAcrossCity)
+{
+  CompareContractionHierarchy(ms::LatLon(55.90466, 37.39752), ms::LatLon(55.57817, 37.81326), 5);
+}
+
+UNIT_CLASS_TEST(CarTest, ContractionHierarchyCenterToRingRoad)
+{
+  CompareContractionHierarchy(ms::LatLon(55.75785, 37.58267), ms::LatLon(55.83061, 37.84321), 5);
+}
 }  // namespace
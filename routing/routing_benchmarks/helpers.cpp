@@ -125,6 +125,11 @@ void RoutingTest::TestTwoPointsOnFeature(m2::PointD const & startPos, m2::PointD
 }
 
 unique_ptr<routing::IRouter> RoutingTest::CreateRouter(string const & name)
+{
+  return CreateIndexRouter();
+}
+
+unique_ptr<routing::IndexRouter> RoutingTest::CreateIndexRouter()
 {
   vector<platform::LocalCountryFile> neededLocalFiles;
   neededLocalFiles.reserve(m_neededMaps.size());
@@ -134,9 +139,8 @@ unique_ptr<routing::IRouter> RoutingTest::CreateRouter(string const & name)
       neededLocalFiles.push_back(file);
   }
 
-  unique_ptr<routing::IRouter> router = integration::CreateVehicleRouter(
-      m_dataSource, *m_cig, m_trafficCache, neededLocalFiles, m_type);
-  return router;
+  return integration::CreateVehicleRouter(m_dataSource, *m_cig, m_trafficCache, neededLocalFiles,
+                                          m_type);
 }
 
 void RoutingTest::GetNearestEdges(m2::PointD const & pt,
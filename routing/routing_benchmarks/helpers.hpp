@@ -39,6 +39,7 @@ protected:
   virtual std::unique_ptr<routing::VehicleModelFactoryInterface> CreateModelFactory() = 0;
 
   std::unique_ptr<routing::IRouter> CreateRouter(std::string const & name);
+  std::unique_ptr<routing::IndexRouter> CreateIndexRouter();
   void GetNearestEdges(m2::PointD const & pt,
                        std::vector<std::pair<routing::Edge, geometry::PointWithAltitude>> & edges);
 
@@ -7,16 +7,19 @@
 
 #include "base/assert.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace routing
 {
 class Route;
+class RouteSegment;
 
 /// Routing possible statuses enumeration.
 /// \warning  this enum has JNI mirror!
@@ -73,6 +76,8 @@ enum class SessionState
  */
 
 using CheckpointCallback = std::function<void(size_t passedCheckpointIdx)>;
+using DirectionsReadyCallback = std::function<void(
+    uint64_t routeId, size_t firstSegmentIdx, std::vector<RouteSegment> const &)>;
 using NeedMoreMapsCallback = std::function<void(uint64_t, std::set<std::string> const &)>;
 using PointCheckCallback = std::function<void(ms::LatLon const &)>;
 using ProgressCallback = std::function<void(float)>;
@@ -45,6 +45,22 @@ void FillSegmentInfo(vector<double> const & times, vector<RouteSegment> & routeS
   }
 }
 
+namespace
+{
+void SetRouteSegmentsAndGeometry(vector<geometry::PointWithAltitude> const & path,
+                                 vector<double> const & times, vector<RouteSegment> && routeSegments,
+                                 Route & route)
+{
+  FillSegmentInfo(times, routeSegments);
+  route.SetRouteSegments(move(routeSegments));
+
+  vector<m2::PointD> routeGeometry;
+  JunctionsToPoints(path, routeGeometry);
+
+  route.SetGeometry(routeGeometry.begin(), routeGeometry.end());
+}
+}  // namespace
+
 void ReconstructRoute(DirectionsEngine & engine, IndexRoadGraph const & graph,
                       base::Cancellable const & cancellable,
                       vector<geometry::PointWithAltitude> const & path, vector<double> const & times,
@@ -65,13 +81,26 @@ void ReconstructRoute(DirectionsEngine & engine, IndexRoadGraph const & graph,
   if (cancellable.IsCancelled())
     return;
 
-  FillSegmentInfo(times, routeSegments);
-  route.SetRouteSegments(move(routeSegments));
+  SetRouteSegmentsAndGeometry(path, times, move(routeSegments), route);
+}
 
-  vector<m2::PointD> routeGeometry;
-  JunctionsToPoints(path, routeGeometry);
+void ReconstructRoute(DirectionsEngine & engine, IndexRoadGraph const & graph,
+                      IndexRoadGraph const & prefixGraph, size_t directionsSize,
+                      base::Cancellable const & cancellable,
+                      vector<geometry::PointWithAltitude> const & path, vector<double> const & times,
+                      Route & route)
+{
+  CHECK_EQUAL(path.size(), times.size() + 1, ());
 
-  route.SetGeometry(routeGeometry.begin(), routeGeometry.end());
+  vector<RouteSegment> routeSegments;
+  if (!engine.Generate(graph, prefixGraph, path, directionsSize, cancellable, routeSegments))
+    return;
+
+  if (cancellable.IsCancelled())
+    return;
+
+  SetRouteSegmentsAndGeometry(path, times, move(routeSegments), route);
+  route.SetPendingDirections(true);
 }
 
 Segment ConvertEdgeToSegment(NumMwmIds const & numMwmIds, Edge const & edge)
@@ -177,6 +206,18 @@ bool AStarLengthChecker::operator()(RouteWeight const & weight) const
   return m_starter.CheckLength(weight);
 }
 
+// MaxWeightLengthChecker --------------------------------------------------------------------------
+
+MaxWeightLengthChecker::MaxWeightLengthChecker(IndexGraphStarter & starter, double maxWeight)
+  : m_starter(starter), m_maxWeight(maxWeight)
+{
+}
+
+bool MaxWeightLengthChecker::operator()(RouteWeight const & weight) const
+{
+  return weight.GetWeight() <= m_maxWeight && m_starter.CheckLength(weight);
+}
+
 // AdjustLengthChecker -----------------------------------------------------------------------------
 
 AdjustLengthChecker::AdjustLengthChecker(IndexGraphStarter & starter) : m_starter(starter) {}
@@ -56,6 +56,15 @@ void ReconstructRoute(DirectionsEngine & engine, IndexRoadGraph const & graph,
                       std::vector<geometry::PointWithAltitude> const & path, std::vector<double> const & times,
                       Route & route);
 
+/// \brief The same as above but turns and street names are generated only for the first
+/// |directionsSize| segments with the help of |prefixGraph|, see DirectionsEngine::Generate().
+/// |route| is marked as a route with pending directions.
+void ReconstructRoute(DirectionsEngine & engine, IndexRoadGraph const & graph,
+                      IndexRoadGraph const & prefixGraph, size_t directionsSize,
+                      base::Cancellable const & cancellable,
+                      std::vector<geometry::PointWithAltitude> const & path, std::vector<double> const & times,
+                      Route & route);
+
 /// \brief Converts |edge| to |segment|.
 /// \returns Segment() if mwm of |edge| is not alive.
 Segment ConvertEdgeToSegment(NumMwmIds const & numMwmIds, Edge const & edge);
@@ -81,6 +90,15 @@ struct AStarLengthChecker
   IndexGraphStarter & m_starter;
 };
 
+// Checks the length as AStarLengthChecker does and limits the weight of the way by |maxWeight|.
+struct MaxWeightLengthChecker
+{
+  MaxWeightLengthChecker(IndexGraphStarter & starter, double maxWeight);
+  bool operator()(RouteWeight const & weight) const;
+  IndexGraphStarter & m_starter;
+  double m_maxWeight;
+};
+
 struct AdjustLengthChecker
 {
   explicit AdjustLengthChecker(IndexGraphStarter & starter);
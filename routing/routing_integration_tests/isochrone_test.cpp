@@ -0,0 +1,84 @@
+#include "testing/testing.hpp"
+
+#include "routing/routing_integration_tests/routing_test_tools.hpp"
+
+#include "routing/index_router.hpp"
+#include "routing/router_delegate.hpp"
+
+#include "geometry/mercator.hpp"
+#include "geometry/rect2d.hpp"
+
+#include <vector>
+
+namespace isochrone_test
+{
+using namespace routing;
+using namespace std;
+
+IndexRouter & GetCarRouter()
+{
+  return dynamic_cast<IndexRouter &>(integration::GetVehicleComponents(VehicleType::Car).GetRouter());
+}
+
+IndexRouter::Isochrone CalculateIsochrone(ms::LatLon const & start, double maxWeightSeconds,
+                                          size_t maxSegmentsNumber)
+{
+  RouterDelegate delegate;
+  IndexRouter::Isochrone isochrone;
+  TEST_EQUAL(GetCarRouter().CalculateIsochrone(mercator::FromLatLon(start), maxWeightSeconds,
+                                               maxSegmentsNumber, delegate, isochrone),
+             RouterResultCode::NoError, (start, maxWeightSeconds));
+  return isochrone;
+}
+
+UNIT_TEST(Isochrone_Moscow_Grows)
+{
+  ms::LatLon const start(55.75100, 37.61790);
+  size_t constexpr kMaxSegmentsNumber = 10000000;
+
+  auto const small = CalculateIsochrone(start, 5 * 60.0 /* maxWeightSeconds */, kMaxSegmentsNumber);
+  auto const big = CalculateIsochrone(start, 15 * 60.0 /* maxWeightSeconds */, kMaxSegmentsNumber);
+
+  TEST(!small.m_isTruncated, ());
+  TEST(!big.m_isTruncated, ());
+  TEST_GREATER(big.m_segments.size(), small.m_segments.size(), ());
+
+  for (auto const & isochrone : {small, big})
+  {
+    TEST_GREATER_OR_EQUAL(isochrone.m_hull.size(), 3, ());
+    m2::RectD rect;
+    for (auto const & point : isochrone.m_hull)
+      rect.Add(point);
+    TEST(rect.IsPointInside(mercator::FromLatLon(start)), (rect));
+  }
+
+  for (auto const & [segment, weight] : small.m_segments)
+    TEST_LESS_OR_EQUAL(weight, 5 * 60.0, (segment));
+}
+
+UNIT_TEST(Isochrone_Moscow_Truncated)
+{
+  size_t constexpr kMaxSegmentsNumber = 1000;
+  auto const isochrone = CalculateIsochrone(ms::LatLon(55.75100, 37.61790),
+                                            60 * 60.0 /* maxWeightSeconds */, kMaxSegmentsNumber);
+
+  TEST(isochrone.m_isTruncated, ());
+  TEST_LESS_OR_EQUAL(isochrone.m_segments.size(), kMaxSegmentsNumber, ());
+}
+
+// The isochrone of a border point spreads to the neighbouring mwm.
+UNIT_TEST(Isochrone_CrossMwm)
+{
+  // Dutch-German border.
+  auto const isochrone = CalculateIsochrone(ms::LatLon(51.94150, 6.42240),
+                                            20 * 60.0 /* maxWeightSeconds */,
+                                            10000000 /* maxSegmentsNumber */);
+
+  TEST(!isochrone.m_segments.empty(), ());
+  bool hasOtherMwm = false;
+  auto const mwmId = isochrone.m_segments.front().first.GetMwmId();
+  for (auto const & [segment, weight] : isochrone.m_segments)
+    hasOtherMwm = hasOtherMwm || segment.GetMwmId() != mwmId;
+  TEST(hasOtherMwm, ());
+}
+}  // namespace isochrone_test
@@ -18,6 +18,7 @@
 
 #include "geometry/point_with_altitude.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -53,3 +54,43 @@ UNIT_TEST(FakeEdgesCombinatorialExplosion)
   // FeaturesRoadGraph::m_fakeIngoingEdges and FeaturesRoadGraph::m_fakeOutgoingEdges fields.
   graph.AddFakeEdges(j, sourceVicinity);
 }
+
+// Roads near a point are found by the road segments index of the mwm if the graph has a vehicle
+// type and by reading of the features in the rect otherwise. Both ways should give the same roads.
+UNIT_TEST(FindRoads_SegmentsIndexAndFeatures)
+{
+  classificator::Load();
+
+  std::vector<LocalCountryFile> localFiles;
+  GetAllLocalFiles(localFiles);
+  TEST(!localFiles.empty(), ());
+
+  FrozenDataSource dataSource;
+  for (auto const & file : localFiles)
+    dataSource.Register(file);
+
+  auto const factory = std::make_shared<CarModelFactory>(CountryParentNameGetterFn());
+  MwmDataSource featuresSource(dataSource, nullptr /* numMwmIDs */);
+  FeaturesRoadGraph featuresGraph(featuresSource, IRoadGraph::Mode::ObeyOnewayTag, factory);
+  MwmDataSource indexSource(dataSource, nullptr /* numMwmIDs */);
+  FeaturesRoadGraph indexGraph(indexSource, IRoadGraph::Mode::ObeyOnewayTag, factory,
+                               VehicleType::Car);
+
+  auto const getFeatures = [](std::vector<IRoadGraph::FullRoadInfo> const & roads)
+  {
+    std::vector<FeatureID> ids;
+    for (auto const & road : roads)
+      ids.push_back(road.m_featureId);
+    std::sort(ids.begin(), ids.end());
+    return ids;
+  };
+
+  for (auto const & latLon : {ms::LatLon(55.75100, 37.61790), ms::LatLon(50.73208, -1.21279)})
+  {
+    auto const rect = mercator::RectByCenterXYAndSizeInMeters(mercator::FromLatLon(latLon), 300.0);
+    auto const roads = getFeatures(indexGraph.FindRoads(rect, nullptr /* isGoodFeature */));
+    TEST(!roads.empty(), (latLon));
+    TEST_EQUAL(roads, getFeatures(featuresGraph.FindRoads(rect, nullptr /* isGoodFeature */)),
+               (latLon));
+  }
+}
@@ -2,8 +2,14 @@
 
 #include "routing/routing_integration_tests/routing_test_tools.hpp"
 
+#include "routing/index_router.hpp"
+#include "routing/router_delegate.hpp"
+#include "routing/transit_raptor.hpp"
+
 #include "geometry/mercator.hpp"
 
+#include <ctime>
+
 using namespace routing;
 
 namespace
@@ -36,6 +42,27 @@ UNIT_TEST(Transit_Moscow_DubrovkaToTrtykovskya)
   integration::CheckSubwayExistence(*routeResult.first);
 }
 
+UNIT_TEST(Transit_Moscow_DubrovkaToTrtykovskya_Journey)
+{
+  auto & router =
+      dynamic_cast<IndexRouter &>(integration::GetVehicleComponents(VehicleType::Transit).GetRouter());
+
+  // Tomorrow at 06:00 UTC, it's morning in Moscow.
+  time_t constexpr kDaySeconds = 24 * 60 * 60;
+  time_t const departure = (time(nullptr) / kDaySeconds + 1) * kDaySeconds + 6 * 60 * 60;
+
+  RouterDelegate delegate;
+  TransitRaptor::Journey journey;
+  TEST_EQUAL(router.CalculateTransitJourney(mercator::FromLatLon(55.71813, 37.67756),
+                                            mercator::FromLatLon(55.74089, 37.62831), departure,
+                                            delegate, journey),
+             RouterResultCode::NoError, ());
+
+  TEST_GREATER_OR_EQUAL(journey.GetRidesNumber(), 1, (journey));
+  TEST_GREATER_OR_EQUAL(journey.m_departureTime, departure, (journey));
+  TEST_GREATER(journey.m_arrivalTime, journey.m_departureTime, (journey));
+}
+
 UNIT_TEST(Transit_Moscow_NoSubwayTest)
 {
   TRouteResult routeResult =
@@ -79,6 +79,10 @@ void RoutingSession::Init(PointCheckCallback const & pointCheckCallback)
   CHECK_THREAD_CHECKER(m_threadChecker, ());
   CHECK(!m_router, ());
   m_router = make_unique<AsyncRouter>(pointCheckCallback);
+  m_router->SetDirectionsReadyCallback(
+      [this](uint64_t routeId, size_t firstSegmentIdx, vector<RouteSegment> const & routeSegments) {
+        OnDirectionsReady(routeId, firstSegmentIdx, routeSegments);
+      });
 }
 
 void RoutingSession::BuildRoute(Checkpoints const & checkpoints, uint32_t timeoutSec)
@@ -514,6 +518,19 @@ void RoutingSession::GenerateNotifications(vector<string> & notifications)
   m_speedCameraManager.GenerateNotifications(notifications);
 }
 
+void RoutingSession::OnDirectionsReady(uint64_t routeId, size_t firstSegmentIdx,
+                                       vector<RouteSegment> const & routeSegments)
+{
+  CHECK_THREAD_CHECKER(m_threadChecker, ());
+  // The route may be rebuilt or removed while its directions are generated.
+  if (!m_route->IsRouteId(routeId) || !m_route->HasPendingDirections())
+    return;
+
+  m_route->SetDirections(firstSegmentIdx, routeSegments);
+  if (m_directionsAppliedCallback)
+    m_directionsAppliedCallback(*m_route);
+}
+
 void RoutingSession::AssignRoute(shared_ptr<Route> route, RouterResultCode e)
 {
   CHECK_THREAD_CHECKER(m_threadChecker, ());
@@ -705,6 +722,12 @@ void RoutingSession::SetOnNewTurnCallback(OnNewTurn const & onNewTurn)
   m_onNewTurn = onNewTurn;
 }
 
+void RoutingSession::SetDirectionsAppliedCallback(RouteCallback const & directionsAppliedCallback)
+{
+  CHECK_THREAD_CHECKER(m_threadChecker, ());
+  m_directionsAppliedCallback = directionsAppliedCallback;
+}
+
 void RoutingSession::SetUserCurrentPosition(m2::PointD const & position)
 {
   CHECK_THREAD_CHECKER(m_threadChecker, ());
@@ -819,18 +842,11 @@ void RoutingSession::OnTrafficInfoClear()
 
 void RoutingSession::OnTrafficInfoAdded(TrafficInfo && info)
 {
-  TrafficInfo::Coloring const & fullColoring = info.GetColoring();
-  auto coloring = make_shared<TrafficInfo::Coloring>();
-  for (auto const & kv : fullColoring)
-  {
-    ASSERT_NOT_EQUAL(kv.second, SpeedGroup::Unknown, ());
-    coloring->insert(kv);
-  }
-
-  // Note. |coloring| should not be used after this call on gui thread.
+  // The table is immutable, so it's shared with TrafficInfo without copying.
+  auto const table = info.GetTable();
   auto const mwmId = info.GetMwmId();
-  GetPlatform().RunTask(Platform::Thread::Gui, [this, mwmId, coloring]() {
-    Set(mwmId, coloring);
+  GetPlatform().RunTask(Platform::Thread::Gui, [this, mwmId, table]() {
+    Set(mwmId, table);
     RebuildRouteOnTrafficUpdate();
   });
 }
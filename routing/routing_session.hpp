@@ -130,6 +130,9 @@ public:
   /// \brief Sets a callback which is called every time when RoutingSession::m_state is changed.
   void SetChangeSessionStateCallback(ChangeSessionStateCallback const & changeSessionStateCallback);
   void SetOnNewTurnCallback(OnNewTurn const & onNewTurn);
+  /// \brief Sets a callback which is called when turns and street names of the current route
+  /// which are generated after the route is built are applied to it.
+  void SetDirectionsAppliedCallback(RouteCallback const & directionsAppliedCallback);
 
   void SetSpeedCamShowCallback(SpeedCameraShowCallback && callback);
   void SetSpeedCamClearCallback(SpeedCameraClearCallback && callback);
@@ -184,6 +187,9 @@ private:
   };
 
   void AssignRoute(std::shared_ptr<Route> route, RouterResultCode e);
+  /// Applies turns and street names which are generated after the route with |routeId| is built.
+  void OnDirectionsReady(uint64_t routeId, size_t firstSegmentIdx,
+                         std::vector<RouteSegment> const & routeSegments);
   /// RemoveRoute() removes m_route and resets route attributes (m_lastDistance, m_moveAwayCounter).
   void RemoveRoute();
   void RebuildRouteOnTrafficUpdate();
@@ -224,6 +230,7 @@ private:
   CheckpointCallback m_checkpointCallback;
   ChangeSessionStateCallback m_changeSessionStateCallback;
   OnNewTurn m_onNewTurn;
+  RouteCallback m_directionsAppliedCallback;
 
   // Statistics parameters
   // Passed distance on route including reroutes
@@ -9,6 +9,7 @@
 #include "routing/index_graph.hpp"
 #include "routing/index_graph_starter.hpp"
 #include "routing/routing_session.hpp"
+#include "routing/speed_profiles.hpp"
 #include "routing/traffic_stash.hpp"
 
 #include "routing_common/car_model.hpp"
@@ -19,7 +20,10 @@
 
 #include "routing/base/astar_algorithm.hpp"
 
+#include <algorithm>
+#include <ctime>
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace
@@ -55,7 +59,9 @@ using namespace traffic;
 //                Start
 //
 // Note. This graph consists of 10 one segment directed features.
-unique_ptr<WorldGraph> BuildXXGraph(shared_ptr<EdgeEstimator> estimator)
+// F3 has |profileOnF3| speed profile if it's valid.
+unique_ptr<WorldGraph> BuildXXGraph(shared_ptr<EdgeEstimator> estimator,
+                                    SpeedProfile profileOnF3 = SpeedProfile())
 {
   unique_ptr<TestGeometryLoader> loader = make_unique<TestGeometryLoader>();
   loader->AddRoad(0 /* featureId */, true /* oneWay */, 1.0 /* speed */,
@@ -78,6 +84,8 @@ unique_ptr<WorldGraph> BuildXXGraph(shared_ptr<EdgeEstimator> estimator)
                   RoadGeometry::Points({{3.0, 0.0}, {3.0, 1.0}}));
   loader->AddRoad(9 /* featureId */, true /* oneWay */, 1.0 /* speed */,
                   RoadGeometry::Points({{2.0, -1.0}, {2.0, 0.0}}));
+  if (profileOnF3.IsValid())
+    loader->SetSpeedProfiles(3 /* featureId */, profileOnF3, profileOnF3);
 
   vector<Joint> const joints = {
       MakeJoint({{0 /* feature id */, 0 /* point id */}}), /* joint at point (0, 0) */
@@ -107,7 +115,7 @@ public:
 
   void SetTrafficColoring(shared_ptr<TrafficInfo::Coloring const> coloring)
   {
-    m_trafficStash->SetColoring(kTestNumMwmId, coloring);
+    m_trafficStash->SetColoring(kTestNumMwmId, make_shared<TrafficTable const>(*coloring));
   }
 
   shared_ptr<EdgeEstimator> GetEstimator() const { return m_estimator; }
@@ -253,4 +261,63 @@ UNIT_CLASS_TEST(ApplyingTrafficTest, XXGraph_ChangingTraffic)
     TestRouteGeometry(*starter, Algorithm::Result::OK, noTrafficGeom);
   }
 }
+
+// Route through XX graph with a slow speed profile on F3.
+UNIT_CLASS_TEST(ApplyingTrafficTest, XXGraph_SpeedProfileOnF3)
+{
+  // A fifth of the speed of the vehicle model all the week long.
+  SpeedProfile::Ratios ratios;
+  ratios.fill(SpeedProfile::kRatioDenominator / 5);
+  SpeedProfile const profile(ratios.data());
+
+  vector<m2::PointD> const directGeom = {{2 /* x */, -1 /* y */}, {2, 0}, {1, 1}, {2, 2}, {3, 3}};
+  vector<m2::PointD> const detourGeom = {{2 /* x */, -1 /* y */}, {2, 0}, {3, 0},
+                                         {3, 1}, {2, 2}, {3, 3}};
+  auto const testRoute = [&](optional<time_t> departureTime,
+                             vector<m2::PointD> const & expectedGeom) {
+    GetEstimator()->SetDepartureTime(departureTime);
+    unique_ptr<WorldGraph> graph = BuildXXGraph(GetEstimator(), profile);
+    auto const start =
+        MakeFakeEnding(9 /* featureId */, 0 /* segmentIdx */, m2::PointD(2.0, -1.0), *graph);
+    auto const finish = MakeFakeEnding(6, 0, m2::PointD(3.0, 3.0), *graph);
+    auto starter = MakeStarter(start, finish, *graph);
+    TestRouteGeometry(*starter, Algorithm::Result::OK, expectedGeom, false /* bidirectional */);
+  };
+
+  // Profiles are ignored without departure time.
+  testRoute(nullopt, directGeom);
+  testRoute(0 /* departureTime */, detourGeom);
+}
+
+// Route through XX graph with a rush hour on F3 which is reached long after the departure.
+UNIT_CLASS_TEST(ApplyingTrafficTest, XXGraph_RushHourOnF3)
+{
+  // F9 and F1 take about 268 hours at 1 km/h, so F3 is entered at about the 100th hour of
+  // the week if the route departs on Monday at 00:00 UTC. The rush hour is from the 96th hour
+  // to the 108th hour.
+  SpeedProfile::Ratios ratios;
+  ratios.fill(SpeedProfile::kRatioDenominator);
+  fill(ratios.begin() + 96, ratios.begin() + 108, SpeedProfile::kRatioDenominator / 5);
+  SpeedProfile const profile(ratios.data());
+  time_t const mondayMidnight = 4 * 24 * 3600;
+  TEST_EQUAL(SpeedProfile::GetSecondOfWeek(mondayMidnight), 0, ());
+
+  vector<m2::PointD> const directGeom = {{2 /* x */, -1 /* y */}, {2, 0}, {1, 1}, {2, 2}, {3, 3}};
+  vector<m2::PointD> const detourGeom = {{2 /* x */, -1 /* y */}, {2, 0}, {3, 0},
+                                         {3, 1}, {2, 2}, {3, 3}};
+  auto const testRoute = [&](time_t departureTime, vector<m2::PointD> const & expectedGeom) {
+    GetEstimator()->SetDepartureTime(departureTime);
+    unique_ptr<WorldGraph> graph = BuildXXGraph(GetEstimator(), profile);
+    auto const start =
+        MakeFakeEnding(9 /* featureId */, 0 /* segmentIdx */, m2::PointD(2.0, -1.0), *graph);
+    auto const finish = MakeFakeEnding(6, 0, m2::PointD(3.0, 3.0), *graph);
+    auto starter = MakeStarter(start, finish, *graph);
+    TestRouteGeometry(*starter, Algorithm::Result::OK, expectedGeom, false /* bidirectional */);
+  };
+
+  // F3 is free at the departure, but it's reached in the rush hour.
+  testRoute(mondayMidnight, detourGeom);
+  // F3 is reached after the rush hour.
+  testRoute(mondayMidnight + 12 * 3600, directGeom);
+}
 }  // namespace
@@ -6,8 +6,10 @@
 
 #include "routing/routing_tests/routing_algorithm.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <map>
+#include <random>
 #include <utility>
 #include <vector>
 
@@ -34,6 +36,34 @@ void TestAStar(UndirectedGraph & graph, vector<unsigned> const & expectedRoute,
   TEST_EQUAL(Algorithm::Result::OK, algo.FindPathBidirectional(params, actualRoute), ());
   TEST_EQUAL(expectedRoute, actualRoute.m_path, ());
   TEST_ALMOST_EQUAL_ULPS(expectedDistance, actualRoute.m_distance, ());
+
+  UndirectedGraph backwardGraph = graph;
+  params.m_backwardGraph = &backwardGraph;
+  actualRoute.m_path.clear();
+  TEST_EQUAL(Algorithm::Result::OK, algo.FindPathBidirectional(params, actualRoute), ());
+  TEST_EQUAL(expectedRoute, actualRoute.m_path, ());
+  TEST_ALMOST_EQUAL_ULPS(expectedDistance, actualRoute.m_distance, ());
+}
+
+// Grid |size| x |size| with random weights.
+UndirectedGraph MakeRandomGrid(uint32_t size, uint32_t seed)
+{
+  mt19937 rnd(seed);
+  uniform_real_distribution<double> weightDist(1.0, 10.0);
+
+  UndirectedGraph graph;
+  for (uint32_t row = 0; row < size; ++row)
+  {
+    for (uint32_t col = 0; col < size; ++col)
+    {
+      uint32_t const v = row * size + col;
+      if (col + 1 < size)
+        graph.AddEdge(v, v + 1, weightDist(rnd));
+      if (row + 1 < size)
+        graph.AddEdge(v, v + size, weightDist(rnd));
+    }
+  }
+  return graph;
 }
 
 UNIT_TEST(AStarAlgorithm_Sample)
@@ -78,6 +108,419 @@ UNIT_TEST(AStarAlgorithm_CheckLength)
   result = algo.FindPathBidirectional(params, routingResult);
   // Best route weight is 23 so we expect to find no route with restriction |weight < 23|.
   TEST_EQUAL(result, Algorithm::Result::NoPath, ());
+
+  UndirectedGraph backwardGraph = graph;
+  params.m_backwardGraph = &backwardGraph;
+  routingResult = {};
+  result = algo.FindPathBidirectional(params, routingResult);
+  TEST_EQUAL(result, Algorithm::Result::NoPath, ());
+}
+
+UNIT_TEST(AStarAlgorithm_ParallelBidirectional)
+{
+  uint32_t constexpr kSize = 40;
+  Algorithm algo;
+  for (uint32_t seed = 0; seed < 5; ++seed)
+  {
+    UndirectedGraph graph = MakeRandomGrid(kSize, seed);
+    UndirectedGraph backwardGraph = graph;
+
+    mt19937 rnd(seed);
+    uniform_int_distribution<uint32_t> vertexDist(0, kSize * kSize - 1);
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+      uint32_t const start = vertexDist(rnd);
+      uint32_t const finish = vertexDist(rnd);
+
+      Algorithm::ParamsForTests<> params(graph, start, finish);
+      RoutingResult<uint32_t, double> expected;
+      TEST_EQUAL(algo.FindPath(params, expected), Algorithm::Result::OK, ());
+
+      params.m_backwardGraph = &backwardGraph;
+      RoutingResult<uint32_t, double> actual;
+      TEST_EQUAL(algo.FindPathBidirectional(params, actual), Algorithm::Result::OK, ());
+      TEST_ALMOST_EQUAL_ABS(actual.m_distance, expected.m_distance, 1e-6, (seed, start, finish));
+      TEST_EQUAL(actual.m_path.front(), start, ());
+      TEST_EQUAL(actual.m_path.back(), finish, ());
+
+      // The path is a chain of edges with the found weight.
+      double weight = 0.0;
+      for (size_t j = 1; j < actual.m_path.size(); ++j)
+      {
+        UndirectedGraph::EdgeListT edges;
+        graph.GetEdgesList(actual.m_path[j - 1], true /* isOutgoing */, edges);
+        auto const it = find_if(edges.begin(), edges.end(), [&](SimpleEdge const & edge) {
+          return edge.GetTarget() == actual.m_path[j];
+        });
+        TEST(it != edges.end(), (actual.m_path[j - 1], actual.m_path[j]));
+        weight += it->GetWeight();
+      }
+      TEST_ALMOST_EQUAL_ABS(weight, actual.m_distance, 1e-6, ());
+    }
+  }
+}
+
+UNIT_TEST(AStarAlgorithm_ParallelBidirectionalNoPath)
+{
+  UndirectedGraph graph;
+  graph.AddEdge(0, 1, 1);
+  graph.AddEdge(1, 2, 1);
+  graph.AddEdge(3, 4, 1);
+  UndirectedGraph backwardGraph = graph;
+
+  Algorithm algo;
+  Algorithm::ParamsForTests<> params(graph, 0u /* startVertex */, 4u /* finishVertex */);
+  params.m_backwardGraph = &backwardGraph;
+
+  RoutingResult<uint32_t, double> result;
+  TEST_EQUAL(algo.FindPathBidirectional(params, result), Algorithm::Result::NoPath, ());
+}
+
+UNIT_TEST(AStarAlgorithm_ParallelBidirectionalNoPathExhaustedWave)
+{
+  uint32_t constexpr kSize = 300;
+  uint32_t constexpr kVerticesNumber = kSize * kSize;
+  UndirectedGraph graph = MakeRandomGrid(kSize, 0 /* seed */);
+  // The finish is in a small separate component, so the backward wave is exhausted at once.
+  graph.AddEdge(kVerticesNumber, kVerticesNumber + 1, 1);
+  UndirectedGraph backwardGraph = graph;
+
+  size_t visitedNumber = 0;
+  base::Cancellable const cancellable;
+  Algorithm algo;
+  Algorithm::Params params(graph, kSize / 2 * kSize + kSize / 2 /* startVertex */,
+                           kVerticesNumber + 1 /* finishVertex */, cancellable,
+                           [&visitedNumber](auto const &, uint32_t const &) { ++visitedNumber; });
+  params.m_backwardGraph = &backwardGraph;
+
+  RoutingResult<uint32_t, double> result;
+  TEST_EQUAL(algo.FindPathBidirectional(params, result), Algorithm::Result::NoPath, ());
+  // The forward wave is stopped when the backward one is exhausted instead of sweeping the grid.
+  TEST_LESS(visitedNumber, kVerticesNumber / 2, ());
+}
+
+UNIT_TEST(AStarAlgorithm_ParallelBidirectionalEmitter)
+{
+  uint32_t constexpr kSize = 200;
+  UndirectedGraph graph = MakeRandomGrid(kSize, 7 /* seed */);
+  UndirectedGraph backwardGraph = graph;
+
+  // The vertices are far from the borders of the grid, so the waves aren't exhausted. Otherwise
+  // the search is stopped with NoPath after the emitter rejects the paths found by that time.
+  Algorithm algo;
+  Algorithm::ParamsForTests<> params(graph, 90 * kSize + 90 /* startVertex */,
+                                     110 * kSize + 110 /* finishVertex */);
+  RoutingResult<uint32_t, double> expected;
+  TEST_EQUAL(algo.FindPath(params, expected), Algorithm::Result::OK, ());
+
+  // The waves are resumed until the emitter accepts a path.
+  params.m_backwardGraph = &backwardGraph;
+  vector<double> distances;
+  auto const result = algo.FindPathBidirectionalEx(params, [&](RoutingResult<uint32_t, double> && route) {
+    distances.push_back(route.m_distance);
+    return distances.size() == 3;
+  });
+  TEST_EQUAL(result, Algorithm::Result::OK, ());
+  TEST_EQUAL(distances.size(), 3, ());
+  TEST_ALMOST_EQUAL_ABS(distances.front(), expected.m_distance, 1e-6, ());
+  for (auto const distance : distances)
+    TEST_GREATER_OR_EQUAL(distance + 1e-6, expected.m_distance, ());
+}
+
+UNIT_TEST(AStarAlgorithm_Alternatives)
+{
+  UndirectedGraph graph;
+
+  // The best route.
+  graph.AddEdge(0, 1, 2);
+  graph.AddEdge(1, 2, 2);
+  graph.AddEdge(2, 3, 2);
+  graph.AddEdge(3, 4, 2);
+  // Alternative without shared edges.
+  graph.AddEdge(0, 5, 2);
+  graph.AddEdge(5, 6, 2);
+  graph.AddEdge(6, 7, 2);
+  graph.AddEdge(7, 4, 3);
+  // Local detour of the best route.
+  graph.AddEdge(1, 8, 1.5);
+  graph.AddEdge(8, 2, 1.5);
+  // Too long route.
+  graph.AddEdge(0, 9, 10);
+  graph.AddEdge(9, 4, 10);
+
+  Algorithm algo;
+  Algorithm::ParamsForTests<> params(graph, 0u /* startVertex */, 4u /* finishVertex */);
+  Algorithm::AlternativesParams altParams;
+
+  vector<RoutingResult<uint32_t, double>> routes;
+  TEST_EQUAL(algo.FindPathBidirectionalAlternatives(params, altParams, routes), Algorithm::Result::OK, ());
+  TEST_EQUAL(routes.size(), 2, ());
+  TEST_EQUAL(routes[0].m_path, vector<uint32_t>({0, 1, 2, 3, 4}), ());
+  TEST_ALMOST_EQUAL_ABS(routes[0].m_distance, 8.0, 1e-6, ());
+  TEST_EQUAL(routes[1].m_path, vector<uint32_t>({0, 5, 6, 7, 4}), ());
+  TEST_ALMOST_EQUAL_ABS(routes[1].m_distance, 9.0, 1e-6, ());
+
+  altParams.m_maxAlternatives = 0;
+  TEST_EQUAL(algo.FindPathBidirectionalAlternatives(params, altParams, routes), Algorithm::Result::OK, ());
+  TEST_EQUAL(routes.size(), 1, ());
+  TEST_EQUAL(routes[0].m_path, vector<uint32_t>({0, 1, 2, 3, 4}), ());
+}
+
+UNIT_TEST(AStarAlgorithm_AlternativesOnGrid)
+{
+  uint32_t constexpr kSize = 40;
+  UndirectedGraph graph = MakeRandomGrid(kSize, 7 /* seed */);
+
+  Algorithm algo;
+  Algorithm::ParamsForTests<> params(graph, 10 * kSize + 10 /* startVertex */,
+                                     30 * kSize + 30 /* finishVertex */);
+  RoutingResult<uint32_t, double> expected;
+  TEST_EQUAL(algo.FindPath(params, expected), Algorithm::Result::OK, ());
+
+  Algorithm::AlternativesParams const altParams;
+  vector<RoutingResult<uint32_t, double>> routes;
+  TEST_EQUAL(algo.FindPathBidirectionalAlternatives(params, altParams, routes), Algorithm::Result::OK, ());
+  TEST_GREATER_OR_EQUAL(routes.size(), 1, ());
+  TEST_LESS_OR_EQUAL(routes.size(), altParams.m_maxAlternatives + 1, ());
+  TEST_ALMOST_EQUAL_ABS(routes.front().m_distance, expected.m_distance, 1e-6, ());
+  for (auto const & route : routes)
+  {
+    TEST_EQUAL(route.m_path.front(), 10 * kSize + 10, ());
+    TEST_EQUAL(route.m_path.back(), 30 * kSize + 30, ());
+    TEST_LESS_OR_EQUAL(route.m_distance, (1.0 + altParams.m_maxStretch) * expected.m_distance + 1e-6, ());
+
+    // Length of the path is equal to the sum of its edges.
+    double length = 0.0;
+    for (size_t i = 1; i < route.m_path.size(); ++i)
+    {
+      UndirectedGraph::EdgeListT adj;
+      graph.GetEdgesList(route.m_path[i - 1], true /* isOutgoing */, adj);
+      double weight = -1.0;
+      for (auto const & e : adj)
+      {
+        if (e.GetTarget() == route.m_path[i])
+          weight = e.GetWeight();
+      }
+      TEST_GREATER_OR_EQUAL(weight, 0.0, ());
+      length += weight;
+    }
+    TEST_ALMOST_EQUAL_ABS(length, route.m_distance, 1e-6, ());
+  }
+}
+
+// Targets in the middle of edges of a grid. Every target is at |m_part| of edge |m_from|, |m_to|.
+struct EdgeTarget
+{
+  uint32_t m_from;
+  uint32_t m_to;
+  double m_weight;
+  double m_part;
+};
+
+template <typename Params>
+Algorithm::Result FindPathsToEdgeTargets(Params & params, vector<EdgeTarget> const & targets,
+                                         vector<RoutingResult<uint32_t, double>> & results)
+{
+  auto const reachTargets = [&targets](uint32_t vertex, SimpleEdge const & edge, auto && emit) {
+    for (size_t i = 0; i < targets.size(); ++i)
+    {
+      auto const & target = targets[i];
+      if (vertex == target.m_from && edge.GetTarget() == target.m_to)
+        emit(i, target.m_part * target.m_weight);
+      else if (vertex == target.m_to && edge.GetTarget() == target.m_from)
+        emit(i, (1.0 - target.m_part) * target.m_weight);
+    }
+  };
+
+  Algorithm algo;
+  return algo.FindPathsToTargets(params, targets.size(), reachTargets, results);
+}
+
+UNIT_TEST(AStarAlgorithm_FindPathsToTargets)
+{
+  uint32_t constexpr kSize = 20;
+  auto graph = MakeRandomGrid(kSize, 3 /* seed */);
+
+  mt19937 rnd(11 /* seed */);
+  uniform_int_distribution<uint32_t> vertexDist(0, kSize * kSize - 1);
+  uniform_real_distribution<double> partDist(0.0, 1.0);
+
+  vector<EdgeTarget> targets;
+  for (size_t i = 0; i < 30; ++i)
+  {
+    uint32_t const from = vertexDist(rnd);
+    Algorithm::Graph::EdgeListT edges;
+    graph.GetEdgesList(from, true /* isOutgoing */, edges);
+    auto const & edge = edges[uniform_int_distribution<size_t>(0, edges.size() - 1)(rnd)];
+    targets.push_back({from, edge.GetTarget(), edge.GetWeight(), partDist(rnd)});
+  }
+
+  uint32_t const start = vertexDist(rnd);
+  Algorithm::ParamsForTests<> params(graph, start, {} /* finalVertex */);
+  vector<RoutingResult<uint32_t, double>> results;
+  TEST_EQUAL(FindPathsToEdgeTargets(params, targets, results), Algorithm::Result::OK, ());
+  TEST_EQUAL(results.size(), targets.size(), ());
+
+  Algorithm algo;
+  auto const getDistance = [&](uint32_t finish) {
+    Algorithm::ParamsForTests<> pathParams(graph, start, finish);
+    RoutingResult<uint32_t, double> result;
+    TEST_EQUAL(algo.FindPath(pathParams, result), Algorithm::Result::OK, ());
+    return result.m_distance;
+  };
+
+  for (size_t i = 0; i < targets.size(); ++i)
+  {
+    auto const & target = targets[i];
+    double const expected =
+        min(getDistance(target.m_from) + target.m_part * target.m_weight,
+            getDistance(target.m_to) + (1.0 - target.m_part) * target.m_weight);
+    TEST_ALMOST_EQUAL_ABS(results[i].m_distance, expected, 1e-6, (i));
+
+    auto const & path = results[i].m_path;
+    TEST_GREATER_OR_EQUAL(path.size(), 2, (i));
+    TEST_EQUAL(path.front(), start, (i));
+    TEST((path[path.size() - 2] == target.m_from && path.back() == target.m_to) ||
+         (path[path.size() - 2] == target.m_to && path.back() == target.m_from), (i, path));
+  }
+}
+
+UNIT_TEST(AStarAlgorithm_FindPathsToTargetsOutOfLimit)
+{
+  UndirectedGraph graph;
+  for (uint32_t i = 0; i < 5; ++i)
+    graph.AddEdge(i /* from */, i + 1 /* to */, 1 /* weight */);
+
+  vector<EdgeTarget> const targets = {{0, 1, 1.0, 0.5}, {3, 4, 1.0, 0.5}, {4, 3, 1.0, 0.25}};
+
+  auto checkLength = [](double weight) { return weight <= 2.0; };
+  Algorithm::ParamsForTests<decltype(checkLength)> params(
+      graph, 0 /* startVertex */, {} /* finalVertex */, move(checkLength));
+  vector<RoutingResult<uint32_t, double>> results;
+  TEST_EQUAL(FindPathsToEdgeTargets(params, targets, results), Algorithm::Result::OK, ());
+
+  TEST_EQUAL(results[0].m_path, vector<uint32_t>({0, 1}), ());
+  TEST_ALMOST_EQUAL_ABS(results[0].m_distance, 0.5, 1e-6, ());
+  TEST(results[1].m_path.empty(), ());
+  TEST(results[2].m_path.empty(), ());
+
+  Algorithm::ParamsForTests<decltype(checkLength)> farParams(
+      graph, 5 /* startVertex */, {} /* finalVertex */, move(checkLength));
+  vector<EdgeTarget> const farTargets = {{0, 1, 1.0, 0.5}};
+  TEST_EQUAL(FindPathsToEdgeTargets(farParams, farTargets, results), Algorithm::Result::NoPath, ());
+  TEST(results[0].m_path.empty(), ());
+}
+
+UNIT_TEST(AStarAlgorithm_FindPathsToTargetsUnreachable)
+{
+  uint32_t constexpr kSize = 100;
+  uint32_t constexpr kVerticesNumber = kSize * kSize;
+  auto graph = MakeRandomGrid(kSize, 5 /* seed */);
+  // The second target is in a separate component.
+  graph.AddEdge(kVerticesNumber, kVerticesNumber + 1, 1.0);
+
+  uint32_t const start = kSize / 2 * kSize + kSize / 2;
+  vector<EdgeTarget> const targets = {{start, start + 1, 1.0, 0.5},
+                                      {kVerticesNumber, kVerticesNumber + 1, 1.0, 0.5}};
+
+  // Without the limit the wave covers the whole grid looking for the second target.
+  {
+    size_t visitedNumber = 0;
+    base::Cancellable const cancellable;
+    Algorithm::Params params(graph, start, {} /* finalVertex */, cancellable,
+                             [&visitedNumber](auto const &, uint32_t const &) { ++visitedNumber; });
+    vector<RoutingResult<uint32_t, double>> results;
+    TEST_EQUAL(FindPathsToEdgeTargets(params, targets, results), Algorithm::Result::OK, ());
+    TEST(!results[0].m_path.empty(), ());
+    TEST(results[1].m_path.empty(), ());
+    TEST_EQUAL(visitedNumber, kVerticesNumber, ());
+  }
+
+  // The limit of the weight of the way stops the wave near the start.
+  {
+    size_t visitedNumber = 0;
+    auto visitor = [&visitedNumber](auto const &, uint32_t const &) { ++visitedNumber; };
+    auto checkLength = [](double weight) { return weight <= 50.0; };
+    base::Cancellable const cancellable;
+    Algorithm::Params<decltype(visitor), decltype(checkLength)> params(
+        graph, start, {} /* finalVertex */, cancellable, move(visitor), move(checkLength));
+    vector<RoutingResult<uint32_t, double>> results;
+    TEST_EQUAL(FindPathsToEdgeTargets(params, targets, results), Algorithm::Result::OK, ());
+    TEST(!results[0].m_path.empty(), ());
+    TEST(results[1].m_path.empty(), ());
+    TEST_LESS(visitedNumber, kVerticesNumber / 10, ());
+  }
+}
+
+UNIT_TEST(AStarAlgorithm_VertexMap)
+{
+  astar::VertexMap<uint32_t, double> distances;
+  TEST(!distances.Find(0), ());
+
+  uint32_t constexpr kSize = 5000;
+  for (uint32_t v = 0; v < kSize; ++v)
+    distances.InsertOrAssign(v, v * 2.0);
+  distances.InsertOrAssign(7, 1.0);
+
+  TEST_EQUAL(distances.Size(), kSize, ());
+  TEST_GREATER_OR_EQUAL(distances.GetCapacity(), 2 * kSize, ());
+  for (uint32_t v = 0; v < kSize; ++v)
+    TEST_EQUAL(*distances.Find(v), v == 7 ? 1.0 : v * 2.0, (v));
+  TEST(!distances.Find(kSize), ());
+
+  // The storage is kept, but the values are gone.
+  size_t const capacity = distances.GetCapacity();
+  distances.Clear();
+  TEST(distances.Empty(), ());
+  TEST_EQUAL(distances.GetCapacity(), capacity, ());
+  for (uint32_t v = 0; v < kSize; ++v)
+    TEST(!distances.Contains(v), (v));
+
+  distances.InsertOrAssign(3, 5.0);
+  TEST_EQUAL(*distances.Find(3), 5.0, ());
+  TEST_EQUAL(distances.Size(), 1, ());
+}
+
+UNIT_TEST(AStarAlgorithm_SearchStateReuse)
+{
+  uint32_t constexpr kSize = 30;
+  UndirectedGraph graph = MakeRandomGrid(kSize, 1 /* seed */);
+  Algorithm algo;
+
+  auto const findPaths = [&]() {
+    vector<double> distances;
+    for (uint32_t finish = 1; finish < kSize * kSize; finish += 97)
+    {
+      Algorithm::ParamsForTests<> params(graph, 0u /* startVertex */, finish);
+      RoutingResult<uint32_t, double> result;
+      TEST_EQUAL(algo.FindPath(params, result), Algorithm::Result::OK, ());
+      distances.push_back(result.m_distance);
+
+      RoutingResult<uint32_t, double> bidirectionalResult;
+      TEST_EQUAL(algo.FindPathBidirectional(params, bidirectionalResult), Algorithm::Result::OK,
+                 ());
+      TEST_ALMOST_EQUAL_ABS(bidirectionalResult.m_distance, result.m_distance, 1e-6, (finish));
+    }
+    return distances;
+  };
+
+  // The first searches fill the pool of the thread.
+  auto const expected = findPaths();
+
+  astar::ResetSearchStateCounters();
+  TEST_EQUAL(findPaths(), expected, ());
+
+  // States and their storage are reused by the next searches.
+  auto const counters = astar::GetSearchStateCounters();
+  TEST_EQUAL(counters.m_statesCreated, 0, (counters));
+  TEST_EQUAL(counters.m_allocations, 0, (counters));
+  TEST_GREATER(counters.m_statesReused, 0, (counters));
+
+  // Cleared pools don't keep states.
+  astar::ClearSearchStatePools();
+  astar::ResetSearchStateCounters();
+  TEST_EQUAL(findPaths(), expected, ());
+  TEST_GREATER(astar::GetSearchStateCounters().m_statesCreated, 0, ());
 }
 
 UNIT_TEST(AdjustRoute)
@@ -108,6 +551,34 @@ UNIT_TEST(AdjustRoute)
   TEST_EQUAL(result.m_distance, 4.0, ());
 }
 
+UNIT_TEST(AdjustRouteRejoinsFartherVertex)
+{
+  UndirectedGraph graph;
+
+  for (unsigned int i = 0; i < 5; ++i)
+    graph.AddEdge(i /* from */, i + 1 /* to */, 1 /* weight */);
+
+  graph.AddEdge(6, 0, 1);
+  graph.AddEdge(6, 3, 2);
+
+  // The route is rejoined at 3 although 0 is closer to the start because the route from 0 is
+  // longer.
+  vector<SimpleEdge> const prevRoute = {{0, 0}, {1, 1}, {2, 10}, {3, 1}, {4, 1}, {5, 1}};
+
+  auto checkLength = [](double weight) { return weight <= 3.0; };
+  Algorithm algo;
+  Algorithm::ParamsForTests<decltype(checkLength)> params(
+      graph, 6 /* startVertex */, {} /* finishVertex */, move(checkLength));
+
+  RoutingResult<unsigned /* Vertex */, double /* Weight */> result;
+  auto const code = algo.AdjustRoute(params, prevRoute, result);
+
+  vector<unsigned> const expectedRoute = {6, 3, 4, 5};
+  TEST_EQUAL(code, Algorithm::Result::OK, ());
+  TEST_EQUAL(result.m_path, expectedRoute, ());
+  TEST_EQUAL(result.m_distance, 4.0, ());
+}
+
 UNIT_TEST(AdjustRouteNoPath)
 {
   UndirectedGraph graph;
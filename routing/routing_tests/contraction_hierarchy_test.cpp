@@ -0,0 +1,197 @@
+#include "testing/testing.hpp"
+
+#include "routing/base/contraction_hierarchy.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "base/cancellable.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace contraction_hierarchy_test
+{
+using namespace routing;
+using namespace std;
+
+using Vertex = ContractionHierarchy::Vertex;
+using Graph = map<pair<Vertex, Vertex>, double>;
+
+double constexpr kEps = 1e-4;
+
+vector<double> Dijkstra(Graph const & graph, uint32_t numVertices, Vertex source)
+{
+  vector<double> weights(numVertices, numeric_limits<double>::max());
+  priority_queue<pair<double, Vertex>, vector<pair<double, Vertex>>, greater<>> queue;
+  weights[source] = 0.0;
+  queue.emplace(0.0, source);
+  while (!queue.empty())
+  {
+    auto const [weight, v] = queue.top();
+    queue.pop();
+    if (weight > weights[v])
+      continue;
+
+    for (auto it = graph.lower_bound({v, 0}); it != graph.end() && it->first.first == v; ++it)
+    {
+      Vertex const to = it->first.second;
+      if (weight + it->second < weights[to])
+      {
+        weights[to] = weight + it->second;
+        queue.emplace(weights[to], to);
+      }
+    }
+  }
+  return weights;
+}
+
+ContractionHierarchy BuildHierarchy(Graph const & graph, uint32_t numVertices)
+{
+  ContractionHierarchyBuilder builder(numVertices);
+  for (auto const & [edge, weight] : graph)
+    builder.AddEdge(edge.first, edge.second, weight);
+
+  ContractionHierarchy ch;
+  builder.Build(ch);
+  return ch;
+}
+
+// Checks that |path| consists of edges of |graph| and returns its weight.
+double GetPathWeight(Graph const & graph, vector<Vertex> const & path)
+{
+  double weight = 0.0;
+  for (size_t i = 1; i < path.size(); ++i)
+  {
+    auto const it = graph.find({path[i - 1], path[i]});
+    TEST(it != graph.end(), (path[i - 1], path[i]));
+    weight += it->second;
+  }
+  return weight;
+}
+
+Graph MakeRandomGraph(uint32_t numVertices, uint32_t numEdges, uint32_t seed)
+{
+  mt19937 rnd(seed);
+  uniform_int_distribution<Vertex> vertexDist(0, numVertices - 1);
+  uniform_int_distribution<uint32_t> weightDist(1, 100);
+
+  Graph graph;
+  // A ring guarantees connectivity.
+  for (Vertex v = 0; v < numVertices; ++v)
+    graph[{v, (v + 1) % numVertices}] = weightDist(rnd);
+
+  for (uint32_t i = 0; i < numEdges; ++i)
+  {
+    Vertex const from = vertexDist(rnd);
+    Vertex const to = vertexDist(rnd);
+    if (from != to)
+      graph[{from, to}] = weightDist(rnd);
+  }
+  return graph;
+}
+
+UNIT_TEST(ContractionHierarchy_Simple)
+{
+  // 0 -> 1 -> 2 -> 3 is cheaper than 0 -> 3 and 1 -> 3.
+  Graph const graph = {{{0, 1}, 1.0}, {{1, 2}, 1.0}, {{2, 3}, 1.0},
+                       {{0, 3}, 5.0}, {{1, 3}, 3.0}, {{3, 4}, 2.0}};
+  auto const ch = BuildHierarchy(graph, 5 /* numVertices */);
+
+  RoutingResult<Vertex, double> result;
+  TEST_EQUAL(ch.FindPath({{0, 0.0}}, {{4, 0.0}}, base::Cancellable(), result),
+             ContractionHierarchy::Result::OK, ());
+  TEST_EQUAL(result.m_path, vector<Vertex>({0, 1, 2, 3, 4}), ());
+  TEST_ALMOST_EQUAL_ABS(result.m_distance, 5.0, kEps, ());
+
+  // There is no way back.
+  TEST_EQUAL(ch.FindPath({{4, 0.0}}, {{0, 0.0}}, base::Cancellable(), result),
+             ContractionHierarchy::Result::NoPath, ());
+}
+
+UNIT_TEST(ContractionHierarchy_Endings)
+{
+  Graph const graph = {{{0, 2}, 10.0}, {{1, 2}, 1.0}, {{2, 3}, 1.0}, {{2, 4}, 1.0}};
+  auto const ch = BuildHierarchy(graph, 5 /* numVertices */);
+
+  RoutingResult<Vertex, double> result;
+  // Source 1 is cheaper even with its initial weight. Target weights may be negative.
+  TEST_EQUAL(ch.FindPath({{0, 0.0}, {1, 5.0}}, {{3, -0.5}, {4, 0.0}}, base::Cancellable(), result),
+             ContractionHierarchy::Result::OK, ());
+  TEST_EQUAL(result.m_path, vector<Vertex>({1, 2, 3}), ());
+  TEST_ALMOST_EQUAL_ABS(result.m_distance, 6.5, kEps, ());
+
+  // A vertex which is a source and a target at the same time.
+  TEST_EQUAL(ch.FindPath({{2, 1.0}}, {{2, 1.5}, {3, 0.0}}, base::Cancellable(), result),
+             ContractionHierarchy::Result::OK, ());
+  TEST_EQUAL(result.m_path, vector<Vertex>({2, 3}), ());
+  TEST_ALMOST_EQUAL_ABS(result.m_distance, 2.0, kEps, ());
+}
+
+UNIT_TEST(ContractionHierarchy_RandomGraphs)
+{
+  uint32_t constexpr kNumVertices = 60;
+  for (uint32_t seed = 0; seed < 5; ++seed)
+  {
+    Graph const graph = MakeRandomGraph(kNumVertices, 4 * kNumVertices /* numEdges */, seed);
+    auto const ch = BuildHierarchy(graph, kNumVertices);
+
+    for (Vertex source = 0; source < kNumVertices; ++source)
+    {
+      auto const expected = Dijkstra(graph, kNumVertices, source);
+      for (Vertex target = 0; target < kNumVertices; ++target)
+      {
+        RoutingResult<Vertex, double> result;
+        TEST_EQUAL(ch.FindPath({{source, 0.0}}, {{target, 0.0}}, base::Cancellable(), result),
+                   ContractionHierarchy::Result::OK, (seed, source, target));
+        TEST_ALMOST_EQUAL_ABS(result.m_distance, expected[target], kEps, (seed, source, target));
+        TEST_EQUAL(result.m_path.front(), source, ());
+        TEST_EQUAL(result.m_path.back(), target, ());
+        TEST_ALMOST_EQUAL_ABS(GetPathWeight(graph, result.m_path), expected[target], kEps, ());
+      }
+    }
+  }
+}
+
+UNIT_TEST(ContractionHierarchy_Serialization)
+{
+  uint32_t constexpr kNumVertices = 30;
+  Graph const graph = MakeRandomGraph(kNumVertices, 3 * kNumVertices /* numEdges */, 42 /* seed */);
+  auto const ch = BuildHierarchy(graph, kNumVertices);
+
+  vector<uint8_t> buffer;
+  {
+    MemWriter<decltype(buffer)> writer(buffer);
+    ch.Serialize(writer);
+  }
+
+  ContractionHierarchy deserialized;
+  {
+    MemReader reader(buffer.data(), buffer.size());
+    ReaderSource<MemReader> src(reader);
+    deserialized.Deserialize(src);
+    TEST_EQUAL(src.Size(), 0, ());
+  }
+
+  TEST_EQUAL(deserialized.GetNumVertices(), kNumVertices, ());
+  TEST_EQUAL(deserialized.GetNumEdges(), ch.GetNumEdges(), ());
+
+  for (Vertex target = 0; target < kNumVertices; ++target)
+  {
+    RoutingResult<Vertex, double> expected;
+    RoutingResult<Vertex, double> actual;
+    TEST_EQUAL(ch.FindPath({{0, 0.0}}, {{target, 0.0}}, base::Cancellable(), expected),
+               ContractionHierarchy::Result::OK, ());
+    TEST_EQUAL(deserialized.FindPath({{0, 0.0}}, {{target, 0.0}}, base::Cancellable(), actual),
+               ContractionHierarchy::Result::OK, ());
+    TEST_EQUAL(expected.m_path, actual.m_path, ());
+    TEST_ALMOST_EQUAL_ABS(expected.m_distance, actual.m_distance, kEps, ());
+  }
+}
+}  // namespace contraction_hierarchy_test
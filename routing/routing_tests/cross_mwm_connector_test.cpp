@@ -280,6 +280,73 @@ void TestWeightsSerialization()
     TestOutgoingEdges(test.connector, enter, expectedEdges);
   }
 }
+
+// Weights are split into blocks, so the matrix is larger than a block and has more blocks than
+// the cache of decoded blocks keeps.
+void TestBlockedWeights(uint32_t numTransitions)
+{
+  uint32_t constexpr segmentIdx = 0;
+  auto const getWeight = [](uint32_t enterIdx, uint32_t exitIdx) {
+    if ((enterIdx + 2 * exitIdx) % 7 == 0)
+      return connector::kNoRoute;
+    // Multiples of the granularity are stored exactly.
+    return static_cast<double>(((enterIdx * 31 + exitIdx * 17) % 1000 + 1) * 4);
+  };
+
+  vector<uint8_t> buffer;
+  {
+    CrossMwmConnectorBuilderEx<base::GeoObjectId> builder;
+    for (uint32_t featureId = 0; featureId < numTransitions; ++featureId)
+    {
+      builder.AddTransition(base::MakeOsmWay(featureId + 1), featureId, segmentIdx, kCarMask,
+                            0 /* oneWayMask */, true /* forwardIsEnter */);
+    }
+
+    auto const & connector = builder.PrepareConnector(VehicleType::Car);
+    map<Segment, uint32_t> enters;
+    map<Segment, uint32_t> exits;
+    connector.ForEachEnter([&](uint32_t enterIdx, Segment const & s) { enters[s] = enterIdx; });
+    connector.ForEachExit([&](uint32_t exitIdx, Segment const & s) { exits[s] = exitIdx; });
+
+    builder.FillWeights([&](Segment const & enter, Segment const & exit) {
+      return getWeight(enters.at(enter), exits.at(exit));
+    });
+
+    MemWriter<vector<uint8_t>> writer(buffer);
+    builder.Serialize(writer);
+  }
+
+  MemReader reader(buffer.data(), buffer.size());
+  CrossMwmBuilderTestFixture<base::GeoObjectId> test(kGeneratorMwmId);
+  test.builder.DeserializeTransitions(VehicleType::Car, reader);
+  test.builder.DeserializeWeights(reader);
+  TEST(test.connector.HasWeights(), ());
+  TEST_EQUAL(test.connector.GetNumEnters(), numTransitions, ());
+  TEST_EQUAL(test.connector.GetNumExits(), numTransitions, ());
+
+  auto const expectedWeight = [&](uint32_t enterIdx, uint32_t exitIdx) {
+    return static_cast<Weight>(getWeight(enterIdx, exitIdx));
+  };
+
+  // By rows as the forward wave and by columns as the backward one.
+  for (uint32_t enterIdx = 0; enterIdx < numTransitions; ++enterIdx)
+  {
+    for (uint32_t exitIdx = 0; exitIdx < numTransitions; ++exitIdx)
+    {
+      TEST_EQUAL(test.connector.GetWeight(enterIdx, exitIdx), expectedWeight(enterIdx, exitIdx),
+                 (enterIdx, exitIdx));
+    }
+  }
+
+  for (uint32_t exitIdx = 0; exitIdx < numTransitions; ++exitIdx)
+  {
+    for (uint32_t enterIdx = 0; enterIdx < numTransitions; ++enterIdx)
+    {
+      TEST_EQUAL(test.connector.GetWeight(enterIdx, exitIdx), expectedWeight(enterIdx, exitIdx),
+                 (enterIdx, exitIdx));
+    }
+  }
+}
 }  // namespace
 
 UNIT_TEST(CMWMC_OneWayEnter)
@@ -333,4 +400,11 @@ UNIT_TEST(CMWMC_WeightsSerialization)
   TestWeightsSerialization<base::GeoObjectId>();
   TestWeightsSerialization<TransitId>();
 }
+
+UNIT_TEST(CMWMC_BlockedWeights)
+{
+  TestBlockedWeights(2 /* numTransitions */);
+  TestBlockedWeights(37 /* numTransitions */);
+  TestBlockedWeights(600 /* numTransitions */);
+}
 } // namespace cross_mwm_connector_test
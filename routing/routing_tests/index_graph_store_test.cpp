@@ -0,0 +1,126 @@
+#include "testing/testing.hpp"
+
+#include "routing/index_graph.hpp"
+#include "routing/index_graph_store.hpp"
+#include "routing/vehicle_mask.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace index_graph_store_test
+{
+using namespace routing;
+using namespace std;
+
+IndexGraphStore::Key MakeKey(string const & mwmPath, VehicleType vehicleType = VehicleType::Car)
+{
+  IndexGraphStore::Key key;
+  key.m_mwmPath = mwmPath;
+  key.m_mwmVersion = 220101;
+  key.m_vehicleType = vehicleType;
+  return key;
+}
+
+// Data with |restrictionsNumber| restrictions to make its size noticeable.
+IndexGraphStore::DataPtr MakeData(uint32_t restrictionsNumber)
+{
+  auto data = make_shared<IndexGraphData>();
+  for (uint32_t featureId = 0; featureId < restrictionsNumber; ++featureId)
+    data->m_restrictionsForward[featureId].push_back({featureId + 1, featureId + 2});
+  return data;
+}
+
+UNIT_TEST(IndexGraphStore_Sharing)
+{
+  IndexGraphStore store;
+  uint32_t loadsNumber = 0;
+  auto const loader = [&loadsNumber]() {
+    ++loadsNumber;
+    return MakeData(10 /* restrictionsNumber */);
+  };
+
+  auto const carData = store.Get(MakeKey("Abkhazia.mwm"), loader);
+  TEST_EQUAL(store.Get(MakeKey("Abkhazia.mwm"), loader), carData, ());
+  TEST_EQUAL(loadsNumber, 1, ());
+
+  auto const bicycleData = store.Get(MakeKey("Abkhazia.mwm", VehicleType::Bicycle), loader);
+  TEST_NOT_EQUAL(bicycleData, carData, ());
+  TEST_EQUAL(loadsNumber, 2, ());
+
+  TEST_EQUAL(store.GetSize(), 2, ());
+  TEST_EQUAL(store.GetMemorySize(), carData->GetMemorySize() + bicycleData->GetMemorySize(), ());
+
+  store.Clear();
+  TEST_EQUAL(store.GetSize(), 0, ());
+  TEST_EQUAL(store.GetMemorySize(), 0, ());
+  // Handles stay valid after the data is removed from the store.
+  TEST_EQUAL(carData->m_restrictionsForward.size(), 10, ());
+}
+
+UNIT_TEST(IndexGraphStore_MemoryBudget)
+{
+  size_t const dataSize = MakeData(100 /* restrictionsNumber */)->GetMemorySize();
+  TEST_GREATER(dataSize, 0, ());
+
+  IndexGraphStore store(2 * dataSize /* memoryBudgetBytes */);
+  auto const loader = []() { return MakeData(100 /* restrictionsNumber */); };
+
+  auto usedData = store.Get(MakeKey("Andorra.mwm"), loader);
+  store.Get(MakeKey("Austria.mwm"), loader);
+  TEST_EQUAL(store.GetSize(), 2, ());
+
+  // Andorra is the least recently used one, but it's in use, so Austria is evicted.
+  store.Get(MakeKey("Belarus.mwm"), loader);
+  TEST_EQUAL(store.GetSize(), 2, ());
+  TEST_EQUAL(store.GetMemorySize(), 2 * dataSize, ());
+
+  uint32_t loadsNumber = 0;
+  auto const countingLoader = [&loadsNumber, &loader]() {
+    ++loadsNumber;
+    return loader();
+  };
+  TEST_EQUAL(store.Get(MakeKey("Andorra.mwm"), countingLoader), usedData, ());
+  store.Get(MakeKey("Belarus.mwm"), countingLoader);
+  TEST_EQUAL(loadsNumber, 0, ());
+  store.Get(MakeKey("Austria.mwm"), countingLoader);
+  TEST_EQUAL(loadsNumber, 1, ());
+
+  // All the entries are evicted except the used one.
+  store.SetMemoryBudget(0 /* memoryBudgetBytes */);
+  TEST_EQUAL(store.GetSize(), 1, ());
+  TEST_EQUAL(store.Get(MakeKey("Andorra.mwm"), countingLoader), usedData, ());
+  TEST_EQUAL(loadsNumber, 1, ());
+
+  usedData.reset();
+  store.SetMemoryBudget(0 /* memoryBudgetBytes */);
+  TEST_EQUAL(store.GetSize(), 0, ());
+}
+
+UNIT_TEST(IndexGraphStore_Threads)
+{
+  IndexGraphStore store;
+  vector<string> const mwms = {"Albania.mwm", "Belgium.mwm", "Cyprus.mwm"};
+
+  size_t constexpr kThreadsNumber = 8;
+  vector<vector<IndexGraphStore::DataPtr>> results(kThreadsNumber);
+  vector<thread> threads;
+  for (size_t i = 0; i < kThreadsNumber; ++i)
+  {
+    threads.emplace_back([&, i]() {
+      for (auto const & mwm : mwms)
+        results[i].push_back(store.Get(MakeKey(mwm), []() { return MakeData(10); }));
+    });
+  }
+
+  for (auto & thread : threads)
+    thread.join();
+
+  // The same data is returned to all the threads even if it was loaded concurrently.
+  TEST_EQUAL(store.GetSize(), mwms.size(), ());
+  for (size_t i = 1; i < kThreadsNumber; ++i)
+    TEST_EQUAL(results[i], results[0], (i));
+}
+}  // namespace index_graph_store_test
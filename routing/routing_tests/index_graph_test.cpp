@@ -20,6 +20,7 @@
 #include "geometry/point2d.hpp"
 #include "geometry/point_with_altitude.hpp"
 
+#include "coding/memory_region.hpp"
 #include "coding/reader.hpp"
 #include "coding/writer.hpp"
 
@@ -610,6 +611,73 @@ UNIT_TEST(SerializeSimpleGraph)
   }
 }
 
+UNIT_TEST(SerializeSimpleGraphInPlace)
+{
+  vector<uint8_t> buffer;
+  {
+    IndexGraph graph;
+    vector<Joint> joints = {
+        MakeJoint({{0, 1}, {1, 0}}), MakeJoint({{1, 1}, {2, 0}}), MakeJoint({{2, 1}, {3, 2}, {4, 0}}),
+    };
+    graph.Import(joints);
+    unordered_map<uint32_t, VehicleMask> masks;
+    masks[0] = kPedestrianMask;
+    masks[1] = kCarMask;
+    masks[2] = kAllVehiclesMask;
+    masks[3] = kCarMask | kBicycleMask;
+    masks[4] = kPedestrianMask | kBicycleMask;
+
+    MemWriter<vector<uint8_t>> writer(buffer);
+    IndexGraphSerializer::Serialize(graph, masks, writer);
+  }
+
+  MemReader reader(buffer.data(), buffer.size());
+  TEST(IndexGraphSerializer::HasInPlaceIndexes(reader), ());
+
+  // Indexes which are used in place are the same as decoded ones.
+  for (auto const vehicleType : {VehicleType::Pedestrian, VehicleType::Bicycle, VehicleType::Car})
+  {
+    IndexGraph expected;
+    ReaderSource<MemReader> source(reader);
+    IndexGraphSerializer::Deserialize(expected, source, GetVehicleMask(vehicleType));
+
+    IndexGraph graph;
+    TEST(IndexGraphSerializer::DeserializeInPlace(make_unique<CopiedMemoryRegion>(vector<uint8_t>(buffer)),
+                                                  vehicleType, graph),
+         (vehicleType));
+    TEST_EQUAL(graph.GetData()->GetMemorySize(), 0, (vehicleType));
+
+    TEST_EQUAL(graph.GetNumRoads(), expected.GetNumRoads(), (vehicleType));
+    TEST_EQUAL(graph.GetNumJoints(), expected.GetNumJoints(), (vehicleType));
+    TEST_EQUAL(graph.GetNumPoints(), expected.GetNumPoints(), (vehicleType));
+
+    for (uint32_t featureId = 0; featureId < 6; ++featureId)
+    {
+      TEST_EQUAL(graph.IsRoad(featureId), expected.IsRoad(featureId), (vehicleType, featureId));
+      for (uint32_t pointId = 0; pointId < 4; ++pointId)
+      {
+        RoadPoint const rp(featureId, pointId);
+        TEST_EQUAL(graph.GetJointId(rp), expected.GetJointId(rp), (vehicleType, rp));
+      }
+    }
+
+    for (Joint::Id jointId = 0; jointId < graph.GetNumJoints(); ++jointId)
+    {
+      vector<RoadPoint> points;
+      graph.ForEachPoint(jointId, [&](RoadPoint const & rp) { points.push_back(rp); });
+      vector<RoadPoint> expectedPoints;
+      expected.ForEachPoint(jointId, [&](RoadPoint const & rp) { expectedPoints.push_back(rp); });
+      TEST_EQUAL(points, expectedPoints, (vehicleType, jointId));
+    }
+  }
+
+  // Transit graph isn't kept in place.
+  IndexGraph graph;
+  TEST(!IndexGraphSerializer::DeserializeInPlace(make_unique<CopiedMemoryRegion>(vector<uint8_t>(buffer)),
+                                                 VehicleType::Transit, graph),
+       ());
+}
+
 //      Finish
 // 0.0004    *
 //           ^
@@ -470,7 +470,7 @@ unique_ptr<TransitWorldGraph> BuildWorldGraph(unique_ptr<TestGeometryLoader> geo
 }
 
 AlgorithmForWorldGraph::Result CalculateRoute(IndexGraphStarter & starter, vector<Segment> & roadPoints,
-                                              double & timeSec)
+                                              double & timeSec, bool bidirectional)
 {
   AlgorithmForWorldGraph algorithm;
   RoutingResult<Segment, RouteWeight> routingResult;
@@ -478,7 +478,8 @@ AlgorithmForWorldGraph::Result CalculateRoute(IndexGraphStarter & starter, vecto
   AlgorithmForWorldGraph::ParamsForTests<AStarLengthChecker> params(
       starter, starter.GetStartSegment(), starter.GetFinishSegment(), AStarLengthChecker(starter));
 
-  auto const resultCode = algorithm.FindPathBidirectional(params, routingResult);
+  auto const resultCode = bidirectional ? algorithm.FindPathBidirectional(params, routingResult)
+                                        : algorithm.FindPath(params, routingResult);
 
   timeSec = routingResult.m_distance.GetWeight();
   roadPoints = routingResult.m_path;
@@ -487,11 +488,11 @@ AlgorithmForWorldGraph::Result CalculateRoute(IndexGraphStarter & starter, vecto
 
 void TestRouteGeometry(IndexGraphStarter & starter,
                        AlgorithmForWorldGraph::Result expectedRouteResult,
-                       vector<m2::PointD> const & expectedRouteGeom)
+                       vector<m2::PointD> const & expectedRouteGeom, bool bidirectional)
 {
   vector<Segment> routeSegs;
   double timeSec = 0.0;
-  auto const resultCode = CalculateRoute(starter, routeSegs, timeSec);
+  auto const resultCode = CalculateRoute(starter, routeSegs, timeSec, bidirectional);
 
   TEST_EQUAL(resultCode, expectedRouteResult, ());
 
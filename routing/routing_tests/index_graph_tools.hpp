@@ -281,13 +281,16 @@ std::unique_ptr<SingleVehicleWorldGraph> BuildWorldGraph(std::unique_ptr<ZeroGeo
                                                          std::shared_ptr<EdgeEstimator> estimator,
                                                          std::vector<Joint> const & joints);
 
+/// \brief Calculates the route by the bidirectional A* or by the forward one if |bidirectional|
+/// is false. The latter is used by IndexRouter with time-dependent weights.
 AStarAlgorithm<Segment, SegmentEdge, RouteWeight>::Result CalculateRoute(
-    IndexGraphStarter & starter, std::vector<Segment> & roadPoints, double & timeSec);
+    IndexGraphStarter & starter, std::vector<Segment> & roadPoints, double & timeSec,
+    bool bidirectional = true);
 
 void TestRouteGeometry(
     IndexGraphStarter & starter,
     AStarAlgorithm<Segment, SegmentEdge, RouteWeight>::Result expectedRouteResult,
-    std::vector<m2::PointD> const & expectedRouteGeom);
+    std::vector<m2::PointD> const & expectedRouteGeom, bool bidirectional = true);
 
 /// \brief Applies |restrictions| to graph in |restrictionTest| and
 /// tests the resulting route.
@@ -0,0 +1,307 @@
+#include "testing/testing.hpp"
+
+#include "routing/base/astar_algorithm.hpp"
+#include "routing/base/astar_graph.hpp"
+#include "routing/base/landmark_distances.hpp"
+#include "routing/base/routing_result.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace landmark_distances_test
+{
+using namespace routing;
+using namespace std;
+
+using Vertex = LandmarkDistances::Vertex;
+
+double constexpr kUnreachable = numeric_limits<double>::max();
+
+struct Edge
+{
+  Edge() = default;
+  Edge(Vertex target, double weight) : m_target(target), m_weight(weight) {}
+
+  Vertex GetTarget() const { return m_target; }
+  double GetWeight() const { return m_weight; }
+
+  Vertex m_target = 0;
+  double m_weight = 0.0;
+};
+
+// Directed graph with zero heuristic.
+class Graph : public AStarGraph<Vertex, Edge, double>
+{
+public:
+  explicit Graph(uint32_t numVertices) : m_outgoing(numVertices), m_ingoing(numVertices) {}
+
+  void AddEdge(Vertex from, Vertex to, double weight)
+  {
+    m_outgoing[from].emplace_back(to, weight);
+    m_ingoing[to].emplace_back(from, weight);
+  }
+
+  uint32_t GetNumVertices() const { return static_cast<uint32_t>(m_outgoing.size()); }
+
+  LandmarkDistances BuildLandmarks(uint32_t numLandmarks) const
+  {
+    LandmarkDistancesBuilder builder(GetNumVertices());
+    for (Vertex v = 0; v < GetNumVertices(); ++v)
+    {
+      for (auto const & edge : m_outgoing[v])
+        builder.AddEdge(v, edge.m_target, edge.m_weight);
+    }
+
+    LandmarkDistances distances;
+    builder.Build(numLandmarks, distances);
+    return distances;
+  }
+
+  vector<double> Dijkstra(Vertex source) const
+  {
+    vector<double> weights(GetNumVertices(), kUnreachable);
+    priority_queue<pair<double, Vertex>, vector<pair<double, Vertex>>, greater<>> queue;
+    weights[source] = 0.0;
+    queue.emplace(0.0, source);
+    while (!queue.empty())
+    {
+      auto const [weight, v] = queue.top();
+      queue.pop();
+      if (weight > weights[v])
+        continue;
+
+      for (auto const & edge : m_outgoing[v])
+      {
+        if (weight + edge.m_weight < weights[edge.m_target])
+        {
+          weights[edge.m_target] = weight + edge.m_weight;
+          queue.emplace(weights[edge.m_target], edge.m_target);
+        }
+      }
+    }
+    return weights;
+  }
+
+  // AStarGraph overrides:
+  double HeuristicCostEstimate(Vertex const & /* from */, Vertex const & /* to */) override
+  {
+    return 0.0;
+  }
+
+  void GetOutgoingEdgesList(astar::VertexData<Vertex, double> const & vertexData,
+                            EdgeListT & edges) override
+  {
+    edges.clear();
+    for (auto const & edge : m_outgoing[vertexData.m_vertex])
+      edges.push_back(edge);
+  }
+
+  void GetIngoingEdgesList(astar::VertexData<Vertex, double> const & vertexData,
+                           EdgeListT & edges) override
+  {
+    edges.clear();
+    for (auto const & edge : m_ingoing[vertexData.m_vertex])
+      edges.push_back(edge);
+  }
+
+private:
+  vector<vector<Edge>> m_outgoing;
+  vector<vector<Edge>> m_ingoing;
+};
+
+class Heuristic : public astar::Heuristic<Vertex, double>
+{
+public:
+  Heuristic(LandmarkDistances const & distances, Vertex start, Vertex finish)
+    : m_distances(distances), m_start(start), m_finish(finish)
+  {
+  }
+
+  double HeuristicCostEstimate(Vertex const & from, Vertex const & to) override
+  {
+    ++m_calls;
+    TEST(to == m_start || to == m_finish, (to));
+    return to == m_finish ? m_distances.GetLowerBound(from, to)
+                          : m_distances.GetLowerBound(to, from);
+  }
+
+  uint32_t m_calls = 0;
+
+private:
+  LandmarkDistances const & m_distances;
+  Vertex const m_start;
+  Vertex const m_finish;
+};
+
+// Weights are integers if |integerWeights| is true.
+Graph MakeRandomGraph(uint32_t numVertices, uint32_t numEdges, uint32_t seed, bool integerWeights)
+{
+  mt19937 rnd(seed);
+  uniform_int_distribution<Vertex> vertexDist(0, numVertices - 1);
+  uniform_real_distribution<double> weightDist(1.0, 100.0);
+  auto const makeWeight = [&]() {
+    double const weight = weightDist(rnd);
+    return integerWeights ? floor(weight) : weight;
+  };
+
+  Graph graph(numVertices);
+  // A ring guarantees connectivity.
+  for (Vertex v = 0; v < numVertices; ++v)
+    graph.AddEdge(v, (v + 1) % numVertices, makeWeight());
+
+  for (uint32_t i = 0; i < numEdges; ++i)
+  {
+    Vertex const from = vertexDist(rnd);
+    Vertex const to = vertexDist(rnd);
+    if (from != to)
+      graph.AddEdge(from, to, makeWeight());
+  }
+  return graph;
+}
+
+UNIT_TEST(LandmarkDistances_Line)
+{
+  // 0 <-> 1 <-> 2 <-> 3, the end of the line is the best landmark.
+  Graph graph(4 /* numVertices */);
+  for (Vertex v = 0; v < 3; ++v)
+  {
+    graph.AddEdge(v, v + 1, 10.0);
+    graph.AddEdge(v + 1, v, 10.0);
+  }
+
+  auto const distances = graph.BuildLandmarks(2 /* numLandmarks */);
+  TEST_EQUAL(distances.GetNumLandmarks(), 2, ());
+  auto const & landmarks = distances.GetLandmarks();
+  TEST((landmarks[0] == 0 && landmarks[1] == 3) || (landmarks[0] == 3 && landmarks[1] == 0),
+       (landmarks));
+
+  TEST_EQUAL(distances.GetLowerBound(0, 3), 30.0, ());
+  TEST_EQUAL(distances.GetLowerBound(1, 2), 10.0, ());
+  TEST_EQUAL(distances.GetLowerBound(2, 2), 0.0, ());
+}
+
+UNIT_TEST(LandmarkDistances_Unreachable)
+{
+  // Two strongly connected components: {0, 1} and {2, 3} with the only edge 1 -> 2.
+  Graph graph(4 /* numVertices */);
+  graph.AddEdge(0, 1, 5.0);
+  graph.AddEdge(1, 0, 5.0);
+  graph.AddEdge(1, 2, 5.0);
+  graph.AddEdge(2, 3, 5.0);
+  graph.AddEdge(3, 2, 5.0);
+
+  auto const distances = graph.BuildLandmarks(4 /* numLandmarks */);
+  TEST_EQUAL(distances.GetNumVertices(), 4, ());
+  // Landmarks are selected in one strongly connected component only.
+  TEST_EQUAL(distances.GetNumLandmarks(), 2, ());
+
+  for (Vertex from = 0; from < 4; ++from)
+  {
+    auto const expected = graph.Dijkstra(from);
+    for (Vertex to = 0; to < 4; ++to)
+      TEST_LESS_OR_EQUAL(distances.GetLowerBound(from, to), expected[to], (from, to));
+  }
+}
+
+UNIT_TEST(LandmarkDistances_RandomGraphs)
+{
+  uint32_t constexpr kNumVertices = 100;
+  for (uint32_t seed = 0; seed < 5; ++seed)
+  {
+    auto const graph = MakeRandomGraph(kNumVertices, 2 * kNumVertices /* numEdges */, seed,
+                                       true /* integerWeights */);
+    auto const distances = graph.BuildLandmarks(4 /* numLandmarks */);
+    TEST_EQUAL(distances.GetNumLandmarks(), 4, ());
+
+    uint32_t nonZeroBounds = 0;
+    for (Vertex from = 0; from < kNumVertices; ++from)
+    {
+      auto const expected = graph.Dijkstra(from);
+      for (Vertex to = 0; to < kNumVertices; ++to)
+      {
+        double const bound = distances.GetLowerBound(from, to);
+        TEST_LESS_OR_EQUAL(bound, expected[to], (seed, from, to));
+        if (bound > 0.0)
+          ++nonZeroBounds;
+      }
+
+      // A bound to a landmark is exact.
+      for (auto const landmark : distances.GetLandmarks())
+        TEST_EQUAL(distances.GetLowerBound(from, landmark), expected[landmark], (seed, from));
+    }
+    TEST_GREATER(nonZeroBounds, kNumVertices * kNumVertices / 2, (seed));
+  }
+}
+
+UNIT_TEST(LandmarkDistances_Serialization)
+{
+  uint32_t constexpr kNumVertices = 30;
+  auto const graph = MakeRandomGraph(kNumVertices, 3 * kNumVertices /* numEdges */, 42 /* seed */,
+                                     false /* integerWeights */);
+  auto const distances = graph.BuildLandmarks(3 /* numLandmarks */);
+
+  vector<uint8_t> buffer;
+  {
+    MemWriter<decltype(buffer)> writer(buffer);
+    distances.Serialize(writer);
+  }
+
+  LandmarkDistances deserialized;
+  {
+    MemReader reader(buffer.data(), buffer.size());
+    ReaderSource<MemReader> src(reader);
+    deserialized.Deserialize(src);
+    TEST_EQUAL(src.Size(), 0, ());
+  }
+
+  TEST_EQUAL(deserialized.GetNumVertices(), kNumVertices, ());
+  TEST_EQUAL(deserialized.GetLandmarks(), distances.GetLandmarks(), ());
+  for (Vertex from = 0; from < kNumVertices; ++from)
+  {
+    for (Vertex to = 0; to < kNumVertices; ++to)
+      TEST_EQUAL(deserialized.GetLowerBound(from, to), distances.GetLowerBound(from, to), ());
+  }
+}
+
+UNIT_TEST(LandmarkDistances_AStarHeuristic)
+{
+  using Algorithm = AStarAlgorithm<Vertex, Edge, double>;
+
+  uint32_t constexpr kNumVertices = 200;
+  // Weights are rounded down for landmarks, the bound must be consistent anyway.
+  auto graph = MakeRandomGraph(kNumVertices, 2 * kNumVertices /* numEdges */, 7 /* seed */,
+                               false /* integerWeights */);
+  auto const distances = graph.BuildLandmarks(4 /* numLandmarks */);
+
+  Algorithm algorithm;
+  for (Vertex finish = 1; finish < kNumVertices; finish += 13)
+  {
+    double const expected = graph.Dijkstra(0 /* source */)[finish];
+    Heuristic heuristic(distances, 0 /* start */, finish);
+
+    Algorithm::ParamsForTests<> params(graph, 0 /* startVertex */, finish);
+    params.m_heuristic = &heuristic;
+
+    RoutingResult<Vertex, double> result;
+    TEST_EQUAL(algorithm.FindPath(params, result), Algorithm::Result::OK, (finish));
+    TEST_ALMOST_EQUAL_ABS(result.m_distance, expected, 1e-6, (finish));
+
+    result = {};
+    TEST_EQUAL(algorithm.FindPathBidirectional(params, result), Algorithm::Result::OK, (finish));
+    TEST_ALMOST_EQUAL_ABS(result.m_distance, expected, 1e-6, (finish));
+    TEST_EQUAL(result.m_path.front(), 0, ());
+    TEST_EQUAL(result.m_path.back(), finish, ());
+
+    TEST_GREATER(heuristic.m_calls, 0, ());
+  }
+}
+}  // namespace landmark_distances_test
@@ -0,0 +1,150 @@
+#include "testing/testing.hpp"
+
+#include "routing/road_geometry_section.hpp"
+#include "routing/routing_exceptions.hpp"
+
+#include "coding/memory_region.hpp"
+#include "coding/point_coding.hpp"
+#include "coding/writer.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace road_geometry_section_test
+{
+using namespace routing;
+using namespace std;
+
+uint8_t constexpr kCoordBits = 30;
+
+RoadGeometrySectionBuilder::Road MakeRoad(uint32_t featureId, vector<m2::PointD> const & points)
+{
+  RoadGeometrySectionBuilder::Road road;
+  road.m_featureId = featureId;
+  // Points are quantized the same way as points of features are.
+  for (auto const & point : points)
+    road.m_points.push_back(PointUToPointD(PointDToPointU(point, kCoordBits), kCoordBits));
+
+  auto & car = road.m_vehicles[static_cast<size_t>(VehicleType::Car)];
+  car.m_valid = true;
+  car.m_isOneWay = featureId % 2 == 0;
+  car.m_highwayType = HighwayType::HighwayPrimary;
+  car.m_forwardSpeed = SpeedKMpH(60.0, 50.0);
+  car.m_backwardSpeed = SpeedKMpH(40.5, 30.25);
+
+  auto & pedestrian = road.m_vehicles[static_cast<size_t>(VehicleType::Pedestrian)];
+  pedestrian.m_valid = true;
+  pedestrian.m_isPassThroughAllowed = true;
+  pedestrian.m_forwardSpeed = pedestrian.m_backwardSpeed = SpeedKMpH(5.0);
+  return road;
+}
+
+unique_ptr<RoadGeometrySection> Serialize(RoadGeometrySectionBuilder const & builder)
+{
+  vector<uint8_t> buffer;
+  {
+    MemWriter<decltype(buffer)> writer(buffer);
+    builder.Serialize(writer);
+  }
+  TEST_EQUAL(buffer.size() % 4, 0, ());
+  return make_unique<RoadGeometrySection>(make_unique<CopiedMemoryRegion>(move(buffer)));
+}
+
+UNIT_TEST(RoadGeometrySection_Smoke)
+{
+  vector<RoadGeometrySectionBuilder::Road> roads = {
+      MakeRoad(3 /* featureId */, {{0.0, 0.0}, {1.0, 1.0}, {2.0, 1.5}}),
+      MakeRoad(10 /* featureId */, {{10.0, 20.0}, {10.5, 20.5}}),
+      MakeRoad(11 /* featureId */, {{-30.123456, 45.654321}, {-30.2, 45.7}, {-30.3, 45.8},
+                                    {-30.4, 45.9}})};
+  roads[0].m_altitudes = {100, 110, 120};
+  roads[1].m_inCity = true;
+  roads[2].m_routingOptions.Add(RoutingOptions::Road::Toll);
+
+  RoadGeometrySectionBuilder builder(kCoordBits, true /* hasAltitudes */);
+  for (auto road : roads)
+    builder.AddRoad(move(road));
+
+  auto const section = Serialize(builder);
+  TEST_EQUAL(section->GetRoadsNumber(), roads.size(), ());
+  TEST(section->HasAltitudes(), ());
+  TEST(!section->FindRoad(0 /* featureId */), ());
+  TEST(!section->FindRoad(5 /* featureId */), ());
+  TEST(!section->FindRoad(12 /* featureId */), ());
+
+  for (auto const & road : roads)
+  {
+    auto const roadIdx = section->FindRoad(road.m_featureId);
+    TEST(roadIdx, (road.m_featureId));
+    TEST_EQUAL(section->GetFeatureId(*roadIdx), road.m_featureId, ());
+
+    uint32_t const begin = section->GetPointsBegin(*roadIdx);
+    TEST_EQUAL(section->GetPointsEnd(*roadIdx) - begin, road.m_points.size(), ());
+    for (uint32_t i = 0; i < road.m_points.size(); ++i)
+    {
+      TEST_EQUAL(section->GetPoint(begin + i), road.m_points[i], (road.m_featureId, i));
+      TEST_EQUAL(section->GetAltitude(begin + i),
+                 road.m_altitudes.empty() ? geometry::kDefaultAltitudeMeters : road.m_altitudes[i],
+                 ());
+    }
+
+    TEST_EQUAL(section->GetRoutingOptions(*roadIdx).GetOptions(),
+               road.m_routingOptions.GetOptions(), ());
+
+    for (auto const vehicleType : {VehicleType::Pedestrian, VehicleType::Bicycle, VehicleType::Car})
+    {
+      auto const & attrs = road.m_vehicles[static_cast<size_t>(vehicleType)];
+      uint8_t const flags = section->GetFlags(vehicleType, *roadIdx);
+      TEST_EQUAL((flags & RoadGeometrySection::kValid) != 0, attrs.m_valid, ());
+      TEST_EQUAL((flags & RoadGeometrySection::kOneWay) != 0, attrs.m_isOneWay, ());
+      TEST_EQUAL((flags & RoadGeometrySection::kPassThroughAllowed) != 0,
+                 attrs.m_isPassThroughAllowed, ());
+      TEST_EQUAL((flags & RoadGeometrySection::kInCity) != 0, road.m_inCity, ());
+      TEST(section->GetHighwayType(vehicleType, *roadIdx) == attrs.m_highwayType, ());
+      TEST_EQUAL(section->GetSpeed(vehicleType, *roadIdx, true /* forward */),
+                 attrs.m_forwardSpeed, ());
+      TEST_EQUAL(section->GetSpeed(vehicleType, *roadIdx, false /* forward */),
+                 attrs.m_backwardSpeed, ());
+    }
+  }
+}
+
+UNIT_TEST(RoadGeometrySection_NoAltitudes)
+{
+  RoadGeometrySectionBuilder builder(kCoordBits, false /* hasAltitudes */);
+  builder.AddRoad(MakeRoad(7 /* featureId */, {{1.0, 2.0}, {3.0, 4.0}}));
+
+  auto const section = Serialize(builder);
+  TEST(!section->HasAltitudes(), ());
+  TEST_EQUAL(section->GetRoadsNumber(), 1, ());
+  auto const roadIdx = section->FindRoad(7 /* featureId */);
+  TEST(roadIdx, ());
+  TEST_EQUAL(*roadIdx, 0, ());
+}
+
+UNIT_TEST(RoadGeometrySection_Empty)
+{
+  auto const section = Serialize(RoadGeometrySectionBuilder(kCoordBits, false /* hasAltitudes */));
+  TEST_EQUAL(section->GetRoadsNumber(), 0, ());
+  TEST(!section->FindRoad(0 /* featureId */), ());
+}
+
+UNIT_TEST(RoadGeometrySection_Corrupted)
+{
+  RoadGeometrySectionBuilder builder(kCoordBits, true /* hasAltitudes */);
+  builder.AddRoad(MakeRoad(1 /* featureId */, {{1.0, 2.0}, {3.0, 4.0}}));
+
+  vector<uint8_t> buffer;
+  {
+    MemWriter<decltype(buffer)> writer(buffer);
+    builder.Serialize(writer);
+  }
+  buffer.resize(buffer.size() / 2);
+
+  TEST_ANY_THROW(RoadGeometrySection(make_unique<CopiedMemoryRegion>(move(buffer))), ());
+}
+}  // namespace road_geometry_section_test
@@ -0,0 +1,209 @@
+#include "testing/testing.hpp"
+
+#include "routing/routing_tests/road_graph_builder.hpp"
+
+#include "routing/nearest_edge_finder.hpp"
+#include "routing/road_graph.hpp"
+#include "routing/road_segments_index.hpp"
+#include "routing/routing_helpers.hpp"
+
+#include "coding/memory_region.hpp"
+#include "coding/point_coding.hpp"
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "geometry/mercator.hpp"
+#include "geometry/point_with_altitude.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace road_segments_index_test
+{
+using namespace routing;
+using namespace routing_test;
+using namespace std;
+
+struct TestRoad
+{
+  uint32_t m_featureId;
+  bool m_bidirectional;
+  IRoadGraph::PointWithAltitudeVec m_junctions;
+};
+
+IRoadGraph::PointWithAltitudeVec MakeJunctions(vector<m2::PointD> const & points,
+                                               geometry::Altitude altitude)
+{
+  IRoadGraph::PointWithAltitudeVec junctions;
+  // Points are quantized the same way as points of features are.
+  for (auto const & point : points)
+  {
+    junctions.emplace_back(PointUToPointD(PointDToPointU(point, kPointCoordBits), kPointCoordBits),
+                           altitude);
+  }
+  return junctions;
+}
+
+// A grid of |size| x |size| roads: horizontal roads are even features, vertical ones are odd.
+vector<TestRoad> MakeGrid(size_t size, double step)
+{
+  vector<TestRoad> roads;
+  for (size_t i = 0; i < size; ++i)
+  {
+    vector<m2::PointD> horizontal;
+    vector<m2::PointD> vertical;
+    for (size_t j = 0; j < size; ++j)
+    {
+      horizontal.emplace_back(j * step, i * step);
+      vertical.emplace_back(i * step, j * step);
+    }
+    auto const altitude = static_cast<geometry::Altitude>(i);
+    roads.push_back({static_cast<uint32_t>(2 * i), true /* bidirectional */,
+                     MakeJunctions(horizontal, altitude)});
+    roads.push_back({static_cast<uint32_t>(2 * i + 1), i % 2 == 0 /* bidirectional */,
+                     MakeJunctions(vertical, altitude)});
+  }
+  return roads;
+}
+
+RoadSegmentsIndexBuilder MakeBuilder(vector<TestRoad> const & roads, bool hasAltitudes)
+{
+  RoadSegmentsIndexBuilder builder(kPointCoordBits, hasAltitudes);
+  for (auto const & road : roads)
+    builder.AddRoad(road.m_featureId, road.m_bidirectional, road.m_junctions);
+  return builder;
+}
+
+unique_ptr<RoadSegmentsIndex> Serialize(RoadSegmentsIndexBuilder const & builder)
+{
+  vector<uint8_t> buffer;
+  {
+    MemWriter<decltype(buffer)> writer(buffer);
+    builder.Serialize(writer);
+  }
+  TEST_EQUAL(buffer.size() % 4, 0, ());
+  return make_unique<RoadSegmentsIndex>(make_unique<CopiedMemoryRegion>(move(buffer)));
+}
+
+UNIT_TEST(RoadSegmentsIndex_ForEachSegment)
+{
+  double constexpr kStep = 0.01;
+  auto const roads = MakeGrid(20 /* size */, kStep);
+  auto const index = MakeBuilder(roads, true /* hasAltitudes */).Build();
+  TEST_EQUAL(index->GetRoadsNumber(), roads.size(), ());
+  TEST(index->HasAltitudes(), ());
+
+  // All the segments are visited once for the rect around the grid.
+  map<pair<uint32_t, uint32_t>, size_t> visits;
+  index->ForEachSegment(m2::RectD(-1.0, -1.0, 1.0, 1.0),
+                        [&](RoadSegmentsIndex::RoadSegment const & segment) {
+                          ++visits[make_pair(segment.m_featureId, segment.m_segmentIdx)];
+                        });
+  TEST_EQUAL(visits.size(), roads.size() * 19, ());
+  for (auto const & visit : visits)
+    TEST_EQUAL(visit.second, 1, (visit.first));
+
+  // Segments keep points, altitudes and directions of the roads.
+  m2::RectD const rect(0.5 * kStep, 0.5 * kStep, 1.5 * kStep, 1.5 * kStep);
+  size_t count = 0;
+  index->ForEachSegment(rect, [&](RoadSegmentsIndex::RoadSegment const & segment) {
+    ++count;
+    TEST(rect.IsIntersect(m2::RectD(segment.m_start.GetPoint(), segment.m_end.GetPoint())), ());
+    auto const & road = roads[segment.m_featureId];
+    TEST_EQUAL(segment.m_bidirectional, road.m_bidirectional, ());
+    TEST_EQUAL(segment.m_start, road.m_junctions[segment.m_segmentIdx], ());
+    TEST_EQUAL(segment.m_end, road.m_junctions[segment.m_segmentIdx + 1], ());
+  });
+  // Two segments of horizontal road 1 and two segments of vertical road 1.
+  TEST_EQUAL(count, 4, ());
+}
+
+UNIT_TEST(RoadSegmentsIndex_FindClosestEdges)
+{
+  double constexpr kStep = 0.001;
+  auto const roads = MakeGrid(30 /* size */, kStep);
+  auto const index = Serialize(MakeBuilder(roads, true /* hasAltitudes */));
+
+  for (auto const & point : {m2::PointD(0.0123, 0.0171), m2::PointD(0.0005, 0.0002),
+                             m2::PointD(-0.0001, 0.0150), m2::PointD(0.0289, 0.0291)})
+  {
+    m2::RectD const rect = mercator::RectByCenterXYAndSizeInMeters(point, 300.0 /* sizeInMeters */);
+
+    // Only roads which cross the rect are added the same way as FeaturesRoadGraphBase::FindRoads()
+    // does.
+    NearestEdgeFinder expectedFinder(point, nullptr /* isEdgeProjGood */);
+    for (auto const & road : roads)
+    {
+      if (!RectCoversPolyline(road.m_junctions, rect))
+        continue;
+
+      IRoadGraph::RoadInfo roadInfo;
+      roadInfo.m_bidirectional = road.m_bidirectional;
+      roadInfo.m_junctions = road.m_junctions;
+      expectedFinder.AddInformationSource(
+          IRoadGraph::FullRoadInfo(MakeTestFeatureID(road.m_featureId), roadInfo));
+    }
+
+    NearestEdgeFinder finder(point, nullptr /* isEdgeProjGood */);
+    index->FindClosestEdges(MakeTestFeatureID(0).m_mwmId, rect, finder);
+
+    vector<IRoadGraph::EdgeProjectionT> expected;
+    expectedFinder.MakeResult(expected, 4 /* maxCountFeatures */);
+    vector<IRoadGraph::EdgeProjectionT> result;
+    finder.MakeResult(result, 4 /* maxCountFeatures */);
+    TEST(!result.empty(), (point));
+    TEST_EQUAL(result, expected, (point));
+  }
+}
+
+UNIT_TEST(RoadSegmentsIndex_Empty)
+{
+  for (bool const hasAltitudes : {false, true})
+  {
+    auto const index = Serialize(RoadSegmentsIndexBuilder(kPointCoordBits, hasAltitudes));
+    TEST_EQUAL(index->GetRoadsNumber(), 0, ());
+    TEST_EQUAL(index->HasAltitudes(), hasAltitudes, ());
+    index->ForEachSegment(m2::RectD(-1.0, -1.0, 1.0, 1.0),
+                          [](RoadSegmentsIndex::RoadSegment const &) { TEST(false, ()); });
+  }
+}
+
+UNIT_TEST(RoadSegmentsIndex_Section)
+{
+  // Indexes of the vehicle types have different numbers of roads.
+  auto const roads = MakeGrid(4 /* size */, 0.001 /* step */);
+  vector<RoadSegmentsIndexBuilder> builders;
+  for (size_t i = 0; i < RoadSegmentsIndex::kVehiclesNumber; ++i)
+  {
+    builders.push_back(MakeBuilder(vector<TestRoad>(roads.cbegin(), roads.cbegin() + i + 1),
+                                   i % 2 == 0 /* hasAltitudes */));
+  }
+
+  vector<uint8_t> buffer;
+  {
+    MemWriter<vector<uint8_t>> writer(buffer);
+    RoadSegmentsIndexBuilder::SerializeSection(builders, writer);
+  }
+
+  MemReader reader(buffer.data(), buffer.size());
+  ReaderSource<MemReader> src(reader);
+  TEST_EQUAL(ReadPrimitiveFromSource<uint16_t>(src), RoadSegmentsIndex::kLastSectionVersion, ());
+  TEST_EQUAL(ReadPrimitiveFromSource<uint16_t>(src), RoadSegmentsIndex::kVehiclesNumber, ());
+  for (size_t i = 0; i < RoadSegmentsIndex::kVehiclesNumber; ++i)
+  {
+    auto const pos = ReadPrimitiveFromSource<uint32_t>(src);
+    RoadSegmentsIndex const index(make_unique<CopiedMemoryRegion>(vector<uint8_t>(buffer)), pos);
+    TEST_EQUAL(index.GetRoadsNumber(), i + 1, ());
+    TEST_EQUAL(index.HasAltitudes(), i % 2 == 0, ());
+
+    size_t segmentsNumber = 0;
+    index.ForEachSegment(m2::RectD(-1.0, -1.0, 1.0, 1.0),
+                         [&segmentsNumber](RoadSegmentsIndex::RoadSegment const &) { ++segmentsNumber; });
+    TEST_EQUAL(segmentsNumber, 3 * (i + 1), ());
+  }
+  TEST_EQUAL(ReadPrimitiveFromSource<uint32_t>(src), buffer.size(), ());
+}
+}  // namespace road_segments_index_test
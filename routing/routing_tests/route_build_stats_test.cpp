@@ -0,0 +1,69 @@
+#include "testing/testing.hpp"
+
+#include "routing/route_build_stats.hpp"
+
+#include <chrono>
+#include <thread>
+
+namespace route_build_stats_test
+{
+using namespace routing;
+using namespace std;
+
+using Phase = RouteBuildStats::Phase;
+
+void Sleep(uint32_t milliseconds) { this_thread::sleep_for(chrono::milliseconds(milliseconds)); }
+
+UNIT_TEST(RouteBuildStats_NestedPhases)
+{
+  RouteBuildStats stats;
+  {
+    RouteBuildStats::ScopedTimer astar(&stats, Phase::AStar);
+    Sleep(20);
+    {
+      RouteBuildStats::ScopedTimer loading(&stats, Phase::GraphLoading);
+      Sleep(50);
+    }
+    Sleep(20);
+  }
+
+  // Time of nested phases is not counted in the enclosing one.
+  TEST_GREATER_OR_EQUAL(stats.GetSeconds(Phase::GraphLoading), 0.05, ());
+  TEST_GREATER_OR_EQUAL(stats.GetSeconds(Phase::AStar), 0.04, ());
+  TEST_LESS(stats.GetSeconds(Phase::AStar), stats.GetSeconds(Phase::GraphLoading) + 0.04, ());
+  TEST_EQUAL(stats.GetSeconds(Phase::Directions), 0.0, ());
+  TEST_ALMOST_EQUAL_ABS(stats.GetTotalSeconds(),
+                        stats.GetSeconds(Phase::AStar) + stats.GetSeconds(Phase::GraphLoading),
+                        1e-9, ());
+
+  // Nothing is measured without stats.
+  RouteBuildStats::ScopedTimer timer(nullptr, Phase::Directions);
+}
+
+UNIT_TEST(RouteBuildStats_Average)
+{
+  RouteBuildStats sum;
+  for (uint32_t i = 1; i <= 3; ++i)
+  {
+    RouteBuildStats stats;
+    {
+      RouteBuildStats::ScopedTimer timer(&stats, Phase::FakeEndings);
+      Sleep(10);
+    }
+    stats.AddSettledVertices(i * 100);
+    sum += stats;
+  }
+
+  TEST_EQUAL(sum.GetSettledVertices(), 600, ());
+  double const totalSeconds = sum.GetSeconds(Phase::FakeEndings);
+  TEST_GREATER_OR_EQUAL(totalSeconds, 0.03, ());
+
+  sum.Average(3 /* launchesNumber */);
+  TEST_EQUAL(sum.GetSettledVertices(), 200, ());
+  TEST_ALMOST_EQUAL_ABS(sum.GetSeconds(Phase::FakeEndings), totalSeconds / 3, 1e-9, ());
+
+  sum.Clear();
+  TEST_EQUAL(sum.GetSettledVertices(), 0, ());
+  TEST_EQUAL(sum.GetTotalSeconds(), 0.0, ());
+}
+}  // namespace route_build_stats_test
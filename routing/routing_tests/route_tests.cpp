@@ -442,4 +442,54 @@ UNIT_TEST(RouteNameTest)
   route.GetCurrentStreetName(roadNameInfo);
   TEST_EQUAL(roadNameInfo.m_name, "Street2", (roadNameInfo.m_name));
 }
+
+UNIT_TEST(PendingDirectionsTest)
+{
+  Route route("TestRouter", 0 /* route id */);
+
+  // Directions are generated for the first two segments only.
+  size_t constexpr kPrefixSize = 2;
+  vector<turns::TurnItem> prefixTurns(kTestTurns2.begin(), kTestTurns2.begin() + kPrefixSize);
+  vector<RouteSegment::RoadNameInfo> prefixNames(kTestNames2.begin(),
+                                                 kTestNames2.begin() + kPrefixSize);
+  for (size_t i = prefixTurns.size(); i < kTestTurns2.size(); ++i)
+  {
+    prefixTurns.emplace_back(static_cast<uint32_t>(i + 1), turns::CarDirection::None);
+    prefixNames.emplace_back();
+  }
+
+  route.SetGeometry(kTestGeometry.begin(), kTestGeometry.end());
+  vector<RouteSegment> routeSegments;
+  GetTestRouteSegments(kTestGeometry, prefixTurns, prefixNames, kTestTimes2, routeSegments);
+  route.SetRouteSegments(move(routeSegments));
+  route.SetPendingDirections(true);
+  TEST(route.HasPendingDirections(), ());
+
+  RouteSegment::RoadNameInfo roadNameInfo;
+  route.GetClosestStreetNameAfterIdx(3, roadNameInfo);
+  TEST(roadNameInfo.m_name.empty(), (roadNameInfo.m_name));
+
+  vector<RouteSegment> directions;
+  GetTestRouteSegments(kTestGeometry, kTestTurns2, kTestNames2, kTestTimes2, directions);
+  // Only the segments without directions are passed.
+  route.SetDirections(kPrefixSize, vector<RouteSegment>(directions.begin() + kPrefixSize,
+                                                        directions.end()));
+  TEST(!route.HasPendingDirections(), ());
+
+  route.GetClosestStreetNameAfterIdx(3, roadNameInfo);
+  TEST_EQUAL(roadNameInfo.m_name, "Street3", (roadNameInfo.m_name));
+
+  // Distances and times are kept.
+  auto const & segments = route.GetRouteSegments();
+  for (size_t i = 0; i < segments.size(); ++i)
+  {
+    TEST_EQUAL(segments[i].GetTurn(), kTestTurns2[i], (i));
+    TEST_EQUAL(segments[i].GetTimeFromBeginningSec(), directions[i].GetTimeFromBeginningSec(), (i));
+  }
+
+  double distance;
+  turns::TurnItem turn;
+  route.GetCurrentTurn(distance, turn);
+  TEST_EQUAL(turn, kTestTurns2[1], ());
+}
 }  // namespace route_tests
@@ -0,0 +1,109 @@
+#include "testing/testing.hpp"
+
+#include "routing/routing_exceptions.hpp"
+#include "routing/speed_profiles.hpp"
+
+#include "routing_common/vehicle_model.hpp"
+
+#include "coding/memory_region.hpp"
+#include "coding/writer.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace speed_profiles_test
+{
+using namespace routing;
+using namespace std;
+
+using Ratios = SpeedProfile::Ratios;
+
+Ratios MakeRatios(uint8_t ratio)
+{
+  Ratios ratios;
+  ratios.fill(ratio);
+  return ratios;
+}
+
+unique_ptr<SpeedProfilesSection> Serialize(SpeedProfilesSectionBuilder const & builder)
+{
+  vector<uint8_t> buffer;
+  {
+    MemWriter<decltype(buffer)> writer(buffer);
+    builder.Serialize(writer);
+  }
+  TEST_EQUAL(buffer.size() % 4, 0, ());
+  return make_unique<SpeedProfilesSection>(make_unique<CopiedMemoryRegion>(move(buffer)));
+}
+
+UNIT_TEST(SpeedProfile_SecondOfWeek)
+{
+  // 1 January 1970 00:00 UTC is Thursday.
+  TEST_EQUAL(SpeedProfile::GetSecondOfWeek(0), 3 * 24 * 3600, ());
+  // 5 January 1970 00:00 UTC is Monday.
+  TEST_EQUAL(SpeedProfile::GetSecondOfWeek(4 * 24 * 3600), 0, ());
+  TEST_EQUAL(SpeedProfile::GetSecondOfWeek(4 * 24 * 3600 + SpeedProfile::kWeekSec + 10), 10, ());
+}
+
+UNIT_TEST(SpeedProfile_Interpolation)
+{
+  Ratios ratios = MakeRatios(100);
+  ratios[1] = 50;
+  ratios[SpeedProfile::kKnotsNumber - 1] = 60;
+  SpeedProfile const profile(ratios.data());
+
+  TEST_ALMOST_EQUAL_ABS(profile.GetSpeedRatio(0.0), 1.0, 1e-9, ());
+  TEST_ALMOST_EQUAL_ABS(profile.GetSpeedRatio(1.5 * SpeedProfile::kKnotPeriodSec), 0.75, 1e-9, ());
+  // The profile is cyclic: the last hour of the week is interpolated with the first one.
+  TEST_ALMOST_EQUAL_ABS(profile.GetSpeedRatio(SpeedProfile::kWeekSec - 0.5 * 3600), 0.8, 1e-9, ());
+  TEST_ALMOST_EQUAL_ABS(profile.GetSpeedRatio(SpeedProfile::kWeekSec + 3600), 0.5, 1e-9, ());
+}
+
+UNIT_TEST(SpeedProfile_Quantize)
+{
+  TEST_EQUAL(SpeedProfile::QuantizeRatio(0.734), 73, ());
+  TEST_EQUAL(SpeedProfile::QuantizeRatio(0.01), SpeedProfile::kMinRatio, ());
+  TEST_EQUAL(SpeedProfile::QuantizeRatio(10.0), 255, ());
+}
+
+UNIT_TEST(SpeedProfilesSection_Smoke)
+{
+  SpeedProfilesSectionBuilder builder;
+  builder.AddFeature(2 /* featureId */, MakeRatios(50), nullopt);
+  builder.AddFeature(7 /* featureId */, MakeRatios(70), MakeRatios(50));
+  builder.AddFeature(9 /* featureId */, nullopt, nullopt);
+  builder.AddHighwayType(HighwayType::HighwayPrimary, MakeRatios(90));
+  builder.AddHighwayType(HighwayType::HighwayMotorway, MakeRatios(70));
+  // Equal profiles are stored once.
+  TEST_EQUAL(builder.GetProfilesNumber(), 3, ());
+
+  auto const section = Serialize(builder);
+  TEST_EQUAL(section->GetHeader().m_profilesNumber, 3, ());
+  TEST_EQUAL(section->GetHeader().m_featuresNumber, 2, ());
+  TEST_EQUAL(section->GetHeader().m_highwayTypesNumber, 2, ());
+
+  auto const ratio = [&](uint32_t featureId, bool forward, optional<HighwayType> type) {
+    auto const profile = section->GetProfile(featureId, forward, type);
+    return profile.IsValid() ? profile.GetSpeedRatio(0.0) : 0.0;
+  };
+
+  TEST_ALMOST_EQUAL_ABS(ratio(2, true, nullopt), 0.5, 1e-9, ());
+  TEST_ALMOST_EQUAL_ABS(ratio(7, true, nullopt), 0.7, 1e-9, ());
+  TEST_ALMOST_EQUAL_ABS(ratio(7, false, nullopt), 0.5, 1e-9, ());
+  // The road has no profile in the direction, so the profile of its highway type is used.
+  TEST_ALMOST_EQUAL_ABS(ratio(2, false, HighwayType::HighwayPrimary), 0.9, 1e-9, ());
+  TEST_ALMOST_EQUAL_ABS(ratio(2, false, nullopt), 0.0, 1e-9, ());
+  TEST_ALMOST_EQUAL_ABS(ratio(9, true, HighwayType::HighwayMotorway), 0.7, 1e-9, ());
+  TEST_ALMOST_EQUAL_ABS(ratio(9, true, HighwayType::HighwaySecondary), 0.0, 1e-9, ());
+}
+
+UNIT_TEST(SpeedProfilesSection_WrongVersion)
+{
+  vector<uint8_t> buffer(20, 0);
+  buffer[0] = 1;
+  TEST_ANY_THROW(SpeedProfilesSection(make_unique<CopiedMemoryRegion>(move(buffer))), ());
+}
+}  // namespace speed_profiles_test
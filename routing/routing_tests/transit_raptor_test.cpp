@@ -0,0 +1,232 @@
+#include "testing/testing.hpp"
+
+#include "routing/transit_raptor.hpp"
+
+#include "transit/experimental/transit_types_experimental.hpp"
+#include "transit/transit_entities.hpp"
+#include "transit/transit_schedule.hpp"
+
+#include "base/timegm.hpp"
+
+#include <ctime>
+#include <vector>
+
+namespace transit_raptor_test
+{
+using namespace routing;
+using namespace std;
+using namespace ::transit;
+using ::transit::experimental::kInvalidFeatureId;
+using ::transit::experimental::kInvalidOsmId;
+using ::transit::experimental::Line;
+using ::transit::experimental::Stop;
+using TransitEdge = ::transit::experimental::Edge;
+
+using Journey = TransitRaptor::Journey;
+using StopTime = TransitRaptor::StopTime;
+
+// All the queries are made on Monday, 15 March 2021, so results don't depend on the current date.
+// Schedules are in UTC unless the offset of the network is set, so results don't depend on
+// the time zone of the device either.
+int constexpr kYear = 2021;
+int constexpr kMonth = 3;
+int constexpr kDay = 15;
+
+time_t GetTodayTime(int hour, int minute)
+{
+  return base::TimeGM(kYear, kMonth, kDay, hour, minute, 0 /* sec */);
+}
+
+Schedule MakeSchedule(Frequency headway)
+{
+  Schedule schedule;
+  schedule.SetDefaultFrequency(headway);
+  return schedule;
+}
+
+Line MakeLine(TransitId id, IdList const & stopIds, Schedule const & schedule)
+{
+  return Line(id, id /* routeId */, ShapeLink(), "" /* title */, stopIds, schedule);
+}
+
+Stop MakeStop(TransitId id, double x)
+{
+  return Stop(id, kInvalidFeatureId, kInvalidOsmId, "" /* title */, TimeTable{},
+              m2::PointD(x, 0.0), {} /* transferIds */);
+}
+
+TransitEdge MakeRide(TransitId stop1, TransitId stop2, EdgeWeight weight, TransitId lineId)
+{
+  return TransitEdge(stop1, stop2, weight, lineId, false /* transfer */, ShapeLink());
+}
+
+TransitEdge MakeTransfer(TransitId stop1, TransitId stop2, EdgeWeight weight)
+{
+  return TransitEdge(stop1, stop2, weight, kInvalidTransitId, true /* transfer */, ShapeLink());
+}
+
+//  Line 100 runs 1 -> 2 -> 3 every 10 minutes, line 200 runs 3 -> 4 every 15 minutes and
+//  line 300 runs 5 -> 4 every 5 minutes. Stops 3 and 5 are connected by a transfer.
+//
+//  1 --100-- 2 --100-- 3 --200-- 4
+//                      |         |
+//                      5 --300---+
+TransitRaptor BuildNetwork(Schedule const & line300Schedule, int32_t utcOffsetSeconds = 0)
+{
+  vector<Line> const lines = {MakeLine(100, {1, 2, 3}, MakeSchedule(600)),
+                              MakeLine(200, {3, 4}, MakeSchedule(900)),
+                              MakeLine(300, {5, 4}, line300Schedule)};
+  vector<Stop> const stops = {MakeStop(1, 0.0), MakeStop(2, 1.0), MakeStop(3, 2.0),
+                              MakeStop(4, 3.0), MakeStop(5, 2.0)};
+  vector<TransitEdge> const edges = {MakeRide(1, 2, 300, 100), MakeRide(2, 3, 300, 100),
+                                     MakeRide(3, 4, 600, 200), MakeRide(5, 4, 120, 300),
+                                     MakeTransfer(3, 5, 60)};
+  return TransitRaptor(lines, stops, edges, utcOffsetSeconds);
+}
+
+UNIT_TEST(TransitRaptor_EarliestArrivalWithTransfer)
+{
+  auto const raptor = BuildNetwork(MakeSchedule(300));
+  TEST_EQUAL(raptor.GetStopsNumber(), 5, ());
+  TEST_EQUAL(raptor.GetRoutesNumber(), 3, ());
+
+  time_t const departure = GetTodayTime(8, 0);
+  Journey journey;
+  TEST(raptor.FindEarliestArrival({StopTime(1, 60)}, {StopTime(4, 0)}, departure,
+                                  TransitRaptor::kDefaultMaxTransfers, journey),
+       ());
+
+  // The trip of line 100 at 08:10 is caught at stop 1, it's at stop 3 at 08:20. Then the walk to
+  // stop 5 and the trip of line 300 at 08:25 which is at stop 4 at 08:27.
+  TEST_EQUAL(journey.m_departureTime, GetTodayTime(8, 10) - 60, (journey));
+  TEST_EQUAL(journey.m_arrivalTime, GetTodayTime(8, 27), (journey));
+  TEST_EQUAL(journey.GetRidesNumber(), 2, (journey));
+  TEST_EQUAL(journey.m_legs.size(), 3, (journey));
+
+  TEST_EQUAL(journey.m_legs[0].m_lineId, 100, ());
+  TEST_EQUAL(journey.m_legs[0].m_fromStopId, 1, ());
+  TEST_EQUAL(journey.m_legs[0].m_toStopId, 3, ());
+  TEST_EQUAL(journey.m_legs[0].m_departureTime, GetTodayTime(8, 10), ());
+  TEST_EQUAL(journey.m_legs[0].m_arrivalTime, GetTodayTime(8, 20), ());
+
+  TEST(journey.m_legs[1].IsWalk(), ());
+  TEST_EQUAL(journey.m_legs[1].m_fromStopId, 3, ());
+  TEST_EQUAL(journey.m_legs[1].m_toStopId, 5, ());
+
+  TEST_EQUAL(journey.m_legs[2].m_lineId, 300, ());
+  TEST_EQUAL(journey.m_legs[2].m_departureTime, GetTodayTime(8, 25), ());
+  TEST_EQUAL(journey.m_legs[2].m_arrivalTime, GetTodayTime(8, 27), ());
+
+  // Stop 4 isn't reachable by line 100 only.
+  TEST(!raptor.FindEarliestArrival({StopTime(1, 60)}, {StopTime(4, 0)}, departure,
+                                   0 /* maxTransfers */, journey),
+       ());
+}
+
+UNIT_TEST(TransitRaptor_FrequencyIntervals)
+{
+  // Line 300 runs only from 08:00 till 08:10 today, so the journey goes by line 200.
+  FrequencyIntervals frequencies;
+  frequencies.AddInterval(TimeInterval(gtfs::Time(8, 0, 0), gtfs::Time(8, 10, 0)), 300);
+  Schedule schedule;
+  schedule.AddDateException(
+      DateException(gtfs::Date(kYear, kMonth, kDay), gtfs::CalendarDateException::Added),
+      frequencies);
+
+  auto const raptor = BuildNetwork(schedule);
+  Journey journey;
+  TEST(raptor.FindEarliestArrival({StopTime(1, 60)}, {StopTime(4, 0)}, GetTodayTime(8, 0),
+                                  TransitRaptor::kDefaultMaxTransfers, journey),
+       ());
+
+  // Line 200 departs from stop 3 at 08:30 and is at stop 4 at 08:40.
+  TEST_EQUAL(journey.m_arrivalTime, GetTodayTime(8, 40), (journey));
+  TEST_EQUAL(journey.GetRidesNumber(), 2, (journey));
+  TEST_EQUAL(journey.m_legs.back().m_lineId, 200, (journey));
+
+  // Before 08:00 line 300 is caught at 08:00.
+  TEST(raptor.FindEarliestArrival({StopTime(5, 0)}, {StopTime(4, 0)}, GetTodayTime(7, 30),
+                                  TransitRaptor::kDefaultMaxTransfers, journey),
+       ());
+  TEST_EQUAL(journey.m_arrivalTime, GetTodayTime(8, 2), (journey));
+}
+
+UNIT_TEST(TransitRaptor_Profile)
+{
+  auto const raptor = BuildNetwork(MakeSchedule(300));
+
+  vector<Journey> journeys;
+  raptor.FindProfile({StopTime(1, 60)}, {StopTime(4, 0)}, GetTodayTime(8, 0),
+                     30 * 60 /* windowSeconds */, TransitRaptor::kDefaultMaxTransfers, journeys);
+
+  // Trips of line 100 at 08:10, 08:20 and 08:30 are caught within the window.
+  TEST_EQUAL(journeys.size(), 3, (journeys));
+  for (size_t i = 0; i < journeys.size(); ++i)
+  {
+    TEST_EQUAL(journeys[i].m_departureTime, GetTodayTime(8, 10 + 10 * static_cast<int>(i)) - 60,
+               (journeys[i]));
+    TEST_EQUAL(journeys[i].m_arrivalTime, GetTodayTime(8, 27 + 10 * static_cast<int>(i)),
+               (journeys[i]));
+  }
+}
+uint32_t GetWaitingTime(TransitRaptor const & raptor, TransitId lineId, TransitId stopId,
+                        time_t time)
+{
+  auto const waitingTime = raptor.GetWaitingTime(lineId, stopId, time);
+  TEST(waitingTime, (lineId, stopId, time));
+  return waitingTime.value_or(0);
+}
+
+UNIT_TEST(TransitRaptor_WaitingTime)
+{
+  FrequencyIntervals frequencies;
+  frequencies.AddInterval(TimeInterval(gtfs::Time(8, 0, 0), gtfs::Time(8, 10, 0)), 300);
+  Schedule schedule;
+  schedule.AddDateException(
+      DateException(gtfs::Date(kYear, kMonth, kDay), gtfs::CalendarDateException::Added),
+      frequencies);
+
+  auto const raptor = BuildNetwork(schedule);
+
+  // Trips of line 100 depart from stop 1 every 10 minutes and are at stop 2 in 5 minutes.
+  TEST_EQUAL(GetWaitingTime(raptor, 100, 1, GetTodayTime(8, 1)), 9 * 60, ());
+  TEST_EQUAL(GetWaitingTime(raptor, 100, 2, GetTodayTime(8, 1)), 4 * 60, ());
+  TEST_EQUAL(GetWaitingTime(raptor, 100, 2, GetTodayTime(8, 5)), 0, ());
+
+  // Line 300 departs at 08:00, 08:05 and 08:10 only.
+  TEST_EQUAL(GetWaitingTime(raptor, 300, 5, GetTodayTime(7, 50)), 10 * 60, ());
+  TEST_EQUAL(GetWaitingTime(raptor, 300, 5, GetTodayTime(8, 6)), 4 * 60, ());
+  TEST(!raptor.GetWaitingTime(300, 5, GetTodayTime(8, 11)), ());
+
+  // Unknown line and a stop which isn't on the line.
+  TEST(!raptor.GetWaitingTime(400, 1, GetTodayTime(8, 0)), ());
+  TEST(!raptor.GetWaitingTime(100, 4, GetTodayTime(8, 0)), ());
+}
+
+UNIT_TEST(TransitRaptor_UtcOffset)
+{
+  // Line 300 runs from 08:00 till 08:10 of the network time, which is 3 hours ahead of UTC.
+  FrequencyIntervals frequencies;
+  frequencies.AddInterval(TimeInterval(gtfs::Time(8, 0, 0), gtfs::Time(8, 10, 0)), 300);
+  Schedule schedule;
+  schedule.AddDateException(
+      DateException(gtfs::Date(kYear, kMonth, kDay), gtfs::CalendarDateException::Added),
+      frequencies);
+
+  int32_t constexpr kOffset = 3 * 60 * 60;
+  auto const raptor = BuildNetwork(schedule, kOffset);
+
+  // 05:01 UTC is 08:01 of the network.
+  TEST_EQUAL(GetWaitingTime(raptor, 300, 5, GetTodayTime(5, 1)), 4 * 60, ());
+  TEST(!raptor.GetWaitingTime(300, 5, GetTodayTime(8, 1)), ());
+
+  // 22:00 UTC of the previous day is 01:00 of the service day of the network.
+  TEST_EQUAL(GetWaitingTime(raptor, 300, 5, GetTodayTime(1, 0) - kOffset), 7 * 60 * 60, ());
+
+  Journey journey;
+  TEST(raptor.FindEarliestArrival({StopTime(5, 0)}, {StopTime(4, 0)}, GetTodayTime(4, 30),
+                                  TransitRaptor::kDefaultMaxTransfers, journey),
+       ());
+  TEST_EQUAL(journey.m_arrivalTime, GetTodayTime(8, 2) - kOffset, (journey));
+}
+}  // namespace transit_raptor_test
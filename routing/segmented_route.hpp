@@ -1,6 +1,7 @@
 #pragma once
 
 #include "routing/route.hpp"
+#include "routing/route_weight.hpp"
 #include "routing/segment.hpp"
 
 #include "geometry/point2d.hpp"
@@ -16,23 +17,29 @@ public:
   {
   public:
     Step() = default;
-    Step(Segment const & segment, m2::PointD const & point) : m_segment(segment), m_point(point) {}
+    Step(Segment const & segment, m2::PointD const & point, RouteWeight const & weight)
+      : m_segment(segment), m_point(point), m_weight(weight)
+    {
+    }
 
     Segment const & GetSegment() const { return m_segment; }
     m2::PointD const & GetPoint() const { return m_point; }
+    RouteWeight const & GetWeight() const { return m_weight; }
 
   private:
     Segment m_segment;
     // The front point of segment
     m2::PointD m_point = m2::PointD::Zero();
+    // Weight of segment. It's kept to not calculate it again when the route is adjusted.
+    RouteWeight m_weight;
   };
 
   SegmentedRoute(m2::PointD const & start, m2::PointD const & finish,
                  std::vector<Route::SubrouteAttrs> const & subroutes);
 
-  void AddStep(Segment const & segment, m2::PointD const & point)
+  void AddStep(Segment const & segment, m2::PointD const & point, RouteWeight const & weight)
   {
-    m_steps.emplace_back(segment, point);
+    m_steps.emplace_back(segment, point, weight);
   }
 
   double CalcDistance(m2::PointD const & point) const;
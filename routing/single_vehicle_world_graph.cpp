@@ -188,6 +188,13 @@ double SingleVehicleWorldGraph::CalculateETAWithoutPenalty(Segment const & segme
                                         EdgeEstimator::Purpose::ETA);
 }
 
+double SingleVehicleWorldGraph::CalcETAFactor(Segment const & segment, double secondsFromDeparture)
+{
+  return m_estimator->CalcTimeFactor(segment,
+                                     GetRoadGeometry(segment.GetMwmId(), segment.GetFeatureId()),
+                                     EdgeEstimator::Purpose::ETA, secondsFromDeparture);
+}
+
 void SingleVehicleWorldGraph::ForEachTransition(NumMwmId numMwmId, bool isEnter, TransitionFnT const & fn)
 {
   return m_crossMwmGraph->ForEachTransition(numMwmId, isEnter, fn);
@@ -67,6 +67,7 @@ public:
                                 EdgeEstimator::Purpose purpose) const override;
   double CalculateETA(Segment const & from, Segment const & to) override;
   double CalculateETAWithoutPenalty(Segment const & segment) override;
+  double CalcETAFactor(Segment const & segment, double secondsFromDeparture) override;
 
   void ForEachTransition(NumMwmId numMwmId, bool isEnter, TransitionFnT const & fn) override;
 
@@ -0,0 +1,192 @@
+#include "routing/speed_profiles.hpp"
+
+#include "routing/aligned_arrays.hpp"
+#include "routing/routing_exceptions.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include "platform/local_country_file.hpp"
+
+#include "coding/endianness.hpp"
+#include "coding/files_container.hpp"
+#include "coding/reader.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/checked_cast.hpp"
+#include "base/logging.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "defines.hpp"
+
+namespace routing
+{
+using namespace std;
+
+// SpeedProfile ------------------------------------------------------------------------------------
+// static
+uint8_t SpeedProfile::QuantizeRatio(double ratio)
+{
+  double const quantized = round(ratio * kRatioDenominator);
+  return static_cast<uint8_t>(
+      clamp(quantized, static_cast<double>(kMinRatio),
+            static_cast<double>(numeric_limits<uint8_t>::max())));
+}
+
+// static
+uint32_t SpeedProfile::GetSecondOfWeek(time_t moment)
+{
+  // 1 January 1970 is Thursday, the fourth day of the week.
+  int64_t constexpr kEpochSecondOfWeek = 3 * 24 * 60 * 60;
+  int64_t const second = (static_cast<int64_t>(moment) + kEpochSecondOfWeek) % kWeekSec;
+  return static_cast<uint32_t>(second < 0 ? second + kWeekSec : second);
+}
+
+// SpeedProfilesSection ----------------------------------------------------------------------------
+SpeedProfilesSection::SpeedProfilesSection(unique_ptr<MemoryRegion> region)
+  : m_region(move(region))
+{
+  CHECK(m_region, ());
+
+  MemReader memReader(m_region->ImmutableData(), m_region->Size());
+  ReaderSource<MemReader> src(memReader);
+  m_header.m_version = ReadPrimitiveFromSource<uint16_t>(src);
+  if (m_header.m_version != kLastVersion)
+    MYTHROW(CorruptedDataException, ("Unknown speed profiles version:", m_header.m_version));
+
+  m_header.m_reserved = ReadPrimitiveFromSource<uint16_t>(src);
+  m_header.m_profilesNumber = ReadPrimitiveFromSource<uint32_t>(src);
+  m_header.m_featuresNumber = ReadPrimitiveFromSource<uint32_t>(src);
+  m_header.m_highwayTypesNumber = ReadPrimitiveFromSource<uint32_t>(src);
+
+  ArraysReader reader(m_region->ImmutableData(), m_region->Size(), src.Pos(),
+                      "Speed profiles section");
+  uint64_t const featuresNumber = m_header.m_featuresNumber;
+  uint64_t const highwayTypesNumber = m_header.m_highwayTypesNumber;
+
+  m_ratios = reader.Read<uint8_t>(uint64_t{m_header.m_profilesNumber} * SpeedProfile::kKnotsNumber);
+  m_featureIds = reader.Read<uint32_t>(featuresNumber);
+  m_forwardProfiles = reader.Read<uint32_t>(featuresNumber);
+  m_backwardProfiles = reader.Read<uint32_t>(featuresNumber);
+  m_highwayTypes = reader.Read<uint32_t>(highwayTypesNumber);
+  m_highwayTypeProfiles = reader.Read<uint32_t>(highwayTypesNumber);
+
+  auto const checkProfiles = [this](uint32_t const * profiles, uint64_t count) {
+    for (uint64_t i = 0; i < count; ++i)
+    {
+      if (profiles[i] != kNoProfile && profiles[i] >= m_header.m_profilesNumber)
+        MYTHROW(CorruptedDataException, ("Wrong speed profile:", profiles[i]));
+    }
+  };
+  checkProfiles(m_forwardProfiles, featuresNumber);
+  checkProfiles(m_backwardProfiles, featuresNumber);
+  checkProfiles(m_highwayTypeProfiles, highwayTypesNumber);
+}
+
+// static
+unique_ptr<SpeedProfilesSection> SpeedProfilesSection::Load(MwmValue const & mwmValue)
+{
+  // Arrays are used in place, so they must have the host byte order.
+  if (IsBigEndianMacroBased() || !mwmValue.m_cont.IsExist(SPEED_PROFILES_FILE_TAG))
+    return nullptr;
+
+  try
+  {
+    return make_unique<SpeedProfilesSection>(MapSection(mwmValue, SPEED_PROFILES_FILE_TAG));
+  }
+  catch (RootException const & e)
+  {
+    LOG(LERROR, ("File", mwmValue.GetCountryFileName(), "Error while reading",
+                 SPEED_PROFILES_FILE_TAG, "section.", e.Msg()));
+    return nullptr;
+  }
+}
+
+SpeedProfile SpeedProfilesSection::GetProfile(uint32_t featureId, bool forward,
+                                              optional<HighwayType> highwayType) const
+{
+  auto const * featuresEnd = m_featureIds + m_header.m_featuresNumber;
+  auto const * feature = lower_bound(m_featureIds, featuresEnd, featureId);
+  if (feature != featuresEnd && *feature == featureId)
+  {
+    auto const idx = feature - m_featureIds;
+    auto const profileIdx = forward ? m_forwardProfiles[idx] : m_backwardProfiles[idx];
+    if (profileIdx != kNoProfile)
+      return GetProfileByIdx(profileIdx);
+  }
+
+  if (!highwayType)
+    return {};
+
+  auto const type = static_cast<uint32_t>(*highwayType);
+  auto const * typesEnd = m_highwayTypes + m_header.m_highwayTypesNumber;
+  auto const * it = lower_bound(m_highwayTypes, typesEnd, type);
+  if (it == typesEnd || *it != type)
+    return {};
+
+  return GetProfileByIdx(m_highwayTypeProfiles[it - m_highwayTypes]);
+}
+
+SpeedProfile SpeedProfilesSection::GetProfileByIdx(uint32_t profileIdx) const
+{
+  ASSERT_LESS(profileIdx, m_header.m_profilesNumber, ());
+  return SpeedProfile(m_ratios + uint64_t{profileIdx} * SpeedProfile::kKnotsNumber);
+}
+
+// SpeedProfilesSectionBuilder ---------------------------------------------------------------------
+void SpeedProfilesSectionBuilder::AddFeature(uint32_t featureId, optional<Ratios> const & forward,
+                                             optional<Ratios> const & backward)
+{
+  CHECK(m_features.empty() || m_features.back().m_featureId < featureId, (featureId));
+  if (!forward && !backward)
+    return;
+
+  Feature feature;
+  feature.m_featureId = featureId;
+  if (forward)
+    feature.m_forward = AddProfile(*forward);
+  if (backward)
+    feature.m_backward = AddProfile(*backward);
+  m_features.push_back(feature);
+}
+
+void SpeedProfilesSectionBuilder::AddHighwayType(HighwayType highwayType, Ratios const & ratios)
+{
+  m_highwayTypes[highwayType] = AddProfile(ratios);
+}
+
+uint32_t SpeedProfilesSectionBuilder::AddProfile(Ratios const & ratios)
+{
+  auto const [it, inserted] =
+      m_profileIds.emplace(ratios, base::checked_cast<uint32_t>(m_profiles.size()));
+  if (inserted)
+    m_profiles.push_back(ratios);
+  return it->second;
+}
+
+void SpeedProfilesSectionBuilder::Serialize(Writer & writer) const
+{
+  vector<pair<uint32_t, uint32_t>> highwayTypes;
+  for (auto const & [type, profile] : m_highwayTypes)
+    highwayTypes.emplace_back(static_cast<uint32_t>(type), profile);
+  sort(highwayTypes.begin(), highwayTypes.end());
+
+  WriteToSink(writer, SpeedProfilesSection::kLastVersion);
+  WriteToSink(writer, uint16_t{0} /* reserved */);
+  WriteToSink(writer, base::checked_cast<uint32_t>(m_profiles.size()));
+  WriteToSink(writer, base::checked_cast<uint32_t>(m_features.size()));
+  WriteToSink(writer, base::checked_cast<uint32_t>(highwayTypes.size()));
+
+  ArraysWriter arrays(writer);
+  arrays.Write<uint8_t>(m_profiles.size() * SpeedProfile::kKnotsNumber, [&](uint64_t i) {
+    return m_profiles[i / SpeedProfile::kKnotsNumber][i % SpeedProfile::kKnotsNumber];
+  });
+  arrays.Write<uint32_t>(m_features.size(), [&](uint64_t i) { return m_features[i].m_featureId; });
+  arrays.Write<uint32_t>(m_features.size(), [&](uint64_t i) { return m_features[i].m_forward; });
+  arrays.Write<uint32_t>(m_features.size(), [&](uint64_t i) { return m_features[i].m_backward; });
+  arrays.Write<uint32_t>(highwayTypes.size(), [&](uint64_t i) { return highwayTypes[i].first; });
+  arrays.Write<uint32_t>(highwayTypes.size(), [&](uint64_t i) { return highwayTypes[i].second; });
+}
+}  // namespace routing
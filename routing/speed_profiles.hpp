@@ -0,0 +1,155 @@
+#pragma once
+
+#include "routing_common/vehicle_model.hpp"
+
+#include "coding/memory_region.hpp"
+#include "coding/writer.hpp"
+
+#include "base/assert.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <ctime>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+class MwmValue;
+
+namespace routing
+{
+/// \brief Weekly profile of the speed on a road relative to the speed of the vehicle model.
+/// The profile is piecewise-linear with a knot at the beginning of every hour of the week (UTC).
+/// Ratios at the knots are quantized to a byte, so a profile takes |kKnotsNumber| bytes.
+/// The class doesn't own the ratios, it's a view to the ratios of SpeedProfilesSection.
+class SpeedProfile final
+{
+public:
+  static uint32_t constexpr kKnotsNumber = 7 * 24;
+  static uint32_t constexpr kKnotPeriodSec = 60 * 60;
+  static uint32_t constexpr kWeekSec = kKnotsNumber * kKnotPeriodSec;
+  // A quantized ratio |kRatioDenominator| is the speed of the vehicle model.
+  static uint8_t constexpr kRatioDenominator = 100;
+  // Ratios are not less than kMinRatio / kRatioDenominator, so weights stay finite.
+  static uint8_t constexpr kMinRatio = 10;
+
+  using Ratios = std::array<uint8_t, kKnotsNumber>;
+
+  SpeedProfile() = default;
+  explicit SpeedProfile(uint8_t const * ratios) : m_ratios(ratios) {}
+
+  bool IsValid() const { return m_ratios != nullptr; }
+
+  /// \returns ratio of the speed at |secondOfWeek| to the speed of the vehicle model.
+  /// |secondOfWeek| may exceed the week, the profile is periodic.
+  double GetSpeedRatio(double secondOfWeek) const
+  {
+    ASSERT(IsValid(), ());
+    ASSERT_GREATER_OR_EQUAL(secondOfWeek, 0.0, ());
+
+    double const position = std::fmod(secondOfWeek, kWeekSec) / kKnotPeriodSec;
+    auto const knot = std::min(static_cast<uint32_t>(position), kKnotsNumber - 1);
+    auto const next = knot + 1 == kKnotsNumber ? 0 : knot + 1;
+    double const t = position - knot;
+    return (m_ratios[knot] * (1.0 - t) + m_ratios[next] * t) / kRatioDenominator;
+  }
+
+  static uint8_t QuantizeRatio(double ratio);
+
+  /// \returns seconds since Monday 00:00 UTC of the week of |moment|.
+  static uint32_t GetSecondOfWeek(time_t moment);
+
+private:
+  uint8_t const * m_ratios = nullptr;
+};
+
+/// \brief SPEED_PROFILES_FILE_TAG section. It keeps weekly speed profiles of car roads which are
+/// aggregated from tracks. A road has profiles of its own for both directions or the profile of
+/// its highway type. Equal profiles are stored once.
+/// The section is a structure of little-endian 4-byte aligned arrays, so it's used right from
+/// the mapped memory:
+///   Header
+///   uint8_t ratios[profilesNumber][SpeedProfile::kKnotsNumber]
+///   uint32_t featureIds[featuresNumber], ascending
+///   uint32_t forwardProfiles[featuresNumber], backwardProfiles[featuresNumber], kNoProfile
+///   if the road has no profile in the direction
+///   uint32_t highwayTypes[highwayTypesNumber], ascending
+///   uint32_t highwayTypeProfiles[highwayTypesNumber]
+class SpeedProfilesSection final
+{
+public:
+  static uint16_t constexpr kLastVersion = 0;
+  static uint32_t constexpr kNoProfile = std::numeric_limits<uint32_t>::max();
+
+  struct Header
+  {
+    uint16_t m_version = kLastVersion;
+    uint16_t m_reserved = 0;
+    uint32_t m_profilesNumber = 0;
+    uint32_t m_featuresNumber = 0;
+    uint32_t m_highwayTypesNumber = 0;
+  };
+
+  explicit SpeedProfilesSection(std::unique_ptr<MemoryRegion> region);
+
+  /// \returns the section of |mwmValue| mapped to memory or nullptr if there's no such section
+  /// or it can't be used.
+  static std::unique_ptr<SpeedProfilesSection> Load(MwmValue const & mwmValue);
+
+  Header const & GetHeader() const { return m_header; }
+
+  /// \returns profile of the road |featureId| in |forward| direction, the profile of
+  /// |highwayType| if the road has no profile of its own or an invalid profile.
+  SpeedProfile GetProfile(uint32_t featureId, bool forward,
+                          std::optional<HighwayType> highwayType) const;
+
+private:
+  SpeedProfile GetProfileByIdx(uint32_t profileIdx) const;
+
+  std::unique_ptr<MemoryRegion> m_region;
+  Header m_header;
+
+  uint8_t const * m_ratios = nullptr;
+  uint32_t const * m_featureIds = nullptr;
+  uint32_t const * m_forwardProfiles = nullptr;
+  uint32_t const * m_backwardProfiles = nullptr;
+  uint32_t const * m_highwayTypes = nullptr;
+  uint32_t const * m_highwayTypeProfiles = nullptr;
+};
+
+/// \brief Collects profiles and writes SpeedProfilesSection.
+class SpeedProfilesSectionBuilder final
+{
+public:
+  using Ratios = SpeedProfile::Ratios;
+
+  /// \brief Features should be added in ascending order of feature ids.
+  void AddFeature(uint32_t featureId, std::optional<Ratios> const & forward,
+                  std::optional<Ratios> const & backward);
+  void AddHighwayType(HighwayType highwayType, Ratios const & ratios);
+
+  bool IsEmpty() const { return m_profiles.empty(); }
+  size_t GetProfilesNumber() const { return m_profiles.size(); }
+
+  void Serialize(Writer & writer) const;
+
+private:
+  struct Feature
+  {
+    uint32_t m_featureId = 0;
+    uint32_t m_forward = SpeedProfilesSection::kNoProfile;
+    uint32_t m_backward = SpeedProfilesSection::kNoProfile;
+  };
+
+  uint32_t AddProfile(Ratios const & ratios);
+
+  std::vector<Ratios> m_profiles;
+  std::map<Ratios, uint32_t> m_profileIds;
+  std::vector<Feature> m_features;
+  std::map<HighwayType, uint32_t> m_highwayTypes;
+};
+}  // namespace routing
@@ -2,8 +2,6 @@
 
 #include "base/checked_cast.hpp"
 
-#include <map>
-
 namespace routing
 {
 using namespace std;
@@ -20,20 +18,14 @@ traffic::SpeedGroup TrafficStash::GetSpeedGroup(Segment const & segment) const
   if (itMwm == m_mwmToTraffic.cend())
     return traffic::SpeedGroup::Unknown;
 
-  auto const & coloring = itMwm->second;
-  auto const itSeg = coloring->find(traffic::TrafficInfo::RoadSegmentId(
+  return itMwm->second->GetSpeedGroup(
       segment.GetFeatureId(), base::asserted_cast<uint16_t>(segment.GetSegmentIdx()),
       segment.IsForward() ? traffic::TrafficInfo::RoadSegmentId::kForwardDirection
-                          : traffic::TrafficInfo::RoadSegmentId::kReverseDirection));
-
-  if (itSeg == coloring->cend())
-    return traffic::SpeedGroup::Unknown;
-
-  return itSeg->second;
+                          : traffic::TrafficInfo::RoadSegmentId::kReverseDirection);
 }
 
 void TrafficStash::SetColoring(NumMwmId numMwmId,
-                               shared_ptr<const traffic::TrafficInfo::Coloring> coloring)
+                               shared_ptr<traffic::TrafficTable const> coloring)
 {
   m_mwmToTraffic[numMwmId] = coloring;
 }
@@ -4,6 +4,7 @@
 
 #include "traffic/traffic_cache.hpp"
 #include "traffic/traffic_info.hpp"
+#include "traffic/traffic_table.hpp"
 
 #include "routing_common/num_mwm_id.hpp"
 
@@ -42,7 +43,7 @@ public:
   TrafficStash(traffic::TrafficCache const & source, std::shared_ptr<NumMwmIds> numMwmIds);
 
   traffic::SpeedGroup GetSpeedGroup(Segment const & segment) const;
-  void SetColoring(NumMwmId numMwmId, std::shared_ptr<const traffic::TrafficInfo::Coloring> coloring);
+  void SetColoring(NumMwmId numMwmId, std::shared_ptr<traffic::TrafficTable const> coloring);
   bool Has(NumMwmId numMwmId) const;
 
 private:
@@ -52,6 +53,6 @@ private:
 
   traffic::TrafficCache const & m_source;
   std::shared_ptr<NumMwmIds> m_numMwmIds;
-  std::unordered_map<NumMwmId, std::shared_ptr<const traffic::TrafficInfo::Coloring>> m_mwmToTraffic;
+  std::unordered_map<NumMwmId, std::shared_ptr<traffic::TrafficTable const>> m_mwmToTraffic;
 };
 }  // namespace routing
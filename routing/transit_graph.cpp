@@ -2,6 +2,7 @@
 
 #include "routing/fake_feature_ids.hpp"
 #include "routing/index_graph.hpp"
+#include "routing/transit_raptor.hpp"
 
 #include "indexer/feature_altitude.hpp"
 
@@ -179,6 +180,25 @@ RouteWeight TransitGraph::GetTransferPenalty(Segment const & from, Segment const
   UNREACHABLE();
 }
 
+double TransitGraph::CalcWaitingTime(Segment const & from, Segment const & to, time_t time) const
+{
+  auto const penalty = GetTransferPenalty(from, to).GetWeight();
+  if (m_transitVersion != ::transit::TransitVersion::AllPublicTransport)
+    return penalty;
+
+  // The same conditions of a boarding as in GetTransferPenalty().
+  if (!IsEdge(to))
+    return 0.0;
+
+  auto const & edgeTo = GetEdgePT(to);
+  if (edgeTo.IsTransfer() || (IsEdge(from) && GetEdgePT(from).GetLineId() == edgeTo.GetLineId()))
+    return 0.0;
+
+  CHECK(m_raptor, ());
+  auto const waitingTime = m_raptor->GetWaitingTime(edgeTo.GetLineId(), edgeTo.GetStop1Id(), time);
+  return waitingTime ? static_cast<double>(*waitingTime) : penalty;
+}
+
 void TransitGraph::GetTransitEdges(Segment const & segment, bool isOutgoing,
                                    EdgeListT & edges) const
 {
@@ -203,13 +223,16 @@ bool TransitGraph::FindReal(Segment const & fake, Segment & real) const
 }
 
 void TransitGraph::Fill(::transit::experimental::TransitData const & transitData,
-                        Endings const & stopEndings, Endings const & gateEndings)
+                        Endings const & stopEndings, Endings const & gateEndings,
+                        int32_t utcOffsetSeconds)
 {
   CHECK_EQUAL(m_transitVersion, ::transit::TransitVersion::AllPublicTransport, ());
 
   for (auto const & line : transitData.GetLines())
     m_transferPenaltiesPT[line.GetId()] = line.GetSchedule();
 
+  m_raptor = make_shared<TransitRaptor>(transitData, utcOffsetSeconds);
+
   map<transit::StopId, LatLonWithAltitude> stopCoords;
 
   for (auto const & stop : transitData.GetStops())
@@ -18,6 +18,7 @@
 #include "routing_common/num_mwm_id.hpp"
 
 #include <cstdint>
+#include <ctime>
 #include <map>
 #include <memory>
 #include <set>
@@ -26,6 +27,7 @@
 namespace routing
 {
 class IndexGraph;
+class TransitRaptor;
 
 class TransitGraph final
 {
@@ -45,6 +47,13 @@ public:
   LatLonWithAltitude const & GetJunction(Segment const & segment, bool front) const;
   RouteWeight CalcSegmentWeight(Segment const & segment, EdgeEstimator::Purpose purpose) const;
   RouteWeight GetTransferPenalty(Segment const & from, Segment const & to) const;
+  // Returns seconds to wait for the trip at the stop if the route boards a line going from |from|
+  // to |to| and reaches the stop at |time|. The waiting time is derived from the trips of the line
+  // on the day for public transport and it's the transfer penalty if the line has no more trips
+  // or it's the subway version of transit. Returns zero if it's not a boarding.
+  double CalcWaitingTime(Segment const & from, Segment const & to, time_t time) const;
+  // Returns the router over the trips of public transport or nullptr for the subway version.
+  std::shared_ptr<TransitRaptor const> GetRaptor() const { return m_raptor; }
 
   using EdgeListT = SmallList<SegmentEdge>;
   void GetTransitEdges(Segment const & segment, bool isOutgoing,
@@ -52,8 +61,9 @@ public:
   std::set<Segment> const & GetFake(Segment const & real) const;
   bool FindReal(Segment const & fake, Segment & real) const;
 
+  // |utcOffsetSeconds| is the offset of the local time of the schedules from UTC.
   void Fill(::transit::experimental::TransitData const & transitData, Endings const & stopEndings,
-            Endings const & gateEndings);
+            Endings const & gateEndings, int32_t utcOffsetSeconds);
   void Fill(transit::GraphData const & transitData, Endings const & gateEndings);
 
   bool IsGate(Segment const & segment) const;
@@ -112,6 +122,7 @@ private:
   std::map<Segment, ::transit::experimental::Gate> m_segmentToGatePT;
   std::map<Segment, ::transit::experimental::Stop> m_segmentToStopPT;
   std::map<::transit::TransitId, ::transit::Schedule> m_transferPenaltiesPT;
+  std::shared_ptr<TransitRaptor const> m_raptor;
 };
 
 void MakeGateEndings(std::vector<transit::Gate> const & gates, NumMwmId mwmId,
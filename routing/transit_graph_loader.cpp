@@ -10,12 +10,18 @@
 #include "transit/transit_types.hpp"
 #include "transit/transit_version.hpp"
 
+#include "indexer/feature_meta.hpp"
+
 #include "platform/country_file.hpp"
 
 #include "coding/files_container.hpp"
 
+#include "base/logging.hpp"
+#include "base/string_utils.hpp"
 #include "base/timer.hpp"
 
+#include <cmath>
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -24,6 +30,28 @@ using namespace std;
 
 namespace routing
 {
+namespace
+{
+// Returns offset of the local time of |mwmValue| from UTC in seconds. The offset is taken from
+// RegionData::RD_TIMEZONE, which is a number of hours. Schedules are supposed to be in UTC if
+// the mwm has no numeric offset.
+int32_t GetUtcOffsetSeconds(MwmValue const & mwmValue)
+{
+  auto const timezone = mwmValue.GetRegionData().Get(feature::RegionData::RD_TIMEZONE);
+  if (timezone.empty())
+    return 0;
+
+  double hours = 0.0;
+  if (!strings::to_double(timezone, hours) || fabs(hours) > 14.0)
+  {
+    LOG(LWARNING, ("Time zone", timezone, "of", mwmValue.GetCountryFileName(),
+                   "isn't an offset from UTC. Schedules of transit are supposed to be in UTC."));
+    return 0;
+  }
+  return static_cast<int32_t>(lround(hours * 60 * 60));
+}
+}  // namespace
+
 class TransitGraphLoaderImpl : public TransitGraphLoader
 {
 public:
@@ -87,7 +115,7 @@ private:
         TransitGraph::Endings stopEndings;
         MakeStopEndings(transitData.GetStops(), numMwmId, indexGraph, stopEndings);
 
-        graph->Fill(transitData, stopEndings, gateEndings);
+        graph->Fill(transitData, stopEndings, gateEndings, GetUtcOffsetSeconds(mwmValue));
       }
       else
         CHECK(false, (transitHeaderVersion));
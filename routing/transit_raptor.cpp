@@ -0,0 +1,740 @@
+#include "routing/transit_raptor.hpp"
+
+#include "routing/index_router.hpp"
+#include "routing/routing_callbacks.hpp"
+
+#include "geometry/mercator.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+#include "base/timegm.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <tuple>
+#include <utility>
+
+namespace routing
+{
+using namespace std;
+using ::transit::experimental::Line;
+using ::transit::experimental::Stop;
+
+namespace
+{
+uint32_t constexpr kSecondsInDay = 24 * 60 * 60;
+
+uint32_t ToSeconds(::transit::Time const & time)
+{
+  return static_cast<uint32_t>(time.m_hour) * 60 * 60 + static_cast<uint32_t>(time.m_minute) * 60 +
+         time.m_second;
+}
+
+bool IsEqual(::transit::Date const & lhs, ::transit::Date const & rhs)
+{
+  return lhs.m_year == rhs.m_year && lhs.m_month == rhs.m_month && lhs.m_day == rhs.m_day;
+}
+
+// Returns seconds from midnight of the day of |time| in the time zone which is |utcOffsetSeconds|
+// ahead of UTC and sets |date| to the day.
+uint32_t GetSecondsOfDay(time_t time, int32_t utcOffsetSeconds, ::transit::Date & date)
+{
+  time_t const localTime = time + utcOffsetSeconds;
+  tm timeTm = {};
+  gmtime_r(&localTime, &timeTm);
+  date = ::transit::Date(timeTm.tm_year + 1900, timeTm.tm_mon + 1, timeTm.tm_mday);
+  return static_cast<uint32_t>(timeTm.tm_hour * 60 * 60 + timeTm.tm_min * 60 + timeTm.tm_sec);
+}
+
+// Returns frequency intervals of |schedule| for |date| or nullptr if there is no service.
+// |isDefault| is set if the service isn't specified for the date and the default frequency
+// should be used for the whole day. Exceptions and intervals are checked in the same order
+// as in Schedule::GetFrequency(), but there are two differences:
+// * a closed exception means that there is no service on the date, while GetFrequency()
+//   skips it and checks the next exceptions and intervals;
+// * the default frequency is used for schedules without service intervals only, while
+//   GetFrequency() falls back to it for any date out of the exceptions and intervals.
+//   For a schedule with service intervals such a date is out of service.
+::transit::FrequencyIntervals const * GetFrequencies(::transit::Schedule const & schedule,
+                                                     ::transit::Date const & date,
+                                                     uint8_t wdIndex, bool & isDefault)
+{
+  isDefault = false;
+  for (auto const & [dateException, frequencies] : schedule.GetServiceExceptions())
+  {
+    auto const status = dateException.GetExceptionStatus(date);
+    if (status == ::transit::Status::Open)
+      return &frequencies;
+    if (status == ::transit::Status::Closed)
+      return nullptr;
+  }
+
+  for (auto const & [datesInterval, frequencies] : schedule.GetServiceIntervals())
+  {
+    if (datesInterval.GetStatusInInterval(date, wdIndex) == ::transit::Status::Open)
+      return &frequencies;
+  }
+
+  isDefault = schedule.GetServiceIntervals().empty();
+  return nullptr;
+}
+}  // namespace
+
+// TransitRaptor::Query ----------------------------------------------------------------------------
+struct TransitRaptor::Query
+{
+  size_t GetIdx(uint32_t round, uint32_t stop) const { return round * m_stopsNumber + stop; }
+
+  void Mark(uint32_t stop)
+  {
+    if (m_isMarked[stop])
+      return;
+
+    m_isMarked[stop] = true;
+    m_markedStops.push_back(stop);
+  }
+
+  shared_ptr<ServiceDay const> m_day;
+  time_t m_dayStart = 0;
+  // Departure from the origin in seconds of the service day.
+  uint32_t m_departure = 0;
+  // Maximum number of rides.
+  uint32_t m_roundsNumber = 0;
+  size_t m_stopsNumber = 0;
+
+  // Stop indexes and walking times of the access and egress legs.
+  vector<pair<uint32_t, uint32_t>> m_access;
+  vector<pair<uint32_t, uint32_t>> m_egress;
+
+  // Arrival to stop s with at most k rides is |m_arrivals[GetIdx(k, s)]|.
+  vector<uint32_t> m_arrivals;
+  vector<Parent> m_parents;
+  // The best arrivals to stops with any number of rides.
+  vector<uint32_t> m_best;
+  uint32_t m_targetBound = kInfinity;
+
+  vector<bool> m_isMarked;
+  vector<uint32_t> m_markedStops;
+
+  // The first position of a marked stop at touched routes.
+  vector<uint32_t> m_routeFirstPos;
+  vector<uint32_t> m_touchedRoutes;
+};
+
+// TransitRaptor::Journey --------------------------------------------------------------------------
+size_t TransitRaptor::Journey::GetRidesNumber() const
+{
+  return count_if(m_legs.cbegin(), m_legs.cend(), [](Leg const & leg) { return !leg.IsWalk(); });
+}
+
+// TransitRaptor -----------------------------------------------------------------------------------
+TransitRaptor::TransitRaptor(vector<Line> const & lines, vector<Stop> const & stops,
+                             vector<::transit::experimental::Edge> const & edges,
+                             int32_t utcOffsetSeconds)
+  : m_utcOffsetSeconds(utcOffsetSeconds)
+{
+  Build(lines, stops, edges);
+}
+
+TransitRaptor::TransitRaptor(::transit::experimental::TransitData const & data,
+                             int32_t utcOffsetSeconds)
+  : m_utcOffsetSeconds(utcOffsetSeconds)
+{
+  Build(data.GetLines(), data.GetStops(), data.GetEdges());
+}
+
+bool TransitRaptor::FindEarliestArrival(vector<StopTime> const & access,
+                                        vector<StopTime> const & egress, time_t departureTime,
+                                        uint32_t maxTransfers, Journey & journey) const
+{
+  Query query;
+  InitQuery(access, egress, departureTime, maxTransfers, query);
+  Run(query, query.m_departure);
+
+  auto const target = GetTarget(query);
+  if (target.m_arrival == kInfinity)
+    return false;
+
+  journey = MakeJourney(query, target);
+  return true;
+}
+
+void TransitRaptor::FindProfile(vector<StopTime> const & access, vector<StopTime> const & egress,
+                                time_t departureTime, uint32_t windowSeconds,
+                                uint32_t maxTransfers, vector<Journey> & journeys) const
+{
+  journeys.clear();
+
+  Query query;
+  InitQuery(access, egress, departureTime, maxTransfers, query);
+
+  // Departures from the origin to catch every trip at the access stops within the window.
+  int64_t const windowBegin = query.m_departure;
+  int64_t const windowEnd = windowBegin + windowSeconds;
+  vector<uint32_t> departures;
+  for (auto const & [stop, seconds] : query.m_access)
+  {
+    for (uint32_t i = m_stopRoutesBegin[stop]; i < m_stopRoutesBegin[stop + 1]; ++i)
+    {
+      auto const & [route, position] = m_stopRoutes[i];
+      int64_t const shift =
+          static_cast<int64_t>(m_routeOffsets[m_routes[route].m_stopsBegin + position]) - seconds;
+      auto const & day = *query.m_day;
+      for (uint32_t j = day.m_intervalsBegin[route]; j < day.m_intervalsBegin[route + 1]; ++j)
+      {
+        auto const & interval = day.m_intervals[j];
+        int64_t const lower = max<int64_t>(windowBegin - shift, interval.m_start);
+        int64_t const upper = min<int64_t>(windowEnd - shift, interval.m_end);
+        int64_t const tripsBefore =
+            (lower - interval.m_start + interval.m_headway - 1) / interval.m_headway;
+        for (int64_t trip = interval.m_start + tripsBefore * interval.m_headway; trip <= upper;
+             trip += interval.m_headway)
+        {
+          departures.push_back(static_cast<uint32_t>(trip + shift));
+        }
+      }
+    }
+  }
+
+  sort(departures.begin(), departures.end(), greater<uint32_t>());
+  departures.erase(unique(departures.begin(), departures.end()), departures.end());
+
+  uint32_t bestArrival = kInfinity;
+  for (auto const departure : departures)
+  {
+    Run(query, departure);
+    auto const target = GetTarget(query);
+    if (target.m_arrival >= bestArrival)
+      continue;
+
+    bestArrival = target.m_arrival;
+    journeys.push_back(MakeJourney(query, target));
+  }
+
+  reverse(journeys.begin(), journeys.end());
+}
+
+vector<TransitRaptor::StopTime> TransitRaptor::FindAccessLegs(IndexRouter & pedestrianRouter,
+                                                              m2::PointD const & point,
+                                                              double radiusMeters, bool toStops,
+                                                              RouterDelegate const & delegate) const
+{
+  vector<uint32_t> stops;
+  vector<m2::PointD> stopPoints;
+  for (uint32_t stop = 0; stop < m_stopPoints.size(); ++stop)
+  {
+    if (mercator::DistanceOnEarth(point, m_stopPoints[stop]) > radiusMeters)
+      continue;
+
+    stops.push_back(stop);
+    stopPoints.push_back(m_stopPoints[stop]);
+  }
+
+  vector<StopTime> legs;
+  if (stops.empty())
+    return legs;
+
+  vector<m2::PointD> const points = {point};
+  IndexRouter::Matrix matrix;
+  auto const code = toStops ? pedestrianRouter.CalculateMatrix(points, stopPoints, delegate, matrix)
+                            : pedestrianRouter.CalculateMatrix(stopPoints, points, delegate, matrix);
+  if (code != RouterResultCode::NoError)
+  {
+    LOG(LWARNING, ("Walks between", mercator::ToLatLon(point), "and stops aren't found:", code));
+    return legs;
+  }
+
+  for (size_t i = 0; i < stops.size(); ++i)
+  {
+    auto const & route = toStops ? matrix[0][i] : matrix[i][0];
+    if (route.m_code != RouterResultCode::NoError)
+      continue;
+
+    legs.emplace_back(m_stopIds[stops[i]], static_cast<uint32_t>(ceil(route.m_etaSeconds)));
+  }
+  return legs;
+}
+
+optional<uint32_t> TransitRaptor::GetWaitingTime(TransitId lineId, TransitId stopId,
+                                                 time_t time) const
+{
+  auto const routeIt = m_lineRoutes.find(lineId);
+  auto const stopIt = m_stopIdxs.find(stopId);
+  if (routeIt == m_lineRoutes.cend() || stopIt == m_stopIdxs.cend())
+    return {};
+
+  ::transit::Date date;
+  uint32_t const seconds = GetSecondsOfDay(time, m_utcOffsetSeconds, date);
+  auto const day = GetServiceDay(date);
+
+  // A line may pass the stop several times.
+  auto const route = routeIt->second;
+  auto const & info = m_routes[route];
+  uint32_t best = kInfinity;
+  for (uint32_t i = info.m_stopsBegin; i < info.m_stopsBegin + info.m_stopsNumber; ++i)
+  {
+    if (m_routeStops[i] != stopIt->second)
+      continue;
+
+    auto const offset = m_routeOffsets[i];
+    auto const trip = GetEarliestTrip(*day, route, seconds > offset ? seconds - offset : 0);
+    if (trip != kInfinity)
+      best = min(best, trip + offset - seconds);
+  }
+
+  if (best == kInfinity)
+    return {};
+  return best;
+}
+
+void TransitRaptor::Build(vector<Line> const & lines, vector<Stop> const & stops,
+                          vector<::transit::experimental::Edge> const & edges)
+{
+  m_stopIds.reserve(stops.size());
+  m_stopPoints.reserve(stops.size());
+  for (auto const & stop : stops)
+  {
+    if (!m_stopIdxs.emplace(stop.GetId(), static_cast<uint32_t>(m_stopIds.size())).second)
+      continue;
+
+    m_stopIds.push_back(stop.GetId());
+    m_stopPoints.push_back(stop.GetPoint());
+  }
+
+  auto const getStopIdx = [this](TransitId stopId) {
+    auto const it = m_stopIdxs.find(stopId);
+    return it == m_stopIdxs.cend() ? kInvalidIdx : it->second;
+  };
+
+  // Running times between consecutive stops of lines and transfers.
+  map<tuple<TransitId, TransitId, TransitId>, uint32_t> rides;
+  vector<pair<uint32_t, Footpath>> footpaths;
+  for (auto const & edge : edges)
+  {
+    if (edge.IsTransfer())
+    {
+      auto const from = getStopIdx(edge.GetStop1Id());
+      auto const to = getStopIdx(edge.GetStop2Id());
+      if (from != kInvalidIdx && to != kInvalidIdx && from != to)
+        footpaths.emplace_back(from, Footpath{to, edge.GetWeight()});
+      continue;
+    }
+
+    rides.emplace(make_tuple(edge.GetLineId(), edge.GetStop1Id(), edge.GetStop2Id()),
+                  edge.GetWeight());
+  }
+
+  for (auto const & line : lines)
+  {
+    auto const & stopIds = line.GetStopIds();
+    if (stopIds.size() < 2)
+      continue;
+
+    Route route;
+    route.m_lineId = line.GetId();
+    route.m_stopsBegin = static_cast<uint32_t>(m_routeStops.size());
+
+    uint32_t offset = 0;
+    bool isValid = true;
+    for (size_t i = 0; i < stopIds.size(); ++i)
+    {
+      auto const stop = getStopIdx(stopIds[i]);
+      if (stop == kInvalidIdx)
+      {
+        LOG(LWARNING, ("Unknown stop", stopIds[i], "of line", line.GetId()));
+        isValid = false;
+        break;
+      }
+
+      if (i != 0)
+      {
+        auto const it = rides.find(make_tuple(line.GetId(), stopIds[i - 1], stopIds[i]));
+        if (it == rides.cend())
+        {
+          LOG(LWARNING, ("No edge between stops", stopIds[i - 1], stopIds[i], "of line",
+                         line.GetId()));
+          isValid = false;
+          break;
+        }
+        offset += it->second;
+      }
+
+      m_routeStops.push_back(stop);
+      m_routeOffsets.push_back(offset);
+    }
+
+    if (!isValid)
+    {
+      m_routeStops.resize(route.m_stopsBegin);
+      m_routeOffsets.resize(route.m_stopsBegin);
+      continue;
+    }
+
+    route.m_stopsNumber = static_cast<uint32_t>(m_routeStops.size()) - route.m_stopsBegin;
+    m_lineRoutes.emplace(route.m_lineId, static_cast<uint32_t>(m_routes.size()));
+    m_routes.push_back(route);
+    m_schedules.push_back(line.GetSchedule());
+  }
+
+  // Stop to routes and footpaths indexes are laid out as compressed rows.
+  m_stopRoutesBegin.assign(m_stopIds.size() + 1, 0);
+  for (auto const stop : m_routeStops)
+    ++m_stopRoutesBegin[stop + 1];
+  for (size_t i = 1; i < m_stopRoutesBegin.size(); ++i)
+    m_stopRoutesBegin[i] += m_stopRoutesBegin[i - 1];
+
+  m_stopRoutes.resize(m_routeStops.size());
+  vector<uint32_t> filled(m_stopRoutesBegin.cbegin(), m_stopRoutesBegin.cend() - 1);
+  for (uint32_t route = 0; route < m_routes.size(); ++route)
+  {
+    for (uint32_t position = 0; position < m_routes[route].m_stopsNumber; ++position)
+    {
+      auto const stop = m_routeStops[m_routes[route].m_stopsBegin + position];
+      m_stopRoutes[filled[stop]++] = {route, position};
+    }
+  }
+
+  sort(footpaths.begin(), footpaths.end(),
+       [](auto const & lhs, auto const & rhs) { return lhs.first < rhs.first; });
+  m_footpathsBegin.assign(m_stopIds.size() + 1, 0);
+  m_footpaths.reserve(footpaths.size());
+  for (auto const & [from, footpath] : footpaths)
+  {
+    ++m_footpathsBegin[from + 1];
+    m_footpaths.push_back(footpath);
+  }
+  for (size_t i = 1; i < m_footpathsBegin.size(); ++i)
+    m_footpathsBegin[i] += m_footpathsBegin[i - 1];
+
+  LOG(LINFO, ("Transit raptor is built. Stops:", m_stopIds.size(), "routes:", m_routes.size(),
+              "footpaths:", m_footpaths.size()));
+}
+
+shared_ptr<TransitRaptor::ServiceDay const> TransitRaptor::GetServiceDay(
+    ::transit::Date const & date) const
+{
+  lock_guard<mutex> guard(m_serviceDayMutex);
+  if (m_serviceDay && IsEqual(m_serviceDay->m_date, date))
+    return m_serviceDay;
+
+  time_t const dayTime = base::TimeGM(date.m_year, date.m_month, date.m_day, 0, 0, 0);
+  tm dayTm = {};
+  gmtime_r(&dayTime, &dayTm);
+  auto const wdIndex = static_cast<uint8_t>(dayTm.tm_wday);
+
+  auto day = make_shared<ServiceDay>();
+  day->m_date = date;
+  day->m_intervalsBegin.reserve(m_routes.size() + 1);
+  day->m_intervalsBegin.push_back(0);
+  for (auto const & schedule : m_schedules)
+  {
+    bool isDefault = false;
+    auto const * frequencies = GetFrequencies(schedule, date, wdIndex, isDefault);
+    if (frequencies)
+    {
+      for (auto const & [timeInterval, headway] : frequencies->GetFrequencies())
+      {
+        auto const [start, end] = timeInterval.Extract();
+        if (headway != 0)
+          day->m_intervals.push_back({ToSeconds(start), ToSeconds(end), headway});
+      }
+      isDefault = frequencies->GetFrequencies().empty();
+    }
+
+    if (isDefault && schedule.GetFrequency() != ::transit::kDefaultFrequency)
+      day->m_intervals.push_back({0, kSecondsInDay - 1, schedule.GetFrequency()});
+
+    day->m_intervalsBegin.push_back(static_cast<uint32_t>(day->m_intervals.size()));
+  }
+
+  m_serviceDay = day;
+  return day;
+}
+
+uint32_t TransitRaptor::GetEarliestTrip(ServiceDay const & day, uint32_t route,
+                                        uint32_t time) const
+{
+  uint32_t best = kInfinity;
+  for (uint32_t i = day.m_intervalsBegin[route]; i < day.m_intervalsBegin[route + 1]; ++i)
+  {
+    auto const & interval = day.m_intervals[i];
+    if (time <= interval.m_start)
+    {
+      best = min(best, interval.m_start);
+      continue;
+    }
+
+    uint32_t const tripsBefore = (time - interval.m_start + interval.m_headway - 1) / interval.m_headway;
+    uint64_t const trip =
+        interval.m_start + static_cast<uint64_t>(tripsBefore) * interval.m_headway;
+    if (trip <= interval.m_end)
+      best = min(best, static_cast<uint32_t>(trip));
+  }
+  return best;
+}
+
+void TransitRaptor::InitQuery(vector<StopTime> const & access, vector<StopTime> const & egress,
+                              time_t departureTime, uint32_t maxTransfers, Query & query) const
+{
+  ::transit::Date date;
+  query.m_departure = GetSecondsOfDay(departureTime, m_utcOffsetSeconds, date);
+  query.m_dayStart = departureTime - query.m_departure;
+  query.m_day = GetServiceDay(date);
+
+  query.m_roundsNumber = maxTransfers + 1;
+  query.m_stopsNumber = m_stopIds.size();
+
+  auto const toIdxs = [this](vector<StopTime> const & stopTimes,
+                             vector<pair<uint32_t, uint32_t>> & idxs) {
+    for (auto const & stopTime : stopTimes)
+    {
+      auto const it = m_stopIdxs.find(stopTime.m_stopId);
+      if (it != m_stopIdxs.cend())
+        idxs.emplace_back(it->second, stopTime.m_seconds);
+    }
+  };
+  toIdxs(access, query.m_access);
+  toIdxs(egress, query.m_egress);
+
+  size_t const labelsNumber = (query.m_roundsNumber + 1) * query.m_stopsNumber;
+  query.m_arrivals.assign(labelsNumber, kInfinity);
+  query.m_parents.assign(labelsNumber, Parent());
+  query.m_best.assign(query.m_stopsNumber, kInfinity);
+  query.m_isMarked.assign(query.m_stopsNumber, false);
+  query.m_routeFirstPos.assign(m_routes.size(), kInvalidIdx);
+}
+
+void TransitRaptor::Run(Query & query, uint32_t departure) const
+{
+  auto const updateTargetBound = [&query](uint32_t round) {
+    for (auto const & [stop, seconds] : query.m_egress)
+    {
+      auto const arrival = query.m_arrivals[query.GetIdx(round, stop)];
+      if (arrival != kInfinity)
+        query.m_targetBound = min(query.m_targetBound, arrival + seconds);
+    }
+  };
+
+  for (auto const & [stop, seconds] : query.m_access)
+  {
+    uint32_t const arrival = departure + seconds;
+    auto const idx = query.GetIdx(0, stop);
+    if (arrival >= query.m_arrivals[idx])
+      continue;
+
+    query.m_arrivals[idx] = arrival;
+    query.m_parents[idx] = {kInvalidIdx, kInvalidIdx, seconds};
+    query.m_best[stop] = min(query.m_best[stop], arrival);
+    query.Mark(stop);
+  }
+  RelaxFootpaths(query, 0);
+  updateTargetBound(0);
+
+  for (uint32_t round = 1; round <= query.m_roundsNumber && !query.m_markedStops.empty(); ++round)
+  {
+    ScanRoutes(query, round);
+    RelaxFootpaths(query, round);
+    updateTargetBound(round);
+  }
+
+  for (auto const stop : query.m_markedStops)
+    query.m_isMarked[stop] = false;
+  query.m_markedStops.clear();
+}
+
+void TransitRaptor::ScanRoutes(Query & query, uint32_t round) const
+{
+  for (auto const stop : query.m_markedStops)
+  {
+    query.m_isMarked[stop] = false;
+    for (uint32_t i = m_stopRoutesBegin[stop]; i < m_stopRoutesBegin[stop + 1]; ++i)
+    {
+      auto const & [route, position] = m_stopRoutes[i];
+      auto & firstPos = query.m_routeFirstPos[route];
+      if (firstPos == kInvalidIdx)
+        query.m_touchedRoutes.push_back(route);
+      firstPos = min(firstPos, position);
+    }
+  }
+  query.m_markedStops.clear();
+
+  // Journeys with fewer rides are journeys with at most |round| rides too.
+  auto const prevRound = query.GetIdx(round - 1, 0);
+  auto const curRound = query.GetIdx(round, 0);
+  for (size_t stop = 0; stop < query.m_stopsNumber; ++stop)
+  {
+    auto & arrival = query.m_arrivals[curRound + stop];
+    arrival = min(arrival, query.m_arrivals[prevRound + stop]);
+  }
+
+  auto const & day = *query.m_day;
+  for (auto const route : query.m_touchedRoutes)
+  {
+    auto const & info = m_routes[route];
+    uint32_t tripDeparture = kInfinity;
+    uint32_t boardingPos = kInvalidIdx;
+    for (uint32_t position = query.m_routeFirstPos[route]; position < info.m_stopsNumber;
+         ++position)
+    {
+      auto const stop = m_routeStops[info.m_stopsBegin + position];
+      auto const offset = m_routeOffsets[info.m_stopsBegin + position];
+
+      if (tripDeparture != kInfinity)
+      {
+        uint32_t const arrival = tripDeparture + offset;
+        if (arrival < query.m_best[stop] && arrival < query.m_targetBound)
+        {
+          query.m_arrivals[curRound + stop] = arrival;
+          query.m_parents[curRound + stop] = {route, boardingPos, tripDeparture};
+          query.m_best[stop] = arrival;
+          query.Mark(stop);
+        }
+      }
+
+      // An earlier trip may be caught at the stop with fewer rides.
+      auto const prevArrival = query.m_arrivals[prevRound + stop];
+      if (prevArrival == kInfinity ||
+          (tripDeparture != kInfinity && prevArrival >= tripDeparture + offset))
+      {
+        continue;
+      }
+
+      auto const trip = GetEarliestTrip(day, route, prevArrival > offset ? prevArrival - offset : 0);
+      if (trip < tripDeparture)
+      {
+        tripDeparture = trip;
+        boardingPos = position;
+      }
+    }
+    query.m_routeFirstPos[route] = kInvalidIdx;
+  }
+  query.m_touchedRoutes.clear();
+}
+
+void TransitRaptor::RelaxFootpaths(Query & query, uint32_t round) const
+{
+  // Footpaths are relaxed from the stops reached by rides only, transfers are supposed to be
+  // transitively closed.
+  size_t const reachedByRides = query.m_markedStops.size();
+  auto const curRound = query.GetIdx(round, 0);
+  for (size_t i = 0; i < reachedByRides; ++i)
+  {
+    auto const from = query.m_markedStops[i];
+    auto const departure = query.m_arrivals[curRound + from];
+    for (uint32_t j = m_footpathsBegin[from]; j < m_footpathsBegin[from + 1]; ++j)
+    {
+      auto const & footpath = m_footpaths[j];
+      uint32_t const arrival = departure + footpath.m_seconds;
+      if (arrival >= query.m_best[footpath.m_toStop] || arrival >= query.m_targetBound)
+        continue;
+
+      query.m_arrivals[curRound + footpath.m_toStop] = arrival;
+      query.m_parents[curRound + footpath.m_toStop] = {kInvalidIdx, from, footpath.m_seconds};
+      query.m_best[footpath.m_toStop] = arrival;
+      query.Mark(footpath.m_toStop);
+    }
+  }
+}
+
+TransitRaptor::Target TransitRaptor::GetTarget(Query const & query) const
+{
+  Target target;
+  for (uint32_t round = 0; round <= query.m_roundsNumber; ++round)
+  {
+    for (auto const & [stop, seconds] : query.m_egress)
+    {
+      auto const arrival = query.m_arrivals[query.GetIdx(round, stop)];
+      if (arrival == kInfinity || arrival + seconds >= target.m_arrival)
+        continue;
+
+      target.m_arrival = arrival + seconds;
+      target.m_round = round;
+      target.m_stop = stop;
+    }
+  }
+  return target;
+}
+
+TransitRaptor::Journey TransitRaptor::MakeJourney(Query const & query, Target const & target) const
+{
+  CHECK_NOT_EQUAL(target.m_arrival, kInfinity, ());
+
+  Journey journey;
+  journey.m_arrivalTime = query.m_dayStart + target.m_arrival;
+
+  auto const toTime = [&query](uint32_t seconds) { return query.m_dayStart + seconds; };
+
+  uint32_t round = target.m_round;
+  uint32_t stop = target.m_stop;
+  // Every leg decreases the arrival time or the round, so the number of legs is limited.
+  size_t const maxLegsNumber = 2 * (query.m_roundsNumber + 1) * query.m_stopsNumber;
+  while (true)
+  {
+    CHECK_LESS(journey.m_legs.size(), maxLegsNumber, ());
+
+    while (round > 0 && query.m_arrivals[query.GetIdx(round - 1, stop)] <=
+                            query.m_arrivals[query.GetIdx(round, stop)])
+    {
+      --round;
+    }
+
+    auto const idx = query.GetIdx(round, stop);
+    auto const & parent = query.m_parents[idx];
+    if (parent.m_route == kInvalidIdx && parent.m_from == kInvalidIdx)
+    {
+      // Access leg.
+      uint32_t const departure = journey.m_legs.empty() ? query.m_arrivals[idx]
+                                                        : static_cast<uint32_t>(
+                                                              journey.m_legs.back().m_departureTime -
+                                                              query.m_dayStart);
+      journey.m_departureTime = toTime(departure - parent.m_value);
+      break;
+    }
+
+    Leg leg;
+    leg.m_toStopId = m_stopIds[stop];
+    leg.m_arrivalTime = toTime(query.m_arrivals[idx]);
+    if (parent.m_route == kInvalidIdx)
+    {
+      leg.m_fromStopId = m_stopIds[parent.m_from];
+      leg.m_departureTime = toTime(query.m_arrivals[idx] - parent.m_value);
+      stop = parent.m_from;
+    }
+    else
+    {
+      auto const & route = m_routes[parent.m_route];
+      auto const boardingIdx = route.m_stopsBegin + parent.m_from;
+      leg.m_lineId = route.m_lineId;
+      leg.m_fromStopId = m_stopIds[m_routeStops[boardingIdx]];
+      leg.m_departureTime = toTime(parent.m_value + m_routeOffsets[boardingIdx]);
+      stop = m_routeStops[boardingIdx];
+      CHECK_GREATER(round, 0, ());
+      --round;
+    }
+    journey.m_legs.push_back(leg);
+  }
+
+  reverse(journey.m_legs.begin(), journey.m_legs.end());
+  return journey;
+}
+
+string DebugPrint(TransitRaptor::Leg const & leg)
+{
+  ostringstream out;
+  out << "Leg [ line: " << (leg.IsWalk() ? string("walk") : to_string(leg.m_lineId))
+      << ", from: " << leg.m_fromStopId << ", to: " << leg.m_toStopId
+      << ", departure: " << leg.m_departureTime << ", arrival: " << leg.m_arrivalTime << " ]";
+  return out.str();
+}
+
+string DebugPrint(TransitRaptor::Journey const & journey)
+{
+  ostringstream out;
+  out << "Journey [ departure: " << journey.m_departureTime
+      << ", arrival: " << journey.m_arrivalTime << ", legs: " << ::DebugPrint(journey.m_legs)
+      << " ]";
+  return out.str();
+}
+}  // namespace routing
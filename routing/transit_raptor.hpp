@@ -0,0 +1,235 @@
+#pragma once
+
+#include "routing/router_delegate.hpp"
+
+#include "transit/experimental/transit_data.hpp"
+#include "transit/experimental/transit_types_experimental.hpp"
+#include "transit/transit_entities.hpp"
+#include "transit/transit_schedule.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include <cstdint>
+#include <ctime>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace routing
+{
+class IndexRouter;
+
+/// \brief Round-based (RAPTOR) public transit router over the data of transit section.
+/// Lines, their stops, running times and transfers are laid out in flat arrays once at load.
+/// A query scans every line touched in the previous round once per round, so its cost is
+/// proportional to the number of lines and transfers, not to the size of a time-expanded graph.
+/// Round k finds the earliest arrivals at stops with k rides.
+/// \note Transit data keeps headways and not the stop times of trips. So trips are derived from
+/// the frequency intervals of a line for the service day: they depart from the first stop of the
+/// line at start of an interval and every headway after it. Running times between stops are
+/// the weights of the line edges. Service after midnight of the query day isn't taken into
+/// account.
+/// \note Times and dates of the schedules are local times of the network. The network is supposed
+/// to have a constant offset from UTC, daylight saving time isn't taken into account. Days of
+/// queries and trips are taken in this time zone and not in the time zone of the device.
+/// TransitGraph uses the trips to calculate waiting times at boarding stops of transit routes.
+/// \note The class is immutable after construction, queries may be run from several threads.
+class TransitRaptor final
+{
+public:
+  using TransitId = ::transit::TransitId;
+
+  /// \brief Walking time between a point of the journey and a stop.
+  struct StopTime
+  {
+    StopTime() = default;
+    StopTime(TransitId stopId, uint32_t seconds) : m_stopId(stopId), m_seconds(seconds) {}
+
+    TransitId m_stopId = ::transit::kInvalidTransitId;
+    uint32_t m_seconds = 0;
+  };
+
+  /// \brief A ride by a line or a walk between stops if |m_lineId| is kInvalidTransitId.
+  struct Leg
+  {
+    bool IsWalk() const { return m_lineId == ::transit::kInvalidTransitId; }
+
+    TransitId m_lineId = ::transit::kInvalidTransitId;
+    TransitId m_fromStopId = ::transit::kInvalidTransitId;
+    TransitId m_toStopId = ::transit::kInvalidTransitId;
+    time_t m_departureTime = 0;
+    time_t m_arrivalTime = 0;
+  };
+
+  /// \brief Journey from the origin to the destination. |m_departureTime| is the latest time to
+  /// leave the origin to catch the first ride, |m_arrivalTime| is the time of arrival at the
+  /// destination including the egress walk.
+  struct Journey
+  {
+    size_t GetRidesNumber() const;
+
+    time_t m_departureTime = 0;
+    time_t m_arrivalTime = 0;
+    std::vector<Leg> m_legs;
+  };
+
+  static uint32_t constexpr kDefaultMaxTransfers = 4;
+
+  /// \param utcOffsetSeconds offset of the local time of the network from UTC.
+  TransitRaptor(std::vector<::transit::experimental::Line> const & lines,
+                std::vector<::transit::experimental::Stop> const & stops,
+                std::vector<::transit::experimental::Edge> const & edges,
+                int32_t utcOffsetSeconds = 0);
+  explicit TransitRaptor(::transit::experimental::TransitData const & data,
+                         int32_t utcOffsetSeconds = 0);
+
+  /// \brief Finds the journey with the earliest arrival to the destination when the origin is left
+  /// at |departureTime|. Among journeys with the same arrival the one with fewer rides is chosen.
+  /// \param access walking times from the origin to stops.
+  /// \param egress walking times from stops to the destination.
+  /// \returns false if the destination isn't reachable with |maxTransfers| transfers.
+  bool FindEarliestArrival(std::vector<StopTime> const & access,
+                           std::vector<StopTime> const & egress, time_t departureTime,
+                           uint32_t maxTransfers, Journey & journey) const;
+
+  /// \brief Finds all the Pareto optimal journeys by departure and arrival time which leave the
+  /// origin within [|departureTime|, |departureTime| + |windowSeconds|]. Journeys are sorted
+  /// by departure time, later journeys arrive later. rRAPTOR is used: departures are scanned
+  /// from the latest one and labels of later departures prune the earlier ones.
+  void FindProfile(std::vector<StopTime> const & access, std::vector<StopTime> const & egress,
+                   time_t departureTime, uint32_t windowSeconds, uint32_t maxTransfers,
+                   std::vector<Journey> & journeys) const;
+
+  /// \brief Calculates walking times between |point| and the stops within |radiusMeters| by
+  /// |pedestrianRouter|, which may be the transit router as well: its matrix routes are walks.
+  /// The walks are from |point| to the stops if |toStops| and from the stops to |point| otherwise.
+  /// Stops which can't be reached by roads are skipped.
+  std::vector<StopTime> FindAccessLegs(IndexRouter & pedestrianRouter, m2::PointD const & point,
+                                       double radiusMeters, bool toStops,
+                                       RouterDelegate const & delegate) const;
+
+  /// \returns seconds to wait for the earliest trip of line |lineId| at stop |stopId| if
+  /// the stop is reached at |time| or std::nullopt if the line has no more trips at the stop
+  /// on the day of |time|.
+  std::optional<uint32_t> GetWaitingTime(TransitId lineId, TransitId stopId, time_t time) const;
+
+  size_t GetStopsNumber() const { return m_stopIds.size(); }
+  size_t GetRoutesNumber() const { return m_routes.size(); }
+
+private:
+  static uint32_t constexpr kInfinity = std::numeric_limits<uint32_t>::max();
+  static uint32_t constexpr kInvalidIdx = std::numeric_limits<uint32_t>::max();
+
+  struct Route
+  {
+    TransitId m_lineId = ::transit::kInvalidTransitId;
+    // Range of the stops of the route in |m_routeStops| and |m_routeOffsets|.
+    uint32_t m_stopsBegin = 0;
+    uint32_t m_stopsNumber = 0;
+  };
+
+  struct RoutePosition
+  {
+    uint32_t m_route = 0;
+    uint32_t m_position = 0;
+  };
+
+  struct Footpath
+  {
+    uint32_t m_toStop = 0;
+    uint32_t m_seconds = 0;
+  };
+
+  // Trips of a route depart from its first stop at |m_start| + k * |m_headway| <= |m_end|.
+  // Times are in seconds from midnight of the service day.
+  struct ServiceInterval
+  {
+    uint32_t m_start = 0;
+    uint32_t m_end = 0;
+    uint32_t m_headway = 0;
+  };
+
+  // Service intervals of all the routes for a day.
+  struct ServiceDay
+  {
+    ::transit::Date m_date;
+    // Range of the intervals of route i is [m_intervalsBegin[i], m_intervalsBegin[i + 1]).
+    std::vector<uint32_t> m_intervalsBegin;
+    std::vector<ServiceInterval> m_intervals;
+  };
+
+  struct Parent
+  {
+    // Index of the route or kInvalidIdx for a footpath or an access leg.
+    uint32_t m_route = kInvalidIdx;
+    // Position of the boarding stop for a ride, the previous stop for a footpath,
+    // kInvalidIdx for an access leg.
+    uint32_t m_from = kInvalidIdx;
+    // Departure of the trip from the first stop for a ride, walking time for a footpath and
+    // an access leg.
+    uint32_t m_value = 0;
+  };
+
+  // Best arrival to the destination, the round and the stop it's reached from.
+  struct Target
+  {
+    uint32_t m_arrival = kInfinity;
+    uint32_t m_round = 0;
+    uint32_t m_stop = kInvalidIdx;
+  };
+
+  struct Query;
+
+  void Build(std::vector<::transit::experimental::Line> const & lines,
+             std::vector<::transit::experimental::Stop> const & stops,
+             std::vector<::transit::experimental::Edge> const & edges);
+
+  std::shared_ptr<ServiceDay const> GetServiceDay(::transit::Date const & date) const;
+
+  // Returns the earliest departure of |route| trips from its first stop which is not earlier
+  // than |time| or kInfinity.
+  uint32_t GetEarliestTrip(ServiceDay const & day, uint32_t route, uint32_t time) const;
+
+  void InitQuery(std::vector<StopTime> const & access, std::vector<StopTime> const & egress,
+                 time_t departureTime, uint32_t maxTransfers, Query & query) const;
+  // Runs the rounds for the departure from the origin at |departure| seconds of the service day.
+  // Labels of the previous runs of |query| are kept.
+  void Run(Query & query, uint32_t departure) const;
+  void ScanRoutes(Query & query, uint32_t round) const;
+  void RelaxFootpaths(Query & query, uint32_t round) const;
+  Target GetTarget(Query const & query) const;
+  Journey MakeJourney(Query const & query, Target const & target) const;
+
+  int32_t m_utcOffsetSeconds = 0;
+
+  std::vector<TransitId> m_stopIds;
+  std::vector<m2::PointD> m_stopPoints;
+  std::unordered_map<TransitId, uint32_t> m_stopIdxs;
+
+  std::vector<Route> m_routes;
+  std::unordered_map<TransitId, uint32_t> m_lineRoutes;
+  std::vector<::transit::Schedule> m_schedules;
+  std::vector<uint32_t> m_routeStops;
+  // Running time from the first stop of the route to the stop in seconds.
+  std::vector<uint32_t> m_routeOffsets;
+
+  // Routes passing through stop i are [m_stopRoutesBegin[i], m_stopRoutesBegin[i + 1]).
+  std::vector<uint32_t> m_stopRoutesBegin;
+  std::vector<RoutePosition> m_stopRoutes;
+
+  // Transfers from stop i are [m_footpathsBegin[i], m_footpathsBegin[i + 1]).
+  std::vector<uint32_t> m_footpathsBegin;
+  std::vector<Footpath> m_footpaths;
+
+  // Service intervals are calculated once per day and shared by the queries of the day.
+  mutable std::mutex m_serviceDayMutex;
+  mutable std::shared_ptr<ServiceDay const> m_serviceDay;
+};
+
+std::string DebugPrint(TransitRaptor::Leg const & leg);
+std::string DebugPrint(TransitRaptor::Journey const & journey);
+}  // namespace routing
@@ -171,6 +171,20 @@ double TransitWorldGraph::CalculateETAWithoutPenalty(Segment const & segment)
       EdgeEstimator::Purpose::ETA);
 }
 
+double TransitWorldGraph::CalcTransitWaitingTime(Segment const & from, Segment const & to,
+                                                 time_t time)
+{
+  if (!TransitGraph::IsTransitSegment(to))
+    return 0.0;
+
+  return GetTransitGraph(to.GetMwmId()).CalcWaitingTime(from, to, time);
+}
+
+shared_ptr<TransitRaptor const> TransitWorldGraph::GetTransitRaptor(NumMwmId mwmId)
+{
+  return GetTransitGraph(mwmId).GetRaptor();
+}
+
 unique_ptr<TransitInfo> TransitWorldGraph::GetTransitInfo(Segment const & segment)
 {
   if (!TransitGraph::IsTransitSegment(segment))
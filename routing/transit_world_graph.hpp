@@ -68,6 +68,8 @@ public:
                                 EdgeEstimator::Purpose purpose) const override;
   double CalculateETA(Segment const & from, Segment const & to) override;
   double CalculateETAWithoutPenalty(Segment const & segment) override;
+  double CalcTransitWaitingTime(Segment const & from, Segment const & to, time_t time) override;
+  std::shared_ptr<TransitRaptor const> GetTransitRaptor(NumMwmId mwmId) override;
 
   std::unique_ptr<TransitInfo> GetTransitInfo(Segment const & segment) override;
 
@@ -53,6 +53,22 @@ SpeedInUnits WorldGraph::GetSpeedLimit(Segment const &)
   return {};
 }
 
+double WorldGraph::CalcETAFactor(Segment const & /* segment */, double /* secondsFromDeparture */)
+{
+  return 1.0;
+}
+
+double WorldGraph::CalcTransitWaitingTime(Segment const & /* from */, Segment const & /* to */,
+                                          time_t /* time */)
+{
+  return 0.0;
+}
+
+std::shared_ptr<TransitRaptor const> WorldGraph::GetTransitRaptor(NumMwmId /* mwmId */)
+{
+  return nullptr;
+}
+
 void WorldGraph::SetAStarParents(bool forward, Parents<Segment> & parents) {}
 void WorldGraph::SetAStarParents(bool forward, Parents<JointSegment> & parents) {}
 void WorldGraph::DropAStarParents() {}
@@ -16,6 +16,7 @@
 #include "geometry/point2d.hpp"
 #include "geometry/point_with_altitude.hpp"
 
+#include <ctime>
 #include <functional>
 #include <memory>
 #include <set>
@@ -25,6 +26,7 @@
 namespace routing
 {
 class CrossMwmGraph;
+class TransitRaptor;
 
 enum class WorldGraphMode
 {
@@ -95,6 +97,14 @@ public:
 
   virtual double CalculateETA(Segment const & from, Segment const & to) = 0;
   virtual double CalculateETAWithoutPenalty(Segment const & segment) = 0;
+  /// \returns factor of CalculateETAWithoutPenalty() of |segment| which is entered
+  /// |secondsFromDeparture| seconds after the departure, see EdgeEstimator::CalcTimeFactor().
+  virtual double CalcETAFactor(Segment const & segment, double secondsFromDeparture);
+  /// \returns seconds to wait for public transport at |time| going from |from| to |to|.
+  virtual double CalcTransitWaitingTime(Segment const & from, Segment const & to, time_t time);
+  /// \returns the router over the trips of public transport of |mwmId| or nullptr if there are
+  /// no trips in the mwm.
+  virtual std::shared_ptr<TransitRaptor const> GetTransitRaptor(NumMwmId mwmId);
 
   using TransitionFnT = std::function<void(Segment const &)>;
   virtual void ForEachTransition(NumMwmId numMwmId, bool isEnter, TransitionFnT const & fn);
@@ -0,0 +1,408 @@
+#include "search/address_index.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include "coding/files_container.hpp"
+#include "coding/succinct_mapper.hpp"
+#include "coding/varint.hpp"
+#include "coding/writer.hpp"
+
+#include "geometry/mercator.hpp"
+
+#include "base/bits.hpp"
+#include "base/checked_cast.hpp"
+#include "base/logging.hpp"
+#include "base/math.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <unordered_set>
+#include <utility>
+
+#include "defines.hpp"
+
+using namespace std;
+
+namespace search
+{
+namespace
+{
+uint32_t constexpr kMaxCoord = (1U << kPointCoordBits) - 1;
+
+double GetDistanceMeters(m2::PointD const & center, m2::RectD const & rect)
+{
+  m2::PointD const closest(base::Clamp(center.x, rect.minX(), rect.maxX()),
+                           base::Clamp(center.y, rect.minY(), rect.maxY()));
+  return mercator::DistanceOnEarth(center, closest);
+}
+
+m2::PointU GetCellOrigin(uint64_t cellId)
+{
+  uint32_t x, y;
+  bits::BitwiseSplit(cellId, x, y);
+  return {x << AddressIndex::kCellShift, y << AddressIndex::kCellShift};
+}
+
+// A cell which is not read yet or an entry which is not visited yet.
+struct Candidate
+{
+  Candidate(double distanceM, uint64_t cellId) : m_distanceM(distanceM), m_cellId(cellId) {}
+  Candidate(double distanceM, AddressIndex::Entry const & entry)
+    : m_distanceM(distanceM), m_isCell(false), m_entry(entry)
+  {
+  }
+
+  bool operator>(Candidate const & rhs) const
+  {
+    if (m_distanceM != rhs.m_distanceM)
+      return m_distanceM > rhs.m_distanceM;
+    // Entries go before cells of the same distance.
+    if (m_isCell != rhs.m_isCell)
+      return m_isCell;
+    if (m_isCell)
+      return m_cellId > rhs.m_cellId;
+    return m_entry.m_buildingId > rhs.m_entry.m_buildingId;
+  }
+
+  double m_distanceM = 0.0;
+  bool m_isCell = true;
+  uint64_t m_cellId = 0;
+  AddressIndex::Entry m_entry;
+};
+}  // namespace
+
+// AddressIndex::Header ----------------------------------------------------------------------------
+void AddressIndex::Header::Read(Reader const & reader)
+{
+  NonOwningReaderSource source(reader);
+  m_version = static_cast<Version>(ReadPrimitiveFromSource<uint8_t>(source));
+  m_cellsOffset = ReadPrimitiveFromSource<uint32_t>(source);
+  m_cellsSize = ReadPrimitiveFromSource<uint32_t>(source);
+  m_blocksOffset = ReadPrimitiveFromSource<uint32_t>(source);
+  m_blocksSize = ReadPrimitiveFromSource<uint32_t>(source);
+}
+
+// AddressIndex ------------------------------------------------------------------------------------
+// static
+unique_ptr<AddressIndex> AddressIndex::Load(MwmValue const & value)
+{
+  if (!value.m_cont.IsExist(SEARCH_ADDRESS_INDEX_FILE_TAG))
+    return {};
+
+  FilesContainerR::TReader reader = value.m_cont.GetReader(SEARCH_ADDRESS_INDEX_FILE_TAG);
+  ASSERT(reader.GetPtr(), ("Can't get", SEARCH_ADDRESS_INDEX_FILE_TAG, "section reader."));
+  return Load(*reader.GetPtr());
+}
+
+// static
+unique_ptr<AddressIndex> AddressIndex::Load(Reader const & reader)
+{
+  Header header;
+  header.Read(reader);
+  // An mwm may be built with a newer format, the old way of reverse geocoding is used then.
+  if (header.m_version != Version::V0)
+  {
+    LOG(LWARNING, ("Unknown address index version:", static_cast<uint32_t>(header.m_version)));
+    return {};
+  }
+  CHECK_EQUAL(header.m_cellsSize % kCellRecordSize, 0, ());
+
+  unique_ptr<AddressIndex> index(new AddressIndex());
+  index->m_cellsReader = reader.CreateSubReader(header.m_cellsOffset, header.m_cellsSize);
+  index->m_blocksReader = reader.CreateSubReader(header.m_blocksOffset, header.m_blocksSize);
+  CHECK(index->m_cellsReader && index->m_blocksReader, ());
+  index->m_numCells = header.m_cellsSize / kCellRecordSize;
+  return index;
+}
+
+// static
+uint64_t AddressIndex::GetCellId(uint32_t x, uint32_t y)
+{
+  ASSERT_LESS(x, 1U << kCellLevel, ());
+  ASSERT_LESS(y, 1U << kCellLevel, ());
+  return bits::BitwiseMerge(x, y);
+}
+
+// static
+m2::RectD AddressIndex::GetCellRect(uint64_t cellId)
+{
+  auto const origin = GetCellOrigin(cellId);
+  uint32_t const size = 1U << kCellShift;
+  return m2::RectD(PointUToPointD(origin, kPointCoordBits),
+                   PointUToPointD(m2::PointU(origin.x + size, origin.y + size), kPointCoordBits));
+}
+
+void AddressIndex::ForEachByDistance(m2::PointD const & center, double maxDistanceM,
+                                     Visitor const & visitor) const
+{
+  // Best-first search: a cell is read only when it may contain an entry which is
+  // closer than all entries which are not visited yet. An entry is put into all cells
+  // which its rect intersects, so the cell distance is not greater than the distance
+  // of any entry which isn't read from closer cells.
+  priority_queue<Candidate, vector<Candidate>, greater<Candidate>> queue;
+
+  auto const rect = mercator::RectByCenterXYAndSizeInMeters(center, maxDistanceM);
+  auto const minCell = PointDToPointU(rect.LeftBottom(), kPointCoordBits);
+  auto const maxCell = PointDToPointU(rect.RightTop(), kPointCoordBits);
+  for (uint32_t x = minCell.x >> kCellShift; x <= maxCell.x >> kCellShift; ++x)
+  {
+    for (uint32_t y = minCell.y >> kCellShift; y <= maxCell.y >> kCellShift; ++y)
+    {
+      auto const cellId = GetCellId(x, y);
+      auto const distance = GetDistanceMeters(center, GetCellRect(cellId));
+      if (distance <= maxDistanceM)
+        queue.emplace(distance, cellId);
+    }
+  }
+
+  vector<Entry> entries;
+  unordered_set<uint32_t> seen;
+  while (!queue.empty())
+  {
+    Candidate const candidate = queue.top();
+    queue.pop();
+
+    if (!candidate.m_isCell)
+    {
+      if (!visitor(candidate.m_entry, candidate.m_distanceM))
+        return;
+      continue;
+    }
+
+    entries.clear();
+    if (!ReadCell(candidate.m_cellId, entries))
+      continue;
+
+    for (auto const & entry : entries)
+    {
+      if (!seen.insert(entry.m_buildingId).second)
+        continue;
+      auto const distance = GetDistanceMeters(center, entry.m_rect);
+      if (distance <= maxDistanceM)
+        queue.emplace(distance, entry);
+    }
+  }
+}
+
+bool AddressIndex::ReadCell(uint64_t cellId, vector<Entry> & entries) const
+{
+  auto const readCellId = [this](size_t i)
+  {
+    return ReadPrimitiveFromPos<uint64_t>(*m_cellsReader, i * kCellRecordSize);
+  };
+  auto const readOffset = [this](size_t i)
+  {
+    return ReadPrimitiveFromPos<uint32_t>(*m_cellsReader, i * kCellRecordSize + sizeof(uint64_t));
+  };
+
+  size_t lo = 0;
+  size_t hi = m_numCells;
+  while (lo < hi)
+  {
+    size_t const mid = lo + (hi - lo) / 2;
+    if (readCellId(mid) < cellId)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  if (lo == m_numCells || readCellId(lo) != cellId)
+    return false;
+
+  uint64_t const begin = readOffset(lo);
+  uint64_t const end = lo + 1 < m_numCells ? readOffset(lo + 1) : m_blocksReader->Size();
+  NonOwningReaderSource source(*m_blocksReader, begin, end);
+
+  auto const origin = GetCellOrigin(cellId);
+  auto const count = ReadVarUint<uint32_t>(source);
+  entries.reserve(entries.size() + count);
+
+  uint32_t buildingId = 0;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    Entry entry;
+    buildingId += ReadVarUint<uint32_t>(source);
+    entry.m_buildingId = buildingId;
+    entry.m_streetId = base::asserted_cast<uint32_t>(static_cast<int64_t>(buildingId) +
+                                                     ReadVarInt<int64_t>(source));
+
+    m2::PointU min;
+    min.x = base::asserted_cast<uint32_t>(origin.x + ReadVarInt<int64_t>(source));
+    min.y = base::asserted_cast<uint32_t>(origin.y + ReadVarInt<int64_t>(source));
+    m2::PointU max = min;
+    max.x += ReadVarUint<uint32_t>(source);
+    max.y += ReadVarUint<uint32_t>(source);
+    entry.m_rect = m2::RectD(PointUToPointD(min, kPointCoordBits),
+                             PointUToPointD(max, kPointCoordBits));
+
+    entries.push_back(entry);
+  }
+  return true;
+}
+
+// AddressIndexCache -------------------------------------------------------------------------------
+// static
+AddressIndexCache & AddressIndexCache::Instance()
+{
+  static AddressIndexCache instance;
+  return instance;
+}
+
+shared_ptr<AddressIndex const> AddressIndexCache::Get(MwmSet const & mwmSet,
+                                                      MwmSet::MwmId const & id)
+{
+  {
+    lock_guard<mutex> lock(m_mu);
+    auto const it = m_indices.find(id);
+    if (it != m_indices.end())
+      return it->second;
+  }
+
+  auto const handle = mwmSet.GetMwmHandleById(id);
+  if (!handle.IsAlive())
+    return {};
+
+  shared_ptr<AddressIndex const> index = AddressIndex::Load(*handle.GetValue());
+
+  lock_guard<mutex> lock(m_mu);
+  for (auto it = m_indices.begin(); it != m_indices.end();)
+  {
+    if (!it->first.IsAlive())
+      it = m_indices.erase(it);
+    else
+      ++it;
+  }
+
+  // Another thread may have loaded the same index in the meantime.
+  return m_indices.emplace(id, move(index)).first->second;
+}
+
+void AddressIndexCache::Clear()
+{
+  lock_guard<mutex> lock(m_mu);
+  m_indices.clear();
+}
+
+size_t AddressIndexCache::GetNumEntries() const
+{
+  lock_guard<mutex> lock(m_mu);
+  return m_indices.size();
+}
+
+void AddressIndexCache::OnMapDeregistered(platform::LocalCountryFile const & localFile)
+{
+  lock_guard<mutex> lock(m_mu);
+  for (auto it = m_indices.begin(); it != m_indices.end();)
+  {
+    if (!it->first.IsAlive() || it->first.IsDeregistered(localFile))
+      it = m_indices.erase(it);
+    else
+      ++it;
+  }
+}
+
+// AddressIndexBuilder -----------------------------------------------------------------------------
+void AddressIndexBuilder::Put(uint32_t buildingId, uint32_t streetId, m2::RectD const & rect)
+{
+  // Rects are extended by a unit of coding, so decoded rects cover buildings despite rounding.
+  Building building;
+  building.m_buildingId = buildingId;
+  building.m_streetId = streetId;
+  building.m_min = PointDToPointU(rect.LeftBottom(), kPointCoordBits);
+  building.m_max = PointDToPointU(rect.RightTop(), kPointCoordBits);
+  building.m_min.x = building.m_min.x > 0 ? building.m_min.x - 1 : 0;
+  building.m_min.y = building.m_min.y > 0 ? building.m_min.y - 1 : 0;
+  building.m_max.x = min(building.m_max.x + 1, kMaxCoord);
+  building.m_max.y = min(building.m_max.y + 1, kMaxCoord);
+  m_buildings.push_back(building);
+}
+
+void AddressIndexBuilder::Freeze(Writer & writer) const
+{
+  // Pairs of cell ids and indices of buildings.
+  vector<pair<uint64_t, size_t>> cells;
+  for (size_t i = 0; i < m_buildings.size(); ++i)
+  {
+    auto const & b = m_buildings[i];
+    for (uint32_t x = b.m_min.x >> AddressIndex::kCellShift;
+         x <= b.m_max.x >> AddressIndex::kCellShift; ++x)
+    {
+      for (uint32_t y = b.m_min.y >> AddressIndex::kCellShift;
+           y <= b.m_max.y >> AddressIndex::kCellShift; ++y)
+      {
+        cells.emplace_back(AddressIndex::GetCellId(x, y), i);
+      }
+    }
+  }
+  sort(cells.begin(), cells.end(), [this](auto const & lhs, auto const & rhs)
+  {
+    if (lhs.first != rhs.first)
+      return lhs.first < rhs.first;
+    return m_buildings[lhs.second].m_buildingId < m_buildings[rhs.second].m_buildingId;
+  });
+
+  // Blocks are written to memory first because the cells array with offsets of
+  // blocks goes before blocks.
+  vector<uint8_t> blocks;
+  vector<pair<uint64_t, uint32_t>> offsets;
+  {
+    MemWriter<vector<uint8_t>> blocksWriter(blocks);
+    for (size_t begin = 0; begin < cells.size();)
+    {
+      uint64_t const cellId = cells[begin].first;
+      size_t end = begin;
+      while (end < cells.size() && cells[end].first == cellId)
+        ++end;
+
+      offsets.emplace_back(cellId, base::asserted_cast<uint32_t>(blocksWriter.Pos()));
+      auto const origin = GetCellOrigin(cellId);
+
+      WriteVarUint(blocksWriter, base::asserted_cast<uint32_t>(end - begin));
+      uint32_t prevBuildingId = 0;
+      for (size_t i = begin; i < end; ++i)
+      {
+        auto const & b = m_buildings[cells[i].second];
+        CHECK(i == begin || b.m_buildingId > prevBuildingId,
+              ("Duplicating building", b.m_buildingId));
+        WriteVarUint(blocksWriter, b.m_buildingId - prevBuildingId);
+        WriteVarInt(blocksWriter,
+                    static_cast<int64_t>(b.m_streetId) - static_cast<int64_t>(b.m_buildingId));
+        WriteVarInt(blocksWriter, static_cast<int64_t>(b.m_min.x) - static_cast<int64_t>(origin.x));
+        WriteVarInt(blocksWriter, static_cast<int64_t>(b.m_min.y) - static_cast<int64_t>(origin.y));
+        WriteVarUint(blocksWriter, b.m_max.x - b.m_min.x);
+        WriteVarUint(blocksWriter, b.m_max.y - b.m_min.y);
+        prevBuildingId = b.m_buildingId;
+      }
+      begin = end;
+    }
+  }
+
+  uint64_t const startOffset = writer.Pos();
+  CHECK(coding::IsAlign8(startOffset), ());
+
+  AddressIndex::Header header;
+  header.Serialize(writer);
+
+  uint64_t bytesWritten = writer.Pos();
+  coding::WritePadding(writer, bytesWritten);
+
+  header.m_cellsOffset = base::asserted_cast<uint32_t>(writer.Pos() - startOffset);
+  for (auto const & offset : offsets)
+  {
+    WriteToSink(writer, offset.first);
+    WriteToSink(writer, offset.second);
+  }
+  header.m_cellsSize =
+      base::asserted_cast<uint32_t>(writer.Pos() - header.m_cellsOffset - startOffset);
+
+  header.m_blocksOffset = base::asserted_cast<uint32_t>(writer.Pos() - startOffset);
+  writer.Write(blocks.data(), blocks.size());
+  header.m_blocksSize =
+      base::asserted_cast<uint32_t>(writer.Pos() - header.m_blocksOffset - startOffset);
+
+  auto const endOffset = writer.Pos();
+  writer.Seek(startOffset);
+  header.Serialize(writer);
+  writer.Seek(endOffset);
+}
+}  // namespace search
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "indexer/mwm_set.hpp"
+
+#include "coding/point_coding.hpp"
+#include "coding/reader.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "geometry/point2d.hpp"
+#include "geometry/rect2d.hpp"
+
+#include "base/assert.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class Writer;
+
+namespace search
+{
+// Spatial index of addresses of buildings of an mwm. Buildings which
+// have house numbers and streets in HouseToStreetTable are grouped
+// by cells of a fixed grid. For every cell there is a compact block
+// with ids of buildings, ids of their streets and limit rects of
+// buildings, so the nearest address to a point is found by reading a
+// few blocks and a few features without any geometric search of
+// buildings and streets.
+//
+// Section layout:
+// * header;
+// * sorted array of cells, each cell is a fixed size record
+//   <cell id, offset of the cell block>;
+// * cell blocks.
+class AddressIndex
+{
+public:
+  enum class Version : uint8_t
+  {
+    V0 = 0,
+    Latest = V0
+  };
+
+  struct Header
+  {
+    template <typename Sink>
+    void Serialize(Sink & sink) const
+    {
+      CHECK_EQUAL(static_cast<uint8_t>(m_version), static_cast<uint8_t>(Version::V0), ());
+      WriteToSink(sink, static_cast<uint8_t>(m_version));
+      WriteToSink(sink, m_cellsOffset);
+      WriteToSink(sink, m_cellsSize);
+      WriteToSink(sink, m_blocksOffset);
+      WriteToSink(sink, m_blocksSize);
+    }
+
+    void Read(Reader const & reader);
+
+    Version m_version = Version::Latest;
+    // All offsets are relative to the start of the section (offset of header is zero).
+    uint32_t m_cellsOffset = 0;
+    uint32_t m_cellsSize = 0;
+    uint32_t m_blocksOffset = 0;
+    uint32_t m_blocksSize = 0;
+  };
+
+  struct Entry
+  {
+    uint32_t m_buildingId = 0;
+    uint32_t m_streetId = 0;
+    m2::RectD m_rect;
+  };
+
+  // Returns false to stop the visiting.
+  using Visitor = std::function<bool(Entry const & entry, double distanceM)>;
+
+  // Cells are squares of the grid of PointU coordinates. Side of a
+  // cell is about 300m on the equator.
+  static uint8_t constexpr kCellLevel = 17;
+  static uint8_t constexpr kCellShift = kPointCoordBits - kCellLevel;
+  static size_t constexpr kCellRecordSize = sizeof(uint64_t) + sizeof(uint32_t);
+
+  // Returns nullptr when there is no address index in the mwm or the
+  // index has an unknown version.
+  static std::unique_ptr<AddressIndex> Load(MwmValue const & value);
+  static std::unique_ptr<AddressIndex> Load(Reader const & reader);
+
+  static uint64_t GetCellId(uint32_t x, uint32_t y);
+  static m2::RectD GetCellRect(uint64_t cellId);
+
+  // Visits entries which are at most |maxDistanceM| far from |center| in
+  // non-decreasing order of distances from |center| to their limit rects.
+  // Every entry is visited once, so the distance to a limit rect is a lower
+  // bound of distances to the current and all next buildings.
+  void ForEachByDistance(m2::PointD const & center, double maxDistanceM,
+                         Visitor const & visitor) const;
+
+  size_t GetNumCells() const { return m_numCells; }
+
+private:
+  AddressIndex() = default;
+
+  // Returns false when there is no cell |cellId| in the index.
+  bool ReadCell(uint64_t cellId, std::vector<Entry> & entries) const;
+
+  std::unique_ptr<Reader> m_cellsReader;
+  std::unique_ptr<Reader> m_blocksReader;
+  size_t m_numCells = 0;
+};
+
+// Address indices of mwms which are shared by all reverse geocoders,
+// so the section of an mwm is loaded once. Indices of deregistered
+// mwms are dropped when the mwm set notifies about deregistration, and
+// entries of dead mwms of other mwm sets are dropped on the next miss.
+//
+// *NOTE* This class is thread-safe.
+class AddressIndexCache : public MwmSet::Observer
+{
+public:
+  static AddressIndexCache & Instance();
+
+  // Returns nullptr when mwm |id| is not alive or has no address index.
+  std::shared_ptr<AddressIndex const> Get(MwmSet const & mwmSet, MwmSet::MwmId const & id);
+
+  void Clear();
+  size_t GetNumEntries() const;
+
+  // MwmSet::Observer overrides:
+  void OnMapDeregistered(platform::LocalCountryFile const & localFile) override;
+
+private:
+  std::map<MwmSet::MwmId, std::shared_ptr<AddressIndex const>> m_indices;
+  mutable std::mutex m_mu;
+};
+
+class AddressIndexBuilder
+{
+public:
+  // |rect| is the limit rect of the building |buildingId|.
+  void Put(uint32_t buildingId, uint32_t streetId, m2::RectD const & rect);
+  void Freeze(Writer & writer) const;
+
+  size_t GetNumBuildings() const { return m_buildings.size(); }
+
+private:
+  struct Building
+  {
+    uint32_t m_buildingId = 0;
+    uint32_t m_streetId = 0;
+    m2::PointU m_min;
+    m2::PointU m_max;
+  };
+
+  std::vector<Building> m_buildings;
+};
+}  // namespace search
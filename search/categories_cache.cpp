@@ -3,6 +3,7 @@
 #include "search/mwm_context.hpp"
 #include "search/query_params.hpp"
 #include "search/retrieval.hpp"
+#include "search/shared_features_cache.hpp"
 
 #include "indexer/classificator.hpp"
 #include "indexer/ftypes_matcher.hpp"
@@ -11,6 +12,8 @@
 #include "base/assert.hpp"
 #include "base/levenshtein_dfa.hpp"
 
+#include <algorithm>
+
 using namespace std;
 
 namespace search
@@ -26,11 +29,30 @@ CBV CategoriesCache::Get(MwmContext const & context)
   if (it != m_cache.cend())
     return it->second;
 
-  auto const cbv = Load(context);
+  CBV cbv;
+  if (!m_sharedCache)
+  {
+    cbv = Load(context);
+  }
+  else if (!m_sharedCache->GetCategories(id, m_sharedKey, cbv))
+  {
+    auto const generation = m_sharedCache->GetGeneration();
+    cbv = Load(context);
+    m_sharedCache->PutCategories(id, m_sharedKey, cbv, generation);
+  }
   m_cache[id] = cbv;
   return cbv;
 }
 
+void CategoriesCache::SetSharedCache(SharedFeaturesCache * sharedCache)
+{
+  m_sharedCache = sharedCache;
+
+  m_sharedKey.clear();
+  m_categories.ForEach([this](uint32_t type) { m_sharedKey.push_back(type); });
+  sort(m_sharedKey.begin(), m_sharedKey.end());
+}
+
 CBV CategoriesCache::Load(MwmContext const & context) const
 {
   ASSERT(context.m_handle.IsAlive(), ());
@@ -14,6 +14,7 @@
 namespace search
 {
 class MwmContext;
+class SharedFeaturesCache;
 
 class CategoriesCache
 {
@@ -38,12 +39,20 @@ public:
 
   inline void Clear() { m_cache.clear(); }
 
+  // Features which are not in the own cache are looked up in |sharedCache| and
+  // loaded features are put there. |sharedCache| may be nullptr.
+  void SetSharedCache(SharedFeaturesCache * sharedCache);
+
 private:
   CBV Load(MwmContext const & context) const;
 
   CategoriesSet m_categories;
   base::Cancellable const & m_cancellable;
   std::map<MwmSet::MwmId, CBV> m_cache;
+
+  SharedFeaturesCache * m_sharedCache = nullptr;
+  // Sorted types of |m_categories|, a key in |m_sharedCache|.
+  std::vector<uint32_t> m_sharedKey;
 };
 
 class StreetsCache : public CategoriesCache
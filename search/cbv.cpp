@@ -1,8 +1,5 @@
 #include "search/cbv.hpp"
 
-#include <limits>
-#include <vector>
-
 using namespace std;
 
 namespace search
@@ -93,25 +90,69 @@ CBV CBV::Intersect(CBV const & rhs) const
   return CBV(coding::CompressedBitVector::Intersect(*m_p, *rhs.m_p));
 }
 
+CBV & CBV::UnionWith(CBV const & rhs)
+{
+  if (IsFull() || rhs.IsEmpty() || m_p.Get() == rhs.m_p.Get())
+    return *this;
+  if (IsEmpty() || rhs.IsFull())
+    return *this = rhs;
+
+  if (auto * chunked = GetOwnChunked())
+  {
+    unique_ptr<coding::ChunkedCBV> buffer;
+    chunked->UnionWith(coding::ChunkedCBV::AsChunked(*rhs.m_p, buffer));
+    return *this;
+  }
+  return *this = Union(rhs);
+}
+
+CBV & CBV::IntersectWith(CBV const & rhs)
+{
+  if (IsFull() || rhs.IsEmpty())
+    return *this = rhs;
+  if (IsEmpty() || rhs.IsFull() || m_p.Get() == rhs.m_p.Get())
+    return *this;
+
+  if (auto * chunked = GetOwnChunked())
+  {
+    unique_ptr<coding::ChunkedCBV> buffer;
+    chunked->IntersectWith(coding::ChunkedCBV::AsChunked(*rhs.m_p, buffer));
+    return *this;
+  }
+  return *this = Intersect(rhs);
+}
+
+uint64_t CBV::IntersectionPopCount(CBV const & rhs) const
+{
+  if (IsFull())
+    return rhs.PopCount();
+  if (rhs.IsFull())
+    return PopCount();
+  if (IsEmpty() || rhs.IsEmpty())
+    return 0;
+  return coding::CompressedBitVector::IntersectionPopCount(*m_p, *rhs.m_p);
+}
+
 CBV CBV::Take(uint64_t n) const
 {
   if (IsEmpty())
     return *this;
   if (IsFull())
-  {
-    vector<uint64_t> groups(static_cast<size_t>((n + 63) / 64), numeric_limits<uint64_t>::max());
-    uint64_t const r = n % 64;
-    if (r != 0)
-    {
-      ASSERT(!groups.empty(), ());
-      groups.back() = (static_cast<uint64_t>(1) << r) - 1;
-    }
-    return CBV(coding::DenseCBV::BuildFromBitGroups(move(groups)));
-  }
+    return CBV(coding::ChunkedCBV::BuildFromRange(0 /* begin */, n /* end */));
 
   return CBV(m_p->LeaveFirstSetNBits(n));
 }
 
+coding::ChunkedCBV * CBV::GetOwnChunked()
+{
+  if (!m_p || m_p->NumRefs() != 1 ||
+      m_p->GetStorageStrategy() != coding::CompressedBitVector::StorageStrategy::Chunked)
+  {
+    return nullptr;
+  }
+  return static_cast<coding::ChunkedCBV *>(m_p.Get());
+}
+
 uint64_t CBV::Hash() const
 {
   if (IsEmpty())
@@ -120,4 +161,36 @@ uint64_t CBV::Hash() const
     return kModulo;
   return coding::CompressedBitVectorHasher::Hash(*m_p) % kModulo;
 }
+
+size_t CBV::GetMemoryUsage() const
+{
+  using coding::CompressedBitVector;
+
+  if (!m_p)
+    return 0;
+
+  size_t bytes = 0;
+  switch (m_p->GetStorageStrategy())
+  {
+  case CompressedBitVector::StorageStrategy::Dense:
+    bytes = static_cast<coding::DenseCBV const &>(*m_p).NumBitGroups() * sizeof(uint64_t);
+    break;
+  case CompressedBitVector::StorageStrategy::Sparse:
+    bytes = static_cast<size_t>(m_p->PopCount()) * sizeof(uint64_t);
+    break;
+  case CompressedBitVector::StorageStrategy::Chunked:
+  {
+    auto const & chunked = static_cast<coding::ChunkedCBV const &>(*m_p);
+    for (size_t i = 0; i < chunked.NumChunks(); ++i)
+    {
+      auto const & chunk = chunked.GetChunk(i);
+      bytes += sizeof(chunk) + chunk.m_values.size() * sizeof(chunk.m_values[0]) +
+               chunk.m_words.size() * sizeof(chunk.m_words[0]) +
+               chunk.m_runs.size() * sizeof(chunk.m_runs[0]);
+    }
+    break;
+  }
+  }
+  return bytes;
+}
 }  // namespace search
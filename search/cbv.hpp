@@ -48,14 +48,28 @@ public:
   CBV Union(CBV const & rhs) const;
   CBV Intersect(CBV const & rhs) const;
 
+  // In-place versions of Union() and Intersect(). The bit vector is modified in place
+  // when it's chunked and is not shared with other CBVs.
+  CBV & UnionWith(CBV const & rhs);
+  CBV & IntersectWith(CBV const & rhs);
+
+  // Returns the number of set bits in Intersect(rhs) without building it when possible.
+  uint64_t IntersectionPopCount(CBV const & rhs) const;
+
   // Takes first set |n| bits.
   CBV Take(uint64_t n) const;
 
   uint64_t Hash() const;
 
+  // Returns an estimate of the number of bytes taken by the bit vector.
+  size_t GetMemoryUsage() const;
+
 private:
   explicit CBV(bool full);
 
+  // Returns the bit vector if it may be modified in place and nullptr otherwise.
+  coding::ChunkedCBV * GetOwnChunked();
+
   base::RefCountPtr<coding::CompressedBitVector> m_p;
 
   // True iff all bits are set to one.
@@ -5,6 +5,7 @@
 #include "storage/country_info_getter.hpp"
 
 #include "indexer/categories_holder.hpp"
+#include "indexer/data_source.hpp"
 #include "indexer/search_string_utils.hpp"
 
 #include "base/scope_guard.hpp"
@@ -23,6 +24,15 @@ namespace search
 {
 namespace
 {
+size_t constexpr kSharedCacheBytes = 64 * 1024 * 1024;
+
+// The shared cache pays off only when there are several threads which may
+// retrieve the same features, for a single thread its own caches are enough.
+size_t GetDefaultSharedCacheBytes(size_t numThreads)
+{
+  return numThreads > 1 ? kSharedCacheBytes : 0;
+}
+
 class InitSuggestions
 {
   map<pair<strings::UniString, int8_t>, uint8_t> m_suggests;
@@ -75,18 +85,25 @@ void ProcessorHandle::Detach()
 }
 
 // Engine::Params ----------------------------------------------------------------------------------
-Engine::Params::Params() : m_locale("en"), m_numThreads(1) {}
+Engine::Params::Params()
+  : m_locale("en"), m_numThreads(1), m_sharedCacheBytes(GetDefaultSharedCacheBytes(m_numThreads))
+{
+}
 
 Engine::Params::Params(string const & locale, size_t numThreads)
-  : m_locale(locale), m_numThreads(numThreads)
+  : m_locale(locale)
+  , m_numThreads(numThreads)
+  , m_sharedCacheBytes(GetDefaultSharedCacheBytes(m_numThreads))
 {
 }
 
 // Engine ------------------------------------------------------------------------------------------
 Engine::Engine(DataSource & dataSource, CategoriesHolder const & categories,
                storage::CountryInfoGetter const & infoGetter, Params const & params)
-  : m_shutdown(false)
+  : m_dataSource(dataSource), m_sharedCache(params.m_sharedCacheBytes), m_shutdown(false)
 {
+  m_dataSource.AddObserver(m_sharedCache);
+
   InitSuggestions doInit;
   categories.ForEachName(bind<void>(ref(doInit), placeholders::_1));
   doInit.GetSuggests(m_suggests);
@@ -96,6 +113,8 @@ Engine::Engine(DataSource & dataSource, CategoriesHolder const & categories,
   {
     auto processor = make_unique<Processor>(dataSource, categories, m_suggests, infoGetter);
     processor->SetPreferredLocale(params.m_locale);
+    if (params.m_sharedCacheBytes > 0)
+      processor->SetSharedCache(&m_sharedCache);
     m_contexts[i].m_processor = move(processor);
   }
 
@@ -118,6 +137,8 @@ Engine::~Engine()
 
   for (auto & thread : m_threads)
     thread.join();
+
+  m_dataSource.RemoveObserver(m_sharedCache);
 }
 
 weak_ptr<ProcessorHandle> Engine::Search(SearchParams const & params)
@@ -140,6 +161,7 @@ size_t Engine::GetNumThreads() const { return m_threads.size(); }
 
 void Engine::ClearCaches()
 {
+  m_sharedCache.Clear();
   PostMessage(Message::TYPE_BROADCAST, [](Processor & processor) { processor.ClearCaches(); });
 }
 
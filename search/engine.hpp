@@ -2,6 +2,7 @@
 
 #include "search/bookmarks/processor.hpp"
 #include "search/search_params.hpp"
+#include "search/shared_features_cache.hpp"
 #include "search/suggest.hpp"
 
 #include "indexer/categories_holder.hpp"
@@ -83,6 +84,11 @@ public:
     // to process queries. Use this field wisely as large values may
     // negatively affect performance due to false sharing.
     size_t m_numThreads;
+
+    // Memory budget of the features cache shared by all threads. The
+    // cache is disabled when it's zero, which is the default for a
+    // single thread.
+    size_t m_sharedCacheBytes;
   };
 
   // Doesn't take ownership of dataSource and categories.
@@ -174,6 +180,9 @@ private:
 
   std::vector<Suggest> m_suggests;
 
+  DataSource & m_dataSource;
+  SharedFeaturesCache m_sharedCache;
+
   bool m_shutdown;
   std::mutex m_mu;
   std::condition_variable m_cv;
@@ -43,7 +43,9 @@
 #include "base/stl_helpers.hpp"
 
 #include <algorithm>
+#include <exception>
 #include <functional>
+#include <future>
 #include <iterator>
 #include <random>
 #include <sstream>
@@ -328,6 +330,32 @@ void Geocoder::LocalitiesCaches::Clear()
   m_villages.Clear();
 }
 
+void Geocoder::LocalitiesCaches::SetSharedCache(SharedFeaturesCache * sharedCache)
+{
+  m_countries.SetSharedCache(sharedCache);
+  m_states.SetSharedCache(sharedCache);
+  m_citiesTownsOrVillages.SetSharedCache(sharedCache);
+  m_villages.SetSharedCache(sharedCache);
+}
+
+// Geocoder::Worker --------------------------------------------------------------------------------
+struct Geocoder::Worker
+{
+  explicit Worker(Geocoder & parent)
+    : m_localitiesCaches(parent.m_cancellable)
+    , m_geocoder(parent.m_dataSource, parent.m_infoGetter, parent.m_categories,
+                 parent.m_citiesBoundaries, parent.m_preRanker, m_localitiesCaches,
+                 parent.m_cancellable)
+  {
+    m_geocoder.m_collectResults = true;
+    m_localitiesCaches.SetSharedCache(parent.m_sharedCache);
+    m_geocoder.SetSharedCache(parent.m_sharedCache);
+  }
+
+  LocalitiesCaches m_localitiesCaches;
+  Geocoder m_geocoder;
+};
+
 // Geocoder::Geocoder ------------------------------------------------------------------------------
 Geocoder::Geocoder(DataSource const & dataSource, storage::CountryInfoGetter const & infoGetter,
                    CategoriesHolder const & categories,
@@ -451,6 +479,32 @@ void Geocoder::ClearCaches()
   m_cuisineFilter.ClearCaches();
   m_postcodePointsCache.Clear();
   m_postcodes.Clear();
+
+  for (auto & worker : m_workers)
+  {
+    worker->m_geocoder.ClearCaches();
+    worker->m_localitiesCaches.Clear();
+  }
+}
+
+void Geocoder::SetSharedCache(SharedFeaturesCache * sharedCache)
+{
+  m_sharedCache = sharedCache;
+
+  m_streetsCache.SetSharedCache(sharedCache);
+  m_suburbsCache.SetSharedCache(sharedCache);
+  m_hotelsCache.SetSharedCache(sharedCache);
+  m_foodCache.SetSharedCache(sharedCache);
+  m_pivotRectsCache.SetSharedCache(sharedCache);
+  m_postcodesRectsCache.SetSharedCache(sharedCache);
+  m_suburbsRectsCache.SetSharedCache(sharedCache);
+  m_localityRectsCache.SetSharedCache(sharedCache);
+
+  for (auto & worker : m_workers)
+  {
+    worker->m_localitiesCaches.SetSharedCache(sharedCache);
+    worker->m_geocoder.SetSharedCache(sharedCache);
+  }
 }
 
 void Geocoder::SetParamsForCategorialSearch(Params const & params)
@@ -572,77 +626,201 @@ void Geocoder::GoImpl(vector<shared_ptr<MwmInfo>> const & infos, bool inViewport
   // found.
   auto const infosWithType = OrderCountries(inViewport, infos);
 
-  // MatchAroundPivot() should always be matched in mwms
-  // intersecting with position and viewport.
+  // Results tracer isn't thread-safe, so traced requests are always geocoded on the calling thread.
+  if (m_params.m_numThreads > 1 && !m_params.m_tracer)
+  {
+    GeocodeCountriesInParallel(infosWithType, inViewport);
+    return;
+  }
+
   auto processCountry = [&](unique_ptr<MwmContext> context, bool updatePreranker) {
-    ASSERT(context, ());
-    m_context = move(context);
+    GeocodeCountry(move(context), inViewport);
 
-    SCOPE_GUARD(cleanup, [&]() {
-      LOG(LDEBUG, (m_context->GetName(), "geocoding complete."));
-      m_matcher->OnQueryFinished();
-      m_matcher = nullptr;
-      m_context.reset();
-    });
+    if (updatePreranker)
+      m_preRanker.UpdateResults(false /* lastUpdate */);
 
-    auto it = m_matchersCache.find(m_context->GetId());
-    if (it == m_matchersCache.end())
-    {
-      it = m_matchersCache
-               .insert(make_pair(m_context->GetId(),
-                                 std::make_unique<FeaturesLayerMatcher>(m_dataSource, m_cancellable)))
-               .first;
-    }
-    m_matcher = it->second.get();
-    m_matcher->SetContext(m_context.get());
+    if (m_preRanker.IsFull())
+      return base::ControlFlow::Break;
+
+    return base::ControlFlow::Continue;
+  };
+
+  // Iterates through all alive mwms and performs geocoding.
+  ForEachCountry(infosWithType, processCountry);
+}
+
+void Geocoder::GeocodeCountry(unique_ptr<MwmContext> context, bool inViewport)
+{
+  ASSERT(context, ());
+  m_context = move(context);
+
+  SCOPE_GUARD(cleanup, [&]() {
+    LOG(LDEBUG, (m_context->GetName(), "geocoding complete."));
+    m_matcher->OnQueryFinished();
+    m_matcher = nullptr;
+    m_context.reset();
+  });
+
+  auto it = m_matchersCache.find(m_context->GetId());
+  if (it == m_matchersCache.end())
+  {
+    it = m_matchersCache
+             .insert(make_pair(m_context->GetId(),
+                               std::make_unique<FeaturesLayerMatcher>(m_dataSource, m_cancellable)))
+             .first;
+  }
+  m_matcher = it->second.get();
+  m_matcher->SetContext(m_context.get());
+
+  BaseContext ctx;
+  InitBaseContext(ctx);
+
+  if (inViewport)
+  {
+    auto const viewportCBV =
+        RetrieveGeometryFeatures(*m_context, m_params.m_pivot, RectId::Pivot);
+    for (auto & features : ctx.m_features)
+      features.IntersectWith(viewportCBV);
+  }
 
-    BaseContext ctx;
-    InitBaseContext(ctx);
+  ctx.m_villages = m_localitiesCaches.m_villages.Get(*m_context);
 
-    if (inViewport)
+  auto const citiesFromWorld = m_cities;
+  FillVillageLocalities(ctx);
+  SCOPE_GUARD(remove_villages, [&]() { m_cities = citiesFromWorld; });
+
+  if (m_params.IsCategorialRequest())
+  {
+    auto const mwmType = m_context->GetType();
+    CHECK(mwmType, ());
+    MatchCategories(ctx, mwmType->m_viewportIntersected /* aroundPivot */);
+  }
+  else
+  {
+    MatchRegions(ctx, Region::TYPE_COUNTRY);
+
+    // MatchAroundPivot() should always be matched in mwms
+    // intersecting with position and viewport.
+    auto const mwmType = m_context->GetType();
+    CHECK(mwmType, ());
+    bool const aroundPivot = mwmType->m_viewportIntersected || mwmType->m_containsUserPosition;
+    if (aroundPivot || !HaveFullyMatchedResult())
     {
-      auto const viewportCBV =
-          RetrieveGeometryFeatures(*m_context, m_params.m_pivot, RectId::Pivot);
-      for (auto & features : ctx.m_features)
-        features = features.Intersect(viewportCBV);
+      // A worker doesn't know results of the previous mwms of its wave, so these results
+      // are dropped on merge if the previous mwms have fully matched results.
+      if (!aroundPivot)
+        m_speculativeResultsBegin = m_collectedResults.size();
+      MatchAroundPivot(ctx);
     }
+  }
+}
 
-    ctx.m_villages = m_localitiesCaches.m_villages.Get(*m_context);
+void Geocoder::GeocodeCountriesInParallel(ExtendedMwmInfos const & infos, bool inViewport)
+{
+  size_t const numThreads = m_params.m_numThreads;
+  if (m_workers.size() != numThreads)
+  {
+    m_threadPool.reset();
+    m_workers.clear();
+    for (size_t i = 0; i < numThreads; ++i)
+      m_workers.push_back(make_unique<Worker>(*this));
+    m_threadPool = make_unique<base::thread_pool::computational::ThreadPool>(numThreads);
+  }
 
-    auto const citiesFromWorld = m_cities;
-    FillVillageLocalities(ctx);
-    SCOPE_GUARD(remove_villages, [&]() { m_cities = citiesFromWorld; });
+  for (auto & worker : m_workers)
+  {
+    auto & geocoder = worker->m_geocoder;
+    geocoder.SetParams(m_params);
+    geocoder.m_worldId = m_worldId;
+    geocoder.m_cities = m_cities;
+    for (size_t i = 0; i < Region::TYPE_COUNT; ++i)
+      geocoder.m_regions[i] = m_regions[i];
+  }
 
-    if (m_params.IsCategorialRequest())
+  // Mwms are collected lazily to keep only handles of the current wave alive.
+  Wave wave;
+  ForEachCountry(infos, [&](unique_ptr<MwmContext> context, bool updatePreranker) {
+    wave.emplace_back(move(context), updatePreranker);
+    if (wave.size() < m_workers.size())
+      return base::ControlFlow::Continue;
+    return GeocodeWave(wave, inViewport);
+  });
+
+  if (!wave.empty())
+    GeocodeWave(wave, inViewport);
+}
+
+base::ControlFlow Geocoder::GeocodeWave(Wave & wave, bool inViewport)
+{
+  ASSERT_LESS_OR_EQUAL(wave.size(), m_workers.size(), ());
+  SCOPE_GUARD(clearWave, [&wave]() { wave.clear(); });
+
+  // |m_preRanker| is not modified while the tasks are running, so workers see
+  // the state of it after the previous wave regardless of the order of execution.
+  vector<future<void>> tasks;
+  tasks.reserve(wave.size());
+  for (size_t i = 0; i < wave.size(); ++i)
+  {
+    auto & geocoder = m_workers[i]->m_geocoder;
+    auto & context = wave[i].first;
+    tasks.push_back(m_threadPool->Submit([&geocoder, &context, inViewport]() {
+      geocoder.m_collectedResults.clear();
+      geocoder.m_speculativeResultsBegin = numeric_limits<size_t>::max();
+      geocoder.GeocodeCountry(move(context), inViewport);
+    }));
+  }
+
+  // All tasks must be finished before an exception is rethrown because they refer to |wave|.
+  // The exception of the first mwm is rethrown to keep it independent from the scheduling.
+  exception_ptr exception;
+  for (auto & task : tasks)
+  {
+    try
     {
-      auto const mwmType = m_context->GetType();
-      CHECK(mwmType, ());
-      MatchCategories(ctx, mwmType->m_viewportIntersected /* aroundPivot */);
+      task.get();
     }
-    else
+    catch (...)
     {
-      MatchRegions(ctx, Region::TYPE_COUNTRY);
+      if (!exception)
+        exception = current_exception();
+    }
+  }
+  if (exception)
+    rethrow_exception(exception);
 
-      auto const mwmType = m_context->GetType();
-      CHECK(mwmType, ());
-      if (mwmType->m_viewportIntersected || mwmType->m_containsUserPosition ||
-          !m_preRanker.HaveFullyMatchedResult())
-      {
-        MatchAroundPivot(ctx);
-      }
+  for (size_t i = 0; i < wave.size(); ++i)
+  {
+    auto & geocoder = m_workers[i]->m_geocoder;
+    auto & results = geocoder.m_collectedResults;
+    size_t const speculativeBegin = min(geocoder.m_speculativeResultsBegin, results.size());
+    for (size_t j = 0; j < speculativeBegin; ++j)
+      m_preRanker.Emplace(move(results[j]));
+
+    // The same check as in GeocodeCountry() but with results of the previous mwms.
+    if (!m_preRanker.HaveFullyMatchedResult())
+    {
+      for (size_t j = speculativeBegin; j < results.size(); ++j)
+        m_preRanker.Emplace(move(results[j]));
     }
+    results.clear();
 
-    if (updatePreranker)
+    if (wave[i].second /* updatePreranker */)
       m_preRanker.UpdateResults(false /* lastUpdate */);
 
     if (m_preRanker.IsFull())
       return base::ControlFlow::Break;
+  }
 
-    return base::ControlFlow::Continue;
-  };
+  return base::ControlFlow::Continue;
+}
 
-  // Iterates through all alive mwms and performs geocoding.
-  ForEachCountry(infosWithType, processCountry);
+bool Geocoder::HaveFullyMatchedResult() const
+{
+  if (m_preRanker.HaveFullyMatchedResult())
+    return true;
+
+  return any_of(m_collectedResults.begin(), m_collectedResults.end(),
+                [](PreRankerResult const & result) { return result.GetInfo().m_allTokensUsed; });
 }
 
 void Geocoder::InitBaseContext(BaseContext & ctx)
@@ -1420,7 +1598,7 @@ void Geocoder::MatchPOIsAndBuildings(BaseContext & ctx, size_t curToken, CBV con
       InitLayer(layer.m_type, TokenRange(curToken, curToken + n), layer);
     }
 
-    features = features.Intersect(ctx.m_features[curToken + n - 1]);
+    features.IntersectWith(ctx.m_features[curToken + n - 1]);
 
     CBV filtered = features.m_features;
     if (m_filter->NeedToFilter(features.m_features))
@@ -1708,7 +1886,10 @@ void Geocoder::EmitResult(BaseContext & ctx, MwmSet::MwmId const & mwmId, uint32
   info.m_allTokensUsed = allTokensUsed;
   info.m_exactMatch = exactMatch;
 
-  m_preRanker.Emplace(id, info, m_resultTracer.GetProvenance());
+  if (m_collectResults)
+    m_collectedResults.emplace_back(id, info, m_resultTracer.GetProvenance());
+  else
+    m_preRanker.Emplace(id, info, m_resultTracer.GetProvenance());
 
   ++ctx.m_numEmitted;
 }
@@ -1751,7 +1932,7 @@ void Geocoder::MatchUnclassified(BaseContext & ctx, size_t curToken)
   auto startToken = curToken;
   for (; curToken < ctx.m_numTokens && !ctx.IsTokenUsed(curToken); ++curToken)
   {
-    allFeatures = allFeatures.Intersect(ctx.m_features[curToken]);
+    allFeatures.IntersectWith(ctx.m_features[curToken]);
   }
 
   if (m_filter->NeedToFilter(allFeatures.m_features))
@@ -11,6 +11,7 @@
 #include "search/geocoder_context.hpp"
 #include "search/geocoder_locality.hpp"
 #include "search/geometry_cache.hpp"
+#include "search/intermediate_result.hpp"
 #include "search/mode.hpp"
 #include "search/model.hpp"
 #include "search/mwm_context.hpp"
@@ -33,9 +34,11 @@
 #include "geometry/rect2d.hpp"
 
 #include "base/cancellable.hpp"
+#include "base/control_flow.hpp"
 #include "base/dfa_helpers.hpp"
 #include "base/levenshtein_dfa.hpp"
 #include "base/string_utils.hpp"
+#include "base/thread_pool_computational.hpp"
 
 #include <cstddef>
 #include <cstdint>
@@ -44,6 +47,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 class CategoriesHolder;
@@ -92,12 +96,16 @@ public:
     double m_streetSearchRadiusM = 0.0;
     double m_villageSearchRadiusM = 0.0;
     int m_scale = scales::GetUpperScale();
+    // Number of threads which geocode mwms in parallel. Mwms are geocoded one by one
+    // on the calling thread if it's 1.
+    size_t m_numThreads = 1;
   };
 
   struct LocalitiesCaches
   {
     LocalitiesCaches(base::Cancellable const & cancellable);
     void Clear();
+    void SetSharedCache(SharedFeaturesCache * sharedCache);
 
     CountriesCache m_countries;
     StatesCache m_states;
@@ -135,6 +143,10 @@ public:
   void CacheWorldLocalities();
   void ClearCaches();
 
+  // Makes categories and rects caches of the geocoder and of its workers
+  // use |sharedCache| which may be nullptr.
+  void SetSharedCache(SharedFeaturesCache * sharedCache);
+
 private:
   enum class RectId
   {
@@ -184,6 +196,12 @@ private:
     CBV m_worldFeatures;
   };
 
+  // Geocoder of a thread of |m_threadPool|. It has its own caches and collects
+  // results of an mwm instead of emitting them to |m_preRanker|.
+  struct Worker;
+
+  using Wave = std::vector<std::pair<std::unique_ptr<MwmContext>, bool /* updatePreranker */>>;
+
   // Sets search query params for categorial search.
   void SetParamsForCategorialSearch(Params const & params);
 
@@ -212,6 +230,20 @@ private:
   template <typename Fn>
   void ForEachCountry(ExtendedMwmInfos const & infos, Fn && fn);
 
+  // Performs geocoding in the mwm of |context|.
+  void GeocodeCountry(std::unique_ptr<MwmContext> context, bool inViewport);
+
+  // Geocodes mwms in waves of |m_params.m_numThreads| mwms. Mwms of a wave are geocoded
+  // in parallel, then their results are emitted to |m_preRanker| in the order of mwms,
+  // so the results are the same as the results of GeocodeCountry() called for mwms
+  // one by one and don't depend on the scheduling of threads.
+  void GeocodeCountriesInParallel(ExtendedMwmInfos const & infos, bool inViewport);
+  base::ControlFlow GeocodeWave(Wave & wave, bool inViewport);
+
+  // Returns true if there is a result with all tokens used in |m_preRanker| or
+  // in results collected by the worker.
+  bool HaveFullyMatchedResult() const;
+
   // Throws CancelException if cancelled.
   void BailIfCancelled() { ::search::BailIfCancelled(m_cancellable); }
 
@@ -373,5 +405,18 @@ private:
   ResultTracer m_resultTracer;
 
   PreRanker & m_preRanker;
+
+  // Results are collected to |m_collectedResults| instead of |m_preRanker| if
+  // |m_collectResults| is true. It's true for workers only.
+  bool m_collectResults = false;
+  std::vector<PreRankerResult> m_collectedResults;
+  // Results of MatchAroundPivot() which is called by a worker without knowledge of results of
+  // the previous mwms of the wave begin from this index of |m_collectedResults|.
+  size_t m_speculativeResultsBegin = 0;
+
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  std::unique_ptr<base::thread_pool::computational::ThreadPool> m_threadPool;
+
+  SharedFeaturesCache * m_sharedCache = nullptr;
 };
 }  // namespace search
@@ -21,10 +21,14 @@ void GeometryCache::InitEntry(MwmContext const & context, m2::RectD const & rect
                               Entry & entry)
 {
   Retrieval retrieval(context, m_cancellable);
+  auto const generation = m_sharedCache ? m_sharedCache->GetGeneration() : 0;
 
   entry.m_rect = rect;
   entry.m_cbv = retrieval.RetrieveGeometryFeatures(rect, scale);
   entry.m_scale = scale;
+
+  if (m_sharedCache)
+    m_sharedCache->PutGeometry(context.GetId(), entry, generation);
 }
 
 // PivotRectsCache ---------------------------------------------------------------------------------
@@ -48,7 +52,15 @@ CBV PivotRectsCache::Get(MwmContext const & context, m2::RectD const & rect, int
     m2::RectD normRect = mercator::RectByCenterXYAndSizeInMeters(rect.Center(), m_maxRadiusMeters);
     if (!normRect.IsRectInside(rect))
       normRect = rect;
-    InitEntry(context, normRect, scale, entry);
+
+    // Shared rects of other pivot caches may be much larger, so only the
+    // rect this cache would retrieve by itself is taken from the shared cache.
+    auto const isNormRect = [&normRect, &scale](Entry const & entry)
+    {
+      return scale == entry.m_scale && IsEqualMercator(normRect, entry.m_rect, kMwmPointAccuracy);
+    };
+    if (!InitEntryFromSharedCache(context.GetId(), isNormRect, entry))
+      InitEntry(context, normRect, scale, entry);
   }
   return entry.m_cbv;
 }
@@ -62,13 +74,13 @@ LocalityRectsCache::LocalityRectsCache(size_t maxNumEntries,
 
 CBV LocalityRectsCache::Get(MwmContext const & context, m2::RectD const & rect, int scale)
 {
-  auto p = FindOrCreateEntry(context.GetId(), [&rect, &scale](Entry const & entry)
-                             {
-                               return scale == entry.m_scale &&
-                                      IsEqualMercator(rect, entry.m_rect, kMwmPointAccuracy);
-                             });
+  auto const pred = [&rect, &scale](Entry const & entry)
+  {
+    return scale == entry.m_scale && IsEqualMercator(rect, entry.m_rect, kMwmPointAccuracy);
+  };
+  auto p = FindOrCreateEntry(context.GetId(), pred);
   auto & entry = p.first;
-  if (p.second)
+  if (p.second && !InitEntryFromSharedCache(context.GetId(), pred, entry))
     InitEntry(context, rect, scale, entry);
   return entry.m_cbv;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "search/cbv.hpp"
+#include "search/shared_features_cache.hpp"
 
 #include "indexer/mwm_set.hpp"
 
@@ -38,13 +39,12 @@ public:
 
   inline void Clear() { m_entries.clear(); }
 
+  // Rects which are not in the own cache are looked up in |sharedCache| and
+  // features of new rects are put there. |sharedCache| may be nullptr.
+  inline void SetSharedCache(SharedFeaturesCache * sharedCache) { m_sharedCache = sharedCache; }
+
 protected:
-  struct Entry
-  {
-    m2::RectD m_rect;
-    CBV m_cbv;
-    int m_scale = 0;
-  };
+  using Entry = SharedFeaturesCache::GeometryEntry;
 
   // |maxNumEntries| denotes the maximum number of rectangles that
   // will be cached for each mwm individually.
@@ -71,11 +71,18 @@ protected:
     return std::pair<Entry &, bool>(entries.front(), true);
   }
 
+  template <typename Pred>
+  bool InitEntryFromSharedCache(MwmSet::MwmId const & id, Pred && pred, Entry & entry)
+  {
+    return m_sharedCache && m_sharedCache->GetGeometry(id, std::forward<Pred>(pred), entry);
+  }
+
   void InitEntry(MwmContext const & context, m2::RectD const & rect, int scale, Entry & entry);
 
   std::map<MwmSet::MwmId, std::deque<Entry>> m_entries;
   size_t const m_maxNumEntries;
   base::Cancellable const & m_cancellable;
+  SharedFeaturesCache * m_sharedCache = nullptr;
 };
 
 class PivotRectsCache : public GeometryCache
@@ -159,7 +159,7 @@ void LocalityScorer::GetTopLocalities(MwmSet::MwmId const & countryId, BaseConte
       }
 
       if (endToken < ctx.m_numTokens)
-        intersection = intersection.Intersect(intersections[endToken]);
+        intersection.IntersectWith(intersections[endToken]);
     }
   }
 
@@ -375,6 +375,12 @@ m2::RectD const & Processor::GetViewport() const
 
 void Processor::CacheWorldLocalities() { m_geocoder.CacheWorldLocalities(); }
 
+void Processor::SetSharedCache(SharedFeaturesCache * sharedCache)
+{
+  m_localitiesCaches.SetSharedCache(sharedCache);
+  m_geocoder.SetSharedCache(sharedCache);
+}
+
 void Processor::LoadCitiesBoundaries()
 {
   if (m_citiesBoundaries.Load())
@@ -862,6 +868,7 @@ void Processor::InitGeocoder(Geocoder::Params & geocoderParams, SearchParams con
   geocoderParams.m_tracer = searchParams.m_tracer;
   geocoderParams.m_streetSearchRadiusM = searchParams.m_streetSearchRadiusM;
   geocoderParams.m_villageSearchRadiusM = searchParams.m_villageSearchRadiusM;
+  geocoderParams.m_numThreads = searchParams.m_numGeocoderThreads;
 
   m_geocoder.SetParams(geocoderParams);
 }
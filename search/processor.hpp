@@ -98,6 +98,9 @@ public:
 
   void ClearCaches();
   void CacheWorldLocalities();
+
+  // Makes features caches of the processor use |sharedCache| which may be nullptr.
+  void SetSharedCache(SharedFeaturesCache * sharedCache);
   void LoadCitiesBoundaries();
   void LoadCountriesTree();
 
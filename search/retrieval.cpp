@@ -134,22 +134,21 @@ private:
   vector<uint32_t> m_created;
 };
 
+// Retrieved features are kept in chunked bit vectors which are cheap to intersect and unite.
 Retrieval::ExtendedFeatures SortFeaturesAndBuildResult(vector<uint64_t> && features,
                                                        vector<uint64_t> && exactlyMatchedFeatures)
 {
-  using Builder = coding::CompressedBitVectorBuilder;
   base::SortUnique(features);
   base::SortUnique(exactlyMatchedFeatures);
-  auto featuresCBV = CBV(Builder::FromBitPositions(move(features)));
-  auto exactlyMatchedFeaturesCBV = CBV(Builder::FromBitPositions(move(exactlyMatchedFeatures)));
+  auto featuresCBV = CBV(make_unique<coding::ChunkedCBV>(features));
+  auto exactlyMatchedFeaturesCBV = CBV(make_unique<coding::ChunkedCBV>(exactlyMatchedFeatures));
   return Retrieval::ExtendedFeatures(move(featuresCBV), move(exactlyMatchedFeaturesCBV));
 }
 
 Retrieval::ExtendedFeatures SortFeaturesAndBuildResult(vector<uint64_t> && features)
 {
-  using Builder = coding::CompressedBitVectorBuilder;
   base::SortUnique(features);
-  auto const featuresCBV = CBV(Builder::FromBitPositions(move(features)));
+  auto const featuresCBV = CBV(make_unique<coding::ChunkedCBV>(features));
   return Retrieval::ExtendedFeatures(featuresCBV);
 }
 
@@ -69,6 +69,20 @@ public:
       return result;
     }
 
+    ExtendedFeatures & IntersectWith(ExtendedFeatures const & rhs)
+    {
+      m_features.IntersectWith(rhs.m_features);
+      m_exactMatchingFeatures.IntersectWith(rhs.m_exactMatchingFeatures);
+      return *this;
+    }
+
+    ExtendedFeatures & IntersectWith(Features const & cbv)
+    {
+      m_features.IntersectWith(cbv);
+      m_exactMatchingFeatures.IntersectWith(cbv);
+      return *this;
+    }
+
     void SetFull()
     {
       m_features.SetFull();
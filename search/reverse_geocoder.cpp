@@ -16,11 +16,18 @@
 #include "indexer/scales.hpp"
 #include "indexer/search_string_utils.hpp"
 
+#include "geometry/mercator.hpp"
+#include "geometry/parametrized_segment.hpp"
+#include "geometry/triangle2d.hpp"
+
 #include "base/stl_helpers.hpp"
+#include "base/thread_pool_computational.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <functional>
+#include <future>
 #include <limits>
 
 using namespace std;
@@ -34,6 +41,14 @@ int constexpr kQueryScale = scales::GetUpperScale();
 /// Max number of tries (nearest houses with housenumber) to check when getting point address.
 size_t constexpr kMaxNumTriesToApproxAddress = 10;
 
+/// Side of a cell of batch reverse geocoding in lookup radii.
+double constexpr kBatchCellSizeInRadii = 2.0;
+/// Number of groups of neighbouring cells per thread of batch reverse geocoding.
+/// Each group is a separate task, more groups balance the load better.
+size_t constexpr kBatchGroupsPerThread = 4;
+/// Max number of buildings streets of which are kept by a task of batch reverse geocoding.
+size_t constexpr kMaxNumBatchBuildingStreets = 100000;
+
 using AppendStreet = function<void(FeatureType & ft)>;
 using FillStreets =
     function<void(MwmSet::MwmHandle && handle, m2::RectD const & rect, AppendStreet && addStreet)>;
@@ -60,6 +75,85 @@ void AddStreet(FeatureType & ft, m2::PointD const & center, bool includeSquaresA
     streets.emplace_back(ft.GetID(), feature::GetMinDistanceMeters(ft, center), name, ft.GetNames());
 }
 
+// Geometry of a feature which is enough to calculate distances to it
+// without reading the feature again.
+class FeatureGeometry
+{
+public:
+  explicit FeatureGeometry(FeatureType & ft) : m_type(ft.GetGeomType())
+  {
+    switch (m_type)
+    {
+    case feature::GeomType::Point: m_points.push_back(ft.GetCenter()); break;
+    case feature::GeomType::Line:
+    {
+      ft.ParseGeometry(FeatureType::BEST_GEOMETRY);
+      size_t const count = ft.GetPointsCount();
+      m_points.reserve(count);
+      for (size_t i = 0; i < count; ++i)
+        m_points.push_back(ft.GetPoint(i));
+      break;
+    }
+    default:
+      ASSERT_EQUAL(m_type, feature::GeomType::Area, ());
+      ft.ForEachTriangle([this](m2::PointD const & p1, m2::PointD const & p2,
+                                m2::PointD const & p3)
+      {
+        m_points.push_back(p1);
+        m_points.push_back(p2);
+        m_points.push_back(p3);
+      }, FeatureType::BEST_GEOMETRY);
+    }
+
+    for (auto const & p : m_points)
+      m_rect.Add(p);
+  }
+
+  m2::RectD const & GetLimitRect() const { return m_rect; }
+
+  // Same as feature::GetMinDistanceMeters().
+  double GetMinDistanceMeters(m2::PointD const & pt) const
+  {
+    double res = numeric_limits<double>::max();
+    auto const updateDistance = [&](m2::PointD const & p1, m2::PointD const & p2)
+    {
+      m2::ParametrizedSegment<m2::PointD> const segment(p1, p2);
+      res = min(res, mercator::DistanceOnEarth(segment.ClosestPointTo(pt), pt));
+    };
+
+    switch (m_type)
+    {
+    case feature::GeomType::Point:
+      if (!m_points.empty())
+        res = mercator::DistanceOnEarth(m_points.front(), pt);
+      break;
+    case feature::GeomType::Line:
+      for (size_t i = 1; i < m_points.size(); ++i)
+        updateDistance(m_points[i - 1], m_points[i]);
+      break;
+    default:
+      for (size_t i = 0; i + 2 < m_points.size(); i += 3)
+      {
+        auto const & p1 = m_points[i];
+        auto const & p2 = m_points[i + 1];
+        auto const & p3 = m_points[i + 2];
+        if (m2::IsPointInsideTriangle(pt, p1, p2, p3))
+          return 0.0;
+        updateDistance(p1, p2);
+        updateDistance(p2, p3);
+        updateDistance(p3, p1);
+      }
+    }
+    return res;
+  }
+
+private:
+  feature::GeomType m_type;
+  // Points of a point or a line or vertices of triangles of an area.
+  vector<m2::PointD> m_points;
+  m2::RectD m_rect;
+};
+
 // Following methods join only non-empty arguments in order with
 // commas.
 string Join(string const & s)
@@ -221,6 +315,13 @@ void ReverseGeocoder::GetNearbyAddress(m2::PointD const & center, Address & addr
 void ReverseGeocoder::GetNearbyAddress(m2::PointD const & center, double maxDistanceM,
                                        Address & addr) const
 {
+  vector<MwmAddressIndex> indices;
+  if (LoadAddressIndices(GetLookupRect(center, maxDistanceM), indices))
+  {
+    GetNearbyAddress(indices, center, maxDistanceM, addr);
+    return;
+  }
+
   vector<Building> buildings;
   GetNearbyBuildings(center, maxDistanceM, buildings);
 
@@ -237,6 +338,260 @@ void ReverseGeocoder::GetNearbyAddress(m2::PointD const & center, double maxDist
   }
 }
 
+bool ReverseGeocoder::LoadAddressIndices(m2::RectD const & rect,
+                                         vector<MwmAddressIndex> & indices) const
+{
+  vector<shared_ptr<MwmInfo>> infos;
+  m_dataSource.GetMwmsInfo(infos);
+
+  auto const & editor = osm::Editor::Instance();
+  auto & cache = AddressIndexCache::Instance();
+  for (auto const & info : infos)
+  {
+    if (info->GetType() != MwmInfo::COUNTRY || !rect.IsIntersect(info->m_bordersRect))
+      continue;
+
+    MwmSet::MwmId id(info);
+    if (!id.IsAlive())
+      continue;
+
+    // Created and edited buildings and streets are not in the index.
+    if (editor.HaveMapEdits(id))
+      return false;
+
+    auto index = cache.Get(m_dataSource, id);
+    if (!index)
+      return false;
+    indices.push_back({move(id), move(index)});
+  }
+  return true;
+}
+
+void ReverseGeocoder::GetNearbyAddress(vector<MwmAddressIndex> const & indices,
+                                       m2::PointD const & center, double maxDistanceM,
+                                       Address & addr) const
+{
+  auto const rect = GetLookupRect(center, maxDistanceM);
+
+  // Buildings are visited in order of distances to their rects, which are not greater
+  // than distances to buildings, so only buildings which may be closer than the nearest
+  // one found so far are read.
+  Building building;
+  FeatureID streetId;
+  for (auto const & mwm : indices)
+  {
+    auto const & mwmId = mwm.m_mwmId;
+    if (!rect.IsIntersect(mwmId.GetInfo()->m_bordersRect))
+      continue;
+
+    unique_ptr<FeaturesLoaderGuard> guard;
+    mwm.m_index->ForEachByDistance(center, maxDistanceM,
+                                   [&](AddressIndex::Entry const & entry, double distanceM)
+    {
+      if (building.IsValid() && distanceM >= building.m_distanceMeters)
+        return false;
+
+      if (!guard)
+        guard = make_unique<FeaturesLoaderGuard>(m_dataSource, mwmId);
+      auto ft = guard->GetFeatureByIndex(entry.m_buildingId);
+      if (!ft)
+        return true;
+
+      auto const distance = feature::GetMinDistanceMeters(*ft, center);
+      if (distance > maxDistanceM || ft->GetHouseNumber().empty())
+        return true;
+
+      if (!building.IsValid() || distance < building.m_distanceMeters)
+      {
+        building = FromFeature(*ft, distance);
+        streetId = FeatureID(mwmId, entry.m_streetId);
+      }
+      return true;
+    });
+  }
+
+  if (!building.IsValid())
+    return;
+
+  m_dataSource.ReadFeature([&building, &addr](FeatureType & ft)
+  {
+    double const distance = feature::GetMinDistanceMeters(ft, building.m_center);
+    addr.m_street = Street(ft.GetID(), distance, ft.GetReadableName(), ft.GetNames());
+  }, streetId);
+
+  if (addr.m_street.IsValid())
+    addr.m_building = building;
+}
+
+struct ReverseGeocoder::CellBuilding
+{
+  explicit CellBuilding(FeatureType & ft)
+    : m_building(FromFeature(ft, 0.0 /* distMeters */)), m_geometry(ft)
+  {
+  }
+
+  Building m_building;
+  FeatureGeometry m_geometry;
+};
+
+void ReverseGeocoder::GetNearbyAddresses(vector<m2::PointD> const & centers, double maxDistanceM,
+                                         size_t numThreads, vector<Address> & addrs) const
+{
+  CHECK_GREATER(maxDistanceM, 0.0, ());
+
+  addrs.assign(centers.size(), {});
+  if (centers.empty())
+    return;
+
+  // Points are sorted by cells, so points of a cell and neighbouring cells are adjacent.
+  double const cellSize = mercator::MetersToMercator(kBatchCellSizeInRadii * maxDistanceM);
+  using Cell = pair<int64_t, int64_t>;
+  vector<pair<Cell, size_t>> points;
+  points.reserve(centers.size());
+  for (size_t i = 0; i < centers.size(); ++i)
+  {
+    Cell const cell(static_cast<int64_t>(floor(centers[i].x / cellSize)),
+                    static_cast<int64_t>(floor(centers[i].y / cellSize)));
+    points.emplace_back(cell, i);
+  }
+  sort(points.begin(), points.end());
+
+  // Groups are ranges of |points| which consist of whole cells.
+  numThreads = max(numThreads, static_cast<size_t>(1));
+  size_t const numGroups = numThreads == 1 ? 1 : numThreads * kBatchGroupsPerThread;
+  size_t const groupSize = (points.size() + numGroups - 1) / numGroups;
+  vector<pair<size_t, size_t>> groups;
+  for (size_t begin = 0; begin < points.size();)
+  {
+    size_t end = min(begin + groupSize, points.size());
+    while (end < points.size() && points[end].first == points[end - 1].first)
+      ++end;
+    groups.emplace_back(begin, end);
+    begin = end;
+  }
+
+  auto const processGroup = [&](size_t begin, size_t end)
+  {
+    m2::RectD groupRect;
+    for (size_t i = begin; i < end; ++i)
+      groupRect.Add(GetLookupRect(centers[points[i].second], maxDistanceM));
+
+    vector<MwmAddressIndex> indices;
+    if (LoadAddressIndices(groupRect, indices))
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        auto const id = points[i].second;
+        GetNearbyAddress(indices, centers[id], maxDistanceM, addrs[id]);
+      }
+      return;
+    }
+
+    HouseTable table(m_dataSource);
+    BuildingStreets streets;
+    vector<size_t> ids;
+    for (size_t i = begin; i < end;)
+    {
+      ids.clear();
+      size_t j = i;
+      for (; j < end && points[j].first == points[i].first; ++j)
+        ids.push_back(points[j].second);
+
+      if (streets.size() > kMaxNumBatchBuildingStreets)
+        streets.clear();
+      GetNearbyAddressesInCell(centers, ids, maxDistanceM, table, streets, addrs);
+      i = j;
+    }
+  };
+
+  if (groups.size() == 1)
+  {
+    processGroup(groups.front().first, groups.front().second);
+    return;
+  }
+
+  auto & threadPool = GetBatchPool(numThreads);
+  vector<future<void>> tasks;
+  tasks.reserve(groups.size());
+  for (auto const & group : groups)
+    tasks.push_back(threadPool.Submit(processGroup, group.first, group.second));
+  for (auto & task : tasks)
+    task.get();
+}
+
+base::thread_pool::computational::ThreadPool & ReverseGeocoder::GetBatchPool(size_t numThreads) const
+{
+  lock_guard guard(m_batchPoolsMutex);
+  auto & pool = m_batchPools[numThreads];
+  if (!pool)
+    pool = make_unique<base::thread_pool::computational::ThreadPool>(numThreads);
+  return *pool;
+}
+
+void ReverseGeocoder::GetNearbyAddressesInCell(vector<m2::PointD> const & centers,
+                                               vector<size_t> const & ids, double maxDistanceM,
+                                               HouseTable & table, BuildingStreets & streets,
+                                               vector<Address> & addrs) const
+{
+  ASSERT(!ids.empty(), ());
+
+  m2::RectD cellRect;
+  for (auto const id : ids)
+    cellRect.Add(GetLookupRect(centers[id], maxDistanceM));
+
+  vector<CellBuilding> cellBuildings;
+  m_dataSource.ForEachInRect([&cellBuildings](FeatureType & ft)
+  {
+    if (!ft.GetHouseNumber().empty())
+      cellBuildings.emplace_back(ft);
+  }, cellRect, kQueryScale);
+
+  vector<Building> buildings;
+  for (auto const id : ids)
+  {
+    auto const & center = centers[id];
+    auto const rect = GetLookupRect(center, maxDistanceM);
+
+    buildings.clear();
+    for (auto const & cb : cellBuildings)
+    {
+      if (!rect.IsIntersect(cb.m_geometry.GetLimitRect()))
+        continue;
+      auto const distance = cb.m_geometry.GetMinDistanceMeters(center);
+      if (distance <= maxDistanceM)
+      {
+        buildings.push_back(cb.m_building);
+        buildings.back().m_distanceMeters = distance;
+      }
+    }
+    sort(buildings.begin(), buildings.end(), base::LessBy(&Building::m_distanceMeters));
+
+    size_t triesCount = 0;
+    for (auto const & b : buildings)
+    {
+      auto it = streets.find(b.m_id);
+      if (it == streets.end())
+      {
+        Address addr;
+        optional<Street> street;
+        if (GetNearbyAddress(table, b, false /* ignoreEdits */, addr))
+          street = move(addr.m_street);
+        it = streets.emplace(b.m_id, move(street)).first;
+      }
+
+      if (it->second)
+      {
+        addrs[id].m_building = b;
+        addrs[id].m_street = *it->second;
+        break;
+      }
+
+      if (++triesCount == kMaxNumTriesToApproxAddress)
+        break;
+    }
+  }
+}
+
 bool ReverseGeocoder::GetExactAddress(FeatureType & ft, Address & addr) const
 {
   if (ft.GetHouseNumber().empty())
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "search/address_index.hpp"
 #include "search/house_to_street_table.hpp"
 
 #include "indexer/feature_decl.hpp"
@@ -9,9 +10,13 @@
 #include "coding/string_utf8_multilang.hpp"
 
 #include "base/string_utils.hpp"
+#include "base/thread_pool_computational.hpp"
 
+#include <cstddef>
 #include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <utility>
@@ -142,7 +147,21 @@ public:
   void GetNearbyAddress(m2::PointD const & center, Address & addr) const;
   /// @return The nearest exact address where building is at most |maxDistanceM| far from |center|,
   /// has house number and valid street match.
+  /// When all mwms around |center| have address indices and have no edits, the address is
+  /// taken from the indices: only a few nearest buildings and the street are read then.
+  /// Buildings without a street in the index are skipped, so unlike the search of the nearest
+  /// buildings, the address is found even if the nearest buildings have no streets.
   void GetNearbyAddress(m2::PointD const & center, double maxDistanceM, Address & addr) const;
+  /// Same as GetNearbyAddress(center, maxDistanceM, addr) for every point of |centers|, but
+  /// much faster for large batches of close points. Points are grouped by cells, buildings
+  /// of a cell are read once for all its points and the street of a building is found once.
+  /// Groups of neighbouring cells are processed on |numThreads| threads. A thread pool of every
+  /// |numThreads| is created on the first call with it and is kept by the geocoder.
+  /// Unlike GetNearbyAddress(), which reads the nearest buildings approximately, buildings
+  /// are checked strictly in order of distance, so results may differ for a few points.
+  /// Address indices are used for groups of points where they are available.
+  void GetNearbyAddresses(std::vector<m2::PointD> const & centers, double maxDistanceM,
+                          size_t numThreads, std::vector<Address> & addrs) const;
   /// @param addr (out) the exact address of a feature.
   /// @returns false if  can't extruct address or ft have no house number.
   bool GetExactAddress(FeatureType & ft, Address & addr) const;
@@ -170,6 +189,33 @@ private:
     MwmSet::MwmHandle m_handle;
   };
 
+  /// Address index of an mwm from AddressIndexCache.
+  struct MwmAddressIndex
+  {
+    MwmSet::MwmId m_mwmId;
+    std::shared_ptr<AddressIndex const> m_index;
+  };
+
+  /// Gets address indices of country mwms which intersect |rect|.
+  /// @returns false if some of the mwms has no address index or has edits,
+  /// the indices can't be used then.
+  bool LoadAddressIndices(m2::RectD const & rect, std::vector<MwmAddressIndex> & indices) const;
+
+  /// Same as GetNearbyAddress(center, maxDistanceM, addr) but buildings and streets
+  /// are taken from |indices|.
+  void GetNearbyAddress(std::vector<MwmAddressIndex> const & indices, m2::PointD const & center,
+                        double maxDistanceM, Address & addr) const;
+
+  struct CellBuilding;
+  /// Streets of buildings or empty values for buildings without address.
+  using BuildingStreets = std::map<FeatureID, std::optional<Street>>;
+
+  /// Reverse geocodes |centers| with |ids| which are in the same cell.
+  void GetNearbyAddressesInCell(std::vector<m2::PointD> const & centers,
+                                std::vector<size_t> const & ids, double maxDistanceM,
+                                HouseTable & table, BuildingStreets & streets,
+                                std::vector<Address> & addrs) const;
+
   /// Old data compatible method to retrieve nearby streets.
   void GetNearbyStreetsWaysOnly(MwmSet::MwmId const & id, m2::PointD const & center,
                                 std::vector<Street> & streets) const;
@@ -183,6 +229,11 @@ private:
                           std::vector<Building> & buildings) const;
 
   static Building FromFeature(FeatureType & ft, double distMeters);
+
+  base::thread_pool::computational::ThreadPool & GetBatchPool(size_t numThreads) const;
+
+  mutable std::mutex m_batchPoolsMutex;
+  mutable std::map<size_t, std::unique_ptr<base::thread_pool::computational::ThreadPool>> m_batchPools;
 };
 
 } // namespace search
@@ -2710,6 +2710,57 @@ UNIT_CLASS_TEST(ProcessorTest, FilterVillages)
   }
 }
 
+UNIT_CLASS_TEST(ProcessorTest, ParallelGeocoding)
+{
+  TestCity city({0.0, 0.0}, "Lenina", "en", 100 /* rank */);
+
+  vector<TestPOI> cafes;
+  vector<TestStreet> streets;
+  for (size_t i = 0; i < 5; ++i)
+  {
+    double const x = 2.0 * static_cast<double>(i);
+    cafes.emplace_back(m2::PointD(x, 0.5), "Lenina cafe", "en");
+    streets.emplace_back(vector<m2::PointD>{{x, -1.0}, {x, 1.0}}, "Lenina street", "en");
+  }
+
+  for (size_t i = 0; i < cafes.size(); ++i)
+  {
+    BuildCountry("Country" + strings::to_string(i), [&](TestMwmBuilder & builder) {
+      builder.Add(cafes[i]);
+      builder.Add(streets[i]);
+    });
+  }
+
+  BuildWorld([&](TestMwmBuilder & builder) { builder.Add(city); });
+
+  SearchParams params;
+  params.m_query = "Lenina";
+  params.m_inputLocale = "en";
+  params.m_viewport = m2::RectD(-1.0, -1.0, 1.0, 1.0);
+  params.m_mode = Mode::Everywhere;
+  params.m_maxNumResults = 2 * cafes.size() + 1;
+
+  TestSearchRequest sequential(m_engine, params);
+  sequential.Run();
+  TEST(!sequential.Results().empty(), ());
+
+  // Results and their order must not depend on the number of geocoder threads
+  // including the case when the last wave of mwms is not full.
+  for (size_t const numThreads : {2, 3, 8})
+  {
+    params.m_numGeocoderThreads = numThreads;
+
+    TestSearchRequest parallel(m_engine, params);
+    parallel.Run();
+
+    auto const & expected = sequential.Results();
+    auto const & actual = parallel.Results();
+    TEST_EQUAL(expected.size(), actual.size(), (numThreads));
+    for (size_t i = 0; i < expected.size(); ++i)
+      TEST_EQUAL(expected[i].GetFeatureID(), actual[i].GetFeatureID(), (numThreads, i));
+  }
+}
+
 UNIT_CLASS_TEST(ProcessorTest, MatchedFraction)
 {
   string const countryName = "Wonderland";
@@ -0,0 +1,115 @@
+#include "testing/testing.hpp"
+
+#include "search/address_index.hpp"
+#include "search/reverse_geocoder.hpp"
+#include "search/search_tests_support/helpers.hpp"
+
+#include "generator/generator_tests_support/test_feature.hpp"
+#include "generator/generator_tests_support/test_mwm_builder.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace generator::tests_support;
+using namespace search;
+using namespace std;
+
+namespace
+{
+class ReverseGeocoderTest : public SearchTest
+{
+};
+
+UNIT_CLASS_TEST(ReverseGeocoderTest, AddressIndex)
+{
+  TestStreet street({{0.0, 0.0}, {0.004, 0.0}}, "Lenina street", "en");
+  TestBuilding house1({0.001, 0.0003}, "", "1", street.GetName("en"), "en");
+  TestBuilding house2({0.003, 0.0003}, "", "2", street.GetName("en"), "en");
+  // The house has no street, so it's not in the address index.
+  TestBuilding house3({0.0013, -0.0003}, "", "3", "en");
+
+  auto const id = BuildCountry("Wonderland", [&](TestMwmBuilder & builder)
+  {
+    builder.Add(street);
+    builder.Add(house1);
+    builder.Add(house2);
+    builder.Add(house3);
+  });
+
+  {
+    auto handle = m_dataSource.GetMwmHandleById(id);
+    TEST(handle.IsAlive(), ());
+    TEST(AddressIndex::Load(*handle.GetValue()), ());
+  }
+
+  ReverseGeocoder const coder(m_dataSource);
+
+  vector<m2::PointD> const points = {
+      {0.0011, 0.0003}, {0.0029, 0.0003}, {0.0013, -0.0003}, {0.002, 0.05}};
+  vector<string> const houses = {"1", "2", "1", ""};
+
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    ReverseGeocoder::Address addr;
+    coder.GetNearbyAddress(points[i], addr);
+    TEST_EQUAL(addr.GetHouseNumber(), houses[i], (points[i]));
+    TEST_EQUAL(addr.IsValid(), !houses[i].empty(), (points[i]));
+    if (addr.IsValid())
+      TEST_EQUAL(addr.GetStreetName(), "Lenina street", (points[i]));
+  }
+
+  {
+    ReverseGeocoder::Address addr;
+    coder.GetNearbyAddress(points[0], 0.0 /* maxDistanceM */, addr);
+    TEST(!addr.IsValid(), ());
+
+    coder.GetNearbyAddress(house2.GetCenter(), 0.0 /* maxDistanceM */, addr);
+    TEST_EQUAL(addr.GetHouseNumber(), "2", ());
+    TEST_EQUAL(addr.GetDistance(), 0.0, ());
+  }
+
+  vector<ReverseGeocoder::Address> addrs;
+  coder.GetNearbyAddresses(points, ReverseGeocoder::kLookupRadiusM, 2 /* numThreads */, addrs);
+  TEST_EQUAL(addrs.size(), points.size(), ());
+  for (size_t i = 0; i < points.size(); ++i)
+    TEST_EQUAL(addrs[i].GetHouseNumber(), houses[i], (points[i]));
+}
+
+UNIT_CLASS_TEST(ReverseGeocoderTest, AddressIndexCache)
+{
+  TestStreet street({{0.0, 0.0}, {0.004, 0.0}}, "Lenina street", "en");
+  TestBuilding house({0.001, 0.0003}, "", "1", street.GetName("en"), "en");
+
+  auto const id = BuildCountry("Wonderland", [&](TestMwmBuilder & builder)
+  {
+    builder.Add(street);
+    builder.Add(house);
+  });
+
+  auto & cache = AddressIndexCache::Instance();
+  cache.Clear();
+  m_dataSource.AddObserver(cache);
+
+  // The index is loaded once and is shared by reverse geocoders.
+  auto const index = cache.Get(m_dataSource, id);
+  TEST(index, ());
+  TEST_EQUAL(cache.Get(m_dataSource, id), index, ());
+  TEST_EQUAL(cache.GetNumEntries(), 1, ());
+
+  {
+    ReverseGeocoder::Address addr;
+    ReverseGeocoder(m_dataSource).GetNearbyAddress({0.0011, 0.0003}, addr);
+    TEST_EQUAL(addr.GetHouseNumber(), "1", ());
+    TEST_EQUAL(cache.GetNumEntries(), 1, ());
+  }
+
+  DeregisterMap("Wonderland");
+  TEST_EQUAL(cache.GetNumEntries(), 0, ());
+  TEST(!cache.Get(m_dataSource, id), ());
+
+  m_dataSource.RemoveObserver(cache);
+  cache.Clear();
+}
+}  // namespace
@@ -22,6 +22,21 @@ class SearchEditedFeaturesTest : public SearchTest
 {
 };
 
+class SearchEditedFeaturesSharedCacheTest : public SearchTest
+{
+public:
+  SearchEditedFeaturesSharedCacheTest() : SearchTest(Engine::Params("en", 2 /* numThreads */))
+  {
+    // Caches are cleared after edits the same way as in the Framework.
+    osm::Editor::Instance().SetInvalidateFn([this]() { m_engine.ClearCaches(); });
+  }
+
+  ~SearchEditedFeaturesSharedCacheTest() override
+  {
+    osm::Editor::Instance().SetInvalidateFn({});
+  }
+};
+
 UNIT_CLASS_TEST(SearchEditedFeaturesTest, Smoke)
 {
   TestCity city(m2::PointD(0, 0), "Quahog", "default", 100 /* rank */);
@@ -146,6 +161,40 @@ UNIT_CLASS_TEST(SearchEditedFeaturesTest, SearchInViewport)
   }
 }
 
+UNIT_CLASS_TEST(SearchEditedFeaturesSharedCacheTest, CreatedFeatureInViewport)
+{
+  TestPOI bakery0(m2::PointD(0, 0), "French Bakery 0", "default");
+  // Need this POI for mwm bounding box.
+  TestPOI dummy(m2::PointD(2, 2), "dummy", "default");
+  auto & editor = osm::Editor::Instance();
+
+  auto const countryId = BuildCountry("Equestria", [&](TestMwmBuilder & builder) {
+    builder.Add(bakery0);
+    builder.Add(dummy);
+  });
+
+  SetViewport(m2::RectD(-1.0, -1.0, 1.5, 1.5));
+
+  // Both search threads run the query, so the features of the viewport get
+  // into the shared cache.
+  for (size_t i = 0; i < 2; ++i)
+  {
+    Rules const rules = {ExactMatch(countryId, bakery0)};
+
+    TEST(ResultsMatch("french bakery", Mode::Viewport, rules), ());
+  }
+
+  auto const tmp = TestPOI::AddWithEditor(editor, countryId, "French Bakery1", {1.0, 1.0});
+  TestPOI const & bakery1 = tmp.first;
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    Rules const rules = {ExactMatch(countryId, bakery0), ExactMatch(countryId, bakery1)};
+
+    TEST(ResultsMatch("french bakery", Mode::Viewport, rules), ());
+  }
+}
+
 UNIT_CLASS_TEST(SearchEditedFeaturesTest, ViewportFilter)
 {
   TestCafe restaurant(m2::PointD(0.0, 0.0), "Pushkin", "default");
@@ -83,6 +83,10 @@ struct SearchParams
 
   Mode m_mode = Mode::Everywhere;
 
+  // Number of threads which geocode mwms of the request in parallel. Mwms are geocoded
+  // one by one on the thread of the request if it's 1.
+  size_t m_numGeocoderThreads = 1;
+
   // Needed to generate search suggests.
   bool m_suggestsEnabled = false;
 
@@ -179,9 +179,7 @@ unique_ptr<search::tests_support::TestSearchEngine> InitSearchEngine(
     DataSource & dataSource, storage::Affiliations const & affiliations, string const & locale,
     size_t numThreads)
 {
-  search::Engine::Params params;
-  params.m_locale = locale;
-  params.m_numThreads = base::checked_cast<size_t>(numThreads);
+  search::Engine::Params params(locale, numThreads);
 
   auto infoGetter = storage::CountryInfoReader::CreateCountryInfoGetter(GetPlatform());
   infoGetter->SetAffiliations(&affiliations);
@@ -0,0 +1,156 @@
+#include "search/search_quality/helpers.hpp"
+
+#include "search/reverse_geocoder.hpp"
+
+#include "indexer/classificator_loader.hpp"
+#include "indexer/data_source.hpp"
+
+#include "platform/platform_tests_support/helpers.hpp"
+
+#include "geometry/mercator.hpp"
+#include "geometry/point2d.hpp"
+
+#include "base/logging.hpp"
+#include "base/string_utils.hpp"
+#include "base/timer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+using namespace search::search_quality;
+using namespace search;
+using namespace std;
+
+DEFINE_string(data_path, "", "Path to data directory (resources dir)");
+DEFINE_string(mwm_path, "", "Path to mwm files (writable dir)");
+DEFINE_string(mwm_list_path, "",
+              "Path to a file containing the names of available mwms, one per line");
+DEFINE_string(points_path, "",
+              "Path to a file with points to reverse geocode, \"lat lon\" one per line. "
+              "When empty, random points around (center_lat, center_lon) are used");
+DEFINE_double(center_lat, 53.8978, "Latitude of the center of random points");
+DEFINE_double(center_lon, 27.5561, "Longitude of the center of random points");
+DEFINE_double(spread_m, 5000.0, "Max distance of random points from the center in meters");
+DEFINE_uint64(num_points, 100000, "Number of random points");
+DEFINE_uint64(seed, 0, "Seed of random points");
+DEFINE_double(max_distance_m, ReverseGeocoder::kLookupRadiusM,
+              "Max distance to the building of an address");
+DEFINE_uint64(num_threads, 1, "Number of threads of the batch reverse geocoding");
+DEFINE_bool(compare, false,
+            "Reverse geocode every point separately too and compare throughput and results");
+
+namespace
+{
+bool ReadPoints(string const & path, vector<m2::PointD> & points)
+{
+  vector<string> lines;
+  ReadStringsFromFile(path, lines);
+  for (auto const & line : lines)
+  {
+    vector<string> parts;
+    strings::Tokenize(line, " \t,", [&parts](string_view part) { parts.emplace_back(part); });
+    if (parts.empty())
+      continue;
+
+    double lat, lon;
+    if (parts.size() != 2 || !strings::to_double(parts[0], lat) ||
+        !strings::to_double(parts[1], lon))
+    {
+      LOG(LERROR, ("Can't parse point:", line));
+      return false;
+    }
+    points.push_back(mercator::FromLatLon(lat, lon));
+  }
+  return true;
+}
+
+void GenerateRandomPoints(vector<m2::PointD> & points)
+{
+  auto const rect = mercator::RectByCenterXYAndSizeInMeters(
+      mercator::FromLatLon(FLAGS_center_lat, FLAGS_center_lon), FLAGS_spread_m);
+
+  mt19937 rng(static_cast<uint32_t>(FLAGS_seed));
+  uniform_real_distribution<double> x(rect.minX(), rect.maxX());
+  uniform_real_distribution<double> y(rect.minY(), rect.maxY());
+
+  points.reserve(FLAGS_num_points);
+  for (uint64_t i = 0; i < FLAGS_num_points; ++i)
+    points.emplace_back(x(rng), y(rng));
+}
+
+size_t CountValid(vector<ReverseGeocoder::Address> const & addrs)
+{
+  size_t count = 0;
+  for (auto const & addr : addrs)
+  {
+    if (addr.IsValid())
+      ++count;
+  }
+  return count;
+}
+
+void PrintStats(string const & name, size_t numPoints, size_t numValid, double seconds)
+{
+  cout << name << ": " << numValid << " of " << numPoints << " addresses found in " << fixed
+       << setprecision(3) << seconds << "s, "
+       << setprecision(1) << (seconds > 0 ? numPoints / seconds : 0.0) << " points/s" << endl;
+}
+}  // namespace
+
+int main(int argc, char * argv[])
+{
+  platform::tests_support::ChangeMaxNumberOfOpenFiles(kMaxOpenFiles);
+  CheckLocale();
+
+  gflags::SetUsageMessage("Reverse geocoding benchmark.");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  SetPlatformDirs(FLAGS_data_path, FLAGS_mwm_path);
+
+  classificator::Load();
+
+  FrozenDataSource dataSource;
+  InitDataSource(dataSource, FLAGS_mwm_list_path);
+
+  vector<m2::PointD> points;
+  if (FLAGS_points_path.empty())
+    GenerateRandomPoints(points);
+  else if (!ReadPoints(FLAGS_points_path, points))
+    return -1;
+
+  ReverseGeocoder const coder(dataSource);
+
+  vector<ReverseGeocoder::Address> addrs;
+  base::Timer timer;
+  coder.GetNearbyAddresses(points, FLAGS_max_distance_m, FLAGS_num_threads, addrs);
+  PrintStats("Batch, " + strings::to_string(FLAGS_num_threads) + " thread(s)", points.size(),
+             CountValid(addrs), timer.ElapsedSeconds());
+
+  if (!FLAGS_compare)
+    return 0;
+
+  vector<ReverseGeocoder::Address> singleAddrs(points.size());
+  timer.Reset();
+  for (size_t i = 0; i < points.size(); ++i)
+    coder.GetNearbyAddress(points[i], FLAGS_max_distance_m, singleAddrs[i]);
+  PrintStats("Single points", points.size(), CountValid(singleAddrs), timer.ElapsedSeconds());
+
+  size_t numSame = 0;
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    if (addrs[i].m_building.m_id == singleAddrs[i].m_building.m_id &&
+        addrs[i].GetStreetName() == singleAddrs[i].GetStreetName())
+    {
+      ++numSame;
+    }
+  }
+  cout << "Same addresses: " << numSame << " of " << points.size() << endl;
+  return 0;
+}
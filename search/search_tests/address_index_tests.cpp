@@ -0,0 +1,180 @@
+#include "testing/testing.hpp"
+
+#include "search/address_index.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "geometry/mercator.hpp"
+
+#include "base/math.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace address_index_tests
+{
+using namespace search;
+using namespace std;
+
+using Entry = AddressIndex::Entry;
+
+unique_ptr<AddressIndex> Build(AddressIndexBuilder const & builder, vector<uint8_t> & buffer)
+{
+  {
+    MemWriter<vector<uint8_t>> writer(buffer);
+    builder.Freeze(writer);
+  }
+  return AddressIndex::Load(MemReader(buffer.data(), buffer.size()));
+}
+
+double GetDistanceMeters(m2::PointD const & point, m2::RectD const & rect)
+{
+  m2::PointD const closest(base::Clamp(point.x, rect.minX(), rect.maxX()),
+                           base::Clamp(point.y, rect.minY(), rect.maxY()));
+  return mercator::DistanceOnEarth(point, closest);
+}
+
+// Pairs of building ids and distances in order of visiting.
+vector<pair<uint32_t, double>> GetVisited(AddressIndex const & index, m2::PointD const & center,
+                                          double maxDistanceM)
+{
+  vector<pair<uint32_t, double>> visited;
+  index.ForEachByDistance(center, maxDistanceM, [&](Entry const & entry, double distanceM)
+  {
+    visited.emplace_back(entry.m_buildingId, distanceM);
+    return true;
+  });
+  return visited;
+}
+
+UNIT_TEST(AddressIndex_Smoke)
+{
+  auto const center = mercator::FromLatLon(53.9, 27.56);
+  auto const rect = [&center](double dxM, double dyM, double sizeM)
+  {
+    auto const p = mercator::GetSmPoint(center, dxM, dyM);
+    return mercator::RectByCenterXYAndSizeInMeters(p, sizeM);
+  };
+
+  AddressIndexBuilder builder;
+  builder.Put(10 /* buildingId */, 3 /* streetId */, rect(0, 0, 10));
+  builder.Put(20 /* buildingId */, 1000 /* streetId */, rect(100, 0, 10));
+  builder.Put(5 /* buildingId */, 7 /* streetId */, rect(0, -300, 10));
+  // A large building which spans several cells.
+  builder.Put(30 /* buildingId */, 3 /* streetId */, rect(-1000, 0, 600));
+  // A far building.
+  builder.Put(40 /* buildingId */, 3 /* streetId */, rect(5000, 5000, 10));
+  TEST_EQUAL(builder.GetNumBuildings(), 5, ());
+
+  vector<uint8_t> buffer;
+  auto const index = Build(builder, buffer);
+  TEST(index, ());
+  TEST_GREATER(index->GetNumCells(), 5, ());
+
+  map<uint32_t, Entry> entries;
+  index->ForEachByDistance(center, 10000 /* maxDistanceM */,
+                           [&entries](Entry const & entry, double /* distanceM */)
+  {
+    TEST(entries.emplace(entry.m_buildingId, entry).second, (entry.m_buildingId));
+    return true;
+  });
+  TEST_EQUAL(entries.size(), 5, ());
+  TEST_EQUAL(entries[10].m_streetId, 3, ());
+  TEST_EQUAL(entries[20].m_streetId, 1000, ());
+  TEST_EQUAL(entries[5].m_streetId, 7, ());
+  TEST(entries[10].m_rect.IsPointInside(center), ());
+  TEST(entries[30].m_rect.IsRectInside(rect(-1000, 0, 599)), ());
+
+  auto const visited = GetVisited(*index, center, 1000 /* maxDistanceM */);
+  TEST_EQUAL(visited.size(), 4, (visited));
+  TEST_EQUAL(visited[0].first, 10, ());
+  TEST_EQUAL(visited[0].second, 0.0, ());
+  TEST_EQUAL(visited[1].first, 20, ());
+  TEST_EQUAL(visited[2].first, 5, ());
+  TEST_EQUAL(visited[3].first, 30, ());
+  TEST_ALMOST_EQUAL_ABS(visited[3].second, 400.0, 10.0, ());
+
+  // Visiting stops when the visitor returns false.
+  size_t count = 0;
+  index->ForEachByDistance(center, 1000 /* maxDistanceM */, [&count](Entry const &, double)
+  {
+    ++count;
+    return count < 2;
+  });
+  TEST_EQUAL(count, 2, ());
+
+  TEST(GetVisited(*index, mercator::GetSmPoint(center, 0, 3000), 500).empty(), ());
+}
+
+UNIT_TEST(AddressIndex_Order)
+{
+  auto const center = mercator::FromLatLon(55.75, 37.62);
+
+  mt19937 rng(0);
+  uniform_real_distribution<double> offset(-2000.0, 2000.0);
+  uniform_real_distribution<double> size(5.0, 200.0);
+
+  AddressIndexBuilder builder;
+  vector<m2::RectD> rects;
+  for (uint32_t i = 0; i < 2000; ++i)
+  {
+    auto const p = mercator::GetSmPoint(center, offset(rng), offset(rng));
+    rects.push_back(mercator::RectByCenterXYAndSizeInMeters(p, size(rng)));
+    builder.Put(i * 3 /* buildingId */, i /* streetId */, rects.back());
+  }
+
+  vector<uint8_t> buffer;
+  auto const index = Build(builder, buffer);
+  TEST(index, ());
+
+  for (size_t i = 0; i < 20; ++i)
+  {
+    auto const point = mercator::GetSmPoint(center, offset(rng), offset(rng));
+    double const maxDistanceM = 500.0;
+
+    // Decoded rects are a bit larger, so the buildings near the border may be visited too.
+    size_t minExpected = 0;
+    size_t maxExpected = 0;
+    for (auto const & r : rects)
+    {
+      auto const distance = GetDistanceMeters(point, r);
+      if (distance < maxDistanceM - 1.0)
+        ++minExpected;
+      if (distance <= maxDistanceM + 1.0)
+        ++maxExpected;
+    }
+
+    auto const visited = GetVisited(*index, point, maxDistanceM);
+    for (size_t j = 1; j < visited.size(); ++j)
+      TEST_LESS_OR_EQUAL(visited[j - 1].second, visited[j].second, (j));
+
+    for (auto const & v : visited)
+    {
+      TEST_EQUAL(v.first % 3, 0, ());
+      TEST_ALMOST_EQUAL_ABS(v.second, GetDistanceMeters(point, rects[v.first / 3]), 1.0, ());
+    }
+
+    TEST_GREATER_OR_EQUAL(visited.size(), minExpected, ());
+    TEST_LESS_OR_EQUAL(visited.size(), maxExpected, ());
+  }
+}
+
+UNIT_TEST(AddressIndex_UnknownVersion)
+{
+  AddressIndexBuilder builder;
+  builder.Put(10 /* buildingId */, 3 /* streetId */,
+              mercator::RectByCenterXYAndSizeInMeters(mercator::FromLatLon(53.9, 27.56), 10));
+
+  vector<uint8_t> buffer;
+  TEST(Build(builder, buffer), ());
+
+  // The version is the first byte of the section.
+  buffer[0] = static_cast<uint8_t>(AddressIndex::Version::Latest) + 1;
+  TEST(!AddressIndex::Load(MemReader(buffer.data(), buffer.size())), ());
+}
+}  // namespace address_index_tests
@@ -0,0 +1,240 @@
+#include "testing/testing.hpp"
+
+#include "search/cbv.hpp"
+#include "search/shared_features_cache.hpp"
+
+#include "indexer/indexer_tests/test_mwm_set.hpp"
+
+#include "coding/compressed_bit_vector.hpp"
+
+#include "platform/country_file.hpp"
+#include "platform/local_country_file.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace shared_features_cache_tests
+{
+using namespace search;
+using namespace std;
+using platform::CountryFile;
+using platform::LocalCountryFile;
+using tests::TestMwmSet;
+
+using GeometryEntry = SharedFeaturesCache::GeometryEntry;
+
+CBV MakeCBV(vector<uint64_t> const & setBits)
+{
+  return CBV(coding::CompressedBitVectorBuilder::FromBitPositions(setBits));
+}
+
+vector<uint64_t> GetBits(CBV const & cbv)
+{
+  vector<uint64_t> bits;
+  cbv.ForEach([&bits](uint64_t bit) { bits.push_back(bit); });
+  return bits;
+}
+
+GeometryEntry MakeEntry(m2::RectD const & rect, int scale, vector<uint64_t> const & setBits)
+{
+  GeometryEntry entry;
+  entry.m_rect = rect;
+  entry.m_scale = scale;
+  entry.m_cbv = MakeCBV(setBits);
+  return entry;
+}
+
+UNIT_TEST(SharedFeaturesCache_Categories)
+{
+  TestMwmSet mwmSet;
+  auto const id0 = mwmSet.Register(LocalCountryFile::MakeForTesting("0")).first;
+  auto const id1 = mwmSet.Register(LocalCountryFile::MakeForTesting("1")).first;
+
+  SharedFeaturesCache cache(1024 * 1024);
+
+  CBV cbv;
+  TEST(!cache.GetCategories(id0, {1, 2}, cbv), ());
+
+  cache.PutCategories(id0, {1, 2}, MakeCBV({1, 5, 7}), cache.GetGeneration());
+  cache.PutCategories(id1, {1, 2}, MakeCBV({3}), cache.GetGeneration());
+  TEST_EQUAL(cache.GetNumEntries(), 2, ());
+
+  TEST(cache.GetCategories(id0, {1, 2}, cbv), ());
+  TEST_EQUAL(GetBits(cbv), vector<uint64_t>({1, 5, 7}), ());
+  TEST(cache.GetCategories(id1, {1, 2}, cbv), ());
+  TEST_EQUAL(GetBits(cbv), vector<uint64_t>({3}), ());
+
+  TEST(!cache.GetCategories(id0, {1}, cbv), ());
+  TEST(!cache.GetCategories(id0, {1, 2, 3}, cbv), ());
+
+  // Features of the same categories are not replaced.
+  cache.PutCategories(id0, {1, 2}, MakeCBV({2}), cache.GetGeneration());
+  TEST_EQUAL(cache.GetNumEntries(), 2, ());
+  TEST(cache.GetCategories(id0, {1, 2}, cbv), ());
+  TEST_EQUAL(GetBits(cbv), vector<uint64_t>({1, 5, 7}), ());
+
+  cache.Clear();
+  TEST_EQUAL(cache.GetNumEntries(), 0, ());
+  TEST_EQUAL(cache.GetMemoryUsage(), 0, ());
+  TEST(!cache.GetCategories(id0, {1, 2}, cbv), ());
+}
+
+UNIT_TEST(SharedFeaturesCache_Generation)
+{
+  TestMwmSet mwmSet;
+  auto const id = mwmSet.Register(LocalCountryFile::MakeForTesting("0")).first;
+
+  SharedFeaturesCache cache(1024 * 1024);
+
+  // Features are loaded, then the cache is cleared after a map edit.
+  auto const generation = cache.GetGeneration();
+  cache.Clear();
+  TEST_NOT_EQUAL(cache.GetGeneration(), generation, ());
+
+  // Features loaded before the edit are not cached.
+  cache.PutCategories(id, {1}, MakeCBV({1}), generation);
+  cache.PutGeometry(id, MakeEntry(m2::RectD(0, 0, 1, 1), 10, {1}), generation);
+  TEST_EQUAL(cache.GetNumEntries(), 0, ());
+
+  cache.PutCategories(id, {1}, MakeCBV({2}), cache.GetGeneration());
+  CBV cbv;
+  TEST(cache.GetCategories(id, {1}, cbv), ());
+  TEST_EQUAL(GetBits(cbv), vector<uint64_t>({2}), ());
+}
+
+UNIT_TEST(SharedFeaturesCache_Geometry)
+{
+  TestMwmSet mwmSet;
+  auto const id = mwmSet.Register(LocalCountryFile::MakeForTesting("0")).first;
+
+  SharedFeaturesCache cache(1024 * 1024);
+
+  m2::RectD const small(0, 0, 1, 1);
+  m2::RectD const large(-1, -1, 2, 2);
+
+  cache.PutGeometry(id, MakeEntry(small, 10, {1}), cache.GetGeneration());
+  cache.PutGeometry(id, MakeEntry(large, 10, {1, 2}), cache.GetGeneration());
+  cache.PutGeometry(id, MakeEntry(large, 11, {1, 2, 3}), cache.GetGeneration());
+
+  auto const inside = [](m2::RectD const & rect, int scale)
+  {
+    return [rect, scale](GeometryEntry const & entry)
+    {
+      return entry.m_scale == scale && entry.m_rect.IsRectInside(rect);
+    };
+  };
+
+  GeometryEntry entry;
+  // The most recently used entry is preferred.
+  TEST(cache.GetGeometry(id, inside(small, 10), entry), ());
+  TEST_EQUAL(entry.m_rect, large, ());
+  TEST_EQUAL(GetBits(entry.m_cbv), vector<uint64_t>({1, 2}), ());
+
+  TEST(cache.GetGeometry(id, inside(large, 11), entry), ());
+  TEST_EQUAL(GetBits(entry.m_cbv), vector<uint64_t>({1, 2, 3}), ());
+
+  TEST(!cache.GetGeometry(id, inside(m2::RectD(5, 5, 6, 6), 10), entry), ());
+  TEST(!cache.GetGeometry(id, inside(small, 12), entry), ());
+}
+
+UNIT_TEST(SharedFeaturesCache_Eviction)
+{
+  TestMwmSet mwmSet;
+  auto const id = mwmSet.Register(LocalCountryFile::MakeForTesting("0")).first;
+
+  vector<uint64_t> bits;
+  for (uint64_t i = 0; i < 1000; ++i)
+    bits.push_back(i * 100);
+  auto const bytes = MakeCBV(bits).GetMemoryUsage();
+  TEST_GREATER(bytes, 0, ());
+
+  // Three bit vectors fit into the cache.
+  SharedFeaturesCache cache(bytes * 3 + bytes / 2);
+  cache.PutCategories(id, {1}, MakeCBV(bits), cache.GetGeneration());
+  cache.PutCategories(id, {2}, MakeCBV(bits), cache.GetGeneration());
+  cache.PutCategories(id, {3}, MakeCBV(bits), cache.GetGeneration());
+  TEST_EQUAL(cache.GetNumEntries(), 3, ());
+
+  CBV cbv;
+  TEST(cache.GetCategories(id, {1}, cbv), ());
+
+  // {2} is the least recently used one.
+  cache.PutCategories(id, {4}, MakeCBV(bits), cache.GetGeneration());
+  TEST_EQUAL(cache.GetNumEntries(), 3, ());
+  TEST_LESS_OR_EQUAL(cache.GetMemoryUsage(), bytes * 3 + bytes / 2, ());
+  TEST(cache.GetCategories(id, {1}, cbv), ());
+  TEST(!cache.GetCategories(id, {2}, cbv), ());
+  TEST(cache.GetCategories(id, {3}, cbv), ());
+  TEST(cache.GetCategories(id, {4}, cbv), ());
+}
+
+UNIT_TEST(SharedFeaturesCache_Deregistration)
+{
+  TestMwmSet mwmSet;
+  SharedFeaturesCache cache(1024 * 1024);
+  TEST(mwmSet.AddObserver(cache), ());
+
+  auto const id0 = mwmSet.Register(LocalCountryFile::MakeForTesting("0")).first;
+  auto const id1 = mwmSet.Register(LocalCountryFile::MakeForTesting("1")).first;
+
+  cache.PutCategories(id0, {1}, MakeCBV({1}), cache.GetGeneration());
+  cache.PutGeometry(id0, MakeEntry(m2::RectD(0, 0, 1, 1), 10, {1}), cache.GetGeneration());
+  cache.PutCategories(id1, {1}, MakeCBV({2}), cache.GetGeneration());
+  TEST_EQUAL(cache.GetNumEntries(), 3, ());
+
+  mwmSet.Deregister(CountryFile("0"));
+  TEST_EQUAL(cache.GetNumEntries(), 1, ());
+
+  CBV cbv;
+  TEST(!cache.GetCategories(id0, {1}, cbv), ());
+  TEST(cache.GetCategories(id1, {1}, cbv), ());
+
+  // Features of deregistered mwms are not cached.
+  cache.PutCategories(id0, {1}, MakeCBV({1}), cache.GetGeneration());
+  TEST_EQUAL(cache.GetNumEntries(), 1, ());
+
+  TEST(mwmSet.RemoveObserver(cache), ());
+}
+
+UNIT_TEST(SharedFeaturesCache_Threads)
+{
+  TestMwmSet mwmSet;
+  auto const id = mwmSet.Register(LocalCountryFile::MakeForTesting("0")).first;
+
+  SharedFeaturesCache cache(1024 * 1024);
+
+  size_t constexpr kNumThreads = 4;
+  size_t constexpr kNumIterations = 1000;
+
+  vector<thread> threads;
+  atomic<size_t> numErrors{0};
+  for (size_t i = 0; i < kNumThreads; ++i)
+  {
+    threads.emplace_back([&]()
+    {
+      for (size_t j = 0; j < kNumIterations; ++j)
+      {
+        uint32_t const type = static_cast<uint32_t>(j % 16);
+        CBV cbv;
+        if (!cache.GetCategories(id, {type}, cbv))
+        {
+          cbv = MakeCBV({type, type + 100});
+          cache.PutCategories(id, {type}, cbv, cache.GetGeneration());
+        }
+
+        // Copies of shared bit vectors are intersected in every thread.
+        auto const result = cbv.Intersect(MakeCBV({type}));
+        if (GetBits(result) != vector<uint64_t>({type}))
+          ++numErrors;
+      }
+    });
+  }
+  for (auto & t : threads)
+    t.join();
+
+  TEST_EQUAL(numErrors.load(), 0, ());
+  TEST_EQUAL(cache.GetNumEntries(), 16, ());
+}
+}  // namespace shared_features_cache_tests
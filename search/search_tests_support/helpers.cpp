@@ -12,9 +12,11 @@ namespace search
 using namespace std;
 using namespace tests_support;
 
-SearchTest::SearchTest()
+SearchTest::SearchTest() : SearchTest(Engine::Params{}) {}
+
+SearchTest::SearchTest(Engine::Params const & params)
   : m_scopedLog(LDEBUG)
-  , m_engine(m_dataSource, make_unique<storage::CountryInfoGetterForTesting>(), Engine::Params{})
+  , m_engine(m_dataSource, make_unique<storage::CountryInfoGetterForTesting>(), params)
 {
   SetViewport(mercator::Bounds::FullRect());
 }
@@ -26,6 +26,8 @@ public:
 
   void LoadCitiesBoundaries() { m_engine.LoadCitiesBoundaries(); }
 
+  void ClearCaches() { m_engine.ClearCaches(); }
+
   std::weak_ptr<ProcessorHandle> Search(SearchParams const & params);
 
   storage::CountryInfoGetter & GetCountryInfoGetter() { return *m_infoGetter; }
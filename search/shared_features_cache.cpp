@@ -0,0 +1,187 @@
+#include "search/shared_features_cache.hpp"
+
+#include "base/assert.hpp"
+#include "base/stl_helpers.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace search
+{
+namespace
+{
+// Approximate memory taken by a cache item besides its bit vector.
+size_t constexpr kItemOverheadBytes = 128;
+}  // namespace
+
+SharedFeaturesCache::SharedFeaturesCache(size_t maxBytes) : m_maxBytes(maxBytes)
+{
+  CHECK_GREATER(m_maxBytes, 0, ());
+}
+
+uint64_t SharedFeaturesCache::GetGeneration() const
+{
+  lock_guard<mutex> lock(m_mu);
+  return m_generation;
+}
+
+bool SharedFeaturesCache::GetCategories(MwmSet::MwmId const & id,
+                                        vector<uint32_t> const & types, CBV & cbv)
+{
+  ASSERT(is_sorted(types.begin(), types.end()), ());
+
+  lock_guard<mutex> lock(m_mu);
+
+  auto const it = m_categories.find(CategoriesKey(id, types));
+  if (it == m_categories.end())
+    return false;
+
+  Touch(it->second);
+  cbv = it->second->m_entry.m_cbv;
+  return true;
+}
+
+void SharedFeaturesCache::PutCategories(MwmSet::MwmId const & id, vector<uint32_t> const & types,
+                                        CBV const & cbv, uint64_t generation)
+{
+  ASSERT(is_sorted(types.begin(), types.end()), ());
+
+  if (!id.IsAlive())
+    return;
+
+  lock_guard<mutex> lock(m_mu);
+
+  // Features are loaded before the cache is cleared.
+  if (generation != m_generation)
+    return;
+
+  // Another processor may have loaded the same features in the meantime.
+  auto const it = m_categories.find(CategoriesKey(id, types));
+  if (it != m_categories.end())
+  {
+    Touch(it->second);
+    return;
+  }
+
+  Item item;
+  item.m_mwmId = id;
+  item.m_types = types;
+  item.m_entry.m_cbv = cbv;
+  Insert(move(item));
+
+  m_categories[CategoriesKey(id, types)] = m_items.begin();
+  EvictIfNeeded();
+}
+
+void SharedFeaturesCache::PutGeometry(MwmSet::MwmId const & id, GeometryEntry const & entry,
+                                      uint64_t generation)
+{
+  if (!id.IsAlive())
+    return;
+
+  lock_guard<mutex> lock(m_mu);
+
+  if (generation != m_generation)
+    return;
+
+  auto const it = m_geometry.find(id);
+  if (it != m_geometry.end() && it->second.size() == kMaxGeometryEntriesPerMwm)
+  {
+    auto const & items = it->second;
+    auto const oldest = *min_element(items.begin(), items.end(),
+                                     [](Items::iterator const & lhs, Items::iterator const & rhs)
+                                     {
+                                       return lhs->m_lastUse < rhs->m_lastUse;
+                                     });
+    Erase(oldest);
+  }
+
+  Item item;
+  item.m_mwmId = id;
+  item.m_isGeometry = true;
+  item.m_entry = entry;
+  Insert(move(item));
+
+  m_geometry[id].push_back(m_items.begin());
+  EvictIfNeeded();
+}
+
+void SharedFeaturesCache::Clear()
+{
+  lock_guard<mutex> lock(m_mu);
+
+  m_items.clear();
+  m_categories.clear();
+  m_geometry.clear();
+  m_bytes = 0;
+  ++m_generation;
+}
+
+size_t SharedFeaturesCache::GetNumEntries() const
+{
+  lock_guard<mutex> lock(m_mu);
+  return m_items.size();
+}
+
+size_t SharedFeaturesCache::GetMemoryUsage() const
+{
+  lock_guard<mutex> lock(m_mu);
+  return m_bytes;
+}
+
+void SharedFeaturesCache::OnMapDeregistered(platform::LocalCountryFile const & localFile)
+{
+  lock_guard<mutex> lock(m_mu);
+
+  for (auto it = m_items.begin(); it != m_items.end();)
+  {
+    auto const next = std::next(it);
+    if (!it->m_mwmId.IsAlive() || it->m_mwmId.IsDeregistered(localFile))
+      Erase(it);
+    it = next;
+  }
+}
+
+void SharedFeaturesCache::Touch(Items::iterator it)
+{
+  it->m_lastUse = ++m_clock;
+  m_items.splice(m_items.begin(), m_items, it);
+}
+
+void SharedFeaturesCache::Insert(Item && item)
+{
+  item.m_bytes = item.m_entry.m_cbv.GetMemoryUsage() + item.m_types.size() * sizeof(uint32_t) +
+                 kItemOverheadBytes;
+  item.m_lastUse = ++m_clock;
+  m_bytes += item.m_bytes;
+  m_items.push_front(move(item));
+}
+
+void SharedFeaturesCache::Erase(Items::iterator it)
+{
+  if (it->m_isGeometry)
+  {
+    auto const git = m_geometry.find(it->m_mwmId);
+    CHECK(git != m_geometry.end(), ());
+    base::EraseIf(git->second, [&it](Items::iterator const & item) { return item == it; });
+    if (git->second.empty())
+      m_geometry.erase(git);
+  }
+  else
+  {
+    m_categories.erase(CategoriesKey(it->m_mwmId, it->m_types));
+  }
+
+  ASSERT_GREATER_OR_EQUAL(m_bytes, it->m_bytes, ());
+  m_bytes -= it->m_bytes;
+  m_items.erase(it);
+}
+
+void SharedFeaturesCache::EvictIfNeeded()
+{
+  // The most recent item is kept even if it doesn't fit into the budget.
+  while (m_bytes > m_maxBytes && m_items.size() > 1)
+    Erase(prev(m_items.end()));
+}
+}  // namespace search
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "search/cbv.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include "geometry/rect2d.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace search
+{
+// This class represents a cache of features of categories and of
+// features in rects for all mwms which is shared by all search
+// processors. Cached bit vectors are never modified: CBV changes a
+// bit vector in place only when it's not shared.
+//
+// The cache is bounded by |maxBytes|, the least recently used
+// entries are evicted first. Entries of deregistered mwms are
+// dropped when the mwm set notifies about deregistration.
+//
+// Clear() starts a new generation of the cache. Features are put
+// with the generation taken before they are loaded, so features
+// which are loaded before Clear() and put after it are rejected.
+//
+// *NOTE* This class is thread-safe.
+class SharedFeaturesCache : public MwmSet::Observer
+{
+public:
+  struct GeometryEntry
+  {
+    m2::RectD m_rect;
+    int m_scale = 0;
+    CBV m_cbv;
+  };
+
+  explicit SharedFeaturesCache(size_t maxBytes);
+
+  // Generation of the cache which should be taken before features are loaded.
+  uint64_t GetGeneration() const;
+
+  // Features of |types| (and of their subtrees) from mwm |id|. |types| must be sorted.
+  bool GetCategories(MwmSet::MwmId const & id, std::vector<uint32_t> const & types, CBV & cbv);
+  void PutCategories(MwmSet::MwmId const & id, std::vector<uint32_t> const & types,
+                     CBV const & cbv, uint64_t generation);
+
+  // Finds the most recently used entry of mwm |id| which satisfies |pred|.
+  template <typename Pred>
+  bool GetGeometry(MwmSet::MwmId const & id, Pred && pred, GeometryEntry & entry)
+  {
+    std::lock_guard<std::mutex> lock(m_mu);
+
+    auto const it = m_geometry.find(id);
+    if (it == m_geometry.end())
+      return false;
+
+    Items::iterator best = m_items.end();
+    for (auto const & item : it->second)
+    {
+      GeometryEntry const & e = item->m_entry;
+      if (pred(e) && (best == m_items.end() || item->m_lastUse > best->m_lastUse))
+        best = item;
+    }
+
+    if (best == m_items.end())
+      return false;
+
+    Touch(best);
+    entry = best->m_entry;
+    return true;
+  }
+
+  void PutGeometry(MwmSet::MwmId const & id, GeometryEntry const & entry, uint64_t generation);
+
+  void Clear();
+
+  size_t GetNumEntries() const;
+  size_t GetMemoryUsage() const;
+
+  // MwmSet::Observer overrides:
+  void OnMapDeregistered(platform::LocalCountryFile const & localFile) override;
+
+private:
+  // Maximum number of rects cached for a single mwm, bounds the
+  // length of the scan in GetGeometry().
+  static size_t constexpr kMaxGeometryEntriesPerMwm = 64;
+
+  using CategoriesKey = std::pair<MwmSet::MwmId, std::vector<uint32_t>>;
+
+  struct Item
+  {
+    MwmSet::MwmId m_mwmId;
+
+    // Non-empty for categories items only.
+    std::vector<uint32_t> m_types;
+    bool m_isGeometry = false;
+
+    // Only |m_cbv| is used by categories items.
+    GeometryEntry m_entry;
+    size_t m_bytes = 0;
+    uint64_t m_lastUse = 0;
+  };
+
+  // Recently used items are at the front.
+  using Items = std::list<Item>;
+
+  void Touch(Items::iterator it);
+  void Insert(Item && item);
+  void Erase(Items::iterator it);
+  void EvictIfNeeded();
+
+  size_t const m_maxBytes;
+
+  Items m_items;
+  std::map<CategoriesKey, Items::iterator> m_categories;
+  std::map<MwmSet::MwmId, std::vector<Items::iterator>> m_geometry;
+  size_t m_bytes = 0;
+  uint64_t m_clock = 0;
+  uint64_t m_generation = 0;
+
+  mutable std::mutex m_mu;
+};
+}  // namespace search
@@ -89,8 +89,13 @@ void FindStreets(BaseContext const & ctx, CBV const & candidates, FeaturesFilter
     if (fs.IsEmpty())
       return;
 
+    // Only the size of the union of filtered |fa| and |fs| is needed, so the union is not built.
+    uint64_t numAll = fa.PopCount();
     if (filter.NeedToFilter(fa))
-      fa = filter.Filter(fa).Union(fs);
+    {
+      auto const filtered = filter.Filter(fa);
+      numAll = filtered.PopCount() + fs.PopCount() - filtered.IntersectionPopCount(fs);
+    }
 
     predictions.emplace_back();
     auto & prediction = predictions.back();
@@ -98,8 +103,8 @@ void FindStreets(BaseContext const & ctx, CBV const & candidates, FeaturesFilter
     prediction.m_tokenRange = TokenRange(startToken, curToken);
 
     ASSERT_NOT_EQUAL(fs.PopCount(), 0, ());
-    ASSERT_LESS_OR_EQUAL(fs.PopCount(), fa.PopCount(), ());
-    prediction.m_prob = static_cast<double>(fs.PopCount()) / static_cast<double>(fa.PopCount());
+    ASSERT_LESS_OR_EQUAL(fs.PopCount(), numAll, ());
+    prediction.m_prob = static_cast<double>(fs.PopCount()) / static_cast<double>(numAll);
 
     prediction.m_features = move(fs);
     prediction.m_hash = prediction.m_features.Hash();
@@ -116,7 +121,7 @@ void FindStreets(BaseContext const & ctx, CBV const & candidates, FeaturesFilter
           // |streets| is temporarily in the
           // incomplete state.
           streets = buffer;
-          all = all.Intersect(ctx.m_features[tag].m_features);
+          all.IntersectWith(ctx.m_features[tag].m_features);
           emptyIntersection = false;
 
           incomplete = true;
@@ -131,7 +136,7 @@ void FindStreets(BaseContext const & ctx, CBV const & candidates, FeaturesFilter
           emit();
 
         streets = buffer;
-        all = all.Intersect(ctx.m_features[tag].m_features);
+        all.IntersectWith(ctx.m_features[tag].m_features);
         emptyIntersection = false;
         incomplete = false;
       },
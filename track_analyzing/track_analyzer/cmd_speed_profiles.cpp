@@ -0,0 +1,133 @@
+#include "track_analyzing/track.hpp"
+#include "track_analyzing/utils.hpp"
+
+#include "routing/geometry.hpp"
+#include "routing/routing_helpers.hpp"
+#include "routing/speed_profiles.hpp"
+
+#include "routing_common/car_model.hpp"
+#include "routing_common/vehicle_model.hpp"
+
+#include "storage/routing_helpers.hpp"
+#include "storage/storage.hpp"
+
+#include "geometry/distance_on_sphere.hpp"
+
+#include "base/logging.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+
+namespace track_analyzing
+{
+using namespace routing;
+using namespace std;
+
+namespace
+{
+// Points which are farther in time are not used because the car may have stopped between them.
+uint64_t constexpr kMaxPointsGapSec = 60;
+// Hours of week with less time of tracks are skipped.
+double constexpr kMinHourTimeSec = 10.0 * 60.0;
+
+struct SpeedProfileKey
+{
+  bool operator<(SpeedProfileKey const & rhs) const
+  {
+    return tie(m_mwmName, m_highwayType, m_hourOfWeek) <
+           tie(rhs.m_mwmName, rhs.m_highwayType, rhs.m_hourOfWeek);
+  }
+
+  string m_mwmName;
+  HighwayType m_highwayType = HighwayType::HighwayPrimary;
+  uint32_t m_hourOfWeek = 0;
+};
+
+struct SpeedProfileTime
+{
+  // Time of moving with the speed of the car model.
+  double m_modelTimeSec = 0.0;
+  // Time of the tracks.
+  double m_trackTimeSec = 0.0;
+};
+}  // namespace
+
+void CmdSpeedProfiles(string const & filepath, string const & trackExtension,
+                      StringFilter mwmFilter, StringFilter userFilter)
+{
+  storage::Storage storage;
+  storage.RegisterAllLocalMaps();
+  auto numMwmIds = CreateNumMwmIds(storage);
+
+  map<SpeedProfileKey, SpeedProfileTime> times;
+  auto processMwm = [&](string const & mwmName, UserToMatchedTracks const & userToMatchedTracks) {
+    if (mwmFilter(mwmName))
+      return;
+
+    auto const carModelFactory =
+        make_shared<CarModelFactory>(VehicleModelFactory::CountryParentNameGetterFn{});
+    shared_ptr<VehicleModelInterface> vehicleModel =
+        carModelFactory->GetVehicleModelForCountry(mwmName);
+    Geometry geometry(
+        GeometryLoader::CreateFromFile(GetCurrentVersionMwmFile(storage, mwmName), vehicleModel));
+
+    for (auto const & [user, tracks] : userToMatchedTracks)
+    {
+      if (userFilter(user))
+        continue;
+
+      for (auto const & track : tracks)
+      {
+        for (size_t i = 1; i < track.size(); ++i)
+        {
+          auto const & from = track[i - 1].GetDataPoint();
+          auto const & to = track[i].GetDataPoint();
+          if (to.m_timestamp <= from.m_timestamp ||
+              to.m_timestamp - from.m_timestamp > kMaxPointsGapSec)
+          {
+            continue;
+          }
+
+          // The move between the points is attributed to the road of the first point.
+          auto const & segment = track[i - 1].GetSegment();
+          auto const & road = geometry.GetRoad(segment.GetFeatureId());
+          auto const highwayType = road.GetHighwayType();
+          auto const speed = road.GetSpeed(segment.IsForward());
+          if (!highwayType || !speed.IsValid())
+            continue;
+
+          double const distanceM = ms::DistanceOnEarth(from.m_latLon, to.m_latLon);
+          auto const secondOfWeek =
+              SpeedProfile::GetSecondOfWeek(static_cast<time_t>(from.m_timestamp));
+
+          auto & time = times[{mwmName, *highwayType, secondOfWeek / SpeedProfile::kKnotPeriodSec}];
+          time.m_modelTimeSec += distanceM / KMPH2MPS(speed.m_eta);
+          time.m_trackTimeSec += static_cast<double>(to.m_timestamp - from.m_timestamp);
+        }
+      }
+    }
+  };
+
+  auto processTrack = [&](string const & filename, MwmToMatchedTracks const & mwmToMatchedTracks) {
+    LOG(LINFO, ("Processing", filename));
+    ForTracksSortedByMwmName(mwmToMatchedTracks, *numMwmIds, processMwm);
+  };
+
+  ForEachTrackFile(filepath, trackExtension, numMwmIds, processTrack);
+
+  // The format is read by routing_builder::ParseSpeedProfiles(). Profiles are aggregated by
+  // highway types, so osm way id is 0.
+  for (auto const & [key, time] : times)
+  {
+    if (time.m_trackTimeSec < kMinHourTimeSec)
+      continue;
+
+    cout << key.m_mwmName << "," << static_cast<uint32_t>(key.m_highwayType) << ",0,1,"
+         << key.m_hourOfWeek << "," << time.m_modelTimeSec / time.m_trackTimeSec << '\n';
+  }
+}
+}  // namespace track_analyzing
@@ -42,6 +42,9 @@ DEFINE_string_ext(cmd, "",
                   "track - prints info about single track\n"
                   "cpptrack - prints track coords to insert them to cpp code\n"
                   "table - prints csv table based on matched tracks to stdout\n"
+                  "speed_profiles - prints csv table with weekly speed profiles of highway types "
+                  "based on matched tracks to stdout. The table is used by generator_tool "
+                  "--speed_profiles_path.\n"
                   "balance_csv - prints csv table based on csv table set in \"in\" param "
                   "with a distribution set according to input_distribution param.\n"
                   "gpx - convert raw logs into gpx files\n");
@@ -108,6 +111,9 @@ void CmdUnmatchedTracks(string const & logFile, string const & trackFileCsv);
 // Print aggregated tracks to csv table.
 void CmdTagsTable(string const & filepath, string const & trackExtension,
                   StringFilter mwmIsFiltered, StringFilter userFilter);
+// Print weekly speed profiles of highway types aggregated from tracks to csv table.
+void CmdSpeedProfiles(string const & filepath, string const & trackExtension,
+                      StringFilter mwmFilter, StringFilter userFilter);
 // Print track information.
 void CmdTrack(string const & trackFile, string const & mwmName, string const & user,
               size_t trackIdx);
@@ -163,6 +169,11 @@ int main(int argc, char ** argv)
       CmdTagsTable(Checked_in(), FLAGS_track_extension, MakeFilter(FLAGS_mwm),
                    MakeFilter(FLAGS_user));
     }
+    else if (cmd == "speed_profiles")
+    {
+      CmdSpeedProfiles(Checked_in(), FLAGS_track_extension, MakeFilter(FLAGS_mwm),
+                       MakeFilter(FLAGS_user));
+    }
     else if (cmd == "balance_csv")
     {
       if (FLAGS_input_distribution.empty())
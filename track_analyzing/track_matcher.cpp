@@ -74,6 +74,23 @@ TrackMatcher::TrackMatcher(storage::Storage const & storage, NumMwmId mwmId,
         nullptr /* dataSource */, nullptr /* numMvmIds */));
 
   DeserializeIndexGraph(*handle.GetValue(), VehicleType::Car, *m_graph);
+
+  RoadSegmentsIndexBuilder builder(kPointCoordBits, false /* hasAltitudes */);
+  IRoadGraph::PointWithAltitudeVec junctions;
+  m_dataSource.ForEachInRectForMWM(
+      [&](FeatureType & ft) {
+        if (!m_vehicleModel->IsRoad(ft))
+          return;
+
+        ft.ParseGeometry(FeatureType::BEST_GEOMETRY);
+        junctions.clear();
+        for (size_t i = 0; i < ft.GetPointsCount(); ++i)
+          junctions.emplace_back(ft.GetPoint(i), geometry::kDefaultAltitudeMeters);
+
+        builder.AddRoad(ft.GetID().m_index, !m_vehicleModel->IsOneWay(ft), junctions);
+      },
+      handle.GetInfo()->m_bordersRect, scales::GetUpperScale(), handle.GetId());
+  m_segmentsIndex = builder.Build();
 }
 
 void TrackMatcher::MatchTrack(vector<DataPoint> const & track, vector<MatchedTrack> & matchedTracks)
@@ -89,8 +106,7 @@ void TrackMatcher::MatchTrack(vector<DataPoint> const & track, vector<MatchedTra
   {
     for (; trackBegin < steps.size(); ++trackBegin)
     {
-      steps[trackBegin].FillCandidatesWithNearbySegments(m_dataSource, *m_graph, *m_vehicleModel,
-                                                         m_mwmId);
+      steps[trackBegin].FillCandidatesWithNearbySegments(*m_segmentsIndex, *m_graph, m_mwmId);
       if (steps[trackBegin].HasCandidates())
         break;
 
@@ -136,43 +152,27 @@ TrackMatcher::Step::Step(DataPoint const & dataPoint)
 }
 
 void TrackMatcher::Step::FillCandidatesWithNearbySegments(
-    DataSource const & dataSource, IndexGraph const & graph,
-    VehicleModelInterface const & vehicleModel, NumMwmId mwmId)
+    RoadSegmentsIndex const & segmentsIndex, IndexGraph const & graph, NumMwmId mwmId)
 {
-  dataSource.ForEachInRect(
-      [&](FeatureType & ft) {
-        if (!ft.GetID().IsValid())
-          return;
-
-        if (ft.GetID().m_mwmId.GetInfo()->GetType() != MwmInfo::COUNTRY)
-          return;
-
-        if (!vehicleModel.IsRoad(ft))
+  segmentsIndex.ForEachSegment(
+      mercator::RectByCenterXYAndSizeInMeters(m_point, kMatchingRange),
+      [&](RoadSegmentsIndex::RoadSegment const & roadSegment) {
+        double const distance = DistanceToSegment(roadSegment.m_start.GetPoint(),
+                                                  roadSegment.m_end.GetPoint(), m_point);
+        if (distance >= kMatchingRange)
           return;
 
-        ft.ParseGeometry(FeatureType::BEST_GEOMETRY);
+        AddCandidate(Segment(mwmId, roadSegment.m_featureId, roadSegment.m_segmentIdx,
+                             true /* forward */),
+                     distance, graph);
 
-        for (size_t segIdx = 0; segIdx + 1 < ft.GetPointsCount(); ++segIdx)
+        if (roadSegment.m_bidirectional)
         {
-          double const distance =
-              DistanceToSegment(ft.GetPoint(segIdx), ft.GetPoint(segIdx + 1), m_point);
-          if (distance < kMatchingRange)
-          {
-            AddCandidate(Segment(mwmId, ft.GetID().m_index, static_cast<uint32_t>(segIdx),
-                                 true /* forward */),
-                         distance, graph);
-
-            if (!vehicleModel.IsOneWay(ft))
-            {
-              AddCandidate(Segment(mwmId, ft.GetID().m_index, static_cast<uint32_t>(segIdx),
-                                   false /* forward */),
-                           distance, graph);
-            }
-          }
+          AddCandidate(Segment(mwmId, roadSegment.m_featureId, roadSegment.m_segmentIdx,
+                               false /* forward */),
+                       distance, graph);
         }
-      },
-      mercator::RectByCenterXYAndSizeInMeters(m_point, kMatchingRange),
-      scales::GetUpperScale());
+      });
 }
 
 void TrackMatcher::Step::FillCandidates(Step const & previousStep, IndexGraph & graph)
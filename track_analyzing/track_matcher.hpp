@@ -3,6 +3,7 @@
 #include "track_analyzing/track.hpp"
 
 #include "routing/index_graph.hpp"
+#include "routing/road_segments_index.hpp"
 #include "routing/segment.hpp"
 
 #include "routing_common/num_mwm_id.hpp"
@@ -57,9 +58,8 @@ private:
     DataPoint const & GetDataPoint() const { return m_dataPoint; }
     routing::Segment const & GetSegment() const { return m_segment; }
     bool HasCandidates() const { return !m_candidates.empty(); }
-    void FillCandidatesWithNearbySegments(DataSource const & dataSource,
+    void FillCandidatesWithNearbySegments(routing::RoadSegmentsIndex const & segmentsIndex,
                                           routing::IndexGraph const & graph,
-                                          routing::VehicleModelInterface const & vehicleModel,
                                           routing::NumMwmId mwmId);
     void FillCandidates(Step const & previousStep, routing::IndexGraph & graph);
     void ChooseSegment(Step const & nextStep, routing::IndexGraph & indexGraph);
@@ -79,6 +79,8 @@ private:
   FrozenDataSource m_dataSource;
   std::shared_ptr<routing::VehicleModelInterface> m_vehicleModel;
   std::unique_ptr<routing::IndexGraph> m_graph;
+  // Roads of the mwm are read once and points are matched without reading of features.
+  std::unique_ptr<routing::RoadSegmentsIndex> m_segmentsIndex;
   uint64_t m_tracksCount = 0;
   uint64_t m_pointsCount = 0;
   uint64_t m_nonMatchedPointsCount = 0;
@@ -4,27 +4,27 @@ namespace traffic
 {
 using namespace std;
 
-void TrafficCache::Set(MwmSet::MwmId const & mwmId, shared_ptr<TrafficInfo::Coloring const> coloring)
+void TrafficCache::Set(MwmSet::MwmId const & mwmId, shared_ptr<TrafficTable const> table)
 {
-  lock_guard<mutex> guard(mutex);
-  m_trafficColoring[mwmId] = coloring;
+  lock_guard<mutex> guard(m_mutex);
+  m_trafficColoring[mwmId] = move(table);
 }
 
 void TrafficCache::Remove(MwmSet::MwmId const & mwmId)
 {
-  lock_guard<mutex> guard(mutex);
+  lock_guard<mutex> guard(m_mutex);
   m_trafficColoring.erase(mwmId);
 }
 
 void TrafficCache::CopyTraffic(AllMwmTrafficInfo & trafficColoring) const
 {
-  lock_guard<mutex> guard(mutex);
+  lock_guard<mutex> guard(m_mutex);
   trafficColoring = m_trafficColoring;
 }
 
 void TrafficCache::Clear()
 {
-  lock_guard<mutex> guard(mutex);
+  lock_guard<mutex> guard(m_mutex);
   m_trafficColoring.clear();
 }
 }  // namespace traffic
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "traffic/traffic_info.hpp"
+#include "traffic/traffic_table.hpp"
 
 #include "indexer/mwm_set.hpp"
 
@@ -10,7 +10,7 @@
 
 namespace traffic
 {
-using AllMwmTrafficInfo = std::map<MwmSet::MwmId, std::shared_ptr<const traffic::TrafficInfo::Coloring>>;
+using AllMwmTrafficInfo = std::map<MwmSet::MwmId, std::shared_ptr<TrafficTable const>>;
 
 class TrafficCache
 {
@@ -21,12 +21,12 @@ public:
   virtual void CopyTraffic(AllMwmTrafficInfo & trafficColoring) const;
 
 protected:
-  void Set(MwmSet::MwmId const & mwmId, std::shared_ptr<TrafficInfo::Coloring const> coloring);
+  void Set(MwmSet::MwmId const & mwmId, std::shared_ptr<TrafficTable const> table);
   void Remove(MwmSet::MwmId const & mwmId);
   void Clear();
 
 private:
-  std::mutex m_mutex;
+  mutable std::mutex m_mutex;
   AllMwmTrafficInfo m_trafficColoring;
 };
 }  // namespace traffic
@@ -1,5 +1,7 @@
 #include "traffic/traffic_info.hpp"
 
+#include "traffic/traffic_table.hpp"
+
 #include "platform/http_client.hpp"
 #include "platform/platform.hpp"
 
@@ -93,8 +95,11 @@ TrafficInfo::RoadSegmentId::RoadSegmentId(uint32_t fid, uint16_t idx, uint8_t di
 uint8_t const TrafficInfo::kLatestKeysVersion = 0;
 uint8_t const TrafficInfo::kLatestValuesVersion = 0;
 
+TrafficInfo::TrafficInfo() : m_table(make_shared<TrafficTable>()) {}
+
 TrafficInfo::TrafficInfo(MwmSet::MwmId const & mwmId, int64_t currentDataVersion)
-  : m_mwmId(mwmId)
+  : m_table(make_shared<TrafficTable>())
+  , m_mwmId(mwmId)
   , m_currentDataVersion(currentDataVersion)
 {
   if (!mwmId.IsAlive())
@@ -139,7 +144,7 @@ TrafficInfo::TrafficInfo(MwmSet::MwmId const & mwmId, int64_t currentDataVersion
 TrafficInfo TrafficInfo::BuildForTesting(Coloring && coloring)
 {
   TrafficInfo info;
-  info.m_coloring = move(coloring);
+  info.m_table = make_shared<TrafficTable>(coloring);
   return info;
 }
 
@@ -167,10 +172,18 @@ bool TrafficInfo::ReceiveTrafficData(string & etag)
 
 SpeedGroup TrafficInfo::GetSpeedGroup(RoadSegmentId const & id) const
 {
-  auto const it = m_coloring.find(id);
-  if (it == m_coloring.cend())
-    return SpeedGroup::Unknown;
-  return it->second;
+  return m_table->GetSpeedGroup(id);
+}
+
+bool TrafficInfo::IsEmpty() const { return m_table->IsEmpty(); }
+
+TrafficInfo::Coloring TrafficInfo::GetColoring() const
+{
+  Coloring coloring;
+  m_table->ForEach([&coloring](RoadSegmentId const & id, SpeedGroup value) {
+    coloring.emplace_hint(coloring.end(), id, value);
+  });
+  return coloring;
 }
 
 // static
@@ -476,7 +489,7 @@ TrafficInfo::ServerDataStatus TrafficInfo::ReceiveTrafficValues(string & etag, v
 
 bool TrafficInfo::UpdateTrafficData(vector<SpeedGroup> const & values)
 {
-  m_coloring.clear();
+  m_table = make_shared<TrafficTable>();
 
   if (m_keys.size() != values.size())
   {
@@ -487,11 +500,7 @@ bool TrafficInfo::UpdateTrafficData(vector<SpeedGroup> const & values)
     return false;
   }
 
-  for (size_t i = 0; i < m_keys.size(); ++i)
-  {
-    if (values[i] != SpeedGroup::Unknown)
-      m_coloring.emplace(m_keys[i], values[i]);
-  }
+  m_table = make_shared<TrafficTable>(m_keys, values);
 
   return true;
 }
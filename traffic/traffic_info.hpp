@@ -6,6 +6,7 @@
 
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace platform
@@ -15,6 +16,8 @@ class HttpClient;
 
 namespace traffic
 {
+class TrafficTable;
+
 // This class is responsible for providing the real-time
 // information about road traffic for one mwm file.
 class TrafficInfo
@@ -74,7 +77,7 @@ public:
   // todo(@m) unordered_map?
   using Coloring = std::map<RoadSegmentId, SpeedGroup>;
 
-  TrafficInfo() = default;
+  TrafficInfo();
 
   TrafficInfo(MwmSet::MwmId const & mwmId, int64_t currentDataVersion);
 
@@ -94,7 +97,14 @@ public:
   SpeedGroup GetSpeedGroup(RoadSegmentId const & id) const;
 
   MwmSet::MwmId const & GetMwmId() const { return m_mwmId; }
-  Coloring const & GetColoring() const { return m_coloring; }
+  // Speed groups of the segments with known speed groups. It's the only storage of the data,
+  // it's built once when the data is received and shared by routing without copying.
+  // It's never nullptr.
+  std::shared_ptr<TrafficTable const> const & GetTable() const { return m_table; }
+  // The same data as GetTable() as a map. It's built on every call, so it's used by consumers
+  // which need the segments sorted only.
+  Coloring GetColoring() const;
+  bool IsEmpty() const;
   Availability GetAvailability() const { return m_availability; }
 
   // Extracts RoadSegmentIds from mwm and stores them in a sorted order.
@@ -135,7 +145,7 @@ private:
 
   // Tries to read the values of the Coloring map from server into |values|.
   // Returns result of communicating with server as ServerDataStatus.
-  // Otherwise, returns false and does not change m_coloring.
+  // Otherwise, returns false and does not change m_table.
   ServerDataStatus ReceiveTrafficValues(std::string & etag, std::vector<SpeedGroup> & values);
 
   // Updates the coloring and changes the availability status if needed.
@@ -144,10 +154,10 @@ private:
   ServerDataStatus ProcessFailure(platform::HttpClient const & request, int64_t const mwmVersion);
 
   // The mapping from feature segments to speed groups (see speed_groups.hpp).
-  Coloring m_coloring;
+  std::shared_ptr<TrafficTable const> m_table;
 
   // The keys of the coloring map. The values are downloaded periodically
-  // and combined with the keys to form m_coloring.
+  // and combined with the keys to form m_table.
   // *NOTE* The values must be received in the exact same order that the
   // keys are saved in.
   std::vector<RoadSegmentId> m_keys;
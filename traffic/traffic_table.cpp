@@ -0,0 +1,79 @@
+#include "traffic/traffic_table.hpp"
+
+#include "base/assert.hpp"
+
+namespace traffic
+{
+using namespace std;
+
+TrafficTable::TrafficTable(TrafficInfo::Coloring const & coloring)
+{
+  Reserve(coloring.size());
+  for (auto const & [id, value] : coloring)
+    Insert(id.GetFid(), id.GetIdx(), id.GetDir(), value);
+}
+
+TrafficTable::TrafficTable(vector<TrafficInfo::RoadSegmentId> const & keys,
+                           vector<SpeedGroup> const & values)
+{
+  CHECK_EQUAL(keys.size(), values.size(), ());
+  Reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i)
+    Insert(keys[i].GetFid(), keys[i].GetIdx(), keys[i].GetDir(), values[i]);
+}
+
+SpeedGroup TrafficTable::GetSpeedGroup(uint32_t fid, uint16_t idx, uint8_t dir) const
+{
+  if (m_size == 0)
+    return SpeedGroup::Unknown;
+
+  uint64_t const key = MakeKey(fid, idx, dir);
+  for (size_t i = GetBucket(key);; i = (i + 1) & m_mask)
+  {
+    uint64_t const slot = m_slots[i];
+    if (slot == kEmptySlot)
+      return SpeedGroup::Unknown;
+    if ((slot & kKeyMask) == key)
+      return static_cast<SpeedGroup>(slot >> kValueShift);
+  }
+}
+
+void TrafficTable::Reserve(size_t size)
+{
+  ASSERT(m_slots.empty(), ());
+  if (size == 0)
+    return;
+
+  // Load factor is not greater than 0.5 so probe sequences are short.
+  size_t capacity = 16;
+  while (capacity < size * 2)
+    capacity *= 2;
+
+  m_slots.assign(capacity, kEmptySlot);
+  m_mask = capacity - 1;
+}
+
+void TrafficTable::Insert(uint32_t fid, uint16_t idx, uint8_t dir, SpeedGroup value)
+{
+  if (value == SpeedGroup::Unknown)
+    return;
+
+  CHECK(!m_slots.empty(), ());
+  uint64_t const key = MakeKey(fid, idx, dir);
+  for (size_t i = GetBucket(key);; i = (i + 1) & m_mask)
+  {
+    uint64_t & slot = m_slots[i];
+    if (slot == kEmptySlot)
+    {
+      slot = key | (static_cast<uint64_t>(value) << kValueShift);
+      ++m_size;
+      return;
+    }
+    if ((slot & kKeyMask) == key)
+    {
+      slot = key | (static_cast<uint64_t>(value) << kValueShift);
+      return;
+    }
+  }
+}
+}  // namespace traffic
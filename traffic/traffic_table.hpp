@@ -0,0 +1,77 @@
+#pragma once
+
+#include "traffic/speed_groups.hpp"
+#include "traffic/traffic_info.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace traffic
+{
+/// \brief Speed groups of road segments of one mwm for lookups while routing.
+/// It's an open addressing hash table in one flat array: every slot keeps a packed
+/// RoadSegmentId and its speed group, so a lookup usually touches one cache line.
+/// The table is immutable after construction and may be shared between threads.
+/// Segments with SpeedGroup::Unknown are not stored.
+class TrafficTable final
+{
+public:
+  TrafficTable() = default;
+  explicit TrafficTable(TrafficInfo::Coloring const & coloring);
+  TrafficTable(std::vector<TrafficInfo::RoadSegmentId> const & keys,
+               std::vector<SpeedGroup> const & values);
+
+  // Returns SpeedGroup::Unknown if there is no information about the segment.
+  SpeedGroup GetSpeedGroup(uint32_t fid, uint16_t idx, uint8_t dir) const;
+  SpeedGroup GetSpeedGroup(TrafficInfo::RoadSegmentId const & id) const
+  {
+    return GetSpeedGroup(id.GetFid(), id.GetIdx(), id.GetDir());
+  }
+
+  // Calls |fn| for every stored segment in arbitrary order.
+  template <typename Fn>
+  void ForEach(Fn && fn) const
+  {
+    for (uint64_t const slot : m_slots)
+    {
+      if (slot == kEmptySlot)
+        continue;
+
+      uint64_t const key = slot & kKeyMask;
+      fn(TrafficInfo::RoadSegmentId(static_cast<uint32_t>(key >> 17),
+                                    static_cast<uint16_t>(key >> 1), static_cast<uint8_t>(key & 1)),
+         static_cast<SpeedGroup>(slot >> kValueShift));
+    }
+  }
+
+  size_t GetSize() const { return m_size; }
+  bool IsEmpty() const { return m_size == 0; }
+  size_t GetMemorySize() const { return m_slots.size() * sizeof(uint64_t); }
+
+private:
+  // Bits 0-48 of a slot are the key: direction in bit 0, segment index in bits 1-16 and
+  // feature id in bits 17-48. Bits 49-56 are the speed group.
+  static uint8_t constexpr kValueShift = 49;
+  static uint64_t constexpr kKeyMask = (uint64_t{1} << kValueShift) - 1;
+  static uint64_t constexpr kEmptySlot = ~uint64_t{0};
+
+  static uint64_t MakeKey(uint32_t fid, uint16_t idx, uint8_t dir)
+  {
+    return (static_cast<uint64_t>(fid) << 17) | (static_cast<uint64_t>(idx) << 1) | (dir & 1);
+  }
+
+  size_t GetBucket(uint64_t key) const
+  {
+    // Fibonacci hashing spreads keys of sequential features between buckets.
+    return static_cast<size_t>((key * 11400714819323198485ULL) >> 32) & m_mask;
+  }
+
+  void Reserve(size_t size);
+  void Insert(uint32_t fid, uint16_t idx, uint8_t dir, SpeedGroup value);
+
+  std::vector<uint64_t> m_slots;
+  size_t m_mask = 0;
+  size_t m_size = 0;
+};
+}  // namespace traffic
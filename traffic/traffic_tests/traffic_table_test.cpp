@@ -0,0 +1,158 @@
+#include "testing/testing.hpp"
+
+#include "traffic/speed_groups.hpp"
+#include "traffic/traffic_info.hpp"
+#include "traffic/traffic_table.hpp"
+
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace traffic
+{
+namespace
+{
+using RoadSegmentId = TrafficInfo::RoadSegmentId;
+
+TrafficInfo::Coloring MakeColoring(uint32_t featuresNumber, uint16_t segmentsNumber)
+{
+  TrafficInfo::Coloring coloring;
+  for (uint32_t fid = 0; fid < featuresNumber; ++fid)
+  {
+    for (uint16_t idx = 0; idx < segmentsNumber; ++idx)
+    {
+      for (uint8_t dir : {RoadSegmentId::kForwardDirection, RoadSegmentId::kReverseDirection})
+      {
+        auto const group =
+            static_cast<SpeedGroup>((fid + idx + dir) % static_cast<uint8_t>(SpeedGroup::Count));
+        coloring.emplace(RoadSegmentId(fid * 3, idx, dir), group);
+      }
+    }
+  }
+  return coloring;
+}
+}  // namespace
+
+UNIT_TEST(TrafficTable_Smoke)
+{
+  auto const coloring = MakeColoring(100 /* featuresNumber */, 5 /* segmentsNumber */);
+  TrafficTable const table(coloring);
+
+  size_t knownNumber = 0;
+  for (auto const & [id, group] : coloring)
+  {
+    TEST_EQUAL(table.GetSpeedGroup(id), group, (id));
+    if (group != SpeedGroup::Unknown)
+      ++knownNumber;
+  }
+  TEST_EQUAL(table.GetSize(), knownNumber, ());
+
+  TEST_EQUAL(table.GetSpeedGroup(RoadSegmentId(1, 0, 0)), SpeedGroup::Unknown, ());
+  TEST_EQUAL(table.GetSpeedGroup(RoadSegmentId(0, 5, 0)), SpeedGroup::Unknown, ());
+  TEST_EQUAL(table.GetSpeedGroup(RoadSegmentId(1000, 0, 1)), SpeedGroup::Unknown, ());
+}
+
+UNIT_TEST(TrafficTable_Empty)
+{
+  TrafficTable const table;
+  TEST(table.IsEmpty(), ());
+  TEST_EQUAL(table.GetSpeedGroup(RoadSegmentId(0, 0, 0)), SpeedGroup::Unknown, ());
+
+  TrafficTable const unknownTable({RoadSegmentId(1, 2, 0)}, {SpeedGroup::Unknown});
+  TEST(unknownTable.IsEmpty(), ());
+  TEST_EQUAL(unknownTable.GetSpeedGroup(RoadSegmentId(1, 2, 0)), SpeedGroup::Unknown, ());
+}
+
+UNIT_TEST(TrafficTable_MaxIds)
+{
+  uint16_t constexpr kMaxIdx = UINT16_MAX;
+  vector<RoadSegmentId> const keys = {RoadSegmentId(UINT32_MAX, kMaxIdx, 1),
+                                      RoadSegmentId(UINT32_MAX, kMaxIdx, 0),
+                                      RoadSegmentId(0, kMaxIdx, 1)};
+  vector<SpeedGroup> const values = {SpeedGroup::G0, SpeedGroup::TempBlock, SpeedGroup::G5};
+
+  TrafficTable const table(keys, values);
+  TEST_EQUAL(table.GetSize(), keys.size(), ());
+  for (size_t i = 0; i < keys.size(); ++i)
+    TEST_EQUAL(table.GetSpeedGroup(keys[i]), values[i], ());
+}
+
+// Segment indices from 1 << 15 must not overlap feature ids.
+UNIT_TEST(TrafficTable_BigSegmentIdx)
+{
+  uint16_t constexpr kBigIdx = 1 << 15;
+  vector<RoadSegmentId> const keys = {RoadSegmentId(0, kBigIdx, 0), RoadSegmentId(1, 0, 0),
+                                      RoadSegmentId(2, kBigIdx + 1, 1), RoadSegmentId(3, 0, 1)};
+  vector<SpeedGroup> const values = {SpeedGroup::G1, SpeedGroup::G4, SpeedGroup::G2,
+                                     SpeedGroup::G3};
+
+  TrafficTable const table(keys, values);
+  TEST_EQUAL(table.GetSize(), keys.size(), ());
+  for (size_t i = 0; i < keys.size(); ++i)
+    TEST_EQUAL(table.GetSpeedGroup(keys[i]), values[i], (keys[i]));
+
+  TrafficTable const bigIdxTable({RoadSegmentId(0, kBigIdx, 0)}, {SpeedGroup::G1});
+  TEST_EQUAL(bigIdxTable.GetSpeedGroup(RoadSegmentId(1, 0, 0)), SpeedGroup::Unknown, ());
+}
+
+UNIT_TEST(TrafficTable_ForEach)
+{
+  auto coloring = MakeColoring(50 /* featuresNumber */, 3 /* segmentsNumber */);
+  coloring.emplace(RoadSegmentId(UINT32_MAX, UINT16_MAX, 1), SpeedGroup::G2);
+  TrafficTable const table(coloring);
+
+  TrafficInfo::Coloring known;
+  for (auto const & [id, group] : coloring)
+  {
+    if (group != SpeedGroup::Unknown)
+      known.emplace(id, group);
+  }
+
+  TrafficInfo::Coloring result;
+  table.ForEach([&result](RoadSegmentId const & id, SpeedGroup group) {
+    TEST(result.emplace(id, group).second, (id));
+  });
+  TEST_EQUAL(result, known, ());
+  TEST_EQUAL(TrafficInfo::BuildForTesting(move(coloring)).GetColoring(), known, ());
+}
+
+// Compares lookups in TrafficTable and in TrafficInfo::Coloring. Time is logged only.
+UNIT_TEST(TrafficTable_LookupBenchmark)
+{
+  auto const coloring = MakeColoring(100000 /* featuresNumber */, 5 /* segmentsNumber */);
+  TrafficTable const table(coloring);
+
+  vector<RoadSegmentId> requests;
+  mt19937 rng(0 /* seed */);
+  uniform_int_distribution<uint32_t> fidDist(0, 100000 * 3);
+  uniform_int_distribution<uint16_t> idxDist(0, 5);
+  for (size_t i = 0; i < 1000000; ++i)
+    requests.emplace_back(fidDist(rng), idxDist(rng), static_cast<uint8_t>(i % 2));
+
+  uint64_t mapSum = 0;
+  base::Timer timer;
+  for (auto const & id : requests)
+  {
+    auto const it = coloring.find(id);
+    mapSum += static_cast<uint64_t>(it == coloring.cend() ? SpeedGroup::Unknown : it->second);
+  }
+  double const mapSeconds = timer.ElapsedSeconds();
+
+  uint64_t tableSum = 0;
+  timer.Reset();
+  for (auto const & id : requests)
+    tableSum += static_cast<uint64_t>(table.GetSpeedGroup(id));
+  double const tableSeconds = timer.ElapsedSeconds();
+
+  TEST_EQUAL(mapSum, tableSum, ());
+  LOG(LINFO, ("Lookups:", requests.size(), "segments:", coloring.size(), "map:", mapSeconds,
+              "seconds, table:", tableSeconds, "seconds, table memory:", table.GetMemorySize(),
+              "bytes."));
+}
+}  // namespace traffic